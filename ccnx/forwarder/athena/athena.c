@@ -34,22 +34,36 @@
 
 #include <config.h>
 #include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <strings.h>
+#include <string.h>
 #include <unistd.h>
+#include <sys/time.h>
 
 #include <ccnx/forwarder/athena/athena.h>
 #include <ccnx/forwarder/athena/athena_Control.h>
 #include <ccnx/forwarder/athena/athena_InterestControl.h>
 #include <ccnx/forwarder/athena/athena_LRUContentStore.h>
+#include <ccnx/forwarder/athena/athena_ShardedContentStore.h>
+#include <ccnx/forwarder/athena/athena_LogReporterAsync.h>
+#include <ccnx/forwarder/athena/athena_Scratch.h>
 
 #include <ccnx/common/ccnx_Interest.h>
 #include <ccnx/common/ccnx_InterestReturn.h>
 #include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
 
 #include <ccnx/common/validation/ccnxValidation_CRC32C.h>
 #include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
 
+// Count of reload signals received by the process, each forwarder instance compares it with those it has handled
+static volatile sig_atomic_t _athenaReloadSignals = 0;
+
 static PARCLog *
-_athena_logger_create(void)
+_athena_logger_create(PARCLogReporter **asyncReporter)
 {
     PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
     PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
@@ -58,6 +72,13 @@ _athena_logger_create(void)
     PARCLogReporter *reporter = parcLogReporterFile_Create(output);
     parcOutputStream_Release(&output);
 
+    // Hand entries off to a writer thread so that logging never blocks the forwarding loop
+    *asyncReporter = athenaLogReporterAsync_Create(reporter, AthenaLogReporterAsync_DefaultCapacity);
+    if (*asyncReporter) {
+        parcLogReporter_Release(&reporter);
+        reporter = parcLogReporter_Acquire(*asyncReporter);
+    }
+
     PARCLog *log = parcLog_Create("localhost", "athena", NULL, reporter);
     parcLogReporter_Release(&reporter);
 
@@ -86,11 +107,40 @@ static void
 _athenaDestroy(Athena **athena)
 {
     ccnxName_Release(&((*athena)->athenaName));
+    // Dumps may still be walking the PIT and content store
+    athenaInterestControl_ReleaseDumps(*athena);
+    if ((*athena)->purge.prefix) {
+        ccnxName_Release(&((*athena)->purge.prefix));
+    }
+    if ((*athena)->config) {
+        athenaConfig_Release(&((*athena)->config));
+    }
+    if ((*athena)->configPath) {
+        parcMemory_Deallocate(&((*athena)->configPath));
+    }
+    if ((*athena)->drainSnapshotPath) {
+        parcMemory_Deallocate(&((*athena)->drainSnapshotPath));
+    }
+    if ((*athena)->routeFeed) {
+        athenaRouteFeed_Release(&((*athena)->routeFeed));
+    }
+    if ((*athena)->warm) {
+        athenaWarm_Release(&((*athena)->warm));
+    }
+    // Fan-outs in progress are finished while their links are still open
+    if ((*athena)->fanout) {
+        athenaFanout_Release(&((*athena)->fanout));
+    }
     athenaTransportLinkAdapter_Destroy(&((*athena)->athenaTransportLinkAdapter));
     athenaContentStore_Release(&((*athena)->athenaContentStore));
     athenaPIT_Release(&((*athena)->athenaPIT));
     athenaFIB_Release(&((*athena)->athenaFIB));
+    athenaNamePool_Release(&((*athena)->namePool));
+    athenaStats_Release(&((*athena)->stats));
     parcLog_Release(&((*athena)->log));
+    if ((*athena)->logReporter) {
+        parcLogReporter_Release(&((*athena)->logReporter));
+    }
 }
 
 parcObject_ExtendPARCObject(Athena, _athenaDestroy, NULL, NULL, NULL, NULL, NULL, NULL);
@@ -103,14 +153,22 @@ athena_Create(size_t contentStoreSizeInMB)
     athena->athenaName = ccnxName_CreateFromURI(CCNxNameAthena_Forwarder);
     assertNotNull(athena->athenaName, "Failed to create forwarder name (%s)", CCNxNameAthena_Forwarder);
 
-    athena->athenaFIB = athenaFIB_Create();
+    // Names are interned once for the FIB, PIT and Content Store
+    athena->namePool = athenaNamePool_Create();
+    assertNotNull(athena->namePool, "Failed to create name pool");
+
+    athena->athenaFIB = athenaFIB_CreateWithNamePool(athena->namePool);
     assertNotNull(athena->athenaFIB, "Failed to create FIB");
 
-    athena->athenaPIT = athenaPIT_Create();
+    athena->athenaPIT = athenaPIT_CreateWithNamePool(AthenaDefaultPITCapacity, athena->namePool);
     assertNotNull(athena->athenaPIT, "Failed to create PIT");
 
     AthenaLRUContentStoreConfig storeConfig;
     storeConfig.capacityInMB = contentStoreSizeInMB;
+    storeConfig.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    storeConfig.coldSegmentPercent = 0;
+    storeConfig.deduplicatePayloads = false;
+    storeConfig.namePool = athena->namePool;
 
     athena->athenaContentStore = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &storeConfig);
     assertNotNull(athena->athenaContentStore, "Failed to create Content Store");
@@ -118,16 +176,117 @@ athena_Create(size_t contentStoreSizeInMB)
     athena->athenaTransportLinkAdapter = athenaTransportLinkAdapter_Create(_removeLink, athena);
     assertNotNull(athena->athenaTransportLinkAdapter, "Failed to create Transport Link Adapter");
 
-    athena->log = _athena_logger_create();
+    athena->stats = athenaStats_Create(AthenaCounter_Count, 0, 0, NULL);
+
+    athena->log = _athena_logger_create(&athena->logReporter);
+    athena->reloadSignals = _athenaReloadSignals;
     athena->athenaState = Athena_Running;
 
     return athena;
 }
 
+void
+athena_SetContentStore(Athena *athena, AthenaContentStore *contentStore)
+{
+    AthenaContentStore *previousContentStore = athena->athenaContentStore;
+    athena->athenaContentStore = athenaContentStore_Acquire(contentStore);
+    athenaContentStore_Release(&previousContentStore);
+}
+
+void
+athena_SetDrainSnapshotPath(Athena *athena, const char *path)
+{
+    if (athena->drainSnapshotPath) {
+        parcMemory_Deallocate(&athena->drainSnapshotPath);
+    }
+    if (path) {
+        athena->drainSnapshotPath = parcMemory_StringDuplicate(path, strlen(path));
+    }
+}
+
 parcObject_ImplementAcquire(athena, Athena);
 
 parcObject_ImplementRelease(athena, Athena);
 
+static void *
+_start_forwarder_instance(void *arg)
+{
+    void *res = athena_ForwarderEngine(arg);
+    pthread_detach(pthread_self());
+    return res;
+}
+
+bool
+athena_Spawn(Athena *athena, const char *connectionSpecification)
+{
+    // Create a new athena instance
+    Athena *newAthena = athena_Create(AthenaDefaultContentStoreSize);
+    if (newAthena == NULL) {
+        parcLog_Error(athena->log, "Could not create a new Athena instance");
+        return false;
+    }
+
+    // Add the specified link
+    PARCURI *connectionURI = parcURI_Parse(connectionSpecification);
+    if ((connectionURI == NULL) || (athenaTransportLinkAdapter_Open(newAthena->athenaTransportLinkAdapter, connectionURI) == NULL)) {
+        parcLog_Error(athena->log, "Unable to configure an interface for a new instance on %s", connectionSpecification);
+        if (connectionURI) {
+            parcURI_Release(&connectionURI);
+        }
+        athena_Release(&newAthena);
+        return false;
+    }
+    parcURI_Release(&connectionURI);
+
+    // Share our content store with the new instance if it can be used concurrently
+    if (athenaContentStore_GetInterface(athena->athenaContentStore) == &AthenaContentStore_ShardedImplementation) {
+        athena_SetContentStore(newAthena, athena->athenaContentStore);
+    }
+
+    pthread_t thread;
+    // Passing in a reference that will be released by the new thread as the thread may not
+    // have time to acquire a reference itself before we release our reference.
+    if (pthread_create(&thread, NULL, _start_forwarder_instance, (void *) athena_Acquire(newAthena)) != 0) {
+        parcLog_Error(athena->log, "Athena process thread creation failed");
+        athena_Release(&newAthena);
+        athena_Release(&newAthena);
+        return false;
+    }
+    athena_Release(&newAthena);
+    return true;
+}
+
+// Give the FIB the link ids of the image links that are open
+static void
+_resolveFIBImageLinks(Athena *athena)
+{
+    AthenaFIBImage *image = athenaFIB_GetImage(athena->athenaFIB);
+    if (image != NULL) {
+        for (size_t i = 0; i < athenaFIBImage_GetNumberOfLinks(image); i++) {
+            const char *linkName = athenaFIBImage_GetLinkName(image, i);
+            int linkId = athenaTransportLinkAdapter_LinkNameToId(athena->athenaTransportLinkAdapter, linkName);
+            athenaFIB_SetImageLinkId(athena->athenaFIB, i, linkId);
+        }
+    }
+}
+
+const char *
+athena_OpenLink(Athena *athena, const char *connectionSpecification)
+{
+    PARCURI *connectionURI = parcURI_Parse(connectionSpecification);
+    if (connectionURI == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+    const char *linkName = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    parcURI_Release(&connectionURI);
+
+    if (linkName) {
+        _resolveFIBImageLinks(athena);
+    }
+    return linkName;
+}
+
 static void
 _processInterestControl(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressVector)
 {
@@ -146,11 +305,67 @@ _processControl(Athena *athena, CCNxControl *control, PARCBitVector *ingressVect
     athenaControl(athena, control, ingressVector);
 }
 
+/**
+ * Ask upstream for a fresh copy of stale content that was served from the content store.  The refresh
+ * is entered in the PIT with no ingress links, so the copy that comes back only replaces the stale item.
+ * It carries the original Interest's lifetime and restrictions, so it can only be answered by content
+ * the consumer would have accepted.
+ */
+static void
+_refreshContent(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressVector)
+{
+    CCNxName *ccnxName = ccnxInterest_GetName(interest);
+    CCNxInterest *refresh = ccnxInterest_Create(ccnxName,
+                                                (uint32_t) ccnxInterest_GetLifetime(interest),
+                                                ccnxInterest_GetKeyIdRestriction(interest),
+                                                ccnxInterest_GetContentObjectHashRestriction(interest));
+    PARCBitVector *noIngressVector = parcBitVector_Create();
+
+    PARCBitVector *expectedReturnVector;
+    if (athenaPIT_AddInterest(athena->athenaPIT, refresh, noIngressVector, &expectedReturnVector) == AthenaPITResolution_Forward) {
+        PARCBitVector *egressVector = athenaFIB_Lookup(athena->athenaFIB, ccnxName);
+        if (egressVector != NULL) {
+            parcBitVector_ClearVector(egressVector, ingressVector);
+        }
+        if ((egressVector != NULL) && (parcBitVector_NumberOfBitsSet(egressVector) > 0)) {
+            parcBitVector_SetVector(expectedReturnVector, egressVector);
+            PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, refresh, egressVector);
+            if (result) {
+                parcBitVector_ClearVector(expectedReturnVector, result);
+                parcBitVector_Release(&result);
+            }
+        } else {
+            athenaPIT_RemoveInterest(athena->athenaPIT, refresh, noIngressVector);
+        }
+        athenaStats_Increment(athena->stats, AthenaCounter_RefreshedContentObjects);
+    }
+
+    parcBitVector_Release(&noIngressVector);
+    ccnxInterest_Release(&refresh);
+}
+
+static void
+_returnNoRoute(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressVector)
+{
+    CCNxInterestReturn *interestReturn = ccnxInterestReturn_Create(interest, CCNxInterestReturn_ReturnCode_NoRoute);
+    PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, interestReturn, ingressVector);
+    if (result) {
+        parcBitVector_Release(&result);
+    }
+    ccnxInterestReturn_Release(&interestReturn);
+}
+
 static void
 _processInterest(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressVector)
 {
     uint8_t hoplimit;
 
+    // Refused while draining, so that consumers fail over rather than wait on a forwarder that is exiting
+    if (athena->athenaState == Athena_Draining) {
+        _returnNoRoute(athena, interest, ingressVector);
+        return;
+    }
+
     //
     // *   (0) Hoplimit check, exclusively on interest messages
     //
@@ -170,16 +385,23 @@ _processInterest(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressV
     //
     // *   (1) if the interest is in the ContentStore, reply and return,
     //     assuming that other PIT entries were satisified when the content arrived.
+    //     Expired content within its stale window is served too, while a fresh copy is fetched.
     //
-    CCNxMetaMessage *content = athenaContentStore_GetMatch(athena->athenaContentStore, interest);
+    bool needsRefresh;
+    CCNxMetaMessage *content = athenaContentStore_GetMatchOrStale(athena->athenaContentStore, interest, &needsRefresh);
     if (content) {
-        const char *ingressVectorString = parcBitVector_ToString(ingressVector);
-        parcLog_Debug(athena->log, "Forwarding content from store to %s", ingressVectorString);
-        parcMemory_Deallocate(&ingressVectorString);
+        if (parcLog_IsLoggable(athena->log, PARCLogLevel_Debug)) {
+            const char *ingressVectorString = parcBitVector_ToString(ingressVector);
+            parcLog_Debug(athena->log, "Forwarding content from store to %s", ingressVectorString);
+            parcMemory_Deallocate(&ingressVectorString);
+        }
         PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, content, ingressVector);
         if (result) { // failed channels - client will resend interest unless we wish to optimize things here
             parcBitVector_Release(&result);
         }
+        if (needsRefresh) {
+            _refreshContent(athena, interest, ingressVector);
+        }
         return;
     }
 
@@ -218,10 +440,7 @@ _processInterest(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressV
         parcBitVector_ClearVector(egressVector, ingressVector);
         // If no links remain, send a no route interest return message
         if (parcBitVector_NumberOfBitsSet(egressVector) == 0) {
-            CCNxInterestReturn *interestReturn = ccnxInterestReturn_Create(interest, CCNxInterestReturn_ReturnCode_NoRoute);
-            PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, interestReturn, ingressVector);
-            parcBitVector_Release(&result);
-            ccnxInterestReturn_Release(&interestReturn);
+            _returnNoRoute(athena, interest, ingressVector);
         } else {
             parcBitVector_SetVector(expectedReturnVector, egressVector);
             PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, interest, egressVector);
@@ -232,16 +451,17 @@ _processInterest(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressV
         }
     } else {
         // No FIB entry found, return a NoRoute interest return and remove the entry from the PIT.
-        CCNxInterestReturn *interestReturn = ccnxInterestReturn_Create(interest, CCNxInterestReturn_ReturnCode_NoRoute);
-        PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, interestReturn, ingressVector);
-        parcBitVector_Release(&result);
-        ccnxInterestReturn_Release(&interestReturn);
-        const char *name = ccnxName_ToString(ccnxName);
+        _returnNoRoute(athena, interest, ingressVector);
         if (athenaPIT_RemoveInterest(athena->athenaPIT, interest, ingressVector) != true) {
+            const char *name = ccnxName_ToString(ccnxName);
             parcLog_Error(athena->log, "Unable to remove interest (%s) from the PIT.", name);
+            parcMemory_Deallocate(&name);
+        }
+        if (parcLog_IsLoggable(athena->log, PARCLogLevel_Debug)) {
+            const char *name = ccnxName_ToString(ccnxName);
+            parcLog_Debug(athena->log, "Name (%s) not found in FIB and no default route. Message dropped.", name);
+            parcMemory_Deallocate(&name);
         }
-        parcLog_Debug(athena->log, "Name (%s) not found in FIB and no default route. Message dropped.", name);
-        parcMemory_Deallocate(&name);
     }
 }
 
@@ -255,15 +475,81 @@ _processInterestReturn(Athena *athena, CCNxInterestReturn *interestReturn, PARCB
     // otherwise, may try another forwarding path or clear the PIT state and forward the interest return on the reverse path
 }
 
+static uint64_t
+_nowInMillis(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+}
+
+/**
+ * Size of a message as it was received, headers, name and signature included.
+ */
+static size_t
+_messageSizeInBytes(CCNxContentObject *contentObject)
+{
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(contentObject);
+    if (wireFormat != NULL) {
+        return parcBuffer_Limit(wireFormat);
+    }
+
+    size_t sizeInBytes = 0;
+    CCNxCodecNetworkBufferIoVec *iovec = ccnxWireFormatMessage_GetIoVec(contentObject);
+    if (iovec != NULL) {
+        size_t iovcnt = ccnxCodecNetworkBufferIoVec_GetCount(iovec);
+        const struct iovec *array = ccnxCodecNetworkBufferIoVec_GetArray(iovec);
+        for (int i = 0; i < iovcnt; i++) {
+            sizeInBytes += array[i].iov_len;
+        }
+    }
+    return sizeInBytes;
+}
+
+/**
+ * Unsolicited Content Objects are only stored if they came from a link trusted to push content and fit
+ * in its quota, they are then subject to the content store's eviction policy like any other content.
+ */
+static void
+_admitPushedContentObject(Athena *athena, CCNxContentObject *contentObject, PARCBitVector *ingressVector)
+{
+    size_t sizeInBytes = _messageSizeInBytes(contentObject);
+    int linkId = parcBitVector_NextBitSet(ingressVector, 0);
+
+    if (athenaTransportLinkAdapter_AdmitPush(athena->athenaTransportLinkAdapter, linkId, sizeInBytes, _nowInMillis())) {
+        athenaContentStore_PutContentObject(athena->athenaContentStore, contentObject);
+        athenaStats_Increment(athena->stats, AthenaCounter_PushedContentObjects);
+        athenaStats_Add(athena->stats, AthenaCounter_PushedBytes, sizeInBytes);
+    } else {
+        athenaStats_Increment(athena->stats, AthenaCounter_UnsolicitedContentObjects);
+        if (parcLog_IsLoggable(athena->log, PARCLogLevel_Debug)) {
+            const char *name = ccnxName_ToString(ccnxContentObject_GetName(contentObject));
+            parcLog_Debug(athena->log, "Unsolicited Content Object (%s) from link %d dropped.", name, linkId);
+            parcMemory_Deallocate(&name);
+        }
+    }
+}
+
 static void
 _processContentObject(Athena *athena, CCNxContentObject *contentObject, PARCBitVector *ingressVector)
 {
     //
-    // *   (1) If it does not match anything in the PIT, drop it
+    // *   (1) If it does not match anything in the PIT, drop it unless it was pushed by a trusted link
     //
     PARCBitVector *egressVector = athenaPIT_Match(athena->athenaPIT, contentObject, ingressVector);
     if (egressVector) {
-        if (parcBitVector_NumberOfBitsSet(egressVector) > 0) {
+        bool warmed = false;
+        if (athena->warm) {
+            PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+            warmed = athenaWarm_Fetched(athena->warm, ccnxContentObject_GetName(contentObject),
+                                        payload ? parcBuffer_Remaining(payload) : 0);
+        }
+        if ((parcBitVector_NumberOfBitsSet(egressVector) == 0) && warmed) {
+            //
+            // *   Fetched by a warming job, nobody downstream is waiting for it yet
+            //
+            athenaContentStore_PutContentObject(athena->athenaContentStore, contentObject);
+        } else if (parcBitVector_NumberOfBitsSet(egressVector) > 0) {
             //
             // *   (2) Add to the Content Store
             //
@@ -272,55 +558,343 @@ _processContentObject(Athena *athena, CCNxContentObject *contentObject, PARCBitV
             //
             // *   (3) Reverse path forward it via PIT entries
             //
-            const char *egressVectorString = parcBitVector_ToString(egressVector);
-            parcLog_Debug(athena->log, "Content Object forwarded to %s.", egressVectorString);
-            parcMemory_Deallocate(&egressVectorString);
-            PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, contentObject, egressVector);
+            if (parcLog_IsLoggable(athena->log, PARCLogLevel_Debug)) {
+                const char *egressVectorString = parcBitVector_ToString(egressVector);
+                parcLog_Debug(athena->log, "Content Object forwarded to %s.", egressVectorString);
+                parcMemory_Deallocate(&egressVectorString);
+            }
+            PARCBitVector *result;
+            if (athena->fanout && (parcBitVector_NumberOfBitsSet(egressVector) >= athenaFanout_GetThreshold(athena->fanout))) {
+                // Too many links to send to in turn without holding up the messages behind this one
+                result = athenaFanout_Send(athena->fanout, athena->athenaTransportLinkAdapter, contentObject, egressVector);
+            } else {
+                result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, contentObject, egressVector);
+            }
             if (result) {
                 // if there are failed channels, client will resend interest unless we wish to retry here
                 parcBitVector_Release(&result);
             }
+        } else {
+            //
+            // *   (4) Nobody downstream is waiting, but it may be the answer to a refresh of stale content
+            //
+            athenaContentStore_PutRefresh(athena->athenaContentStore, contentObject);
         }
         parcBitVector_Release(&egressVector);
+    } else {
+        _admitPushedContentObject(athena, contentObject, ingressVector);
     }
 }
 
 void
 athena_ProcessMessage(Athena *athena, CCNxMetaMessage *ccnxMessage, PARCBitVector *ingressVector)
 {
+    // Debug strings are only built when debug logging is enabled, this is the per-message hot path
+    bool debugEnabled = parcLog_IsLoggable(athena->log, PARCLogLevel_Debug);
+
     if (ccnxMetaMessage_IsInterest(ccnxMessage)) {
-        const char *name = ccnxName_ToString(ccnxInterest_GetName(ccnxMessage));
-        parcLog_Debug(athena->log, "Processing Interest Message: %s", name);
-        parcMemory_Deallocate(&name);
+        if (debugEnabled) {
+            const char *name = ccnxName_ToString(ccnxInterest_GetName(ccnxMessage));
+            parcLog_Debug(athena->log, "Processing Interest Message: %s", name);
+            parcMemory_Deallocate(&name);
+        }
 
         CCNxInterest *interest = ccnxMetaMessage_GetInterest(ccnxMessage);
         _processInterest(athena, interest, ingressVector);
-        athena->stats.numProcessedInterests++;
+        athenaStats_Increment(athena->stats, AthenaCounter_ProcessedInterests);
     } else if (ccnxMetaMessage_IsContentObject(ccnxMessage)) {
-        const char *name = ccnxName_ToString(ccnxContentObject_GetName(ccnxMessage));
-        parcLog_Debug(athena->log, "Processing Content Object Message: %s", name);
-        parcMemory_Deallocate(&name);
+        if (debugEnabled) {
+            const char *name = ccnxName_ToString(ccnxContentObject_GetName(ccnxMessage));
+            parcLog_Debug(athena->log, "Processing Content Object Message: %s", name);
+            parcMemory_Deallocate(&name);
+        }
 
         CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(ccnxMessage);
         _processContentObject(athena, contentObject, ingressVector);
-        athena->stats.numProcessedContentObjects++;
+        athenaStats_Increment(athena->stats, AthenaCounter_ProcessedContentObjects);
     } else if (ccnxMetaMessage_IsControl(ccnxMessage)) {
         parcLog_Debug(athena->log, "Processing Control Message");
 
         CCNxControl *control = ccnxMetaMessage_GetControl(ccnxMessage);
         _processControl(athena, control, ingressVector);
-        athena->stats.numProcessedControlMessages++;
+        athenaStats_Increment(athena->stats, AthenaCounter_ProcessedControlMessages);
     } else if (ccnxMetaMessage_IsInterestReturn(ccnxMessage)) {
         parcLog_Debug(athena->log, "Processing Interest Return Message");
 
         CCNxInterestReturn *interestReturn = ccnxMetaMessage_GetInterestReturn(ccnxMessage);
         _processInterestReturn(athena, interestReturn, ingressVector);
-        athena->stats.numProcessedInterestReturns++;
+        athenaStats_Increment(athena->stats, AthenaCounter_ProcessedInterestReturns);
     } else {
         trapUnexpectedState("Invalid CCNxMetaMessage type");
     }
 }
 
+bool
+athena_ContinuePurge(Athena *athena)
+{
+    if (athena->purge.prefix == NULL) {
+        return false;
+    }
+
+    size_t bytesFreed = 0;
+    size_t numPurged = athenaContentStore_PurgePrefix(athena->athenaContentStore, athena->purge.prefix,
+                                                      AthenaPurgeEntriesPerSlice, &bytesFreed);
+    athena->purge.numEntries += numPurged;
+    athena->purge.sizeInBytes += bytesFreed;
+    athenaStats_Add(athena->stats, AthenaCounter_PurgedEntries, numPurged);
+    athenaStats_Add(athena->stats, AthenaCounter_PurgedBytes, bytesFreed);
+
+    if (numPurged < AthenaPurgeEntriesPerSlice) {
+        const char *prefix = ccnxName_ToString(athena->purge.prefix);
+        parcLog_Info(athena->log, "Purged %zu entries (%zu bytes) under %s",
+                     athena->purge.numEntries, athena->purge.sizeInBytes, prefix);
+        parcMemory_Deallocate(&prefix);
+        ccnxName_Release(&athena->purge.prefix);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Fetch a name for a warming job as if a consumer had asked for it, the Interest is entered in the PIT
+ * with no ingress links so that the Content Object returned is only stored.
+ */
+static void
+_warmName(Athena *athena, CCNxName *ccnxName, uint64_t nowInMillis)
+{
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxName);
+
+    // Looking must not count as a use, or warming would reorder eviction and restore compressed entries
+    if (athenaContentStore_ContainsMatch(athena->athenaContentStore, interest)) {
+        athenaWarm_Hit(athena->warm);
+        ccnxInterest_Release(&interest);
+        return;
+    }
+
+    PARCBitVector *noIngressVector = parcBitVector_Create();
+    PARCBitVector *expectedReturnVector;
+    AthenaPITResolution resolution = athenaPIT_AddInterest(athena->athenaPIT, interest, noIngressVector, &expectedReturnVector);
+    if (resolution == AthenaPITResolution_Aggregated) {
+        // Already being fetched for a consumer, the Content Object is stored when it arrives
+        athenaWarm_Miss(athena->warm, ccnxName, nowInMillis + ccnxInterest_GetLifetime(interest));
+    } else if (resolution == AthenaPITResolution_Forward) {
+        PARCBitVector *egressVector = athenaFIB_Lookup(athena->athenaFIB, ccnxName);
+        if ((egressVector != NULL) && (parcBitVector_NumberOfBitsSet(egressVector) > 0)) {
+            parcBitVector_SetVector(expectedReturnVector, egressVector);
+            PARCBitVector *result = athenaTransportLinkAdapter_Send(athena->athenaTransportLinkAdapter, interest, egressVector);
+            if (result) {
+                parcBitVector_ClearVector(expectedReturnVector, result);
+                parcBitVector_Release(&result);
+            }
+            athenaWarm_Miss(athena->warm, ccnxName, nowInMillis + ccnxInterest_GetLifetime(interest));
+        } else {
+            athenaPIT_RemoveInterest(athena->athenaPIT, interest, noIngressVector);
+            athenaWarm_NoRoute(athena->warm);
+        }
+    }
+
+    parcBitVector_Release(&noIngressVector);
+    ccnxInterest_Release(&interest);
+}
+
+bool
+athena_ContinueWarm(Athena *athena)
+{
+    if (athena->warm == NULL) {
+        return false;
+    }
+
+    uint64_t nowInMillis = _nowInMillis();
+    CCNxName *ccnxName;
+    for (size_t i = 0; (i < AthenaWarmInterestsPerSlice) && ((ccnxName = athenaWarm_CreateNextName(athena->warm, nowInMillis)) != NULL); i++) {
+        _warmName(athena, ccnxName, nowInMillis);
+        ccnxName_Release(&ccnxName);
+    }
+
+    if (athenaWarm_IsComplete(athena->warm, nowInMillis)) {
+        AthenaWarmStats stats;
+        athenaWarm_GetStats(athena->warm, &stats);
+        parcLog_Info(athena->log, "Warmed %" PRIu64 " names from %s: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " fetched (%" PRIu64 " bytes), %" PRIu64 " unanswered, %" PRIu64 " without a route",
+                     stats.numIssued, athenaWarm_GetListPath(athena->warm), stats.numHits, stats.numMisses,
+                     stats.numFetched, stats.bytesFetched, stats.numPending, stats.numNoRoute);
+        athenaWarm_Release(&athena->warm);
+        return false;
+    }
+    return true;
+}
+
+bool
+athena_SweepExpired(Athena *athena)
+{
+    uint64_t nowInMillis = _nowInMillis();
+
+    if (nowInMillis < athena->nextSweepTime) {
+        return false;
+    }
+
+    size_t numSwept = athenaContentStore_SweepExpired(athena->athenaContentStore, AthenaSweepEntriesPerSlice);
+    athenaStats_Add(athena->stats, AthenaCounter_SweptEntries, numSwept);
+    athenaStats_Add(athena->stats, AthenaCounter_ExpiredRouteLeases, athenaFIB_ExpireLeases(athena->athenaFIB, nowInMillis));
+
+    bool sweepBacklog = (numSwept == AthenaSweepEntriesPerSlice);
+    athena->nextSweepTime = sweepBacklog ? nowInMillis : nowInMillis + AthenaSweepIntervalMillis;
+    return sweepBacklog;
+}
+
+bool
+athena_Reload(Athena *athena, const char *configPath, AthenaConfigChanges *changes)
+{
+    if (configPath == NULL) {
+        configPath = athena->configPath;
+    }
+    if (configPath == NULL) {
+        parcLog_Error(athena->log, "No configuration file to reload");
+        return false;
+    }
+
+    AthenaConfig *config = athenaConfig_Read(configPath, athena->log);
+    if (config == NULL) {
+        parcLog_Error(athena->log, "Configuration %s not applied, running configuration left in place", configPath);
+        return false;
+    }
+    if (athenaConfig_Apply(athena->config, config, athena->athenaTransportLinkAdapter, athena->athenaFIB,
+                           athena->athenaContentStore, athena->log, changes) == false) {
+        parcLog_Error(athena->log, "Configuration %s not applied, running configuration left in place", configPath);
+        athenaConfig_Release(&config);
+        return false;
+    }
+
+    if (athena->config) {
+        athenaConfig_Release(&athena->config);
+    }
+    athena->config = config;
+    if (configPath != athena->configPath) {
+        if (athena->configPath) {
+            parcMemory_Deallocate(&athena->configPath);
+        }
+        athena->configPath = parcMemory_StringDuplicate(configPath, strlen(configPath));
+    }
+    athenaStats_Increment(athena->stats, AthenaCounter_ConfigReloads);
+    _resolveFIBImageLinks(athena);
+    return true;
+}
+
+bool
+athena_LoadFIBImage(Athena *athena, const char *imagePath)
+{
+    AthenaFIBImage *image = athenaFIBImage_Open(imagePath, athena->log);
+    if (image == NULL) {
+        return false;
+    }
+    athenaFIB_SetImage(athena->athenaFIB, image);
+    parcLog_Info(athena->log, "Loaded %zu routes from FIB image %s", athenaFIBImage_GetNumberOfRoutes(image), imagePath);
+    athenaFIBImage_Release(&image);
+    _resolveFIBImageLinks(athena);
+    return true;
+}
+
+bool
+athena_OpenRouteFeed(Athena *athena, const char *socketPath)
+{
+    AthenaRouteFeed *routeFeed = athenaRouteFeed_Create(socketPath, athena->log);
+    if (routeFeed == NULL) {
+        return false;
+    }
+    if (athena->routeFeed) {
+        athenaRouteFeed_Release(&athena->routeFeed);
+    }
+    athena->routeFeed = routeFeed;
+    parcLog_Info(athena->log, "Accepting routes on %s", socketPath);
+    return true;
+}
+
+bool
+athena_StartFanout(Athena *athena, size_t numWorkers, size_t threshold)
+{
+    AthenaFanout *fanout = athenaFanout_Create(numWorkers, threshold, athena->log);
+    if (fanout == NULL) {
+        return false;
+    }
+    if (athena->fanout) {
+        athenaFanout_Release(&athena->fanout);
+    }
+    athena->fanout = fanout;
+    parcLog_Info(athena->log, "Fanning out to %zu or more links over %zu workers", threshold, numWorkers);
+    return true;
+}
+
+void
+athena_ReloadSignalHandler(int signalNumber)
+{
+    _athenaReloadSignals++;
+}
+
+static void
+_saveContentStoreSnapshot(Athena *athena, const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        parcLog_Error(athena->log, "Unable to save content store snapshot to %s: %s", path, strerror(errno));
+        return;
+    }
+
+    AthenaSnapshot *snapshot = athenaContentStore_CreateSnapshot(athena->athenaContentStore);
+    if (snapshot) {
+        size_t numChunks = athenaSnapshot_GetNumberOfChunks(snapshot, AthenaDumpEntriesPerChunk);
+        for (size_t chunkNumber = 0; chunkNumber < numChunks; chunkNumber++) {
+            PARCJSON *chunk = athenaSnapshot_CreateChunk(snapshot, chunkNumber, AthenaDumpEntriesPerChunk);
+            char *chunkString = parcJSON_ToCompactString(chunk);
+            fprintf(file, "%s\n", chunkString);
+            parcMemory_Deallocate(&chunkString);
+            parcJSON_Release(&chunk);
+        }
+        parcLog_Info(athena->log, "Saved %zu content store entries to %s", athenaSnapshot_GetSize(snapshot), path);
+        athenaSnapshot_Release(&snapshot);
+    }
+    fclose(file);
+}
+
+static void
+_returnPendingNoRoute(void *context, CCNxInterest *interest, PARCBitVector *ingressVector)
+{
+    if (parcBitVector_NumberOfBitsSet(ingressVector) > 0) {
+        _returnNoRoute((Athena *) context, interest, ingressVector);
+    }
+}
+
+size_t
+athena_Drain(Athena *athena)
+{
+    athena->athenaState = Athena_Draining;
+
+    // Answer everything pending, refreshes issued by the forwarder itself have no one to answer
+    size_t numReturned = athenaPIT_RemoveAllPending(athena->athenaPIT, _returnPendingNoRoute, athena);
+    parcLog_Info(athena->log, "Draining, returned %zu pending interests", numReturned);
+
+    if (athena->drainSnapshotPath) {
+        _saveContentStoreSnapshot(athena, athena->drainSnapshotPath);
+    }
+
+    // Flush what other threads queued, refusing any interests that arrive in the meantime
+    PARCBitVector *ingressVector;
+    uint64_t deadline = _nowInMillis() + AthenaDrainTimeoutMillis;
+    while (athenaTransportLinkAdapter_FlushSendQueues(athena->athenaTransportLinkAdapter) && (_nowInMillis() < deadline)) {
+        CCNxMetaMessage *ccnxMessage = athenaTransportLinkAdapter_Receive(athena->athenaTransportLinkAdapter, &ingressVector, 1);
+        if (ccnxMessage) {
+            athena_ProcessMessage(athena, ccnxMessage, ingressVector);
+            parcBitVector_Release(&ingressVector);
+            ccnxMetaMessage_Release(&ccnxMessage);
+            athenaScratch_Reset();
+        }
+    }
+    if (athenaTransportLinkAdapter_FlushSendQueues(athena->athenaTransportLinkAdapter)) {
+        parcLog_Error(athena->log, "Sends still queued after draining for %d ms, exiting anyway", AthenaDrainTimeoutMillis);
+    }
+
+    athena->athenaState = Athena_Exit;
+    return numReturned;
+}
+
 void
 athena_EncodeMessage(CCNxMetaMessage *message)
 {
@@ -337,10 +911,21 @@ athena_ForwarderEngine(void *arg)
     Athena *athena = (Athena *) arg;
 
     if (athena) {
+        bool sweepBacklog = false;
+        bool dumpBacklog = false;
         while (athena->athenaState == Athena_Running) {
             CCNxMetaMessage *ccnxMessage;
             PARCBitVector *ingressVector;
-            int receiveTimeout = -1; // block until message received
+            int receiveTimeout = AthenaSweepIntervalMillis; // wake up to sweep expired content if idle
+            if (athena->routeFeed) {
+                receiveTimeout = AthenaRouteFeedIntervalMillis; // pick up route changes promptly
+            }
+            if (athena->warm) {
+                receiveTimeout = AthenaWarmIntervalMillis; // issue warming interests at their rate
+            }
+            if (athena->purge.prefix || sweepBacklog || dumpBacklog) {
+                receiveTimeout = 0;  // poll, so pending purges, sweeps and dumps advance between messages
+            }
             ccnxMessage = athenaTransportLinkAdapter_Receive(athena->athenaTransportLinkAdapter,
                                                              &ingressVector, receiveTimeout);
             if (ccnxMessage) {
@@ -348,9 +933,27 @@ athena_ForwarderEngine(void *arg)
 
                 parcBitVector_Release(&ingressVector);
                 ccnxMetaMessage_Release(&ccnxMessage);
+
+                // Nothing allocated from the scratch arena while handling a message outlives it
+                athenaScratch_Reset();
+            }
+            if (athena->routeFeed) {
+                athenaStats_Add(athena->stats, AthenaCounter_RouteFeedChanges,
+                                athenaRouteFeed_Apply(athena->routeFeed, athena->athenaTransportLinkAdapter, athena->athenaFIB));
+            }
+            athena_ContinuePurge(athena);
+            athena_ContinueWarm(athena);
+            sweepBacklog = athena_SweepExpired(athena);
+            dumpBacklog = athenaInterestControl_ContinueDumps(athena);
+
+            if (athena->reloadSignals != _athenaReloadSignals) {
+                athena->reloadSignals = _athenaReloadSignals;
+                if (athena->configPath) {
+                    athena_Reload(athena, NULL, NULL);
+                }
             }
         }
-        usleep(1000); // workaround for coordinating with test infrastructure
+        athena_Drain(athena);
         athena_Release(&athena);
     }
     return NULL;
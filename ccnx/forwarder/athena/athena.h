@@ -41,10 +41,26 @@
 #include <ccnx/forwarder/athena/athena_ContentStore.h>
 #include <ccnx/forwarder/athena/athena_PIT.h>
 #include <ccnx/forwarder/athena/athena_FIB.h>
+#include <ccnx/forwarder/athena/athena_NamePool.h>
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
+#include <ccnx/forwarder/athena/athena_Config.h>
+#include <ccnx/forwarder/athena/athena_RouteFeed.h>
+#include <ccnx/forwarder/athena/athena_Fanout.h>
+#include <ccnx/forwarder/athena/athena_Warm.h>
+#include <ccnx/forwarder/athena/athena_Stats.h>
 
 #define AthenaDefaultConnectionURI "tcp://localhost:9695/Listener"
 #define AthenaDefaultContentStoreSize 0
 #define AthenaDefaultListenerPort 9695
+#define AthenaDefaultPITCapacity 100000
+#define AthenaDumpEntriesPerChunk 64
+#define AthenaDumpsOutstanding 4
+#define AthenaDumpIdMaxLength 32
+#define AthenaDumpEntriesPerSlice 256
+#define AthenaPurgeEntriesPerSlice 256
+#define AthenaSweepIntervalMillis 100
+#define AthenaSweepEntriesPerSlice 64
+#define AthenaDrainTimeoutMillis 2000
 
 /**
  * @typedef AthenaTransportLinkFlag
@@ -52,9 +68,32 @@
  */
 typedef enum {
     Athena_Exit = 0x00,
-    Athena_Running = 0x01
+    Athena_Running = 0x01,
+    Athena_Draining = 0x02 // refusing new interests and flushing sends before exiting
 } AthenaState;
 
+/**
+ * @typedef AthenaCounter
+ * @brief Forwarder counters, kept per thread in Athena stats
+ */
+typedef enum {
+    AthenaCounter_ProcessedInterests,
+    AthenaCounter_ProcessedContentObjects,
+    AthenaCounter_ProcessedInterestReturns,
+    AthenaCounter_ProcessedControlMessages,
+    AthenaCounter_RefreshedContentObjects,
+    AthenaCounter_SweptEntries,
+    AthenaCounter_PurgedEntries,
+    AthenaCounter_PurgedBytes,
+    AthenaCounter_ConfigReloads,
+    AthenaCounter_RouteFeedChanges,
+    AthenaCounter_ExpiredRouteLeases,
+    AthenaCounter_PushedContentObjects,      // unsolicited, admitted from trusted-push links
+    AthenaCounter_PushedBytes,
+    AthenaCounter_UnsolicitedContentObjects, // unsolicited and dropped
+    AthenaCounter_Count
+} AthenaCounter;
+
 /**
  * @typedef Athena∫
  * @brief private data for Athena daemon
@@ -62,18 +101,42 @@ typedef enum {
 typedef struct Athena {
     CCNxName *athenaName;
     AthenaState athenaState;
+    AthenaNamePool *namePool;
     AthenaTransportLinkAdapter *athenaTransportLinkAdapter;
     AthenaPIT *athenaPIT;
     AthenaFIB *athenaFIB;
     AthenaContentStore *athenaContentStore;
     PARCLog *log;
+    PARCLogReporter *logReporter;
+    struct {
+        char *dumpId;                 // chosen by the client for each dump, NULL if the slot is free
+        AthenaSnapshot *snapshot;     // table snapshot being dumped, later chunks are rendered from it
+        AthenaPITWalk *pitWalk;       // walk still filling a PIT snapshot, NULL once it is complete
+        AthenaContentStore *store;    // content store still being walked to fill the snapshot, or NULL
+        AthenaContentStoreWalk *storeWalk;
+        uint64_t lastUsed;            // dumpSequence when a chunk was last rendered from it
+    } dumps[AthenaDumpsOutstanding];
+    uint64_t dumpSequence;
 
     struct {
-        uint64_t numProcessedInterests;
-        uint64_t numProcessedContentObjects;
-        uint64_t numProcessedInterestReturns;
-        uint64_t numProcessedControlMessages;
-    } stats;
+        CCNxName *prefix;             // prefix of the content store purge in progress, NULL if none
+        size_t numEntries;            // entries removed by it so far
+        size_t sizeInBytes;           // content store capacity freed by it so far
+    } purge;
+
+    uint64_t nextSweepTime;           // when expired content store entries are next swept
+
+    char *configPath;                 // configuration file re-read on reload, NULL if none
+    AthenaConfig *config;             // configuration last applied, NULL if none
+    unsigned reloadSignals;           // reload signals handled so far
+
+    AthenaRouteFeed *routeFeed;       // routes streamed from a routing daemon, NULL if none
+    AthenaFanout *fanout;             // workers sending large Content Object fan-outs, NULL if none
+    AthenaWarm *warm;                 // content store warming job in progress, NULL if none
+
+    AthenaStats *stats;               // AthenaCounter counts, summed over the threads updating them
+
+    char *drainSnapshotPath;          // content store snapshot written when draining, NULL if none
 
 } Athena;
 
@@ -101,6 +164,17 @@ typedef struct Athena {
 #define AthenaCommand_Quit   "quit"
 #define AthenaCommand_Run    "spawn"
 #define AthenaCommand_Stats  "stats"
+#define AthenaCommand_Dump   "dump"
+#define AthenaCommand_Purge  "purge"
+#define AthenaCommand_Stale  "stale"
+#define AthenaCommand_Warm   "warm"
+#define AthenaCommand_Reload "reload"
+#define AthenaCommand_Drain  "drain"
+
+#define AthenaDump_FIB          "fib"
+#define AthenaDump_PIT          "pit"
+#define AthenaDump_ContentStore "cs"
+#define AthenaDump_Links        "links"
 
 #define AthenaCommand_LogLevel  "level"
 #define AthenaCommand_LogDebug  "debug"
@@ -120,10 +194,16 @@ typedef struct Athena {
 #define CCNxNameAthenaCommand_FIBRemoveRoute     CCNxNameAthena_FIB "/" AthenaCommand_Remove                  // remove route for arguments in payload
 #define CCNxNameAthenaCommand_PITLookup          CCNxNameAthena_PIT "/" AthenaCommand_Lookup                  // return current PIT contents for name in payload
 #define CCNxNameAthenaCommand_ContentStoreResize CCNxNameAthena_ContentStore "/" AthenaCommand_Resize         // resize current content store to size in MB in payload
-#define CCNxNameAthenaCommand_Quit               CCNxNameAthena_Control "/" AthenaCommand_Quit                // ask the forwarder to exit
+#define CCNxNameAthenaCommand_ContentStorePurge  CCNxNameAthena_ContentStore "/" AthenaCommand_Purge          // purge cached content under the prefix in payload
+#define CCNxNameAthenaCommand_ContentStoreStale  CCNxNameAthena_ContentStore "/" AthenaCommand_Stale          // set the stale window for the "<prefix> <milliseconds>" in payload
+#define CCNxNameAthenaCommand_ContentStoreWarm   CCNxNameAthena_ContentStore "/" AthenaCommand_Warm           // warm the store from the "<name list file> [<interests per second>]" in payload
+#define CCNxNameAthenaCommand_Quit               CCNxNameAthena_Control "/" AthenaCommand_Quit                // ask the forwarder to drain and exit
+#define CCNxNameAthenaCommand_Drain              CCNxNameAthena_Control "/" AthenaCommand_Drain               // drain and exit, local links only
 #define CCNxNameAthenaCommand_Run                CCNxNameAthena_Control "/" AthenaCommand_Run                 // start a new forwarder instance
 #define CCNxNameAthenaCommand_Set                CCNxNameAthena_Control "/" AthenaCommand_Set                 // set a forwarder variable
+#define CCNxNameAthenaCommand_Reload             CCNxNameAthena_Control "/" AthenaCommand_Reload              // re-read the configuration, from the file in payload if any
 #define CCNxNameAthenaCommand_Stats              CCNxNameAthena_Control "/" AthenaCommand_Stats               // get forwarder stats
+#define CCNxNameAthenaCommand_Dump               CCNxNameAthena_Control "/" AthenaCommand_Dump                // dump a chunk of a forwarder table snapshot, /<table>/<dump id>[/chunk=<n>]
 
 /**
  * @abstract create an Athena forwarder instance
@@ -143,6 +223,93 @@ typedef struct Athena {
  */
 Athena *athena_Create(size_t contentStoreSizeInMB);
 
+/**
+ * @abstract replace the content store of an Athena forwarder instance
+ * @discussion
+ *
+ * The forwarder acquires a reference to the provided store and releases its previous store.
+ * Forwarder instances running on different threads may share a store only if its implementation
+ * is safe for concurrent use, such as AthenaContentStore_ShardedImplementation.
+ *
+ * @param [in] athena instance
+ * @param [in] contentStore content store to use
+ *
+ * Example:
+ * @code
+ * {
+ *     Athena *athena = athena_Create(10);
+ *     AthenaShardedContentStoreConfig config = { .capacityInMB = 10, .numShards = 16 };
+ *     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_ShardedImplementation, &config);
+ *
+ *     athena_SetContentStore(athena, store);
+ *     athenaContentStore_Release(&store);
+ *     ...
+ *     athena_Release(&athena);
+ * }
+ * @endcode
+ */
+void athena_SetContentStore(Athena *athena, AthenaContentStore *contentStore);
+
+/**
+ * @abstract set the file the content store is saved to when the forwarder drains
+ * @discussion
+ *
+ * Only set from the command line, the drain command can't name the file.
+ *
+ * @param [in] athena instance
+ * @param [in] path snapshot file, NULL for none
+ *
+ * Example:
+ * @code
+ * {
+ *     athena_SetDrainSnapshotPath(athena, "/var/cache/athena/contentstore.json");
+ * }
+ * @endcode
+ */
+void athena_SetDrainSnapshotPath(Athena *athena, const char *path);
+
+/**
+ * @abstract start a new forwarder instance on its own thread
+ * @discussion
+ *
+ * The new instance is given a single link opened from the connection specification and shares the
+ * content store of the spawning instance if it can be used concurrently.  It runs until told to quit.
+ *
+ * @param [in] athena spawning instance
+ * @param [in] connectionSpecification link for the new instance
+ * @return true if the new instance was started
+ *
+ * Example:
+ * @code
+ * {
+ *     athena_Spawn(athena, "tcp://localhost:9696/listener");
+ * }
+ * @endcode
+ */
+bool athena_Spawn(Athena *athena, const char *connectionSpecification);
+
+/**
+ * @abstract open a link on a forwarder instance
+ * @discussion
+ *
+ * Opens the link on the instance's link adapter, then points any FIB image routes that name the
+ * link at it.  Links are served by this instance's forwarding thread; listener shards (/shards=<n>
+ * with n greater than 1) are refused, since a shard on a forwarder of its own would have its own
+ * empty FIB and PIT and drop the traffic the kernel hands it.
+ *
+ * @param [in] athena instance
+ * @param [in] connectionSpecification link to open
+ * @return name of the link opened, or NULL with errno set on failure
+ *
+ * Example:
+ * @code
+ * {
+ *     const char *linkName = athena_OpenLink(athena, "udp://0.0.0.0:9695/listener");
+ * }
+ * @endcode
+ */
+const char *athena_OpenLink(Athena *athena, const char *connectionSpecification);
+
 /**
  * @abstract acquire a reference to an Athena forwarder instance
  * @discussion
@@ -206,6 +373,207 @@ void athena_Release(Athena **athena);
  */
 void athena_ProcessMessage(Athena *athena, CCNxMetaMessage *ccnxMessage, PARCBitVector *ingressVector);
 
+/**
+ * @abstract continue a pending content store purge
+ * @discussion
+ *
+ * Removes at most AthenaPurgeEntriesPerSlice more entries under the prefix of the purge in progress,
+ * so that a purge of a large prefix is spread over the forwarder loop rather than stalling it.
+ * When nothing is left under the prefix the purge is logged and cleared.
+ *
+ * @param [in] athena forwarder context
+ * @return true if the purge is still in progress
+ *
+ * Example:
+ * @code
+ * {
+ *     while (athena_ContinuePurge(athena)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athena_ContinuePurge(Athena *athena);
+
+/**
+ * @abstract continue a content store warming job
+ * @discussion
+ *
+ * Issues as many Interests for the job's names as its rate allows, at most
+ * AthenaWarmInterestsPerSlice, through the PIT and FIB as if a consumer had sent them.  Names
+ * already in the content store are counted as hits and not fetched.  When the job is complete its
+ * counts are logged and it is cleared.
+ *
+ * @param [in] athena forwarder context
+ * @return true if the job is still in progress
+ *
+ * Example:
+ * @code
+ * {
+ *     athena->warm = athenaWarm_Create(listPath, 500, nowInMillis, athena->log);
+ *     while (athena_ContinueWarm(athena)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athena_ContinueWarm(Athena *athena);
+
+/**
+ * @abstract sweep expired content from the content store
+ * @discussion
+ *
+ * Once every AthenaSweepIntervalMillis, removes at most AthenaSweepEntriesPerSlice entries that have
+ * passed their expiry time, so that their space is reclaimed steadily rather than when an insert needs it.
+ * If the slice was full the next sweep is due immediately.  Routes whose leases have run out are
+ * removed from the FIB on the same schedule.
+ *
+ * @param [in] athena forwarder context
+ * @return true if more expired entries may remain and the next sweep is due
+ *
+ * Example:
+ * @code
+ * {
+ *     bool sweepBacklog = athena_SweepExpired(athena);
+ * }
+ * @endcode
+ */
+bool athena_SweepExpired(Athena *athena);
+
+/**
+ * @abstract reload the forwarder configuration
+ * @discussion
+ *
+ * Reads the configuration file and applies only what differs from the configuration last applied,
+ * see athenaConfig_Apply.  Pending interests, cached content and links that are unaffected by the
+ * changes are kept.  If the file can't be read or applied the running configuration is left in place.
+ * A path given here becomes the one re-read by later reloads once it has been applied.
+ *
+ * Must be called from the thread running the forwarder.
+ *
+ * @param [in] athena forwarder context
+ * @param [in] configPath configuration file to read, or NULL to re-read the current one
+ * @param [out] changes counts of the changes made, may be NULL
+ * @return true if the configuration was applied
+ *
+ * Example:
+ * @code
+ * {
+ *     if (athena_Reload(athena, "/etc/athena.conf", NULL) == false) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athena_Reload(Athena *athena, const char *configPath, AthenaConfigChanges *changes);
+
+/**
+ * @abstract signal handler requesting a configuration reload
+ * @discussion
+ *
+ * Installed for SIGHUP by the athena runtime.  Only notes the signal, each forwarder instance with a
+ * configuration file reloads it from its own loop the next time it wakes up.
+ *
+ * @param [in] signalNumber signal received
+ *
+ * Example:
+ * @code
+ * {
+ *     signal(SIGHUP, athena_ReloadSignalHandler);
+ * }
+ * @endcode
+ */
+void athena_ReloadSignalHandler(int signalNumber);
+
+/**
+ * @abstract route from a compiled FIB image
+ * @discussion
+ *
+ * Maps an image written by athenaFIBImage_Compile and sets it beneath the forwarder's FIB, see
+ * athenaFIB_SetImage.  The image is shared, not copied, so loading a large route table costs a
+ * single mapping.  Image routes forward to links that are open under the names the image gives,
+ * including links opened later.  A previously loaded image is replaced.
+ *
+ * @param [in] athena forwarder context
+ * @param [in] imagePath file holding the image
+ * @return true if the image was loaded
+ *
+ * Example:
+ * @code
+ * {
+ *     athena_LoadFIBImage(athena, "/var/athena/routes.fib");
+ * }
+ * @endcode
+ */
+bool athena_LoadFIBImage(Athena *athena, const char *imagePath);
+
+/**
+ * @abstract accept routes streamed from a routing daemon
+ * @discussion
+ *
+ * Listens for a routing daemon on a Unix domain socket, see athenaRouteFeed_Create.  The forwarder
+ * loop applies the route changes the daemon sends a batch at a time between messages.  A route feed
+ * already open is closed, the routes it installed are kept.
+ *
+ * @param [in] athena forwarder context
+ * @param [in] socketPath path to bind the socket to
+ * @return true if the socket is listening
+ *
+ * Example:
+ * @code
+ * {
+ *     athena_OpenRouteFeed(athena, "/var/run/athena.routes");
+ * }
+ * @endcode
+ */
+bool athena_OpenRouteFeed(Athena *athena, const char *socketPath);
+
+/**
+ * @abstract send Content Objects satisfying Interests from many links in parallel
+ * @discussion
+ *
+ * Starts a pool of workers, see athenaFanout_Create.  A Content Object to be sent on at least
+ * threshold links is then handed to the workers, so the forwarder can process the messages behind it
+ * while they send it.  Smaller fan-outs are still sent by the forwarder.  A pool already started is
+ * replaced, once the fan-outs it was handed have been sent.
+ *
+ * @param [in] athena forwarder context
+ * @param [in] numWorkers number of worker threads
+ * @param [in] threshold fewest links a Content Object is sent on in parallel
+ * @return true if the workers were started
+ *
+ * Example:
+ * @code
+ * {
+ *     athena_StartFanout(athena, 4, AthenaFanoutDefaultThreshold);
+ * }
+ * @endcode
+ */
+bool athena_StartFanout(Athena *athena, size_t numWorkers, size_t threshold);
+
+/**
+ * @abstract drain a forwarder instance before it exits
+ * @discussion
+ *
+ * New interests are refused with a NoRoute Interest Return, and every interest pending in the PIT
+ * is answered the same way so that consumers fail over at once instead of waiting for their
+ * interests to time out.  If a drain snapshot path has been set the content store is saved there,
+ * one JSON chunk per line.  Sends queued on links are then flushed, for at most
+ * AthenaDrainTimeoutMillis, and the instance is left in the Athena_Exit state.  Called by the
+ * forwarder engine once a quit or drain command has been received.
+ *
+ * @param [in] athena forwarder instance
+ * @return number of pending interests answered
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t numReturned = athena_Drain(athena);
+ * }
+ * @endcode
+ */
+size_t athena_Drain(Athena *athena);
+
 /**
  * @abstract encode message into wire format
  * @discussion
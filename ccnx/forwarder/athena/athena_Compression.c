@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena block compression
+ *
+ * Greedy single pass LZ77 emitting LZ4 block format sequences.  Candidate matches come from a
+ * direct mapped hash table of recent 4 byte sequences, which is fast enough to run on the
+ * forwarding thread when entries are moved into the content store's cold segment.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/athena/athena_Compression.h>
+
+#define MIN_MATCH       4       // shortest match that can be encoded
+#define LAST_LITERALS   5       // the final bytes of a block are always literals
+#define MATCH_LIMIT     12      // no match may start within this many bytes of the end
+#define MAX_OFFSET      65535   // largest distance representable in a match offset
+#define HASH_LOG        12
+
+static uint32_t
+_read32(const uint8_t *pointer)
+{
+    uint32_t value;
+    memcpy(&value, pointer, sizeof(value));
+    return value;
+}
+
+static uint32_t
+_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+static uint8_t *
+_putLength(uint8_t *output, size_t length)
+{
+    while (length >= 255) {
+        *output++ = 255;
+        length -= 255;
+    }
+    *output++ = (uint8_t) length;
+    return output;
+}
+
+/**
+ * Emit one sequence, literals optionally followed by a match. Returns false if it does not fit.
+ */
+static bool
+_emitSequence(uint8_t **outputPtr, const uint8_t *outputEnd,
+              const uint8_t *literals, size_t literalLength,
+              bool hasMatch, size_t offset, size_t matchLength)
+{
+    uint8_t *output = *outputPtr;
+
+    size_t required = 1 + literalLength + (literalLength / 255) + 1;
+    if (hasMatch) {
+        required += 2 + (matchLength / 255) + 1;
+    }
+    if ((size_t) (outputEnd - output) < required) {
+        return false;
+    }
+
+    uint8_t *token = output++;
+    if (literalLength >= 15) {
+        *token = 15 << 4;
+        output = _putLength(output, literalLength - 15);
+    } else {
+        *token = (uint8_t) (literalLength << 4);
+    }
+    memcpy(output, literals, literalLength);
+    output += literalLength;
+
+    if (hasMatch) {
+        *output++ = (uint8_t) (offset & 0xff);
+        *output++ = (uint8_t) (offset >> 8);
+        if (matchLength >= 15) {
+            *token |= 15;
+            output = _putLength(output, matchLength - 15);
+        } else {
+            *token |= (uint8_t) matchLength;
+        }
+    }
+
+    *outputPtr = output;
+    return true;
+}
+
+size_t
+athenaCompression_Bound(size_t length)
+{
+    return length + (length / 255) + 16;
+}
+
+size_t
+athenaCompression_Compress(const uint8_t *source, size_t sourceLength, uint8_t *destination, size_t destinationCapacity)
+{
+    uint32_t table[1 << HASH_LOG];
+    memset(table, 0, sizeof(table));
+
+    const uint8_t *input = source;
+    const uint8_t *anchor = source;
+    const uint8_t *inputEnd = source + sourceLength;
+    uint8_t *output = destination;
+    const uint8_t *outputEnd = destination + destinationCapacity;
+
+    if (sourceLength > MATCH_LIMIT) {
+        const uint8_t *matchStartLimit = inputEnd - MATCH_LIMIT;
+        const uint8_t *matchEndLimit = inputEnd - LAST_LITERALS;
+
+        while (input < matchStartLimit) {
+            uint32_t sequence = _read32(input);
+            uint32_t hash = _hash(sequence);
+            const uint8_t *candidate = source + table[hash];
+            table[hash] = (uint32_t) (input - source);
+
+            if (candidate < input && (input - candidate) <= MAX_OFFSET && _read32(candidate) == sequence) {
+                const uint8_t *matchEnd = input + MIN_MATCH;
+                const uint8_t *reference = candidate + MIN_MATCH;
+                while (matchEnd < matchEndLimit && *matchEnd == *reference) {
+                    matchEnd++;
+                    reference++;
+                }
+
+                if (!_emitSequence(&output, outputEnd, anchor, (size_t) (input - anchor),
+                                   true, (size_t) (input - candidate), (size_t) (matchEnd - input) - MIN_MATCH)) {
+                    return 0;
+                }
+                input = matchEnd;
+                anchor = input;
+            } else {
+                input++;
+            }
+        }
+    }
+
+    // The remainder of the block is emitted as a final literal only sequence.
+    if (!_emitSequence(&output, outputEnd, anchor, (size_t) (inputEnd - anchor), false, 0, 0)) {
+        return 0;
+    }
+
+    return (size_t) (output - destination);
+}
+
+static bool
+_getLength(const uint8_t **inputPtr, const uint8_t *inputEnd, size_t *length)
+{
+    const uint8_t *input = *inputPtr;
+    uint8_t byte;
+    do {
+        if (input >= inputEnd) {
+            return false;
+        }
+        byte = *input++;
+        *length += byte;
+    } while (byte == 255);
+    *inputPtr = input;
+    return true;
+}
+
+bool
+athenaCompression_Decompress(const uint8_t *source, size_t sourceLength, uint8_t *destination, size_t destinationLength)
+{
+    const uint8_t *input = source;
+    const uint8_t *inputEnd = source + sourceLength;
+    uint8_t *output = destination;
+    const uint8_t *outputEnd = destination + destinationLength;
+
+    while (input < inputEnd) {
+        uint8_t token = *input++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !_getLength(&input, inputEnd, &literalLength)) {
+            return false;
+        }
+        if (literalLength > (size_t) (inputEnd - input) || literalLength > (size_t) (outputEnd - output)) {
+            return false;
+        }
+        memcpy(output, input, literalLength);
+        input += literalLength;
+        output += literalLength;
+
+        if (input == inputEnd) {
+            break; // the last sequence has no match
+        }
+
+        if ((inputEnd - input) < 2) {
+            return false;
+        }
+        size_t offset = input[0] | ((size_t) input[1] << 8);
+        input += 2;
+        if (offset == 0 || offset > (size_t) (output - destination)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !_getLength(&input, inputEnd, &matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > (size_t) (outputEnd - output)) {
+            return false;
+        }
+
+        // Matches may overlap their own output (e.g. runs), so copy a byte at a time.
+        const uint8_t *reference = output - offset;
+        while (matchLength-- > 0) {
+            *output++ = *reference++;
+        }
+    }
+
+    return output == outputEnd;
+}
+
+bool
+athenaCompression_IsCompressible(const uint8_t *source, size_t sourceLength, size_t sampleLength, unsigned maxRatioPercent)
+{
+    if (sampleLength > sourceLength) {
+        sampleLength = sourceLength;
+    }
+    if (sampleLength == 0) {
+        return false;
+    }
+
+    // Anything larger than the limit is not worth keeping, so stop compressing as soon as it is exceeded.
+    size_t limit = (sampleLength * maxRatioPercent) / 100;
+    if (limit == 0) {
+        return false;
+    }
+    uint8_t *sample = parcMemory_Allocate(limit);
+    assertNotNull(sample, "parcMemory_Allocate(%zu) returned NULL", limit);
+
+    size_t compressedLength = athenaCompression_Compress(source, sampleLength, sample, limit);
+
+    parcMemory_Deallocate(&sample);
+
+    return compressedLength > 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Compression_h
+#define libathena_Compression_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//
+// Block compression
+//
+// A small LZ77 byte-oriented block codec producing the LZ4 block format (a token byte with literal
+// and match length nibbles, literals, then a little-endian 16 bit match offset).  It is used to
+// hold content store entries in compressed form and favours speed over ratio.  The block carries
+// no header, the caller must retain the original length to decompress it.
+//
+
+/**
+ * @abstract return the worst case compressed size for an input of the given length
+ * @discussion
+ *
+ * A destination buffer of this size is always large enough to hold the compressed result.
+ *
+ * @param [in] length size of the input in bytes
+ * @return the maximum size of the compressed output
+ *
+ * Example:
+ * @code
+ * {
+ *     uint8_t *output = parcMemory_Allocate(athenaCompression_Bound(length));
+ * }
+ * @endcode
+ */
+size_t athenaCompression_Bound(size_t length);
+
+/**
+ * @abstract compress a block of bytes
+ * @discussion
+ *
+ * Compression stops early if the output would not fit in the destination, allowing the caller to
+ * abandon data that does not shrink by passing a destination smaller than the input.
+ *
+ * @param [in] source bytes to compress
+ * @param [in] sourceLength number of bytes to compress
+ * @param [out] destination buffer for the compressed block
+ * @param [in] destinationCapacity size of the destination buffer
+ * @return the size of the compressed block, or 0 if it did not fit in the destination
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t capacity = athenaCompression_Bound(length);
+ *     uint8_t *output = parcMemory_Allocate(capacity);
+ *     size_t compressedLength = athenaCompression_Compress(input, length, output, capacity);
+ * }
+ * @endcode
+ */
+size_t athenaCompression_Compress(const uint8_t *source, size_t sourceLength, uint8_t *destination, size_t destinationCapacity);
+
+/**
+ * @abstract decompress a block produced by athenaCompression_Compress
+ * @discussion
+ *
+ * The block is validated as it is decoded, a corrupt block never reads or writes outside of the
+ * buffers provided.
+ *
+ * @param [in] source compressed block
+ * @param [in] sourceLength size of the compressed block
+ * @param [out] destination buffer for the decompressed bytes
+ * @param [in] destinationLength the exact original length of the data
+ * @return true if the block decoded to exactly destinationLength bytes
+ *
+ * Example:
+ * @code
+ * {
+ *     uint8_t *output = parcMemory_Allocate(originalLength);
+ *     if (athenaCompression_Decompress(block, blockLength, output, originalLength) == false) {
+ *         printf("corrupt block\n");
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaCompression_Decompress(const uint8_t *source, size_t sourceLength, uint8_t *destination, size_t destinationLength);
+
+/**
+ * @abstract estimate whether a block is worth compressing
+ * @discussion
+ *
+ * Compresses at most sampleLength bytes from the start of the block and reports whether
+ * they shrank to no more than (maxRatioPercent / 100) of their size.  Already compressed or
+ * encrypted payloads fail this test cheaply.
+ *
+ * @param [in] source bytes to test
+ * @param [in] sourceLength number of bytes available
+ * @param [in] sampleLength maximum number of bytes to sample
+ * @param [in] maxRatioPercent the largest compressed to original size ratio considered worthwhile
+ * @return true if the sample compressed well enough
+ *
+ * Example:
+ * @code
+ * {
+ *     if (athenaCompression_IsCompressible(input, length, 4096, 90)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaCompression_IsCompressible(const uint8_t *source, size_t sourceLength, size_t sampleLength, unsigned maxRatioPercent);
+#endif // libathena_Compression_h
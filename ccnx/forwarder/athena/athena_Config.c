@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena forwarder configuration files
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <sys/param.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_ArrayList.h>
+#include <parc/algol/parc_URI.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+#include <ccnx/forwarder/athena/athena_Config.h>
+
+#define AthenaConfig_Link  "link"
+#define AthenaConfig_Route "route"
+#define AthenaConfig_Stale "stale"
+#define AthenaConfig_Store "store"
+
+typedef struct athena_config_link {
+    char *name;
+    char *specification;
+} _AthenaConfigLink;
+
+typedef struct athena_config_route {
+    char *linkName;
+    CCNxName *prefix;
+} _AthenaConfigRoute;
+
+typedef struct athena_config_stale_window {
+    CCNxName *prefix;
+    uint64_t windowInMillis;
+} _AthenaConfigStaleWindow;
+
+struct athena_config {
+    PARCArrayList *links;
+    PARCArrayList *routes;
+    PARCArrayList *staleWindows;
+    size_t storeSizeInMB;             // 0 if the content store size is not configured
+};
+
+static void
+_destroyLink(void **linkPtr)
+{
+    _AthenaConfigLink *link = (_AthenaConfigLink *) *linkPtr;
+    parcMemory_Deallocate(&link->name);
+    parcMemory_Deallocate(&link->specification);
+    parcMemory_Deallocate(linkPtr);
+}
+
+static void
+_destroyRoute(void **routePtr)
+{
+    _AthenaConfigRoute *route = (_AthenaConfigRoute *) *routePtr;
+    parcMemory_Deallocate(&route->linkName);
+    ccnxName_Release(&route->prefix);
+    parcMemory_Deallocate(routePtr);
+}
+
+static void
+_destroyStaleWindow(void **staleWindowPtr)
+{
+    _AthenaConfigStaleWindow *staleWindow = (_AthenaConfigStaleWindow *) *staleWindowPtr;
+    ccnxName_Release(&staleWindow->prefix);
+    parcMemory_Deallocate(staleWindowPtr);
+}
+
+static void
+_athenaConfig_Destroy(AthenaConfig **configPtr)
+{
+    AthenaConfig *config = *configPtr;
+    parcArrayList_Destroy(&config->links);
+    parcArrayList_Destroy(&config->routes);
+    parcArrayList_Destroy(&config->staleWindows);
+}
+
+parcObject_ExtendPARCObject(AthenaConfig, _athenaConfig_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaConfig, AthenaConfig);
+
+parcObject_ImplementRelease(athenaConfig, AthenaConfig);
+
+static AthenaConfig *
+_athenaConfig_Create(void)
+{
+    AthenaConfig *config = parcObject_CreateInstance(AthenaConfig);
+    if (config != NULL) {
+        config->links = parcArrayList_Create(_destroyLink);
+        config->routes = parcArrayList_Create(_destroyRoute);
+        config->staleWindows = parcArrayList_Create(_destroyStaleWindow);
+        config->storeSizeInMB = 0;
+    }
+    return config;
+}
+
+static _AthenaConfigLink *
+_findLink(const AthenaConfig *config, const char *linkName)
+{
+    if (config != NULL) {
+        for (size_t index = 0; index < parcArrayList_Size(config->links); index++) {
+            _AthenaConfigLink *link = parcArrayList_Get(config->links, index);
+            if (strcmp(link->name, linkName) == 0) {
+                return link;
+            }
+        }
+    }
+    return NULL;
+}
+
+static bool
+_hasRoute(const AthenaConfig *config, const _AthenaConfigRoute *route)
+{
+    if (config != NULL) {
+        for (size_t index = 0; index < parcArrayList_Size(config->routes); index++) {
+            _AthenaConfigRoute *configRoute = parcArrayList_Get(config->routes, index);
+            if ((strcmp(configRoute->linkName, route->linkName) == 0) && ccnxName_Equals(configRoute->prefix, route->prefix)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static _AthenaConfigStaleWindow *
+_findStaleWindow(const AthenaConfig *config, const CCNxName *prefix)
+{
+    if (config != NULL) {
+        for (size_t index = 0; index < parcArrayList_Size(config->staleWindows); index++) {
+            _AthenaConfigStaleWindow *staleWindow = parcArrayList_Get(config->staleWindows, index);
+            if (ccnxName_Equals(staleWindow->prefix, prefix)) {
+                return staleWindow;
+            }
+        }
+    }
+    return NULL;
+}
+
+static bool
+_isListener(const _AthenaConfigLink *link)
+{
+    return strstr(link->specification, "/listener") != NULL;
+}
+
+static bool
+_parseLink(AthenaConfig *config, char *specification, PARCLog *log, const char *path, int lineNumber)
+{
+    PARCURI *connectionURI = parcURI_Parse(specification);
+    if (connectionURI == NULL) {
+        parcLog_Error(log, "%s:%d: unable to parse link %s", path, lineNumber, specification);
+        return false;
+    }
+    parcURI_Release(&connectionURI);
+
+    // The link name is taken from the specification so that links can be compared before they're opened
+    const char *name = strstr(specification, "/name=");
+    if (name == NULL) {
+        parcLog_Error(log, "%s:%d: link %s must be given a name", path, lineNumber, specification);
+        return false;
+    }
+    name += strlen("/name=");
+    size_t nameLength = strcspn(name, "/");
+    if (nameLength == 0) {
+        parcLog_Error(log, "%s:%d: link %s must be given a name", path, lineNumber, specification);
+        return false;
+    }
+
+    _AthenaConfigLink *link = parcMemory_AllocateAndClear(sizeof(_AthenaConfigLink));
+    assertNotNull(link, "parcMemory_AllocateAndClear failed to allocate %zu bytes", sizeof(_AthenaConfigLink));
+    link->name = parcMemory_StringDuplicate(name, nameLength);
+    link->specification = parcMemory_StringDuplicate(specification, strlen(specification));
+
+    if (_findLink(config, link->name)) {
+        parcLog_Error(log, "%s:%d: link %s is already configured", path, lineNumber, link->name);
+        _destroyLink((void **) &link);
+        return false;
+    }
+    parcArrayList_Add(config->links, link);
+    return true;
+}
+
+static bool
+_parseRoute(AthenaConfig *config, const char *linkName, const char *prefix, PARCLog *log, const char *path, int lineNumber)
+{
+    CCNxName *prefixName = ccnxName_CreateFromURI(prefix);
+    if (prefixName == NULL) {
+        parcLog_Error(log, "%s:%d: unable to parse prefix %s", path, lineNumber, prefix);
+        return false;
+    }
+
+    _AthenaConfigRoute *route = parcMemory_AllocateAndClear(sizeof(_AthenaConfigRoute));
+    assertNotNull(route, "parcMemory_AllocateAndClear failed to allocate %zu bytes", sizeof(_AthenaConfigRoute));
+    route->linkName = parcMemory_StringDuplicate(linkName, strlen(linkName));
+    route->prefix = prefixName;
+
+    if (_hasRoute(config, route)) {
+        _destroyRoute((void **) &route);
+        return true;
+    }
+    parcArrayList_Add(config->routes, route);
+    return true;
+}
+
+static bool
+_parseStaleWindow(AthenaConfig *config, const char *prefix, const char *window, PARCLog *log, const char *path, int lineNumber)
+{
+    char *end;
+    unsigned long long windowInMillis = strtoull(window, &end, 10);
+    if (*end != '\0') {
+        parcLog_Error(log, "%s:%d: invalid stale window %s", path, lineNumber, window);
+        return false;
+    }
+    CCNxName *prefixName = ccnxName_CreateFromURI(prefix);
+    if (prefixName == NULL) {
+        parcLog_Error(log, "%s:%d: unable to parse prefix %s", path, lineNumber, prefix);
+        return false;
+    }
+
+    _AthenaConfigStaleWindow *staleWindow = _findStaleWindow(config, prefixName);
+    if (staleWindow) {
+        ccnxName_Release(&prefixName);
+    } else {
+        staleWindow = parcMemory_AllocateAndClear(sizeof(_AthenaConfigStaleWindow));
+        assertNotNull(staleWindow, "parcMemory_AllocateAndClear failed to allocate %zu bytes", sizeof(_AthenaConfigStaleWindow));
+        staleWindow->prefix = prefixName;
+        parcArrayList_Add(config->staleWindows, staleWindow);
+    }
+    staleWindow->windowInMillis = windowInMillis;
+    return true;
+}
+
+static bool
+_parseLine(AthenaConfig *config, char *line, PARCLog *log, const char *path, int lineNumber)
+{
+    char *argv[4];
+    int argc = 0;
+
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+    for (char *word = strtok(line, " \t\r\n"); word != NULL; word = strtok(NULL, " \t\r\n")) {
+        if (argc == (sizeof(argv) / sizeof(argv[0]))) {
+            parcLog_Error(log, "%s:%d: too many arguments", path, lineNumber);
+            return false;
+        }
+        argv[argc++] = word;
+    }
+    if (argc == 0) {
+        return true;
+    }
+
+    if ((strcasecmp(argv[0], AthenaConfig_Link) == 0) && (argc == 2)) {
+        return _parseLink(config, argv[1], log, path, lineNumber);
+    }
+    if ((strcasecmp(argv[0], AthenaConfig_Route) == 0) && (argc == 3)) {
+        return _parseRoute(config, argv[1], argv[2], log, path, lineNumber);
+    }
+    if ((strcasecmp(argv[0], AthenaConfig_Stale) == 0) && (argc == 3)) {
+        return _parseStaleWindow(config, argv[1], argv[2], log, path, lineNumber);
+    }
+    if ((strcasecmp(argv[0], AthenaConfig_Store) == 0) && (argc == 2)) {
+        char *end;
+        config->storeSizeInMB = strtoul(argv[1], &end, 10);
+        if ((*end != '\0') || (config->storeSizeInMB == 0)) {
+            parcLog_Error(log, "%s:%d: invalid content store size %s", path, lineNumber, argv[1]);
+            return false;
+        }
+        return true;
+    }
+
+    parcLog_Error(log, "%s:%d: unrecognized directive \"%s\" with %d arguments", path, lineNumber, argv[0], argc - 1);
+    return false;
+}
+
+static bool
+_athenaConfig_Check(const AthenaConfig *config, PARCLog *log, const char *path)
+{
+    for (size_t index = 0; index < parcArrayList_Size(config->routes); index++) {
+        _AthenaConfigRoute *route = parcArrayList_Get(config->routes, index);
+        _AthenaConfigLink *link = _findLink(config, route->linkName);
+        if (link && _isListener(link)) {
+            parcLog_Error(log, "%s: route to %s, which is a listener", path, route->linkName);
+            return false;
+        }
+    }
+    return true;
+}
+
+static AthenaConfig *
+_athenaConfig_ReadStream(FILE *file, PARCLog *log, const char *path)
+{
+    AthenaConfig *config = _athenaConfig_Create();
+    char line[MAXPATHLEN];
+    int lineNumber = 0;
+
+    while (config && (fgets(line, sizeof(line), file) != NULL)) {
+        lineNumber++;
+        if (_parseLine(config, line, log, path, lineNumber) == false) {
+            athenaConfig_Release(&config);
+        }
+    }
+    if (config && (_athenaConfig_Check(config, log, path) == false)) {
+        athenaConfig_Release(&config);
+    }
+    return config;
+}
+
+AthenaConfig *
+athenaConfig_Read(const char *path, PARCLog *log)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        parcLog_Error(log, "Unable to open configuration %s: %s", path, strerror(errno));
+        return NULL;
+    }
+    AthenaConfig *config = _athenaConfig_ReadStream(file, log, path);
+    fclose(file);
+    return config;
+}
+
+size_t
+athenaConfig_GetNumberOfLinks(const AthenaConfig *config)
+{
+    return parcArrayList_Size(config->links);
+}
+
+static bool
+_openLink(AthenaTransportLinkAdapter *adapter, const char *specification, PARCLog *log)
+{
+    PARCURI *connectionURI = parcURI_Parse(specification);
+    const char *linkName = athenaTransportLinkAdapter_Open(adapter, connectionURI);
+    parcURI_Release(&connectionURI);
+    if (linkName == NULL) {
+        parcLog_Error(log, "Unable to open link %s: %s", specification, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static bool
+_routeLink(AthenaTransportLinkAdapter *adapter, AthenaFIB *fib, const _AthenaConfigRoute *route, bool add)
+{
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(adapter, route->linkName);
+    if (linkId == -1) {
+        return false;
+    }
+    PARCBitVector *linkVector = parcBitVector_Create();
+    parcBitVector_Set(linkVector, linkId);
+    bool result;
+    if (add) {
+        result = athenaFIB_AddRoute(fib, route->prefix, linkVector);
+    } else {
+        result = athenaFIB_DeleteRoute(fib, route->prefix, linkVector);
+    }
+    parcBitVector_Release(&linkVector);
+    return result;
+}
+
+/*
+ * Close a link and open it again with another specification, falling back to the previous specification
+ * if given and the new one can't be opened.  Closing a link removes every route to it, including routes
+ * added through CPI, athenactl or the route feed, so they are saved first and put back on the link
+ * however it is reopened.
+ */
+static bool
+_reopenLink(AthenaTransportLinkAdapter *adapter, AthenaFIB *fib, const char *linkName,
+            const char *specification, const char *previousSpecification, PARCLog *log)
+{
+    PARCList *routes = NULL;
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(adapter, linkName);
+    if (linkId != -1) {
+        routes = athenaFIB_CreateLinkEntryList(fib, linkId);
+        athenaTransportLinkAdapter_CloseByName(adapter, linkName);
+    }
+
+    bool result = _openLink(adapter, specification, log);
+    if ((result == false) && previousSpecification) {
+        _openLink(adapter, previousSpecification, log);
+    }
+
+    if (routes) {
+        linkId = athenaTransportLinkAdapter_LinkNameToId(adapter, linkName);
+        if (linkId != -1) {
+            athenaFIB_RestoreLinkEntries(fib, routes, linkId);
+        } else {
+            parcLog_Error(log, "Unable to reopen link %s, %zu routes to it were lost", linkName, parcList_Size(routes));
+        }
+        parcList_Release(&routes);
+    }
+    return result;
+}
+
+/*
+ * Undo the link changes of a configuration that couldn't be applied, opened lists the links of the new
+ * configuration that were opened or reopened, in the order they were.
+ */
+static void
+_rollBackLinks(const AthenaConfig *running, PARCArrayList *opened, AthenaTransportLinkAdapter *adapter, AthenaFIB *fib, PARCLog *log)
+{
+    for (size_t index = 0; index < parcArrayList_Size(opened); index++) {
+        _AthenaConfigLink *link = parcArrayList_Get(opened, index);
+        _AthenaConfigLink *previous = _findLink(running, link->name);
+        if (previous) {
+            _reopenLink(adapter, fib, link->name, previous->specification, NULL, log);
+        } else {
+            athenaTransportLinkAdapter_CloseByName(adapter, link->name);
+        }
+    }
+}
+
+bool
+athenaConfig_Apply(const AthenaConfig *running, const AthenaConfig *config,
+                   AthenaTransportLinkAdapter *adapter, AthenaFIB *fib, AthenaContentStore *contentStore,
+                   PARCLog *log, AthenaConfigChanges *changes)
+{
+    AthenaConfigChanges counts = { 0 };
+
+    // Routes must refer to a configured link or one that's already running and that we don't manage
+    for (size_t index = 0; index < parcArrayList_Size(config->routes); index++) {
+        _AthenaConfigRoute *route = parcArrayList_Get(config->routes, index);
+        if ((_findLink(config, route->linkName) == NULL) &&
+            ((_findLink(running, route->linkName) != NULL) || (athenaTransportLinkAdapter_LinkNameToId(adapter, route->linkName) == -1))) {
+            parcLog_Error(log, "Configuration routes to unknown link %s", route->linkName);
+            return false;
+        }
+    }
+
+    // Open new and changed links first, so a link that can't be opened leaves everything as it was
+    PARCArrayList *opened = parcArrayList_Create(NULL);
+    for (size_t index = 0; index < parcArrayList_Size(config->links); index++) {
+        _AthenaConfigLink *link = parcArrayList_Get(config->links, index);
+        _AthenaConfigLink *previous = _findLink(running, link->name);
+        if (previous && (strcmp(previous->specification, link->specification) == 0)) {
+            continue;
+        }
+        if ((previous == NULL) && (athenaTransportLinkAdapter_LinkNameToId(adapter, link->name) != -1)) {
+            parcLog_Error(log, "Configured link %s is already open and not managed by the configuration", link->name);
+            _rollBackLinks(running, opened, adapter, fib, log);
+            parcArrayList_Destroy(&opened);
+            return false;
+        }
+        bool isOpen;
+        if (previous) {
+            isOpen = _reopenLink(adapter, fib, link->name, link->specification, previous->specification, log);
+        } else {
+            isOpen = _openLink(adapter, link->specification, log);
+        }
+        if (isOpen == false) {
+            _rollBackLinks(running, opened, adapter, fib, log);
+            parcArrayList_Destroy(&opened);
+            return false;
+        }
+        parcArrayList_Add(opened, link);
+        if (previous) {
+            counts.linksChanged++;
+        } else {
+            counts.linksAdded++;
+        }
+    }
+
+    // From here on the new configuration is committed
+    if (running) {
+        for (size_t index = 0; index < parcArrayList_Size(running->routes); index++) {
+            _AthenaConfigRoute *route = parcArrayList_Get(running->routes, index);
+            if ((_hasRoute(config, route) == false) && _routeLink(adapter, fib, route, false)) {
+                counts.routesRemoved++;
+            }
+        }
+    }
+
+    for (size_t index = 0; index < parcArrayList_Size(config->routes); index++) {
+        _AthenaConfigRoute *route = parcArrayList_Get(config->routes, index);
+        _AthenaConfigLink *link = _findLink(config, route->linkName);
+        _AthenaConfigLink *previous = _findLink(running, route->linkName);
+        bool reopened = link && previous && (strcmp(previous->specification, link->specification) != 0);
+        if ((_hasRoute(running, route) == false) || reopened) {
+            if (_routeLink(adapter, fib, route, true)) {
+                counts.routesAdded++;
+            } else {
+                parcLog_Warning(log, "Unable to add configured route to %s", route->linkName);
+            }
+        }
+    }
+
+    if (running) {
+        for (size_t index = 0; index < parcArrayList_Size(running->links); index++) {
+            _AthenaConfigLink *link = parcArrayList_Get(running->links, index);
+            if (_findLink(config, link->name) == NULL) {
+                athenaTransportLinkAdapter_CloseByName(adapter, link->name);
+                counts.linksRemoved++;
+            }
+        }
+
+        // A window of 0 stops serving stale content under a prefix that's no longer configured
+        for (size_t index = 0; index < parcArrayList_Size(running->staleWindows); index++) {
+            _AthenaConfigStaleWindow *staleWindow = parcArrayList_Get(running->staleWindows, index);
+            if (_findStaleWindow(config, staleWindow->prefix) == NULL) {
+                athenaContentStore_SetStaleWindow(contentStore, staleWindow->prefix, 0);
+                counts.policiesChanged++;
+            }
+        }
+    }
+
+    for (size_t index = 0; index < parcArrayList_Size(config->staleWindows); index++) {
+        _AthenaConfigStaleWindow *staleWindow = parcArrayList_Get(config->staleWindows, index);
+        _AthenaConfigStaleWindow *previous = _findStaleWindow(running, staleWindow->prefix);
+        if ((previous == NULL) || (previous->windowInMillis != staleWindow->windowInMillis)) {
+            athenaContentStore_SetStaleWindow(contentStore, staleWindow->prefix, staleWindow->windowInMillis);
+            counts.policiesChanged++;
+        }
+    }
+
+    size_t runningStoreSizeInMB = running ? running->storeSizeInMB : 0;
+    if ((config->storeSizeInMB > 0) && (config->storeSizeInMB != runningStoreSizeInMB)) {
+        athenaContentStore_SetCapacity(contentStore, config->storeSizeInMB);
+        counts.policiesChanged++;
+    }
+
+    parcArrayList_Destroy(&opened);
+
+    parcLog_Info(log, "Configuration applied: links %zu added %zu changed %zu removed, routes %zu added %zu removed, %zu policies changed",
+                 counts.linksAdded, counts.linksChanged, counts.linksRemoved, counts.routesAdded, counts.routesRemoved, counts.policiesChanged);
+    if (changes) {
+        *changes = counts;
+    }
+    return true;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Config_h
+#define libathena_Config_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <parc/logging/parc_Log.h>
+
+#include <ccnx/forwarder/athena/athena_TransportLinkAdapter.h>
+#include <ccnx/forwarder/athena/athena_FIB.h>
+#include <ccnx/forwarder/athena/athena_ContentStore.h>
+
+//
+// Forwarder configuration files
+//
+// A configuration file describes the links, routes and content store policies a forwarder should
+// be running with, one directive per line, anything following a '#' being a comment:
+//
+//     link <protocol>://<address>:<port>[/listener][/local=<bool>][/trusted-push=<bytes per second>]/name=<name>
+//     route <linkName> <prefix>
+//     stale <prefix> <milliseconds>
+//     store <sizeInMB>
+//
+// Every configured link must be named, as links are matched by name when a new configuration is
+// compared with the one that is running.  Applying a configuration only makes the changes needed
+// to get from the previously applied configuration to the new one.  Links, routes and policies
+// that are in both are left untouched, as are links and routes added by other means, and the PIT
+// and content store are never flushed.
+//
+
+struct athena_config;
+typedef struct athena_config AthenaConfig;
+
+/**
+ * @typedef AthenaConfigChanges
+ * @brief Count of the changes made by applying a configuration
+ */
+typedef struct athena_config_changes {
+    size_t linksAdded;
+    size_t linksChanged;
+    size_t linksRemoved;
+    size_t routesAdded;
+    size_t routesRemoved;
+    size_t policiesChanged;
+} AthenaConfigChanges;
+
+/**
+ * @abstract read a configuration file
+ * @discussion
+ *
+ * The whole file is parsed and checked before anything is returned, so a file with any error
+ * in it yields no configuration.  Errors are logged with their line number.
+ *
+ * @param [in] path of the configuration file
+ * @param [in] log to report errors to
+ * @return a new configuration, or NULL if the file could not be read or parsed
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaConfig *config = athenaConfig_Read("/etc/athena.conf", athena->log);
+ *     athenaConfig_Release(&config);
+ * }
+ * @endcode
+ */
+AthenaConfig *athenaConfig_Read(const char *path, PARCLog *log);
+
+/**
+ * @abstract acquire a reference to a configuration
+ *
+ * @param [in] config instance to acquire
+ * @return the same configuration
+ */
+AthenaConfig *athenaConfig_Acquire(const AthenaConfig *config);
+
+/**
+ * @abstract release a configuration
+ *
+ * @param [in,out] configPtr pointer to the configuration to release, set to NULL
+ */
+void athenaConfig_Release(AthenaConfig **configPtr);
+
+/**
+ * @abstract number of links in a configuration
+ *
+ * @param [in] config instance
+ * @return number of configured links
+ */
+size_t athenaConfig_GetNumberOfLinks(const AthenaConfig *config);
+
+/**
+ * @abstract apply a configuration on top of the one that is running
+ * @discussion
+ *
+ * Links that are new or whose specification changed are opened first.  If any of them fails to
+ * open they are closed again, changed links are restored, and nothing else is touched.  Only then
+ * are routes that are no longer configured removed, new routes added, links that are no longer
+ * configured closed and content store policies updated.  Closing a link drops the routes and
+ * pending interests that refer to it, so every route on a changed link, configured or added at run
+ * time, is saved before it is closed and added back once it is reopened, or once it is restored if
+ * the configuration fails.
+ *
+ * Must be called from the thread running the forwarder the tables belong to.
+ *
+ * @param [in] running configuration previously applied, or NULL if none
+ * @param [in] config configuration to apply
+ * @param [in] adapter links of the forwarder
+ * @param [in] fib of the forwarder
+ * @param [in] contentStore of the forwarder
+ * @param [in] log to report changes and errors to
+ * @param [out] changes counts of the changes made, may be NULL
+ * @return true if the configuration was applied, false if the running configuration was left in place
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaConfig *config = athenaConfig_Read(path, athena->log);
+ *     if (config && athenaConfig_Apply(athena->config, config, athena->athenaTransportLinkAdapter,
+ *                                      athena->athenaFIB, athena->athenaContentStore, athena->log, NULL)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaConfig_Apply(const AthenaConfig *running, const AthenaConfig *config,
+                        AthenaTransportLinkAdapter *adapter, AthenaFIB *fib, AthenaContentStore *contentStore,
+                        PARCLog *log, AthenaConfigChanges *changes);
+#endif // libathena_Config_h
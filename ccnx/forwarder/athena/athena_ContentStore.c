@@ -91,6 +91,16 @@ athenaContentStore_PutContentObject(AthenaContentStore *store, const CCNxContent
     return store->interface->putContentObject(store->impl, contentItem);
 }
 
+bool
+athenaContentStore_PutRefresh(AthenaContentStore *store, const CCNxContentObject *contentItem)
+{
+    if (store->interface->putRefresh == NULL) {
+        return false;
+    }
+
+    return store->interface->putRefresh(store->impl, contentItem);
+}
+
 CCNxContentObject *
 athenaContentStore_GetMatch(AthenaContentStore *store, const CCNxInterest *interest)
 {
@@ -101,6 +111,54 @@ athenaContentStore_GetMatch(AthenaContentStore *store, const CCNxInterest *inter
     return store->interface->getMatch(store->impl, interest);
 }
 
+bool
+athenaContentStore_ContainsMatch(AthenaContentStore *store, const CCNxInterest *interest)
+{
+    if (store->interface->containsMatch == NULL) {
+        return false;
+    }
+
+    return store->interface->containsMatch(store->impl, interest);
+}
+
+void
+athenaContentStore_GetMatchBatch(AthenaContentStore *store, const CCNxInterest **interests, size_t count,
+                                 CCNxContentObject **results, bool *needsRefresh)
+{
+    if (store->interface->getMatchBatch != NULL) {
+        store->interface->getMatchBatch(store->impl, interests, count, results, needsRefresh);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        CCNxContentObject *match = athenaContentStore_GetMatchOrStale(store, interests[i], &needsRefresh[i]);
+        results[i] = (match != NULL) ? ccnxContentObject_Acquire(match) : NULL;
+    }
+}
+
+CCNxContentObject *
+athenaContentStore_GetMatchOrStale(AthenaContentStore *store, const CCNxInterest *interest, bool *needsRefresh)
+{
+    *needsRefresh = false;
+
+    // A store that doesn't serve stale content only ever returns fresh matches
+    if (store->interface->getMatchOrStale == NULL) {
+        return athenaContentStore_GetMatch(store, interest);
+    }
+
+    return store->interface->getMatchOrStale(store->impl, interest, needsRefresh);
+}
+
+bool
+athenaContentStore_SetStaleWindow(AthenaContentStore *store, const CCNxName *prefix, uint64_t windowInMillis)
+{
+    if (store->interface->setStaleWindow == NULL) {
+        return false;
+    }
+
+    return store->interface->setStaleWindow(store->impl, prefix, windowInMillis);
+}
+
 bool
 athenaContentStore_RemoveMatch(AthenaContentStore *store, const CCNxName *name, const PARCBuffer *keyId, const PARCBuffer *contentObjectHash)
 {
@@ -111,6 +169,30 @@ athenaContentStore_RemoveMatch(AthenaContentStore *store, const CCNxName *name,
     return store->interface->removeMatch(store->impl, name, keyId, contentObjectHash);
 }
 
+size_t
+athenaContentStore_SweepExpired(AthenaContentStore *store, size_t maxEntries)
+{
+    if (store->interface->sweepExpired == NULL) {
+        return 0;
+    }
+
+    return store->interface->sweepExpired(store->impl, maxEntries);
+}
+
+size_t
+athenaContentStore_PurgePrefix(AthenaContentStore *store, const CCNxName *prefix, size_t maxEntries, size_t *bytesFreed)
+{
+    if (bytesFreed != NULL) {
+        *bytesFreed = 0;
+    }
+
+    if (store->interface->purgePrefix == NULL) {
+        return 0;
+    }
+
+    return store->interface->purgePrefix(store->impl, prefix, maxEntries, bytesFreed);
+}
+
 bool
 athenaContentStore_SetCapacity(AthenaContentStore *store, size_t maxSizeInMB)
 {
@@ -140,3 +222,43 @@ athenaContentStore_ProcessMessage(AthenaContentStore *store, const CCNxMetaMessa
 
     return store->interface->processMessage(store->impl, message);
 }
+
+AthenaSnapshot *
+athenaContentStore_CreateSnapshot(AthenaContentStore *store)
+{
+    AthenaSnapshot *snapshot = athenaSnapshot_Create("cs", 0);
+
+    if (store->interface->snapshot != NULL) {
+        store->interface->snapshot(store->impl, snapshot);
+    }
+
+    return snapshot;
+}
+
+AthenaContentStoreWalk *
+athenaContentStore_StartSnapshot(AthenaContentStore *store)
+{
+    if (store->interface->startSnapshot == NULL) {
+        return NULL;
+    }
+
+    return store->interface->startSnapshot(store->impl);
+}
+
+bool
+athenaContentStore_ContinueSnapshot(AthenaContentStore *store, AthenaContentStoreWalk *walk, AthenaSnapshot *snapshot, size_t maxEntries)
+{
+    return store->interface->continueSnapshot(store->impl, walk, snapshot, maxEntries);
+}
+
+void
+athenaContentStore_StopSnapshot(AthenaContentStore *store, AthenaContentStoreWalk **walkPtr)
+{
+    store->interface->stopSnapshot(store->impl, walkPtr);
+}
+
+AthenaContentStoreInterface *
+athenaContentStore_GetInterface(const AthenaContentStore *store)
+{
+    return store->interface;
+}
@@ -60,6 +60,14 @@ typedef struct athena_contentstore AthenaContentStore;
  */
 AthenaContentStore *athenaContentStore_Create(AthenaContentStoreInterface *interface, AthenaContentStoreConfig *config);
 
+/**
+ * Acquire a reference to a ContentStore
+ *
+ * @param store
+ * @return the same value as store
+ */
+AthenaContentStore *athenaContentStore_Acquire(const AthenaContentStore *store);
+
 /**
  * Release a ContentStore
  *
@@ -76,6 +84,17 @@ void athenaContentStore_Release(AthenaContentStore **store);
  */
 bool athenaContentStore_PutContentObject(AthenaContentStore *store, const CCNxContentObject *contentItem);
 
+/**
+ * Put a ContentObject into the store only if it is a fresh copy of a stale item that the store asked to have
+ * refreshed (see athenaContentStore_GetMatchOrStale), and the refresh has not yet timed out.  A refresh has
+ * no downstream consumer to forward it to, this lets it replace the stale item without caching unsolicited content.
+ *
+ * @param store
+ * @param [in] contentItem - the refreshed item.
+ * @return true if the item was stored.
+ */
+bool athenaContentStore_PutRefresh(AthenaContentStore *store, const CCNxContentObject *contentItem);
+
 /**
  * Put a ContentObject, in wire format, into the store.
  *
@@ -100,6 +119,59 @@ bool athenaContentStore_PutContentObject(AthenaContentStore *store, const CCNxCo
  */
 CCNxContentObject *athenaContentStore_GetMatch(AthenaContentStore *store, const CCNxInterest *interest);
 
+/**
+ * Return true if athenaContentStore_GetMatch would return fresh content for a {@link CCNxInterest}, without
+ * changing the store: the match's place in the eviction order is kept, expired items are not removed and
+ * items in a compressed segment are not restored.  A store that can't look without changing its state
+ * reports no match.
+ *
+ * @param store
+ * @param [in] interest - the {@link CCNxInterest} to look for a match for.
+ * @return true if the store holds an unexpired match.
+ */
+bool athenaContentStore_ContainsMatch(AthenaContentStore *store, const CCNxInterest *interest);
+
+/**
+ * Find the matches for a batch of {@link CCNxInterest}s, as athenaContentStore_GetMatchOrStale would for each in
+ * turn, so that matches within a stale window are served and flagged for refresh.  A store that supports batches
+ * looks the interests' names up in the name pool together, so that the cache misses of that step overlap; the
+ * index probes that follow are made one interest at a time.  As the match returned for one interest may be
+ * replaced by the lookup for the next, each match is returned as an acquired reference.
+ *
+ * @param store
+ * @param [in] interests - the interests to find matches for.
+ * @param [in] count - the number of interests.
+ * @param [out] results - filled in with an acquired reference to each interest's match, or NULL if it has none.
+ * @param [out] needsRefresh - filled in for each interest as by athenaContentStore_GetMatchOrStale.
+ */
+void athenaContentStore_GetMatchBatch(AthenaContentStore *store, const CCNxInterest **interests, size_t count,
+                                      CCNxContentObject **results, bool *needsRefresh);
+
+/**
+ * As athenaContentStore_GetMatch, but a match that has passed its expiry time is still returned if it is
+ * within the stale window of its name's longest configured prefix (see athenaContentStore_SetStaleWindow).
+ * When a stale match is returned, `needsRefresh` is set for the first such match, and again only if no
+ * fresh copy has replaced it after a refresh would have timed out, so that the caller sends a single
+ * refresh Interest upstream for the content.
+ *
+ * @param store
+ * @param [in] interest - the {@link CCNxInterest} to attempt to find a match for.
+ * @param [out] needsRefresh - set to true if the caller should request a fresh copy of the returned match.
+ * @return a pointer to the matched ContentObject, fresh or stale.
+ */
+CCNxContentObject *athenaContentStore_GetMatchOrStale(AthenaContentStore *store, const CCNxInterest *interest, bool *needsRefresh);
+
+/**
+ * Set the window after their expiry time during which items cached under the specified name prefix may still
+ * be served by athenaContentStore_GetMatchOrStale. The window of the longest configured prefix of a name applies.
+ *
+ * @param store
+ * @param [in] prefix - the name prefix the window applies to.
+ * @param [in] windowInMillis - the stale window, 0 to remove the window for the prefix.
+ * @return true if the store supports serving stale content.
+ */
+bool athenaContentStore_SetStaleWindow(AthenaContentStore *store, const CCNxName *prefix, uint64_t windowInMillis);
+
 /**
  * Remove an item that matches the specified search parameters.
  *
@@ -112,6 +184,30 @@ CCNxContentObject *athenaContentStore_GetMatch(AthenaContentStore *store, const
  */
 bool athenaContentStore_RemoveMatch(AthenaContentStore *store, const CCNxName *name, const PARCBuffer *keyIdRestriction, const PARCBuffer *contentObjectHash);
 
+/**
+ * Remove up to `maxEntries` items that have passed their expiry time, earliest first.  Items still within
+ * a stale window are kept.  Expired items are otherwise only removed when they are matched or their space
+ * is needed, this lets the caller reclaim them a bounded step at a time.
+ *
+ * @param store
+ * @param [in] maxEntries - the most expired items to examine in this call.
+ * @return the number of items removed, `maxEntries` if more expired items may remain.
+ */
+size_t athenaContentStore_SweepExpired(AthenaContentStore *store, size_t maxEntries);
+
+/**
+ * Remove up to `maxEntries` of the items cached under the specified name prefix, including any cached under the
+ * prefix itself. A large prefix is purged in bounded slices by calling this repeatedly with the same prefix until
+ * it returns less than `maxEntries`, so that the purge can be interleaved with forwarding.
+ *
+ * @param store
+ * @param [in] prefix - the name prefix to purge.
+ * @param [in] maxEntries - the most items to remove in this call.
+ * @param [out] bytesFreed - if not NULL, set to the number of bytes of store capacity freed.
+ * @return the number of items removed, less than `maxEntries` once none remain under the prefix.
+ */
+size_t athenaContentStore_PurgePrefix(AthenaContentStore *store, const CCNxName *prefix, size_t maxEntries, size_t *bytesFreed);
+
 /**
  * Set the max size of the specified `AthenaContentStore` to the size, in MB, specified by `maxSizeInMB`. If the Content Store
  * implementation needs to discard items to apply the new size limit, the order in which items are discarded is undefined.
@@ -143,4 +239,55 @@ size_t athenaContentStore_GetCapacity(AthenaContentStore *store);
  * @return a `CCNxMetaMessage` instance containing a response.
  */
 CCNxMetaMessage *athenaContentStore_ProcessMessage(AthenaContentStore *store, const CCNxMetaMessage *message);
+
+/**
+ * Take a snapshot of the index of the specified `AthenaContentStore`. Each cached object is
+ * copied into the snapshot as its name and the store's bookkeeping for it, never its payload,
+ * so the store may go on adding and evicting content while the snapshot is rendered. Stores
+ * that do not implement snapshots return an empty snapshot.
+ *
+ * @param store
+ * @return a new `AthenaSnapshot`, to be released with `athenaSnapshot_Release`.
+ */
+AthenaSnapshot *athenaContentStore_CreateSnapshot(AthenaContentStore *store);
+
+/**
+ * Start a snapshot of the index of the specified `AthenaContentStore` that is taken a slice at a
+ * time, so that a large store is never copied in one go.  Each entry is copied as by
+ * `athenaContentStore_CreateSnapshot`.  The walk reports the objects that were cached when it
+ * started and are still cached when it reaches them, whatever is added or evicted in between.
+ *
+ * @param store
+ * @return a walk to be stopped with `athenaContentStore_StopSnapshot`.
+ * @return NULL if the store can only be copied whole with `athenaContentStore_CreateSnapshot`.
+ */
+AthenaContentStoreWalk *athenaContentStore_StartSnapshot(AthenaContentStore *store);
+
+/**
+ * Append at most maxEntries more cached objects to a snapshot being walked.
+ *
+ * @param store the store the walk was started on
+ * @param walk the walk in progress
+ * @param snapshot the snapshot being filled
+ * @param maxEntries the most entries to append
+ * @return true if the walk has further to go, false once it has been through the whole store.
+ */
+bool athenaContentStore_ContinueSnapshot(AthenaContentStore *store, AthenaContentStoreWalk *walk, AthenaSnapshot *snapshot, size_t maxEntries);
+
+/**
+ * Stop a snapshot walk, whether or not it is complete. A store must not be released while walks
+ * started on it are still in progress.
+ *
+ * @param store the store the walk was started on
+ * @param walkPtr pointer to the walk, set to NULL
+ */
+void athenaContentStore_StopSnapshot(AthenaContentStore *store, AthenaContentStoreWalk **walkPtr);
+
+/**
+ * Return the implementation interface the specified `AthenaContentStore` was created with.
+ *
+ * @param store
+ * @return the `AthenaContentStoreInterface` passed to `athenaContentStore_Create`.
+ */
+AthenaContentStoreInterface *athenaContentStore_GetInterface(const AthenaContentStore *store);
 #endif // libathena_ContentStore_h
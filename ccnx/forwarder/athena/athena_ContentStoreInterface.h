@@ -38,10 +38,14 @@
 #include <parc/algol/parc_Buffer.h>
 #include <parc/algol/parc_Iterator.h>
 
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
+
 typedef void AthenaContentStoreConfig;
 
 typedef void AthenaContentStoreImplementation;
 
+typedef void AthenaContentStoreWalk;
+
 typedef struct athena_contentstore_interface {
 
     char *description;
@@ -53,12 +57,33 @@ typedef struct athena_contentstore_interface {
     /** @see athenaContentStore_PutContentObject */
     bool (*putContentObject)(AthenaContentStoreImplementation *store, const CCNxContentObject *content); // Note: the content object must contain its wireformat buffer
 
+    /** @see athenaContentStore_PutRefresh */
+    bool (*putRefresh)(AthenaContentStoreImplementation *store, const CCNxContentObject *content);
+
     /** @see athenaContentStore_GetMatch */
     CCNxContentObject *(*getMatch)(AthenaContentStoreImplementation *store, const CCNxInterest *interest);
 
+    /** @see athenaContentStore_ContainsMatch, optional, no match is reported if NULL */
+    bool (*containsMatch)(AthenaContentStoreImplementation *store, const CCNxInterest *interest);
+
+    /** @see athenaContentStore_GetMatchBatch, optional, athenaContentStore_GetMatchOrStale is used for each interest if NULL */
+    void (*getMatchBatch)(AthenaContentStoreImplementation *store, const CCNxInterest **interests, size_t count, CCNxContentObject **results, bool *needsRefresh);
+
+    /** @see athenaContentStore_GetMatchOrStale */
+    CCNxContentObject *(*getMatchOrStale)(AthenaContentStoreImplementation *store, const CCNxInterest *interest, bool *needsRefresh);
+
+    /** @see athenaContentStore_SetStaleWindow */
+    bool (*setStaleWindow)(AthenaContentStoreImplementation *store, const CCNxName *prefix, uint64_t windowInMillis);
+
     /** @see athenaContentStore_RemoveMatch */
     bool (*removeMatch)(AthenaContentStoreImplementation *store, const CCNxName *name, const PARCBuffer *keyIdRestriction, const PARCBuffer *contentObjectHash);
 
+    /** @see athenaContentStore_SweepExpired */
+    size_t (*sweepExpired)(AthenaContentStoreImplementation *store, size_t maxEntries);
+
+    /** @see athenaContentStore_PurgePrefix */
+    size_t (*purgePrefix)(AthenaContentStoreImplementation *store, const CCNxName *prefix, size_t maxEntries, size_t *bytesFreed);
+
     /** @see athenaContentStore_SetCapacity */
     bool (*setCapacity)(AthenaContentStoreImplementation *store, size_t maxSizeInMB);
 
@@ -68,6 +93,18 @@ typedef struct athena_contentstore_interface {
     /** @see athenaContentStore_ProcessMessage */
     CCNxMetaMessage *(*processMessage)(AthenaContentStoreImplementation *store, const CCNxMetaMessage *message);
 
+    /** @see athenaContentStore_CreateSnapshot */
+    void (*snapshot)(AthenaContentStoreImplementation *store, AthenaSnapshot *snapshot);
+
+    /** @see athenaContentStore_StartSnapshot, optional, with continueSnapshot and stopSnapshot */
+    AthenaContentStoreWalk *(*startSnapshot)(AthenaContentStoreImplementation *store);
+
+    /** @see athenaContentStore_ContinueSnapshot */
+    bool (*continueSnapshot)(AthenaContentStoreImplementation *store, AthenaContentStoreWalk *walk, AthenaSnapshot *snapshot, size_t maxEntries);
+
+    /** @see athenaContentStore_StopSnapshot */
+    void (*stopSnapshot)(AthenaContentStoreImplementation *store, AthenaContentStoreWalk **walkPtr);
+
 } AthenaContentStoreInterface;
 
 #endif
@@ -34,6 +34,9 @@
 
 #include <config.h>
 
+#include <inttypes.h>
+#include <sys/time.h>
+
 #include <ccnx/forwarder/athena/athena_Control.h>
 #include <parc/algol/parc_Memory.h>
 
@@ -74,9 +77,32 @@ athenaControl(Athena *athena, CCNxControl *control, PARCBitVector *ingressVector
                 parcBitVector_Set(egressVector, linkId);
             }
 
-            parcLog_Debug(athena->log, "Adding %s route to interface %d",
-                          ccnxName_ToString(prefix), parcBitVector_NextBitSet(egressVector, 0));
-            athenaFIB_AddRoute(athena->athenaFIB, prefix, egressVector);
+            // A registration with a lifetime is a lease the producer has to renew before it runs out
+            const struct timeval *lifetime = cpiRouteEntry_GetLifetime(cpiRouteEntry);
+            if ((lifetime != NULL) && ((lifetime->tv_sec > 0) || (lifetime->tv_usec > 0))) {
+                struct timeval tv;
+                gettimeofday(&tv, NULL);
+                uint64_t nowInMillis = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+                uint64_t lifetimeInMillis = (lifetime->tv_sec * 1000) + (lifetime->tv_usec / 1000);
+
+                if (parcLog_IsLoggable(athena->log, PARCLogLevel_Debug)) {
+                    const char *name = ccnxName_ToString(prefix);
+                    parcLog_Debug(athena->log, "Adding %s route to interface %d for %" PRIu64 "ms",
+                                  name, parcBitVector_NextBitSet(egressVector, 0), lifetimeInMillis);
+                    parcMemory_Deallocate(&name);
+                }
+                athenaFIB_AddLeasedRoute(athena->athenaFIB, prefix, egressVector, nowInMillis + lifetimeInMillis);
+            } else {
+                if (parcLog_IsLoggable(athena->log, PARCLogLevel_Debug)) {
+                    const char *name = ccnxName_ToString(prefix);
+                    parcLog_Debug(athena->log, "Adding %s route to interface %d",
+                                  name, parcBitVector_NextBitSet(egressVector, 0));
+                    parcMemory_Deallocate(&name);
+                }
+                athenaFIB_AddRoute(athena->athenaFIB, prefix, egressVector);
+            }
+            parcBitVector_Release(&egressVector);
+            cpiRouteEntry_Destroy(&cpiRouteEntry);
 
             PARCJSON *json = ccnxControl_GetJson(control);
             PARCJSON *jsonAck = cpiAcks_CreateAck(json);
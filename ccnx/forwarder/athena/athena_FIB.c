@@ -30,24 +30,82 @@
  */
 #include <config.h>
 
+#include <string.h>
+
 #include <ccnx/forwarder/athena/athena.h>
 #include <parc/algol/parc_BitVector.h>
 #include <parc/algol/parc_HashMap.h>
 #include <parc/algol/parc_TreeRedBlack.h>
 
 #include <ccnx/forwarder/athena/athena_FIB.h>
+#include <ccnx/forwarder/athena/athena_FIBImage.h>
+#include <ccnx/forwarder/athena/athena_NamePool.h>
+#include <ccnx/forwarder/athena/athena_Scratch.h>
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
 
 /**
  * @typedef AthenaFIB
- * @brief FIB tables, tableByName (KEY == CCNxName, VALUE == PARCBitVector
+ * @brief FIB tables, tableByName (KEY == AthenaNameKey, VALUE == PARCBitVector
  *                    listOfLinks (List ( index = linkId ) of lists (CCNxNames))
+ *
+ * Routes in tableByName overlay those of a compiled image, if one is set.  An empty vector in
+ * tableByName is a route deleted from the image, hiding the image's route for that name.
+ *
+ * When aggregating, a route with the same links as the nearest route above it in tableByName is
+ * left out of tableByName, as lookups find the same links without it.  It's kept in aggregates
+ * (KEY == AthenaNameKey of the route above, VALUE == PARCHashMap of the routes left out beneath
+ * it, KEY == AthenaNameKey, VALUE == PARCBitVector) so it can be put back once the routes differ.
+ *
+ * Leased routes have their leases kept in leases (KEY == CCNxName, VALUE == _AthenaFIBLeases),
+ * apart from the routes themselves, which are removed through athenaFIB_DeleteRoute once a lease
+ * runs out.
  */
 struct athena_FIB {
+    AthenaNamePool *namePool;
     PARCHashMap *tableByName;
     PARCList *listOfLinks;
     PARCBitVector *defaultRoute;
+    AthenaSnapshot *snapshot; // taken since the last route change, NULL if there is none
+    AthenaFIBImage *image;    // compiled routes beneath tableByName, NULL if there are none
+    int *imageLinkIds;        // link id of each image link, -1 until the link is open
+    PARCBitVector *imageResult; // links of the last lookup answered from the image
+    PARCHashMap *aggregates;  // routes left out of tableByName, NULL if not aggregating
+    size_t numAggregatedRoutes;
+    size_t routesSinceAggregation; // routes added since tableByName was last aggregated as a whole
+    size_t routesAtAggregation;    // size of tableByName when it was
+    PARCHashMap *leases;
+    size_t numLeases;
+    uint64_t nextLeaseExpiration;  // no lease runs out before this time
 };
 
+/**
+ * @typedef _AthenaFIBLeases
+ * @brief Leases held on the links of a route
+ */
+typedef struct athena_fib_lease {
+    int linkId;
+    uint64_t expiration;
+} _AthenaFIBLease;
+
+typedef struct athena_fib_leases {
+    size_t numLeases;
+    size_t capacity;
+    _AthenaFIBLease *lease;
+} _AthenaFIBLeases;
+
+static void
+_athenaFIBLeases_Destroy(_AthenaFIBLeases **leasesPtr)
+{
+    if ((*leasesPtr)->lease != NULL) {
+        parcMemory_Deallocate(&(*leasesPtr)->lease);
+    }
+}
+
+parcObject_ExtendPARCObject(_AthenaFIBLeases, _athenaFIBLeases_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static
+parcObject_ImplementRelease(_athenaFIBLeases, _AthenaFIBLeases);
+
 /**
  * @typedef AthenaFIBListEntry
  * @brief Element for FIB table entry list
@@ -55,6 +113,7 @@ struct athena_FIB {
 struct athena_FIB_list_entry {
     CCNxName *name;
     int linkId;
+    uint64_t leaseExpiration; // 0 unless the route is leased
 };
 
 CCNxName *
@@ -69,6 +128,12 @@ athenaFIBListEntry_GetLinkId(AthenaFIBListEntry *entry)
     return entry->linkId;
 }
 
+uint64_t
+athenaFIBListEntry_GetLeaseExpiration(AthenaFIBListEntry *entry)
+{
+    return entry->leaseExpiration;
+}
+
 
 static void
 _athenaFIB_Destroy(AthenaFIB **fib)
@@ -79,6 +144,21 @@ _athenaFIB_Destroy(AthenaFIB **fib)
     if (pFib->defaultRoute != NULL) {
         parcBitVector_Release(&pFib->defaultRoute);
     }
+    if (pFib->snapshot != NULL) {
+        athenaSnapshot_Release(&pFib->snapshot);
+    }
+    if (pFib->image != NULL) {
+        athenaFIBImage_Release(&pFib->image);
+        parcMemory_Deallocate(&pFib->imageLinkIds);
+    }
+    if (pFib->imageResult != NULL) {
+        parcBitVector_Release(&pFib->imageResult);
+    }
+    if (pFib->aggregates != NULL) {
+        parcHashMap_Release(&pFib->aggregates);
+    }
+    parcHashMap_Release(&pFib->leases);
+    athenaNamePool_Release(&pFib->namePool);
 }
 
 parcObject_ExtendPARCObject(AthenaFIB, _athenaFIB_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
@@ -88,29 +168,135 @@ parcObject_ImplementAcquire(athenaFIB, AthenaFIB);
 parcObject_ImplementRelease(athenaFIB, AthenaFIB);
 
 AthenaFIB *
-athenaFIB_Create()
+athenaFIB_CreateWithNamePool(AthenaNamePool *namePool)
 {
     AthenaFIB *newFIB = parcObject_CreateInstance(AthenaFIB);
     if (newFIB != NULL) {
+        newFIB->namePool = (namePool != NULL) ? athenaNamePool_Acquire(namePool) : athenaNamePool_Create();
         newFIB->listOfLinks = parcList(parcArrayList_Create((void (*)(void**))parcList_Release), PARCArrayListAsPARCList);
         newFIB->tableByName = parcHashMap_Create();
         newFIB->defaultRoute = NULL;
+        newFIB->snapshot = NULL;
+        newFIB->image = NULL;
+        newFIB->imageLinkIds = NULL;
+        newFIB->imageResult = NULL;
+        newFIB->aggregates = NULL;
+        newFIB->numAggregatedRoutes = 0;
+        newFIB->routesSinceAggregation = 0;
+        newFIB->routesAtAggregation = 0;
+        newFIB->leases = parcHashMap_Create();
+        newFIB->numLeases = 0;
+        newFIB->nextLeaseExpiration = UINT64_MAX;
     }
 
     return newFIB;
 }
 
-PARCBitVector *
-athenaFIB_Lookup(AthenaFIB *athenaFIB, const CCNxName *ccnxName)
+AthenaFIB *
+athenaFIB_Create()
 {
-    CCNxName *name = ccnxName_Copy(ccnxName);
-    PARCBitVector *result = (PARCBitVector *) parcHashMap_Get(athenaFIB->tableByName, (PARCObject *) name);
+    return athenaFIB_CreateWithNamePool(NULL);
+}
 
-    while ((ccnxName_GetSegmentCount(name) > 0) && (result == NULL)) {
-        name = ccnxName_Trim(name, 1);
-        result = (PARCBitVector *) parcHashMap_Get(athenaFIB->tableByName, (PARCObject *) name);
+static bool
+_athenaFIB_IsDefaultRoute(const CCNxName *ccnxName)
+{
+    if (ccnxName_GetSegmentCount(ccnxName) == 1) {
+        CCNxNameSegment *segment = ccnxName_GetSegment(ccnxName, 0);
+        if ((ccnxNameSegment_GetType(segment) == CCNxNameLabelType_NAME) &&
+            (ccnxNameSegment_Length(segment) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Set the open links of an image route in linkVector, returning how many there were
+static size_t
+_athenaFIB_SetImageLinks(AthenaFIB *athenaFIB, const AthenaFIBImageMatch *match, PARCBitVector *linkVector)
+{
+    size_t numLinks = 0;
+    for (size_t i = 0; i < match->numLinks; i++) {
+        int linkId = athenaFIB->imageLinkIds[match->links[i]];
+        if (linkId >= 0) {
+            parcBitVector_Set(linkVector, linkId);
+            numLinks++;
+        }
+    }
+    return numLinks;
+}
+
+// Find the image route for exactly ccnxName, if there is one
+static bool
+_athenaFIB_LookupImageRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, AthenaFIBImageMatch *match)
+{
+    if (athenaFIB->image == NULL) {
+        return false;
+    }
+    size_t depth = _athenaFIB_IsDefaultRoute(ccnxName) ? 0 : ccnxName_GetSegmentCount(ccnxName);
+    AthenaFIBImageMatch matches[AthenaFIBImageMaxDepth + 1];
+    size_t numMatches = athenaFIBImage_Match(athenaFIB->image, ccnxName, matches, AthenaFIBImageMaxDepth + 1);
+    if ((numMatches > 0) && (matches[numMatches - 1].depth == depth)) {
+        *match = matches[numMatches - 1];
+        return true;
+    }
+    return false;
+}
+
+// Look up ccnxName given its longest interned prefix, which is released
+static PARCBitVector *
+_athenaFIB_LookupFromPrefix(AthenaFIB *athenaFIB, const CCNxName *ccnxName, AthenaInternedName *longestPrefix)
+{
+    PARCBitVector *result = NULL;
+    size_t resultDepth = 0;
+    bool hidden[AthenaFIBImageMaxDepth + 1] = { false };
+
+    // Each level's key only lives for its probe of the table
+    size_t scratchMark = athenaScratch_Mark();
+    const AthenaInternedName *name = longestPrefix;
+    while ((name != NULL) && (result == NULL)) {
+        AthenaNameKey *key = athenaNameKey_CreateScratch(name, NULL);
+        PARCBitVector *linkV = (PARCBitVector *) parcHashMap_Get(athenaFIB->tableByName, (PARCObject *) key);
+        athenaScratch_Rewind(scratchMark);
+        size_t depth = athenaInternedName_GetSegmentCount(name);
+        if ((linkV != NULL) && (athenaFIB->image != NULL) && (parcBitVector_NumberOfBitsSet(linkV) == 0)) {
+            if (depth <= AthenaFIBImageMaxDepth) {
+                hidden[depth] = true;
+            }
+        } else if (linkV != NULL) {
+            result = linkV;
+            resultDepth = depth;
+        }
+        name = athenaInternedName_GetPrefix(name);
+    }
+    athenaInternedName_Release(&longestPrefix);
+
+    // An image route is used if it's longer than the route found above, and hasn't been deleted
+    if (athenaFIB->image != NULL) {
+        AthenaFIBImageMatch matches[AthenaFIBImageMaxDepth + 1];
+        size_t numMatches = athenaFIBImage_Match(athenaFIB->image, ccnxName, matches, AthenaFIBImageMaxDepth + 1);
+        while (numMatches-- > 0) {
+            const AthenaFIBImageMatch *match = &matches[numMatches];
+            if ((result != NULL) && (match->depth <= resultDepth)) {
+                break;
+            }
+            if ((match->depth == 0) && (athenaFIB->defaultRoute != NULL)) {
+                break;
+            }
+            if (hidden[match->depth]) {
+                continue;
+            }
+            // Callers may alter the vector returned, so each lookup is given a fresh one
+            if (athenaFIB->imageResult != NULL) {
+                parcBitVector_Release(&athenaFIB->imageResult);
+            }
+            athenaFIB->imageResult = parcBitVector_Create();
+            if (_athenaFIB_SetImageLinks(athenaFIB, match, athenaFIB->imageResult) > 0) {
+                result = athenaFIB->imageResult;
+                break;
+            }
+        }
     }
-    ccnxName_Release(&name);
 
     if (result == NULL) {
         result = athenaFIB->defaultRoute;
@@ -119,50 +305,89 @@ athenaFIB_Lookup(AthenaFIB *athenaFIB, const CCNxName *ccnxName)
     return result;
 }
 
-bool
-athenaFIB_AddRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector)
+PARCBitVector *
+athenaFIB_Lookup(AthenaFIB *athenaFIB, const CCNxName *ccnxName)
+{
+    // A route can only exist for a prefix that has been interned, so the search starts from the
+    // longest interned prefix and follows the interned prefixes up from there.
+    AthenaInternedName *longestPrefix = athenaNamePool_LookupLongestPrefix(athenaFIB->namePool, ccnxName);
+    return _athenaFIB_LookupFromPrefix(athenaFIB, ccnxName, longestPrefix);
+}
+
+void
+athenaFIB_LookupBatch(AthenaFIB *athenaFIB, const CCNxName **ccnxNames, size_t count, PARCBitVector **results)
+{
+    AthenaInternedName *longestPrefixes[AthenaNamePoolBatchSize];
+
+    for (size_t first = 0; first < count; first += AthenaNamePoolBatchSize) {
+        size_t groupSize = ((count - first) < AthenaNamePoolBatchSize) ? (count - first) : AthenaNamePoolBatchSize;
+        athenaNamePool_LookupLongestPrefixBatch(athenaFIB->namePool, &ccnxNames[first], groupSize, longestPrefixes);
+        for (size_t i = 0; i < groupSize; i++) {
+            // An image result is replaced by the next lookup, so every result is acquired
+            PARCBitVector *result = _athenaFIB_LookupFromPrefix(athenaFIB, ccnxNames[first + i], longestPrefixes[i]);
+            results[first + i] = (result != NULL) ? parcBitVector_Acquire(result) : NULL;
+        }
+    }
+}
+
+// Drop the cached snapshot, it no longer describes the routes.  Holders of it are unaffected.
+static void
+_athenaFIB_InvalidateSnapshot(AthenaFIB *athenaFIB)
+{
+    if (athenaFIB->snapshot != NULL) {
+        athenaSnapshot_Release(&athenaFIB->snapshot);
+    }
+}
+
+// For each bit in the link vector, add an entry for the name in the list of links for future cleanup
+static void
+_athenaFIB_AddToListOfLinks(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector)
+{
+    for (int i = 0, bit = 0; i < parcBitVector_NumberOfBitsSet(ccnxLinkVector); ++i, ++bit) {
+        bit = parcBitVector_NextBitSet(ccnxLinkVector, bit);
+        if (bit >= parcList_Size(athenaFIB->listOfLinks)) {
+            //Expand the list if needed
+            for (size_t j = parcList_Size(athenaFIB->listOfLinks); j <= bit; ++j) {
+                parcList_Add(athenaFIB->listOfLinks, NULL);
+            }
+        }
+        PARCList *nameList = parcList_GetAtIndex((PARCList *) athenaFIB->listOfLinks, bit);
+        if (nameList == NULL) {
+            nameList = parcList(parcArrayList_Create((void (*)(void **))ccnxName_Release), PARCArrayListAsPARCList);
+            parcList_SetAtIndex(athenaFIB->listOfLinks, bit, (PARCObject *) nameList);
+        }
+        parcList_Add(nameList, (PARCObject *) ccnxName_Acquire(ccnxName));
+    }
+}
+
+static bool
+_athenaFIB_AddRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector)
 {
     PARCBitVector *linkV = NULL;
 
     // Check if the is a mapping for the default route
-    if (ccnxName_GetSegmentCount(ccnxName) == 1) {
-        CCNxNameSegment *segment = ccnxName_GetSegment(ccnxName, 0);
-        if ((ccnxNameSegment_GetType(segment) == CCNxNameLabelType_NAME) &&
-            (ccnxNameSegment_Length(segment) == 0)) {
-            if (athenaFIB->defaultRoute == NULL) {
-                athenaFIB->defaultRoute = parcBitVector_Create();
-            }
-            linkV = athenaFIB->defaultRoute;
+    if (_athenaFIB_IsDefaultRoute(ccnxName)) {
+        if (athenaFIB->defaultRoute == NULL) {
+            athenaFIB->defaultRoute = parcBitVector_Create();
         }
+        linkV = athenaFIB->defaultRoute;
     }
 
     if (linkV == NULL) { // It's not the default link
-        // for each bit in the link vector, add an entry for the name in the list of links for future
-        // cleanup
-        for (int i = 0, bit = 0; i < parcBitVector_NumberOfBitsSet(ccnxLinkVector); ++i, ++bit) {
-            bit = parcBitVector_NextBitSet(ccnxLinkVector, bit);
-            if (bit >= parcList_Size(athenaFIB->listOfLinks)) {
-                //Expand the list if needed
-                for (size_t j = parcList_Size(athenaFIB->listOfLinks); j <= bit; ++j) {
-                    parcList_Add(athenaFIB->listOfLinks, NULL);
-                }
-            }
-            PARCList *nameList = parcList_GetAtIndex((PARCList *) athenaFIB->listOfLinks, bit);
-            if (nameList == NULL) {
-                nameList = parcList(parcArrayList_Create((void (*)(void **))ccnxName_Release), PARCArrayListAsPARCList);
-                parcList_SetAtIndex(athenaFIB->listOfLinks, bit, (PARCObject *) nameList);
-            }
-            parcList_Add(nameList, (PARCObject *) ccnxName_Acquire(ccnxName));
-        }
+        _athenaFIB_AddToListOfLinks(athenaFIB, ccnxName, ccnxLinkVector);
 
         // Now add the actual fib mapping
-        linkV = (PARCBitVector *) parcHashMap_Get(athenaFIB->tableByName, (PARCObject *) ccnxName);
+        AthenaInternedName *name = athenaNamePool_Intern(athenaFIB->namePool, ccnxName);
+        AthenaNameKey *key = athenaNameKey_Create(name, NULL);
+        linkV = (PARCBitVector *) parcHashMap_Get(athenaFIB->tableByName, (PARCObject *) key);
         if (linkV == NULL) {
             PARCBitVector *newLinkV = parcBitVector_Create();
             linkV = newLinkV;
-            parcHashMap_Put(athenaFIB->tableByName, (PARCObject *) ccnxName, (PARCObject *) newLinkV);
+            parcHashMap_Put(athenaFIB->tableByName, (PARCObject *) key, (PARCObject *) newLinkV);
             parcBitVector_Release(&newLinkV);
         }
+        athenaNameKey_Release(&key);
+        athenaInternedName_Release(&name);
     }
 
     parcBitVector_SetVector(linkV, ccnxLinkVector);
@@ -170,16 +395,535 @@ athenaFIB_AddRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBit
     return true;
 }
 
+// Before an image route is first changed, copy it into tableByName so that the change applies to it
+static void
+_athenaFIB_CopyImageRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName)
+{
+    AthenaFIBImageMatch match;
+    if (_athenaFIB_LookupImageRoute(athenaFIB, ccnxName, &match) == false) {
+        return;
+    }
+    if (_athenaFIB_IsDefaultRoute(ccnxName)) {
+        if (athenaFIB->defaultRoute != NULL) {
+            return;
+        }
+    } else {
+        AthenaInternedName *name = athenaNamePool_Lookup(athenaFIB->namePool, ccnxName);
+        if (name != NULL) {
+            AthenaNameKey *key = athenaNameKey_Create(name, NULL);
+            bool present = parcHashMap_Contains(athenaFIB->tableByName, (PARCObject *) key);
+            athenaNameKey_Release(&key);
+            athenaInternedName_Release(&name);
+            if (present) {
+                return;
+            }
+        }
+    }
+    PARCBitVector *imageLinks = parcBitVector_Create();
+    if (_athenaFIB_SetImageLinks(athenaFIB, &match, imageLinks) > 0) {
+        _athenaFIB_AddRoute(athenaFIB, ccnxName, imageLinks);
+    }
+    parcBitVector_Release(&imageLinks);
+}
+
+//
+// Aggregation
+//
+// Every route left out of tableByName is kept in the aggregates of the nearest route above it that
+// is in tableByName, and has the same links as that route.  A lookup that would have found it
+// therefore finds the same links in the route above.
+//
+
+static PARCObject *
+_athenaFIB_Get(PARCHashMap *map, const AthenaInternedName *name)
+{
+    size_t scratchMark = athenaScratch_Mark();
+    AthenaNameKey *key = athenaNameKey_CreateScratch(name, NULL);
+    PARCObject *value = parcHashMap_Get(map, (PARCObject *) key);
+    athenaScratch_Rewind(scratchMark);
+    return value;
+}
+
+static void
+_athenaFIB_Put(PARCHashMap *map, const AthenaInternedName *name, PARCObject *value)
+{
+    AthenaNameKey *key = athenaNameKey_Create(name, NULL);
+    parcHashMap_Put(map, (PARCObject *) key, value);
+    athenaNameKey_Release(&key);
+}
+
+static void
+_athenaFIB_Remove(PARCHashMap *map, const AthenaInternedName *name)
+{
+    AthenaNameKey *key = athenaNameKey_Create(name, NULL);
+    parcHashMap_Remove(map, (PARCObject *) key);
+    athenaNameKey_Release(&key);
+}
+
+static bool
+_athenaFIB_IsBeneath(const AthenaInternedName *name, const AthenaInternedName *prefix)
+{
+    size_t prefixSegmentCount = athenaInternedName_GetSegmentCount(prefix);
+    while ((name != NULL) && (athenaInternedName_GetSegmentCount(name) > prefixSegmentCount)) {
+        name = athenaInternedName_GetPrefix(name);
+    }
+    return name == prefix;
+}
+
+// Collect the names of the routes in a map into a list, so the map can be changed while they are visited
+static PARCList *
+_athenaFIB_CreateNameList(PARCHashMap *map, const AthenaInternedName *beneath)
+{
+    PARCList *names = parcList(parcArrayList_Create((void (*)(void **))athenaInternedName_Release), PARCArrayListAsPARCList);
+    PARCIterator *it = parcHashMap_CreateKeyIterator(map);
+    while (parcIterator_HasNext(it)) {
+        const AthenaInternedName *name = athenaNameKey_GetName((AthenaNameKey *) parcIterator_Next(it));
+        if ((beneath == NULL) || _athenaFIB_IsBeneath(name, beneath)) {
+            parcList_Add(names, athenaInternedName_Acquire(name));
+        }
+    }
+    parcIterator_Release(&it);
+    return names;
+}
+
+/*
+ * Find the route for name, or the longest route above it if it has none.  Its links are returned in
+ * links, and if it's aggregated, the route it's aggregated into is returned in aggregatedInto.
+ */
+static const AthenaInternedName *
+_athenaFIB_FindRoute(AthenaFIB *athenaFIB, const AthenaInternedName *name, PARCBitVector **links,
+                     const AthenaInternedName **aggregatedInto)
+{
+    const AthenaInternedName *route = name;
+    PARCBitVector *routeLinks = NULL;
+    while ((route != NULL) && ((routeLinks = _athenaFIB_Get(athenaFIB->tableByName, route)) == NULL)) {
+        route = athenaInternedName_GetPrefix(route);
+    }
+    *aggregatedInto = NULL;
+    if (route == NULL) {
+        return NULL;
+    }
+
+    PARCHashMap *aggregates = _athenaFIB_Get(athenaFIB->aggregates, route);
+    if (aggregates != NULL) {
+        for (const AthenaInternedName *prefix = name; prefix != route; prefix = athenaInternedName_GetPrefix(prefix)) {
+            PARCBitVector *prefixLinks = _athenaFIB_Get(aggregates, prefix);
+            if (prefixLinks != NULL) {
+                *links = prefixLinks;
+                *aggregatedInto = route;
+                return prefix;
+            }
+        }
+    }
+    *links = routeLinks;
+    return route;
+}
+
+// Leave the route for name out of tableByName if the route above it has the same links
+static void
+_athenaFIB_Aggregate(AthenaFIB *athenaFIB, const AthenaInternedName *name)
+{
+    PARCBitVector *links = _athenaFIB_Get(athenaFIB->tableByName, name);
+    if ((links == NULL) || (parcBitVector_NumberOfBitsSet(links) == 0)) {
+        return;
+    }
+    const AthenaInternedName *parent = athenaInternedName_GetPrefix(name);
+    PARCBitVector *parentLinks = NULL;
+    while ((parent != NULL) && ((parentLinks = _athenaFIB_Get(athenaFIB->tableByName, parent)) == NULL)) {
+        parent = athenaInternedName_GetPrefix(parent);
+    }
+    if ((parent == NULL) || (parcBitVector_Equals(links, parentLinks) == false)) {
+        return;
+    }
+
+    PARCHashMap *parentAggregates = _athenaFIB_Get(athenaFIB->aggregates, parent);
+    if (parentAggregates == NULL) {
+        parentAggregates = parcHashMap_Create();
+        _athenaFIB_Put(athenaFIB->aggregates, parent, (PARCObject *) parentAggregates);
+        parcHashMap_Release(&parentAggregates);
+        parentAggregates = _athenaFIB_Get(athenaFIB->aggregates, parent);
+    }
+    _athenaFIB_Put(parentAggregates, name, (PARCObject *) links);
+
+    // Routes aggregated into this one have the same links, and so are now aggregated into the parent
+    PARCHashMap *aggregates = _athenaFIB_Get(athenaFIB->aggregates, name);
+    if (aggregates != NULL) {
+        PARCIterator *it = parcHashMap_CreateKeyIterator(aggregates);
+        while (parcIterator_HasNext(it)) {
+            AthenaNameKey *key = parcIterator_Next(it);
+            parcHashMap_Put(parentAggregates, (PARCObject *) key, parcHashMap_Get(aggregates, (PARCObject *) key));
+        }
+        parcIterator_Release(&it);
+        _athenaFIB_Remove(athenaFIB->aggregates, name);
+    }
+
+    _athenaFIB_Remove(athenaFIB->tableByName, name);
+    athenaFIB->numAggregatedRoutes++;
+}
+
+// Aggregate each of a list of routes that have been put back in tableByName
+static void
+_athenaFIB_AggregateList(AthenaFIB *athenaFIB, PARCList *names)
+{
+    for (size_t i = 0; i < parcList_Size(names); i++) {
+        _athenaFIB_Aggregate(athenaFIB, parcList_GetAtIndex(names, i));
+    }
+}
+
+/*
+ * Put the routes aggregated into parent back in tableByName, all of them or only those beneath a
+ * name, returning the names of the routes put back.
+ */
+static PARCList *
+_athenaFIB_Disaggregate(AthenaFIB *athenaFIB, const AthenaInternedName *parent, const AthenaInternedName *beneath)
+{
+    PARCHashMap *aggregates = _athenaFIB_Get(athenaFIB->aggregates, parent);
+    if (aggregates == NULL) {
+        return NULL;
+    }
+    PARCList *names = _athenaFIB_CreateNameList(aggregates, beneath);
+    for (size_t i = 0; i < parcList_Size(names); i++) {
+        const AthenaInternedName *name = parcList_GetAtIndex(names, i);
+        _athenaFIB_Put(athenaFIB->tableByName, name, _athenaFIB_Get(aggregates, name));
+        _athenaFIB_Remove(aggregates, name);
+        athenaFIB->numAggregatedRoutes--;
+    }
+    if (parcHashMap_Size(aggregates) == 0) {
+        _athenaFIB_Remove(athenaFIB->aggregates, parent);
+    }
+    return names;
+}
+
+static void
+_athenaFIB_DisaggregateAndAggregate(AthenaFIB *athenaFIB, const AthenaInternedName *parent, const AthenaInternedName *beneath)
+{
+    PARCList *names = _athenaFIB_Disaggregate(athenaFIB, parent, beneath);
+    if (names != NULL) {
+        _athenaFIB_AggregateList(athenaFIB, names);
+        parcList_Release(&names);
+    }
+}
+
+// Aggregate every route in tableByName, catching routes added before the route above them
+static void
+_athenaFIB_AggregateAll(AthenaFIB *athenaFIB)
+{
+    PARCList *names = _athenaFIB_CreateNameList(athenaFIB->tableByName, NULL);
+    _athenaFIB_AggregateList(athenaFIB, names);
+    parcList_Release(&names);
+    athenaFIB->routesSinceAggregation = 0;
+    athenaFIB->routesAtAggregation = parcHashMap_Size(athenaFIB->tableByName);
+}
+
+/*
+ * Add links to, or remove them from, the route for a name while aggregating, keeping the routes left
+ * out of tableByName exactly those that have the same links as the route above them.
+ */
+static bool
+_athenaFIB_ChangeAggregatedRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector, bool add)
+{
+    AthenaInternedName *name = add ? athenaNamePool_Intern(athenaFIB->namePool, ccnxName)
+                               : athenaNamePool_LookupLongestPrefix(athenaFIB->namePool, ccnxName);
+    if (name == NULL) {
+        return false;
+    }
+
+    PARCBitVector *links = NULL;
+    const AthenaInternedName *aggregatedInto = NULL;
+    const AthenaInternedName *route = _athenaFIB_FindRoute(athenaFIB, name, &links, &aggregatedInto);
+
+    if (add && (route != name)) {
+        // A new route
+        const AthenaInternedName *parent = (aggregatedInto != NULL) ? aggregatedInto : route;
+        PARCBitVector *newLinks = parcBitVector_Create();
+        parcBitVector_SetVector(newLinks, ccnxLinkVector);
+        _athenaFIB_Put(athenaFIB->tableByName, name, (PARCObject *) newLinks);
+        parcBitVector_Release(&newLinks);
+        if (parent != NULL) {
+            if (parcBitVector_Equals(ccnxLinkVector, _athenaFIB_Get(athenaFIB->tableByName, parent))) {
+                _athenaFIB_Aggregate(athenaFIB, name);
+            } else {
+                // Routes aggregated into the parent beneath the new route now find it instead
+                _athenaFIB_DisaggregateAndAggregate(athenaFIB, parent, name);
+            }
+        }
+        if (++athenaFIB->routesSinceAggregation > athenaFIB->routesAtAggregation) {
+            _athenaFIB_AggregateAll(athenaFIB);
+        }
+    } else if (route != NULL) {
+        PARCBitVector *previousLinks = parcBitVector_Copy(links);
+        if (add) {
+            parcBitVector_SetVector(links, ccnxLinkVector);
+        } else {
+            parcBitVector_ClearVector(links, ccnxLinkVector);
+        }
+        bool changed = (parcBitVector_Equals(links, previousLinks) == false);
+        parcBitVector_Release(&previousLinks);
+        // As without aggregation, a route left with no links is only removed if it's the one named
+        bool remove = (add == false) && (parcBitVector_NumberOfBitsSet(links) == 0) && (route == name) &&
+                      (athenaInternedName_GetSegmentCount(route) == ccnxName_GetSegmentCount(ccnxName));
+
+        if (aggregatedInto != NULL) {
+            // Put back in tableByName unless it's removed or still has the links of the route above
+            PARCHashMap *aggregates = _athenaFIB_Get(athenaFIB->aggregates, aggregatedInto);
+            if (remove) {
+                _athenaFIB_Remove(aggregates, route);
+                athenaFIB->numAggregatedRoutes--;
+                if (parcHashMap_Size(aggregates) == 0) {
+                    _athenaFIB_Remove(athenaFIB->aggregates, aggregatedInto);
+                }
+            } else if (parcBitVector_Equals(links, _athenaFIB_Get(athenaFIB->tableByName, aggregatedInto)) == false) {
+                _athenaFIB_Put(athenaFIB->tableByName, route, (PARCObject *) links);
+                _athenaFIB_Remove(aggregates, route);
+                athenaFIB->numAggregatedRoutes--;
+                _athenaFIB_DisaggregateAndAggregate(athenaFIB, aggregatedInto, route);
+            }
+        } else if (remove || changed) {
+            // Routes aggregated into this one had its previous links
+            PARCList *names = _athenaFIB_Disaggregate(athenaFIB, route, NULL);
+            if (remove) {
+                _athenaFIB_Remove(athenaFIB->tableByName, route);
+            } else {
+                _athenaFIB_Aggregate(athenaFIB, route);
+            }
+            if (names != NULL) {
+                _athenaFIB_AggregateList(athenaFIB, names);
+                parcList_Release(&names);
+            }
+        }
+    }
+
+    athenaInternedName_Release(&name);
+    return add || (route != NULL);
+}
+
+bool
+athenaFIB_SetAggregation(AthenaFIB *athenaFIB, bool aggregate)
+{
+    if (aggregate && (athenaFIB->image != NULL)) {
+        return false;
+    }
+    if (aggregate && (athenaFIB->aggregates == NULL)) {
+        athenaFIB->aggregates = parcHashMap_Create();
+        _athenaFIB_AggregateAll(athenaFIB);
+    } else if ((aggregate == false) && (athenaFIB->aggregates != NULL)) {
+        PARCList *parents = _athenaFIB_CreateNameList(athenaFIB->aggregates, NULL);
+        for (size_t i = 0; i < parcList_Size(parents); i++) {
+            PARCList *names = _athenaFIB_Disaggregate(athenaFIB, parcList_GetAtIndex(parents, i), NULL);
+            parcList_Release(&names);
+        }
+        parcList_Release(&parents);
+        parcHashMap_Release(&athenaFIB->aggregates);
+    }
+    return true;
+}
+
+size_t
+athenaFIB_GetNumberOfAggregatedRoutes(const AthenaFIB *athenaFIB)
+{
+    return athenaFIB->numAggregatedRoutes;
+}
+
+//
+// Route leases
+//
+
+// Drop the leases on the given links of a route
+static void
+_athenaFIB_ClearLeases(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector)
+{
+    if (athenaFIB->numLeases == 0) {
+        return;
+    }
+    _AthenaFIBLeases *leases = (_AthenaFIBLeases *) parcHashMap_Get(athenaFIB->leases, (PARCObject *) ccnxName);
+    if (leases != NULL) {
+        size_t numKept = 0;
+        for (size_t i = 0; i < leases->numLeases; i++) {
+            if (parcBitVector_Get(ccnxLinkVector, leases->lease[i].linkId) == 1) {
+                athenaFIB->numLeases--;
+            } else {
+                leases->lease[numKept++] = leases->lease[i];
+            }
+        }
+        leases->numLeases = numKept;
+        if (numKept == 0) {
+            parcHashMap_Remove(athenaFIB->leases, (PARCObject *) ccnxName);
+        }
+    }
+}
+
+static void
+_athenaFIB_SetLease(AthenaFIB *athenaFIB, const CCNxName *ccnxName, int linkId, uint64_t expiration)
+{
+    _AthenaFIBLeases *leases = (_AthenaFIBLeases *) parcHashMap_Get(athenaFIB->leases, (PARCObject *) ccnxName);
+    if (leases == NULL) {
+        _AthenaFIBLeases *newLeases = parcObject_CreateInstance(_AthenaFIBLeases);
+        assertNotNull(newLeases, "Failed to allocate route leases");
+        newLeases->numLeases = 0;
+        newLeases->capacity = 0;
+        newLeases->lease = NULL;
+        parcHashMap_Put(athenaFIB->leases, (PARCObject *) ccnxName, (PARCObject *) newLeases);
+        leases = newLeases;
+        _athenaFIBLeases_Release(&newLeases);
+    }
+
+    size_t i = 0;
+    while ((i < leases->numLeases) && (leases->lease[i].linkId != linkId)) {
+        i++;
+    }
+    if (i == leases->numLeases) {
+        if (leases->numLeases == leases->capacity) {
+            size_t capacity = (leases->capacity == 0) ? 2 : leases->capacity * 2;
+            _AthenaFIBLease *lease = parcMemory_Allocate(capacity * sizeof(_AthenaFIBLease));
+            assertNotNull(lease, "parcMemory_Allocate failed to allocate %zu route leases", capacity);
+            if (leases->lease != NULL) {
+                memcpy(lease, leases->lease, leases->numLeases * sizeof(_AthenaFIBLease));
+                parcMemory_Deallocate(&leases->lease);
+            }
+            leases->lease = lease;
+            leases->capacity = capacity;
+        }
+        leases->lease[leases->numLeases++].linkId = linkId;
+        athenaFIB->numLeases++;
+    }
+    leases->lease[i].expiration = expiration;
+
+    if (expiration < athenaFIB->nextLeaseExpiration) {
+        athenaFIB->nextLeaseExpiration = expiration;
+    }
+}
+
+bool
+athenaFIB_AddLeasedRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector,
+                         uint64_t expiration)
+{
+    bool result = athenaFIB_AddRoute(athenaFIB, ccnxName, ccnxLinkVector);
+    if (result) {
+        for (int i = 0, bit = 0; i < parcBitVector_NumberOfBitsSet(ccnxLinkVector); ++i, ++bit) {
+            bit = parcBitVector_NextBitSet(ccnxLinkVector, bit);
+            _athenaFIB_SetLease(athenaFIB, ccnxName, bit, expiration);
+        }
+    }
+    return result;
+}
+
+size_t
+athenaFIB_ExpireLeases(AthenaFIB *athenaFIB, uint64_t now)
+{
+    if ((athenaFIB->numLeases == 0) || (now < athenaFIB->nextLeaseExpiration)) {
+        return 0;
+    }
+
+    // Find the routes with leases that ran out, and when the next lease runs out
+    PARCList *expiredNames = parcList(parcArrayList_Create((void (*)(void **))ccnxName_Release), PARCArrayListAsPARCList);
+    uint64_t nextLeaseExpiration = UINT64_MAX;
+    PARCIterator *iterator = parcHashMap_CreateKeyIterator(athenaFIB->leases);
+    while (parcIterator_HasNext(iterator)) {
+        CCNxName *name = (CCNxName *) parcIterator_Next(iterator);
+        _AthenaFIBLeases *leases = (_AthenaFIBLeases *) parcHashMap_Get(athenaFIB->leases, (PARCObject *) name);
+        bool expired = false;
+        for (size_t i = 0; i < leases->numLeases; i++) {
+            if (leases->lease[i].expiration <= now) {
+                expired = true;
+            } else if (leases->lease[i].expiration < nextLeaseExpiration) {
+                nextLeaseExpiration = leases->lease[i].expiration;
+            }
+        }
+        if (expired) {
+            parcList_Add(expiredNames, ccnxName_Acquire(name));
+        }
+    }
+    parcIterator_Release(&iterator);
+
+    size_t numExpired = 0;
+    for (size_t i = 0; i < parcList_Size(expiredNames); i++) {
+        CCNxName *name = (CCNxName *) parcList_GetAtIndex(expiredNames, i);
+        _AthenaFIBLeases *leases = (_AthenaFIBLeases *) parcHashMap_Get(athenaFIB->leases, (PARCObject *) name);
+        PARCBitVector *expiredLinks = parcBitVector_Create();
+        for (size_t j = 0; j < leases->numLeases; j++) {
+            if (leases->lease[j].expiration <= now) {
+                parcBitVector_Set(expiredLinks, leases->lease[j].linkId);
+                numExpired++;
+            }
+        }
+        athenaFIB_DeleteRoute(athenaFIB, name, expiredLinks);
+        parcBitVector_Release(&expiredLinks);
+    }
+    parcList_Release(&expiredNames);
+
+    athenaFIB->nextLeaseExpiration = nextLeaseExpiration;
+    return numExpired;
+}
+
+size_t
+athenaFIB_GetNumberOfLeases(const AthenaFIB *athenaFIB)
+{
+    return athenaFIB->numLeases;
+}
+
+PARCJSONArray *
+athenaFIB_CreateLeaseCounts(AthenaFIB *athenaFIB)
+{
+    PARCJSONArray *leaseCounts = parcJSONArray_Create();
+    PARCIterator *iterator = parcHashMap_CreateKeyIterator(athenaFIB->leases);
+    while (parcIterator_HasNext(iterator)) {
+        CCNxName *name = (CCNxName *) parcIterator_Next(iterator);
+        _AthenaFIBLeases *leases = (_AthenaFIBLeases *) parcHashMap_Get(athenaFIB->leases, (PARCObject *) name);
+
+        PARCJSON *json = parcJSON_Create();
+        char *prefix = ccnxName_ToString(name);
+        parcJSON_AddString(json, "name", prefix);
+        parcJSON_AddInteger(json, "numLeases", leases->numLeases);
+        parcMemory_Deallocate(&prefix);
+
+        PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+        parcJSONArray_AddValue(leaseCounts, value);
+        parcJSONValue_Release(&value);
+        parcJSON_Release(&json);
+    }
+    parcIterator_Release(&iterator);
+    return leaseCounts;
+}
+
+bool
+athenaFIB_AddRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector)
+{
+    _athenaFIB_InvalidateSnapshot(athenaFIB);
+    _athenaFIB_ClearLeases(athenaFIB, ccnxName, ccnxLinkVector);
+    if ((athenaFIB->aggregates != NULL) && (_athenaFIB_IsDefaultRoute(ccnxName) == false)) {
+        _athenaFIB_AddToListOfLinks(athenaFIB, ccnxName, ccnxLinkVector);
+        return _athenaFIB_ChangeAggregatedRoute(athenaFIB, ccnxName, ccnxLinkVector, true);
+    }
+    _athenaFIB_CopyImageRoute(athenaFIB, ccnxName);
+    return _athenaFIB_AddRoute(athenaFIB, ccnxName, ccnxLinkVector);
+}
+
 bool
 athenaFIB_DeleteRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector)
 {
     bool result = false;
 
+    _athenaFIB_InvalidateSnapshot(athenaFIB);
+    _athenaFIB_ClearLeases(athenaFIB, ccnxName, ccnxLinkVector);
+    if ((athenaFIB->aggregates != NULL) && (_athenaFIB_IsDefaultRoute(ccnxName) == false)) {
+        return _athenaFIB_ChangeAggregatedRoute(athenaFIB, ccnxName, ccnxLinkVector, false);
+    }
+    _athenaFIB_CopyImageRoute(athenaFIB, ccnxName);
+
     PARCBitVector *linkV = athenaFIB_Lookup(athenaFIB, ccnxName);
     if (linkV != NULL) {
         parcBitVector_ClearVector(linkV, ccnxLinkVector);
-        if (parcBitVector_NumberOfBitsSet(linkV) == 0) {
-            parcHashMap_Remove(athenaFIB->tableByName, (PARCObject *) ccnxName);
+        // A route emptied of links is kept if it must go on hiding the image's route for the name
+        AthenaFIBImageMatch match;
+        if ((linkV != athenaFIB->imageResult) && (parcBitVector_NumberOfBitsSet(linkV) == 0) &&
+            (_athenaFIB_LookupImageRoute(athenaFIB, ccnxName, &match) == false)) {
+            AthenaInternedName *name = athenaNamePool_Lookup(athenaFIB->namePool, ccnxName);
+            if (name != NULL) {
+                AthenaNameKey *key = athenaNameKey_Create(name, NULL);
+                parcHashMap_Remove(athenaFIB->tableByName, (PARCObject *) key);
+                athenaNameKey_Release(&key);
+                athenaInternedName_Release(&name);
+            }
         }
         result = true;
     }
@@ -208,9 +952,54 @@ athenaFIB_RemoveLink(AthenaFIB *athenaFIB, const PARCBitVector *ccnxLinkVector)
         }
     }
 
+    if (athenaFIB->image != NULL) {
+        for (size_t i = 0; i < athenaFIBImage_GetNumberOfLinks(athenaFIB->image); i++) {
+            if ((athenaFIB->imageLinkIds[i] >= 0) && (parcBitVector_Get(ccnxLinkVector, athenaFIB->imageLinkIds[i]) == 1)) {
+                athenaFIB->imageLinkIds[i] = -1;
+            }
+        }
+    }
+
     return result;
 }
 
+void
+athenaFIB_SetImage(AthenaFIB *athenaFIB, AthenaFIBImage *image)
+{
+    _athenaFIB_InvalidateSnapshot(athenaFIB);
+    if (image != NULL) {
+        // Routes aggregated into a route above them might not be beneath an image route between them
+        athenaFIB_SetAggregation(athenaFIB, false);
+    }
+    if (athenaFIB->image != NULL) {
+        athenaFIBImage_Release(&athenaFIB->image);
+        parcMemory_Deallocate(&athenaFIB->imageLinkIds);
+    }
+    if (image != NULL) {
+        size_t numLinks = athenaFIBImage_GetNumberOfLinks(image);
+        athenaFIB->image = athenaFIBImage_Acquire(image);
+        athenaFIB->imageLinkIds = parcMemory_Allocate(sizeof(int) * (numLinks + 1));
+        assertNotNull(athenaFIB->imageLinkIds, "parcMemory_Allocate failed to allocate %zu link ids", numLinks);
+        for (size_t i = 0; i < numLinks; i++) {
+            athenaFIB->imageLinkIds[i] = -1;
+        }
+    }
+}
+
+AthenaFIBImage *
+athenaFIB_GetImage(const AthenaFIB *athenaFIB)
+{
+    return athenaFIB->image;
+}
+
+void
+athenaFIB_SetImageLinkId(AthenaFIB *athenaFIB, size_t imageLinkIndex, int linkId)
+{
+    assertNotNull(athenaFIB->image, "FIB has no image");
+    assertTrue(imageLinkIndex < athenaFIBImage_GetNumberOfLinks(athenaFIB->image), "Image link index %zu out of range", imageLinkIndex);
+    athenaFIB->imageLinkIds[imageLinkIndex] = linkId;
+}
+
 static void
 _athenaFIBListEntry_Destroy(AthenaFIBListEntry **entryHandle)
 {
@@ -220,7 +1009,18 @@ _athenaFIBListEntry_Destroy(AthenaFIBListEntry **entryHandle)
     }
 }
 
-parcObject_ExtendPARCObject(AthenaFIBListEntry, _athenaFIBListEntry_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+static PARCJSON *
+_athenaFIBListEntry_ToJSON(const AthenaFIBListEntry *entry)
+{
+    PARCJSON *json = parcJSON_Create();
+    char *prefix = ccnxName_ToString(entry->name);
+    parcJSON_AddString(json, "name", prefix);
+    parcJSON_AddInteger(json, "linkId", entry->linkId);
+    parcMemory_Deallocate(&prefix);
+    return json;
+}
+
+parcObject_ExtendPARCObject(AthenaFIBListEntry, _athenaFIBListEntry_Destroy, NULL, NULL, NULL, NULL, NULL, _athenaFIBListEntry_ToJSON);
 
 static
 parcObject_ImplementRelease(_athenaFIBListEntry, AthenaFIBListEntry);
@@ -233,6 +1033,7 @@ _athenaFIBListEntry_Create(const CCNxName *name, int linkId)
     if (entry != NULL) {
         entry->name = ccnxName_Acquire(name);
         entry->linkId = linkId;
+        entry->leaseExpiration = 0;
     }
 
     return entry;
@@ -258,6 +1059,90 @@ athenaFIB_CreateEntryList(AthenaFIB *athenaFIB)
     return result;
 }
 
+PARCList *
+athenaFIB_CreateLinkEntryList(AthenaFIB *athenaFIB, int linkId)
+{
+    PARCList *result =
+        parcList(parcArrayList_Create((void (*)(void **))_athenaFIBListEntry_Release), PARCArrayListAsPARCList);
+
+    if ((linkId < 0) || (linkId >= parcList_Size(athenaFIB->listOfLinks))) {
+        return result;
+    }
+    PARCList *linksForId = parcList_GetAtIndex(athenaFIB->listOfLinks, linkId);
+    if (linksForId == NULL) {
+        return result;
+    }
+
+    // The list of links isn't pruned as routes are deleted and may name a route more than once, only
+    // the names still routed to the link are kept, once each.
+    PARCHashMap *seen = parcHashMap_Create();
+    for (size_t i = 0; i < parcList_Size(linksForId); ++i) {
+        CCNxName *name = parcList_GetAtIndex(linksForId, i);
+        if (parcHashMap_Contains(seen, (PARCObject *) name)) {
+            continue;
+        }
+        parcHashMap_Put(seen, (PARCObject *) name, (PARCObject *) name);
+
+        PARCBitVector *links = athenaFIB_Lookup(athenaFIB, name);
+        if ((links == NULL) || (parcBitVector_Get(links, linkId) == 0)) {
+            continue;
+        }
+
+        AthenaFIBListEntry *entry = _athenaFIBListEntry_Create(name, linkId);
+        _AthenaFIBLeases *leases = (_AthenaFIBLeases *) parcHashMap_Get(athenaFIB->leases, (PARCObject *) name);
+        for (size_t j = 0; (leases != NULL) && (j < leases->numLeases); j++) {
+            if (leases->lease[j].linkId == linkId) {
+                entry->leaseExpiration = leases->lease[j].expiration;
+            }
+        }
+        parcList_Add(result, entry);
+    }
+    parcHashMap_Release(&seen);
+
+    return result;
+}
+
+size_t
+athenaFIB_RestoreLinkEntries(AthenaFIB *athenaFIB, PARCList *entries, int linkId)
+{
+    size_t result = 0;
+    PARCBitVector *linkVector = parcBitVector_Create();
+    parcBitVector_Set(linkVector, linkId);
+
+    for (size_t i = 0; i < parcList_Size(entries); ++i) {
+        AthenaFIBListEntry *entry = parcList_GetAtIndex(entries, i);
+        bool added;
+        if (entry->leaseExpiration > 0) {
+            added = athenaFIB_AddLeasedRoute(athenaFIB, entry->name, linkVector, entry->leaseExpiration);
+        } else {
+            added = athenaFIB_AddRoute(athenaFIB, entry->name, linkVector);
+        }
+        if (added) {
+            result++;
+        }
+    }
+
+    parcBitVector_Release(&linkVector);
+    return result;
+}
+
+AthenaSnapshot *
+athenaFIB_AcquireSnapshot(AthenaFIB *athenaFIB)
+{
+    // Route changes are rare next to lookups, so a snapshot is reused by every dump until the
+    // next change rather than copied out of the table each time.
+    if (athenaFIB->snapshot == NULL) {
+        AthenaSnapshot *snapshot = athenaSnapshot_Create("fib", parcHashMap_Size(athenaFIB->tableByName));
+        PARCList *entryList = athenaFIB_CreateEntryList(athenaFIB);
+        for (size_t i = 0; i < parcList_Size(entryList); ++i) {
+            athenaSnapshot_Append(snapshot, parcList_GetAtIndex(entryList, i));
+        }
+        parcList_Release(&entryList);
+        athenaFIB->snapshot = snapshot;
+    }
+    return athenaSnapshot_Acquire(athenaFIB->snapshot);
+}
+
 CCNxMetaMessage *
 athenaFIB_ProcessMessage(AthenaFIB *athenaFIB, const CCNxMetaMessage *message)
 {
@@ -32,9 +32,14 @@
 #define libathena_athena_FIB_h
 
 #include <parc/algol/parc_BitVector.h>
+#include <parc/algol/parc_JSON.h>
 
 #include <ccnx/transport/common/transport_MetaMessage.h>
 
+#include <ccnx/forwarder/athena/athena_FIBImage.h>
+#include <ccnx/forwarder/athena/athena_NamePool.h>
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
+
 /*
  * FIB interfaces
  *
@@ -44,8 +49,17 @@
  *    athenaFIB_RemoveLink
  *
  *    athenaFIB_Lookup
+ *    athenaFIB_LookupBatch
  *    athenaFIB_DeleteRoute
  *    athenaFIB_AddRoute
+ *
+ *    athenaFIB_SetImage
+ *    athenaFIB_SetImageLinkId
+ *
+ *    athenaFIB_SetAggregation
+ *
+ *    athenaFIB_AddLeasedRoute
+ *    athenaFIB_ExpireLeases
  */
 
 /**
@@ -67,6 +81,8 @@ CCNxName *athenaFIBListEntry_GetName(AthenaFIBListEntry *entry);
 
 int athenaFIBListEntry_GetLinkId(AthenaFIBListEntry *entry);
 
+uint64_t athenaFIBListEntry_GetLeaseExpiration(AthenaFIBListEntry *entry);
+
 /**
  * @abstract Create a FIB table
  * @discussion
@@ -85,6 +101,27 @@ int athenaFIBListEntry_GetLinkId(AthenaFIBListEntry *entry);
  */
 AthenaFIB *athenaFIB_Create();
 
+/**
+ * @abstract Create a FIB table whose names are interned in the given pool
+ * @discussion
+ *
+ * Sharing a pool with the PIT and Content Store lets them hold a single copy of names they have
+ * in common.  If namePool is NULL the FIB creates a pool of its own, as athenaFIB_Create does.
+ *
+ * @param [in] namePool pool to intern route names in, may be NULL
+ * @return pointer to a FIB instance
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaNamePool *namePool = athenaNamePool_Create();
+ *     AthenaFIB *athenaFIB = athenaFIB_CreateWithNamePool(namePool);
+ *     athenaNamePool_Release(&namePool);
+ * }
+ * @endcode
+ */
+AthenaFIB *athenaFIB_CreateWithNamePool(AthenaNamePool *namePool);
+
 /**
  * @abstract Release a FIB
  * @discussion
@@ -147,6 +184,36 @@ bool athenaFIB_RemoveLink(AthenaFIB *athenaFIB, const PARCBitVector *ccnxLinkVec
  */
 PARCBitVector *athenaFIB_Lookup(AthenaFIB *athenaFIB, const CCNxName *ccnxName);
 
+/**
+ * @abstract lookup destination vectors for a batch of names in FIB
+ * @discussion
+ *
+ * The same as calling athenaFIB_Lookup for each name in turn, except that the names' prefixes are
+ * found in the name pool together (see athenaNamePool_LookupLongestPrefixBatch) and each result is
+ * an acquired reference, as the result of one lookup may be replaced by the next.  Only the name
+ * pool step is batched, the table probes that follow are made one name at a time.  The forwarder
+ * handles one message at a time and does not call this yet.
+ *
+ * @param [in] athenaFIB
+ * @param [in] ccnxNames names to look up
+ * @param [in] count number of names
+ * @param [out] results filled in with an acquired vector of links for each name, or NULL if it has no route
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *egressVectors[count];
+ *     athenaFIB_LookupBatch(athenaFIB, names, count, egressVectors);
+ *     for (size_t i = 0; i < count; i++) {
+ *         if (egressVectors[i]) {
+ *             parcBitVector_Release(&egressVectors[i]);
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+void athenaFIB_LookupBatch(AthenaFIB *athenaFIB, const CCNxName **ccnxNames, size_t count, PARCBitVector **results);
+
 /**
  * @abstract add route to FIB
  * @discussion
@@ -212,6 +279,227 @@ bool athenaFIB_DeleteRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const
  */
 PARCList *athenaFIB_CreateEntryList(AthenaFIB *athenaFIB);
 
+/**
+ * @abstract retrieve the routes to one link, with their leases
+ * @discussion
+ *
+ * Closing a link removes every route to it.  The list taken before closing it can be given to
+ * athenaFIB_RestoreLinkEntries to put the same routes back once it has been opened again.
+ *
+ * @param [in] athenaFIB
+ * @param [in] linkId link whose routes are wanted
+ * @return PARCList of AthenaFIBListEntry, empty if nothing is routed to the link
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCList *routes = athenaFIB_CreateLinkEntryList(athenaFIB, linkId);
+ *     ...
+ *     parcList_Release(&routes);
+ * }
+ * @endcode
+ */
+PARCList *athenaFIB_CreateLinkEntryList(AthenaFIB *athenaFIB, int linkId);
+
+/**
+ * @abstract add the routes of an entry list to a link
+ * @discussion
+ *
+ * Each route is added to the given link rather than the one it was listed for, leased routes keep
+ * their lease expiration.
+ *
+ * @param [in] athenaFIB
+ * @param [in] entries list from athenaFIB_CreateLinkEntryList
+ * @param [in] linkId link to route the entries to
+ * @return number of routes added
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaFIB_RestoreLinkEntries(athenaFIB, routes, linkId);
+ * }
+ * @endcode
+ */
+size_t athenaFIB_RestoreLinkEntries(AthenaFIB *athenaFIB, PARCList *entries, int linkId);
+
+/**
+ * @abstract acquire a snapshot of the FIB routes
+ * @discussion
+ *
+ * The snapshot holds one entry per route and link, rendered as {"name", "linkId"}.  It is
+ * taken once and shared by every caller until the next route is added or removed, and remains
+ * valid, unchanged, for as long as a caller holds it.
+ *
+ * @param [in] athenaFIB
+ * @return an acquired snapshot, to be released with athenaSnapshot_Release
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaSnapshot *snapshot = athenaFIB_AcquireSnapshot(athenaFIB);
+ *     ...
+ *     athenaSnapshot_Release(&snapshot);
+ * }
+ * @endcode
+ */
+AthenaSnapshot *athenaFIB_AcquireSnapshot(AthenaFIB *athenaFIB);
+
+/**
+ * @abstract set the compiled routes the FIB's routes overlay
+ * @discussion
+ *
+ * Lookups use the longest matching route from either the image or the routes added to the FIB.
+ * Adding or deleting a route the image has changes the FIB's copy of it, and a route deleted
+ * from the image stays hidden until it's added again.  The image names its links, which are not
+ * routed to until athenaFIB_SetImageLinkId gives their link ids, and are forgotten again when
+ * athenaFIB_RemoveLink removes them.  Image routes are not included in the entry list or
+ * snapshot.  Setting a new image replaces the previous one, NULL removes it.
+ *
+ * @param [in] athenaFIB
+ * @param [in] image compiled routes, acquired by the FIB, may be NULL
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaFIBImage *image = athenaFIBImage_Open("/var/athena/routes.fib", log);
+ *     athenaFIB_SetImage(athenaFIB, image);
+ *     athenaFIBImage_Release(&image);
+ * }
+ * @endcode
+ */
+void athenaFIB_SetImage(AthenaFIB *athenaFIB, AthenaFIBImage *image);
+
+/**
+ * @abstract return the compiled routes set with athenaFIB_SetImage
+ *
+ * @param [in] athenaFIB
+ * @return the FIB's image, NULL if it has none
+ */
+AthenaFIBImage *athenaFIB_GetImage(const AthenaFIB *athenaFIB);
+
+/**
+ * @abstract give the link id of one of the image's links
+ *
+ * @param [in] athenaFIB
+ * @param [in] imageLinkIndex index of the link in the image
+ * @param [in] linkId id of the open link with that name, -1 if it isn't open
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < athenaFIBImage_GetNumberOfLinks(image); i++) {
+ *         const char *linkName = athenaFIBImage_GetLinkName(image, i);
+ *         athenaFIB_SetImageLinkId(athenaFIB, i, athenaTransportLinkAdapter_LinkNameToId(adapter, linkName));
+ *     }
+ * }
+ * @endcode
+ */
+void athenaFIB_SetImageLinkId(AthenaFIB *athenaFIB, size_t imageLinkIndex, int linkId);
+
+/**
+ * @abstract aggregate routes that add nothing to the route above them
+ * @discussion
+ *
+ * A route whose links are the same as those of the nearest route above it, such as lci:/a/b/1
+ * through lci:/a/b/9999 all to the links of lci:/a/b, doesn't change the result of any lookup.
+ * When aggregating, such routes are kept out of the table searched by lookups, leaving it smaller
+ * and quicker to search, and are put back as soon as a route change makes them differ.  Lookups,
+ * route changes, the entry list and snapshots give the same results as without aggregation.
+ * Routes are aggregated as they are added or changed, and the whole table again each time as many
+ * routes have been added as it held at the last pass, catching routes added before the route above
+ * them.
+ *
+ * Aggregation isn't available while the FIB has an image, setting one turns it off.
+ *
+ * @param [in] athenaFIB
+ * @param [in] aggregate true to aggregate routes, false to put every aggregated route back
+ * @return false if aggregation was requested and the FIB has an image
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaFIB_SetAggregation(athenaFIB, true);
+ * }
+ * @endcode
+ */
+bool athenaFIB_SetAggregation(AthenaFIB *athenaFIB, bool aggregate);
+
+/**
+ * @abstract return the number of routes kept out of the lookup table by aggregation
+ *
+ * @param [in] athenaFIB
+ * @return number of aggregated routes
+ */
+size_t athenaFIB_GetNumberOfAggregatedRoutes(const AthenaFIB *athenaFIB);
+
+/**
+ * @abstract add a route that is removed unless its lease is renewed
+ * @discussion
+ *
+ * Each link of the route holds a lease until the given expiration time, adding the route again
+ * renews the leases.  A route added, or deleted, with athenaFIB_AddRoute or athenaFIB_DeleteRoute
+ * no longer has a lease on the links it names, nor does one whose link is removed.
+ *
+ * @param [in] athenaFIB
+ * @param [in] ccnxName prefix of the route
+ * @param [in] ccnxLinkVector links of the route
+ * @param [in] expiration time in milliseconds at which the leases run out
+ * @return true if the route was added
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaFIB_AddLeasedRoute(athenaFIB, prefix, linkVector, nowInMillis + lifetimeInMillis);
+ * }
+ * @endcode
+ */
+bool athenaFIB_AddLeasedRoute(AthenaFIB *athenaFIB, const CCNxName *ccnxName, const PARCBitVector *ccnxLinkVector,
+                              uint64_t expiration);
+
+/**
+ * @abstract remove the routes whose leases have run out
+ * @discussion
+ *
+ * Returns straight away until the earliest lease runs out, so it can be called often.
+ *
+ * @param [in] athenaFIB
+ * @param [in] now current time in milliseconds, on the clock lease expirations were given on
+ * @return number of leases that ran out, each removing a route to one link
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t numExpired = athenaFIB_ExpireLeases(athenaFIB, nowInMillis);
+ * }
+ * @endcode
+ */
+size_t athenaFIB_ExpireLeases(AthenaFIB *athenaFIB, uint64_t now);
+
+/**
+ * @abstract return the number of leases held on routes
+ *
+ * @param [in] athenaFIB
+ * @return number of leases, one per link of each leased route
+ */
+size_t athenaFIB_GetNumberOfLeases(const AthenaFIB *athenaFIB);
+
+/**
+ * @abstract list the number of leases held under each leased prefix
+ *
+ * @param [in] athenaFIB
+ * @return array of objects with the prefix "name" and its "numLeases", to be released by the caller
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSONArray *leaseCounts = athenaFIB_CreateLeaseCounts(athenaFIB);
+ *     parcJSON_AddArray(json, "routeLeases", leaseCounts);
+ *     parcJSONArray_Release(&leaseCounts);
+ * }
+ * @endcode
+ */
+PARCJSONArray *athenaFIB_CreateLeaseCounts(AthenaFIB *athenaFIB);
+
 /**
  * Process a message (e.g. an Interest) addressed to this module. For example, it might be a
  * message asking for a particular statistic or a control message. The response can be NULL,
@@ -0,0 +1,711 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena compiled FIB images
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/athena/athena_FIBImage.h>
+
+#define AthenaFIBImage_Magic   "ATHNAFIB"
+#define AthenaFIBImage_Version 1
+#define AthenaFIBImage_Align   8
+
+/*
+ * Image layout, every section starts on an 8 byte boundary:
+ *
+ *     header
+ *     nodes       numNodes nodes in breadth first order, the root first
+ *     nextHops    numNextHops link indexes, each node's are contiguous
+ *     linkNames   numLinks offsets into strings
+ *     strings     NUL terminated link names
+ *     components  component values, each node's at its componentOffset
+ */
+typedef struct athena_fib_image_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numRoutes;
+    uint32_t numNodes;
+    uint32_t numNextHops;
+    uint32_t numLinks;
+    uint32_t reserved;
+    uint64_t nodesOffset;
+    uint64_t nextHopsOffset;
+    uint64_t linkNamesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t componentsOffset;
+    uint64_t componentsSize;
+} _AthenaFIBImageHeader;
+
+typedef struct athena_fib_image_node {
+    uint64_t componentOffset;
+    uint32_t componentLength;
+    uint32_t componentType;
+    uint32_t firstChild;              // children are nodes [firstChild, firstChild + numChildren), sorted
+    uint32_t numChildren;
+    uint32_t firstNextHop;            // links routed to are nextHops [firstNextHop, firstNextHop + numNextHops)
+    uint32_t numNextHops;
+} _AthenaFIBImageNode;
+
+struct athena_fib_image {
+    void *base;
+    size_t size;
+    const _AthenaFIBImageHeader *header;
+    const _AthenaFIBImageNode *nodes;
+    const uint32_t *nextHops;
+    const uint32_t *linkNames;
+    const char *strings;
+    const uint8_t *components;
+};
+
+static int
+_compareComponent(uint32_t typeA, size_t lengthA, const uint8_t *valueA, uint32_t typeB, size_t lengthB, const uint8_t *valueB)
+{
+    if (typeA != typeB) {
+        return (typeA < typeB) ? -1 : 1;
+    }
+    if (lengthA != lengthB) {
+        return (lengthA < lengthB) ? -1 : 1;
+    }
+    return (lengthA > 0) ? memcmp(valueA, valueB, lengthA) : 0;
+}
+
+static const uint8_t *
+_segmentValue(const CCNxNameSegment *segment, size_t *length)
+{
+    PARCBuffer *valueBuffer = ccnxNameSegment_GetValue(segment);
+    *length = parcBuffer_Remaining(valueBuffer);
+    return (*length > 0) ? parcBuffer_Overlay(valueBuffer, 0) : NULL;
+}
+
+static int
+_compareSegment(const CCNxNameSegment *a, const CCNxNameSegment *b)
+{
+    size_t lengthA;
+    size_t lengthB;
+    const uint8_t *valueA = _segmentValue(a, &lengthA);
+    const uint8_t *valueB = _segmentValue(b, &lengthB);
+    return _compareComponent(ccnxNameSegment_GetType(a), lengthA, valueA, ccnxNameSegment_GetType(b), lengthB, valueB);
+}
+
+// The default route is given as a name with a single empty segment, as it is to athenaFIB_AddRoute
+static size_t
+_routeDepth(const CCNxName *prefix)
+{
+    size_t segmentCount = ccnxName_GetSegmentCount(prefix);
+    if (segmentCount == 1) {
+        CCNxNameSegment *segment = ccnxName_GetSegment(prefix, 0);
+        if ((ccnxNameSegment_GetType(segment) == CCNxNameLabelType_NAME) && (ccnxNameSegment_Length(segment) == 0)) {
+            return 0;
+        }
+    }
+    return segmentCount;
+}
+
+//
+// Compiler
+//
+
+typedef struct athena_fib_image_route {
+    CCNxName *prefix;
+    uint32_t linkIndex;
+    size_t order;                     // position in the route list, keeping each node's links in list order
+} _AthenaFIBImageRoute;
+
+typedef struct athena_fib_image_compile_node {
+    const CCNxNameSegment *segment;   // NULL for the root, borrowed from the route that created the node
+    struct athena_fib_image_compile_node **children;
+    size_t numChildren;
+    size_t childCapacity;
+    uint32_t *links;
+    size_t numLinks;
+    size_t linkCapacity;
+    uint32_t firstChild;
+} _AthenaFIBImageCompileNode;
+
+static _AthenaFIBImageCompileNode *
+_compileNode_Create(const CCNxNameSegment *segment, size_t *numNodes)
+{
+    _AthenaFIBImageCompileNode *node = parcMemory_AllocateAndClear(sizeof(_AthenaFIBImageCompileNode));
+    assertNotNull(node, "parcMemory_AllocateAndClear failed to allocate %zu bytes", sizeof(_AthenaFIBImageCompileNode));
+    node->segment = segment;
+    (*numNodes)++;
+    return node;
+}
+
+static void
+_compileNode_Destroy(_AthenaFIBImageCompileNode **nodePtr)
+{
+    _AthenaFIBImageCompileNode *node = *nodePtr;
+    for (size_t i = 0; i < node->numChildren; i++) {
+        _compileNode_Destroy(&node->children[i]);
+    }
+    if (node->children) {
+        parcMemory_Deallocate(&node->children);
+    }
+    if (node->links) {
+        parcMemory_Deallocate(&node->links);
+    }
+    parcMemory_Deallocate(nodePtr);
+}
+
+static void
+_compileNode_AddChild(_AthenaFIBImageCompileNode *node, _AthenaFIBImageCompileNode *child)
+{
+    if (node->numChildren == node->childCapacity) {
+        node->childCapacity = (node->childCapacity > 0) ? node->childCapacity * 2 : 4;
+        node->children = parcMemory_Reallocate(node->children, node->childCapacity * sizeof(_AthenaFIBImageCompileNode *));
+        assertNotNull(node->children, "parcMemory_Reallocate failed to allocate %zu children", node->childCapacity);
+    }
+    node->children[node->numChildren++] = child;
+}
+
+static bool
+_compileNode_AddLink(_AthenaFIBImageCompileNode *node, uint32_t linkIndex)
+{
+    for (size_t i = 0; i < node->numLinks; i++) {
+        if (node->links[i] == linkIndex) {
+            return false;
+        }
+    }
+    if (node->numLinks == node->linkCapacity) {
+        node->linkCapacity = (node->linkCapacity > 0) ? node->linkCapacity * 2 : 2;
+        node->links = parcMemory_Reallocate(node->links, node->linkCapacity * sizeof(uint32_t));
+        assertNotNull(node->links, "parcMemory_Reallocate failed to allocate %zu links", node->linkCapacity);
+    }
+    node->links[node->numLinks++] = linkIndex;
+    return true;
+}
+
+static int
+_compareRoutes(const void *a, const void *b)
+{
+    const _AthenaFIBImageRoute *routeA = a;
+    const _AthenaFIBImageRoute *routeB = b;
+    size_t depthA = _routeDepth(routeA->prefix);
+    size_t depthB = _routeDepth(routeB->prefix);
+
+    for (size_t i = 0; (i < depthA) && (i < depthB); i++) {
+        int result = _compareSegment(ccnxName_GetSegment(routeA->prefix, i), ccnxName_GetSegment(routeB->prefix, i));
+        if (result != 0) {
+            return result;
+        }
+    }
+    if (depthA != depthB) {
+        return (depthA < depthB) ? -1 : 1;
+    }
+    return (routeA->order < routeB->order) ? -1 : (routeA->order > routeB->order);
+}
+
+static bool
+_writeSection(FILE *file, const void *data, size_t size, uint64_t *offset)
+{
+    static const uint8_t padding[AthenaFIBImage_Align] = { 0 };
+    if ((size > 0) && (fwrite(data, size, 1, file) != 1)) {
+        return false;
+    }
+    *offset += size;
+    size_t padSize = (AthenaFIBImage_Align - (*offset % AthenaFIBImage_Align)) % AthenaFIBImage_Align;
+    if ((padSize > 0) && (fwrite(padding, padSize, 1, file) != 1)) {
+        return false;
+    }
+    *offset += padSize;
+    return true;
+}
+
+static uint64_t
+_alignedSize(uint64_t size)
+{
+    return (size + AthenaFIBImage_Align - 1) & ~((uint64_t) AthenaFIBImage_Align - 1);
+}
+
+/*
+ * Write the trie breadth first so that every node's children are contiguous, order lists the nodes
+ * in that order.
+ */
+static bool
+_writeImage(FILE *file, _AthenaFIBImageCompileNode **order, _AthenaFIBImageHeader *header,
+            char **linkNames, size_t numLinks)
+{
+    uint64_t stringsSize = 0;
+    for (size_t i = 0; i < numLinks; i++) {
+        stringsSize += strlen(linkNames[i]) + 1;
+    }
+    uint64_t componentsSize = 0;
+    for (size_t i = 0; i < header->numNodes; i++) {
+        if (order[i]->segment) {
+            componentsSize += ccnxNameSegment_Length(order[i]->segment);
+        }
+    }
+
+    header->nodesOffset = _alignedSize(sizeof(_AthenaFIBImageHeader));
+    header->nextHopsOffset = header->nodesOffset + _alignedSize((uint64_t) header->numNodes * sizeof(_AthenaFIBImageNode));
+    header->linkNamesOffset = header->nextHopsOffset + _alignedSize((uint64_t) header->numNextHops * sizeof(uint32_t));
+    header->stringsOffset = header->linkNamesOffset + _alignedSize((uint64_t) numLinks * sizeof(uint32_t));
+    header->stringsSize = stringsSize;
+    header->componentsOffset = header->stringsOffset + _alignedSize(stringsSize);
+    header->componentsSize = componentsSize;
+
+    uint64_t offset = 0;
+    if (_writeSection(file, header, sizeof(_AthenaFIBImageHeader), &offset) == false) {
+        return false;
+    }
+
+    uint64_t componentOffset = 0;
+    uint32_t firstNextHop = 0;
+    for (size_t i = 0; i < header->numNodes; i++) {
+        _AthenaFIBImageCompileNode *compileNode = order[i];
+        _AthenaFIBImageNode node = { 0 };
+        if (compileNode->segment) {
+            node.componentOffset = componentOffset;
+            node.componentLength = (uint32_t) ccnxNameSegment_Length(compileNode->segment);
+            node.componentType = ccnxNameSegment_GetType(compileNode->segment);
+            componentOffset += node.componentLength;
+        }
+        node.firstChild = compileNode->firstChild;
+        node.numChildren = (uint32_t) compileNode->numChildren;
+        node.firstNextHop = firstNextHop;
+        node.numNextHops = (uint32_t) compileNode->numLinks;
+        firstNextHop += node.numNextHops;
+        if (fwrite(&node, sizeof(node), 1, file) != 1) {
+            return false;
+        }
+    }
+    offset += (uint64_t) header->numNodes * sizeof(_AthenaFIBImageNode);
+    if (_writeSection(file, NULL, 0, &offset) == false) {
+        return false;
+    }
+
+    for (size_t i = 0; i < header->numNodes; i++) {
+        if ((order[i]->numLinks > 0) && (fwrite(order[i]->links, sizeof(uint32_t), order[i]->numLinks, file) != order[i]->numLinks)) {
+            return false;
+        }
+        offset += order[i]->numLinks * sizeof(uint32_t);
+    }
+    if (_writeSection(file, NULL, 0, &offset) == false) {
+        return false;
+    }
+
+    uint32_t stringOffset = 0;
+    for (size_t i = 0; i < numLinks; i++) {
+        if (fwrite(&stringOffset, sizeof(stringOffset), 1, file) != 1) {
+            return false;
+        }
+        stringOffset += (uint32_t) strlen(linkNames[i]) + 1;
+    }
+    offset += numLinks * sizeof(uint32_t);
+    if (_writeSection(file, NULL, 0, &offset) == false) {
+        return false;
+    }
+
+    for (size_t i = 0; i < numLinks; i++) {
+        if (fwrite(linkNames[i], strlen(linkNames[i]) + 1, 1, file) != 1) {
+            return false;
+        }
+    }
+    offset += stringsSize;
+    if (_writeSection(file, NULL, 0, &offset) == false) {
+        return false;
+    }
+
+    for (size_t i = 0; i < header->numNodes; i++) {
+        if (order[i]->segment) {
+            size_t length;
+            const uint8_t *value = _segmentValue(order[i]->segment, &length);
+            if ((length > 0) && (fwrite(value, length, 1, file) != 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static uint32_t
+_linkIndex(char ***linkNames, size_t *numLinks, const char *linkName)
+{
+    for (size_t i = 0; i < *numLinks; i++) {
+        if (strcmp((*linkNames)[i], linkName) == 0) {
+            return (uint32_t) i;
+        }
+    }
+    *linkNames = parcMemory_Reallocate(*linkNames, (*numLinks + 1) * sizeof(char *));
+    assertNotNull(*linkNames, "parcMemory_Reallocate failed to allocate %zu link names", *numLinks + 1);
+    (*linkNames)[*numLinks] = parcMemory_StringDuplicate(linkName, strlen(linkName));
+    return (uint32_t) (*numLinks)++;
+}
+
+ssize_t
+athenaFIBImage_Compile(FILE *routeList, const char *imagePath, PARCLog *log)
+{
+    _AthenaFIBImageRoute *routes = NULL;
+    size_t numRoutes = 0;
+    size_t routeCapacity = 0;
+    char **linkNames = NULL;
+    size_t numLinks = 0;
+    ssize_t result = -1;
+
+    char line[MAXPATHLEN];
+    int lineNumber = 0;
+    bool parsed = true;
+    while (parsed && (fgets(line, sizeof(line), routeList) != NULL)) {
+        lineNumber++;
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        char *linkName = strtok(line, " \t\r\n");
+        if (linkName == NULL) {
+            continue;
+        }
+        char *prefix = strtok(NULL, " \t\r\n");
+        if ((prefix == NULL) || (strtok(NULL, " \t\r\n") != NULL)) {
+            parcLog_Error(log, "line %d: expected <linkName> <prefix>", lineNumber);
+            parsed = false;
+            break;
+        }
+        CCNxName *prefixName = ccnxName_CreateFromURI(prefix);
+        if (prefixName == NULL) {
+            parcLog_Error(log, "line %d: unable to parse prefix %s", lineNumber, prefix);
+            parsed = false;
+            break;
+        }
+        if (_routeDepth(prefixName) > AthenaFIBImageMaxDepth) {
+            parcLog_Error(log, "line %d: prefix %s has more than %d segments", lineNumber, prefix, AthenaFIBImageMaxDepth);
+            ccnxName_Release(&prefixName);
+            parsed = false;
+            break;
+        }
+
+        if (numRoutes == routeCapacity) {
+            routeCapacity = (routeCapacity > 0) ? routeCapacity * 2 : 1024;
+            routes = parcMemory_Reallocate(routes, routeCapacity * sizeof(_AthenaFIBImageRoute));
+            assertNotNull(routes, "parcMemory_Reallocate failed to allocate %zu routes", routeCapacity);
+        }
+        routes[numRoutes].prefix = prefixName;
+        routes[numRoutes].linkIndex = _linkIndex(&linkNames, &numLinks, linkName);
+        routes[numRoutes].order = numRoutes;
+        numRoutes++;
+    }
+
+    if (parsed) {
+        // Sorted routes add their nodes to the trie in order, each only needs comparing with the route before
+        qsort(routes, numRoutes, sizeof(_AthenaFIBImageRoute), _compareRoutes);
+
+        size_t numNodes = 0;
+        _AthenaFIBImageCompileNode *root = _compileNode_Create(NULL, &numNodes);
+        _AthenaFIBImageCompileNode *path[AthenaFIBImageMaxDepth + 1] = { root };
+        size_t pathDepth = 0;
+        size_t numPrefixes = 0;
+        size_t numNextHops = 0;
+
+        for (size_t i = 0; i < numRoutes; i++) {
+            size_t depth = _routeDepth(routes[i].prefix);
+            size_t common = 0;
+            if (i > 0) {
+                while ((common < depth) && (common < pathDepth) &&
+                       (_compareSegment(ccnxName_GetSegment(routes[i - 1].prefix, common), ccnxName_GetSegment(routes[i].prefix, common)) == 0)) {
+                    common++;
+                }
+            }
+            for (size_t d = common; d < depth; d++) {
+                _AthenaFIBImageCompileNode *child = _compileNode_Create(ccnxName_GetSegment(routes[i].prefix, d), &numNodes);
+                _compileNode_AddChild(path[d], child);
+                path[d + 1] = child;
+            }
+            pathDepth = depth;
+
+            _AthenaFIBImageCompileNode *node = path[depth];
+            if (node->numLinks == 0) {
+                numPrefixes++;
+            }
+            if (_compileNode_AddLink(node, routes[i].linkIndex)) {
+                numNextHops++;
+            }
+        }
+
+        _AthenaFIBImageCompileNode **order = parcMemory_Allocate(numNodes * sizeof(_AthenaFIBImageCompileNode *));
+        assertNotNull(order, "parcMemory_Allocate failed to allocate %zu nodes", numNodes);
+        size_t tail = 0;
+        order[tail++] = root;
+        for (size_t head = 0; head < tail; head++) {
+            order[head]->firstChild = (uint32_t) tail;
+            for (size_t c = 0; c < order[head]->numChildren; c++) {
+                order[tail++] = order[head]->children[c];
+            }
+        }
+
+        _AthenaFIBImageHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, AthenaFIBImage_Magic, sizeof(header.magic));
+        header.version = AthenaFIBImage_Version;
+        header.numRoutes = (uint32_t) numPrefixes;
+        header.numNodes = (uint32_t) numNodes;
+        header.numNextHops = (uint32_t) numNextHops;
+        header.numLinks = (uint32_t) numLinks;
+
+        // Write beside the image and rename over it, processes with the old image mapped keep it
+        char temporaryPath[MAXPATHLEN];
+        snprintf(temporaryPath, sizeof(temporaryPath), "%s.%d", imagePath, (int) getpid());
+        FILE *imageFile = fopen(temporaryPath, "w");
+        if (imageFile == NULL) {
+            parcLog_Error(log, "Unable to create %s: %s", temporaryPath, strerror(errno));
+        } else {
+            bool written = _writeImage(imageFile, order, &header, linkNames, numLinks);
+            if ((fclose(imageFile) != 0) || (written == false)) {
+                parcLog_Error(log, "Unable to write %s: %s", temporaryPath, strerror(errno));
+                unlink(temporaryPath);
+            } else if (rename(temporaryPath, imagePath) != 0) {
+                parcLog_Error(log, "Unable to rename %s to %s: %s", temporaryPath, imagePath, strerror(errno));
+                unlink(temporaryPath);
+            } else {
+                result = (ssize_t) numPrefixes;
+            }
+        }
+
+        parcMemory_Deallocate(&order);
+        _compileNode_Destroy(&root);
+    }
+
+    for (size_t i = 0; i < numRoutes; i++) {
+        ccnxName_Release(&routes[i].prefix);
+    }
+    if (routes) {
+        parcMemory_Deallocate(&routes);
+    }
+    for (size_t i = 0; i < numLinks; i++) {
+        parcMemory_Deallocate(&linkNames[i]);
+    }
+    if (linkNames) {
+        parcMemory_Deallocate(&linkNames);
+    }
+    return result;
+}
+
+//
+// Mapped images
+//
+
+static void
+_athenaFIBImage_Destroy(AthenaFIBImage **imagePtr)
+{
+    AthenaFIBImage *image = *imagePtr;
+    munmap(image->base, image->size);
+}
+
+parcObject_ExtendPARCObject(AthenaFIBImage, _athenaFIBImage_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaFIBImage, AthenaFIBImage);
+
+parcObject_ImplementRelease(athenaFIBImage, AthenaFIBImage);
+
+static bool
+_sectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, size_t imageSize)
+{
+    return (offset <= imageSize) && (count <= ((imageSize - offset) / elementSize));
+}
+
+static bool
+_athenaFIBImage_IsValid(const AthenaFIBImage *image)
+{
+    const _AthenaFIBImageHeader *header = image->header;
+    if ((memcmp(header->magic, AthenaFIBImage_Magic, sizeof(header->magic)) != 0) || (header->version != AthenaFIBImage_Version)) {
+        return false;
+    }
+    if ((header->numNodes == 0) ||
+        !_sectionFits(header->nodesOffset, header->numNodes, sizeof(_AthenaFIBImageNode), image->size) ||
+        !_sectionFits(header->nextHopsOffset, header->numNextHops, sizeof(uint32_t), image->size) ||
+        !_sectionFits(header->linkNamesOffset, header->numLinks, sizeof(uint32_t), image->size) ||
+        !_sectionFits(header->stringsOffset, header->stringsSize, 1, image->size) ||
+        !_sectionFits(header->componentsOffset, header->componentsSize, 1, image->size)) {
+        return false;
+    }
+    if ((header->nodesOffset % AthenaFIBImage_Align) || (header->nextHopsOffset % AthenaFIBImage_Align) ||
+        (header->linkNamesOffset % AthenaFIBImage_Align)) {
+        return false;
+    }
+    // Link names are checked here, nodes as they're visited by lookups
+    const uint32_t *linkNames = (const uint32_t *) ((const uint8_t *) image->base + header->linkNamesOffset);
+    const char *strings = (const char *) image->base + header->stringsOffset;
+    for (uint32_t i = 0; i < header->numLinks; i++) {
+        if ((linkNames[i] >= header->stringsSize) || (memchr(strings + linkNames[i], '\0', header->stringsSize - linkNames[i]) == NULL)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AthenaFIBImage *
+athenaFIBImage_Open(const char *imagePath, PARCLog *log)
+{
+    int fd = open(imagePath, O_RDONLY);
+    if (fd < 0) {
+        parcLog_Error(log, "Unable to open FIB image %s: %s", imagePath, strerror(errno));
+        return NULL;
+    }
+    struct stat status;
+    if ((fstat(fd, &status) != 0) || (status.st_size < (off_t) sizeof(_AthenaFIBImageHeader))) {
+        parcLog_Error(log, "FIB image %s is too short", imagePath);
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        parcLog_Error(log, "Unable to map FIB image %s: %s", imagePath, strerror(errno));
+        return NULL;
+    }
+
+    AthenaFIBImage *image = parcObject_CreateInstance(AthenaFIBImage);
+    assertNotNull(image, "parcObject_CreateInstance failed to create an AthenaFIBImage");
+    image->base = base;
+    image->size = (size_t) status.st_size;
+    image->header = (const _AthenaFIBImageHeader *) base;
+
+    if (_athenaFIBImage_IsValid(image) == false) {
+        parcLog_Error(log, "%s is not a valid FIB image", imagePath);
+        athenaFIBImage_Release(&image);
+        return NULL;
+    }
+
+    const uint8_t *bytes = base;
+    image->nodes = (const _AthenaFIBImageNode *) (bytes + image->header->nodesOffset);
+    image->nextHops = (const uint32_t *) (bytes + image->header->nextHopsOffset);
+    image->linkNames = (const uint32_t *) (bytes + image->header->linkNamesOffset);
+    image->strings = (const char *) (bytes + image->header->stringsOffset);
+    image->components = bytes + image->header->componentsOffset;
+    return image;
+}
+
+size_t
+athenaFIBImage_GetNumberOfRoutes(const AthenaFIBImage *image)
+{
+    return image->header->numRoutes;
+}
+
+size_t
+athenaFIBImage_GetNumberOfLinks(const AthenaFIBImage *image)
+{
+    return image->header->numLinks;
+}
+
+const char *
+athenaFIBImage_GetLinkName(const AthenaFIBImage *image, size_t linkIndex)
+{
+    assertTrue(linkIndex < image->header->numLinks, "Link index %zu out of range", linkIndex);
+    return image->strings + image->linkNames[linkIndex];
+}
+
+static bool
+_addMatch(const AthenaFIBImage *image, const _AthenaFIBImageNode *node, size_t depth,
+          AthenaFIBImageMatch *matches, size_t maxMatches, size_t *numMatches)
+{
+    if (node->numNextHops == 0) {
+        return true;
+    }
+    if (((uint64_t) node->firstNextHop + node->numNextHops) > image->header->numNextHops) {
+        return false;
+    }
+    if (*numMatches < maxMatches) {
+        matches[*numMatches].depth = depth;
+        matches[*numMatches].links = &image->nextHops[node->firstNextHop];
+        matches[*numMatches].numLinks = node->numNextHops;
+        (*numMatches)++;
+    }
+    return true;
+}
+
+size_t
+athenaFIBImage_Match(const AthenaFIBImage *image, const CCNxName *name, AthenaFIBImageMatch *matches, size_t maxMatches)
+{
+    const _AthenaFIBImageHeader *header = image->header;
+    size_t numMatches = 0;
+
+    const _AthenaFIBImageNode *node = &image->nodes[0];
+    if (_addMatch(image, node, 0, matches, maxMatches, &numMatches) == false) {
+        return numMatches;
+    }
+
+    size_t segmentCount = ccnxName_GetSegmentCount(name);
+    for (size_t depth = 0; (depth < segmentCount) && (node->numChildren > 0); depth++) {
+        if (((uint64_t) node->firstChild + node->numChildren) > header->numNodes) {
+            break;
+        }
+        CCNxNameSegment *segment = ccnxName_GetSegment(name, depth);
+        uint32_t type = ccnxNameSegment_GetType(segment);
+        size_t length;
+        const uint8_t *value = _segmentValue(segment, &length);
+
+        // Binary search of the node's children
+        const _AthenaFIBImageNode *child = NULL;
+        size_t low = node->firstChild;
+        size_t high = (size_t) node->firstChild + node->numChildren;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            const _AthenaFIBImageNode *candidate = &image->nodes[middle];
+            if ((candidate->componentOffset + candidate->componentLength) > header->componentsSize) {
+                return numMatches;
+            }
+            int comparison = _compareComponent(candidate->componentType, candidate->componentLength,
+                                               image->components + candidate->componentOffset, type, length, value);
+            if (comparison == 0) {
+                child = candidate;
+                break;
+            } else if (comparison < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (child == NULL) {
+            break;
+        }
+        node = child;
+        if (_addMatch(image, node, depth + 1, matches, maxMatches, &numMatches) == false) {
+            break;
+        }
+    }
+    return numMatches;
+}
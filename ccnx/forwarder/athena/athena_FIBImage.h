@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_FIBImage_h
+#define libathena_FIBImage_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include <parc/logging/parc_Log.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+//
+// Compiled FIB images
+//
+// A FIB image is a route list compiled offline into a single flat, pointer-free file that a forwarder
+// maps read-only and looks names up in directly, without building a CCNxName or PARCBitVector per route.
+// The image holds a trie of name components: every node's children are contiguous and sorted by
+// component type, length and value, so each step of a lookup is a binary search, and every node
+// carries the indexes of the links it routes to.  Routes refer to links by name and the forwarder
+// maps those to link ids once the links are open.  Images are written in host byte order, may be
+// mapped by any number of processes on the host, and are replaced by renaming a new image over them.
+//
+
+#define AthenaFIBImageMaxDepth 64 // most name segments a compiled route may have
+
+struct athena_fib_image;
+typedef struct athena_fib_image AthenaFIBImage;
+
+/**
+ * @typedef AthenaFIBImageMatch
+ * @brief A prefix of a looked up name that the image has a route for
+ */
+typedef struct athena_fib_image_match {
+    size_t depth;                     // number of name segments in the route's prefix
+    const uint32_t *links;            // indexes of the links the route forwards to
+    size_t numLinks;
+} AthenaFIBImageMatch;
+
+/**
+ * @abstract compile a route list into a FIB image
+ * @discussion
+ *
+ * Each line of the route list is "<linkName> <prefix>", blank lines and anything following a '#'
+ * being ignored.  A prefix listed for several links routes to all of them.  The image is written
+ * next to imagePath and renamed over it once complete, so forwarders that have the previous image
+ * mapped keep using it undisturbed.
+ *
+ * @param [in] routeList stream to read routes from
+ * @param [in] imagePath file to write the image to
+ * @param [in] log to report errors to
+ * @return number of routes compiled, or -1 on error
+ *
+ * Example:
+ * @code
+ * {
+ *     FILE *routes = fopen("routes.txt", "r");
+ *     ssize_t numRoutes = athenaFIBImage_Compile(routes, "routes.fib", log);
+ *     fclose(routes);
+ * }
+ * @endcode
+ */
+ssize_t athenaFIBImage_Compile(FILE *routeList, const char *imagePath, PARCLog *log);
+
+/**
+ * @abstract map a FIB image read-only
+ *
+ * @param [in] imagePath file holding the image
+ * @param [in] log to report errors to
+ * @return the mapped image, or NULL if it could not be mapped or isn't a valid image
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaFIBImage *image = athenaFIBImage_Open("routes.fib", log);
+ *     athenaFIBImage_Release(&image);
+ * }
+ * @endcode
+ */
+AthenaFIBImage *athenaFIBImage_Open(const char *imagePath, PARCLog *log);
+
+/**
+ * @abstract acquire a reference to a FIB image
+ *
+ * @param [in] image instance to acquire
+ * @return the same image
+ */
+AthenaFIBImage *athenaFIBImage_Acquire(const AthenaFIBImage *image);
+
+/**
+ * @abstract release a FIB image, unmapping it when the last reference is released
+ *
+ * @param [in,out] imagePtr pointer to the image to release, set to NULL
+ */
+void athenaFIBImage_Release(AthenaFIBImage **imagePtr);
+
+/**
+ * @abstract number of routes compiled into an image
+ *
+ * @param [in] image instance
+ * @return number of routes
+ */
+size_t athenaFIBImage_GetNumberOfRoutes(const AthenaFIBImage *image);
+
+/**
+ * @abstract number of links routed to by an image
+ *
+ * @param [in] image instance
+ * @return number of links, indexed from 0
+ */
+size_t athenaFIBImage_GetNumberOfLinks(const AthenaFIBImage *image);
+
+/**
+ * @abstract name of a link routed to by an image
+ *
+ * @param [in] image instance
+ * @param [in] linkIndex index of the link, less than athenaFIBImage_GetNumberOfLinks
+ * @return name of the link, valid as long as the image is
+ */
+const char *athenaFIBImage_GetLinkName(const AthenaFIBImage *image, size_t linkIndex);
+
+/**
+ * @abstract find the routes of an image for the prefixes of a name
+ * @discussion
+ *
+ * Matches are returned shortest prefix first, so the last match is the longest.  A route for the
+ * default prefix matches at depth 0.
+ *
+ * @param [in] image instance
+ * @param [in] name to look up
+ * @param [out] matches array to fill
+ * @param [in] maxMatches capacity of matches, AthenaFIBImageMaxDepth + 1 holds every possible match
+ * @return number of matches
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaFIBImageMatch matches[AthenaFIBImageMaxDepth + 1];
+ *     size_t numMatches = athenaFIBImage_Match(image, name, matches, AthenaFIBImageMaxDepth + 1);
+ *     if (numMatches > 0) {
+ *         AthenaFIBImageMatch *longest = &matches[numMatches - 1];
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+size_t athenaFIBImage_Match(const AthenaFIBImage *image, const CCNxName *name, AthenaFIBImageMatch *matches, size_t maxMatches);
+#endif // libathena_FIBImage_h
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena parallel fan-out
+ *
+ * Fan-outs waiting for workers are kept on a list in the order they were handed over.  A worker
+ * claims the next chunk of links of the fan-out at the head of the list under the pool mutex, and
+ * the fan-out is taken off the list when its last chunk is claimed, so the mutex is only held to
+ * move a cursor.  The sends themselves are made without it.  Each fan-out counts the links it has
+ * left to send to, and the worker that sends to the last of them records the fan-out's latency and
+ * frees it.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/forwarder/athena/athena_Fanout.h>
+#include <ccnx/forwarder/athena/athena_Stats.h>
+
+typedef enum {
+    _AthenaFanoutCounter_Links,
+    _AthenaFanoutCounter_SendsFailed,
+    _AthenaFanoutCounter_LatencyMicros,
+    _AthenaFanoutCounter_Fanouts,     // counted last, so a fan-out's other counts are seen with it
+    _AthenaFanoutCounter_Count
+} _AthenaFanoutCounter;
+
+#define _AthenaFanoutHistogram_Latency 0
+
+typedef struct athena_fanout_job {
+    struct athena_fanout_job *next;
+    CCNxMetaMessage *ccnxMetaMessage;
+    AthenaTransportLink **links;
+    size_t numLinks;
+    size_t nextLink;                  // first link of the next chunk to claim, under the pool mutex
+    size_t remainingLinks;            // links not yet sent to, updated atomically
+    size_t numSendsFailed;            // updated atomically
+    uint64_t startMicros;
+} _AthenaFanoutJob;
+
+struct athena_fanout {
+    PARCLog *log;
+    size_t threshold;
+    size_t numWorkers;
+    pthread_t *workers;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t work;              // signalled when a fan-out is handed over, or the pool is stopping
+    _AthenaFanoutJob *jobs;           // fan-outs with chunks left to claim, oldest first
+    _AthenaFanoutJob *lastJob;
+    bool running;
+
+    AthenaStats *stats;               // _AthenaFanoutCounter counts and the latency histogram
+    uint64_t maxLatencyMicros;        // updated atomically by the workers
+};
+
+static uint64_t
+_nowInMicros(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+static void
+_athenaFanoutJob_Destroy(_AthenaFanoutJob **jobPtr)
+{
+    _AthenaFanoutJob *job = *jobPtr;
+    for (size_t i = 0; i < job->numLinks; i++) {
+        athenaTransportLink_Release(&job->links[i]);
+    }
+    parcMemory_Deallocate(&job->links);
+    ccnxMetaMessage_Release(&job->ccnxMetaMessage);
+    parcMemory_Deallocate(jobPtr);
+}
+
+static void
+_athenaFanout_Complete(AthenaFanout *fanout, _AthenaFanoutJob *job)
+{
+    uint64_t latencyMicros = _nowInMicros() - job->startMicros;
+
+    uint64_t maxLatencyMicros = __atomic_load_n(&fanout->maxLatencyMicros, __ATOMIC_RELAXED);
+    while ((latencyMicros > maxLatencyMicros) &&
+           !__atomic_compare_exchange_n(&fanout->maxLatencyMicros, &maxLatencyMicros, latencyMicros,
+                                        false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+
+    athenaStats_Add(fanout->stats, _AthenaFanoutCounter_Links, job->numLinks);
+    athenaStats_Add(fanout->stats, _AthenaFanoutCounter_SendsFailed, __atomic_load_n(&job->numSendsFailed, __ATOMIC_ACQUIRE));
+    athenaStats_Add(fanout->stats, _AthenaFanoutCounter_LatencyMicros, latencyMicros);
+    athenaStats_Record(fanout->stats, _AthenaFanoutHistogram_Latency, latencyMicros);
+    athenaStats_Increment(fanout->stats, _AthenaFanoutCounter_Fanouts);
+
+    _athenaFanoutJob_Destroy(&job);
+}
+
+/**
+ * @abstract claim the next chunk of links, waiting for a fan-out if there are none
+ *
+ * @return the fan-out the chunk belongs to, or NULL once the pool has stopped and every chunk has been claimed
+ */
+static _AthenaFanoutJob *
+_athenaFanout_Claim(AthenaFanout *fanout, size_t *first, size_t *last)
+{
+    pthread_mutex_lock(&fanout->mutex);
+    while ((fanout->jobs == NULL) && fanout->running) {
+        pthread_cond_wait(&fanout->work, &fanout->mutex);
+    }
+    _AthenaFanoutJob *job = fanout->jobs;
+    if (job) {
+        *first = job->nextLink;
+        *last = *first + AthenaFanoutChunkSize;
+        if (*last >= job->numLinks) {
+            *last = job->numLinks;
+            fanout->jobs = job->next;
+            if (fanout->jobs == NULL) {
+                fanout->lastJob = NULL;
+            }
+        }
+        job->nextLink = *last;
+    }
+    pthread_mutex_unlock(&fanout->mutex);
+    return job;
+}
+
+static void *
+_athenaFanout_Worker(void *arg)
+{
+    AthenaFanout *fanout = arg;
+    size_t first;
+    size_t last;
+    _AthenaFanoutJob *job;
+
+    while ((job = _athenaFanout_Claim(fanout, &first, &last)) != NULL) {
+        size_t numSendsFailed = 0;
+        for (size_t i = first; i < last; i++) {
+            if (athenaTransportLink_Send(job->links[i], job->ccnxMetaMessage) != 0) {
+                numSendsFailed++;
+            }
+        }
+        if (numSendsFailed) {
+            __atomic_fetch_add(&job->numSendsFailed, numSendsFailed, __ATOMIC_RELEASE);
+        }
+        if (__atomic_sub_fetch(&job->remainingLinks, last - first, __ATOMIC_ACQ_REL) == 0) {
+            _athenaFanout_Complete(fanout, job);
+        }
+    }
+    return NULL;
+}
+
+static void
+_athenaFanout_Destroy(AthenaFanout **fanoutPtr)
+{
+    AthenaFanout *fanout = *fanoutPtr;
+
+    // Workers finish the fan-outs already handed to them before they exit
+    pthread_mutex_lock(&fanout->mutex);
+    fanout->running = false;
+    pthread_cond_broadcast(&fanout->work);
+    pthread_mutex_unlock(&fanout->mutex);
+    for (size_t i = 0; i < fanout->numWorkers; i++) {
+        pthread_join(fanout->workers[i], NULL);
+    }
+
+    parcMemory_Deallocate(&fanout->workers);
+    pthread_cond_destroy(&fanout->work);
+    pthread_mutex_destroy(&fanout->mutex);
+    athenaStats_Release(&fanout->stats);
+    parcLog_Release(&fanout->log);
+}
+
+parcObject_ExtendPARCObject(AthenaFanout, _athenaFanout_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaFanout, AthenaFanout);
+
+parcObject_ImplementRelease(athenaFanout, AthenaFanout);
+
+AthenaFanout *
+athenaFanout_Create(size_t numWorkers, size_t threshold, PARCLog *log)
+{
+    assertTrue(numWorkers > 0, "A fan-out pool needs at least one worker");
+    AthenaFanout *fanout = parcObject_CreateAndClearInstance(AthenaFanout);
+    assertNotNull(fanout, "Could not allocate a fan-out pool");
+
+    static const uint64_t bucketMicros[AthenaFanoutLatencyBuckets] = AthenaFanoutLatencyBucketMicros;
+    fanout->stats = athenaStats_Create(_AthenaFanoutCounter_Count, 1, AthenaFanoutLatencyBuckets, bucketMicros);
+
+    fanout->log = parcLog_Acquire(log);
+    fanout->threshold = threshold;
+    fanout->running = true;
+    pthread_mutex_init(&fanout->mutex, NULL);
+    pthread_cond_init(&fanout->work, NULL);
+
+    fanout->workers = parcMemory_AllocateAndClear(sizeof(pthread_t) * numWorkers);
+    assertNotNull(fanout->workers, "Could not allocate fan-out workers");
+    for (; fanout->numWorkers < numWorkers; fanout->numWorkers++) {
+        if (pthread_create(&fanout->workers[fanout->numWorkers], NULL, _athenaFanout_Worker, fanout) != 0) {
+            parcLog_Error(log, "Unable to start fan-out worker (%s)", strerror(errno));
+            athenaFanout_Release(&fanout);
+            return NULL;
+        }
+    }
+    return fanout;
+}
+
+size_t
+athenaFanout_GetThreshold(const AthenaFanout *fanout)
+{
+    return fanout->threshold;
+}
+
+PARCBitVector *
+athenaFanout_Send(AthenaFanout *fanout, AthenaTransportLinkAdapter *adapter,
+                  CCNxMetaMessage *ccnxMetaMessage, PARCBitVector *linkVector)
+{
+    PARCBitVector *resultVector = parcBitVector_Create();
+
+    _AthenaFanoutJob *job = parcMemory_AllocateAndClear(sizeof(_AthenaFanoutJob));
+    assertNotNull(job, "Could not allocate a fan-out");
+    job->links = parcMemory_Allocate(sizeof(AthenaTransportLink *) * parcBitVector_NumberOfBitsSet(linkVector));
+    assertNotNull(job->links, "Could not allocate fan-out links");
+
+    int linkId = 0;
+    while ((linkId = parcBitVector_NextBitSet(linkVector, linkId)) >= 0) {
+        AthenaTransportLink *athenaTransportLink = athenaTransportLinkAdapter_AcquireLink(adapter, linkId);
+        if (athenaTransportLink) {
+            if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Send) {
+                job->links[job->numLinks++] = athenaTransportLink;
+                parcBitVector_Set(resultVector, linkId);
+            } else {
+                athenaTransportLink_Release(&athenaTransportLink);
+            }
+        }
+        linkId++;
+    }
+
+    if (job->numLinks == 0) {
+        parcMemory_Deallocate(&job->links);
+        parcMemory_Deallocate(&job);
+        return resultVector;
+    }
+
+    job->ccnxMetaMessage = ccnxMetaMessage_Acquire(ccnxMetaMessage);
+    job->remainingLinks = job->numLinks;
+    job->startMicros = _nowInMicros();
+
+    pthread_mutex_lock(&fanout->mutex);
+    if (fanout->lastJob) {
+        fanout->lastJob->next = job;
+    } else {
+        fanout->jobs = job;
+    }
+    fanout->lastJob = job;
+    if (job->numLinks > AthenaFanoutChunkSize) {
+        pthread_cond_broadcast(&fanout->work);
+    } else {
+        pthread_cond_signal(&fanout->work);
+    }
+    pthread_mutex_unlock(&fanout->mutex);
+
+    return resultVector;
+}
+
+void
+athenaFanout_GetStats(const AthenaFanout *fanout, AthenaFanoutStats *stats)
+{
+    stats->numFanouts = athenaStats_Get(fanout->stats, _AthenaFanoutCounter_Fanouts);
+    stats->numLinks = athenaStats_Get(fanout->stats, _AthenaFanoutCounter_Links);
+    stats->numSendsFailed = athenaStats_Get(fanout->stats, _AthenaFanoutCounter_SendsFailed);
+    stats->totalLatencyMicros = athenaStats_Get(fanout->stats, _AthenaFanoutCounter_LatencyMicros);
+    stats->maxLatencyMicros = __atomic_load_n(&fanout->maxLatencyMicros, __ATOMIC_ACQUIRE);
+    athenaStats_GetHistogram(fanout->stats, _AthenaFanoutHistogram_Latency, stats->latencyHistogram);
+}
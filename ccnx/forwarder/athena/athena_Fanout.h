@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Fanout_h
+#define libathena_Fanout_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <parc/algol/parc_BitVector.h>
+#include <parc/logging/parc_Log.h>
+
+#include <ccnx/forwarder/athena/athena_TransportLinkAdapter.h>
+
+//
+// Parallel fan-out
+//
+// A Content Object satisfying a PIT entry that aggregated Interests from many links has to be sent
+// to every one of them.  Rather than the forwarder making each of those sends in turn, a fan-out
+// hands the message and a reference to each of its egress links to a pool of worker threads.  The
+// links are split into chunks of AthenaFanoutChunkSize, and whichever worker is idle claims the next
+// chunk of the oldest fan-out, so a large fan-out is spread over every idle worker while the
+// forwarder goes on to the next message.  The message is acquired, not copied, so every worker
+// sends the same encoded wire buffer, which is released by the worker completing the last chunk.
+//
+// A link's send method is only ever run by one thread at a time, see athenaTransportLink_Send; a
+// worker finding the forwarder sending on a link queues the message for it instead.
+//
+// The latency of each fan-out, from being handed to the workers until its last link is sent to, is
+// counted in a histogram with the bounds given by AthenaFanoutLatencyBucketMicros.
+//
+
+#define AthenaFanoutDefaultThreshold 64         // fewest links a Content Object is fanned out to in parallel
+#define AthenaFanoutChunkSize 16                // links sent to by a worker for each chunk it claims
+#define AthenaFanoutLatencyBuckets 4            // fan-out latency histogram buckets
+#define AthenaFanoutLatencyBucketMicros { 100, 1000, 10000, UINT64_MAX }
+
+/**
+ * @typedef AthenaFanoutStats
+ * @brief Counts of fan-outs handed to the workers, all of which have completed
+ */
+typedef struct athena_fanout_stats {
+    uint64_t numFanouts;                          // fan-outs completed
+    uint64_t numLinks;                            // links sent to by them
+    uint64_t numSendsFailed;                      // of those, sends that failed
+    uint64_t totalLatencyMicros;                  // sum of fan-out latencies
+    uint64_t maxLatencyMicros;                    // longest fan-out latency
+    uint64_t latencyHistogram[AthenaFanoutLatencyBuckets]; // fan-outs completed within each bucket bound
+} AthenaFanoutStats;
+
+struct athena_fanout;
+typedef struct athena_fanout AthenaFanout;
+
+/**
+ * @abstract start a pool of workers to send large fan-outs in parallel
+ * @discussion
+ *
+ * @param [in] numWorkers number of worker threads
+ * @param [in] threshold fewest links a message is fanned out to by the workers, see athenaFanout_GetThreshold
+ * @param [in] log to report errors to
+ * @return a new fan-out pool, or NULL if a worker thread could not be started
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaFanout *fanout = athenaFanout_Create(4, AthenaFanoutDefaultThreshold, athena->log);
+ *     athenaFanout_Release(&fanout);
+ * }
+ * @endcode
+ */
+AthenaFanout *athenaFanout_Create(size_t numWorkers, size_t threshold, PARCLog *log);
+
+/**
+ * @abstract acquire a reference to a fan-out pool
+ *
+ * @param [in] fanout instance to acquire
+ * @return the same fan-out pool
+ */
+AthenaFanout *athenaFanout_Acquire(const AthenaFanout *fanout);
+
+/**
+ * @abstract release a fan-out pool, finishing any fan-outs in progress and stopping its workers with the last reference
+ *
+ * @param [in,out] fanoutPtr pointer to the fan-out pool to release, set to NULL
+ */
+void athenaFanout_Release(AthenaFanout **fanoutPtr);
+
+/**
+ * @abstract the fewest egress links a message needs to be worth fanning out in parallel
+ *
+ * @param [in] fanout fan-out pool
+ * @return link count threshold
+ *
+ * Example:
+ * @code
+ * {
+ *     if (parcBitVector_NumberOfBitsSet(egressVector) >= athenaFanout_GetThreshold(fanout)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+size_t athenaFanout_GetThreshold(const AthenaFanout *fanout);
+
+/**
+ * @abstract hand a Content Object to the workers to send on a set of links
+ * @discussion
+ *
+ * Called by the thread owning the link adapter, which returns as soon as the links have been
+ * queued.  Links that are not open or not accepting sends are skipped, as by
+ * athenaTransportLinkAdapter_Send.  Interests should be sent with athenaTransportLinkAdapter_Send,
+ * which applies hop limits.
+ *
+ * @param [in] fanout fan-out pool
+ * @param [in] adapter link adapter owning the links
+ * @param [in] ccnxMetaMessage encoded message to send, acquired until sent on every link
+ * @param [in] linkVector links to send the message on
+ * @return vector of the links the message was handed to the workers for
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBitVector *result = athenaFanout_Send(fanout, athena->athenaTransportLinkAdapter, contentObject, egressVector);
+ *     parcBitVector_Release(&result);
+ * }
+ * @endcode
+ */
+PARCBitVector *athenaFanout_Send(AthenaFanout *fanout, AthenaTransportLinkAdapter *adapter,
+                                 CCNxMetaMessage *ccnxMetaMessage, PARCBitVector *linkVector);
+
+/**
+ * @abstract read the counts of completed fan-outs
+ *
+ * @param [in] fanout fan-out pool
+ * @param [out] stats filled in with the counts
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaFanoutStats stats;
+ *     athenaFanout_GetStats(fanout, &stats);
+ * }
+ * @endcode
+ */
+void athenaFanout_GetStats(const AthenaFanout *fanout, AthenaFanoutStats *stats);
+
+#endif // libathena_Fanout_h
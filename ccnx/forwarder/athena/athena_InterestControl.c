@@ -35,6 +35,7 @@
 #include <config.h>
 
 #include <errno.h>
+#include <inttypes.h>
 #include <pthread.h>
 #include <sys/param.h>
 #include <stdio.h>
@@ -45,13 +46,16 @@
 #include "athena_PIT.h"
 #include "athena_FIB.h"
 #include "athena_ContentStore.h"
+#include "athena_ShardedContentStore.h"
 #include "athena_TransportLinkAdapter.h"
+#include "athena_LogReporterAsync.h"
 
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_JSON.h>
 
 #include <ccnx/common/ccnx_InterestReturn.h>
 #include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
 
 #include <ccnx/api/control/controlPlaneInterface.h>
 
@@ -106,13 +110,84 @@ _create_stats_response(Athena *athena, CCNxName *ccnxName)
     parcJSON_AddString(json, "moduleName", athenaAbout_Name());
     parcJSON_AddInteger(json, "time", nowInMillis);
     parcJSON_AddInteger(json, "numProcessedInterests",
-                        athena->stats.numProcessedInterests);
+                        athenaStats_Get(athena->stats, AthenaCounter_ProcessedInterests));
     parcJSON_AddInteger(json, "numProcessedContentObjects",
-                        athena->stats.numProcessedContentObjects);
+                        athenaStats_Get(athena->stats, AthenaCounter_ProcessedContentObjects));
     parcJSON_AddInteger(json, "numProcessedControlMessages",
-                        athena->stats.numProcessedControlMessages);
+                        athenaStats_Get(athena->stats, AthenaCounter_ProcessedControlMessages));
     parcJSON_AddInteger(json, "numProcessedInterestReturns",
-                        athena->stats.numProcessedInterestReturns);
+                        athenaStats_Get(athena->stats, AthenaCounter_ProcessedInterestReturns));
+    parcJSON_AddInteger(json, "numRefreshedContentObjects",
+                        athenaStats_Get(athena->stats, AthenaCounter_RefreshedContentObjects));
+    parcJSON_AddInteger(json, "numSweptEntries",
+                        athenaStats_Get(athena->stats, AthenaCounter_SweptEntries));
+    parcJSON_AddInteger(json, "numPurgedEntries",
+                        athenaStats_Get(athena->stats, AthenaCounter_PurgedEntries));
+    parcJSON_AddInteger(json, "numPurgedBytes",
+                        athenaStats_Get(athena->stats, AthenaCounter_PurgedBytes));
+    parcJSON_AddInteger(json, "numConfigReloads",
+                        athenaStats_Get(athena->stats, AthenaCounter_ConfigReloads));
+    parcJSON_AddInteger(json, "numRouteFeedChanges",
+                        athenaStats_Get(athena->stats, AthenaCounter_RouteFeedChanges));
+    parcJSON_AddInteger(json, "numAggregatedRoutes",
+                        athenaFIB_GetNumberOfAggregatedRoutes(athena->athenaFIB));
+    parcJSON_AddInteger(json, "numRouteLeases",
+                        athenaFIB_GetNumberOfLeases(athena->athenaFIB));
+    parcJSON_AddInteger(json, "numExpiredRouteLeases",
+                        athenaStats_Get(athena->stats, AthenaCounter_ExpiredRouteLeases));
+    parcJSON_AddInteger(json, "numPushedContentObjects",
+                        athenaStats_Get(athena->stats, AthenaCounter_PushedContentObjects));
+    parcJSON_AddInteger(json, "numPushedBytes",
+                        athenaStats_Get(athena->stats, AthenaCounter_PushedBytes));
+    parcJSON_AddInteger(json, "numUnsolicitedContentObjects",
+                        athenaStats_Get(athena->stats, AthenaCounter_UnsolicitedContentObjects));
+    if (athenaFIB_GetNumberOfLeases(athena->athenaFIB) > 0) {
+        PARCJSONArray *leaseCounts = athenaFIB_CreateLeaseCounts(athena->athenaFIB);
+        parcJSON_AddArray(json, "routeLeases", leaseCounts);
+        parcJSONArray_Release(&leaseCounts);
+    }
+
+    AthenaTransportLinkAdapterStats linkStats;
+    athenaTransportLinkAdapter_GetStats(athena->athenaTransportLinkAdapter, &linkStats);
+    parcJSON_AddInteger(json, "numLinkMessagesReceived", linkStats.messageReceived);
+    parcJSON_AddInteger(json, "numLinkMessagesSent", linkStats.messageSent);
+    parcJSON_AddInteger(json, "numLinkMessagesDequeued", linkStats.messageSend_Dequeued);
+    parcJSON_AddInteger(json, "numLinkSendsFailed", linkStats.messageSend_LinkSendFailed);
+    parcJSON_AddInteger(json, "numLinkSendsHopLimitExceeded", linkStats.messageSend_HopLimitExceeded);
+
+    if (athena->fanout) {
+        AthenaFanoutStats fanoutStats;
+        athenaFanout_GetStats(athena->fanout, &fanoutStats);
+        parcJSON_AddInteger(json, "numParallelFanouts", fanoutStats.numFanouts);
+        parcJSON_AddInteger(json, "numParallelFanoutLinks", fanoutStats.numLinks);
+        parcJSON_AddInteger(json, "numParallelFanoutSendsFailed", fanoutStats.numSendsFailed);
+        parcJSON_AddInteger(json, "fanoutLatencyTotalMicros", fanoutStats.totalLatencyMicros);
+        parcJSON_AddInteger(json, "fanoutLatencyMaxMicros", fanoutStats.maxLatencyMicros);
+        PARCJSONArray *histogram = parcJSONArray_Create();
+        for (int bucket = 0; bucket < AthenaFanoutLatencyBuckets; bucket++) {
+            PARCJSONValue *count = parcJSONValue_CreateFromInteger(fanoutStats.latencyHistogram[bucket]);
+            parcJSONArray_AddValue(histogram, count);
+            parcJSONValue_Release(&count);
+        }
+        parcJSON_AddArray(json, "fanoutLatencyHistogram", histogram);
+        parcJSONArray_Release(&histogram);
+    }
+    if (athena->warm) {
+        AthenaWarmStats warmStats;
+        athenaWarm_GetStats(athena->warm, &warmStats);
+        parcJSON_AddString(json, "warmList", athenaWarm_GetListPath(athena->warm));
+        parcJSON_AddInteger(json, "numWarmIssued", warmStats.numIssued);
+        parcJSON_AddInteger(json, "numWarmHits", warmStats.numHits);
+        parcJSON_AddInteger(json, "numWarmMisses", warmStats.numMisses);
+        parcJSON_AddInteger(json, "numWarmFetched", warmStats.numFetched);
+        parcJSON_AddInteger(json, "numWarmBytesFetched", warmStats.bytesFetched);
+        parcJSON_AddInteger(json, "numWarmPending", warmStats.numPending);
+        parcJSON_AddInteger(json, "numWarmNoRoute", warmStats.numNoRoute);
+    }
+    if (athena->logReporter) {
+        parcJSON_AddInteger(json, "numDroppedLogMessages",
+                            athenaLogReporterAsync_GetDroppedCount(athena->logReporter));
+    }
 
     char *jsonString = parcJSON_ToString(json);
 
@@ -189,62 +264,304 @@ _Control_Command_Set(Athena *athena, CCNxName *ccnxName, const char *command)
 static CCNxMetaMessage *
 _Control_Command_Quit(Athena *athena, CCNxName *ccnxName, const char *command)
 {
-    athena->athenaState = Athena_Exit;
+    // The forwarder engine drains once this command's response has been sent
+    athena->athenaState = Athena_Draining;
     return _create_response(athena, ccnxName, "Athena exiting ...");
 }
 
+/**
+ * Only links on this host may drain the forwarder, and the snapshot file can't be named by the
+ * command as that would let a peer have the forwarder overwrite any file it can write to.
+ */
+static CCNxMetaMessage *
+_Control_Command_Drain(Athena *athena, CCNxName *ccnxName, const char *command, const char *arguments, PARCBitVector *ingressVector)
+{
+    int linkId = (ingressVector != NULL) ? parcBitVector_NextBitSet(ingressVector, 0) : -1;
+    if (athenaTransportLinkAdapter_IsNotLocal(athena->athenaTransportLinkAdapter, linkId)) {
+        return _create_response(athena, ccnxName, "The %s command is only accepted from local links", command);
+    }
+    if (arguments != NULL) {
+        return _create_response(athena, ccnxName, "The %s command takes no arguments, the snapshot file is set with --drain-snapshot", command);
+    }
+    athena->athenaState = Athena_Draining;
+    if (athena->drainSnapshotPath == NULL) {
+        return _create_response(athena, ccnxName, "Athena draining and exiting ...");
+    }
+    return _create_response(athena, ccnxName, "Athena draining and exiting, content store saved to %s ...", athena->drainSnapshotPath);
+}
+
 static CCNxMetaMessage *
 _Control_Command_Stats(Athena *athena, CCNxName *ccnxName, const char *command)
 {
     return _create_stats_response(athena, ccnxName);
 }
 
-static void *
-_start_forwarder_instance(void *arg)
+static CCNxMetaMessage *
+_Control_Command_Reload(Athena *athena, CCNxName *ccnxName, const char *command, const char *configPath)
+{
+    if ((configPath == NULL) && (athena->configPath == NULL)) {
+        return _create_response(athena, ccnxName, "No configuration file given to %s command", command);
+    }
+
+    AthenaConfigChanges changes;
+    if (athena_Reload(athena, configPath, &changes) == false) {
+        return _create_response(athena, ccnxName, "reload of %s failed, running configuration left in place",
+                                configPath ? configPath : athena->configPath);
+    }
+    return _create_response(athena, ccnxName,
+                            "reloaded %s: links %zu added %zu changed %zu removed, routes %zu added %zu removed, %zu policies changed",
+                            athena->configPath, changes.linksAdded, changes.linksChanged, changes.linksRemoved,
+                            changes.routesAdded, changes.routesRemoved, changes.policiesChanged);
+}
+
+/*
+ * The FIB's cached snapshot and a copy of the link table, which is bounded by the descriptors the
+ * forwarder has open, are complete at once.  The PIT and content store snapshots start out empty
+ * and are filled by a walk of the table, a slice at a time.
+ */
+static AthenaSnapshot *
+_create_table_snapshot(Athena *athena, const char *table, AthenaPITWalk **pitWalk, AthenaContentStoreWalk **storeWalk)
+{
+    AthenaSnapshot *snapshot = NULL;
+
+    if (strcasecmp(table, AthenaDump_FIB) == 0) {
+        snapshot = athenaFIB_AcquireSnapshot(athena->athenaFIB);
+    } else if (strcasecmp(table, AthenaDump_PIT) == 0) {
+        snapshot = athenaSnapshot_CreatePartial(AthenaDump_PIT, athenaPIT_GetNumberOfTableEntries(athena->athenaPIT));
+        *pitWalk = athenaPIT_StartSnapshot(athena->athenaPIT);
+    } else if (strcasecmp(table, AthenaDump_ContentStore) == 0) {
+        *storeWalk = athenaContentStore_StartSnapshot(athena->athenaContentStore);
+        if (*storeWalk != NULL) {
+            snapshot = athenaSnapshot_CreatePartial(AthenaDump_ContentStore, 0);
+        } else {
+            snapshot = athenaContentStore_CreateSnapshot(athena->athenaContentStore);
+        }
+    } else if (strcasecmp(table, AthenaDump_Links) == 0) {
+        snapshot = athenaTransportLinkAdapter_CreateSnapshot(athena->athenaTransportLinkAdapter);
+    }
+
+    return snapshot;
+}
+
+static int
+_findDump(Athena *athena, const char *dumpId)
+{
+    for (int i = 0; i < AthenaDumpsOutstanding; i++) {
+        if ((athena->dumps[i].dumpId != NULL) && (strcmp(athena->dumps[i].dumpId, dumpId) == 0)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void
+_stopDumpWalk(Athena *athena, int slot)
 {
-    void *res = athena_ForwarderEngine(arg);
-    pthread_detach(pthread_self());
-    return res;
+    if (athena->dumps[slot].pitWalk != NULL) {
+        athenaPIT_StopSnapshot(&athena->dumps[slot].pitWalk);
+    }
+    if (athena->dumps[slot].storeWalk != NULL) {
+        athenaContentStore_StopSnapshot(athena->dumps[slot].store, &athena->dumps[slot].storeWalk);
+        athenaContentStore_Release(&athena->dumps[slot].store);
+    }
+}
+
+static void
+_releaseDump(Athena *athena, int slot)
+{
+    if (athena->dumps[slot].dumpId != NULL) {
+        _stopDumpWalk(athena, slot);
+        parcMemory_Deallocate(&athena->dumps[slot].dumpId);
+        athenaSnapshot_Release(&athena->dumps[slot].snapshot);
+    }
 }
 
+/*
+ * Walk at most maxEntries more of a dump's table into its snapshot, completing the snapshot at the
+ * end of the table.  The walk of a content store is continued on the store it was started on, even
+ * if the forwarder has since been given another.
+ */
+static void
+_continueDump(Athena *athena, int slot, size_t maxEntries)
+{
+    bool more = false;
+    if (athena->dumps[slot].pitWalk != NULL) {
+        more = athenaPIT_ContinueSnapshot(athena->athenaPIT, athena->dumps[slot].pitWalk,
+                                          athena->dumps[slot].snapshot, maxEntries);
+    } else if (athena->dumps[slot].storeWalk != NULL) {
+        more = athenaContentStore_ContinueSnapshot(athena->dumps[slot].store, athena->dumps[slot].storeWalk,
+                                                   athena->dumps[slot].snapshot, maxEntries);
+    }
+
+    if (!more) {
+        _stopDumpWalk(athena, slot);
+        athenaSnapshot_SetComplete(athena->dumps[slot].snapshot);
+    }
+}
+
+bool
+athenaInterestControl_ContinueDumps(Athena *athena)
+{
+    bool result = false;
+    for (int i = 0; i < AthenaDumpsOutstanding; i++) {
+        if ((athena->dumps[i].dumpId != NULL) && !athenaSnapshot_IsComplete(athena->dumps[i].snapshot)) {
+            _continueDump(athena, i, AthenaDumpEntriesPerSlice);
+            result |= !athenaSnapshot_IsComplete(athena->dumps[i].snapshot);
+        }
+    }
+    return result;
+}
+
+void
+athenaInterestControl_ReleaseDumps(Athena *athena)
+{
+    for (int i = 0; i < AthenaDumpsOutstanding; i++) {
+        _releaseDump(athena, i);
+    }
+}
+
+/*
+ * A free slot, or the one least recently dumped from, whose client has most likely given up on it.
+ */
+static int
+_allocateDump(Athena *athena)
+{
+    int result = 0;
+    for (int i = 0; i < AthenaDumpsOutstanding; i++) {
+        if (athena->dumps[i].dumpId == NULL) {
+            return i;
+        }
+        if (athena->dumps[i].lastUsed < athena->dumps[result].lastUsed) {
+            result = i;
+        }
+    }
+    parcLog_Info(athena->log, "Abandoning dump %s to start another", athena->dumps[result].dumpId);
+    _releaseDump(athena, result);
+    return result;
+}
+
+/*
+ * Dump <table>/<dump id>[/chunk=<n>]
+ *
+ * A snapshot of the table is started when chunk 0 of a dump is asked for and every chunk of that
+ * dump is rendered from it, while each response only costs the forwarder the rendering of a single
+ * chunk.  The PIT and content store are not copied in one go: their snapshots are filled by walks
+ * that athenaInterestControl_ContinueDumps resumes between messages, and a chunk asked for before
+ * the walk has reached it advances the walk by at most that chunk.  Entries changed while a walk
+ * is in progress are reported as the walk finds them, so only the FIB and link dumps describe a
+ * single point in time.  The client names each dump, so that dumps by several clients don't mix,
+ * and a later chunk of a dump whose snapshot is gone is refused rather than rendered from another.
+ */
 static CCNxMetaMessage *
-_Control_Command_Spawn(Athena *athena, CCNxName *ccnxName, const char *command, const char *connectionSpecification)
+_Control_Command_Dump(Athena *athena, CCNxName *ccnxName, const char *command)
 {
-    CCNxMetaMessage *responseMessage;
+    size_t idSegment = AthenaCommandSegment + 2;
+    if ((ccnxName_GetSegmentCount(ccnxName) <= idSegment) ||
+        (ccnxNameSegment_GetType(ccnxName_GetSegment(ccnxName, idSegment)) == CCNxNameLabelType_CHUNK)) {
+        return _create_response(athena, ccnxName, "Athena dump requires a table <%s|%s|%s|%s> and a dump id",
+                                AthenaDump_FIB, AthenaDump_PIT, AthenaDump_ContentStore, AthenaDump_Links);
+    }
 
-    // Create a new athena instance
-    Athena *newAthena = athena_Create(AthenaDefaultContentStoreSize);
-    if (newAthena == NULL) {
-        responseMessage = _create_response(athena, ccnxName, "Could not create a new Athena instance");
-        return responseMessage;
+    uint64_t chunkNumber = 0;
+    CCNxNameSegment *lastSegment = ccnxName_GetSegment(ccnxName, ccnxName_GetSegmentCount(ccnxName) - 1);
+    if (ccnxNameSegment_GetType(lastSegment) == CCNxNameLabelType_CHUNK) {
+        chunkNumber = ccnxNameSegmentNumber_Value(lastSegment);
     }
 
-    // Add the specified link
-    PARCURI *connectionURI = parcURI_Parse(connectionSpecification);
-    if (athenaTransportLinkAdapter_Open(newAthena->athenaTransportLinkAdapter, connectionURI) == NULL) {
-        parcLog_Error(athena->log, "Unable to configure an interface.  Exiting...");
-        responseMessage = _create_response(athena, ccnxName, "Unable to configure an Athena interface for thread");
-        parcURI_Release(&connectionURI);
-        athena_Release(&newAthena);
-        return responseMessage;
+    CCNxMetaMessage *responseMessage = NULL;
+    char *table = ccnxNameSegment_ToString(ccnxName_GetSegment(ccnxName, AthenaCommandSegment + 1));
+    char *dumpId = ccnxNameSegment_ToString(ccnxName_GetSegment(ccnxName, idSegment));
+
+    int slot = -1;
+    if (strlen(dumpId) > AthenaDumpIdMaxLength) {
+        responseMessage = _create_response(athena, ccnxName, "Athena dump id longer than %d characters", AthenaDumpIdMaxLength);
+    } else if ((slot = _findDump(athena, dumpId)) >= 0) {
+        if (strcasecmp(athenaSnapshot_GetTableName(athena->dumps[slot].snapshot), table) != 0) {
+            responseMessage = _create_response(athena, ccnxName, "Athena dump %s is of table %s, not %s", dumpId,
+                                               athenaSnapshot_GetTableName(athena->dumps[slot].snapshot), table);
+        }
+    } else if (chunkNumber > 0) {
+        responseMessage = _create_response(athena, ccnxName, "Athena dump %s has no snapshot, restart it from chunk 0", dumpId);
+    } else {
+        AthenaPITWalk *pitWalk = NULL;
+        AthenaContentStoreWalk *storeWalk = NULL;
+        AthenaSnapshot *snapshot = _create_table_snapshot(athena, table, &pitWalk, &storeWalk);
+        if (snapshot == NULL) {
+            responseMessage = _create_response(athena, ccnxName, "Athena unknown dump table (%s)", table);
+        } else {
+            slot = _allocateDump(athena);
+            athena->dumps[slot].dumpId = parcMemory_StringDuplicate(dumpId, strlen(dumpId));
+            athena->dumps[slot].snapshot = snapshot;
+            athena->dumps[slot].pitWalk = pitWalk;
+            athena->dumps[slot].storeWalk = storeWalk;
+            if (storeWalk != NULL) {
+                athena->dumps[slot].store = athenaContentStore_Acquire(athena->athenaContentStore);
+            }
+        }
     }
-    parcURI_Release(&connectionURI);
 
-    pthread_t thread;
-    // Passing in a reference that will be released by the new thread as the thread may not
-    // have time to acquire a reference itself before we release our reference.
-    if (pthread_create(&thread, NULL, _start_forwarder_instance, (void *) athena_Acquire(newAthena)) != 0) {
-        responseMessage = _create_response(athena, ccnxName, "Athena process thread creation failed");
+    // Walk no further than the chunk asked for, which must follow the entries walked so far
+    if ((responseMessage == NULL) && !athenaSnapshot_IsComplete(athena->dumps[slot].snapshot)) {
+        size_t numWalked = athenaSnapshot_GetSize(athena->dumps[slot].snapshot);
+        if (chunkNumber > (numWalked / AthenaDumpEntriesPerChunk)) {
+            responseMessage = _create_response(athena, ccnxName, "Athena dump %s has not reached chunk %" PRIu64 " yet",
+                                               dumpId, chunkNumber);
+        } else if (numWalked < ((chunkNumber + 1) * AthenaDumpEntriesPerChunk)) {
+            _continueDump(athena, slot, ((chunkNumber + 1) * AthenaDumpEntriesPerChunk) - numWalked);
+        }
+    }
+    parcMemory_Deallocate(&dumpId);
+    parcMemory_Deallocate(&table);
+
+    if (responseMessage != NULL) {
         return responseMessage;
     }
-    athena_Release(&newAthena);
 
-    responseMessage = _create_response(athena, ccnxName, "Athena process thread started on %s", connectionSpecification);
-    return responseMessage;
+    AthenaSnapshot *snapshot = athena->dumps[slot].snapshot;
+    athena->dumps[slot].lastUsed = ++athena->dumpSequence;
+
+    PARCJSON *json = athenaSnapshot_CreateChunk(snapshot, chunkNumber, AthenaDumpEntriesPerChunk);
+
+    // Let go of the snapshot once its last chunk has been rendered
+    if (athenaSnapshot_IsComplete(snapshot) &&
+        ((chunkNumber + 1) >= athenaSnapshot_GetNumberOfChunks(snapshot, AthenaDumpEntriesPerChunk))) {
+        _releaseDump(athena, slot);
+    }
+
+    char *jsonString = parcJSON_ToString(json);
+    parcJSON_Release(&json);
+
+    PARCBuffer *payload = parcBuffer_CreateFromArray(jsonString, strlen(jsonString));
+    parcMemory_Deallocate(&jsonString);
+
+    CCNxContentObject *contentObject =
+        ccnxContentObject_CreateWithDataPayload(ccnxName, parcBuffer_Flip(payload));
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t nowInMillis = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+    ccnxContentObject_SetExpiryTime(contentObject, nowInMillis + 100); // this response is good for 100 millis
+
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromContentObject(contentObject);
+
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+
+    athena_EncodeMessage(result);
+    return result;
+}
+
+static CCNxMetaMessage *
+_Control_Command_Spawn(Athena *athena, CCNxName *ccnxName, const char *command, const char *connectionSpecification)
+{
+    if (athena_Spawn(athena, connectionSpecification) == false) {
+        return _create_response(athena, ccnxName, "Unable to start an Athena instance on %s", connectionSpecification);
+    }
+    return _create_response(athena, ccnxName, "Athena process thread started on %s", connectionSpecification);
 }
 
 static CCNxMetaMessage *
-_Control_Command(Athena *athena, CCNxInterest *interest)
+_Control_Command(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressVector)
 {
     CCNxMetaMessage *responseMessage;
     responseMessage = athenaControl_ProcessMessage(athena, interest);
@@ -275,6 +592,17 @@ _Control_Command(Athena *athena, CCNxInterest *interest)
         return responseMessage;
     }
 
+    // Drain
+    if (strncasecmp(command, AthenaCommand_Drain, strlen(AthenaCommand_Drain)) == 0) {
+        char *arguments = _get_arguments(interest);
+        responseMessage = _Control_Command_Drain(athena, ccnxName, command, arguments, ingressVector);
+        if (arguments) {
+            parcMemory_Deallocate(&arguments);
+        }
+        parcMemory_Deallocate(&command);
+        return responseMessage;
+    }
+
     // Stats
     if (strncasecmp(command, AthenaCommand_Stats, strlen(AthenaCommand_Stats)) == 0) {
         responseMessage = _Control_Command_Stats(athena, ccnxName, command);
@@ -282,6 +610,24 @@ _Control_Command(Athena *athena, CCNxInterest *interest)
         return responseMessage;
     }
 
+    // Dump <table>
+    if (strncasecmp(command, AthenaCommand_Dump, strlen(AthenaCommand_Dump)) == 0) {
+        responseMessage = _Control_Command_Dump(athena, ccnxName, command);
+        parcMemory_Deallocate(&command);
+        return responseMessage;
+    }
+
+    // Reload [<configuration file>]
+    if (strncasecmp(command, AthenaCommand_Reload, strlen(AthenaCommand_Reload)) == 0) {
+        char *configPath = _get_arguments(interest);
+        responseMessage = _Control_Command_Reload(athena, ccnxName, command, configPath);
+        if (configPath) {
+            parcMemory_Deallocate(&configPath);
+        }
+        parcMemory_Deallocate(&command);
+        return responseMessage;
+    }
+
     // Spawn
     if (strncasecmp(command, AthenaCommand_Run, strlen(AthenaCommand_Run)) == 0) {
         const char *connectionSpecification = _get_arguments(interest);
@@ -324,6 +670,108 @@ _PIT_Command(Athena *athena, CCNxInterest *interest)
     return responseMessage;
 }
 
+static CCNxMetaMessage *
+_ContentStore_Command_Purge(Athena *athena, CCNxName *ccnxName, const char *command, const char *arguments)
+{
+    if (arguments == NULL) {
+        return _create_response(athena, ccnxName, "No prefix argument given to %s command", command);
+    }
+
+    if (athena->purge.prefix) {
+        const char *pending = ccnxName_ToString(athena->purge.prefix);
+        CCNxMetaMessage *responseMessage =
+            _create_response(athena, ccnxName, "purge of %s in progress, %zu entries (%zu bytes) purged so far",
+                             pending, athena->purge.numEntries, athena->purge.sizeInBytes);
+        parcMemory_Deallocate(&pending);
+        return responseMessage;
+    }
+
+    CCNxName *prefix = ccnxName_CreateFromURI(arguments);
+    if (prefix == NULL) {
+        return _create_response(athena, ccnxName, "Unable to parse prefix %s", arguments);
+    }
+
+    // Run the first slice now, anything left is purged by the forwarder loop between messages
+    athena->purge.prefix = prefix;
+    athena->purge.numEntries = 0;
+    athena->purge.sizeInBytes = 0;
+    if (athena_ContinuePurge(athena)) {
+        return _create_response(athena, ccnxName, "purging %s, %zu entries (%zu bytes) purged so far",
+                                arguments, athena->purge.numEntries, athena->purge.sizeInBytes);
+    }
+    return _create_response(athena, ccnxName, "purged %zu entries (%zu bytes) under %s",
+                            athena->purge.numEntries, athena->purge.sizeInBytes, arguments);
+}
+
+static CCNxMetaMessage *
+_create_warm_progress_response(Athena *athena, CCNxName *ccnxName)
+{
+    AthenaWarmStats stats;
+    athenaWarm_GetStats(athena->warm, &stats);
+    return _create_response(athena, ccnxName,
+                            "warming from %s at %zu interests per second, %" PRIu64 " names issued: %" PRIu64 " hits, %" PRIu64
+                            " misses, %" PRIu64 " fetched (%" PRIu64 " bytes), %" PRIu64 " pending, %" PRIu64 " without a route",
+                            athenaWarm_GetListPath(athena->warm), athenaWarm_GetRate(athena->warm), stats.numIssued,
+                            stats.numHits, stats.numMisses, stats.numFetched, stats.bytesFetched, stats.numPending, stats.numNoRoute);
+}
+
+static CCNxMetaMessage *
+_ContentStore_Command_Warm(Athena *athena, CCNxName *ccnxName, const char *command, const char *arguments)
+{
+    char listPath[MAXPATHLEN];
+    unsigned long interestsPerSecond = 0;
+
+    // Without arguments, or while a job is running, report on the job in progress
+    if (athena->warm) {
+        return _create_warm_progress_response(athena, ccnxName);
+    }
+    if ((arguments == NULL) || (sscanf(arguments, "%s %lu", listPath, &interestsPerSecond) < 1)) {
+        return _create_response(athena, ccnxName, "No warming job in progress");
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t nowInMillis = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+
+    athena->warm = athenaWarm_Create(listPath, interestsPerSecond, nowInMillis, athena->log);
+    if (athena->warm == NULL) {
+        return _create_response(athena, ccnxName, "Unable to open name list %s", listPath);
+    }
+
+    // Issue the first slice now, the rest are issued by the forwarder loop between messages
+    if (athena_ContinueWarm(athena)) {
+        return _create_warm_progress_response(athena, ccnxName);
+    }
+    return _create_response(athena, ccnxName, "warmed from %s, see the log for its counts", listPath);
+}
+
+static CCNxMetaMessage *
+_ContentStore_Command_Stale(Athena *athena, CCNxName *ccnxName, const char *command, const char *arguments)
+{
+    char prefix[MAXPATHLEN];
+    unsigned long long windowInMillis;
+
+    // Stale window arguments "<prefix> <milliseconds>", a window of 0 stops serving stale content under the prefix
+    if ((arguments == NULL) || (sscanf(arguments, "%s %llu", prefix, &windowInMillis) != 2)) {
+        return _create_response(athena, ccnxName, "No prefix and window arguments given to %s command", command);
+    }
+
+    CCNxName *prefixName = ccnxName_CreateFromURI(prefix);
+    if (prefixName == NULL) {
+        return _create_response(athena, ccnxName, "Unable to parse prefix %s", prefix);
+    }
+
+    CCNxMetaMessage *responseMessage;
+    if (athenaContentStore_SetStaleWindow(athena->athenaContentStore, prefixName, windowInMillis)) {
+        responseMessage = _create_response(athena, ccnxName, "stale window for %s set to %llu ms", prefix, windowInMillis);
+    } else {
+        responseMessage = _create_response(athena, ccnxName, "content store does not serve stale content");
+    }
+    ccnxName_Release(&prefixName);
+
+    return responseMessage;
+}
+
 static CCNxMetaMessage *
 _ContentStore_Command(Athena *athena, CCNxInterest *interest)
 {
@@ -338,15 +786,19 @@ _ContentStore_Command(Athena *athena, CCNxInterest *interest)
         CCNxNameSegment *nameSegment = ccnxName_GetSegment(ccnxName, AthenaCommandSegment);
         char *command = ccnxNameSegment_ToString(nameSegment);
 
-        //char *arguments = _get_arguments(interest);
-
-        //responseMessage = _create_response(athena, ccnxName, ...
+        char *arguments = _get_arguments(interest);
 
-        //parcMemory_Deallocate(&command);
-        //if (arguments) {
-        //    parcMemory_Deallocate(&arguments);
-        //}
+        if (strncasecmp(command, AthenaCommand_Purge, strlen(AthenaCommand_Purge)) == 0) {
+            responseMessage = _ContentStore_Command_Purge(athena, ccnxName, command, arguments);
+        } else if (strncasecmp(command, AthenaCommand_Stale, strlen(AthenaCommand_Stale)) == 0) {
+            responseMessage = _ContentStore_Command_Stale(athena, ccnxName, command, arguments);
+        } else if (strncasecmp(command, AthenaCommand_Warm, strlen(AthenaCommand_Warm)) == 0) {
+            responseMessage = _ContentStore_Command_Warm(athena, ccnxName, command, arguments);
+        }
 
+        if (arguments) {
+            parcMemory_Deallocate(&arguments);
+        }
         parcMemory_Deallocate(&command);
     }
     return responseMessage;
@@ -514,8 +966,8 @@ _TransportLinkAdapter_Command(Athena *athena, CCNxInterest *interest)
                     responseMessage = _create_response(athena, ccnxName, "Could not parse URI:  %s", arguments);
                     return responseMessage;
                 }
-                const char *linkName = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
                 parcURI_Release(&connectionURI);
+                const char *linkName = athena_OpenLink(athena, arguments);
                 if (linkName) {
                     responseMessage = _create_response(athena, ccnxName, "%s", linkName);
                 } else {
@@ -549,7 +1001,7 @@ athenaInterestControl(Athena *athena, CCNxInterest *interest, PARCBitVector *ing
 
     CCNxName *ccnxComponentName = ccnxName_CreateFromURI(CCNxNameAthena_Control);
     if (ccnxName_StartsWith(ccnxName, ccnxComponentName) == true) {
-        responseMessage = _Control_Command(athena, interest);
+        responseMessage = _Control_Command(athena, interest, ingressVector);
     }
     ccnxName_Release(&ccnxComponentName);
 
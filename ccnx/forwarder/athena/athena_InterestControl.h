@@ -65,4 +65,37 @@
  */
 int athenaInterestControl(Athena *athena, CCNxInterest *interest, PARCBitVector *ingressVector);
 
+/**
+ * @abstract continue taking the snapshots of dumps in progress
+ * @discussion
+ *
+ * Walks at most AthenaDumpEntriesPerSlice more entries of each PIT or content store snapshot that
+ * a dump is still taking, so that dumping a large table is spread over the forwarder loop rather
+ * than copying it while forwarding waits.  Chunks asked for before their entries have been walked
+ * advance the walk themselves.
+ *
+ * @param [in] athena forwarder context
+ * @return true if any snapshot is still being taken
+ *
+ * Example:
+ * @code
+ * {
+ *     while (athenaInterestControl_ContinueDumps(athena)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaInterestControl_ContinueDumps(Athena *athena);
+
+/**
+ * @abstract abandon every dump in progress, releasing its snapshot and stopping its table walk
+ * @discussion
+ *
+ * Called before the tables being walked are released.
+ *
+ * @param [in] athena forwarder context
+ */
+void athenaInterestControl_ReleaseDumps(Athena *athena);
+
 #endif // athena_InterestControl_h
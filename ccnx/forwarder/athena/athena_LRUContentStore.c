@@ -32,6 +32,8 @@
 
 #include <config.h>
 
+#include <time.h>
+
 #include <ccnx/forwarder/athena/athena.h>
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_DisplayIndented.h>
@@ -47,16 +49,41 @@
 
 #include <ccnx/common/ccnx_NameSegment.h>
 #include <ccnx/common/ccnx_NameSegmentNumber.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/codec/ccnxCodec_NetworkBuffer.h>
 
 #include <ccnx/forwarder/athena/athena_ContentStore.h>
 #include <ccnx/forwarder/athena/athena_LRUContentStore.h>
+#include <ccnx/forwarder/athena/athena_Compression.h>
+#include <ccnx/forwarder/athena/athena_NamePool.h>
+#include <ccnx/forwarder/athena/athena_Scratch.h>
+
+// Entries are sampled before being compressed into the cold segment, and are discarded instead if
+// the sample does not shrink to COLD_SEGMENT_MAX_RATIO percent of its size.
+#define COLD_SEGMENT_SAMPLE_SIZE 4096
+#define COLD_SEGMENT_MAX_RATIO 90
+#define COLD_SEGMENT_MIN_ENTRY_SIZE 128
+
+// Payloads smaller than this are not worth indexing for deduplication
+#define DEDUPLICATION_MIN_PAYLOAD_SIZE 256
+
+// The rate of expirations is measured over at least this interval
+#define EXPIRATION_RATE_INTERVAL_MILLIS 1000
 
+// A stale entry is refreshed again if a fresh copy hasn't replaced it within an Interest lifetime
+#define STALE_REFRESH_RETRY_MILLIS 4000
 
 typedef struct athena_lrucontentstore_entry _AthenaLRUContentStoreEntry;
+typedef struct athena_lrucontentstore_payload _AthenaLRUContentStorePayload;
+typedef struct athena_lrucontentstore_prefix _AthenaLRUContentStorePrefix;
+typedef struct athena_lrucontentstore_stalewindow _AthenaLRUContentStoreStaleWindow;
+typedef struct athena_lrucontentstore_walk _AthenaLRUContentStoreWalk;
 
 struct AthenaLRUContentStore {
     PARCClock *wallClock;
 
+    AthenaLRUContentStoreEvictionPolicy evictionPolicy;
+
     size_t maxSizeInBytes;
     size_t currentSizeInBytes;
     uint64_t numEntries;
@@ -64,21 +91,71 @@ struct AthenaLRUContentStore {
     _AthenaLRUContentStoreEntry *lruHead;  // entry that was most recently used
     _AthenaLRUContentStoreEntry *lruTail;  // entry that was least recently used
 
+    // Entries evicted from the LRU that have been compressed rather than discarded
+    size_t maxColdSizeInBytes;
+    size_t currentColdSizeInBytes;
+    size_t coldSegmentPercent;
+    uint64_t numColdEntries;
+    _AthenaLRUContentStoreEntry *coldHead; // entry that was most recently compressed
+    _AthenaLRUContentStoreEntry *coldTail; // compressed entry to be discarded next
+
+    // Every entry, hot or cold, in the order it was added, for snapshots taken a slice at a time
+    _AthenaLRUContentStoreEntry *firstAdded;
+    _AthenaLRUContentStoreEntry *lastAdded;
+    _AthenaLRUContentStoreWalk *walks;     // snapshot walks in progress
+
+    // Distinct payloads shared by entries, indexed by payload hash
+    bool deduplicatePayloads;
+    PARCHashMap *tableByPayload;
+    uint64_t numSharedPayloads;
+    size_t sharedPayloadSizeInBytes;
+    uint64_t numDeduplicatedEntries;
+    size_t deduplicatedSizeInBytes;
+
+    // A match reassembled from a deduplicated entry, held until the next match
+    CCNxContentObject *reassembledMatch;
+
+    // Entry names are interned, the index tables are keyed by interned name and restriction
+    AthenaNamePool *namePool;
+
     PARCHashMap *tableByName;
     PARCHashMap *tableByNameAndKeyId;
     PARCHashMap *tableByNameAndObjectHash;
 
+    // Prefix index, a trie of the names of the cached entries and their prefixes keyed by interned name
+    PARCHashMap *tableByPrefix;
+
+    // Windows after expiry during which content may still be served, keyed by interned name prefix
+    PARCHashMap *tableByStaleWindow;
+
     PARCSortedList *listByRecommendedCacheTime;
     PARCSortedList *listByExpiryTime;
 
+    // Expired entries kept for their stale window, ordered by the end of that window
+    PARCSortedList *listByStaleUntilTime;
+
+    // Expirations per second, measured by the sweeper over at least EXPIRATION_RATE_INTERVAL_MILLIS
+    uint64_t expirationRateTime;
+    uint64_t expirationRateCount;
+    uint64_t removedByExpirationPerSecond;
+
     struct {
         uint64_t numAdds;
         uint64_t numRemoves;
         uint64_t numMatchHits;
         uint64_t numMatchMisses;
+        uint64_t numStaleHits;
         uint64_t numRemovedByLRU;
         uint64_t numRemovedByExpiration;
         uint64_t numRemovedByRCT;
+        uint64_t numRemovedByPurge;
+        uint64_t numCompressed;
+        uint64_t numIncompressible;
+        uint64_t numDecompressed;
+        uint64_t bytesBeforeCompression;
+        uint64_t bytesAfterCompression;
+        uint64_t compressionTimeInNanos;
+        uint64_t decompressionTimeInNanos;
     } stats;
 };
 
@@ -98,24 +175,21 @@ _calculateSizeOfContentObject(const CCNxContentObject *contentObject)
 }
 
 static PARCObject *
-_createHashableKey(const CCNxName *name, const PARCBuffer *keyId, const PARCBuffer *contentObjectHash)
+_createHashableKey(const AthenaInternedName *name, const PARCBuffer *keyId, const PARCBuffer *contentObjectHash)
 {
-    PARCBufferComposer *keyComposer = parcBufferComposer_Create();
-
-    keyComposer = ccnxName_BuildString(name, keyComposer);
-
-    if (keyId != NULL) {
-        parcBufferComposer_PutBuffer(keyComposer, keyId);
-    }
+    // Each index table is keyed by at most one restriction
+    const PARCBuffer *restriction = (keyId != NULL) ? keyId : contentObjectHash;
 
-    if (contentObjectHash != NULL) {
-        parcBufferComposer_PutBuffer(keyComposer, contentObjectHash);
-    }
+    return (PARCObject *) athenaNameKey_Create(name, restriction);
+}
 
-    PARCBuffer *result = parcBufferComposer_ProduceBuffer(keyComposer);
-    parcBufferComposer_Release(&keyComposer);
+// A key for lookups alone, valid until the scratch arena is rewound, @see athenaNameKey_CreateScratch
+static PARCObject *
+_createScratchKey(const AthenaInternedName *name, const PARCBuffer *keyId, const PARCBuffer *contentObjectHash)
+{
+    const PARCBuffer *restriction = (keyId != NULL) ? keyId : contentObjectHash;
 
-    return result;
+    return (PARCObject *) athenaNameKey_CreateScratch(name, restriction);
 }
 
 
@@ -130,14 +204,29 @@ static void _athenaLRUContentStore_PurgeContentStoreEntry(AthenaLRUContentStore
 struct athena_lrucontentstore_entry {
     AthenaContentStoreInterface *storeImpl;
 
-    CCNxContentObject *contentObject;
+    CCNxContentObject *contentObject;   // NULL while the entry is in the cold segment
+    AthenaInternedName *name;
+
+    PARCBuffer *compressedWireFormat;   // Non-NULL only while the entry is in the cold segment
+    size_t wireFormatLength;
+
+    _AthenaLRUContentStorePayload *sharedPayload; // Payload bytes charged once for all entries sharing them
+    PARCBuffer *wireFormatPrefix;       // Non-NULL only if the shared payload was cut out of the wire format
+    PARCBuffer *wireFormatSuffix;
+    bool isPurged;
 
     int indexCount; // How many 'tableBy<X>' indexes does this entry appear in.
 
+    bool referenced; // Matched since the eviction hand last passed it (Clock policy only)
+
     size_t sizeInBytes;
 
     bool hasExpiryTime;
     uint64_t expiryTime;
+    uint64_t refreshRequestedTime; // When a refresh of the expired entry was last requested, 0 if never
+
+    bool isStale;                  // Moved from listByExpiryTime to listByStaleUntilTime by the sweeper
+    uint64_t staleUntilTime;
 
     bool hasRecommendedCacheTime;
     uint64_t recommendedCacheTime;
@@ -150,6 +239,13 @@ struct athena_lrucontentstore_entry {
 
     _AthenaLRUContentStoreEntry *next;
     _AthenaLRUContentStoreEntry *prev;
+
+    _AthenaLRUContentStorePrefix *prefix; // Prefix index node for the entry's name
+    _AthenaLRUContentStoreEntry *nextWithName;
+    _AthenaLRUContentStoreEntry *prevWithName;
+
+    _AthenaLRUContentStoreEntry *nextAdded; // Entry added to the store after this one
+    _AthenaLRUContentStoreEntry *prevAdded;
 };
 
 static void
@@ -157,7 +253,24 @@ _athenaLRUContentStoreEntry_Finalize(_AthenaLRUContentStoreEntry **entryPtr)
 {
     _AthenaLRUContentStoreEntry *entry = (_AthenaLRUContentStoreEntry *) *entryPtr;
     //printf("LRUContentStoreEntry being finalized.  %p\n", entry);
-    ccnxContentObject_Release(&entry->contentObject);
+    if (entry->contentObject) {
+        ccnxContentObject_Release(&entry->contentObject);
+    }
+
+    if (entry->compressedWireFormat) {
+        parcBuffer_Release(&entry->compressedWireFormat);
+    }
+
+    if (entry->sharedPayload) {
+        parcObject_Release((PARCObject **) &entry->sharedPayload);
+    }
+
+    if (entry->wireFormatPrefix) {
+        parcBuffer_Release(&entry->wireFormatPrefix);
+        parcBuffer_Release(&entry->wireFormatSuffix);
+    }
+
+    athenaInternedName_Release(&entry->name);
 
     if (entry->keyId) {
         parcBuffer_Release(&entry->keyId);
@@ -171,7 +284,7 @@ _athenaLRUContentStoreEntry_Finalize(_AthenaLRUContentStoreEntry **entryPtr)
 static void
 _athenaLRUContentStoreEntry_Display(const _AthenaLRUContentStoreEntry *entry, int indentation)
 {
-    CCNxName *name = ccnxContentObject_GetName(entry->contentObject);
+    CCNxName *name = athenaInternedName_CreateName(entry->name);
     char *nameString = ccnxName_ToString(name);
     int childIndentation = indentation + 2; //strlen("AthenaLRUContentStoreEntry");
     parcDisplayIndented_PrintLine(indentation,
@@ -189,6 +302,7 @@ _athenaLRUContentStoreEntry_Display(const _AthenaLRUContentStoreEntry *entry, in
 
     parcDisplayIndented_PrintLine(childIndentation, "}");
     parcMemory_Deallocate(&nameString);
+    ccnxName_Release(&name);
 }
 
 static
@@ -210,16 +324,18 @@ parcObject_ExtendPARCObject(_AthenaLRUContentStoreEntry,
 
 
 static _AthenaLRUContentStoreEntry *
-_athenaLRUContentStoreEntry_Create(const CCNxContentObject *contentObject)
+_athenaLRUContentStoreEntry_Create(AthenaNamePool *namePool, const CCNxContentObject *contentObject)
 {
     _AthenaLRUContentStoreEntry *result = parcObject_CreateAndClearInstance(_AthenaLRUContentStoreEntry);
 
     if (result != NULL) {
         result->contentObject = ccnxContentObject_Acquire(contentObject);
+        result->name = athenaNamePool_Intern(namePool, ccnxContentObject_GetName(contentObject));
         result->next = NULL;
         result->prev = NULL;
         result->sizeInBytes = _calculateSizeOfContentObject(contentObject);
         result->hasExpiryTime = false;
+        result->isStale = false;
         result->hasRecommendedCacheTime = false;
 
         if (ccnxContentObject_HasExpiryTime(contentObject)) {
@@ -264,6 +380,16 @@ _compareByExpiryTime(_AthenaLRUContentStoreEntry *entry1, _AthenaLRUContentStore
     return result;
 }
 
+static int
+_compareByStaleUntilTime(const _AthenaLRUContentStoreEntry *entry1, const _AthenaLRUContentStoreEntry *entry2)
+{
+    int result = 0;
+    if (entry1->staleUntilTime != entry2->staleUntilTime) {
+        result = entry1->staleUntilTime < entry2->staleUntilTime ? -1 : 1;
+    }
+    return result;
+}
+
 static int
 _compareByRecommendedCacheTime(const _AthenaLRUContentStoreEntry *entry1, const _AthenaLRUContentStoreEntry *entry2)
 {
@@ -291,9 +417,87 @@ _compareByRecommendedCacheTime(const _AthenaLRUContentStoreEntry *entry1, const
 *   End AthenaLRUContentStoreEntry definition.
 ***************************************************************************************************/
 
+//
+// A payload held once on behalf of all of the entries with identical payloads.
+struct athena_lrucontentstore_payload {
+    PARCHashCode hashCode;
+    PARCBuffer *payload;    // a slice of the first entry's wire format until detached
+    bool isDetached;        // payload is a copy of its own
+    size_t sizeInBytes;
+    uint64_t numReferences; // entries in the store sharing this payload
+};
+
 static void
-_athenaLRUContentStore_RemoveContentStoreEntryFromLRU(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *storeEntry)
+_athenaLRUContentStorePayload_Finalize(_AthenaLRUContentStorePayload **payloadPtr)
+{
+    _AthenaLRUContentStorePayload *sharedPayload = *payloadPtr;
+    parcBuffer_Release(&sharedPayload->payload);
+}
+
+parcObject_ExtendPARCObject(_AthenaLRUContentStorePayload,
+                            _athenaLRUContentStorePayload_Finalize,
+                            NULL, // copy
+                            NULL, // toString
+                            NULL, // equals,
+                            NULL, // compare
+                            NULL, // hashCode
+                            NULL  // toJSON
+                            );
+
+static _AthenaLRUContentStorePayload *
+_athenaLRUContentStorePayload_Create(const PARCBuffer *payload, PARCHashCode hashCode)
+{
+    _AthenaLRUContentStorePayload *result = parcObject_CreateAndClearInstance(_AthenaLRUContentStorePayload);
+
+    if (result != NULL) {
+        result->hashCode = hashCode;
+        result->payload = parcBuffer_Slice(payload); // shares the bytes, with its own position
+        result->sizeInBytes = parcBuffer_Remaining(payload);
+        result->numReferences = 0;
+    }
+    return result;
+}
+
+/**
+ * Give a shared payload a copy of its bytes. Until then it is a slice of the wire format of the entry that
+ * brought it in, which would keep that whole wire format alive, uncounted, once the entry let go of it.
+ */
+static void
+_athenaLRUContentStorePayload_Detach(_AthenaLRUContentStorePayload *sharedPayload)
+{
+    if (sharedPayload->isDetached) {
+        return;
+    }
+    PARCBuffer *copy = parcBuffer_Allocate(sharedPayload->sizeInBytes);
+    parcBuffer_PutBuffer(copy, sharedPayload->payload);
+    parcBuffer_Flip(copy);
+
+    parcBuffer_Release(&sharedPayload->payload);
+    sharedPayload->payload = copy;
+    sharedPayload->isDetached = true;
+}
+
+static PARCBuffer *
+_createPayloadKey(PARCHashCode hashCode)
+{
+    PARCBuffer *result = parcBuffer_Allocate(sizeof(hashCode));
+    parcBuffer_PutArray(result, sizeof(hashCode), (uint8_t *) &hashCode);
+    return parcBuffer_Flip(result);
+}
+
+/**
+ * Remove an entry from whichever list (LRU or cold segment) it is in, without releasing it.
+ */
+static void
+_unlinkContentStoreEntry(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *storeEntry)
 {
+    _AthenaLRUContentStoreEntry **head = &impl->lruHead;
+    _AthenaLRUContentStoreEntry **tail = &impl->lruTail;
+    if (storeEntry->compressedWireFormat != NULL) {
+        head = &impl->coldHead;
+        tail = &impl->coldTail;
+    }
+
     if (storeEntry->next != NULL) {
         storeEntry->next->prev = storeEntry->prev;
     }
@@ -302,49 +506,358 @@ _athenaLRUContentStore_RemoveContentStoreEntryFromLRU(AthenaLRUContentStore *imp
         storeEntry->prev->next = storeEntry->next;
     }
 
-    if (impl->lruHead == storeEntry) {
-        impl->lruHead = storeEntry->prev;   // Could be NULL
+    if (*head == storeEntry) {
+        *head = storeEntry->prev;   // Could be NULL
     }
 
-    if (impl->lruTail == storeEntry) {
-        impl->lruTail = storeEntry->next;   // Could be NULL;
+    if (*tail == storeEntry) {
+        *tail = storeEntry->next;   // Could be NULL;
     }
 
+    storeEntry->next = NULL;
+    storeEntry->prev = NULL;
+}
+
+static void
+_athenaLRUContentStore_RemoveContentStoreEntryFromLRU(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *storeEntry)
+{
+    _unlinkContentStoreEntry(impl, storeEntry);
+
     _athenaLRUContentStoreEntry_Release(&storeEntry);
 }
 
+/**
+ * Drop an entry's reference to its shared payload, discarding the payload once no entry refers to it.
+ */
+static void
+_releaseSharedPayload(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *storeEntry)
+{
+    _AthenaLRUContentStorePayload *sharedPayload = storeEntry->sharedPayload;
+    if (sharedPayload == NULL) {
+        return;
+    }
+
+    if (storeEntry->wireFormatPrefix != NULL) {
+        impl->numDeduplicatedEntries--;
+        impl->deduplicatedSizeInBytes -= sharedPayload->sizeInBytes;
+    } else if (sharedPayload->numReferences > 1) {
+        // The entry whose wire format holds the payload is leaving, the entries still sharing it need a copy
+        _athenaLRUContentStorePayload_Detach(sharedPayload);
+    }
+
+    sharedPayload->numReferences--;
+    if (sharedPayload->numReferences == 0) {
+        PARCBuffer *key = _createPayloadKey(sharedPayload->hashCode);
+        parcHashMap_Remove(impl->tableByPayload, key);
+        parcBuffer_Release(&key);
+
+        impl->currentSizeInBytes -= sharedPayload->sizeInBytes;
+        impl->numSharedPayloads--;
+        impl->sharedPayloadSizeInBytes -= sharedPayload->sizeInBytes;
+    }
+
+    parcObject_Release((PARCObject **) &storeEntry->sharedPayload);
+}
+
+/**
+ * A node of the prefix index.  There is a node for the name of every cached entry and for each of
+ * its prefixes, linked to its parent and children, so that the entries under a prefix can be found
+ * without visiting the rest of the store.  A node is removed once it has neither entries nor
+ * children, every leaf of the trie therefore holds at least one entry.
+ */
+struct athena_lrucontentstore_prefix {
+    const AthenaInternedName *name;          // held by the key of the node in tableByPrefix
+    _AthenaLRUContentStorePrefix *parent;    // NULL for the empty name
+    _AthenaLRUContentStorePrefix *firstChild;
+    _AthenaLRUContentStorePrefix *nextSibling;
+    _AthenaLRUContentStorePrefix *prevSibling;
+    _AthenaLRUContentStoreEntry *firstEntry; // entries with exactly this name
+};
+
+parcObject_ExtendPARCObject(_AthenaLRUContentStorePrefix, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static _AthenaLRUContentStorePrefix *
+_getPrefix(const AthenaLRUContentStore *impl, const AthenaInternedName *name)
+{
+    PARCObject *key = _createHashableKey(name, NULL, NULL);
+    _AthenaLRUContentStorePrefix *prefix = (_AthenaLRUContentStorePrefix *) parcHashMap_Get(impl->tableByPrefix, key);
+    parcObject_Release((PARCObject **) &key);
+    return prefix;
+}
+
+static _AthenaLRUContentStorePrefix *
+_createPrefix(AthenaLRUContentStore *impl, const AthenaInternedName *name)
+{
+    _AthenaLRUContentStorePrefix *prefix = parcObject_CreateAndClearInstance(_AthenaLRUContentStorePrefix);
+    prefix->name = name;
+
+    PARCObject *key = _createHashableKey(name, NULL, NULL);
+    parcHashMap_Put(impl->tableByPrefix, key, prefix);
+    parcObject_Release((PARCObject **) &key);
+
+    _AthenaLRUContentStorePrefix *result = prefix;
+    parcObject_Release((PARCObject **) &prefix); // tableByPrefix holds the node
+    return result;
+}
+
+/**
+ * Index an entry under its name, adding nodes for the name and any of its prefixes not yet indexed.
+ */
+static void
+_addEntryToPrefixIndex(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    _AthenaLRUContentStorePrefix *prefix = _getPrefix(impl, entry->name);
+    if (prefix == NULL) {
+        prefix = _createPrefix(impl, entry->name);
+
+        _AthenaLRUContentStorePrefix *child = prefix;
+        const AthenaInternedName *parentName = athenaInternedName_GetPrefix(child->name);
+        while (parentName != NULL) {
+            _AthenaLRUContentStorePrefix *parent = _getPrefix(impl, parentName);
+            bool isNew = (parent == NULL);
+            if (isNew) {
+                parent = _createPrefix(impl, parentName);
+            }
+
+            child->parent = parent;
+            child->nextSibling = parent->firstChild;
+            if (parent->firstChild != NULL) {
+                parent->firstChild->prevSibling = child;
+            }
+            parent->firstChild = child;
+
+            if (!isNew) {
+                break; // the rest of the path is already indexed
+            }
+            child = parent;
+            parentName = athenaInternedName_GetPrefix(child->name);
+        }
+    }
+
+    entry->prefix = prefix;
+    entry->prevWithName = NULL;
+    entry->nextWithName = prefix->firstEntry;
+    if (prefix->firstEntry != NULL) {
+        prefix->firstEntry->prevWithName = entry;
+    }
+    prefix->firstEntry = entry;
+}
+
+/**
+ * Remove an entry from the prefix index, removing the nodes that no longer lead to any entry.
+ */
+static void
+_removeEntryFromPrefixIndex(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    _AthenaLRUContentStorePrefix *prefix = entry->prefix;
+    if (prefix == NULL) {
+        return;
+    }
+
+    if (entry->nextWithName != NULL) {
+        entry->nextWithName->prevWithName = entry->prevWithName;
+    }
+    if (entry->prevWithName != NULL) {
+        entry->prevWithName->nextWithName = entry->nextWithName;
+    } else {
+        prefix->firstEntry = entry->nextWithName;
+    }
+    entry->prefix = NULL;
+    entry->nextWithName = NULL;
+    entry->prevWithName = NULL;
+
+    while (prefix != NULL && prefix->firstEntry == NULL && prefix->firstChild == NULL) {
+        _AthenaLRUContentStorePrefix *parent = prefix->parent;
+        if (prefix->nextSibling != NULL) {
+            prefix->nextSibling->prevSibling = prefix->prevSibling;
+        }
+        if (prefix->prevSibling != NULL) {
+            prefix->prevSibling->nextSibling = prefix->nextSibling;
+        } else if (parent != NULL) {
+            parent->firstChild = prefix->nextSibling;
+        }
+
+        PARCObject *key = _createHashableKey(prefix->name, NULL, NULL);
+        parcHashMap_Remove(impl->tableByPrefix, key);
+        parcObject_Release((PARCObject **) &key);
+
+        prefix = parent;
+    }
+}
+
+/**
+ * How long after its expiry time content under a prefix may still be served while it is refreshed.
+ */
+struct athena_lrucontentstore_stalewindow {
+    uint64_t windowInMillis;
+};
+
+parcObject_ExtendPARCObject(_AthenaLRUContentStoreStaleWindow, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+
+/**
+ * Find the stale window of the longest configured prefix of an entry's name, returning false if there is none.
+ */
+static bool
+_getStaleWindow(const AthenaLRUContentStore *impl, const _AthenaLRUContentStoreEntry *entry, uint64_t *windowInMillis)
+{
+    if (parcHashMap_Size(impl->tableByStaleWindow) == 0) {
+        return false;
+    }
+
+    size_t scratchMark = athenaScratch_Mark();
+    for (const AthenaInternedName *name = entry->name; name != NULL; name = athenaInternedName_GetPrefix(name)) {
+        PARCObject *key = _createScratchKey(name, NULL, NULL);
+        _AthenaLRUContentStoreStaleWindow *window =
+            (_AthenaLRUContentStoreStaleWindow *) parcHashMap_Get(impl->tableByStaleWindow, key);
+        athenaScratch_Rewind(scratchMark);
+
+        if (window != NULL) {
+            *windowInMillis = window->windowInMillis;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Return true if an expired entry is within the stale window of the longest configured prefix of its name.
+ */
+static bool
+_isWithinStaleWindow(const AthenaLRUContentStore *impl, const _AthenaLRUContentStoreEntry *entry, uint64_t nowInMillis)
+{
+    uint64_t windowInMillis;
+    if (_getStaleWindow(impl, entry, &windowInMillis)) {
+        return nowInMillis <= entry->expiryTime + windowInMillis;
+    }
+    return false;
+}
+
+/**
+ * Take an entry out of the time-ordered lists, so that nothing purges it for its expiry or recommended cache time.
+ */
+static void
+_unlinkEntryFromTimeIndexes(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    if (entry->isStale) {
+        parcSortedList_Remove(impl->listByStaleUntilTime, entry);
+    } else {
+        parcSortedList_Remove(impl->listByExpiryTime, entry);
+    }
+    parcSortedList_Remove(impl->listByRecommendedCacheTime, entry);
+}
+
+/**
+ * Add an entry to the time-ordered lists, if it has an RCT or ExpiryTime.
+ */
+static void
+_linkEntryToTimeIndexes(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    if (entry->hasExpiryTime) {
+        parcSortedList_Add(entry->isStale ? impl->listByStaleUntilTime : impl->listByExpiryTime, entry);
+    }
+    if (entry->hasRecommendedCacheTime) {
+        parcSortedList_Add(impl->listByRecommendedCacheTime, entry);
+    }
+}
+
+/**
+ * A snapshot walk through the entries in the order they were added.  Entries are only ever added at the end
+ * of that order and the walk is moved past any entry removed from under it, so it needs no other reference
+ * into the store between slices.
+ */
+struct athena_lrucontentstore_walk {
+    _AthenaLRUContentStoreEntry *next; // next entry to report, NULL once the walk is done
+    _AthenaLRUContentStoreEntry *last; // entry added last when the walk started, later ones are not reported
+    _AthenaLRUContentStoreWalk *nextWalk;
+    _AthenaLRUContentStoreWalk *prevWalk;
+};
+
+static void
+_linkEntryToAddedList(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    entry->prevAdded = impl->lastAdded;
+    entry->nextAdded = NULL;
+    if (impl->lastAdded != NULL) {
+        impl->lastAdded->nextAdded = entry;
+    } else {
+        impl->firstAdded = entry;
+    }
+    impl->lastAdded = entry;
+}
+
+/**
+ * Take an entry out of the order entries were added in, first moving any walk that would visit it next, or
+ * stop at it, to its neighbours.
+ */
+static void
+_unlinkEntryFromAddedList(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    for (_AthenaLRUContentStoreWalk *walk = impl->walks; walk != NULL; walk = walk->nextWalk) {
+        if (walk->next == entry) {
+            walk->next = (walk->last == entry) ? NULL : entry->nextAdded;
+        }
+        if (walk->last == entry) {
+            // The walk has not passed the entry, so it still has the entries before it to visit
+            walk->last = (walk->next != NULL) ? entry->prevAdded : NULL;
+        }
+    }
+
+    if (entry->nextAdded != NULL) {
+        entry->nextAdded->prevAdded = entry->prevAdded;
+    }
+    if (entry->prevAdded != NULL) {
+        entry->prevAdded->nextAdded = entry->nextAdded;
+    }
+    if (impl->firstAdded == entry) {
+        impl->firstAdded = entry->nextAdded;
+    }
+    if (impl->lastAdded == entry) {
+        impl->lastAdded = entry->prevAdded;
+    }
+    entry->nextAdded = NULL;
+    entry->prevAdded = NULL;
+}
+
 static void
 _athenaLRUContentStore_PurgeContentStoreEntry(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *storeEntry)
 {
-    PARCObject *nameKey = _createHashableKey(ccnxContentObject_GetName(storeEntry->contentObject), NULL, NULL);
+    PARCObject *nameKey = _createHashableKey(storeEntry->name, NULL, NULL);
     parcHashMap_Remove(impl->tableByName, nameKey);
     parcObject_Release((PARCObject **) &nameKey);
 
     if (storeEntry->hasKeyId) {
-        PARCObject *nameAndKeyIdKey = _createHashableKey(ccnxContentObject_GetName(storeEntry->contentObject), storeEntry->keyId, NULL);
+        PARCObject *nameAndKeyIdKey = _createHashableKey(storeEntry->name, storeEntry->keyId, NULL);
         parcHashMap_Remove(impl->tableByNameAndKeyId, nameAndKeyIdKey);
         parcObject_Release((PARCObject **) &nameAndKeyIdKey);
     }
 
     if (storeEntry->hasContentObjectHash) {
-        PARCObject *nameAndContentObjectHashKey = _createHashableKey(ccnxContentObject_GetName(storeEntry->contentObject), NULL, storeEntry->contentObjectHash);
+        PARCObject *nameAndContentObjectHashKey = _createHashableKey(storeEntry->name, NULL, storeEntry->contentObjectHash);
         parcHashMap_Remove(impl->tableByNameAndObjectHash, nameAndContentObjectHashKey);
         parcObject_Release((PARCObject **) &nameAndContentObjectHashKey);
     }
 
-    parcSortedList_Remove(impl->listByExpiryTime, storeEntry);
+    _removeEntryFromPrefixIndex(impl, storeEntry);
 
-    parcSortedList_Remove(impl->listByRecommendedCacheTime, storeEntry);
+    _unlinkEntryFromTimeIndexes(impl, storeEntry);
 
     impl->currentSizeInBytes -= storeEntry->sizeInBytes;
+    if (storeEntry->compressedWireFormat != NULL) {
+        impl->currentColdSizeInBytes -= storeEntry->sizeInBytes;
+        impl->numColdEntries--;
+    }
 
+    _releaseSharedPayload(impl, storeEntry);
+
+    storeEntry->isPurged = true;
+    _unlinkEntryFromAddedList(impl, storeEntry);
     _athenaLRUContentStore_RemoveContentStoreEntryFromLRU(impl, storeEntry);
 
     impl->numEntries--;
 }
 
 /**
- * Release all of the AthenaLRUContentStoreEntry items in the store's LRU.
+ * Release all of the AthenaLRUContentStoreEntry items in the store's LRU and cold segment.
  */
 static void
 _athenaLRUContentStoreEntry_ReleaseAllInLRU(AthenaLRUContentStore *impl)
@@ -355,6 +868,13 @@ _athenaLRUContentStoreEntry_ReleaseAllInLRU(AthenaLRUContentStore *impl)
         _athenaLRUContentStoreEntry_Release(&entry);
         entry = prev;
     }
+
+    entry = impl->coldHead;
+    while (entry != NULL) {
+        _AthenaLRUContentStoreEntry *prev = entry->prev;
+        _athenaLRUContentStoreEntry_Release(&entry);
+        entry = prev;
+    }
 }
 
 
@@ -379,15 +899,34 @@ _athenaLRUContentStore_Finalize(AthenaLRUContentStore **instancePtr)
     if (impl->tableByNameAndObjectHash) {
         parcHashMap_Release(&impl->tableByNameAndObjectHash);
     }
+    if (impl->tableByPrefix) {
+        parcHashMap_Release(&impl->tableByPrefix);
+    }
+    if (impl->tableByStaleWindow) {
+        parcHashMap_Release(&impl->tableByStaleWindow);
+    }
 
     if (impl->listByExpiryTime) {
         parcSortedList_Release(&impl->listByExpiryTime);
     }
+    if (impl->listByStaleUntilTime) {
+        parcSortedList_Release(&impl->listByStaleUntilTime);
+    }
     if (impl->listByRecommendedCacheTime) {
         parcSortedList_Release(&impl->listByRecommendedCacheTime);
     }
 
+    if (impl->tableByPayload) {
+        parcHashMap_Release(&impl->tableByPayload);
+    }
+
+    if (impl->reassembledMatch) {
+        ccnxContentObject_Release(&impl->reassembledMatch);
+    }
+
     _athenaLRUContentStoreEntry_ReleaseAllInLRU(impl);
+
+    athenaNamePool_Release(&impl->namePool);
 }
 
 parcObject_ImplementAcquire(athenaLRUContentStore, AthenaLRUContentStore);
@@ -420,19 +959,44 @@ _athenaLRUContentStore_Create(AthenaContentStoreConfig *storeConfig)
         result->tableByName = parcHashMap_Create();
         result->tableByNameAndKeyId = parcHashMap_Create();
         result->tableByNameAndObjectHash = parcHashMap_Create();
+        result->tableByPrefix = parcHashMap_Create();
+        result->tableByStaleWindow = parcHashMap_Create();
+        result->tableByPayload = parcHashMap_Create();
 
         result->listByRecommendedCacheTime = parcSortedList_CreateCompare((PARCSortedListEntryCompareFunction) _compareByRecommendedCacheTime);
         result->listByExpiryTime = parcSortedList_CreateCompare((PARCSortedListEntryCompareFunction) _compareByExpiryTime);
+        result->listByStaleUntilTime = parcSortedList_CreateCompare((PARCSortedListEntryCompareFunction) _compareByStaleUntilTime);
 
         result->lruHead = NULL;
         result->lruTail = NULL;
+        result->coldHead = NULL;
+        result->coldTail = NULL;
+        result->firstAdded = NULL;
+        result->lastAdded = NULL;
+        result->walks = NULL;
 
         result->currentSizeInBytes = 0;
+        result->currentColdSizeInBytes = 0;
+        result->expirationRateTime = parcClock_GetTime(result->wallClock);
 
         if (config != NULL) {
             result->maxSizeInBytes = config->capacityInMB * (1024 * 1024); // MB to bytes
+            result->evictionPolicy = config->evictionPolicy;
+            result->coldSegmentPercent = config->coldSegmentPercent < 100 ? config->coldSegmentPercent : 100;
+            result->deduplicatePayloads = config->deduplicatePayloads;
+            if (config->namePool != NULL) {
+                result->namePool = athenaNamePool_Acquire(config->namePool);
+            }
         } else {
             result->maxSizeInBytes = 10 * (1024 * 1024); // 10 MB default
+            result->evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+            result->coldSegmentPercent = 0;
+            result->deduplicatePayloads = false;
+        }
+        result->maxColdSizeInBytes = (result->maxSizeInBytes / 100) * result->coldSegmentPercent;
+
+        if (result->namePool == NULL) {
+            result->namePool = athenaNamePool_Create();
         }
     }
 
@@ -466,6 +1030,13 @@ athenaLRUContentStore_Display(const AthenaContentStoreImplementation *store, int
         entry = entry->next;
     }
     parcDisplayIndented_PrintLine(indentation + 4, "}");
+    parcDisplayIndented_PrintLine(indentation + 4, "Cold = {");
+    entry = impl->coldTail;
+    while (entry) {
+        _athenaLRUContentStoreEntry_Display(entry, indentation + 8);
+        entry = entry->next;
+    }
+    parcDisplayIndented_PrintLine(indentation + 4, "}");
     parcDisplayIndented_PrintLine(indentation, "}");
 }
 
@@ -544,7 +1115,19 @@ _moveContentStoreEntryToLRUHead(AthenaLRUContentStore *impl, _AthenaLRUContentSt
 static _AthenaLRUContentStoreEntry *
 _getLeastUsedFromLRU(AthenaLRUContentStore *impl)
 {
-    return impl->lruTail;
+    _AthenaLRUContentStoreEntry *entry = impl->lruTail;
+
+    if (impl->evictionPolicy == AthenaLRUContentStoreEvictionPolicy_Clock) {
+        // Give entries referenced since the hand last passed them a second chance. Each bit is
+        // cleared as the entry is moved, so this visits every entry at most once.
+        while (entry != NULL && entry->referenced) {
+            entry->referenced = false;
+            _moveContentStoreEntryToLRUHead(impl, entry);
+            entry = impl->lruTail;
+        }
+    }
+
+    return entry;
 }
 
 static _AthenaLRUContentStoreEntry *
@@ -558,6 +1141,17 @@ _getEarliestExpiryTime(AthenaLRUContentStore *impl)
     return result;
 }
 
+static _AthenaLRUContentStoreEntry *
+_getEarliestStaleUntilTime(AthenaLRUContentStore *impl)
+{
+    _AthenaLRUContentStoreEntry *result = NULL;
+
+    if (parcSortedList_Size(impl->listByStaleUntilTime) > 0) {
+        result = parcSortedList_GetAtIndex(impl->listByStaleUntilTime, 0);
+    }
+    return result;
+}
+
 static _AthenaLRUContentStoreEntry *
 _getEarliestRecommendedCacheTime(AthenaLRUContentStore *impl)
 {
@@ -569,56 +1163,305 @@ _getEarliestRecommendedCacheTime(AthenaLRUContentStore *impl)
     return result;
 }
 
-static bool
-_makeRoomInStore(AthenaLRUContentStore *impl, size_t sizeNeeded)
+/**
+ * Move an expired entry that is still within its stale window from the expiry index to the stale index,
+ * ordered by the end of the window, so that it no longer sits in front of entries that can be removed.
+ */
+static void
+_parkStaleEntry(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry, uint64_t staleUntilTime)
 {
-    bool result = false;
-
-    if (sizeNeeded > impl->maxSizeInBytes) {
-        return false; // not possible.
+    if (entry->isStale) {
+        parcSortedList_Remove(impl->listByStaleUntilTime, entry);
+    } else {
+        parcSortedList_Remove(impl->listByExpiryTime, entry);
+    }
+    entry->isStale = true;
+    entry->staleUntilTime = staleUntilTime;
+    parcSortedList_Add(impl->listByStaleUntilTime, entry);
+}
+
+/**
+ * Remove an expired entry, unless it is still within the stale window of its name, in which case it is
+ * moved to the stale index until the window ends.  Returns true if the entry was removed.
+ */
+static bool
+_expireContentStoreEntry(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry, uint64_t nowInMillis)
+{
+    uint64_t windowInMillis;
+    if (_getStaleWindow(impl, entry, &windowInMillis) && (nowInMillis <= entry->expiryTime + windowInMillis)) {
+        _parkStaleEntry(impl, entry, entry->expiryTime + windowInMillis);
+        return false;
+    }
+
+    _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+    return true;
+}
+
+static uint64_t
+_elapsedNanos(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t elapsed = ((int64_t) (now.tv_sec - start->tv_sec) * 1000000000) + (now.tv_nsec - start->tv_nsec);
+    return elapsed > 0 ? (uint64_t) elapsed : 0;
+}
+
+/**
+ * Return the wire format of a content object in a single buffer, or NULL if it has never been encoded.
+ */
+static PARCBuffer *
+_acquireWireFormat(const CCNxContentObject *contentObject)
+{
+    PARCBuffer *result = ccnxWireFormatMessage_GetWireFormatBuffer((CCNxWireFormatMessage *) contentObject);
+    if (result != NULL) {
+        return parcBuffer_Acquire(result);
+    }
+
+    CCNxCodecNetworkBufferIoVec *iovec = ccnxWireFormatMessage_GetIoVec((CCNxWireFormatMessage *) contentObject);
+    if (iovec != NULL) {
+        size_t iovcnt = ccnxCodecNetworkBufferIoVec_GetCount(iovec);
+        const struct iovec *array = ccnxCodecNetworkBufferIoVec_GetArray(iovec);
+
+        size_t totalbytes = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            totalbytes += array[i].iov_len;
+        }
+        result = parcBuffer_Allocate(totalbytes);
+        for (int i = 0; i < iovcnt; i++) {
+            parcBuffer_PutArray(result, array[i].iov_len, array[i].iov_base);
+        }
+        parcBuffer_Flip(result);
+    }
+    return result;
+}
+
+static void
+_addContentStoreEntryToColdHead(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    if (impl->coldTail == NULL) {
+        impl->coldTail = entry;
+    }
+
+    entry->next = NULL;
+    entry->prev = impl->coldHead; // Could be NULL
+
+    if (impl->coldHead != NULL) {
+        impl->coldHead->next = entry;
+    }
+    impl->coldHead = entry;
+}
+
+/**
+ * Compress an entry being evicted from the LRU into the cold segment, discarding the oldest compressed
+ * entries if necessary to make room for it. Returns false, leaving the entry where it was, if the entry
+ * should be discarded instead. Its wire format is sampled first so payloads that are already compressed
+ * or encrypted cost little.
+ */
+static bool
+_moveContentStoreEntryToColdSegment(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    if (impl->maxColdSizeInBytes == 0 || entry->contentObject == NULL || entry->sizeInBytes < COLD_SEGMENT_MIN_ENTRY_SIZE) {
+        return false;
+    }
+
+    PARCBuffer *wireFormat = _acquireWireFormat(entry->contentObject);
+    if (wireFormat == NULL) {
+        return false;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    size_t wireFormatLength = parcBuffer_Limit(wireFormat);
+    const uint8_t *bytes = parcByteArray_Array(parcBuffer_Array(wireFormat)) + parcBuffer_ArrayOffset(wireFormat);
+
+    PARCBuffer *compressed = NULL;
+    if (athenaCompression_IsCompressible(bytes, wireFormatLength, COLD_SEGMENT_SAMPLE_SIZE, COLD_SEGMENT_MAX_RATIO)) {
+        // The block is only worth keeping if it is smaller than the entry it replaces.
+        uint8_t *block = parcMemory_Allocate(entry->sizeInBytes);
+        assertNotNull(block, "parcMemory_Allocate(%zu) returned NULL", entry->sizeInBytes);
+        size_t blockLength = athenaCompression_Compress(bytes, wireFormatLength, block, entry->sizeInBytes);
+        if (blockLength > 0 && blockLength < entry->sizeInBytes && blockLength <= impl->maxColdSizeInBytes) {
+            compressed = parcBuffer_Allocate(blockLength);
+            parcBuffer_PutArray(compressed, blockLength, block);
+            parcBuffer_Flip(compressed);
+        }
+        parcMemory_Deallocate(&block);
+    }
+
+    impl->stats.compressionTimeInNanos += _elapsedNanos(&start);
+    parcBuffer_Release(&wireFormat);
+
+    if (compressed == NULL) {
+        impl->stats.numIncompressible++;
+        return false;
     }
 
+    size_t blockLength = parcBuffer_Remaining(compressed);
+    while ((impl->currentColdSizeInBytes + blockLength) > impl->maxColdSizeInBytes) {
+        _athenaLRUContentStore_PurgeContentStoreEntry(impl, impl->coldTail);
+        impl->stats.numRemovedByLRU++;
+    }
+
+    // The wire format is about to be released, a payload it holds for other entries needs a copy
+    if (entry->sharedPayload != NULL) {
+        _athenaLRUContentStorePayload_Detach(entry->sharedPayload);
+    }
+
+    // Unlink while the entry is still in the LRU, then switch it to its compressed form.
+    _unlinkContentStoreEntry(impl, entry);
+    impl->currentSizeInBytes -= entry->sizeInBytes;
+    ccnxContentObject_Release(&entry->contentObject);
+
+    entry->compressedWireFormat = compressed;
+    entry->wireFormatLength = wireFormatLength;
+    entry->sizeInBytes = blockLength;
+    entry->referenced = false;
+    _addContentStoreEntryToColdHead(impl, entry);
+
+    impl->currentSizeInBytes += blockLength;
+    impl->currentColdSizeInBytes += blockLength;
+    impl->numColdEntries++;
+
+    impl->stats.numCompressed++;
+    impl->stats.bytesBeforeCompression += wireFormatLength;
+    impl->stats.bytesAfterCompression += blockLength;
+
+    return true;
+}
+
+static bool _makeRoomInStore(AthenaLRUContentStore *impl, size_t sizeNeeded);
+static bool _removePayloadFromWireFormat(_AthenaLRUContentStoreEntry *entry, _AthenaLRUContentStorePayload *sharedPayload);
+
+/**
+ * Decompress a matched entry from the cold segment and return it to the head of the LRU. Returns false
+ * if the entry could not be restored, in which case it has been removed from the store.
+ */
+static bool
+_restoreContentStoreEntryFromColdSegment(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    CCNxMetaMessage *contentObject = NULL;
+    PARCBuffer *wireFormat = parcBuffer_Allocate(entry->wireFormatLength);
+    if (athenaCompression_Decompress(parcBuffer_Overlay(entry->compressedWireFormat, 0),
+                                     parcBuffer_Remaining(entry->compressedWireFormat),
+                                     parcBuffer_Overlay(wireFormat, 0), entry->wireFormatLength)) {
+        contentObject = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+    }
+    parcBuffer_Release(&wireFormat);
+
+    impl->stats.decompressionTimeInNanos += _elapsedNanos(&start);
+
+    if (contentObject == NULL) {
+        _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+        return false;
+    }
+
+    // Take the entry out of the cold segment and the time-ordered lists while room is made for it, so
+    // it can't be chosen for eviction or purged as expired while it is being matched.
+    _unlinkContentStoreEntry(impl, entry);
+    _unlinkEntryFromTimeIndexes(impl, entry);
+    impl->currentSizeInBytes -= entry->sizeInBytes;
+    impl->currentColdSizeInBytes -= entry->sizeInBytes;
+    impl->numColdEntries--;
+    parcBuffer_Release(&entry->compressedWireFormat);
+
+    entry->contentObject = contentObject;
+    entry->sizeInBytes = 0;
+
+    // The shared payload has a copy of its own since the entry was compressed, keep only the bytes around
+    // it as the other entries sharing it do. If it can't be cut out the entry is charged for all of it.
+    size_t sizeInBytes = _calculateSizeOfContentObject(contentObject);
+    if ((entry->sharedPayload != NULL) && _removePayloadFromWireFormat(entry, entry->sharedPayload)) {
+        ccnxContentObject_Release(&entry->contentObject);
+        impl->numDeduplicatedEntries++;
+        impl->deduplicatedSizeInBytes += entry->sharedPayload->sizeInBytes;
+        sizeInBytes -= entry->sharedPayload->sizeInBytes; // already charged
+    }
+    bool isEnoughRoomInStore = _makeRoomInStore(impl, sizeInBytes);
+
+    _linkEntryToTimeIndexes(impl, entry);
+    if (isEnoughRoomInStore == false) {
+        _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+        return false;
+    }
+
+    entry->sizeInBytes = sizeInBytes;
+    impl->currentSizeInBytes += sizeInBytes;
+    _addContentStoreEntryToLRUHead(impl, entry);
+    impl->stats.numDecompressed++;
+
+    return true;
+}
+
+static bool
+_makeRoomInStore(AthenaLRUContentStore *impl, size_t sizeNeeded)
+{
+    if (sizeNeeded > impl->maxSizeInBytes) {
+        return false; // not possible.
+    }
+
+    // The store must shrink to this size to fit the new item, a sizeNeeded of 0 trims it to capacity.
+    size_t targetSizeInBytes = impl->maxSizeInBytes - sizeNeeded;
+
     uint64_t nowInMillis = parcClock_GetTime(impl->wallClock);
 
-    // Evict expired items until we have enough room, or don't have any expired items.
-    while (sizeNeeded > (impl->maxSizeInBytes - impl->currentSizeInBytes)) {
+    // Evict expired items until we have enough room, or don't have any expired items. Items that are
+    // still within a stale window may be served, so they are moved aside and left to the LRU.
+    while (impl->currentSizeInBytes > targetSizeInBytes) {
         _AthenaLRUContentStoreEntry *entry = _getEarliestExpiryTime(impl);
-        if (entry == NULL) {
+        if ((entry == NULL) || (nowInMillis <= entry->expiryTime)) {
             break;
         }
-        if (nowInMillis > entry->expiryTime) {
-            _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
-        } else {
+        if (_expireContentStoreEntry(impl, entry, nowInMillis)) {
+            impl->stats.numRemovedByExpiration++;
+        }
+    }
+
+    // Then the items whose stale window has ended.
+    while (impl->currentSizeInBytes > targetSizeInBytes) {
+        _AthenaLRUContentStoreEntry *entry = _getEarliestStaleUntilTime(impl);
+        if ((entry == NULL) || (nowInMillis <= entry->staleUntilTime)) {
             break;
         }
+        if (_expireContentStoreEntry(impl, entry, nowInMillis)) {
+            impl->stats.numRemovedByExpiration++;
+        }
     }
 
     // Evict items past their recommended cache time until we have enough room, or don't have any items.
-    while (sizeNeeded > (impl->maxSizeInBytes - impl->currentSizeInBytes)) {
+    while (impl->currentSizeInBytes > targetSizeInBytes) {
         _AthenaLRUContentStoreEntry *entry = _getEarliestRecommendedCacheTime(impl);
         if (entry == NULL) {
             break;
         }
         if (nowInMillis > entry->recommendedCacheTime) {
             _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+            impl->stats.numRemovedByRCT++;
         } else {
             break;
         }
     }
 
-    while (sizeNeeded > (impl->maxSizeInBytes - impl->currentSizeInBytes)) {
+    // Evict least recently used items, compressing them into the cold segment if it's enabled. Once
+    // the LRU is empty, discard the oldest compressed items.
+    while (impl->currentSizeInBytes > targetSizeInBytes) {
         _AthenaLRUContentStoreEntry *entry = _getLeastUsedFromLRU(impl);
         if (entry == NULL) {
-            break;
+            entry = impl->coldTail;
+            if (entry == NULL) {
+                break;
+            }
+        } else if (_moveContentStoreEntryToColdSegment(impl, entry)) {
+            continue;
         }
         _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+        impl->stats.numRemovedByLRU++;
     }
 
-    if (impl->maxSizeInBytes - impl->currentSizeInBytes > sizeNeeded) {
-        return true;
-    }
-
-    return result;
+    return (impl->currentSizeInBytes <= targetSizeInBytes);
 }
 
 /**
@@ -669,7 +1512,7 @@ _athenaLRUContentStore_PutLRUContentStoreEntry(AthenaContentStoreImplementation
         // own, but the LRU holds the final reference.
 
         _AthenaLRUContentStoreEntry *existingEntry = NULL;
-        CCNxName *name = ccnxContentObject_GetName(newEntry->contentObject);
+        AthenaInternedName *name = newEntry->name;
         if (name != NULL) {
             PARCObject *nameKey = _createHashableKey(name, NULL, NULL);
             existingEntry = _addEntryToIndexTableIfNotAlreadyInIt(impl->tableByName, nameKey, newEntry);
@@ -688,6 +1531,8 @@ _athenaLRUContentStore_PutLRUContentStoreEntry(AthenaContentStoreImplementation
             parcObject_Release((PARCObject **) &nameAndObjectHashKey);
         }
 
+        _addEntryToPrefixIndex(impl, newEntry);
+
         if (existingEntry != NULL && existingEntry->indexCount < 1) {
             // The existing entry is in no indexes, which means it cannot be matched and serves no further purpose.
             // Remove it completely from all containers.
@@ -695,14 +1540,8 @@ _athenaLRUContentStore_PutLRUContentStoreEntry(AthenaContentStoreImplementation
             _athenaLRUContentStore_PurgeContentStoreEntry(impl, existingEntry);
         }
 
-        // Add the new entry to the time-ordered lists, if it has an RCT or ExpiryTime.
-        if (newEntry->hasExpiryTime) {
-            parcSortedList_Add(impl->listByExpiryTime, newEntry);
-        }
-
-        if (newEntry->hasRecommendedCacheTime) {
-            parcSortedList_Add(impl->listByRecommendedCacheTime, newEntry);
-        }
+        _linkEntryToTimeIndexes(impl, newEntry);
+        _linkEntryToAddedList(impl, newEntry);
 
         impl->stats.numAdds++;
         impl->numEntries++;
@@ -713,6 +1552,103 @@ _athenaLRUContentStore_PutLRUContentStoreEntry(AthenaContentStoreImplementation
     return result;
 }
 
+/**
+ * Cut a shared payload out of an entry's wire format, keeping the bytes on either side of it. The payload
+ * is the last field of the message body, so it is searched for backwards from the end.
+ */
+static bool
+_removePayloadFromWireFormat(_AthenaLRUContentStoreEntry *entry, _AthenaLRUContentStorePayload *sharedPayload)
+{
+    PARCBuffer *wireFormat = _acquireWireFormat(entry->contentObject);
+    if (wireFormat == NULL) {
+        return false;
+    }
+
+    size_t length = parcBuffer_Limit(wireFormat);
+    const uint8_t *bytes = parcByteArray_Array(parcBuffer_Array(wireFormat)) + parcBuffer_ArrayOffset(wireFormat);
+    const uint8_t *payloadBytes = parcBuffer_Overlay(sharedPayload->payload, 0);
+    size_t payloadLength = sharedPayload->sizeInBytes;
+
+    bool result = false;
+    size_t offset = (payloadLength <= length) ? (length - payloadLength + 1) : 0;
+    while (offset-- > 0) {
+        if (bytes[offset] == payloadBytes[0] && memcmp(&bytes[offset], payloadBytes, payloadLength) == 0) {
+            size_t suffixOffset = offset + payloadLength;
+
+            entry->wireFormatPrefix = parcBuffer_Allocate(offset);
+            parcBuffer_PutArray(entry->wireFormatPrefix, offset, bytes);
+            parcBuffer_Flip(entry->wireFormatPrefix);
+
+            entry->wireFormatSuffix = parcBuffer_Allocate(length - suffixOffset);
+            parcBuffer_PutArray(entry->wireFormatSuffix, length - suffixOffset, &bytes[suffixOffset]);
+            parcBuffer_Flip(entry->wireFormatSuffix);
+
+            entry->wireFormatLength = length;
+            result = true;
+            break;
+        }
+    }
+
+    parcBuffer_Release(&wireFormat);
+    return result;
+}
+
+/**
+ * Look up the payload of a new entry among those already held. The first entry with a given payload
+ * holds it as usual and the payload is charged to the store rather than to the entry. Later entries with
+ * the same payload drop their copy and keep only the surrounding wire format.
+ */
+static void
+_shareContentStoreEntryPayload(AthenaLRUContentStore *impl, _AthenaLRUContentStoreEntry *entry)
+{
+    PARCBuffer *payload = ccnxContentObject_GetPayload(entry->contentObject);
+    if (payload == NULL || parcBuffer_Remaining(payload) < DEDUPLICATION_MIN_PAYLOAD_SIZE) {
+        return;
+    }
+
+    PARCHashCode hashCode = parcBuffer_HashCode(payload);
+    PARCBuffer *key = _createPayloadKey(hashCode);
+    _AthenaLRUContentStorePayload *sharedPayload = (_AthenaLRUContentStorePayload *) parcHashMap_Get(impl->tableByPayload, key);
+
+    if (sharedPayload == NULL) {
+        sharedPayload = _athenaLRUContentStorePayload_Create(payload, hashCode);
+        parcHashMap_Put(impl->tableByPayload, key, sharedPayload);
+        impl->currentSizeInBytes += sharedPayload->sizeInBytes;
+        impl->numSharedPayloads++;
+        impl->sharedPayloadSizeInBytes += sharedPayload->sizeInBytes;
+        entry->sharedPayload = sharedPayload; // the table acquires its own reference, the entry keeps ours
+    } else if (parcBuffer_Equals(sharedPayload->payload, payload) && _removePayloadFromWireFormat(entry, sharedPayload)) {
+        ccnxContentObject_Release(&entry->contentObject);
+        impl->numDeduplicatedEntries++;
+        impl->deduplicatedSizeInBytes += sharedPayload->sizeInBytes;
+        entry->sharedPayload = parcObject_Acquire(sharedPayload);
+    }
+    parcBuffer_Release(&key);
+
+    if (entry->sharedPayload != NULL) {
+        entry->sharedPayload->numReferences++;
+        entry->sizeInBytes -= entry->sharedPayload->sizeInBytes;
+    }
+}
+
+/**
+ * Rebuild the content object of an entry whose payload was removed in favour of a shared copy.
+ */
+static CCNxContentObject *
+_reassembleContentStoreEntry(_AthenaLRUContentStoreEntry *entry)
+{
+    PARCBuffer *wireFormat = parcBuffer_Allocate(entry->wireFormatLength);
+    parcBuffer_PutBuffer(wireFormat, entry->wireFormatPrefix);
+    parcBuffer_PutBuffer(wireFormat, entry->sharedPayload->payload);
+    parcBuffer_PutBuffer(wireFormat, entry->wireFormatSuffix);
+    parcBuffer_Flip(wireFormat);
+
+    CCNxMetaMessage *result = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+    parcBuffer_Release(&wireFormat);
+
+    return result;
+}
+
 static bool
 _athenaLRUContentStore_PutContentObject(AthenaContentStoreImplementation *store, const CCNxContentObject *content)
 {
@@ -726,12 +1662,17 @@ _athenaLRUContentStore_PutContentObject(AthenaContentStoreImplementation *store,
         }
     }
 
-    _AthenaLRUContentStoreEntry *newEntry = _athenaLRUContentStoreEntry_Create(content);
+    _AthenaLRUContentStoreEntry *newEntry = _athenaLRUContentStoreEntry_Create(impl->namePool, content);
+
+    if (impl->deduplicatePayloads) {
+        _shareContentStoreEntryPayload(impl, newEntry);
+    }
 
     bool result = _athenaLRUContentStore_PutLRUContentStoreEntry(store, newEntry);
 
     if (result == false) {
         // We didn't have enough room in the store to add the new item.
+        _releaseSharedPayload(impl, newEntry);
     }
 
     _athenaLRUContentStoreEntry_Release(&newEntry);
@@ -739,72 +1680,250 @@ _athenaLRUContentStore_PutContentObject(AthenaContentStoreImplementation *store,
     return result;
 }
 
-static CCNxContentObject *
-//_athenaLRUContentStore_GetMatch(AthenaContentStoreImplementation *store, const CCNxName *name, const PARCBuffer *keyIdRestriction,
-//                                const PARCBuffer *contentObjectHash)
-_athenaLRUContentStore_GetMatch(AthenaContentStoreImplementation *store, const CCNxInterest *interest)
+/**
+ * Find the best match for an interest whose name has been looked up in the name pool, releasing the
+ * interned name.  If `needsRefresh` is NULL only fresh content is matched, otherwise expired content
+ * within its stale window is matched too, and `needsRefresh` is set when the caller should request
+ * a fresh copy of it.
+ */
+/**
+ * Find the entry matching an interest in the most restrictive index the interest applies to, leaving the store as it is.
+ */
+static _AthenaLRUContentStoreEntry *
+_findMatchingEntry(AthenaLRUContentStore *impl, const CCNxInterest *interest, const AthenaInternedName *name)
 {
-    CCNxContentObject *result = NULL;
-    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
     _AthenaLRUContentStoreEntry *entry = NULL;
-
-    CCNxName *name = ccnxInterest_GetName(interest);
     PARCBuffer *contentObjectHashRestriction = ccnxInterest_GetContentObjectHashRestriction(interest);
     PARCBuffer *keyIdRestriction = ccnxInterest_GetKeyIdRestriction(interest);
 
+    size_t scratchMark = athenaScratch_Mark();
     if (contentObjectHashRestriction != NULL) {
-        PARCObject *nameAndHashKey = _createHashableKey(name, NULL, contentObjectHashRestriction);
+        PARCObject *nameAndHashKey = _createScratchKey(name, NULL, contentObjectHashRestriction);
         entry = (_AthenaLRUContentStoreEntry *) parcHashMap_Get(impl->tableByNameAndObjectHash, nameAndHashKey);
-        parcObject_Release((PARCObject **) &nameAndHashKey);
     }
 
     if ((entry == NULL) && (keyIdRestriction != NULL)) {
-        PARCObject *nameAndKeyIdKey = _createHashableKey(name, keyIdRestriction, NULL);
+        PARCObject *nameAndKeyIdKey = _createScratchKey(name, keyIdRestriction, NULL);
         entry = (_AthenaLRUContentStoreEntry *) parcHashMap_Get(impl->tableByNameAndKeyId, nameAndKeyIdKey);
-        parcObject_Release((PARCObject **) &nameAndKeyIdKey);
     }
 
     if (entry == NULL) {
-        PARCObject *nameKey = _createHashableKey(name, NULL, NULL);
+        PARCObject *nameKey = _createScratchKey(name, NULL, NULL);
         entry = (_AthenaLRUContentStoreEntry *) parcHashMap_Get(impl->tableByName, nameKey);
-        parcObject_Release((PARCObject **) &nameKey);
+    }
+    athenaScratch_Rewind(scratchMark);
+
+    return entry;
+}
+
+static CCNxContentObject *
+_athenaLRUContentStore_MatchName(AthenaContentStoreImplementation *store, const CCNxInterest *interest,
+                                 AthenaInternedName *name, bool *needsRefresh)
+{
+    CCNxContentObject *result = NULL;
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    _AthenaLRUContentStoreEntry *entry = NULL;
+
+    // The previously reassembled match is only guaranteed to the caller until this call.
+    if (impl->reassembledMatch != NULL) {
+        ccnxContentObject_Release(&impl->reassembledMatch);
+    }
+
+    // A name that has not been interned is in none of the indexes.
+    if (name != NULL) {
+        entry = _findMatchingEntry(impl, interest, name);
+        athenaInternedName_Release(&name);
     }
 
     // Matching is done. Now check for validity, if necessary.
 
     if (entry != NULL) {
         // We found matching content. Now make sure it's not expired before returning it. If it is expired,
-        // remove it from the store and don't return anything.
-        if (entry->hasExpiryTime && (entry->expiryTime < parcClock_GetTime(impl->wallClock))) {
-            _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
-            entry = NULL;
+        // and may not be served stale, remove it from the store and don't return anything.
+        uint64_t nowInMillis = parcClock_GetTime(impl->wallClock);
+        if (entry->hasExpiryTime && (entry->expiryTime < nowInMillis)) {
+            if ((needsRefresh != NULL) && _isWithinStaleWindow(impl, entry, nowInMillis)) {
+                if ((entry->refreshRequestedTime == 0) ||
+                    (nowInMillis > entry->refreshRequestedTime + STALE_REFRESH_RETRY_MILLIS)) {
+                    entry->refreshRequestedTime = nowInMillis;
+                    *needsRefresh = true;
+                }
+                impl->stats.numStaleHits++;
+            } else {
+                _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+                entry = NULL;
+            }
         }
 
         // XXX: TODO: Check that the KeyId, if any, was verified.
     }
 
+    // A match in the cold segment has to be decompressed before it can be returned.
+    if (entry != NULL && entry->compressedWireFormat != NULL) {
+        if (_restoreContentStoreEntryFromColdSegment(impl, entry) == false) {
+            entry = NULL;
+        }
+    }
+
+    // A match that shares another entry's payload has to be reassembled.
+    if (entry != NULL && entry->wireFormatPrefix != NULL) {
+        impl->reassembledMatch = _reassembleContentStoreEntry(entry);
+        if (impl->reassembledMatch == NULL) {
+            _athenaLRUContentStore_PurgeContentStoreEntry(impl, entry);
+            entry = NULL;
+        }
+    }
+
     // At this point, the cached content is considered valid for responding with. Return it.
     if (entry != NULL) {
-        result = entry->contentObject;
+        result = (entry->contentObject != NULL) ? entry->contentObject : impl->reassembledMatch;
 
-        // Update LRU so that the matched entry is at the top of the list.
-        _moveContentStoreEntryToLRUHead(impl, entry);
+        if (impl->evictionPolicy == AthenaLRUContentStoreEvictionPolicy_Clock) {
+            // Just note the reference, the entry is requeued if and when the eviction hand reaches it.
+            // Testing first avoids dirtying the entry's cache line on repeated hits.
+            if (entry->referenced == false) {
+                entry->referenced = true;
+            }
+        } else {
+            // Update LRU so that the matched entry is at the top of the list.
+            _moveContentStoreEntryToLRUHead(impl, entry);
+        }
 
         impl->stats.numMatchHits++;
     } else {
         impl->stats.numMatchMisses++;
+        if (needsRefresh != NULL) {
+            *needsRefresh = false;
+        }
     }
 
     return result;
 }
 
+static CCNxContentObject *
+_athenaLRUContentStore_Match(AthenaContentStoreImplementation *store, const CCNxInterest *interest, bool *needsRefresh)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    AthenaInternedName *name = athenaNamePool_Lookup(impl->namePool, ccnxInterest_GetName(interest));
+    return _athenaLRUContentStore_MatchName(store, interest, name, needsRefresh);
+}
+
+static CCNxContentObject *
+_athenaLRUContentStore_GetMatch(AthenaContentStoreImplementation *store, const CCNxInterest *interest)
+{
+    return _athenaLRUContentStore_Match(store, interest, NULL);
+}
+
+static bool
+_athenaLRUContentStore_ContainsMatch(AthenaContentStoreImplementation *store, const CCNxInterest *interest)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    bool result = false;
+
+    // A name that has not been interned is in none of the indexes.
+    AthenaInternedName *name = athenaNamePool_Lookup(impl->namePool, ccnxInterest_GetName(interest));
+    if (name != NULL) {
+        _AthenaLRUContentStoreEntry *entry = _findMatchingEntry(impl, interest, name);
+        result = (entry != NULL) &&
+                 (!entry->hasExpiryTime || (entry->expiryTime >= parcClock_GetTime(impl->wallClock)));
+        athenaInternedName_Release(&name);
+    }
+
+    return result;
+}
+
+static void
+_athenaLRUContentStore_GetMatchBatch(AthenaContentStoreImplementation *store, const CCNxInterest **interests,
+                                     size_t count, CCNxContentObject **results, bool *needsRefresh)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    const CCNxName *names[AthenaNamePoolBatchSize];
+    AthenaInternedName *internedNames[AthenaNamePoolBatchSize];
+
+    for (size_t first = 0; first < count; first += AthenaNamePoolBatchSize) {
+        size_t groupSize = ((count - first) < AthenaNamePoolBatchSize) ? (count - first) : AthenaNamePoolBatchSize;
+        for (size_t i = 0; i < groupSize; i++) {
+            names[i] = ccnxInterest_GetName(interests[first + i]);
+        }
+        athenaNamePool_LookupBatch(impl->namePool, names, groupSize, internedNames);
+
+        for (size_t i = 0; i < groupSize; i++) {
+            // A reassembled match only lasts until the next lookup
+            needsRefresh[first + i] = false;
+            CCNxContentObject *match = _athenaLRUContentStore_MatchName(store, interests[first + i], internedNames[i],
+                                                                        &needsRefresh[first + i]);
+            results[first + i] = (match != NULL) ? ccnxContentObject_Acquire(match) : NULL;
+        }
+    }
+}
+
+static bool
+_athenaLRUContentStore_PutRefresh(AthenaContentStoreImplementation *store, const CCNxContentObject *content)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    _AthenaLRUContentStoreEntry *entry = NULL;
+
+    AthenaInternedName *name = athenaNamePool_Lookup(impl->namePool, ccnxContentObject_GetName(content));
+    if (name != NULL) {
+        size_t scratchMark = athenaScratch_Mark();
+        PARCObject *nameKey = _createScratchKey(name, NULL, NULL);
+        entry = (_AthenaLRUContentStoreEntry *) parcHashMap_Get(impl->tableByName, nameKey);
+        athenaScratch_Rewind(scratchMark);
+        athenaInternedName_Release(&name);
+    }
+
+    // Only a copy we asked for, while it can still be an answer to our refresh, replaces the stale entry
+    if ((entry == NULL) || (entry->refreshRequestedTime == 0) ||
+        (parcClock_GetTime(impl->wallClock) > entry->refreshRequestedTime + STALE_REFRESH_RETRY_MILLIS)) {
+        return false;
+    }
+
+    return _athenaLRUContentStore_PutContentObject(store, content);
+}
+
+static CCNxContentObject *
+_athenaLRUContentStore_GetMatchOrStale(AthenaContentStoreImplementation *store, const CCNxInterest *interest,
+                                       bool *needsRefresh)
+{
+    *needsRefresh = false;
+    return _athenaLRUContentStore_Match(store, interest, needsRefresh);
+}
+
 static bool
-_athenaLRUContentStore_RemoveMatch(AthenaContentStoreImplementation *store, const CCNxName *name,
+_athenaLRUContentStore_SetStaleWindow(AthenaContentStoreImplementation *store, const CCNxName *ccnxPrefix,
+                                      uint64_t windowInMillis)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+
+    AthenaInternedName *name = athenaNamePool_Intern(impl->namePool, ccnxPrefix);
+    PARCObject *key = _createHashableKey(name, NULL, NULL);
+    athenaInternedName_Release(&name); // the key holds the name while the window is configured
+
+    if (windowInMillis == 0) {
+        parcHashMap_Remove(impl->tableByStaleWindow, key);
+    } else {
+        _AthenaLRUContentStoreStaleWindow *window = parcObject_CreateAndClearInstance(_AthenaLRUContentStoreStaleWindow);
+        window->windowInMillis = windowInMillis;
+        parcHashMap_Put(impl->tableByStaleWindow, key, window);
+        parcObject_Release((PARCObject **) &window);
+    }
+    parcObject_Release((PARCObject **) &key);
+
+    return true;
+}
+
+static bool
+_athenaLRUContentStore_RemoveMatch(AthenaContentStoreImplementation *store, const CCNxName *ccnxName,
                                    const PARCBuffer *keyIdRestriction, const PARCBuffer *contentObjectHash)
 {
     AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
     bool wasRemoved = false;
 
+    AthenaInternedName *name = athenaNamePool_Lookup(impl->namePool, ccnxName);
+    if (name == NULL) {
+        return false;
+    }
+
     if (contentObjectHash != NULL) {
         PARCObject *nameAndHashKey = _createHashableKey(name, NULL, contentObjectHash);
         _AthenaLRUContentStoreEntry *entry =
@@ -839,9 +1958,107 @@ _athenaLRUContentStore_RemoveMatch(AthenaContentStoreImplementation *store, cons
         }
     }
 
+    athenaInternedName_Release(&name);
+
+    if (wasRemoved) {
+        impl->stats.numRemoves++;
+    }
+
     return wasRemoved;
 }
 
+static void
+_updateExpirationRate(AthenaLRUContentStore *impl, uint64_t nowInMillis)
+{
+    uint64_t elapsedMillis = nowInMillis - impl->expirationRateTime;
+    if (elapsedMillis >= EXPIRATION_RATE_INTERVAL_MILLIS) {
+        uint64_t numExpired = impl->stats.numRemovedByExpiration - impl->expirationRateCount;
+        impl->removedByExpirationPerSecond = (numExpired * 1000) / elapsedMillis;
+        impl->expirationRateTime = nowInMillis;
+        impl->expirationRateCount = impl->stats.numRemovedByExpiration;
+    }
+}
+
+/**
+ * Free expired entries from the front of the expiry index, and entries whose stale window has ended from the
+ * front of the stale index.  Both are taken from the head of their list, so each step is constant time and a
+ * slice never rescans entries it has already passed over.  At most maxEntries are removed and at most
+ * maxEntries are moved between the lists, so the slice stays bounded.  Stale windows are looked up when an
+ * entry is moved; a window shortened later only takes effect for the sweeper when the old one ends.
+ */
+static size_t
+_athenaLRUContentStore_SweepExpired(AthenaContentStoreImplementation *store, size_t maxEntries)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    uint64_t nowInMillis = parcClock_GetTime(impl->wallClock);
+    size_t numRemoved = 0;
+    size_t numParked = 0;
+
+    while ((numRemoved < maxEntries) && (numParked < maxEntries)) {
+        _AthenaLRUContentStoreEntry *entry = _getEarliestExpiryTime(impl);
+        if ((entry == NULL) || !entry->hasExpiryTime || (entry->expiryTime >= nowInMillis)) {
+            break;
+        }
+        if (_expireContentStoreEntry(impl, entry, nowInMillis)) {
+            numRemoved++;
+        } else {
+            numParked++;
+        }
+    }
+
+    // The window may have been lengthened since an entry was moved aside, if so it is moved again.
+    while ((numRemoved < maxEntries) && (numParked < maxEntries)) {
+        _AthenaLRUContentStoreEntry *entry = _getEarliestStaleUntilTime(impl);
+        if ((entry == NULL) || (entry->staleUntilTime >= nowInMillis)) {
+            break;
+        }
+        if (_expireContentStoreEntry(impl, entry, nowInMillis)) {
+            numRemoved++;
+        } else {
+            numParked++;
+        }
+    }
+
+    impl->stats.numRemovedByExpiration += numRemoved;
+    _updateExpirationRate(impl, nowInMillis);
+
+    return numRemoved;
+}
+
+static size_t
+_athenaLRUContentStore_PurgePrefix(AthenaContentStoreImplementation *store, const CCNxName *ccnxPrefix,
+                                   size_t maxEntries, size_t *bytesFreed)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    size_t numPurged = 0;
+    size_t sizeBeforePurge = impl->currentSizeInBytes;
+
+    AthenaInternedName *name = athenaNamePool_Lookup(impl->namePool, ccnxPrefix);
+    if (name != NULL) {
+        // Take entries from the leaves of the trie under the prefix.  Purging the last entry under a
+        // node removes the node, possibly up to and including the prefix, so it is looked up again.
+        _AthenaLRUContentStorePrefix *prefix = _getPrefix(impl, name);
+        while (prefix != NULL && numPurged < maxEntries) {
+            while (prefix->firstChild != NULL) {
+                prefix = prefix->firstChild;
+            }
+            _athenaLRUContentStore_PurgeContentStoreEntry(impl, prefix->firstEntry);
+            numPurged++;
+
+            prefix = _getPrefix(impl, name);
+        }
+        athenaInternedName_Release(&name);
+    }
+
+    impl->stats.numRemoves += numPurged;
+    impl->stats.numRemovedByPurge += numPurged;
+
+    if (bytesFreed != NULL) {
+        *bytesFreed = sizeBeforePurge - impl->currentSizeInBytes;
+    }
+    return numPurged;
+}
+
 static size_t
 _athenaLRUContentStore_GetCapacity(AthenaContentStoreImplementation *store)
 {
@@ -851,15 +2068,204 @@ _athenaLRUContentStore_GetCapacity(AthenaContentStoreImplementation *store)
 
 static bool
 _athenaLRUContentStore_SetCapacity(AthenaContentStoreImplementation *store, size_t maxSizeInMB)
+{
+    return athenaLRUContentStore_SetCapacityInBytes(store, maxSizeInMB * (1024 * 1024));
+}
+
+bool
+athenaLRUContentStore_SetCapacityInBytes(AthenaContentStoreImplementation *store, size_t maxSizeInBytes)
 {
     AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
-    impl->maxSizeInBytes = maxSizeInMB * (1024 * 1024);
+    impl->maxSizeInBytes = maxSizeInBytes;
+    impl->maxColdSizeInBytes = (maxSizeInBytes / 100) * impl->coldSegmentPercent;
 
-    // TODO: Trim existing entries to fit into the new limit, if necessary.
+    while (impl->currentColdSizeInBytes > impl->maxColdSizeInBytes) {
+        _athenaLRUContentStore_PurgeContentStoreEntry(impl, impl->coldTail);
+        impl->stats.numRemovedByLRU++;
+    }
+
+    // Trim existing entries to fit into the new limit, if necessary.
+    if (impl->currentSizeInBytes > impl->maxSizeInBytes) {
+        _makeRoomInStore(impl, 0);
+    }
 
     return true;
 }
 
+void
+athenaLRUContentStore_GetStats(const AthenaContentStoreImplementation *store, AthenaLRUContentStoreStats *stats)
+{
+    const AthenaLRUContentStore *impl = (const AthenaLRUContentStore *) store;
+
+    stats->numEntries = impl->numEntries;
+    stats->sizeInBytes = impl->currentSizeInBytes;
+    stats->capacityInBytes = impl->maxSizeInBytes;
+    stats->numAdds = impl->stats.numAdds;
+    stats->numRemoves = impl->stats.numRemoves;
+    stats->numMatchHits = impl->stats.numMatchHits;
+    stats->numMatchMisses = impl->stats.numMatchMisses;
+    stats->numStaleHits = impl->stats.numStaleHits;
+    stats->numRemovedByLRU = impl->stats.numRemovedByLRU;
+    stats->numRemovedByExpiration = impl->stats.numRemovedByExpiration;
+    stats->removedByExpirationPerSecond = impl->removedByExpirationPerSecond;
+    stats->numRemovedByRCT = impl->stats.numRemovedByRCT;
+    stats->numRemovedByPurge = impl->stats.numRemovedByPurge;
+
+    stats->numColdEntries = impl->numColdEntries;
+    stats->coldSizeInBytes = impl->currentColdSizeInBytes;
+    stats->coldCapacityInBytes = impl->maxColdSizeInBytes;
+    stats->numCompressed = impl->stats.numCompressed;
+    stats->numIncompressible = impl->stats.numIncompressible;
+    stats->numDecompressed = impl->stats.numDecompressed;
+    stats->bytesBeforeCompression = impl->stats.bytesBeforeCompression;
+    stats->bytesAfterCompression = impl->stats.bytesAfterCompression;
+    stats->compressionTimeInNanos = impl->stats.compressionTimeInNanos;
+    stats->decompressionTimeInNanos = impl->stats.decompressionTimeInNanos;
+
+    stats->numSharedPayloads = impl->numSharedPayloads;
+    stats->sharedPayloadSizeInBytes = impl->sharedPayloadSizeInBytes;
+    stats->numDeduplicatedEntries = impl->numDeduplicatedEntries;
+    stats->deduplicatedSizeInBytes = impl->deduplicatedSizeInBytes;
+}
+
+/**
+ * The part of a store entry reported by a snapshot.  The entry itself moves between lists and
+ * segments as the store is used, so a snapshot takes a copy.
+ */
+typedef struct athena_lrucontentstore_snapshot_entry {
+    AthenaInternedName *name;
+    size_t sizeInBytes;
+    bool hasExpiryTime;
+    uint64_t expiryTime;
+    bool isCold;
+    bool isDeduplicated;
+} _AthenaLRUContentStoreSnapshotEntry;
+
+static void
+_athenaLRUContentStoreSnapshotEntry_Finalize(_AthenaLRUContentStoreSnapshotEntry **entryPtr)
+{
+    athenaInternedName_Release(&(*entryPtr)->name);
+}
+
+static PARCJSON *
+_athenaLRUContentStoreSnapshotEntry_ToJSON(const _AthenaLRUContentStoreSnapshotEntry *entry)
+{
+    PARCJSON *json = parcJSON_Create();
+
+    CCNxName *name = athenaInternedName_CreateName(entry->name);
+    char *nameString = ccnxName_ToString(name);
+    parcJSON_AddString(json, "name", nameString);
+    parcMemory_Deallocate(&nameString);
+    ccnxName_Release(&name);
+
+    parcJSON_AddInteger(json, "sizeInBytes", entry->sizeInBytes);
+    if (entry->hasExpiryTime) {
+        parcJSON_AddInteger(json, "expiryTime", entry->expiryTime);
+    }
+    parcJSON_AddBoolean(json, "cold", entry->isCold);
+    parcJSON_AddBoolean(json, "deduplicated", entry->isDeduplicated);
+
+    return json;
+}
+
+parcObject_ExtendPARCObject(_AthenaLRUContentStoreSnapshotEntry,
+                            _athenaLRUContentStoreSnapshotEntry_Finalize,
+                            NULL, // copy
+                            NULL, // toString
+                            NULL, // equals,
+                            NULL, // compare
+                            NULL, // hashCode
+                            _athenaLRUContentStoreSnapshotEntry_ToJSON
+                            );
+
+static
+parcObject_ImplementRelease(_athenaLRUContentStoreSnapshotEntry, _AthenaLRUContentStoreSnapshotEntry);
+
+static void
+_appendToSnapshot(AthenaSnapshot *snapshot, const _AthenaLRUContentStoreEntry *entry, bool isCold)
+{
+    _AthenaLRUContentStoreSnapshotEntry *snapshotEntry = parcObject_CreateInstance(_AthenaLRUContentStoreSnapshotEntry);
+    snapshotEntry->name = athenaInternedName_Acquire(entry->name);
+    snapshotEntry->sizeInBytes = entry->sizeInBytes;
+    snapshotEntry->hasExpiryTime = entry->hasExpiryTime;
+    snapshotEntry->expiryTime = entry->expiryTime;
+    snapshotEntry->isCold = isCold;
+    snapshotEntry->isDeduplicated = (entry->sharedPayload != NULL);
+    athenaSnapshot_Append(snapshot, snapshotEntry);
+    _athenaLRUContentStoreSnapshotEntry_Release(&snapshotEntry);
+}
+
+/**
+ * Append the store's entries to a snapshot, most recently used first, followed by the cold segment.
+ */
+static void
+_athenaLRUContentStore_Snapshot(AthenaContentStoreImplementation *store, AthenaSnapshot *snapshot)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+
+    for (_AthenaLRUContentStoreEntry *entry = impl->lruHead; entry != NULL; entry = entry->prev) {
+        _appendToSnapshot(snapshot, entry, false);
+    }
+    for (_AthenaLRUContentStoreEntry *entry = impl->coldHead; entry != NULL; entry = entry->prev) {
+        _appendToSnapshot(snapshot, entry, true);
+    }
+}
+
+static AthenaContentStoreWalk *
+_athenaLRUContentStore_StartSnapshot(AthenaContentStoreImplementation *store)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+
+    _AthenaLRUContentStoreWalk *walk = parcMemory_AllocateAndClear(sizeof(_AthenaLRUContentStoreWalk));
+    assertNotNull(walk, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_AthenaLRUContentStoreWalk));
+    walk->next = impl->firstAdded;
+    walk->last = impl->lastAdded;
+
+    walk->nextWalk = impl->walks;
+    if (impl->walks != NULL) {
+        impl->walks->prevWalk = walk;
+    }
+    impl->walks = walk;
+
+    return walk;
+}
+
+/**
+ * Append the next entries of a walk to a snapshot, oldest first, whether they are in the LRU or the cold segment.
+ */
+static bool
+_athenaLRUContentStore_ContinueSnapshot(AthenaContentStoreImplementation *store, AthenaContentStoreWalk *storeWalk,
+                                        AthenaSnapshot *snapshot, size_t maxEntries)
+{
+    _AthenaLRUContentStoreWalk *walk = (_AthenaLRUContentStoreWalk *) storeWalk;
+
+    for (size_t i = 0; (i < maxEntries) && (walk->next != NULL); i++) {
+        _AthenaLRUContentStoreEntry *entry = walk->next;
+        _appendToSnapshot(snapshot, entry, entry->compressedWireFormat != NULL);
+        walk->next = (entry == walk->last) ? NULL : entry->nextAdded;
+    }
+
+    return (walk->next != NULL);
+}
+
+static void
+_athenaLRUContentStore_StopSnapshot(AthenaContentStoreImplementation *store, AthenaContentStoreWalk **walkPtr)
+{
+    AthenaLRUContentStore *impl = (AthenaLRUContentStore *) store;
+    _AthenaLRUContentStoreWalk *walk = (_AthenaLRUContentStoreWalk *) *walkPtr;
+
+    if (walk->nextWalk != NULL) {
+        walk->nextWalk->prevWalk = walk->prevWalk;
+    }
+    if (walk->prevWalk != NULL) {
+        walk->prevWalk->nextWalk = walk->nextWalk;
+    } else {
+        impl->walks = walk->nextWalk;
+    }
+
+    parcMemory_Deallocate(walkPtr);
+}
+
 static void
 _getChunkNumberFromName(const CCNxName *name, uint64_t *chunkNum, bool *hasChunkNum)
 {
@@ -890,6 +2296,10 @@ _createStatSizeResponsePayload(const AthenaLRUContentStore *impl, const CCNxName
     parcJSON_AddInteger(json, "time", parcClock_GetTime(impl->wallClock));
     parcJSON_AddInteger(json, "numEntries", impl->numEntries);
     parcJSON_AddInteger(json, "sizeInBytes", impl->currentSizeInBytes);
+    parcJSON_AddInteger(json, "numSharedPayloads", impl->numSharedPayloads);
+    parcJSON_AddInteger(json, "sharedPayloadSizeInBytes", impl->sharedPayloadSizeInBytes);
+    parcJSON_AddInteger(json, "numDeduplicatedEntries", impl->numDeduplicatedEntries);
+    parcJSON_AddInteger(json, "deduplicatedSizeInBytes", impl->deduplicatedSizeInBytes);
 
     char *jsonString = parcJSON_ToString(json);
 
@@ -916,7 +2326,43 @@ _createStatHitsResponsePayload(const AthenaLRUContentStore *impl, const CCNxName
     parcJSON_AddInteger(json, "numAdds", impl->stats.numAdds);
     parcJSON_AddInteger(json, "numHits", impl->stats.numMatchHits);
     parcJSON_AddInteger(json, "numMisses", impl->stats.numMatchMisses);
+    parcJSON_AddInteger(json, "numStaleHits", impl->stats.numStaleHits);
     parcJSON_AddInteger(json, "numRemovedByExpiration", impl->stats.numRemovedByExpiration);
+    parcJSON_AddInteger(json, "removedByExpirationPerSecond", impl->removedByExpirationPerSecond);
+    parcJSON_AddInteger(json, "numRemovedByPurge", impl->stats.numRemovedByPurge);
+
+    char *jsonString = parcJSON_ToString(json);
+
+    parcJSON_Release(&json);
+
+    PARCBuffer *result = parcBuffer_CreateFromArray(jsonString, strlen(jsonString));
+
+    parcMemory_Deallocate(&jsonString);
+
+    return parcBuffer_Flip(result);
+}
+
+/**
+ * Create a PARCBuffer payload containing a JSON string with information about this ContentStore's
+ * cold segment, the compression ratio achieved and the time spent compressing.
+ */
+static PARCBuffer *
+_createStatCompressionResponsePayload(const AthenaLRUContentStore *impl, const CCNxName *name, uint64_t chunkNumber)
+{
+    PARCJSON *json = parcJSON_Create();
+
+    parcJSON_AddString(json, "moduleName", AthenaContentStore_LRUImplementation.description);
+    parcJSON_AddInteger(json, "time", parcClock_GetTime(impl->wallClock));
+    parcJSON_AddInteger(json, "numColdEntries", impl->numColdEntries);
+    parcJSON_AddInteger(json, "coldSizeInBytes", impl->currentColdSizeInBytes);
+    parcJSON_AddInteger(json, "coldCapacityInBytes", impl->maxColdSizeInBytes);
+    parcJSON_AddInteger(json, "numCompressed", impl->stats.numCompressed);
+    parcJSON_AddInteger(json, "numIncompressible", impl->stats.numIncompressible);
+    parcJSON_AddInteger(json, "numDecompressed", impl->stats.numDecompressed);
+    parcJSON_AddInteger(json, "bytesBeforeCompression", impl->stats.bytesBeforeCompression);
+    parcJSON_AddInteger(json, "bytesAfterCompression", impl->stats.bytesAfterCompression);
+    parcJSON_AddInteger(json, "compressionTimeInNanos", impl->stats.compressionTimeInNanos);
+    parcJSON_AddInteger(json, "decompressionTimeInNanos", impl->stats.decompressionTimeInNanos);
 
     char *jsonString = parcJSON_ToString(json);
 
@@ -940,11 +2386,14 @@ _processStatQuery(const AthenaLRUContentStore *impl, CCNxName *queryName, size_t
 
         char *sizeString = "size";
         char *hitsString = "hits";
+        char *compressionString = "compression";
 
         if (strncasecmp(queryString, sizeString, strlen(sizeString)) == 0) {
             result = _createStatSizeResponsePayload(impl, queryName, chunkNumber);
         } else if (strncasecmp(queryString, hitsString, strlen(hitsString)) == 0) {
             result = _createStatHitsResponsePayload(impl, queryName, chunkNumber);
+        } else if (strncasecmp(queryString, compressionString, strlen(compressionString)) == 0) {
+            result = _createStatCompressionResponsePayload(impl, queryName, chunkNumber);
         }
 
         parcMemory_Deallocate(&queryString);
@@ -1028,11 +2477,23 @@ AthenaContentStoreInterface AthenaContentStore_LRUImplementation = {
 
     .putContentObject = _athenaLRUContentStore_PutContentObject,
     .getMatch         = _athenaLRUContentStore_GetMatch,
+    .getMatchBatch    = _athenaLRUContentStore_GetMatchBatch,
+    .getMatchOrStale  = _athenaLRUContentStore_GetMatchOrStale,
+    .containsMatch    = _athenaLRUContentStore_ContainsMatch,
+    .putRefresh       = _athenaLRUContentStore_PutRefresh,
+    .setStaleWindow   = _athenaLRUContentStore_SetStaleWindow,
     .removeMatch      = _athenaLRUContentStore_RemoveMatch,
+    .sweepExpired     = _athenaLRUContentStore_SweepExpired,
+    .purgePrefix      = _athenaLRUContentStore_PurgePrefix,
 
     .getCapacity      = _athenaLRUContentStore_GetCapacity,
     .setCapacity      = _athenaLRUContentStore_SetCapacity,
 
-    .processMessage   = _athenaLRUContentStore_ProcessMessage
+    .processMessage   = _athenaLRUContentStore_ProcessMessage,
+
+    .snapshot         = _athenaLRUContentStore_Snapshot,
+    .startSnapshot    = _athenaLRUContentStore_StartSnapshot,
+    .continueSnapshot = _athenaLRUContentStore_ContinueSnapshot,
+    .stopSnapshot     = _athenaLRUContentStore_StopSnapshot
 };
 
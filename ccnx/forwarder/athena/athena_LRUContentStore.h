@@ -37,14 +37,87 @@
 #include <parc/algol/parc_HashCode.h>
 
 #include <ccnx/forwarder/athena/athena_ContentStore.h>
+#include <ccnx/forwarder/athena/athena_NamePool.h>
 
 struct AthenaLRUContentStore;
 typedef struct AthenaLRUContentStore AthenaLRUContentStore;
 
+/**
+ * @typedef AthenaLRUContentStoreEvictionPolicy
+ * @brief How the store chooses entries to evict when it needs room
+ *
+ * AthenaLRUContentStoreEvictionPolicy_LRU moves every matched entry to the head of the eviction list.
+ * AthenaLRUContentStoreEvictionPolicy_Clock (second chance) only marks a matched entry as referenced,
+ * the eviction path moves referenced entries back to the head instead of evicting them, so a cache
+ * hit never modifies the list.
+ */
+typedef enum {
+    AthenaLRUContentStoreEvictionPolicy_LRU = 0,
+    AthenaLRUContentStoreEvictionPolicy_Clock = 1
+} AthenaLRUContentStoreEvictionPolicy;
+
+/**
+ * @typedef AthenaLRUContentStoreConfig
+ * @brief Configuration of an LRU store
+ *
+ * coldSegmentPercent is the share of the capacity that may hold compressed entries. Entries evicted
+ * from the uncompressed (hot) portion of the store are compressed into this cold segment rather than
+ * discarded, and are decompressed back into the hot portion when they are matched. Payloads that do
+ * not compress well are discarded as before. A value of 0 disables the cold segment.
+ *
+ * If deduplicatePayloads is set, entries whose payloads are identical share a single copy of the
+ * payload, which is charged against the capacity once. An entry that shares a payload held by an
+ * earlier entry keeps its wire format without the payload bytes and is reassembled when matched.
+ *
+ * Entry names are interned in namePool, which may be shared with the PIT and FIB so that names they
+ * have in common are held once. If namePool is NULL the store creates a pool of its own.
+ */
 typedef struct AthenaLRUContentStoreConfig {
     size_t capacityInMB;
+    AthenaLRUContentStoreEvictionPolicy evictionPolicy;
+    size_t coldSegmentPercent;
+    bool deduplicatePayloads;
+    AthenaNamePool *namePool;
 } AthenaLRUContentStoreConfig;
 
+/**
+ * @typedef AthenaLRUContentStoreStats
+ * @brief A snapshot of the occupancy and activity counters of an LRU store
+ */
+typedef struct AthenaLRUContentStoreStats {
+    uint64_t numEntries;
+    size_t sizeInBytes;
+    size_t capacityInBytes;
+    uint64_t numAdds;
+    uint64_t numRemoves;
+    uint64_t numMatchHits;
+    uint64_t numMatchMisses;
+    uint64_t numStaleHits;             // expired matches served within their stale window
+    uint64_t numRemovedByLRU;
+    uint64_t numRemovedByExpiration;
+    uint64_t removedByExpirationPerSecond; // rate measured by the expiry sweeper
+    uint64_t numRemovedByRCT;
+    uint64_t numRemovedByPurge;        // entries removed by prefix purges
+
+    // Cold segment
+    uint64_t numColdEntries;
+    size_t coldSizeInBytes;
+    size_t coldCapacityInBytes;
+    uint64_t numCompressed;            // entries moved into the cold segment
+    uint64_t numIncompressible;        // entries discarded because sampling showed they would not compress
+    uint64_t numDecompressed;          // cold entries matched and restored
+    uint64_t bytesBeforeCompression;   // total wire format bytes compressed
+    uint64_t bytesAfterCompression;    // total size of the resulting blocks
+    uint64_t compressionTimeInNanos;   // time spent sampling and compressing
+    uint64_t decompressionTimeInNanos; // time spent decompressing and decoding
+
+    // Payload deduplication
+    uint64_t numSharedPayloads;        // distinct payloads held
+    size_t sharedPayloadSizeInBytes;   // size of the distinct payloads, each charged once
+    uint64_t numDeduplicatedEntries;   // entries referring to a payload held by another entry
+    size_t deduplicatedSizeInBytes;    // payload bytes those entries would otherwise hold
+} AthenaLRUContentStoreStats;
+
 /**
  * Increase the number of references to a `AthenaLRUContentStore` instance.
  *
@@ -245,5 +318,46 @@ bool athenaLRUContentStore_IsValid(const AthenaLRUContentStore *instance);
  */
 char *athenaLRUContentStore_ToString(const AthenaLRUContentStore *instance);
 
+/**
+ * Set the capacity of an LRU store in bytes, evicting entries as needed to fit within it.
+ *
+ * This is a finer grained version of `athenaContentStore_SetCapacity`, used by stores that divide
+ * a budget among several LRU stores.
+ *
+ * @param [in] store A pointer to an AthenaLRUContentStore implementation instance.
+ * @param [in] maxSizeInBytes The new capacity of the store.
+ *
+ * @return true if the capacity was set.
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaContentStoreImplementation *store = AthenaContentStore_LRUImplementation.create(&config);
+ *
+ *     athenaLRUContentStore_SetCapacityInBytes(store, 64 * 1024);
+ *
+ *     AthenaContentStore_LRUImplementation.release(&store);
+ * }
+ * @endcode
+ */
+bool athenaLRUContentStore_SetCapacityInBytes(AthenaContentStoreImplementation *store, size_t maxSizeInBytes);
+
+/**
+ * Copy the current occupancy and activity counters of an LRU store.
+ *
+ * @param [in] store A pointer to an AthenaLRUContentStore implementation instance.
+ * @param [out] stats The structure to fill in.
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaLRUContentStoreStats stats;
+ *     athenaLRUContentStore_GetStats(store, &stats);
+ *     printf("%" PRIu64 " entries\n", stats.numEntries);
+ * }
+ * @endcode
+ */
+void athenaLRUContentStore_GetStats(const AthenaContentStoreImplementation *store, AthenaLRUContentStoreStats *stats);
+
 extern AthenaContentStoreInterface AthenaContentStore_LRUImplementation;
 #endif
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena asynchronous log reporter
+ *
+ * Producers (any thread logging through a PARCLog using this reporter) claim a slot in a bounded
+ * multi-producer ring with a single compare-and-swap and publish the acquired PARCLogEntry.  The
+ * writer thread is the only consumer; it renders and outputs the entry through the downstream
+ * reporter, so a log call on the forwarding path never performs I/O.
+ *
+ * The message text itself is still formatted by parcLog on the calling thread, before the entry
+ * reaches this reporter; only rendering the record and writing it are deferred.
+ *
+ * An idle writer sleeps on a condition variable.  A producer only takes the mutex to wake it when
+ * it has announced that it is asleep, so a busy writer costs producers nothing but the ring.
+ */
+
+#include <config.h>
+
+#include <pthread.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Object.h>
+#include <parc/logging/parc_LogEntry.h>
+
+#include <ccnx/forwarder/athena/athena_LogReporterAsync.h>
+
+typedef struct athena_log_slot {
+    uint64_t sequence;
+    PARCLogEntry *entry;
+} _AthenaLogSlot;
+
+typedef struct athena_log_reporter_async {
+    PARCLogReporter *reporter;
+    _AthenaLogSlot *ring;
+    size_t capacity;
+    size_t mask;
+
+    // Producer and consumer positions are kept on separate cache lines
+    uint64_t enqueuePosition __attribute__((aligned(64)));
+    uint64_t dequeuePosition __attribute__((aligned(64)));
+
+    uint64_t dropped;
+    uint64_t written;
+    bool running;
+    pthread_t writer;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t queued;            // signalled when an entry is queued for a sleeping writer, or on stop
+    pthread_cond_t drained;           // broadcast when the writer finds the ring empty
+    bool sleeping;                    // set by the writer, under the mutex, before waiting for an entry
+} _AthenaLogReporterAsync;
+
+static bool
+_athenaLogReporterAsync_Enqueue(_AthenaLogReporterAsync *queue, PARCLogEntry *entry)
+{
+    uint64_t position = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_RELAXED);
+    _AthenaLogSlot *slot;
+
+    for (;;) {
+        slot = &queue->ring[position & queue->mask];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int64_t difference = (int64_t) sequence - (int64_t) position;
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&queue->enqueuePosition, &position, position + 1,
+                                            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false; // full
+        } else {
+            position = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->entry = entry;
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+
+    // Either the writer sees this entry when it looks again before sleeping, or we see it asleep
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&queue->sleeping, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&queue->mutex);
+        pthread_cond_signal(&queue->queued);
+        pthread_mutex_unlock(&queue->mutex);
+    }
+    return true;
+}
+
+static bool
+_athenaLogReporterAsync_IsEmpty(_AthenaLogReporterAsync *queue)
+{
+    uint64_t position = queue->dequeuePosition;
+    return __atomic_load_n(&queue->ring[position & queue->mask].sequence, __ATOMIC_ACQUIRE) != (position + 1);
+}
+
+static PARCLogEntry *
+_athenaLogReporterAsync_Dequeue(_AthenaLogReporterAsync *queue)
+{
+    uint64_t position = queue->dequeuePosition;
+    _AthenaLogSlot *slot = &queue->ring[position & queue->mask];
+
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != (position + 1)) {
+        return NULL; // empty
+    }
+    PARCLogEntry *entry = slot->entry;
+    slot->entry = NULL;
+    queue->dequeuePosition = position + 1;
+    __atomic_store_n(&slot->sequence, position + queue->capacity, __ATOMIC_RELEASE);
+    return entry;
+}
+
+static void *
+_athenaLogReporterAsync_Writer(void *arg)
+{
+    _AthenaLogReporterAsync *queue = (_AthenaLogReporterAsync *) arg;
+
+    for (;;) {
+        PARCLogEntry *entry = _athenaLogReporterAsync_Dequeue(queue);
+        if (entry) {
+            parcLogReporter_Report(queue->reporter, entry);
+            parcLogEntry_Release(&entry);
+            __atomic_add_fetch(&queue->written, 1, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        pthread_mutex_lock(&queue->mutex);
+        pthread_cond_broadcast(&queue->drained);
+
+        // Drain everything that was queued before we were asked to stop
+        if (queue->running == false) {
+            pthread_mutex_unlock(&queue->mutex);
+            break;
+        }
+
+        __atomic_store_n(&queue->sleeping, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (_athenaLogReporterAsync_IsEmpty(queue) && queue->running) {
+            pthread_cond_wait(&queue->queued, &queue->mutex);
+        }
+        __atomic_store_n(&queue->sleeping, false, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&queue->mutex);
+    }
+    return NULL;
+}
+
+static void
+_athenaLogReporterAsync_Destroy(_AthenaLogReporterAsync **queuePtr)
+{
+    _AthenaLogReporterAsync *queue = *queuePtr;
+
+    pthread_mutex_lock(&queue->mutex);
+    queue->running = false;
+    pthread_cond_signal(&queue->queued);
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_join(queue->writer, NULL);
+
+    pthread_cond_destroy(&queue->drained);
+    pthread_cond_destroy(&queue->queued);
+    pthread_mutex_destroy(&queue->mutex);
+    parcLogReporter_Release(&queue->reporter);
+    parcMemory_Deallocate(&queue->ring);
+    parcMemory_Deallocate(queuePtr);
+}
+
+static PARCLogReporter *
+_athenaLogReporterAsync_Acquire(const PARCLogReporter *reporter)
+{
+    return parcObject_Acquire(reporter);
+}
+
+static void
+_athenaLogReporterAsync_Release(PARCLogReporter **reporterPtr)
+{
+    // The queue and writer thread live as long as the last reference to the reporter
+    _AthenaLogReporterAsync *queue = parcLogReporter_GetPrivateObject(*reporterPtr);
+    if (parcObject_Release((void **) reporterPtr) == 0) {
+        _athenaLogReporterAsync_Destroy(&queue);
+    }
+}
+
+static void
+_athenaLogReporterAsync_Report(PARCLogReporter *reporter, const PARCLogEntry *entry)
+{
+    _AthenaLogReporterAsync *queue = parcLogReporter_GetPrivateObject(reporter);
+
+    PARCLogEntry *queuedEntry = parcLogEntry_Acquire(entry);
+    if (_athenaLogReporterAsync_Enqueue(queue, queuedEntry) == false) {
+        parcLogEntry_Release(&queuedEntry);
+        __atomic_add_fetch(&queue->dropped, 1, __ATOMIC_RELAXED);
+    }
+}
+
+PARCLogReporter *
+athenaLogReporterAsync_Create(PARCLogReporter *reporter, size_t capacity)
+{
+    assertNotNull(reporter, "Parameter reporter must be non-null");
+    assertTrue(capacity > 0, "Parameter capacity must be greater than zero");
+
+    size_t ringSize = 1;
+    while (ringSize < capacity) {
+        ringSize <<= 1;
+    }
+
+    _AthenaLogReporterAsync *queue = parcMemory_AllocateAndClear(sizeof(_AthenaLogReporterAsync));
+    assertNotNull(queue, "parcMemory_AllocateAndClear failed to create a new asynchronous log queue");
+    queue->ring = parcMemory_AllocateAndClear(ringSize * sizeof(_AthenaLogSlot));
+    assertNotNull(queue->ring, "parcMemory_AllocateAndClear failed to create a log ring of %zu entries", ringSize);
+    queue->capacity = ringSize;
+    queue->mask = ringSize - 1;
+    for (size_t i = 0; i < ringSize; i++) {
+        queue->ring[i].sequence = i;
+    }
+    queue->reporter = parcLogReporter_Acquire(reporter);
+    queue->running = true;
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->queued, NULL);
+    pthread_cond_init(&queue->drained, NULL);
+
+    if (pthread_create(&queue->writer, NULL, _athenaLogReporterAsync_Writer, queue) != 0) {
+        pthread_cond_destroy(&queue->drained);
+        pthread_cond_destroy(&queue->queued);
+        pthread_mutex_destroy(&queue->mutex);
+        parcLogReporter_Release(&queue->reporter);
+        parcMemory_Deallocate(&queue->ring);
+        parcMemory_Deallocate(&queue);
+        return NULL;
+    }
+
+    return parcLogReporter_Create(_athenaLogReporterAsync_Acquire,
+                                  _athenaLogReporterAsync_Release,
+                                  _athenaLogReporterAsync_Report,
+                                  queue);
+}
+
+uint64_t
+athenaLogReporterAsync_GetDroppedCount(const PARCLogReporter *reporter)
+{
+    _AthenaLogReporterAsync *queue = parcLogReporter_GetPrivateObject(reporter);
+    return __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED);
+}
+
+uint64_t
+athenaLogReporterAsync_GetWrittenCount(const PARCLogReporter *reporter)
+{
+    _AthenaLogReporterAsync *queue = parcLogReporter_GetPrivateObject(reporter);
+    return __atomic_load_n(&queue->written, __ATOMIC_ACQUIRE);
+}
+
+void
+athenaLogReporterAsync_Flush(PARCLogReporter *reporter)
+{
+    _AthenaLogReporterAsync *queue = parcLogReporter_GetPrivateObject(reporter);
+    uint64_t target = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_ACQUIRE);
+
+    pthread_mutex_lock(&queue->mutex);
+    while (__atomic_load_n(&queue->written, __ATOMIC_ACQUIRE) < target) {
+        pthread_cond_wait(&queue->drained, &queue->mutex);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_LogReporterAsync_h
+#define libathena_LogReporterAsync_h
+
+#include <stdint.h>
+
+#include <parc/logging/parc_Log.h>
+#include <parc/logging/parc_LogReporter.h>
+
+//
+// Asynchronous log reporter
+//
+// Wraps an existing PARCLogReporter (e.g. a parcLogReporterFile instance) so that log entries
+// are handed off to a background writer thread through a fixed size, lock-free ring.  The
+// forwarding thread never performs output; if the ring is full the entry is discarded and
+// counted rather than blocking the caller.  The message is formatted by parcLog before it
+// reaches the reporter, so that still happens on the logging thread.
+//
+
+#define AthenaLogReporterAsync_DefaultCapacity 4096
+
+/**
+ * @abstract Wrap a log reporter with an asynchronous queue and writer thread
+ * @discussion
+ *
+ * The returned reporter acquires a reference to the provided reporter and forwards each entry
+ * to it from a dedicated writer thread.  The capacity is rounded up to a power of two.  When the
+ * last reference to the returned reporter is released, all queued entries are written and the
+ * writer thread is joined.
+ *
+ * @param [in] reporter downstream reporter that performs the actual output
+ * @param [in] capacity maximum number of entries that may be queued
+ * @return pointer to a new PARCLogReporter, or NULL if the writer thread could not be started
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCLogReporter *fileReporter = parcLogReporterFile_Create(output);
+ *     PARCLogReporter *reporter = athenaLogReporterAsync_Create(fileReporter, AthenaLogReporterAsync_DefaultCapacity);
+ *     parcLogReporter_Release(&fileReporter);
+ *
+ *     PARCLog *log = parcLog_Create("localhost", "athena", NULL, reporter);
+ *     parcLogReporter_Release(&reporter);
+ * }
+ * @endcode
+ */
+PARCLogReporter *athenaLogReporterAsync_Create(PARCLogReporter *reporter, size_t capacity);
+
+/**
+ * @abstract return the number of entries discarded because the queue was full
+ * @discussion
+ *
+ * @param [in] reporter an asynchronous reporter created by athenaLogReporterAsync_Create
+ * @return number of dropped log entries
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t dropped = athenaLogReporterAsync_GetDroppedCount(reporter);
+ * }
+ * @endcode
+ */
+uint64_t athenaLogReporterAsync_GetDroppedCount(const PARCLogReporter *reporter);
+
+/**
+ * @abstract return the number of entries handed to the downstream reporter
+ * @discussion
+ *
+ * @param [in] reporter an asynchronous reporter created by athenaLogReporterAsync_Create
+ * @return number of written log entries
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t written = athenaLogReporterAsync_GetWrittenCount(reporter);
+ * }
+ * @endcode
+ */
+uint64_t athenaLogReporterAsync_GetWrittenCount(const PARCLogReporter *reporter);
+
+/**
+ * @abstract wait until all entries queued so far have been written
+ * @discussion
+ *
+ * Intended for orderly shutdown and testing, this call blocks the caller.
+ *
+ * @param [in] reporter an asynchronous reporter created by athenaLogReporterAsync_Create
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaLogReporterAsync_Flush(reporter);
+ * }
+ * @endcode
+ */
+void athenaLogReporterAsync_Flush(PARCLogReporter *reporter);
+#endif // libathena_LogReporterAsync_h
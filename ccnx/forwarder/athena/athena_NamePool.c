@@ -0,0 +1,840 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena name interning pool
+ *
+ * Interned names form a tree rooted at the empty name, each node holding one name segment and a
+ * counted reference to its parent.  The nodes are indexed by a single chained hash table keyed on
+ * (parent, segment), the hash of a node being an FNV-1a hash of its segment seeded with the hash of
+ * its parent, so that a name is interned or looked up one segment at a time without composing
+ * its prefixes.
+ *
+ * Lookups don't take the pool lock.  They walk the table inside a read section, and a name found is
+ * acquired by incrementing its reference count only if it is not zero: a name whose count has
+ * dropped to zero is being removed, and the lookup falls back to the lock.  Reference counts are
+ * atomic, and only the release of a last reference takes the lock, to remove the name from the
+ * table and release its reference to its prefix in the same step.  Adding names, removing them and
+ * growing the table are serialized by the lock.
+ *
+ * A removed name or a replaced table is retired rather than freed, as a lookup may still be reading
+ * it.  Read sections are counted per stripe, a reader using the stripe of its thread so that readers
+ * on different threads don't share a cache line, and each count is kept for one of two phases.  Once
+ * AthenaNamePoolRetiredLimit names have been retired, the writer switches phase twice, waiting each
+ * time for the read sections of the previous phase to end, after which no lookup can hold a pointer
+ * to anything retired before the switch, and frees them.
+ *
+ * Growing the table relinks the names into the new table's chains, so a lookup that runs while the
+ * table grows can miss a name.  The table's resize sequence is odd while it is being grown, and a
+ * lookup that misses any part of a name checks that the sequence is even and has not changed before
+ * trusting the miss, or else retries under the lock.  Names found are always right, the segment and
+ * parent of a name never change.
+ *
+ * A batch walks a group of names down the tree together, one level per round.  Each round makes
+ * three passes over the names still descending: the first hashes their next segment and prefetches
+ * its bucket, the second prefetches the first node chained from each bucket, and the third searches
+ * the chains, by which time the lines the search needs are arriving or have arrived.
+ */
+
+#include <config.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/common/ccnx_NameSegment.h>
+
+#include <ccnx/forwarder/athena/athena_NamePool.h>
+#include <ccnx/forwarder/athena/athena_Scratch.h>
+
+#define INITIAL_BUCKET_COUNT 1024   // must be a power of 2
+#define CACHE_LINE_SIZE 64
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME        1099511628211ULL
+
+struct athena_interned_name {
+    AthenaNamePool *pool;
+    AthenaInternedName *parent;       // NULL only for the empty name at the root of the pool
+    AthenaInternedName *nextInBucket; // published atomically, lookups follow it without the lock
+    AthenaInternedName *nextRetired;
+    uint64_t hashCode;
+    size_t references;                // atomic, only dropped to zero under the pool lock
+    size_t segmentCount;
+    CCNxNameLabelType type;
+    size_t length;
+    uint8_t value[];
+};
+
+typedef struct athena_name_pool_table {
+    struct athena_name_pool_table *nextRetired;
+    size_t numBuckets;
+    AthenaInternedName *buckets[];
+} _AthenaNamePoolTable;
+
+typedef struct athena_name_pool_readers {
+    size_t active[2];                 // read sections in progress, by phase
+} __attribute__((aligned(CACHE_LINE_SIZE))) _AthenaNamePoolReaders;
+
+struct athena_name_pool {
+    pthread_mutex_t lock;             // serializes adding, removing and retiring names
+    AthenaInternedName *root;
+    _AthenaNamePoolTable *table;      // published atomically
+    uint64_t resizeSequence;          // odd while the table is being grown
+    size_t numNames;
+    size_t sizeInBytes;
+
+    uint64_t phase;                   // read sections are counted in active[phase & 1]
+    AthenaInternedName *retiredNames;
+    _AthenaNamePoolTable *retiredTables;
+    size_t numRetired;
+
+    _AthenaNamePoolReaders *readers;  // AthenaNamePoolReaderStripes, one per cache line
+};
+
+typedef enum {
+    _AthenaNamePoolFind_Exact,
+    _AthenaNamePoolFind_LongestPrefix,
+    _AthenaNamePoolFind_Intern
+} _AthenaNamePoolFind;
+
+static size_t _nextReaderStripe;
+static __thread size_t _readerStripe;  // stripe plus one, zero until the thread first reads
+
+static void _athenaNamePool_Reclaim(AthenaNamePool *pool);
+
+static void
+_athenaNamePool_Finalize(AthenaNamePool **poolPtr)
+{
+    AthenaNamePool *pool = *poolPtr;
+
+    // Every other name holds a reference to the pool, so only the root can remain.
+    assertTrue(pool->numNames == 0, "Name pool finalized with %zu names still interned", pool->numNames);
+
+    // With the last reference gone there can be no lookups left to wait for
+    _athenaNamePool_Reclaim(pool);
+
+    parcMemory_Deallocate(&pool->root);
+    parcMemory_Deallocate(&pool->table);
+    parcMemory_Deallocate(&pool->readers);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+parcObject_ExtendPARCObject(AthenaNamePool, _athenaNamePool_Finalize, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaNamePool, AthenaNamePool);
+
+parcObject_ImplementRelease(athenaNamePool, AthenaNamePool);
+
+static _AthenaNamePoolTable *
+_athenaNamePool_CreateTable(size_t numBuckets)
+{
+    _AthenaNamePoolTable *table = parcMemory_AllocateAndClear(sizeof(_AthenaNamePoolTable) + numBuckets * sizeof(AthenaInternedName *));
+    assertNotNull(table, "parcMemory_AllocateAndClear failed to allocate %zu buckets", numBuckets);
+    table->numBuckets = numBuckets;
+    return table;
+}
+
+AthenaNamePool *
+athenaNamePool_Create(void)
+{
+    AthenaNamePool *pool = parcObject_CreateAndClearInstance(AthenaNamePool);
+    if (pool != NULL) {
+        pthread_mutex_init(&pool->lock, NULL);
+
+        pool->root = parcMemory_AllocateAndClear(sizeof(AthenaInternedName));
+        assertNotNull(pool->root, "parcMemory_AllocateAndClear failed to allocate the root name");
+        pool->root->pool = pool;
+        pool->root->references = 1; // held by the pool itself, never released before the pool
+
+        pool->table = _athenaNamePool_CreateTable(INITIAL_BUCKET_COUNT);
+
+        void *readers = NULL;
+        int result = parcMemory_MemAlign(&readers, CACHE_LINE_SIZE, AthenaNamePoolReaderStripes * sizeof(_AthenaNamePoolReaders));
+        assertTrue(result == 0, "parcMemory_MemAlign failed to allocate %d reader stripes", AthenaNamePoolReaderStripes);
+        memset(readers, 0, AthenaNamePoolReaderStripes * sizeof(_AthenaNamePoolReaders));
+        pool->readers = readers;
+    }
+    return pool;
+}
+
+/*
+ * Read sections
+ */
+
+static size_t
+_athenaNamePool_GetReaderStripe(void)
+{
+    if (_readerStripe == 0) {
+        _readerStripe = (__atomic_fetch_add(&_nextReaderStripe, 1, __ATOMIC_RELAXED) % AthenaNamePoolReaderStripes) + 1;
+    }
+    return _readerStripe - 1;
+}
+
+// Returns the counter to pass to _athenaNamePool_EndRead
+static size_t *
+_athenaNamePool_BeginRead(AthenaNamePool *pool)
+{
+    size_t phase = __atomic_load_n(&pool->phase, __ATOMIC_SEQ_CST) & 1;
+    size_t *active = &pool->readers[_athenaNamePool_GetReaderStripe()].active[phase];
+    __atomic_fetch_add(active, 1, __ATOMIC_SEQ_CST);
+    return active;
+}
+
+static void
+_athenaNamePool_EndRead(size_t *active)
+{
+    __atomic_fetch_sub(active, 1, __ATOMIC_RELEASE);
+}
+
+// Called with the pool locked, never from inside a read section
+static void
+_athenaNamePool_WaitForReaders(AthenaNamePool *pool)
+{
+    for (int flip = 0; flip < 2; flip++) {
+        size_t phase = __atomic_fetch_add(&pool->phase, 1, __ATOMIC_SEQ_CST) & 1;
+        for (size_t stripe = 0; stripe < AthenaNamePoolReaderStripes; stripe++) {
+            while (__atomic_load_n(&pool->readers[stripe].active[phase], __ATOMIC_ACQUIRE) != 0) {
+                sched_yield();
+            }
+        }
+    }
+}
+
+static void
+_athenaNamePool_Reclaim(AthenaNamePool *pool)
+{
+    while (pool->retiredNames != NULL) {
+        AthenaInternedName *name = pool->retiredNames;
+        pool->retiredNames = name->nextRetired;
+        parcMemory_Deallocate(&name);
+    }
+    while (pool->retiredTables != NULL) {
+        _AthenaNamePoolTable *table = pool->retiredTables;
+        pool->retiredTables = table->nextRetired;
+        parcMemory_Deallocate(&table);
+    }
+    pool->numRetired = 0;
+}
+
+// Called with the pool locked
+static void
+_athenaNamePool_ReclaimIfNeeded(AthenaNamePool *pool)
+{
+    if (pool->numRetired >= AthenaNamePoolRetiredLimit) {
+        _athenaNamePool_WaitForReaders(pool);
+        _athenaNamePool_Reclaim(pool);
+    }
+}
+
+/*
+ * Reference counts
+ */
+
+static bool
+_athenaInternedName_AcquireIfLive(AthenaInternedName *name)
+{
+    size_t references = __atomic_load_n(&name->references, __ATOMIC_RELAXED);
+    while (references > 0) {
+        if (__atomic_compare_exchange_n(&name->references, &references, references + 1,
+                                        true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Table
+ */
+
+static uint64_t
+_hashSegment(uint64_t prefixHash, CCNxNameLabelType type, const uint8_t *value, size_t length)
+{
+    uint64_t hash = prefixHash ^ FNV_OFFSET_BASIS;
+    hash = (hash ^ (uint64_t) type) * FNV_PRIME;
+    hash = (hash ^ (uint64_t) length) * FNV_PRIME;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ value[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static AthenaInternedName **
+_athenaNamePool_Bucket(const _AthenaNamePoolTable *table, uint64_t hashCode)
+{
+    return (AthenaInternedName **) &table->buckets[hashCode & (table->numBuckets - 1)];
+}
+
+static AthenaInternedName *
+_athenaNamePool_FindChild(const _AthenaNamePoolTable *table, const AthenaInternedName *parent, uint64_t hashCode,
+                          CCNxNameLabelType type, const uint8_t *value, size_t length)
+{
+    AthenaInternedName *node = __atomic_load_n(_athenaNamePool_Bucket(table, hashCode), __ATOMIC_ACQUIRE);
+    while (node != NULL) {
+        if ((node->hashCode == hashCode) && (node->parent == parent) && (node->type == type) &&
+            (node->length == length) && (memcmp(node->value, value, length) == 0)) {
+            break;
+        }
+        node = __atomic_load_n(&node->nextInBucket, __ATOMIC_ACQUIRE);
+    }
+    return node;
+}
+
+// Called with the pool locked
+static void
+_athenaNamePool_Grow(AthenaNamePool *pool)
+{
+    _AthenaNamePoolTable *oldTable = pool->table;
+    _AthenaNamePoolTable *table = _athenaNamePool_CreateTable(oldTable->numBuckets * 2);
+
+    // Lookups that overlap the relinking distrust their misses
+    __atomic_fetch_add(&pool->resizeSequence, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (size_t i = 0; i < oldTable->numBuckets; i++) {
+        AthenaInternedName *node = oldTable->buckets[i];
+        while (node != NULL) {
+            AthenaInternedName *next = node->nextInBucket;
+            AthenaInternedName **bucket = _athenaNamePool_Bucket(table, node->hashCode);
+            __atomic_store_n(&node->nextInBucket, *bucket, __ATOMIC_RELEASE);
+            *bucket = node;
+            node = next;
+        }
+    }
+
+    __atomic_store_n(&pool->table, table, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&pool->resizeSequence, 1, __ATOMIC_RELEASE);
+
+    oldTable->nextRetired = pool->retiredTables;
+    pool->retiredTables = oldTable;
+    pool->numRetired++;
+}
+
+// Called with the pool locked
+static AthenaInternedName *
+_athenaNamePool_AddChild(AthenaNamePool *pool, AthenaInternedName *parent, uint64_t hashCode,
+                         CCNxNameLabelType type, const uint8_t *value, size_t length)
+{
+    if (pool->numNames >= pool->table->numBuckets) {
+        _athenaNamePool_Grow(pool);
+    }
+
+    AthenaInternedName *node = parcMemory_Allocate(sizeof(AthenaInternedName) + length);
+    assertNotNull(node, "parcMemory_Allocate failed to allocate an interned name");
+
+    node->pool = athenaNamePool_Acquire(pool);
+    node->parent = parent;
+    __atomic_fetch_add(&parent->references, 1, __ATOMIC_RELAXED);
+    node->nextRetired = NULL;
+    node->hashCode = hashCode;
+    node->references = 0;
+    node->segmentCount = parent->segmentCount + 1;
+    node->type = type;
+    node->length = length;
+    memcpy(node->value, value, length);
+
+    AthenaInternedName **bucket = _athenaNamePool_Bucket(pool->table, hashCode);
+    node->nextInBucket = *bucket;
+    __atomic_store_n(bucket, node, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&pool->numNames, pool->numNames + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->sizeInBytes, pool->sizeInBytes + sizeof(AthenaInternedName) + length, __ATOMIC_RELAXED);
+
+    return node;
+}
+
+// Called with the pool locked, the name is retired rather than freed
+static void
+_athenaNamePool_RemoveName(AthenaNamePool *pool, AthenaInternedName *name)
+{
+    AthenaInternedName **link = _athenaNamePool_Bucket(pool->table, name->hashCode);
+    while (*link != name) {
+        link = &(*link)->nextInBucket;
+    }
+    // The name keeps its own link, so a lookup standing on it carries on down the chain
+    __atomic_store_n(link, name->nextInBucket, __ATOMIC_RELEASE);
+
+    name->nextRetired = pool->retiredNames;
+    pool->retiredNames = name;
+    pool->numRetired++;
+
+    __atomic_store_n(&pool->numNames, pool->numNames - 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->sizeInBytes, pool->sizeInBytes - (sizeof(AthenaInternedName) + name->length), __ATOMIC_RELAXED);
+}
+
+/*
+ * Lookups
+ */
+
+typedef struct athena_name_pool_probe {
+    AthenaInternedName *node;         // deepest name found so far
+    size_t depth;                     // segments of the name matched by node
+    size_t segmentCount;
+    uint64_t hashCode;                // of the next segment, below node
+    CCNxNameLabelType type;
+    const uint8_t *value;
+    size_t length;
+} _AthenaNamePoolProbe;
+
+static void
+_athenaNamePool_ReadSegment(_AthenaNamePoolProbe *probe, const CCNxName *name)
+{
+    CCNxNameSegment *segment = ccnxName_GetSegment(name, probe->depth);
+    PARCBuffer *valueBuffer = ccnxNameSegment_GetValue(segment);
+    probe->type = ccnxNameSegment_GetType(segment);
+    probe->length = parcBuffer_Remaining(valueBuffer);
+    probe->value = (probe->length > 0) ? parcBuffer_Overlay(valueBuffer, 0) : NULL;
+    probe->hashCode = _hashSegment(probe->node->hashCode, probe->type, probe->value, probe->length);
+}
+
+// Walks a name down the tree under the lock, interning any missing segments if asked to
+static AthenaInternedName *
+_athenaNamePool_FindLocked(AthenaNamePool *pool, const CCNxName *name, _AthenaNamePoolFind mode)
+{
+    pthread_mutex_lock(&pool->lock);
+
+    _AthenaNamePoolProbe probe = { .node = pool->root, .depth = 0, .segmentCount = ccnxName_GetSegmentCount(name) };
+    AthenaInternedName *node = pool->root;
+    for (; probe.depth < probe.segmentCount; probe.depth++) {
+        _athenaNamePool_ReadSegment(&probe, name);
+        AthenaInternedName *child = _athenaNamePool_FindChild(pool->table, probe.node, probe.hashCode,
+                                                              probe.type, probe.value, probe.length);
+        if (child == NULL) {
+            if (mode == _AthenaNamePoolFind_Intern) {
+                child = _athenaNamePool_AddChild(pool, probe.node, probe.hashCode, probe.type, probe.value, probe.length);
+            } else {
+                if (mode == _AthenaNamePoolFind_Exact) {
+                    node = NULL;
+                }
+                break;
+            }
+        }
+        probe.node = child;
+        node = child;
+    }
+
+    // Every name in the table has a reference while the lock is held
+    if (node != NULL) {
+        __atomic_fetch_add(&node->references, 1, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return node;
+}
+
+/**
+ * Settle a probe walked without the lock.  Returns true with *result set, acquired or NULL, if the
+ * walk can be trusted, or false if the name has to be looked up again under the lock.
+ */
+static bool
+_athenaNamePool_SettleProbe(AthenaNamePool *pool, const _AthenaNamePoolProbe *probe, _AthenaNamePoolFind mode,
+                            uint64_t resizeSequence, AthenaInternedName **result)
+{
+    if (probe->depth < probe->segmentCount) {
+        if (mode == _AthenaNamePoolFind_Intern) {
+            return false;
+        }
+        // A miss can be an artefact of the table growing under the walk
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if ((resizeSequence & 1) || (__atomic_load_n(&pool->resizeSequence, __ATOMIC_RELAXED) != resizeSequence)) {
+            return false;
+        }
+        if (mode == _AthenaNamePoolFind_Exact) {
+            *result = NULL;
+            return true;
+        }
+    }
+    if (_athenaInternedName_AcquireIfLive(probe->node) == false) {
+        return false;
+    }
+    *result = probe->node;
+    return true;
+}
+
+static AthenaInternedName *
+_athenaNamePool_Find(AthenaNamePool *pool, const CCNxName *name, _AthenaNamePoolFind mode)
+{
+    AthenaInternedName *result = NULL;
+
+    size_t *active = _athenaNamePool_BeginRead(pool);
+    uint64_t resizeSequence = __atomic_load_n(&pool->resizeSequence, __ATOMIC_ACQUIRE);
+    const _AthenaNamePoolTable *table = __atomic_load_n(&pool->table, __ATOMIC_ACQUIRE);
+
+    _AthenaNamePoolProbe probe = { .node = pool->root, .depth = 0, .segmentCount = ccnxName_GetSegmentCount(name) };
+    for (; probe.depth < probe.segmentCount; probe.depth++) {
+        _athenaNamePool_ReadSegment(&probe, name);
+        AthenaInternedName *child = _athenaNamePool_FindChild(table, probe.node, probe.hashCode,
+                                                              probe.type, probe.value, probe.length);
+        if (child == NULL) {
+            break;
+        }
+        probe.node = child;
+    }
+
+    bool settled = _athenaNamePool_SettleProbe(pool, &probe, mode, resizeSequence, &result);
+    _athenaNamePool_EndRead(active);
+
+    if (settled == false) {
+        result = _athenaNamePool_FindLocked(pool, name, mode);
+    }
+    return result;
+}
+
+// Called inside a read section, count no more than AthenaNamePoolBatchSize
+static void
+_athenaNamePool_FindGroup(const _AthenaNamePoolTable *table, AthenaInternedName *root, const CCNxName **names, size_t count,
+                          _AthenaNamePoolProbe *probes)
+{
+    size_t descending[AthenaNamePoolBatchSize];
+    size_t numDescending = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        probes[i].node = root;
+        probes[i].depth = 0;
+        probes[i].segmentCount = ccnxName_GetSegmentCount(names[i]);
+        descending[numDescending++] = i;
+    }
+
+    while (numDescending > 0) {
+        size_t numProbing = 0;
+        for (size_t k = 0; k < numDescending; k++) {
+            _AthenaNamePoolProbe *probe = &probes[descending[k]];
+            if (probe->depth < probe->segmentCount) {
+                _athenaNamePool_ReadSegment(probe, names[descending[k]]);
+                __builtin_prefetch(_athenaNamePool_Bucket(table, probe->hashCode));
+                descending[numProbing++] = descending[k];
+            }
+        }
+        numDescending = numProbing;
+
+        for (size_t k = 0; k < numDescending; k++) {
+            const _AthenaNamePoolProbe *probe = &probes[descending[k]];
+            __builtin_prefetch(__atomic_load_n(_athenaNamePool_Bucket(table, probe->hashCode), __ATOMIC_RELAXED));
+        }
+
+        numProbing = 0;
+        for (size_t k = 0; k < numDescending; k++) {
+            _AthenaNamePoolProbe *probe = &probes[descending[k]];
+            AthenaInternedName *child = _athenaNamePool_FindChild(table, probe->node, probe->hashCode,
+                                                                  probe->type, probe->value, probe->length);
+            if (child != NULL) {
+                probe->node = child;
+                probe->depth++;
+                descending[numProbing++] = descending[k];
+            }
+        }
+        numDescending = numProbing;
+    }
+}
+
+static void
+_athenaNamePool_FindBatch(AthenaNamePool *pool, const CCNxName **names, size_t count, _AthenaNamePoolFind mode,
+                          AthenaInternedName **results)
+{
+    _AthenaNamePoolProbe probes[AthenaNamePoolBatchSize];
+    bool settled[AthenaNamePoolBatchSize];
+
+    for (size_t first = 0; first < count; first += AthenaNamePoolBatchSize) {
+        size_t groupSize = ((count - first) < AthenaNamePoolBatchSize) ? (count - first) : AthenaNamePoolBatchSize;
+
+        size_t *active = _athenaNamePool_BeginRead(pool);
+        uint64_t resizeSequence = __atomic_load_n(&pool->resizeSequence, __ATOMIC_ACQUIRE);
+        const _AthenaNamePoolTable *table = __atomic_load_n(&pool->table, __ATOMIC_ACQUIRE);
+
+        _athenaNamePool_FindGroup(table, pool->root, &names[first], groupSize, probes);
+        for (size_t i = 0; i < groupSize; i++) {
+            settled[i] = _athenaNamePool_SettleProbe(pool, &probes[i], mode, resizeSequence, &results[first + i]);
+        }
+        _athenaNamePool_EndRead(active);
+
+        // The lock is only taken outside the read section, as a writer holding it may wait on readers
+        for (size_t i = 0; i < groupSize; i++) {
+            if (settled[i] == false) {
+                results[first + i] = _athenaNamePool_FindLocked(pool, names[first + i], mode);
+            }
+        }
+    }
+}
+
+AthenaInternedName *
+athenaNamePool_Intern(AthenaNamePool *pool, const CCNxName *name)
+{
+    return _athenaNamePool_Find(pool, name, _AthenaNamePoolFind_Intern);
+}
+
+AthenaInternedName *
+athenaNamePool_Lookup(AthenaNamePool *pool, const CCNxName *name)
+{
+    return _athenaNamePool_Find(pool, name, _AthenaNamePoolFind_Exact);
+}
+
+AthenaInternedName *
+athenaNamePool_LookupLongestPrefix(AthenaNamePool *pool, const CCNxName *name)
+{
+    return _athenaNamePool_Find(pool, name, _AthenaNamePoolFind_LongestPrefix);
+}
+
+void
+athenaNamePool_InternBatch(AthenaNamePool *pool, const CCNxName **names, size_t count, AthenaInternedName **results)
+{
+    _athenaNamePool_FindBatch(pool, names, count, _AthenaNamePoolFind_Intern, results);
+}
+
+void
+athenaNamePool_LookupBatch(AthenaNamePool *pool, const CCNxName **names, size_t count, AthenaInternedName **results)
+{
+    _athenaNamePool_FindBatch(pool, names, count, _AthenaNamePoolFind_Exact, results);
+}
+
+void
+athenaNamePool_LookupLongestPrefixBatch(AthenaNamePool *pool, const CCNxName **names, size_t count,
+                                        AthenaInternedName **results)
+{
+    _athenaNamePool_FindBatch(pool, names, count, _AthenaNamePoolFind_LongestPrefix, results);
+}
+
+size_t
+athenaNamePool_GetNumberOfNames(const AthenaNamePool *pool)
+{
+    return __atomic_load_n(&pool->numNames, __ATOMIC_RELAXED);
+}
+
+size_t
+athenaNamePool_GetSizeInBytes(const AthenaNamePool *pool)
+{
+    return __atomic_load_n(&pool->sizeInBytes, __ATOMIC_RELAXED);
+}
+
+AthenaInternedName *
+athenaInternedName_Acquire(const AthenaInternedName *name)
+{
+    AthenaInternedName *result = (AthenaInternedName *) name;
+
+    // The caller holds a reference, so the count can't be at zero
+    __atomic_fetch_add(&result->references, 1, __ATOMIC_RELAXED);
+
+    return result;
+}
+
+void
+athenaInternedName_Release(AthenaInternedName **namePtr)
+{
+    AthenaInternedName *name = *namePtr;
+    AthenaNamePool *pool = name->pool;
+    size_t numRemoved = 0;
+
+    *namePtr = NULL;
+
+    // Only the last reference needs the lock
+    size_t references = __atomic_load_n(&name->references, __ATOMIC_RELAXED);
+    while (references > 1) {
+        if (__atomic_compare_exchange_n(&name->references, &references, references - 1,
+                                        true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+
+    // Releasing the last reference to a name releases its reference to its prefix in turn.
+    pthread_mutex_lock(&pool->lock);
+    while ((name != NULL) && (__atomic_sub_fetch(&name->references, 1, __ATOMIC_ACQ_REL) == 0)) {
+        AthenaInternedName *parent = name->parent;
+        _athenaNamePool_RemoveName(pool, name);
+        numRemoved++;
+        name = parent;
+    }
+    _athenaNamePool_ReclaimIfNeeded(pool);
+    pthread_mutex_unlock(&pool->lock);
+
+    // Each removed name held a reference to the pool, which may be the last one, so these are
+    // released only once the lock is no longer needed.
+    for (size_t i = 0; i < numRemoved; i++) {
+        AthenaNamePool *poolReference = pool;
+        athenaNamePool_Release(&poolReference);
+    }
+}
+
+const AthenaInternedName *
+athenaInternedName_GetPrefix(const AthenaInternedName *name)
+{
+    return name->parent;
+}
+
+size_t
+athenaInternedName_GetSegmentCount(const AthenaInternedName *name)
+{
+    return name->segmentCount;
+}
+
+CCNxName *
+athenaInternedName_CreateName(const AthenaInternedName *name)
+{
+    CCNxName *result = ccnxName_Create();
+
+    if (name->segmentCount > 0) {
+        // Segments are reached from the last to the first
+        const AthenaInternedName **path = parcMemory_Allocate(name->segmentCount * sizeof(AthenaInternedName *));
+        assertNotNull(path, "parcMemory_Allocate failed to allocate %zu segments", name->segmentCount);
+
+        size_t index = name->segmentCount;
+        for (const AthenaInternedName *node = name; node->parent != NULL; node = node->parent) {
+            path[--index] = node;
+        }
+
+        for (size_t i = 0; i < name->segmentCount; i++) {
+            PARCBuffer *value = parcBuffer_Flip(parcBuffer_CreateFromArray(path[i]->value, path[i]->length));
+            CCNxNameSegment *segment = ccnxNameSegment_CreateTypeValue(path[i]->type, value);
+            ccnxName_Append(result, segment);
+            ccnxNameSegment_Release(&segment);
+            parcBuffer_Release(&value);
+        }
+
+        parcMemory_Deallocate(&path);
+    }
+
+    return result;
+}
+
+/*
+ * Table keys
+ */
+
+struct athena_name_key {
+    AthenaInternedName *name;
+    PARCBuffer *restriction;
+};
+
+static void
+_athenaNameKey_Finalize(AthenaNameKey **keyPtr)
+{
+    AthenaNameKey *key = *keyPtr;
+    athenaInternedName_Release(&key->name);
+    if (key->restriction != NULL) {
+        parcBuffer_Release(&key->restriction);
+    }
+}
+
+static AthenaNameKey *
+_athenaNameKey_Copy(const AthenaNameKey *key)
+{
+    // Keys are immutable, a copy can share the name and restriction
+    return athenaNameKey_Create(key->name, key->restriction);
+}
+
+static bool
+_athenaNameKey_Equals(const AthenaNameKey *a, const AthenaNameKey *b)
+{
+    bool result = (a->name == b->name);
+
+    if (result) {
+        if ((a->restriction == NULL) || (b->restriction == NULL)) {
+            result = (a->restriction == b->restriction);
+        } else {
+            result = parcBuffer_Equals(a->restriction, b->restriction);
+        }
+    }
+    return result;
+}
+
+static int
+_athenaNameKey_Compare(const AthenaNameKey *a, const AthenaNameKey *b)
+{
+    int result = 0;
+
+    // The order only has to be consistent, not meaningful
+    if (a->name != b->name) {
+        result = ((uintptr_t) a->name < (uintptr_t) b->name) ? -1 : 1;
+    } else if (a->restriction != b->restriction) {
+        if (a->restriction == NULL) {
+            result = -1;
+        } else if (b->restriction == NULL) {
+            result = 1;
+        } else {
+            result = parcBuffer_Compare(a->restriction, b->restriction);
+        }
+    }
+    return result;
+}
+
+static PARCHashCode
+_athenaNameKey_HashCode(const AthenaNameKey *key)
+{
+    PARCHashCode result = (PARCHashCode) key->name->hashCode;
+    if (key->restriction != NULL) {
+        result = (result * 31) + parcBuffer_HashCode(key->restriction);
+    }
+    return result;
+}
+
+parcObject_ExtendPARCObject(AthenaNameKey,
+                            _athenaNameKey_Finalize,
+                            _athenaNameKey_Copy,
+                            NULL,
+                            _athenaNameKey_Equals,
+                            _athenaNameKey_Compare,
+                            _athenaNameKey_HashCode,
+                            NULL);
+
+parcObject_ImplementAcquire(athenaNameKey, AthenaNameKey);
+
+parcObject_ImplementRelease(athenaNameKey, AthenaNameKey);
+
+AthenaNameKey *
+athenaNameKey_Create(const AthenaInternedName *name, const PARCBuffer *restriction)
+{
+    AthenaNameKey *key = parcObject_CreateInstance(AthenaNameKey);
+    if (key != NULL) {
+        key->name = athenaInternedName_Acquire(name);
+        key->restriction = (restriction != NULL) ? parcBuffer_Acquire(restriction) : NULL;
+    }
+    return key;
+}
+
+AthenaNameKey *
+athenaNameKey_CreateScratch(const AthenaInternedName *name, const PARCBuffer *restriction)
+{
+    // A key only found with, never stored or released, can borrow its name and restriction
+    void *memory = athenaScratch_Allocate(parcObject_TotalSize(sizeof(void *), sizeof(AthenaNameKey)));
+    AthenaNameKey *key = parcObject_Wrap(memory, AthenaNameKey);
+    key->name = (AthenaInternedName *) name;
+    key->restriction = (PARCBuffer *) restriction;
+    return key;
+}
+
+const AthenaInternedName *
+athenaNameKey_GetName(const AthenaNameKey *key)
+{
+    return key->name;
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_NamePool_h
+#define libathena_NamePool_h
+
+#include <ccnx/common/ccnx_Name.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+//
+// Name interning pool
+//
+// A reference counted table of canonical names shared by the PIT, FIB and Content Store.  Each
+// interned name is a single name segment plus a reference to its interned prefix, so names that
+// share a prefix share the storage for it, and a given name is only held once however many tables
+// refer to it.  Two names interned in the same pool are equal if and only if their interned
+// pointers are equal, which lets the tables compare keys without comparing name bytes.
+//
+// The pool may be shared by several threads.  Lookups, and acquiring or releasing a reference that
+// is not a name's last, don't take the pool lock, so threads looking names up don't contend with
+// each other.  Interning a new name and releasing the last reference to one are serialized by the
+// lock.  Interned names hold a reference to their pool.
+//
+// The batch functions walk names a segment at a time in step: the bucket of each name's next
+// segment is hashed and prefetched for every name in a group of AthenaNamePoolBatchSize before any
+// bucket is searched, so that the cache misses of a group overlap rather than each waiting on the
+// one before.
+//
+
+#define AthenaNamePoolBatchSize 16       // names walked in step by the batch functions
+#define AthenaNamePoolReaderStripes 64   // cache lines lookups are counted on, threads share them beyond this
+#define AthenaNamePoolRetiredLimit 256   // names and tables retired before waiting on lookups to free them
+
+struct athena_name_pool;
+typedef struct athena_name_pool AthenaNamePool;
+
+struct athena_interned_name;
+typedef struct athena_interned_name AthenaInternedName;
+
+struct athena_name_key;
+typedef struct athena_name_key AthenaNameKey;
+
+/**
+ * @abstract create an empty name pool
+ *
+ * @return a new pool, or NULL on failure
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaNamePool *pool = athenaNamePool_Create();
+ *     athenaNamePool_Release(&pool);
+ * }
+ * @endcode
+ */
+AthenaNamePool *athenaNamePool_Create(void);
+
+/**
+ * @abstract acquire a reference to a name pool
+ *
+ * @param [in] pool instance to acquire
+ * @return the same pool
+ */
+AthenaNamePool *athenaNamePool_Acquire(const AthenaNamePool *pool);
+
+/**
+ * @abstract release a reference to a name pool
+ * @discussion
+ *
+ * The pool is destroyed once its last reference, including those held by its interned names,
+ * has been released.
+ *
+ * @param [in,out] poolPtr pointer to the pool to release, set to NULL
+ */
+void athenaNamePool_Release(AthenaNamePool **poolPtr);
+
+/**
+ * @abstract intern a name, adding it and any of its prefixes that are not already present
+ *
+ * @param [in] pool the pool to intern into
+ * @param [in] name the name to intern
+ * @return an acquired reference to the interned name, to be released with athenaInternedName_Release
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaInternedName *interned = athenaNamePool_Intern(pool, name);
+ *     athenaInternedName_Release(&interned);
+ * }
+ * @endcode
+ */
+AthenaInternedName *athenaNamePool_Intern(AthenaNamePool *pool, const CCNxName *name);
+
+/**
+ * @abstract find a name that has already been interned
+ * @discussion
+ *
+ * Unlike athenaNamePool_Intern, the pool is not modified.  A name that is not in the pool cannot
+ * be a key in any table using the pool, so a NULL result is a definite miss.
+ *
+ * @param [in] pool the pool to search
+ * @param [in] name the name to find
+ * @return an acquired reference to the interned name, or NULL if it has not been interned
+ */
+AthenaInternedName *athenaNamePool_Lookup(AthenaNamePool *pool, const CCNxName *name);
+
+/**
+ * @abstract find the longest prefix of a name that has been interned
+ * @discussion
+ *
+ * The result may be the name itself, or the empty name if no segment of it has been interned.
+ * Walking the result's prefixes with athenaInternedName_GetPrefix visits every shorter prefix.
+ *
+ * @param [in] pool the pool to search
+ * @param [in] name the name whose prefixes are searched for
+ * @return an acquired reference to the longest interned prefix, never NULL
+ */
+AthenaInternedName *athenaNamePool_LookupLongestPrefix(AthenaNamePool *pool, const CCNxName *name);
+
+/**
+ * @abstract intern a batch of names
+ * @discussion
+ * The same as calling athenaNamePool_Intern on each name in turn, a name repeated in the batch
+ * being interned once and returned for each occurrence.
+ * @param [in] pool the pool to intern into
+ * @param [in] names the names to intern
+ * @param [in] count number of names
+ * @param [out] results filled in with an acquired reference to each interned name
+ * Example:
+ * @code
+ * {
+ *     AthenaInternedName *interned[count];
+ *     athenaNamePool_InternBatch(pool, names, count, interned);
+ *     for (size_t i = 0; i < count; i++) {
+ *         athenaInternedName_Release(&interned[i]);
+ *     }
+ * }
+ * @endcode
+ */
+void athenaNamePool_InternBatch(AthenaNamePool *pool, const CCNxName **names, size_t count, AthenaInternedName **results);
+
+/**
+ * @abstract find a batch of names that have already been interned
+ * @discussion
+ * The same as calling athenaNamePool_Lookup on each name in turn.
+ * @param [in] pool the pool to search
+ * @param [in] names the names to find
+ * @param [in] count number of names
+ * @param [out] results filled in with an acquired reference to each interned name, or NULL if it has not been interned
+ */
+void athenaNamePool_LookupBatch(AthenaNamePool *pool, const CCNxName **names, size_t count, AthenaInternedName **results);
+
+/**
+ * @abstract find the longest interned prefix of each of a batch of names
+ * @discussion
+ * The same as calling athenaNamePool_LookupLongestPrefix on each name in turn.
+ * @param [in] pool the pool to search
+ * @param [in] names the names whose prefixes are searched for
+ * @param [in] count number of names
+ * @param [out] results filled in with an acquired reference to each longest interned prefix, never NULL
+ */
+void athenaNamePool_LookupLongestPrefixBatch(AthenaNamePool *pool, const CCNxName **names, size_t count,
+                                             AthenaInternedName **results);
+
+/**
+ * @abstract return the number of distinct names (including prefixes) held by the pool
+ *
+ * @param [in] pool the pool
+ * @return number of interned names
+ */
+size_t athenaNamePool_GetNumberOfNames(const AthenaNamePool *pool);
+
+/**
+ * @abstract return the memory held by the interned names
+ *
+ * @param [in] pool the pool
+ * @return size in bytes of the interned names, excluding the pool's hash table
+ */
+size_t athenaNamePool_GetSizeInBytes(const AthenaNamePool *pool);
+
+/**
+ * @abstract acquire another reference to an interned name
+ *
+ * @param [in] name interned name
+ * @return the same interned name
+ */
+AthenaInternedName *athenaInternedName_Acquire(const AthenaInternedName *name);
+
+/**
+ * @abstract release a reference to an interned name
+ * @discussion
+ *
+ * A name is removed from its pool when its last reference is released, including the references
+ * held on it as the prefix of longer names.
+ *
+ * @param [in,out] namePtr pointer to the interned name, set to NULL
+ */
+void athenaInternedName_Release(AthenaInternedName **namePtr);
+
+/**
+ * @abstract return the interned name with the last segment removed
+ *
+ * @param [in] name interned name
+ * @return the interned prefix (not acquired), or NULL if name is the empty name
+ */
+const AthenaInternedName *athenaInternedName_GetPrefix(const AthenaInternedName *name);
+
+/**
+ * @abstract return the number of segments in an interned name
+ *
+ * @param [in] name interned name
+ * @return number of name segments
+ */
+size_t athenaInternedName_GetSegmentCount(const AthenaInternedName *name);
+
+/**
+ * @abstract create a CCNxName equal to an interned name
+ *
+ * @param [in] name interned name
+ * @return a new CCNxName, to be released by the caller
+ */
+CCNxName *athenaInternedName_CreateName(const AthenaInternedName *name);
+
+/**
+ * @abstract create a hashable table key from an interned name and an optional restriction
+ * @discussion
+ *
+ * Keys are PARCObjects implementing equals, compare and hashCode so that they can be used in
+ * PARCHashMap and PARCTreeMap.  Names are compared by pointer, so keys must only be compared
+ * with keys whose names were interned in the same pool.  The restriction (a KeyId or content
+ * object hash) is compared by value.
+ *
+ * @param [in] name interned name, acquired by the key
+ * @param [in] restriction optional restriction, acquired by the key, may be NULL
+ * @return a new key
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaNameKey *key = athenaNameKey_Create(interned, keyId);
+ *     parcHashMap_Put(table, key, value);
+ *     athenaNameKey_Release(&key);
+ * }
+ * @endcode
+ */
+AthenaNameKey *athenaNameKey_Create(const AthenaInternedName *name, const PARCBuffer *restriction);
+
+/**
+ * @abstract create a key for looking a name up in a table, in the calling thread's scratch arena
+ * @discussion
+ *
+ * A scratch key costs no allocator call.  It borrows the name and restriction rather than acquiring
+ * them, and it's given back when the scratch arena is rewound, so it must only be used to find,
+ * get or remove entries.  It must not be put into a table, acquired or released.
+ *
+ * @param [in] name interned name, which must outlive the key
+ * @param [in] restriction optional restriction, which must outlive the key, may be NULL
+ * @return a key valid until the scratch arena is rewound past it
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t scratchMark = athenaScratch_Mark();
+ *     AthenaNameKey *key = athenaNameKey_CreateScratch(interned, NULL);
+ *     PARCObject *value = parcHashMap_Get(table, key);
+ *     athenaScratch_Rewind(scratchMark);
+ * }
+ * @endcode
+ */
+AthenaNameKey *athenaNameKey_CreateScratch(const AthenaInternedName *name, const PARCBuffer *restriction);
+
+/**
+ * @abstract acquire a reference to a key
+ *
+ * @param [in] key instance to acquire
+ * @return the same key
+ */
+AthenaNameKey *athenaNameKey_Acquire(const AthenaNameKey *key);
+
+/**
+ * @abstract release a reference to a key
+ *
+ * @param [in,out] keyPtr pointer to the key, set to NULL
+ */
+void athenaNameKey_Release(AthenaNameKey **keyPtr);
+
+/**
+ * @abstract return the interned name of a key
+ *
+ * @param [in] key the key
+ * @return the key's interned name (not acquired)
+ */
+const AthenaInternedName *athenaNameKey_GetName(const AthenaNameKey *key);
+#endif // libathena_NamePool_h
@@ -47,7 +47,10 @@
 #include <parc/algol/parc_Clock.h>
 #include <parc/security/parc_CryptoHash.h>
 
-#define DEFAULT_CAPACITY 100000
+#include <ccnx/forwarder/athena/athena_Scratch.h>
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
+
+#define DEFAULT_CAPACITY AthenaDefaultPITCapacity
 
 static const char *_athenaPIT_Name = "AthenaPIT 20150913";
 
@@ -115,7 +118,7 @@ _time_Get(_Time *time)
  * @brief PIT table entry, vector of links to forward to and expiration
  */
 typedef struct athena_pitEntry {
-    PARCBuffer *key;
+    AthenaNameKey *key;
     CCNxInterest *ccnxMessage;
     PARCBitVector *ingress;
     PARCBitVector *egress; // FIB egress at entry, used to validate return of content on expected link
@@ -128,7 +131,7 @@ _athenaPITEntry_Destroy(_AthenaPITEntry**entryHandle)
 {
     _AthenaPITEntry *entry = *entryHandle;
     if (entry != NULL) {
-        parcBuffer_Release(&entry->key);
+        athenaNameKey_Release(&entry->key);
         ccnxMetaMessage_Release(&entry->ccnxMessage);
         parcBitVector_Release(&entry->ingress);
         parcBitVector_Release(&entry->egress);
@@ -140,19 +143,19 @@ _athenaPITEntry_Destroy(_AthenaPITEntry**entryHandle)
 static bool
 _athenaPITEntry_Equals(const _AthenaPITEntry *a, const _AthenaPITEntry *b)
 {
-    return parcBuffer_Equals(a->key, b->key);
+    return parcObject_Equals(a->key, b->key);
 }
 
 static bool
 _athenaPITEntry_Compare(const _AthenaPITEntry *a, const _AthenaPITEntry *b)
 {
-    return parcBuffer_Compare(a->key, b->key);
+    return parcObject_Compare(a->key, b->key);
 }
 
 static PARCHashCode
 _athenaPITEntry_HashCode(const _AthenaPITEntry *a)
 {
-    return parcBuffer_HashCode(a->key);
+    return parcObject_HashCode(a->key);
 }
 
 parcObject_ExtendPARCObject(_AthenaPITEntry,
@@ -170,7 +173,7 @@ static
 parcObject_ImplementAcquire(_athenaPITEntry, _AthenaPITEntry);
 
 static _AthenaPITEntry *
-_athenaPITEntry_Create(const PARCBuffer *key,
+_athenaPITEntry_Create(const AthenaNameKey *key,
                        const CCNxInterest *message,
                        const PARCBitVector *ingress,
                        const PARCBitVector *egress,
@@ -179,7 +182,7 @@ _athenaPITEntry_Create(const PARCBuffer *key,
 {
     _AthenaPITEntry *entry = parcObject_CreateInstance(_AthenaPITEntry);
     if (entry != NULL) {
-        entry->key = parcBuffer_Acquire(key);
+        entry->key = athenaNameKey_Acquire(key);
         entry->ccnxMessage = ccnxMetaMessage_Acquire(message);
         entry->ingress = parcBitVector_Copy(ingress);
         entry->egress = parcBitVector_Acquire(egress);
@@ -201,6 +204,8 @@ _athenaPITEntry_Age(_AthenaPITEntry *entry, uint64_t now)
 struct athena_pit {
     size_t capacity;
 
+    AthenaNamePool *namePool;
+
     PARCHashMap *entryTable;
 
     PARCList *linkCleanupList;
@@ -226,6 +231,7 @@ _athenaPIT_Destroy(AthenaPIT **pitHandle)
         parcTreeMap_Release(&pit->timeoutTable);
         parcList_Release(&pit->linkCleanupList);
         parcClock_Release(&pit->clock);
+        athenaNamePool_Release(&pit->namePool);
     }
 }
 
@@ -237,10 +243,11 @@ parcObject_ImplementRelease(athenaPIT, AthenaPIT);
 
 
 AthenaPIT *
-athenaPIT_CreateCapacity(size_t capacity)
+athenaPIT_CreateWithNamePool(size_t capacity, AthenaNamePool *namePool)
 {
     AthenaPIT *pit = parcObject_CreateInstance(AthenaPIT);
     if (pit != NULL) {
+        pit->namePool = (namePool != NULL) ? athenaNamePool_Acquire(namePool) : athenaNamePool_Create();
         pit->entryTable = parcHashMap_Create();
         pit->timeoutTable = parcTreeMap_Create();
         pit->linkCleanupList = parcList(parcArrayList_Create((void (*)(void**))parcTreeMap_Release), PARCArrayListAsPARCList);
@@ -259,53 +266,48 @@ athenaPIT_CreateCapacity(size_t capacity)
     return pit;
 }
 
+AthenaPIT *
+athenaPIT_CreateCapacity(size_t capacity)
+{
+    return athenaPIT_CreateWithNamePool(capacity, NULL);
+}
+
 AthenaPIT *
 athenaPIT_Create()
 {
     return athenaPIT_CreateCapacity(DEFAULT_CAPACITY);
 }
 
-// Returns a buffer that is a concatination of a CCNxName and an input buffer
-static PARCBuffer *
-_athenaPIT_createCompoundKey(const CCNxName *name, const PARCBuffer *buffer)
+// Returns the most restrictive key for the interest depending on KeyId
+// Restriction and Content Hash Restriction.  If intern is false and the interest's name
+// has not been interned, there can be no entry for it and NULL is returned.
+static AthenaNameKey *
+_athenaPIT_createInterestKey(const CCNxInterest *interest, AthenaInternedName **internedName)
 {
-    PARCBufferComposer *composer = parcBufferComposer_Create();
-
-    composer = ccnxName_BuildString(name, composer);
-
-    if (buffer != NULL) {
-        parcBufferComposer_PutBuffer(composer, buffer);
+    PARCBuffer *restriction = ccnxInterest_GetContentObjectHashRestriction(interest);
+    if (restriction == NULL) {
+        restriction = ccnxInterest_GetKeyIdRestriction(interest);
     }
 
-    PARCBuffer *key = parcBufferComposer_ProduceBuffer(composer);
+    AthenaNameKey *result = athenaNameKey_Create(*internedName, restriction);
+    athenaInternedName_Release(internedName);
 
-    parcBufferComposer_Release(&composer);
-    return key;
+    return result;
 }
 
-// Returns the most restrictive key for the interest depending on KeyId
-// Restriction and Content Hash Restriction
-static PARCBuffer *
-_athenaPIT_acquireInterestKey(const CCNxInterest *interest)
+static AthenaNameKey *
+_athenaPIT_acquireInterestKey(AthenaPIT *athenaPIT, const CCNxInterest *interest, bool intern)
 {
-    PARCBuffer *result = NULL;
     CCNxName *name = ccnxInterest_GetName(interest);
 
-    PARCBuffer *hash = ccnxInterest_GetContentObjectHashRestriction(interest);
-    if (hash != NULL) {
-        result = _athenaPIT_createCompoundKey(name, hash);
-        return result;
-    }
-
-    PARCBuffer *keyId = ccnxInterest_GetKeyIdRestriction(interest);
-    if (keyId != NULL) {
-        result = _athenaPIT_createCompoundKey(name, keyId);
-        return result;
+    AthenaInternedName *internedName = intern ?
+                                       athenaNamePool_Intern(athenaPIT->namePool, name) :
+                                       athenaNamePool_Lookup(athenaPIT->namePool, name);
+    if (internedName == NULL) {
+        return NULL;
     }
 
-    result = _athenaPIT_createCompoundKey(name, NULL);
-
-    return result;
+    return _athenaPIT_createInterestKey(interest, &internedName);
 }
 
 static void
@@ -375,10 +377,7 @@ _athenaPIT_addInterestToLinkCleanupList(AthenaPIT *athenaPIT, const PARCBitVecto
         }
 
         // Store the interest in the link's hash map
-        PARCBuffer *keyBuffer = _athenaPIT_acquireInterestKey(entry->ccnxMessage);
-        parcTreeMap_Put(entryMap, keyBuffer, entry);
-
-        parcBuffer_Release(&keyBuffer);
+        parcTreeMap_Put(entryMap, entry->key, entry);
     }
 }
 
@@ -409,12 +408,10 @@ _athenaPIT_removeInterestFromCleanupList(AthenaPIT *athenaPIT, const PARCBitVect
 }
 
 static bool
-_athenaPIT_RemoveInterestFromMap(AthenaPIT *athenaPIT, CCNxInterest *interest, const PARCBitVector *link)
+_athenaPIT_RemoveInterestFromMap(AthenaPIT *athenaPIT, const AthenaNameKey *key, const PARCBitVector *link)
 {
     bool result = false;
 
-    PARCBuffer *key = _athenaPIT_acquireInterestKey(interest);
-
     _AthenaPITEntry *entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
 
     if (entry != NULL) {
@@ -430,8 +427,6 @@ _athenaPIT_RemoveInterestFromMap(AthenaPIT *athenaPIT, CCNxInterest *interest, c
         }
     }
 
-    parcBuffer_Release(&key);
-
     return result;
 }
 
@@ -453,10 +448,8 @@ _athenaPIT_PurgeExpired(AthenaPIT *pit)
             _AthenaPITEntry *entry = (_AthenaPITEntry *) parcIterator_Next(it);
             // Necessary because the entry's expiration time may have been increased since being added to the list
             if (_time_Compare(now, entry->expiration) > 0) {
-                _athenaPIT_RemoveInterestFromMap(pit, entry->ccnxMessage, entry->ingress);
-                PARCBuffer *nameKey = _athenaPIT_acquireInterestKey(entry->ccnxMessage);
-                _athenaPIT_removeInterestFromCleanupList(pit, entry->ingress, nameKey);
-                parcBuffer_Release(&nameKey);
+                _athenaPIT_RemoveInterestFromMap(pit, entry->key, entry->ingress);
+                _athenaPIT_removeInterestFromCleanupList(pit, entry->ingress, entry->key);
             }
         }
         parcIterator_Release(&it);
@@ -479,11 +472,13 @@ _athenaPIT_AddLifetimeStat(AthenaPIT *pit, time_t latencyEntry)
     }
 }
 
-AthenaPITResolution
-athenaPIT_AddInterest(AthenaPIT *athenaPIT,
-                      const CCNxInterest *ccnxInterestMessage,
-                      const PARCBitVector *ingressVector,
-                      PARCBitVector **expectedReturnVector)
+// Add an interest given its most restrictive key, which is released
+static AthenaPITResolution
+_athenaPIT_AddInterestWithKey(AthenaPIT *athenaPIT,
+                              const CCNxInterest *ccnxInterestMessage,
+                              const PARCBitVector *ingressVector,
+                              AthenaNameKey *key,
+                              PARCBitVector **expectedReturnVector)
 {
     AthenaPITResolution result = AthenaPITResolution_Error;
 
@@ -492,9 +487,6 @@ athenaPIT_AddInterest(AthenaPIT *athenaPIT,
     uint64_t now = parcClock_GetTime(athenaPIT->clock);
     expiration += now;
 
-    //Get the most restrictive key
-    PARCBuffer *key = _athenaPIT_acquireInterestKey(ccnxInterestMessage);
-
     _AthenaPITEntry *entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
 
     if (entry == NULL) { //New PIT entry
@@ -513,7 +505,8 @@ athenaPIT_AddInterest(AthenaPIT *athenaPIT,
             parcBitVector_Release(&newEgressVector);
 
             parcHashMap_Put(athenaPIT->entryTable, key, newEntry);
-            ++athenaPIT->interestCount;
+            // Counted per ingress link, a refresh issued by the forwarder itself has none
+            athenaPIT->interestCount += parcBitVector_NumberOfBitsSet(ingressVector);
 
             _athenaPIT_addInterestToLinkCleanupList(athenaPIT, ingressVector, newEntry);
             _athenaPIT_addInterestToTimeoutTable(athenaPIT, expiration, newEntry);
@@ -547,7 +540,7 @@ athenaPIT_AddInterest(AthenaPIT *athenaPIT,
         result = AthenaPITResolution_Aggregated;
     }
 
-    parcBuffer_Release(&key);
+    athenaNameKey_Release(&key);
 
     if (entry != NULL) {
         *expectedReturnVector = entry->egress;
@@ -556,6 +549,50 @@ athenaPIT_AddInterest(AthenaPIT *athenaPIT,
     return result;
 }
 
+AthenaPITResolution
+athenaPIT_AddInterest(AthenaPIT *athenaPIT,
+                      const CCNxInterest *ccnxInterestMessage,
+                      const PARCBitVector *ingressVector,
+                      PARCBitVector **expectedReturnVector)
+{
+    //Get the most restrictive key
+    AthenaNameKey *key = _athenaPIT_acquireInterestKey(athenaPIT, ccnxInterestMessage, true);
+
+    return _athenaPIT_AddInterestWithKey(athenaPIT, ccnxInterestMessage, ingressVector, key, expectedReturnVector);
+}
+
+void
+athenaPIT_AddInterestBatch(AthenaPIT *athenaPIT,
+                           const CCNxInterest **ccnxInterestMessages,
+                           const PARCBitVector **ingressVectors,
+                           size_t count,
+                           AthenaPITResolution *results,
+                           PARCBitVector **expectedReturnVectors)
+{
+    const CCNxName *names[AthenaNamePoolBatchSize];
+    AthenaInternedName *internedNames[AthenaNamePoolBatchSize];
+
+    for (size_t first = 0; first < count; first += AthenaNamePoolBatchSize) {
+        size_t groupSize = ((count - first) < AthenaNamePoolBatchSize) ? (count - first) : AthenaNamePoolBatchSize;
+        for (size_t i = 0; i < groupSize; i++) {
+            names[i] = ccnxInterest_GetName(ccnxInterestMessages[first + i]);
+        }
+        athenaNamePool_InternBatch(athenaPIT->namePool, names, groupSize, internedNames);
+
+        // Interests are added in order, so a name repeated in the batch is aggregated as it would be one by one
+        for (size_t i = 0; i < groupSize; i++) {
+            const CCNxInterest *interest = ccnxInterestMessages[first + i];
+            AthenaNameKey *key = _athenaPIT_createInterestKey(interest, &internedNames[i]);
+            PARCBitVector *expectedReturnVector = NULL;
+            results[first + i] = _athenaPIT_AddInterestWithKey(athenaPIT, interest, ingressVectors[first + i],
+                                                               key, &expectedReturnVector);
+            // The entry may be removed by a later interest of the batch making room for itself
+            expectedReturnVectors[first + i] =
+                (expectedReturnVector != NULL) ? parcBitVector_Acquire(expectedReturnVector) : NULL;
+        }
+    }
+}
+
 
 static PARCCryptoHash*
 _createContentObjectHash(const CCNxContentObject *ccnxContentMessage)
@@ -576,9 +613,12 @@ athenaPIT_RemoveInterest(AthenaPIT *athenaPIT,
     assertNotNull(ingressVector, "Parameter ingressVector must not be NULL");
 
     bool result = false;
-    PARCBuffer *key = _athenaPIT_acquireInterestKey(ccnxInterestMessage);
+    AthenaNameKey *key = _athenaPIT_acquireInterestKey(athenaPIT, ccnxInterestMessage, false);
 
-    _AthenaPITEntry *entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
+    _AthenaPITEntry *entry = NULL;
+    if (key != NULL) {
+        entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
+    }
     if (entry != NULL) {
         entry = _athenaPITEntry_Acquire(entry);
 
@@ -603,7 +643,7 @@ athenaPIT_RemoveInterest(AthenaPIT *athenaPIT,
     }
 
     if (key != NULL) {
-        parcBuffer_Release(&key);
+        athenaNameKey_Release(&key);
     }
 
     return result;
@@ -620,8 +660,17 @@ athenaPIT_Match(AthenaPIT *athenaPIT,
 
     CCNxName *name = ccnxContentObject_GetName(ccnxContentMessage);
 
+    // If the name has never been interned there can be no interest for it
+    AthenaInternedName *internedName = athenaNamePool_Lookup(athenaPIT->namePool, name);
+    if (internedName == NULL) {
+        return result;
+    }
+
+    // The keys are only used to find and remove entries, so they're made in the scratch arena
+    size_t scratchMark = athenaScratch_Mark();
+
     // Match based on Name alone
-    PARCBuffer *key = _athenaPIT_createCompoundKey(name, NULL);
+    AthenaNameKey *key = athenaNameKey_CreateScratch(internedName, NULL);
     _AthenaPITEntry *entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
 
     // We have an entry, set the match vector and remove
@@ -636,14 +685,13 @@ athenaPIT_Match(AthenaPIT *athenaPIT,
         _athenaPIT_removeInterestFromTimeoutTable(athenaPIT, entry);
         athenaPIT->interestCount -= parcBitVector_NumberOfBitsSet(result);
     }
-    parcBuffer_Release(&key);
 
 
     // Match based on Name & keyId Restriction
     // A content object may or may not have a keyId
     PARCBuffer *keyId = ccnxContentObject_GetKeyId(ccnxContentMessage);
     if (keyId != NULL) {
-        key = _athenaPIT_createCompoundKey(name, keyId);
+        key = athenaNameKey_CreateScratch(internedName, keyId);
         entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
         if (entry != NULL) {
             uint64_t now = parcClock_GetTime(athenaPIT->clock);
@@ -656,7 +704,6 @@ athenaPIT_Match(AthenaPIT *athenaPIT,
             _athenaPIT_removeInterestFromTimeoutTable(athenaPIT, entry);
             athenaPIT->interestCount -= parcBitVector_NumberOfBitsSet(result);
         }
-        parcBuffer_Release(&key);
     }
 
     // Match based on Name & Content Id Restriction
@@ -665,8 +712,7 @@ athenaPIT_Match(AthenaPIT *athenaPIT,
     // should be hashable. But because locally generated contentObjects are not currently
     // hashable, we need to support this case.
     if (contentId != NULL) {
-        key = _athenaPIT_createCompoundKey(name, parcCryptoHash_GetDigest(contentId));
-        parcCryptoHash_Release(&contentId);
+        key = athenaNameKey_CreateScratch(internedName, parcCryptoHash_GetDigest(contentId));
         entry = (_AthenaPITEntry *) parcHashMap_Get(athenaPIT->entryTable, key);
 
         // We have an entry, set the match vector and remove
@@ -681,8 +727,11 @@ athenaPIT_Match(AthenaPIT *athenaPIT,
             _athenaPIT_removeInterestFromTimeoutTable(athenaPIT, entry);
             athenaPIT->interestCount -= parcBitVector_NumberOfBitsSet(result);
         }
-        parcBuffer_Release(&key);
+        parcCryptoHash_Release(&contentId);
     }
+
+    athenaScratch_Rewind(scratchMark);
+    athenaInternedName_Release(&internedName);
     return result;
 }
 
@@ -706,8 +755,7 @@ athenaPIT_RemoveLink(AthenaPIT *athenaPIT, const PARCBitVector *ccnxLinkVector)
         PARCList*valueList = parcTreeMap_AcquireValues(interestMap);
         for (size_t i = 0; i < parcList_Size(valueList); ++i) {
             _AthenaPITEntry *entry = (_AthenaPITEntry *) parcList_GetAtIndex(valueList, i);
-            CCNxInterest *interest = entry->ccnxMessage;
-            _athenaPIT_RemoveInterestFromMap(athenaPIT, interest, ccnxLinkVector);
+            _athenaPIT_RemoveInterestFromMap(athenaPIT, entry->key, ccnxLinkVector);
             result = true;
         }
         parcList_Release(&valueList);
@@ -720,6 +768,41 @@ athenaPIT_RemoveLink(AthenaPIT *athenaPIT, const PARCBitVector *ccnxLinkVector)
     return result;
 }
 
+size_t
+athenaPIT_RemoveAllPending(AthenaPIT *athenaPIT, AthenaPIT_PendingCallback *pendingCallback, void *context)
+{
+    size_t result = 0;
+
+    // Collect the entries in one pass over the table, then remove them
+    PARCLinkedList *pendingList = parcLinkedList_Create();
+    PARCIterator *it = parcHashMap_CreateValueIterator(athenaPIT->entryTable);
+    while (parcIterator_HasNext(it)) {
+        parcLinkedList_Append(pendingList, parcIterator_Next(it));
+    }
+    parcIterator_Release(&it);
+
+    it = parcLinkedList_CreateIterator(pendingList);
+    while (parcIterator_HasNext(it)) {
+        _AthenaPITEntry *entry = (_AthenaPITEntry *) parcIterator_Next(it);
+
+        // Copied, removing the entry from the link cleanup lists clears its ingress bits
+        PARCBitVector *ingressVector = parcBitVector_Copy(entry->ingress);
+
+        _athenaPIT_removeInterestFromCleanupList(athenaPIT, ingressVector, entry->key);
+        _athenaPIT_removeInterestFromTimeoutTable(athenaPIT, entry);
+        parcHashMap_Remove(athenaPIT->entryTable, entry->key);
+        athenaPIT->interestCount -= parcBitVector_NumberOfBitsSet(ingressVector);
+        result += parcBitVector_NumberOfBitsSet(ingressVector);
+
+        pendingCallback(context, entry->ccnxMessage, ingressVector);
+        parcBitVector_Release(&ingressVector);
+    }
+    parcIterator_Release(&it);
+    parcLinkedList_Release(&pendingList);
+
+    return result;
+}
+
 size_t
 athenaPIT_GetNumberOfTableEntries(const AthenaPIT *athenaPIT)
 {
@@ -743,6 +826,145 @@ athenaPIT_GetMeanEntryLifetime(const AthenaPIT *athenaPIT)
     return result;
 }
 
+/**
+ * @typedef AthenaPITSnapshotEntry
+ * @brief Copy of a PIT entry taken for a snapshot, sharing none of the entry's mutable state
+ */
+typedef struct athena_pitSnapshotEntry {
+    AthenaInternedName *name;
+    PARCBitVector *ingress;
+    int64_t expiresInMillis;
+    uint64_t ageInMillis;
+} _AthenaPITSnapshotEntry;
+
+static void
+_athenaPITSnapshotEntry_Destroy(_AthenaPITSnapshotEntry **entryHandle)
+{
+    _AthenaPITSnapshotEntry *entry = *entryHandle;
+    athenaInternedName_Release(&entry->name);
+    parcBitVector_Release(&entry->ingress);
+}
+
+static PARCJSON *
+_athenaPITSnapshotEntry_ToJSON(const _AthenaPITSnapshotEntry *entry)
+{
+    PARCJSON *json = parcJSON_Create();
+
+    CCNxName *name = athenaInternedName_CreateName(entry->name);
+    char *nameString = ccnxName_ToString(name);
+    parcJSON_AddString(json, "name", nameString);
+    parcMemory_Deallocate(&nameString);
+    ccnxName_Release(&name);
+
+    PARCJSONArray *ingressList = parcJSONArray_Create();
+    for (int bit = parcBitVector_NextBitSet(entry->ingress, 0); bit >= 0; bit = parcBitVector_NextBitSet(entry->ingress, bit + 1)) {
+        PARCJSONValue *linkId = parcJSONValue_CreateFromInteger(bit);
+        parcJSONArray_AddValue(ingressList, linkId);
+        parcJSONValue_Release(&linkId);
+    }
+    parcJSON_AddArray(json, "ingress", ingressList);
+    parcJSONArray_Release(&ingressList);
+
+    parcJSON_AddInteger(json, "expiresInMillis", entry->expiresInMillis);
+    parcJSON_AddInteger(json, "ageInMillis", entry->ageInMillis);
+
+    return json;
+}
+
+parcObject_ExtendPARCObject(_AthenaPITSnapshotEntry, _athenaPITSnapshotEntry_Destroy,
+                            NULL, NULL, NULL, NULL, NULL, _athenaPITSnapshotEntry_ToJSON);
+
+static
+parcObject_ImplementRelease(_athenaPITSnapshotEntry, _AthenaPITSnapshotEntry);
+
+// Copy only what is reported, formatting is left to whoever renders the snapshot
+static void
+_appendToSnapshot(AthenaSnapshot *snapshot, _AthenaPITEntry *entry, uint64_t now)
+{
+    _AthenaPITSnapshotEntry *snapshotEntry = parcObject_CreateInstance(_AthenaPITSnapshotEntry);
+    snapshotEntry->name = athenaInternedName_Acquire(athenaNameKey_GetName(entry->key));
+    snapshotEntry->ingress = parcBitVector_Copy(entry->ingress);
+    snapshotEntry->expiresInMillis = (int64_t) (_time_Get(entry->expiration) - now);
+    snapshotEntry->ageInMillis = _athenaPITEntry_Age(entry, now);
+    athenaSnapshot_Append(snapshot, snapshotEntry);
+    _athenaPITSnapshotEntry_Release(&snapshotEntry);
+}
+
+AthenaSnapshot *
+athenaPIT_CreateSnapshot(AthenaPIT *athenaPIT)
+{
+    uint64_t now = parcClock_GetTime(athenaPIT->clock);
+    AthenaSnapshot *snapshot = athenaSnapshot_Create("pit", parcHashMap_Size(athenaPIT->entryTable));
+
+    PARCIterator *it = parcHashMap_CreateValueIterator(athenaPIT->entryTable);
+    while (parcIterator_HasNext(it)) {
+        _appendToSnapshot(snapshot, (_AthenaPITEntry *) parcIterator_Next(it), now);
+    }
+    parcIterator_Release(&it);
+
+    return snapshot;
+}
+
+/**
+ * @typedef AthenaPITWalk
+ * @brief A snapshot walk through the timeout table, which holds no reference into the PIT between slices
+ */
+struct athena_pitWalk {
+    _Time *lastKey; // expiration whose entries were appended last, NULL before the first slice
+};
+
+AthenaPITWalk *
+athenaPIT_StartSnapshot(AthenaPIT *athenaPIT)
+{
+    AthenaPITWalk *walk = parcMemory_AllocateAndClear(sizeof(AthenaPITWalk));
+    assertNotNull(walk, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(AthenaPITWalk));
+    return walk;
+}
+
+bool
+athenaPIT_ContinueSnapshot(AthenaPIT *athenaPIT, AthenaPITWalk *walk, AthenaSnapshot *snapshot, size_t maxEntries)
+{
+    uint64_t now = parcClock_GetTime(athenaPIT->clock);
+    size_t numAppended = 0;
+
+    _Time *timeKey = (walk->lastKey == NULL) ?
+                     (_Time *) parcTreeMap_FirstKey(athenaPIT->timeoutTable) :
+                     (_Time *) parcTreeMap_HigherKey(athenaPIT->timeoutTable, walk->lastKey);
+    while ((timeKey != NULL) && (numAppended < maxEntries)) {
+        PARCLinkedList *list = (PARCLinkedList *) parcTreeMap_Get(athenaPIT->timeoutTable, timeKey);
+        PARCIterator *it = parcLinkedList_CreateIterator(list);
+        while (parcIterator_HasNext(it)) {
+            _AthenaPITEntry *entry = (_AthenaPITEntry *) parcIterator_Next(it);
+            // The timeout table can still hold entries that have since been removed from the PIT
+            if ((_time_Compare(timeKey, entry->expiration) == 0) &&
+                (parcHashMap_Get(athenaPIT->entryTable, entry->key) == entry)) {
+                _appendToSnapshot(snapshot, entry, now);
+                numAppended++;
+            }
+        }
+        parcIterator_Release(&it);
+
+        if (walk->lastKey == NULL) {
+            walk->lastKey = _time_Create(_time_Get(timeKey));
+        } else {
+            _time_Set(walk->lastKey, _time_Get(timeKey));
+        }
+        timeKey = (_Time *) parcTreeMap_HigherKey(athenaPIT->timeoutTable, walk->lastKey);
+    }
+
+    return (timeKey != NULL);
+}
+
+void
+athenaPIT_StopSnapshot(AthenaPITWalk **walkPtr)
+{
+    AthenaPITWalk *walk = *walkPtr;
+    if (walk->lastKey != NULL) {
+        _time_Release(&walk->lastKey);
+    }
+    parcMemory_Deallocate(walkPtr);
+}
+
 static void
 _getChunkNumberFromName(const CCNxName *name, uint64_t *chunkNum, bool *hasChunkNum)
 {
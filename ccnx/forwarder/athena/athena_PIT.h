@@ -38,6 +38,9 @@
 
 #include <ccnx/transport/common/transport_MetaMessage.h>
 
+#include <ccnx/forwarder/athena/athena_NamePool.h>
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
+
 /*
  * PIT interfaces
  *
@@ -47,6 +50,7 @@
  *    athenaPIT_Match
  *
  *    athenaPIT_AddInterest
+ *    athenaPIT_AddInterestBatch
  *    athenaPIT_RemoveInterest
  *    athenaPIT_RemoveLink
  */
@@ -58,6 +62,13 @@
 struct athena_pit;
 typedef struct athena_pit AthenaPIT;
 
+/**
+ * @typedef AthenaPITWalk
+ * @brief Position of a snapshot walk through the PIT, @see athenaPIT_StartSnapshot
+ */
+struct athena_pitWalk;
+typedef struct athena_pitWalk AthenaPITWalk;
+
 /**
  * @typedef AthenaPITResolution
  * @brief PIT decision resolved during insertion
@@ -106,6 +117,29 @@ AthenaPIT *athenaPIT_Create();
  */
 AthenaPIT *athenaPIT_CreateCapacity(size_t capacity);
 
+/**
+ * @abstract Create a PIT table whose names are interned in the given pool
+ * @discussion
+ *
+ * Sharing a pool with the FIB and Content Store lets them hold a single copy of names they have
+ * in common.  If namePool is NULL the PIT creates a pool of its own.
+ *
+ * @param [in] capacity - PIT entry limit
+ * @param [in] namePool - pool to intern interest names in, may be NULL
+ *
+ * @return pointer to a PIT instance
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaNamePool *namePool = athenaNamePool_Create();
+ *     AthenaPIT *athenaPIT = athenaPIT_CreateWithNamePool(1000000, namePool);
+ *     athenaNamePool_Release(&namePool);
+ * }
+ * @endcode
+ */
+AthenaPIT *athenaPIT_CreateWithNamePool(size_t capacity, AthenaNamePool *namePool);
+
 
 /**
  * @abstract Release a PIT
@@ -147,6 +181,44 @@ AthenaPITResolution athenaPIT_AddInterest(AthenaPIT *athenaPIT,
                                           const PARCBitVector *ingressVector,
                                           PARCBitVector **expectedReturnVector);
 
+/**
+ * @abstract Add a batch of interests to the PIT
+ * @discussion
+ *
+ * The same as calling athenaPIT_AddInterest for each interest in turn, except that the interests'
+ * names are interned together (see athenaNamePool_InternBatch), and each expected return vector is
+ * an acquired reference, as an entry added early in the batch may be purged to make room for a
+ * later one.  Only the name pool step is batched, the table updates that follow are made one
+ * interest at a time.  The forwarder handles one message at a time and does not call this yet.
+ *
+ * @param [in] athenaPIT
+ * @param [in] ccnxInterestMessages interests to add
+ * @param [in] ingressVectors link each interest arrived on
+ * @param [in] count number of interests
+ * @param [out] results resolution of each interest, as returned by athenaPIT_AddInterest
+ * @param [out] expectedReturnVectors acquired expected return vector of each interest, NULL if it was not added
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaPITResolution results[count];
+ *     PARCBitVector *expectedReturnVectors[count];
+ *     athenaPIT_AddInterestBatch(athenaPIT, interests, ingressVectors, count, results, expectedReturnVectors);
+ *     for (size_t i = 0; i < count; i++) {
+ *         if (expectedReturnVectors[i]) {
+ *             parcBitVector_Release(&expectedReturnVectors[i]);
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+void athenaPIT_AddInterestBatch(AthenaPIT *athenaPIT,
+                                const CCNxInterest **ccnxInterestMessages,
+                                const PARCBitVector **ingressVectors,
+                                size_t count,
+                                AthenaPITResolution *results,
+                                PARCBitVector **expectedReturnVectors);
+
 /**
  * @abstract Remove an interest from the PIT
  * @discussion
@@ -216,6 +288,41 @@ PARCBitVector *athenaPIT_Match(AthenaPIT *athenaPIT,
  */
 bool athenaPIT_RemoveLink(AthenaPIT *athenaPIT, const PARCBitVector *ccnxLinkVector);
 
+/**
+ * @typedef AthenaPIT_PendingCallback
+ * @brief called by athenaPIT_RemoveAllPending for each entry removed from the PIT
+ */
+typedef void (AthenaPIT_PendingCallback)(void *context, CCNxInterest *interest, PARCBitVector *ingressVector);
+
+/**
+ * @abstract Remove every pending entry from the PIT, passing each entry's interest and ingress links to a callback
+ * @discussion
+ *
+ * Used when the forwarder is shutting down to answer every outstanding interest instead of
+ * leaving consumers to time out.  The table is walked once, entries are passed in no particular
+ * order.  The interest passed is the one that created the entry, aggregated interests share its
+ * name and restriction.  The callback must acquire anything it keeps.
+ *
+ * @param [in] athenaPIT
+ * @param [in] pendingCallback called for each removed entry
+ * @param [in] context passed to the callback
+ * @return the number of pending interests removed, counting each ingress link of each entry
+ *
+ * Example:
+ * @code
+ * {
+ *     static void
+ *     _answer(void *context, CCNxInterest *interest, PARCBitVector *ingressVector)
+ *     {
+ *         // answer the interest on each of its ingress links
+ *     }
+ *
+ *     size_t numPending = athenaPIT_RemoveAllPending(athenaPIT, _answer, NULL);
+ * }
+ * @endcode
+ */
+size_t athenaPIT_RemoveAllPending(AthenaPIT *athenaPIT, AthenaPIT_PendingCallback *pendingCallback, void *context);
+
 /**
  * @abstract Get the current number of PIT table entries.
  * @discussion
@@ -282,6 +389,80 @@ size_t athenaPIT_GetNumberOfPendingInterests(const AthenaPIT *athenaPIT);
  */
 time_t athenaPIT_GetMeanEntryLifetime(const AthenaPIT *athenaPIT);
 
+/**
+ * @abstract Take a snapshot of the pending interests.
+ * @discussion
+ *
+ * Each entry is copied into the snapshot as its name, the links the interest arrived on and the
+ * milliseconds until it expires and since it was created, rendered as
+ * {"name", "ingress", "expiresInMillis", "ageInMillis"}.  The snapshot shares nothing the PIT
+ * goes on to modify, so it can be rendered later, or on another thread, while the PIT is in use.
+ *
+ * @param [in] athenaPIT
+ *
+ * @return a new snapshot, to be released with athenaSnapshot_Release
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaSnapshot *snapshot = athenaPIT_CreateSnapshot(pit);
+ *     ...
+ *     athenaSnapshot_Release(&snapshot);
+ * }
+ * @endcode
+ */
+AthenaSnapshot *athenaPIT_CreateSnapshot(AthenaPIT *athenaPIT);
+
+/**
+ * @abstract Start a snapshot of the pending interests that is taken a slice at a time.
+ * @discussion
+ *
+ * The walk visits entries in order of expiration and remembers only the last expiration it
+ * reached, so the PIT may change freely between slices.  An entry that is removed before the walk
+ * reaches it is not reported, and one whose lifetime is extended after the walk has passed it may
+ * be reported again at its new expiration.  Entries are copied as by athenaPIT_CreateSnapshot.
+ *
+ * @param [in] athenaPIT
+ *
+ * @return a new walk, to be stopped with athenaPIT_StopSnapshot
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaSnapshot *snapshot = athenaSnapshot_CreatePartial("pit", athenaPIT_GetNumberOfTableEntries(pit));
+ *     AthenaPITWalk *walk = athenaPIT_StartSnapshot(pit);
+ *     while (athenaPIT_ContinueSnapshot(pit, walk, snapshot, 256)) {
+ *         ...
+ *     }
+ *     athenaPIT_StopSnapshot(&walk);
+ *     athenaSnapshot_SetComplete(snapshot);
+ * }
+ * @endcode
+ */
+AthenaPITWalk *athenaPIT_StartSnapshot(AthenaPIT *athenaPIT);
+
+/**
+ * @abstract Append the next slice of pending interests to a snapshot being walked.
+ * @discussion
+ *
+ * Entries sharing an expiration are appended together, so a slice may go a little past maxEntries.
+ *
+ * @param [in] athenaPIT the PIT the walk was started on
+ * @param [in] walk walk in progress
+ * @param [in] snapshot snapshot being filled
+ * @param [in] maxEntries number of entries after which the slice ends
+ *
+ * @return true if the walk has further to go, false once it has been through the whole PIT
+ */
+bool athenaPIT_ContinueSnapshot(AthenaPIT *athenaPIT, AthenaPITWalk *walk, AthenaSnapshot *snapshot, size_t maxEntries);
+
+/**
+ * @abstract Stop a snapshot walk, whether or not it is complete.
+ *
+ * @param [in,out] walkPtr pointer to the walk, set to NULL
+ */
+void athenaPIT_StopSnapshot(AthenaPITWalk **walkPtr);
+
 /**
  * Process a message (e.g. an Interest) addressed to this module. For example, it might be a
  * message asking for a particular statistic or a control message. The response can be NULL,
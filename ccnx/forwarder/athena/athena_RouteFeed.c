@@ -0,0 +1,768 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena route feed
+ *
+ * The feed thread owns the connection to the routing daemon and the table of routes the feed has
+ * installed, a map from prefix to the names of the links it routes to.  Route frames are applied to
+ * that table as they arrive and the difference they make is queued as a list of single link route
+ * changes.  Queued changes are handed to the forwarder a batch at a time through a single slot,
+ * the feed thread waiting for the forwarder to take a batch before handing it the next one.  A full
+ * sync builds a second table and only the difference between the two is queued once it ends.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_ArrayList.h>
+#include <parc/algol/parc_HashMap.h>
+#include <parc/algol/parc_Iterator.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+#include <ccnx/forwarder/athena/athena_RouteFeed.h>
+
+#define AthenaRouteFeedPollMillis 100           // how often the feed thread checks whether it should stop
+
+#define FRAME_LENGTH_SIZE 4
+#define FRAME_HEADER_SIZE 9                     // type and sequence number
+
+//
+// Platform support required for managing SIGPIPE, as in the UDP link module
+//
+#if defined(SO_NOSIGPIPE) // MacOS, BSD
+    #define BSD_IGNORESIGPIPE 1
+#elif defined(MSG_NOSIGNAL) // Primarily Linux
+    #define LINUX_IGNORESIGPIPE 1
+#else
+"Platform not supported";
+#endif
+
+/*
+ * Names of the links a prefix is routed to, never changed once created
+ */
+typedef struct athena_route_feed_links {
+    size_t numLinks;
+    char **linkNames;
+} _AthenaRouteFeedLinks;
+
+typedef struct athena_route_feed_change {
+    bool add;
+    CCNxName *prefix;
+    char *linkName;
+} _AthenaRouteFeedChange;
+
+struct athena_route_feed {
+    char *socketPath;
+    int listenSocket;
+    PARCLog *log;
+    pthread_t thread;
+    bool running;
+
+    // Used by the feed thread only
+    int connection;                   // connection to the routing daemon, -1 if none
+    bool synced;                      // frames are being accepted, false until the next sync begin
+    bool resyncRequested;             // a resync has been sent since frames stopped being accepted
+    uint64_t sequence;                // sequence number of the last frame accepted
+    PARCHashMap *routes;              // prefix to links, as installed
+    PARCHashMap *syncRoutes;          // prefix to links, of the full sync in progress, NULL if none
+    PARCArrayList *changes;           // route changes not yet handed to the forwarder
+    size_t numAcknowledgedRejected;   // rejected changes reported by the last ack
+
+    // Shared with the forwarder, under mutex
+    pthread_mutex_t mutex;
+    pthread_cond_t applied;           // signalled when the forwarder has applied a batch
+    PARCArrayList *batch;             // batch handed to the forwarder, NULL once it has been taken
+    bool applying;                    // the forwarder is applying the batch it took
+    size_t numRejected;               // route additions naming a link that isn't open
+};
+
+static void
+_athenaRouteFeedLinks_Destroy(_AthenaRouteFeedLinks **linksPtr)
+{
+    _AthenaRouteFeedLinks *links = *linksPtr;
+    for (size_t i = 0; i < links->numLinks; i++) {
+        parcMemory_Deallocate(&links->linkNames[i]);
+    }
+    if (links->linkNames) {
+        parcMemory_Deallocate(&links->linkNames);
+    }
+}
+
+parcObject_ExtendPARCObject(_AthenaRouteFeedLinks, _athenaRouteFeedLinks_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static _AthenaRouteFeedLinks *
+_athenaRouteFeedLinks_Create(size_t capacity)
+{
+    _AthenaRouteFeedLinks *links = parcObject_CreateInstance(_AthenaRouteFeedLinks);
+    assertNotNull(links, "Failed to allocate route feed links");
+    links->numLinks = 0;
+    links->linkNames = NULL;
+    if (capacity > 0) {
+        links->linkNames = parcMemory_Allocate(capacity * sizeof(char *));
+        assertNotNull(links->linkNames, "Failed to allocate %zu route feed link names", capacity);
+    }
+    return links;
+}
+
+static bool
+_athenaRouteFeedLinks_Contains(const _AthenaRouteFeedLinks *links, const char *linkName)
+{
+    if (links != NULL) {
+        for (size_t i = 0; i < links->numLinks; i++) {
+            if (strcmp(links->linkNames[i], linkName) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Add a name to links created with room for it, unless it's already there
+static void
+_athenaRouteFeedLinks_Add(_AthenaRouteFeedLinks *links, const char *linkName)
+{
+    if (_athenaRouteFeedLinks_Contains(links, linkName) == false) {
+        links->linkNames[links->numLinks++] = parcMemory_StringDuplicate(linkName, strlen(linkName));
+    }
+}
+
+static void
+_destroyChange(void **changePtr)
+{
+    _AthenaRouteFeedChange *change = (_AthenaRouteFeedChange *) *changePtr;
+    ccnxName_Release(&change->prefix);
+    parcMemory_Deallocate(&change->linkName);
+    parcMemory_Deallocate(changePtr);
+}
+
+//
+// Frame encoding, integers are in network byte order
+//
+
+static uint8_t *
+_put(uint8_t *cursor, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        cursor[i] = (uint8_t) (value >> (8 * (size - 1 - i)));
+    }
+    return cursor + size;
+}
+
+static uint64_t
+_get(const uint8_t *cursor, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value = (value << 8) | cursor[i];
+    }
+    return value;
+}
+
+size_t
+athenaRouteFeed_EncodeFrame(uint8_t *buffer, size_t size, AthenaRouteFeedFrameType type, uint64_t sequence,
+                            const char *prefix, size_t numLinks, const char *linkNames[])
+{
+    size_t length = FRAME_LENGTH_SIZE + FRAME_HEADER_SIZE;
+    if (prefix != NULL) {
+        length += 2 + strlen(prefix) + 2;
+        for (size_t i = 0; i < numLinks; i++) {
+            length += 2 + strlen(linkNames[i]);
+        }
+    }
+    if ((length > size) || (length - FRAME_LENGTH_SIZE > AthenaRouteFeedMaxFrameSize)) {
+        return 0;
+    }
+
+    uint8_t *cursor = _put(buffer, length - FRAME_LENGTH_SIZE, FRAME_LENGTH_SIZE);
+    cursor = _put(cursor, type, 1);
+    cursor = _put(cursor, sequence, 8);
+    if (prefix != NULL) {
+        cursor = _put(cursor, strlen(prefix), 2);
+        memcpy(cursor, prefix, strlen(prefix));
+        cursor = _put(cursor + strlen(prefix), numLinks, 2);
+        for (size_t i = 0; i < numLinks; i++) {
+            cursor = _put(cursor, strlen(linkNames[i]), 2);
+            memcpy(cursor, linkNames[i], strlen(linkNames[i]));
+            cursor += strlen(linkNames[i]);
+        }
+    }
+    return length;
+}
+
+// Decode a length prefixed string, returning NULL if it overruns the end of the frame
+static char *
+_decodeString(const uint8_t **cursor, const uint8_t *end)
+{
+    if (end - *cursor < 2) {
+        return NULL;
+    }
+    size_t length = _get(*cursor, 2);
+    *cursor += 2;
+    if ((size_t) (end - *cursor) < length) {
+        return NULL;
+    }
+    char *string = parcMemory_StringDuplicate((const char *) *cursor, length);
+    *cursor += length;
+    return string;
+}
+
+// Decode the body of a route frame
+static bool
+_decodeRoute(const uint8_t *body, size_t bodyLength, CCNxName **prefix, _AthenaRouteFeedLinks **links)
+{
+    const uint8_t *cursor = body;
+    const uint8_t *end = body + bodyLength;
+
+    char *prefixURI = _decodeString(&cursor, end);
+    if ((prefixURI == NULL) || (end - cursor < 2)) {
+        if (prefixURI) {
+            parcMemory_Deallocate(&prefixURI);
+        }
+        return false;
+    }
+    *prefix = ccnxName_CreateFromURI(prefixURI);
+    parcMemory_Deallocate(&prefixURI);
+    if (*prefix == NULL) {
+        return false;
+    }
+
+    size_t numLinks = _get(cursor, 2);
+    cursor += 2;
+    *links = _athenaRouteFeedLinks_Create(numLinks);
+    for (size_t i = 0; i < numLinks; i++) {
+        char *linkName = _decodeString(&cursor, end);
+        if (linkName == NULL) {
+            break;
+        }
+        _athenaRouteFeedLinks_Add(*links, linkName);
+        parcMemory_Deallocate(&linkName);
+    }
+    if ((cursor != end) || ((*links)->numLinks == 0 && numLinks > 0)) {
+        ccnxName_Release(prefix);
+        parcObject_Release((void **) links);
+        return false;
+    }
+    return true;
+}
+
+//
+// Handing route changes to the forwarder
+//
+
+// Hand the queued changes to the forwarder once it has taken the previous batch
+static void
+_athenaRouteFeed_Submit(AthenaRouteFeed *routeFeed)
+{
+    if (parcArrayList_Size(routeFeed->changes) == 0) {
+        return;
+    }
+    pthread_mutex_lock(&routeFeed->mutex);
+    while ((routeFeed->batch != NULL) && __atomic_load_n(&routeFeed->running, __ATOMIC_ACQUIRE)) {
+        pthread_cond_wait(&routeFeed->applied, &routeFeed->mutex);
+    }
+    if (routeFeed->batch == NULL) {
+        __atomic_store_n(&routeFeed->batch, routeFeed->changes, __ATOMIC_RELEASE);
+        routeFeed->changes = parcArrayList_Create(_destroyChange);
+    }
+    pthread_mutex_unlock(&routeFeed->mutex);
+}
+
+// Hand over the queued changes and wait for the forwarder to have applied them all
+static size_t
+_athenaRouteFeed_Flush(AthenaRouteFeed *routeFeed)
+{
+    _athenaRouteFeed_Submit(routeFeed);
+    pthread_mutex_lock(&routeFeed->mutex);
+    while (((routeFeed->batch != NULL) || routeFeed->applying) && __atomic_load_n(&routeFeed->running, __ATOMIC_ACQUIRE)) {
+        pthread_cond_wait(&routeFeed->applied, &routeFeed->mutex);
+    }
+    size_t numRejected = routeFeed->numRejected;
+    pthread_mutex_unlock(&routeFeed->mutex);
+    return numRejected;
+}
+
+static void
+_athenaRouteFeed_QueueChange(AthenaRouteFeed *routeFeed, bool add, const CCNxName *prefix, const char *linkName)
+{
+    _AthenaRouteFeedChange *change = parcMemory_Allocate(sizeof(_AthenaRouteFeedChange));
+    assertNotNull(change, "Failed to allocate a route feed change");
+    change->add = add;
+    change->prefix = ccnxName_Acquire(prefix);
+    change->linkName = parcMemory_StringDuplicate(linkName, strlen(linkName));
+    parcArrayList_Add(routeFeed->changes, change);
+
+    if (parcArrayList_Size(routeFeed->changes) >= AthenaRouteFeedBatchSize) {
+        _athenaRouteFeed_Submit(routeFeed);
+    }
+}
+
+// Queue the changes taking a prefix from one set of links to another, either may be NULL for none
+static void
+_athenaRouteFeed_QueueDifference(AthenaRouteFeed *routeFeed, const CCNxName *prefix,
+                                 const _AthenaRouteFeedLinks *previous, const _AthenaRouteFeedLinks *next)
+{
+    // New links are added before old ones are deleted so that the prefix stays routed throughout
+    for (size_t i = 0; (next != NULL) && (i < next->numLinks); i++) {
+        if (_athenaRouteFeedLinks_Contains(previous, next->linkNames[i]) == false) {
+            _athenaRouteFeed_QueueChange(routeFeed, true, prefix, next->linkNames[i]);
+        }
+    }
+    for (size_t i = 0; (previous != NULL) && (i < previous->numLinks); i++) {
+        if (_athenaRouteFeedLinks_Contains(next, previous->linkNames[i]) == false) {
+            _athenaRouteFeed_QueueChange(routeFeed, false, prefix, previous->linkNames[i]);
+        }
+    }
+}
+
+size_t
+athenaRouteFeed_Apply(AthenaRouteFeed *routeFeed, AthenaTransportLinkAdapter *adapter, AthenaFIB *fib)
+{
+    if (__atomic_load_n(&routeFeed->batch, __ATOMIC_ACQUIRE) == NULL) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&routeFeed->mutex);
+    PARCArrayList *batch = routeFeed->batch;
+    routeFeed->batch = NULL;
+    routeFeed->applying = true;
+    pthread_mutex_unlock(&routeFeed->mutex);
+
+    size_t numRejected = 0;
+    PARCBitVector *linkVector = parcBitVector_Create();
+    for (size_t i = 0; i < parcArrayList_Size(batch); i++) {
+        _AthenaRouteFeedChange *change = parcArrayList_Get(batch, i);
+        int linkId = athenaTransportLinkAdapter_LinkNameToId(adapter, change->linkName);
+        if (linkId == -1) {
+            // A link that isn't open has no routes to delete
+            numRejected += change->add ? 1 : 0;
+            continue;
+        }
+        parcBitVector_Set(linkVector, linkId);
+        if (change->add) {
+            athenaFIB_AddRoute(fib, change->prefix, linkVector);
+        } else {
+            athenaFIB_DeleteRoute(fib, change->prefix, linkVector);
+        }
+        parcBitVector_Clear(linkVector, linkId);
+    }
+    parcBitVector_Release(&linkVector);
+    size_t numChanges = parcArrayList_Size(batch);
+
+    pthread_mutex_lock(&routeFeed->mutex);
+    routeFeed->numRejected += numRejected;
+    routeFeed->applying = false;
+    pthread_cond_broadcast(&routeFeed->applied);
+    pthread_mutex_unlock(&routeFeed->mutex);
+
+    parcArrayList_Destroy(&batch);
+    return numChanges - numRejected;
+}
+
+//
+// Feed thread
+//
+
+static void
+_athenaRouteFeed_Send(AthenaRouteFeed *routeFeed, const uint8_t *frame, size_t length)
+{
+    while (length > 0) {
+#ifdef LINUX_IGNORESIGPIPE
+        ssize_t writeCount = send(routeFeed->connection, frame, length, MSG_NOSIGNAL);
+#else
+        ssize_t writeCount = send(routeFeed->connection, frame, length, 0);
+#endif
+        if (writeCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            parcLog_Debug(routeFeed->log, "Route feed send failed (%s)", strerror(errno));
+            return; // the connection is dropped when the next read fails
+        }
+        frame += writeCount;
+        length -= writeCount;
+    }
+}
+
+static void
+_athenaRouteFeed_SendAck(AthenaRouteFeed *routeFeed)
+{
+    size_t numRejected = _athenaRouteFeed_Flush(routeFeed);
+
+    uint8_t frame[FRAME_LENGTH_SIZE + FRAME_HEADER_SIZE + 4];
+    size_t length = athenaRouteFeed_EncodeFrame(frame, sizeof(frame), AthenaRouteFeedFrame_Ack, routeFeed->sequence, NULL, 0, NULL);
+    _put(frame, length + 4 - FRAME_LENGTH_SIZE, FRAME_LENGTH_SIZE);
+    _put(frame + length, numRejected - routeFeed->numAcknowledgedRejected, 4);
+    routeFeed->numAcknowledgedRejected = numRejected;
+    _athenaRouteFeed_Send(routeFeed, frame, length + 4);
+}
+
+// Stop accepting frames until the daemon starts a full sync
+static void
+_athenaRouteFeed_Desynchronize(AthenaRouteFeed *routeFeed, const char *reason)
+{
+    parcLog_Warning(routeFeed->log, "Route feed lost synchronization after sequence %llu (%s), requesting a full sync",
+                    (unsigned long long) routeFeed->sequence, reason);
+    routeFeed->synced = false;
+    routeFeed->resyncRequested = true;
+    if (routeFeed->syncRoutes) {
+        parcHashMap_Release(&routeFeed->syncRoutes);
+    }
+
+    uint8_t frame[FRAME_LENGTH_SIZE + FRAME_HEADER_SIZE];
+    size_t length = athenaRouteFeed_EncodeFrame(frame, sizeof(frame), AthenaRouteFeedFrame_Resync, routeFeed->sequence, NULL, 0, NULL);
+    _athenaRouteFeed_Send(routeFeed, frame, length);
+}
+
+// Apply a route frame to the routes being synced, or to the installed routes queueing the changes
+static void
+_athenaRouteFeed_Route(AthenaRouteFeed *routeFeed, AthenaRouteFeedFrameType type, const CCNxName *prefix,
+                       const _AthenaRouteFeedLinks *links)
+{
+    PARCHashMap *routes = routeFeed->syncRoutes ? routeFeed->syncRoutes : routeFeed->routes;
+    const _AthenaRouteFeedLinks *previous = parcHashMap_Get(routes, prefix);
+    size_t numPrevious = previous ? previous->numLinks : 0;
+
+    _AthenaRouteFeedLinks *next = _athenaRouteFeedLinks_Create(numPrevious + links->numLinks);
+    switch (type) {
+        case AthenaRouteFeedFrame_Add:
+            for (size_t i = 0; i < numPrevious; i++) {
+                _athenaRouteFeedLinks_Add(next, previous->linkNames[i]);
+            }
+            for (size_t i = 0; i < links->numLinks; i++) {
+                _athenaRouteFeedLinks_Add(next, links->linkNames[i]);
+            }
+            break;
+        case AthenaRouteFeedFrame_Delete:
+            for (size_t i = 0; (links->numLinks > 0) && (i < numPrevious); i++) {
+                if (_athenaRouteFeedLinks_Contains(links, previous->linkNames[i]) == false) {
+                    _athenaRouteFeedLinks_Add(next, previous->linkNames[i]);
+                }
+            }
+            break;
+        default: // AthenaRouteFeedFrame_Replace
+            for (size_t i = 0; i < links->numLinks; i++) {
+                _athenaRouteFeedLinks_Add(next, links->linkNames[i]);
+            }
+            break;
+    }
+
+    if (routes == routeFeed->routes) {
+        _athenaRouteFeed_QueueDifference(routeFeed, prefix, previous, next);
+    }
+    if (next->numLinks > 0) {
+        parcHashMap_Put(routes, prefix, next);
+    } else if (previous != NULL) {
+        parcHashMap_Remove(routes, prefix);
+    }
+    parcObject_Release((void **) &next);
+}
+
+// Install the routes of a full sync, queueing only the changes from the routes installed before it
+static void
+_athenaRouteFeed_EndSync(AthenaRouteFeed *routeFeed)
+{
+    PARCIterator *iterator = parcHashMap_CreateKeyIterator(routeFeed->routes);
+    while (parcIterator_HasNext(iterator)) {
+        const CCNxName *prefix = parcIterator_Next(iterator);
+        _athenaRouteFeed_QueueDifference(routeFeed, prefix, parcHashMap_Get(routeFeed->routes, prefix),
+                                         parcHashMap_Get(routeFeed->syncRoutes, prefix));
+    }
+    parcIterator_Release(&iterator);
+
+    iterator = parcHashMap_CreateKeyIterator(routeFeed->syncRoutes);
+    while (parcIterator_HasNext(iterator)) {
+        const CCNxName *prefix = parcIterator_Next(iterator);
+        if (parcHashMap_Contains(routeFeed->routes, prefix) == false) {
+            _athenaRouteFeed_QueueDifference(routeFeed, prefix, NULL, parcHashMap_Get(routeFeed->syncRoutes, prefix));
+        }
+    }
+    parcIterator_Release(&iterator);
+
+    parcHashMap_Release(&routeFeed->routes);
+    routeFeed->routes = routeFeed->syncRoutes;
+    routeFeed->syncRoutes = NULL;
+
+    parcLog_Info(routeFeed->log, "Route feed synced %zu prefixes", parcHashMap_Size(routeFeed->routes));
+}
+
+static void
+_athenaRouteFeed_ProcessFrame(AthenaRouteFeed *routeFeed, AthenaRouteFeedFrameType type, uint64_t sequence,
+                              const uint8_t *body, size_t bodyLength)
+{
+    if (type == AthenaRouteFeedFrame_SyncBegin) {
+        if (routeFeed->syncRoutes) {
+            parcHashMap_Release(&routeFeed->syncRoutes);
+        }
+        routeFeed->syncRoutes = parcHashMap_Create();
+        routeFeed->sequence = sequence;
+        routeFeed->synced = true;
+        routeFeed->resyncRequested = false;
+        return;
+    }
+    if (routeFeed->synced == false) {
+        // Ask once for a full sync, frames the daemon sent before it sees the request are ignored
+        if (routeFeed->resyncRequested == false) {
+            _athenaRouteFeed_Desynchronize(routeFeed, "no full sync");
+        }
+        return;
+    }
+    if (sequence != routeFeed->sequence + 1) {
+        _athenaRouteFeed_Desynchronize(routeFeed, "out of sequence");
+        return;
+    }
+
+    switch (type) {
+        case AthenaRouteFeedFrame_Add:
+        case AthenaRouteFeedFrame_Delete:
+        case AthenaRouteFeedFrame_Replace: {
+            CCNxName *prefix;
+            _AthenaRouteFeedLinks *links;
+            if (_decodeRoute(body, bodyLength, &prefix, &links) == false) {
+                _athenaRouteFeed_Desynchronize(routeFeed, "malformed route");
+                return;
+            }
+            routeFeed->sequence = sequence;
+            _athenaRouteFeed_Route(routeFeed, type, prefix, links);
+            ccnxName_Release(&prefix);
+            parcObject_Release((void **) &links);
+            break;
+        }
+        case AthenaRouteFeedFrame_Commit:
+            routeFeed->sequence = sequence;
+            _athenaRouteFeed_SendAck(routeFeed);
+            break;
+        case AthenaRouteFeedFrame_SyncEnd:
+            if (routeFeed->syncRoutes == NULL) {
+                _athenaRouteFeed_Desynchronize(routeFeed, "sync end without sync begin");
+                return;
+            }
+            routeFeed->sequence = sequence;
+            _athenaRouteFeed_EndSync(routeFeed);
+            _athenaRouteFeed_SendAck(routeFeed);
+            break;
+        default:
+            _athenaRouteFeed_Desynchronize(routeFeed, "unexpected frame type");
+            break;
+    }
+}
+
+// Read exactly length bytes from the daemon, false if the connection closed or the feed is stopping
+static bool
+_athenaRouteFeed_Read(AthenaRouteFeed *routeFeed, uint8_t *buffer, size_t length)
+{
+    while (length > 0) {
+        struct pollfd pollfd = { .fd = routeFeed->connection, .events = POLLIN };
+        int result = poll(&pollfd, 1, AthenaRouteFeedPollMillis);
+        if (__atomic_load_n(&routeFeed->running, __ATOMIC_ACQUIRE) == false) {
+            return false;
+        }
+        if (result <= 0) {
+            if ((result == 0) || (errno == EINTR)) {
+                continue;
+            }
+            return false;
+        }
+        ssize_t readCount = read(routeFeed->connection, buffer, length);
+        if (readCount <= 0) {
+            if ((readCount < 0) && (errno == EINTR)) {
+                continue;
+            }
+            return false;
+        }
+        buffer += readCount;
+        length -= readCount;
+    }
+    return true;
+}
+
+static void
+_athenaRouteFeed_Serve(AthenaRouteFeed *routeFeed)
+{
+    uint8_t *frame = parcMemory_Allocate(AthenaRouteFeedMaxFrameSize);
+    assertNotNull(frame, "Failed to allocate a route feed frame buffer");
+
+    // A new daemon has to start with a full sync
+    routeFeed->synced = false;
+    routeFeed->resyncRequested = false;
+    pthread_mutex_lock(&routeFeed->mutex);
+    routeFeed->numAcknowledgedRejected = routeFeed->numRejected;
+    pthread_mutex_unlock(&routeFeed->mutex);
+
+    for (;;) {
+        uint8_t lengthField[FRAME_LENGTH_SIZE];
+        if (_athenaRouteFeed_Read(routeFeed, lengthField, sizeof(lengthField)) == false) {
+            break;
+        }
+        size_t length = _get(lengthField, FRAME_LENGTH_SIZE);
+        if ((length < FRAME_HEADER_SIZE) || (length > AthenaRouteFeedMaxFrameSize)) {
+            parcLog_Error(routeFeed->log, "Route feed frame of %zu bytes, dropping the connection", length);
+            break;
+        }
+        if (_athenaRouteFeed_Read(routeFeed, frame, length) == false) {
+            break;
+        }
+        _athenaRouteFeed_ProcessFrame(routeFeed, frame[0], _get(frame + 1, 8), frame + FRAME_HEADER_SIZE,
+                                      length - FRAME_HEADER_SIZE);
+    }
+
+    // Changes from frames already accepted are applied even though the daemon has gone
+    _athenaRouteFeed_Submit(routeFeed);
+    if (routeFeed->syncRoutes) {
+        parcHashMap_Release(&routeFeed->syncRoutes);
+    }
+    parcMemory_Deallocate(&frame);
+}
+
+static void *
+_athenaRouteFeed_Thread(void *arg)
+{
+    AthenaRouteFeed *routeFeed = (AthenaRouteFeed *) arg;
+
+    while (__atomic_load_n(&routeFeed->running, __ATOMIC_ACQUIRE)) {
+        struct pollfd pollfd = { .fd = routeFeed->listenSocket, .events = POLLIN };
+        if (poll(&pollfd, 1, AthenaRouteFeedPollMillis) <= 0) {
+            continue;
+        }
+        routeFeed->connection = accept(routeFeed->listenSocket, NULL, NULL);
+        if (routeFeed->connection == -1) {
+            continue;
+        }
+#ifdef BSD_IGNORESIGPIPE
+        int on = 1;
+        setsockopt(routeFeed->connection, SOL_SOCKET, SO_NOSIGPIPE, (void *) &on, sizeof(on));
+#endif
+        parcLog_Info(routeFeed->log, "Route feed connected on %s", routeFeed->socketPath);
+        _athenaRouteFeed_Serve(routeFeed);
+        parcLog_Info(routeFeed->log, "Route feed disconnected from %s", routeFeed->socketPath);
+        close(routeFeed->connection);
+        routeFeed->connection = -1;
+    }
+    return NULL;
+}
+
+static void
+_athenaRouteFeed_Destroy(AthenaRouteFeed **routeFeedPtr)
+{
+    AthenaRouteFeed *routeFeed = *routeFeedPtr;
+
+    pthread_mutex_lock(&routeFeed->mutex);
+    bool running = __atomic_exchange_n(&routeFeed->running, false, __ATOMIC_ACQ_REL);
+    pthread_cond_broadcast(&routeFeed->applied);
+    pthread_mutex_unlock(&routeFeed->mutex);
+    if (running) {
+        pthread_join(routeFeed->thread, NULL);
+    }
+
+    close(routeFeed->listenSocket);
+    unlink(routeFeed->socketPath);
+    parcMemory_Deallocate(&routeFeed->socketPath);
+    parcLog_Release(&routeFeed->log);
+
+    if (routeFeed->batch) {
+        parcArrayList_Destroy(&routeFeed->batch);
+    }
+    parcArrayList_Destroy(&routeFeed->changes);
+    parcHashMap_Release(&routeFeed->routes);
+    pthread_cond_destroy(&routeFeed->applied);
+    pthread_mutex_destroy(&routeFeed->mutex);
+}
+
+parcObject_ExtendPARCObject(AthenaRouteFeed, _athenaRouteFeed_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaRouteFeed, AthenaRouteFeed);
+
+parcObject_ImplementRelease(athenaRouteFeed, AthenaRouteFeed);
+
+static int
+_athenaRouteFeed_Listen(const char *socketPath, PARCLog *log)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        parcLog_Error(log, "Route feed socket path %s is too long", socketPath);
+        return -1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket == -1) {
+        parcLog_Error(log, "Unable to create route feed socket (%s)", strerror(errno));
+        return -1;
+    }
+    unlink(socketPath);
+    if ((bind(listenSocket, (struct sockaddr *) &address, sizeof(address)) == -1) || (listen(listenSocket, 1) == -1)) {
+        parcLog_Error(log, "Unable to listen for a route feed on %s (%s)", socketPath, strerror(errno));
+        close(listenSocket);
+        return -1;
+    }
+    return listenSocket;
+}
+
+AthenaRouteFeed *
+athenaRouteFeed_Create(const char *socketPath, PARCLog *log)
+{
+    int listenSocket = _athenaRouteFeed_Listen(socketPath, log);
+    if (listenSocket == -1) {
+        return NULL;
+    }
+
+    AthenaRouteFeed *routeFeed = parcObject_CreateAndClearInstance(AthenaRouteFeed);
+    assertNotNull(routeFeed, "Failed to allocate a route feed");
+    routeFeed->socketPath = parcMemory_StringDuplicate(socketPath, strlen(socketPath));
+    routeFeed->listenSocket = listenSocket;
+    routeFeed->log = parcLog_Acquire(log);
+    routeFeed->connection = -1;
+    routeFeed->routes = parcHashMap_Create();
+    routeFeed->changes = parcArrayList_Create(_destroyChange);
+    pthread_mutex_init(&routeFeed->mutex, NULL);
+    pthread_cond_init(&routeFeed->applied, NULL);
+    routeFeed->running = true;
+
+    if (pthread_create(&routeFeed->thread, NULL, _athenaRouteFeed_Thread, routeFeed) != 0) {
+        parcLog_Error(log, "Unable to start the route feed thread");
+        routeFeed->running = false; // nothing to join
+        athenaRouteFeed_Release(&routeFeed);
+        return NULL;
+    }
+    return routeFeed;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_RouteFeed_h
+#define libathena_RouteFeed_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <parc/logging/parc_Log.h>
+
+#include <ccnx/forwarder/athena/athena_TransportLinkAdapter.h>
+#include <ccnx/forwarder/athena/athena_FIB.h>
+
+//
+// Route feed
+//
+// A route feed lets a local routing daemon stream route changes into a forwarder over a Unix
+// domain socket, rather than sending a control Interest per route.  The daemon connects and sends
+// frames, each of which is a 4 byte length counting the bytes that follow it, a 1 byte frame type,
+// an 8 byte sequence number and the frame's body, all integers in network byte order.  Route frames
+// (add, delete, replace) have a body of
+//
+//     uint16 prefixLength, prefix URI, uint16 numLinks, numLinks * (uint16 nameLength, link name)
+//
+// Add routes the prefix to the links given, delete stops routing it to them, or to every link the
+// feed routes it to if none are given, and replace routes it to exactly the links given.  Every
+// frame's sequence number must follow that of the previous frame, except for sync begin which
+// starts a full sync at any sequence number.  Route frames received between sync begin and sync
+// end describe the daemon's complete route table; once sync end is received the feed makes only
+// the changes needed to get from the routes it had installed to those.  A connection must start
+// with a full sync.
+//
+// The feed thread decodes frames, keeps the routes it has installed and works out the FIB changes
+// each frame needs, handing them to the forwarder in batches of at most AthenaRouteFeedBatchSize
+// changes.  The forwarder applies a batch at a time between messages, see athenaRouteFeed_Apply.
+// Once the changes preceding a commit or sync end have all been applied, the feed answers with an
+// ack frame whose body is a uint32 count of the routes that couldn't be added since the previous
+// ack, because they named a link that isn't open.  A frame that is out of sequence or can't be decoded is answered
+// with a resync frame carrying the sequence number of the last frame accepted, and frames are then
+// ignored until the next sync begin.  Routes installed by a feed outlive the connection that
+// installed them, so a daemon restarting only has to sync again.
+//
+
+#define AthenaRouteFeedBatchSize 256            // most route changes applied by the forwarder at once
+#define AthenaRouteFeedMaxFrameSize 65536       // largest frame accepted, not counting its length
+#define AthenaRouteFeedIntervalMillis 10        // longest a forwarder with a route feed waits for messages
+
+/**
+ * @typedef AthenaRouteFeedFrameType
+ * @brief Types of route feed frames
+ */
+typedef enum {
+    AthenaRouteFeedFrame_Add = 1,
+    AthenaRouteFeedFrame_Delete = 2,
+    AthenaRouteFeedFrame_Replace = 3,
+    AthenaRouteFeedFrame_Commit = 4,
+    AthenaRouteFeedFrame_SyncBegin = 5,
+    AthenaRouteFeedFrame_SyncEnd = 6,
+    AthenaRouteFeedFrame_Ack = 7,               // sent by the forwarder
+    AthenaRouteFeedFrame_Resync = 8             // sent by the forwarder
+} AthenaRouteFeedFrameType;
+
+struct athena_route_feed;
+typedef struct athena_route_feed AthenaRouteFeed;
+
+/**
+ * @abstract listen for a routing daemon on a Unix domain socket
+ * @discussion
+ *
+ * Binds the socket, replacing any file left at its path, and starts the thread serving it.  One
+ * daemon is served at a time.
+ *
+ * @param [in] socketPath path to bind the socket to
+ * @param [in] log to report connections and errors to
+ * @return a new route feed, or NULL if the socket could not be bound
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaRouteFeed *routeFeed = athenaRouteFeed_Create("/var/run/athena.routes", athena->log);
+ *     athenaRouteFeed_Release(&routeFeed);
+ * }
+ * @endcode
+ */
+AthenaRouteFeed *athenaRouteFeed_Create(const char *socketPath, PARCLog *log);
+
+/**
+ * @abstract acquire a reference to a route feed
+ *
+ * @param [in] routeFeed instance to acquire
+ * @return the same route feed
+ */
+AthenaRouteFeed *athenaRouteFeed_Acquire(const AthenaRouteFeed *routeFeed);
+
+/**
+ * @abstract release a route feed, stopping its thread and removing its socket with the last reference
+ *
+ * @param [in,out] routeFeedPtr pointer to the route feed to release, set to NULL
+ */
+void athenaRouteFeed_Release(AthenaRouteFeed **routeFeedPtr);
+
+/**
+ * @abstract apply the next batch of route changes received by a feed
+ * @discussion
+ *
+ * Routes are added to or deleted from the links of the adapter with the names the daemon gave.
+ * Returns immediately if no batch is waiting.  Must be called from the thread running the
+ * forwarder the tables belong to.
+ *
+ * @param [in] routeFeed instance
+ * @param [in] adapter links of the forwarder
+ * @param [in] fib of the forwarder
+ * @return number of route changes applied
+ *
+ * Example:
+ * @code
+ * {
+ *     athena->stats.numRouteFeedChanges += athenaRouteFeed_Apply(routeFeed, athena->athenaTransportLinkAdapter,
+ *                                                                athena->athenaFIB);
+ * }
+ * @endcode
+ */
+size_t athenaRouteFeed_Apply(AthenaRouteFeed *routeFeed, AthenaTransportLinkAdapter *adapter, AthenaFIB *fib);
+
+/**
+ * @abstract encode a route feed frame
+ * @discussion
+ *
+ * For use by routing daemons and tests.  Frames other than route frames have no prefix or links.
+ *
+ * @param [out] buffer to encode the frame into
+ * @param [in] size of the buffer
+ * @param [in] type of the frame
+ * @param [in] sequence number of the frame
+ * @param [in] prefix URI of a route frame, or NULL
+ * @param [in] numLinks number of link names
+ * @param [in] linkNames names of the links of a route frame
+ * @return length of the encoded frame, or 0 if it doesn't fit in the buffer
+ *
+ * Example:
+ * @code
+ * {
+ *     uint8_t frame[AthenaRouteFeedMaxFrameSize];
+ *     const char *linkNames[] = { "upstream" };
+ *     size_t length = athenaRouteFeed_EncodeFrame(frame, sizeof(frame), AthenaRouteFeedFrame_Add, 12,
+ *                                                 "lci:/example", 1, linkNames);
+ *     write(socket, frame, length);
+ * }
+ * @endcode
+ */
+size_t athenaRouteFeed_EncodeFrame(uint8_t *buffer, size_t size, AthenaRouteFeedFrameType type, uint64_t sequence,
+                                   const char *prefix, size_t numLinks, const char *linkNames[]);
+#endif // libathena_RouteFeed_h
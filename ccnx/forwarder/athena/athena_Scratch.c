@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena per-thread scratch arena
+ *
+ * A position in the arena counts the bytes handed out since it was last empty, and is what a mark
+ * records.  The inline buffer covers positions up to AthenaScratchInlineSize.  Each chunk allocated
+ * after it records the position of its first byte, positions skipping whatever was left at the end
+ * of the buffer or chunk before it, so the chunks holding positions at or after a mark are exactly
+ * those to free when rewinding to it.
+ */
+
+#include <config.h>
+
+#include <stdint.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/athena/athena_Scratch.h>
+
+typedef struct athena_scratch_chunk {
+    struct athena_scratch_chunk *previous;
+    size_t start;                 // position of the first byte of the chunk
+    size_t size;
+    size_t used;
+    uint8_t bytes[] __attribute__((aligned(AthenaScratchAlignment)));
+} _AthenaScratchChunk;
+
+typedef struct athena_scratch {
+    uint8_t bytes[AthenaScratchInlineSize] __attribute__((aligned(AthenaScratchAlignment)));
+    size_t used;
+    _AthenaScratchChunk *chunk;   // most recently allocated chunk, NULL while the inline buffer suffices
+} _AthenaScratch;
+
+static __thread _AthenaScratch _scratch;
+
+static size_t
+_position(void)
+{
+    if (_scratch.chunk != NULL) {
+        return _scratch.chunk->start + _scratch.chunk->used;
+    }
+    return _scratch.used;
+}
+
+static void *
+_allocateChunk(size_t length)
+{
+    size_t size = (length > AthenaScratchChunkSize) ? length : AthenaScratchChunkSize;
+
+    void *memory = NULL;
+    int result = parcMemory_MemAlign(&memory, AthenaScratchAlignment, sizeof(_AthenaScratchChunk) + size);
+    assertTrue(result == 0, "Could not allocate a %zu byte scratch chunk", size);
+
+    _AthenaScratchChunk *chunk = memory;
+    chunk->previous = _scratch.chunk;
+    chunk->start = _position();
+    chunk->size = size;
+    chunk->used = length;
+    _scratch.chunk = chunk;
+
+    return chunk->bytes;
+}
+
+void *
+athenaScratch_Allocate(size_t length)
+{
+    length = (length + AthenaScratchAlignment - 1) & ~((size_t) AthenaScratchAlignment - 1);
+
+    _AthenaScratchChunk *chunk = _scratch.chunk;
+    void *result;
+    if (chunk == NULL) {
+        if ((AthenaScratchInlineSize - _scratch.used) < length) {
+            return _allocateChunk(length);
+        }
+        result = &_scratch.bytes[_scratch.used];
+        _scratch.used += length;
+    } else {
+        if ((chunk->size - chunk->used) < length) {
+            return _allocateChunk(length);
+        }
+        result = &chunk->bytes[chunk->used];
+        chunk->used += length;
+    }
+    return result;
+}
+
+size_t
+athenaScratch_Mark(void)
+{
+    return _position();
+}
+
+void
+athenaScratch_Rewind(size_t mark)
+{
+    assertTrue(mark <= _position(), "Scratch arena rewound past mark %zu", mark);
+
+    while ((_scratch.chunk != NULL) && (_scratch.chunk->start >= mark)) {
+        _AthenaScratchChunk *chunk = _scratch.chunk;
+        _scratch.chunk = chunk->previous;
+        parcMemory_Deallocate(&chunk);
+    }
+
+    if (_scratch.chunk != NULL) {
+        _scratch.chunk->used = mark - _scratch.chunk->start;
+    } else {
+        _scratch.used = mark;
+    }
+}
+
+void
+athenaScratch_Reset(void)
+{
+    athenaScratch_Rewind(0);
+}
+
+size_t
+athenaScratch_GetBytesInUse(void)
+{
+    return _position();
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Scratch_h
+#define libathena_Scratch_h
+
+#include <stddef.h>
+
+//
+// Per-thread scratch arena
+//
+// Much of what the forwarding path allocates lives for a single message: the keys composed to look
+// a name up in a table, for instance.  Rather than a round trip through the allocator for each, a
+// thread can take such memory from its scratch arena, which hands out space by advancing a pointer
+// through a buffer kept by the thread, and takes it all back at once.
+//
+// Allocations are made in a stack discipline.  A function takes a mark of the arena before
+// allocating, and rewinds to the mark when it's done with what it allocated, which leaves
+// allocations made before the mark untouched.  The forwarder also resets the arena once it has
+// processed each message, so nothing allocated while handling a message survives it.  Memory from
+// the arena is never freed, or held beyond the rewind.
+//
+// Each thread's arena starts with AthenaScratchInlineSize bytes of thread local storage, so that in
+// the steady state the arena makes no allocator calls at all.  Should a thread need more than that
+// between rewinds, further chunks are allocated as needed and freed again when the arena is rewound
+// to before them.
+//
+
+#define AthenaScratchInlineSize 16384      // bytes of thread local storage per thread
+#define AthenaScratchChunkSize 65536       // minimum size of a chunk allocated once that is used up
+#define AthenaScratchAlignment 16          // alignment of every allocation
+
+/**
+ * @abstract allocate memory from the calling thread's scratch arena
+ * @discussion
+ *
+ * The memory is neither cleared nor freed, it's reused once the arena is rewound to a mark taken
+ * before the allocation.
+ *
+ * @param [in] length number of bytes to allocate
+ * @return memory aligned to AthenaScratchAlignment, valid until the arena is rewound
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t scratchMark = athenaScratch_Mark();
+ *     uint8_t *buffer = athenaScratch_Allocate(length);
+ *     ...
+ *     athenaScratch_Rewind(scratchMark);
+ * }
+ * @endcode
+ */
+void *athenaScratch_Allocate(size_t length);
+
+/**
+ * @abstract return a mark of the calling thread's scratch arena to later rewind it to
+ *
+ * @return the mark
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t scratchMark = athenaScratch_Mark();
+ *     AthenaNameKey *key = athenaNameKey_CreateScratch(name, NULL);
+ *     entry = parcHashMap_Get(table, key);
+ *     athenaScratch_Rewind(scratchMark);
+ * }
+ * @endcode
+ */
+size_t athenaScratch_Mark(void);
+
+/**
+ * @abstract give back everything allocated from the calling thread's scratch arena since a mark was taken
+ * @discussion
+ *
+ * Chunks allocated after the mark are freed.
+ *
+ * @param [in] mark returned by athenaScratch_Mark on the same thread, and not rewound past since
+ */
+void athenaScratch_Rewind(size_t mark);
+
+/**
+ * @abstract give back everything allocated from the calling thread's scratch arena
+ *
+ * Example:
+ * @code
+ * {
+ *     athena_ProcessMessage(athena, ccnxMessage, ingressVector);
+ *     athenaScratch_Reset();
+ * }
+ * @endcode
+ */
+void athenaScratch_Reset(void);
+
+/**
+ * @abstract return the number of bytes in use in the calling thread's scratch arena
+ * @discussion
+ *
+ * The count includes padding for alignment and any space left unused at the end of a chunk.
+ *
+ * @return bytes allocated and not yet given back
+ */
+size_t athenaScratch_GetBytesInUse(void);
+#endif // libathena_Scratch_h
@@ -0,0 +1,689 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#include <ccnx/forwarder/athena/athena.h>
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_DisplayIndented.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_Clock.h>
+
+#include <ccnx/common/ccnx_NameSegment.h>
+
+#include <ccnx/forwarder/athena/athena_ContentStore.h>
+#include <ccnx/forwarder/athena/athena_LRUContentStore.h>
+#include <ccnx/forwarder/athena/athena_ShardedContentStore.h>
+
+#define REBALANCE_INTERVAL 4096     // puts between redistributions of the byte budget
+
+typedef struct athena_sharded_contentstore_shard {
+    pthread_mutex_t lock;
+    AthenaContentStoreImplementation *store; // AthenaLRUContentStore
+    uint64_t lastNumAdds;                    // adds seen at the previous rebalance
+} _AthenaContentStoreShard;
+
+typedef struct AthenaShardedContentStore {
+    PARCClock *wallClock;
+
+    size_t maxSizeInBytes;
+    size_t numShards;
+    size_t shardMask;
+    _AthenaContentStoreShard **shards;
+
+    pthread_mutex_t rebalanceLock;
+    uint64_t *rebalanceWeights;     // one per shard, only used with rebalanceLock held
+    uint64_t numPuts;
+    size_t nextSweptShard;
+} AthenaShardedContentStore;
+
+/*
+ * Each thread keeps a reference to the last content object it was handed by getMatch, releasing it
+ * on its next lookup (or when the thread exits).  This keeps the borrowed result valid while the
+ * caller is forwarding it, even if a concurrent put on another thread evicts it from its shard.
+ */
+static pthread_once_t _heldMatchKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t _heldMatchKey;
+
+static void
+_releaseHeldMatch(void *heldMatch)
+{
+    CCNxContentObject *contentObject = (CCNxContentObject *) heldMatch;
+    ccnxContentObject_Release(&contentObject);
+}
+
+static void
+_createHeldMatchKey(void)
+{
+    pthread_key_create(&_heldMatchKey, _releaseHeldMatch);
+}
+
+static void
+_holdMatch(CCNxContentObject *acquiredMatch)
+{
+    pthread_once(&_heldMatchKeyOnce, _createHeldMatchKey);
+
+    CCNxContentObject *previousMatch = pthread_getspecific(_heldMatchKey);
+    pthread_setspecific(_heldMatchKey, acquiredMatch);
+    if (previousMatch != NULL) {
+        ccnxContentObject_Release(&previousMatch);
+    }
+}
+
+static _AthenaContentStoreShard *
+_getShard(const AthenaShardedContentStore *impl, const CCNxName *name)
+{
+    PARCHashCode hash = ccnxName_HashCode(name);
+    hash ^= (hash >> 17);
+    return impl->shards[hash & impl->shardMask];
+}
+
+static void
+_athenaShardedContentStore_Finalize(AthenaShardedContentStore **instancePtr)
+{
+    assertNotNull(instancePtr, "Parameter must be a non-null pointer to a AthenaShardedContentStore pointer.");
+    AthenaShardedContentStore *impl = *instancePtr;
+
+    // Drop the calling thread's hold, it may refer to an object from this store
+    _holdMatch(NULL);
+
+    for (size_t i = 0; i < impl->numShards; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+        AthenaContentStore_LRUImplementation.release(&shard->store);
+        pthread_mutex_destroy(&shard->lock);
+        parcMemory_Deallocate(&shard);
+    }
+    parcMemory_Deallocate(&impl->shards);
+    parcMemory_Deallocate(&impl->rebalanceWeights);
+    pthread_mutex_destroy(&impl->rebalanceLock);
+    parcClock_Release(&impl->wallClock);
+}
+
+parcObject_ExtendPARCObject(AthenaShardedContentStore,
+                            _athenaShardedContentStore_Finalize,
+                            NULL,   // Copy
+                            NULL,   // ToString
+                            NULL,   // Equals
+                            NULL,   // compare
+                            NULL,   // hashCode
+                            NULL    // toJSON
+                            );
+
+/**
+ * Divide the byte budget among the shards.  Half of the budget is split evenly, so every shard can
+ * always hold some content, the other half in proportion to the number of objects each shard was
+ * asked to store since the previous rebalance.  Shards given less room than they hold are trimmed.
+ */
+static void
+_athenaShardedContentStore_Rebalance(AthenaShardedContentStore *impl, bool wait)
+{
+    if (wait) {
+        pthread_mutex_lock(&impl->rebalanceLock);
+    } else if (pthread_mutex_trylock(&impl->rebalanceLock) != 0) {
+        return; // another thread is already rebalancing
+    }
+
+    uint64_t *weights = impl->rebalanceWeights;
+    uint64_t totalWeight = 0;
+
+    for (size_t i = 0; i < impl->numShards; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+        AthenaLRUContentStoreStats stats;
+
+        pthread_mutex_lock(&shard->lock);
+        athenaLRUContentStore_GetStats(shard->store, &stats);
+        pthread_mutex_unlock(&shard->lock);
+
+        weights[i] = (stats.numAdds - shard->lastNumAdds) + 1;
+        shard->lastNumAdds = stats.numAdds;
+        totalWeight += weights[i];
+    }
+
+    size_t evenShareInBytes = impl->maxSizeInBytes / (2 * impl->numShards);
+    size_t demandShareInBytes = impl->maxSizeInBytes - (evenShareInBytes * impl->numShards);
+
+    for (size_t i = 0; i < impl->numShards; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+        size_t capacityInBytes = evenShareInBytes + (size_t) (((double) demandShareInBytes * weights[i]) / totalWeight);
+
+        pthread_mutex_lock(&shard->lock);
+        athenaLRUContentStore_SetCapacityInBytes(shard->store, capacityInBytes);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    pthread_mutex_unlock(&impl->rebalanceLock);
+}
+
+static AthenaContentStoreImplementation *
+_athenaShardedContentStore_Create(AthenaContentStoreConfig *storeConfig)
+{
+    AthenaShardedContentStoreConfig *config = (AthenaShardedContentStoreConfig *) storeConfig;
+    AthenaShardedContentStore *result = parcObject_CreateAndClearInstance(AthenaShardedContentStore);
+    if (result != NULL) {
+        result->wallClock = parcClock_Wallclock();
+
+        size_t requestedShards = AthenaShardedContentStore_DefaultShardCount;
+        AthenaLRUContentStoreConfig shardConfig = {
+            .capacityInMB       = 0,
+            .evictionPolicy     = AthenaLRUContentStoreEvictionPolicy_LRU,
+            .coldSegmentPercent = 0,
+            .deduplicatePayloads = false,
+            .namePool = NULL
+        };
+        if (config != NULL) {
+            shardConfig.evictionPolicy = config->evictionPolicy;
+            shardConfig.coldSegmentPercent = config->coldSegmentPercent;
+            shardConfig.deduplicatePayloads = config->deduplicatePayloads;
+            if (config->namePool != NULL) {
+                shardConfig.namePool = athenaNamePool_Acquire(config->namePool);
+            }
+            result->maxSizeInBytes = config->capacityInMB * (1024 * 1024); // MB to bytes
+            if (config->numShards > 0) {
+                requestedShards = config->numShards;
+            }
+            if (requestedShards > AthenaShardedContentStore_MaxShardCount) {
+                requestedShards = AthenaShardedContentStore_MaxShardCount;
+            }
+        } else {
+            result->maxSizeInBytes = 10 * (1024 * 1024); // 10 MB default
+        }
+
+        // The shards intern names in one pool rather than one each
+        if (shardConfig.namePool == NULL) {
+            shardConfig.namePool = athenaNamePool_Create();
+        }
+
+        result->numShards = 1;
+        while (result->numShards < requestedShards) {
+            result->numShards <<= 1;
+        }
+        result->shardMask = result->numShards - 1;
+
+        result->shards = parcMemory_AllocateAndClear(result->numShards * sizeof(_AthenaContentStoreShard *));
+        assertNotNull(result->shards, "parcMemory_AllocateAndClear failed to allocate %zu shards", result->numShards);
+        result->rebalanceWeights = parcMemory_AllocateAndClear(result->numShards * sizeof(uint64_t));
+        assertNotNull(result->rebalanceWeights, "parcMemory_AllocateAndClear failed to allocate %zu shard weights", result->numShards);
+
+        for (size_t i = 0; i < result->numShards; i++) {
+            _AthenaContentStoreShard *shard = parcMemory_AllocateAndClear(sizeof(_AthenaContentStoreShard));
+            assertNotNull(shard, "parcMemory_AllocateAndClear failed to allocate a content store shard");
+            pthread_mutex_init(&shard->lock, NULL);
+            shard->store = AthenaContentStore_LRUImplementation.create(&shardConfig);
+            result->shards[i] = shard;
+        }
+
+        // Each shard holds its own reference to the pool
+        athenaNamePool_Release(&shardConfig.namePool);
+
+        pthread_mutex_init(&result->rebalanceLock, NULL);
+        _athenaShardedContentStore_Rebalance(result, true);
+    }
+
+    return (AthenaContentStoreImplementation *) result;
+}
+
+static void
+_athenaShardedContentStore_Release(AthenaContentStoreImplementation **instance)
+{
+    parcObject_Release((PARCObject **) instance);
+}
+
+static bool
+_athenaShardedContentStore_PutContentObject(AthenaContentStoreImplementation *store, const CCNxContentObject *content)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaContentStoreShard *shard = _getShard(impl, ccnxContentObject_GetName(content));
+
+    pthread_mutex_lock(&shard->lock);
+    bool result = AthenaContentStore_LRUImplementation.putContentObject(shard->store, content);
+    pthread_mutex_unlock(&shard->lock);
+
+    if ((__atomic_add_fetch(&impl->numPuts, 1, __ATOMIC_RELAXED) % REBALANCE_INTERVAL) == 0) {
+        _athenaShardedContentStore_Rebalance(impl, false);
+    }
+
+    return result;
+}
+
+static bool
+_athenaShardedContentStore_PutRefresh(AthenaContentStoreImplementation *store, const CCNxContentObject *content)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaContentStoreShard *shard = _getShard(impl, ccnxContentObject_GetName(content));
+
+    pthread_mutex_lock(&shard->lock);
+    bool result = AthenaContentStore_LRUImplementation.putRefresh(shard->store, content);
+    pthread_mutex_unlock(&shard->lock);
+
+    return result;
+}
+
+static CCNxContentObject *
+_athenaShardedContentStore_GetMatch(AthenaContentStoreImplementation *store, const CCNxInterest *interest)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaContentStoreShard *shard = _getShard(impl, ccnxInterest_GetName(interest));
+
+    pthread_mutex_lock(&shard->lock);
+    CCNxContentObject *result = AthenaContentStore_LRUImplementation.getMatch(shard->store, interest);
+    if (result != NULL) {
+        // Must be acquired before the shard is unlocked, after that it may be evicted by another thread
+        result = ccnxContentObject_Acquire(result);
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    _holdMatch(result);
+
+    return result;
+}
+
+static CCNxContentObject *
+_athenaShardedContentStore_GetMatchOrStale(AthenaContentStoreImplementation *store, const CCNxInterest *interest,
+                                           bool *needsRefresh)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaContentStoreShard *shard = _getShard(impl, ccnxInterest_GetName(interest));
+
+    pthread_mutex_lock(&shard->lock);
+    CCNxContentObject *result = AthenaContentStore_LRUImplementation.getMatchOrStale(shard->store, interest, needsRefresh);
+    if (result != NULL) {
+        result = ccnxContentObject_Acquire(result);
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    _holdMatch(result);
+
+    return result;
+}
+
+static bool
+_athenaShardedContentStore_ContainsMatch(AthenaContentStoreImplementation *store, const CCNxInterest *interest)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaContentStoreShard *shard = _getShard(impl, ccnxInterest_GetName(interest));
+
+    pthread_mutex_lock(&shard->lock);
+    bool result = AthenaContentStore_LRUImplementation.containsMatch(shard->store, interest);
+    pthread_mutex_unlock(&shard->lock);
+
+    return result;
+}
+
+/**
+ * Content under a prefix can be in any shard, so every shard is given the window.
+ */
+static bool
+_athenaShardedContentStore_SetStaleWindow(AthenaContentStoreImplementation *store, const CCNxName *prefix,
+                                          uint64_t windowInMillis)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    bool result = true;
+
+    for (size_t i = 0; i < impl->numShards; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        result &= AthenaContentStore_LRUImplementation.setStaleWindow(shard->store, prefix, windowInMillis);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return result;
+}
+
+static bool
+_athenaShardedContentStore_RemoveMatch(AthenaContentStoreImplementation *store, const CCNxName *name,
+                                       const PARCBuffer *keyIdRestriction, const PARCBuffer *contentObjectHash)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaContentStoreShard *shard = _getShard(impl, name);
+
+    pthread_mutex_lock(&shard->lock);
+    bool result = AthenaContentStore_LRUImplementation.removeMatch(shard->store, name, keyIdRestriction, contentObjectHash);
+    pthread_mutex_unlock(&shard->lock);
+
+    return result;
+}
+
+/**
+ * Each sweep starts from the shard after the one the previous sweep started from, so that a shard
+ * with many expired entries doesn't keep the others from being swept.
+ */
+static size_t
+_athenaShardedContentStore_SweepExpired(AthenaContentStoreImplementation *store, size_t maxEntries)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    size_t firstShard = __atomic_fetch_add(&impl->nextSweptShard, 1, __ATOMIC_RELAXED);
+    size_t numRemoved = 0;
+
+    for (size_t i = 0; i < impl->numShards && numRemoved < maxEntries; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[(firstShard + i) & impl->shardMask];
+
+        pthread_mutex_lock(&shard->lock);
+        numRemoved += AthenaContentStore_LRUImplementation.sweepExpired(shard->store, maxEntries - numRemoved);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return numRemoved;
+}
+
+/**
+ * A prefix can have content in any shard.  Each shard is purged under its own lock, and only for
+ * what is left of this slice, so no lock is held for longer than one slice would take.
+ */
+static size_t
+_athenaShardedContentStore_PurgePrefix(AthenaContentStoreImplementation *store, const CCNxName *prefix,
+                                       size_t maxEntries, size_t *bytesFreed)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    size_t numPurged = 0;
+    size_t totalBytesFreed = 0;
+
+    for (size_t i = 0; i < impl->numShards && numPurged < maxEntries; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+        size_t shardBytesFreed = 0;
+
+        pthread_mutex_lock(&shard->lock);
+        numPurged += AthenaContentStore_LRUImplementation.purgePrefix(shard->store, prefix, maxEntries - numPurged, &shardBytesFreed);
+        pthread_mutex_unlock(&shard->lock);
+
+        totalBytesFreed += shardBytesFreed;
+    }
+
+    if (bytesFreed != NULL) {
+        *bytesFreed = totalBytesFreed;
+    }
+    return numPurged;
+}
+
+static size_t
+_athenaShardedContentStore_GetCapacity(AthenaContentStoreImplementation *store)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    return impl->maxSizeInBytes / (1024 * 1024);
+}
+
+static bool
+_athenaShardedContentStore_SetCapacity(AthenaContentStoreImplementation *store, size_t maxSizeInMB)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    impl->maxSizeInBytes = maxSizeInMB * (1024 * 1024);
+
+    _athenaShardedContentStore_Rebalance(impl, true);
+
+    return true;
+}
+
+static void
+_athenaShardedContentStore_GetStats(AthenaShardedContentStore *impl, AthenaLRUContentStoreStats *totals)
+{
+    memset(totals, 0, sizeof(AthenaLRUContentStoreStats));
+
+    for (size_t i = 0; i < impl->numShards; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+        AthenaLRUContentStoreStats stats;
+
+        pthread_mutex_lock(&shard->lock);
+        athenaLRUContentStore_GetStats(shard->store, &stats);
+        pthread_mutex_unlock(&shard->lock);
+
+        totals->numEntries += stats.numEntries;
+        totals->sizeInBytes += stats.sizeInBytes;
+        totals->capacityInBytes += stats.capacityInBytes;
+        totals->numAdds += stats.numAdds;
+        totals->numRemoves += stats.numRemoves;
+        totals->numMatchHits += stats.numMatchHits;
+        totals->numMatchMisses += stats.numMatchMisses;
+        totals->numStaleHits += stats.numStaleHits;
+        totals->numRemovedByLRU += stats.numRemovedByLRU;
+        totals->numRemovedByExpiration += stats.numRemovedByExpiration;
+        totals->removedByExpirationPerSecond += stats.removedByExpirationPerSecond;
+        totals->numRemovedByRCT += stats.numRemovedByRCT;
+        totals->numRemovedByPurge += stats.numRemovedByPurge;
+        totals->numColdEntries += stats.numColdEntries;
+        totals->coldSizeInBytes += stats.coldSizeInBytes;
+        totals->coldCapacityInBytes += stats.coldCapacityInBytes;
+        totals->numCompressed += stats.numCompressed;
+        totals->numIncompressible += stats.numIncompressible;
+        totals->numDecompressed += stats.numDecompressed;
+        totals->bytesBeforeCompression += stats.bytesBeforeCompression;
+        totals->bytesAfterCompression += stats.bytesAfterCompression;
+        totals->compressionTimeInNanos += stats.compressionTimeInNanos;
+        totals->decompressionTimeInNanos += stats.decompressionTimeInNanos;
+        totals->numSharedPayloads += stats.numSharedPayloads;
+        totals->sharedPayloadSizeInBytes += stats.sharedPayloadSizeInBytes;
+        totals->numDeduplicatedEntries += stats.numDeduplicatedEntries;
+        totals->deduplicatedSizeInBytes += stats.deduplicatedSizeInBytes;
+    }
+}
+
+/**
+ * Create a PARCBuffer payload containing a JSON string with the statistics requested by the query,
+ * summed over all of the shards.
+ */
+static PARCBuffer *
+_createStatResponsePayload(AthenaShardedContentStore *impl, const char *queryString)
+{
+    AthenaLRUContentStoreStats stats;
+    _athenaShardedContentStore_GetStats(impl, &stats);
+
+    PARCJSON *json = parcJSON_Create();
+
+    parcJSON_AddString(json, "moduleName", AthenaContentStore_ShardedImplementation.description);
+    parcJSON_AddInteger(json, "time", parcClock_GetTime(impl->wallClock));
+
+    if (strncasecmp(queryString, "size", strlen("size")) == 0) {
+        parcJSON_AddInteger(json, "numEntries", stats.numEntries);
+        parcJSON_AddInteger(json, "sizeInBytes", stats.sizeInBytes);
+        parcJSON_AddInteger(json, "numShards", impl->numShards);
+        parcJSON_AddInteger(json, "numSharedPayloads", stats.numSharedPayloads);
+        parcJSON_AddInteger(json, "sharedPayloadSizeInBytes", stats.sharedPayloadSizeInBytes);
+        parcJSON_AddInteger(json, "numDeduplicatedEntries", stats.numDeduplicatedEntries);
+        parcJSON_AddInteger(json, "deduplicatedSizeInBytes", stats.deduplicatedSizeInBytes);
+    } else if (strncasecmp(queryString, "hits", strlen("hits")) == 0) {
+        parcJSON_AddInteger(json, "numAdds", stats.numAdds);
+        parcJSON_AddInteger(json, "numHits", stats.numMatchHits);
+        parcJSON_AddInteger(json, "numMisses", stats.numMatchMisses);
+        parcJSON_AddInteger(json, "numStaleHits", stats.numStaleHits);
+        parcJSON_AddInteger(json, "numRemovedByExpiration", stats.numRemovedByExpiration);
+        parcJSON_AddInteger(json, "removedByExpirationPerSecond", stats.removedByExpirationPerSecond);
+        parcJSON_AddInteger(json, "numRemovedByPurge", stats.numRemovedByPurge);
+    } else if (strncasecmp(queryString, "compression", strlen("compression")) == 0) {
+        parcJSON_AddInteger(json, "numColdEntries", stats.numColdEntries);
+        parcJSON_AddInteger(json, "coldSizeInBytes", stats.coldSizeInBytes);
+        parcJSON_AddInteger(json, "coldCapacityInBytes", stats.coldCapacityInBytes);
+        parcJSON_AddInteger(json, "numCompressed", stats.numCompressed);
+        parcJSON_AddInteger(json, "numIncompressible", stats.numIncompressible);
+        parcJSON_AddInteger(json, "numDecompressed", stats.numDecompressed);
+        parcJSON_AddInteger(json, "bytesBeforeCompression", stats.bytesBeforeCompression);
+        parcJSON_AddInteger(json, "bytesAfterCompression", stats.bytesAfterCompression);
+        parcJSON_AddInteger(json, "compressionTimeInNanos", stats.compressionTimeInNanos);
+        parcJSON_AddInteger(json, "decompressionTimeInNanos", stats.decompressionTimeInNanos);
+    } else {
+        parcJSON_Release(&json);
+        return NULL;
+    }
+
+    char *jsonString = parcJSON_ToString(json);
+    parcJSON_Release(&json);
+
+    PARCBuffer *result = parcBuffer_CreateFromArray(jsonString, strlen(jsonString));
+    parcMemory_Deallocate(&jsonString);
+
+    return parcBuffer_Flip(result);
+}
+
+static CCNxMetaMessage *
+_athenaShardedContentStore_ProcessMessage(AthenaContentStoreImplementation *store, const CCNxMetaMessage *message)
+{
+    CCNxMetaMessage *result = NULL;
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+
+    if (ccnxMetaMessage_IsInterest(message)) {
+        CCNxInterest *interest = ccnxMetaMessage_GetInterest(message);
+        CCNxName *queryName = ccnxInterest_GetName(interest);
+        PARCBuffer *responsePayload = NULL;
+
+        // Expecting lci:/local/forwarder/ContentStore/stat/<query>
+        if (ccnxName_GetSegmentCount(queryName) > (AthenaCommandSegment + 1)) {
+            char *queryTypeString = ccnxNameSegment_ToString(ccnxName_GetSegment(queryName, AthenaCommandSegment));
+            if (strncasecmp(queryTypeString, "stat", strlen("stat")) == 0) {
+                char *queryString = ccnxNameSegment_ToString(ccnxName_GetSegment(queryName, AthenaCommandSegment + 1));
+                responsePayload = _createStatResponsePayload(impl, queryString);
+                parcMemory_Deallocate(&queryString);
+            }
+            parcMemory_Deallocate(&queryTypeString);
+        }
+
+        if (responsePayload != NULL) {
+            CCNxContentObject *contentObjectResponse = ccnxContentObject_CreateWithDataPayload(queryName, responsePayload);
+            ccnxContentObject_SetExpiryTime(contentObjectResponse,
+                                            parcClock_GetTime(impl->wallClock) + 100); // this response is good for 100 millis
+            result = ccnxMetaMessage_CreateFromContentObject(contentObjectResponse);
+
+            ccnxContentObject_Release(&contentObjectResponse);
+            parcBuffer_Release(&responsePayload);
+        }
+    }
+
+    return result;  // could be NULL
+}
+
+/**
+ * Each shard is copied under its own lock, so a snapshot never stops more than one shard at a
+ * time.  Shards are consistent individually rather than with each other.
+ */
+static void
+_athenaShardedContentStore_Snapshot(AthenaContentStoreImplementation *store, AthenaSnapshot *snapshot)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+
+    for (size_t i = 0; i < impl->numShards; i++) {
+        _AthenaContentStoreShard *shard = impl->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        AthenaContentStore_LRUImplementation.snapshot(shard->store, snapshot);
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+/**
+ * A snapshot walk visits one shard at a time, in shard order, starting each shard's own walk when it gets
+ * to it.  Each slice holds a shard's lock only while it appends that shard's entries.
+ */
+typedef struct athena_sharded_contentstore_walk {
+    size_t shardIndex;                 // shard being walked, numShards once the walk is done
+    AthenaContentStoreWalk *shardWalk; // walk of that shard, NULL until it is started
+} _AthenaShardedContentStoreWalk;
+
+static AthenaContentStoreWalk *
+_athenaShardedContentStore_StartSnapshot(AthenaContentStoreImplementation *store)
+{
+    _AthenaShardedContentStoreWalk *walk = parcMemory_AllocateAndClear(sizeof(_AthenaShardedContentStoreWalk));
+    assertNotNull(walk, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_AthenaShardedContentStoreWalk));
+    return walk;
+}
+
+static bool
+_athenaShardedContentStore_ContinueSnapshot(AthenaContentStoreImplementation *store, AthenaContentStoreWalk *storeWalk,
+                                            AthenaSnapshot *snapshot, size_t maxEntries)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaShardedContentStoreWalk *walk = (_AthenaShardedContentStoreWalk *) storeWalk;
+
+    size_t initialSize = athenaSnapshot_GetSize(snapshot);
+    size_t numAppended = 0;
+    while ((walk->shardIndex < impl->numShards) && (numAppended < maxEntries)) {
+        _AthenaContentStoreShard *shard = impl->shards[walk->shardIndex];
+
+        pthread_mutex_lock(&shard->lock);
+        if (walk->shardWalk == NULL) {
+            walk->shardWalk = AthenaContentStore_LRUImplementation.startSnapshot(shard->store);
+        }
+        bool more = AthenaContentStore_LRUImplementation.continueSnapshot(shard->store, walk->shardWalk, snapshot,
+                                                                          maxEntries - numAppended);
+        if (!more) {
+            AthenaContentStore_LRUImplementation.stopSnapshot(shard->store, &walk->shardWalk);
+        }
+        pthread_mutex_unlock(&shard->lock);
+
+        if (!more) {
+            walk->shardIndex++;
+        }
+        numAppended = athenaSnapshot_GetSize(snapshot) - initialSize;
+    }
+
+    return (walk->shardIndex < impl->numShards);
+}
+
+static void
+_athenaShardedContentStore_StopSnapshot(AthenaContentStoreImplementation *store, AthenaContentStoreWalk **walkPtr)
+{
+    AthenaShardedContentStore *impl = (AthenaShardedContentStore *) store;
+    _AthenaShardedContentStoreWalk *walk = (_AthenaShardedContentStoreWalk *) *walkPtr;
+
+    if (walk->shardWalk != NULL) {
+        _AthenaContentStoreShard *shard = impl->shards[walk->shardIndex];
+        pthread_mutex_lock(&shard->lock);
+        AthenaContentStore_LRUImplementation.stopSnapshot(shard->store, &walk->shardWalk);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    parcMemory_Deallocate(walkPtr);
+}
+
+AthenaContentStoreInterface AthenaContentStore_ShardedImplementation = {
+    .description      = "AthenaContentStore_ShardedImplementation 20151001",
+    .create           = _athenaShardedContentStore_Create,
+    .release          = _athenaShardedContentStore_Release,
+
+    .putContentObject = _athenaShardedContentStore_PutContentObject,
+    .getMatch         = _athenaShardedContentStore_GetMatch,
+    .getMatchOrStale  = _athenaShardedContentStore_GetMatchOrStale,
+    .containsMatch    = _athenaShardedContentStore_ContainsMatch,
+    .putRefresh       = _athenaShardedContentStore_PutRefresh,
+    .setStaleWindow   = _athenaShardedContentStore_SetStaleWindow,
+    .removeMatch      = _athenaShardedContentStore_RemoveMatch,
+    .sweepExpired     = _athenaShardedContentStore_SweepExpired,
+    .purgePrefix      = _athenaShardedContentStore_PurgePrefix,
+
+    .getCapacity      = _athenaShardedContentStore_GetCapacity,
+    .setCapacity      = _athenaShardedContentStore_SetCapacity,
+
+    .processMessage   = _athenaShardedContentStore_ProcessMessage,
+
+    .snapshot         = _athenaShardedContentStore_Snapshot,
+    .startSnapshot    = _athenaShardedContentStore_StartSnapshot,
+    .continueSnapshot = _athenaShardedContentStore_ContinueSnapshot,
+    .stopSnapshot     = _athenaShardedContentStore_StopSnapshot
+};
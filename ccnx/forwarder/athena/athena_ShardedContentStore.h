@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#ifndef libathena_ShardedContentStore
+#define libathena_ShardedContentStore
+
+#include <stdbool.h>
+
+#include <ccnx/forwarder/athena/athena_ContentStore.h>
+#include <ccnx/forwarder/athena/athena_LRUContentStore.h>
+
+//
+// Sharded Content Store
+//
+// A content store that may be shared by several forwarding threads.  Content is partitioned into
+// independently locked shards by a hash of its name, each shard being an LRU store with its own
+// indexes and eviction list.  A lookup only takes the lock of the shard holding the name.  The
+// overall byte budget is divided among the shards and periodically rebalanced towards the shards
+// receiving the most new content.
+//
+// Content objects returned by getMatch are borrowed, as with other stores.  The store holds a
+// reference to the last object returned to each thread until that thread's next lookup, so the
+// object remains valid while the caller forwards it even if another thread evicts it.
+//
+
+#define AthenaShardedContentStore_DefaultShardCount 16
+#define AthenaShardedContentStore_MaxShardCount 1024
+
+typedef struct AthenaShardedContentStoreConfig {
+    size_t capacityInMB;
+    size_t numShards;    // rounded up to a power of 2, AthenaShardedContentStore_DefaultShardCount if 0, at most AthenaShardedContentStore_MaxShardCount
+    AthenaLRUContentStoreEvictionPolicy evictionPolicy; // used by every shard
+    size_t coldSegmentPercent;                          // used by every shard
+    bool deduplicatePayloads;                           // within each shard
+    AthenaNamePool *namePool;                           // shared by every shard, created if NULL
+} AthenaShardedContentStoreConfig;
+
+extern AthenaContentStoreInterface AthenaContentStore_ShardedImplementation;
+#endif // libathena_ShardedContentStore
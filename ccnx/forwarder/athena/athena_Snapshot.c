@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena forwarder table snapshots
+ */
+
+#include <config.h>
+
+#include <string.h>
+#include <sys/time.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_ArrayList.h>
+#include <parc/algol/parc_JSON.h>
+
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
+
+struct athena_snapshot {
+    char *tableName;
+    uint64_t time;
+    PARCArrayList *entries;
+    bool isComplete;
+};
+
+static void
+_athenaSnapshot_Destroy(AthenaSnapshot **snapshotPtr)
+{
+    AthenaSnapshot *snapshot = *snapshotPtr;
+    parcArrayList_Destroy(&snapshot->entries);
+    parcMemory_Deallocate(&snapshot->tableName);
+}
+
+parcObject_ExtendPARCObject(AthenaSnapshot, _athenaSnapshot_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaSnapshot, AthenaSnapshot);
+
+parcObject_ImplementRelease(athenaSnapshot, AthenaSnapshot);
+
+static void
+_releaseEntry(void **entryPtr)
+{
+    parcObject_Release((PARCObject **) entryPtr);
+}
+
+AthenaSnapshot *
+athenaSnapshot_Create(const char *tableName, size_t capacityHint)
+{
+    AthenaSnapshot *snapshot = parcObject_CreateInstance(AthenaSnapshot);
+    if (snapshot != NULL) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+
+        snapshot->tableName = parcMemory_StringDuplicate(tableName, strlen(tableName));
+        snapshot->time = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+        snapshot->entries = parcArrayList_Create_Capacity(NULL, _releaseEntry, (capacityHint > 0) ? capacityHint : 16);
+        snapshot->isComplete = true;
+    }
+    return snapshot;
+}
+
+AthenaSnapshot *
+athenaSnapshot_CreatePartial(const char *tableName, size_t capacityHint)
+{
+    AthenaSnapshot *snapshot = athenaSnapshot_Create(tableName, capacityHint);
+    if (snapshot != NULL) {
+        snapshot->isComplete = false;
+    }
+    return snapshot;
+}
+
+void
+athenaSnapshot_Append(AthenaSnapshot *snapshot, const PARCObject *entry)
+{
+    assertNotNull(entry, "Snapshot entries must be non-NULL");
+    parcArrayList_Add(snapshot->entries, parcObject_Acquire(entry));
+}
+
+void
+athenaSnapshot_SetComplete(AthenaSnapshot *snapshot)
+{
+    snapshot->isComplete = true;
+}
+
+bool
+athenaSnapshot_IsComplete(const AthenaSnapshot *snapshot)
+{
+    return snapshot->isComplete;
+}
+
+const char *
+athenaSnapshot_GetTableName(const AthenaSnapshot *snapshot)
+{
+    return snapshot->tableName;
+}
+
+uint64_t
+athenaSnapshot_GetTime(const AthenaSnapshot *snapshot)
+{
+    return snapshot->time;
+}
+
+size_t
+athenaSnapshot_GetSize(const AthenaSnapshot *snapshot)
+{
+    return parcArrayList_Size(snapshot->entries);
+}
+
+const PARCObject *
+athenaSnapshot_Get(const AthenaSnapshot *snapshot, size_t index)
+{
+    return parcArrayList_Get(snapshot->entries, index);
+}
+
+size_t
+athenaSnapshot_GetNumberOfChunks(const AthenaSnapshot *snapshot, size_t entriesPerChunk)
+{
+    assertTrue(entriesPerChunk > 0, "A chunk must hold at least one entry");
+    size_t numChunks = (athenaSnapshot_GetSize(snapshot) + entriesPerChunk - 1) / entriesPerChunk;
+    return (numChunks > 0) ? numChunks : 1;
+}
+
+PARCJSON *
+athenaSnapshot_CreateChunk(const AthenaSnapshot *snapshot, size_t chunkNumber, size_t entriesPerChunk)
+{
+    size_t numEntries = athenaSnapshot_GetSize(snapshot);
+    size_t numChunks = athenaSnapshot_GetNumberOfChunks(snapshot, entriesPerChunk);
+
+    size_t first = (chunkNumber < numChunks) ? (chunkNumber * entriesPerChunk) : numEntries;
+    size_t last = ((numEntries - first) > entriesPerChunk) ? (first + entriesPerChunk) : numEntries;
+
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddString(json, "table", snapshot->tableName);
+    parcJSON_AddInteger(json, "time", snapshot->time);
+    parcJSON_AddInteger(json, "numEntries", numEntries);
+    parcJSON_AddInteger(json, "chunk", chunkNumber);
+    parcJSON_AddBoolean(json, "lastChunk", snapshot->isComplete && ((chunkNumber + 1) >= numChunks));
+
+    PARCJSONArray *jsonEntryList = parcJSONArray_Create();
+    for (size_t i = first; i < last; i++) {
+        PARCJSON *jsonItem = parcObject_ToJSON(athenaSnapshot_Get(snapshot, i));
+        if (jsonItem != NULL) {
+            PARCJSONValue *jsonItemValue = parcJSONValue_CreateFromJSON(jsonItem);
+            parcJSONArray_AddValue(jsonEntryList, jsonItemValue);
+            parcJSONValue_Release(&jsonItemValue);
+            parcJSON_Release(&jsonItem);
+        }
+    }
+    parcJSON_AddArray(json, "result", jsonEntryList);
+    parcJSONArray_Release(&jsonEntryList);
+
+    return json;
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Snapshot_h
+#define libathena_Snapshot_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_JSON.h>
+
+//
+// Forwarder table snapshots
+//
+// A snapshot is an immutable, reference counted list of entries copied out of one forwarder table
+// (FIB, PIT, Content Store or link table) at a single point in time.  Each table creates its own
+// entries, which are PARCObjects holding only acquired or copied data, and renders them through
+// their toJSON function.  Once a table has returned a snapshot it no longer refers to it, so a
+// snapshot may be iterated, rendered and released on any thread while the forwarder carries on
+// changing the table it was taken from.  Large snapshots are rendered a chunk at a time so that
+// no single diagnostic response holds up forwarding for long.
+//
+// A partial snapshot is filled by a walk of its table that is resumed between messages, rather
+// than copied in one go, so it describes each entry as the walk found it rather than the whole
+// table at one point in time.  Entries are only ever appended to it, so chunks already rendered
+// stay valid, and its last chunk is not reported until the walk has marked it complete.
+//
+
+struct athena_snapshot;
+typedef struct athena_snapshot AthenaSnapshot;
+
+/**
+ * @abstract create an empty snapshot of the named table
+ * @discussion
+ *
+ * Entries are added with athenaSnapshot_Append by the table taking the snapshot, after which the
+ * snapshot must not be modified.
+ *
+ * @param [in] tableName name of the table the snapshot is taken from, copied
+ * @param [in] capacityHint expected number of entries, may be 0
+ * @return a new snapshot, or NULL on failure
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaSnapshot *snapshot = athenaSnapshot_Create("fib", 0);
+ *     athenaSnapshot_Release(&snapshot);
+ * }
+ * @endcode
+ */
+AthenaSnapshot *athenaSnapshot_Create(const char *tableName, size_t capacityHint);
+
+/**
+ * @abstract create an empty snapshot of the named table, to be filled by a walk of the table
+ * @discussion
+ *
+ * Entries are added with athenaSnapshot_Append as the walk reaches them, and the walk calls
+ * athenaSnapshot_SetComplete once it has been through the whole table.  Until then no chunk
+ * rendered from the snapshot is reported as its last.
+ *
+ * @param [in] tableName name of the table the snapshot is taken from, copied
+ * @param [in] capacityHint expected number of entries, may be 0
+ * @return a new incomplete snapshot, or NULL on failure
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaSnapshot *snapshot = athenaSnapshot_CreatePartial("pit", 0);
+ *     AthenaPITWalk *walk = athenaPIT_StartSnapshot(pit);
+ *     while (athenaPIT_ContinueSnapshot(pit, walk, snapshot, 256)) {
+ *         ...
+ *     }
+ *     athenaPIT_StopSnapshot(&walk);
+ *     athenaSnapshot_SetComplete(snapshot);
+ * }
+ * @endcode
+ */
+AthenaSnapshot *athenaSnapshot_CreatePartial(const char *tableName, size_t capacityHint);
+
+/**
+ * @abstract acquire a reference to a snapshot
+ *
+ * @param [in] snapshot instance to acquire
+ * @return the same snapshot
+ */
+AthenaSnapshot *athenaSnapshot_Acquire(const AthenaSnapshot *snapshot);
+
+/**
+ * @abstract release a reference to a snapshot and, with the last reference, its entries
+ *
+ * @param [in,out] snapshotPtr pointer to the snapshot to release, set to NULL
+ */
+void athenaSnapshot_Release(AthenaSnapshot **snapshotPtr);
+
+/**
+ * @abstract add an entry to a snapshot that is being taken
+ * @discussion
+ *
+ * The entry must not refer to any mutable state of the table it describes.  Once a snapshot is
+ * complete nothing more may be appended to it.
+ *
+ * @param [in] snapshot snapshot being taken
+ * @param [in] entry PARCObject entry, acquired by the snapshot
+ */
+void athenaSnapshot_Append(AthenaSnapshot *snapshot, const PARCObject *entry);
+
+/**
+ * @abstract mark the end of the walk filling a partial snapshot
+ *
+ * @param [in] snapshot snapshot created by athenaSnapshot_CreatePartial
+ */
+void athenaSnapshot_SetComplete(AthenaSnapshot *snapshot);
+
+/**
+ * @abstract return whether a snapshot holds every entry it is going to
+ *
+ * @param [in] snapshot instance
+ * @return false while a walk is still filling a partial snapshot, true otherwise
+ */
+bool athenaSnapshot_IsComplete(const AthenaSnapshot *snapshot);
+
+/**
+ * @abstract return the name of the table a snapshot was taken from
+ *
+ * @param [in] snapshot instance
+ * @return table name, valid for the life of the snapshot
+ */
+const char *athenaSnapshot_GetTableName(const AthenaSnapshot *snapshot);
+
+/**
+ * @abstract return the wall clock time, in milliseconds, at which a snapshot was taken
+ *
+ * @param [in] snapshot instance
+ * @return creation time in milliseconds since the epoch
+ */
+uint64_t athenaSnapshot_GetTime(const AthenaSnapshot *snapshot);
+
+/**
+ * @abstract return the number of entries in a snapshot
+ *
+ * @param [in] snapshot instance
+ * @return number of entries, so far if the snapshot is still being taken
+ */
+size_t athenaSnapshot_GetSize(const AthenaSnapshot *snapshot);
+
+/**
+ * @abstract return an entry of a snapshot
+ *
+ * @param [in] snapshot instance
+ * @param [in] index entry index, less than athenaSnapshot_GetSize
+ * @return the entry, which is not acquired and is valid for the life of the snapshot
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < athenaSnapshot_GetSize(snapshot); i++) {
+ *         PARCJSON *json = parcObject_ToJSON(athenaSnapshot_Get(snapshot, i));
+ *         ...
+ *         parcJSON_Release(&json);
+ *     }
+ * }
+ * @endcode
+ */
+const PARCObject *athenaSnapshot_Get(const AthenaSnapshot *snapshot, size_t index);
+
+/**
+ * @abstract return the number of chunks a snapshot is rendered in
+ *
+ * @param [in] snapshot instance
+ * @param [in] entriesPerChunk maximum number of entries rendered per chunk, greater than 0
+ * @return number of chunks, at least 1 even for an empty snapshot
+ */
+size_t athenaSnapshot_GetNumberOfChunks(const AthenaSnapshot *snapshot, size_t entriesPerChunk);
+
+/**
+ * @abstract render one chunk of a snapshot as JSON
+ * @discussion
+ *
+ * The chunk is a JSON object naming the table, the time of the snapshot, its number of entries,
+ * the chunk number, whether it is the last chunk and a "result" array of at most entriesPerChunk
+ * rendered entries.  A chunk number past the end renders an empty chunk.  Until the snapshot is
+ * complete its number of entries is only those appended so far and no chunk is the last.
+ *
+ * @param [in] snapshot instance
+ * @param [in] chunkNumber chunk to render, from 0
+ * @param [in] entriesPerChunk maximum number of entries rendered per chunk, greater than 0
+ * @return a new PARCJSON object to be released by the caller
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *chunk = athenaSnapshot_CreateChunk(snapshot, 0, 64);
+ *     char *chunkString = parcJSON_ToString(chunk);
+ *     ...
+ *     parcMemory_Deallocate(&chunkString);
+ *     parcJSON_Release(&chunk);
+ * }
+ * @endcode
+ */
+PARCJSON *athenaSnapshot_CreateChunk(const AthenaSnapshot *snapshot, size_t chunkNumber, size_t entriesPerChunk);
+#endif // libathena_Snapshot_h
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena per-thread statistics
+ *
+ * Each statistics object has a table of block pointers indexed by thread number, with one more
+ * entry for the block shared by threads without a number of their own.  A thread's number is kept
+ * in thread specific data, and is handed back to a free list by the key's destructor when the
+ * thread exits.  A block is allocated and published the first time its thread updates the object,
+ * and is only ever written by the thread holding its number, which stores each new count with
+ * release ordering so a reader summing the blocks sees every update made before the one it read.
+ * A thread number is only handed on after its last owner has exited, under the same mutex, so the
+ * next owner carries on from the counts its predecessor left.
+ */
+
+#include <config.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/forwarder/athena/athena_Stats.h>
+
+#define _AthenaStatsSharedBlock AthenaStatsMaxThreads
+
+struct athena_stats {
+    size_t numCounters;
+    size_t numHistograms;
+    size_t numBuckets;
+    uint64_t *bucketBounds;
+    size_t blockSize;                                  // bytes, a multiple of AthenaStatsCacheLineSize
+    uint64_t *blocks[AthenaStatsMaxThreads + 1];       // counters then histogram buckets, published atomically
+};
+
+static pthread_once_t _threadNumberKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t _threadNumberKey;
+static pthread_mutex_t _threadNumberMutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t _freeThreadNumbers[AthenaStatsMaxThreads];
+static size_t _numFreeThreadNumbers;
+static size_t _nextThreadNumber;
+
+// Thread specific data holds the thread number plus one, as a NULL value has no destructor call
+static void
+_releaseThreadNumber(void *value)
+{
+    size_t threadNumber = (uintptr_t) value - 1;
+    if (threadNumber != _AthenaStatsSharedBlock) {
+        pthread_mutex_lock(&_threadNumberMutex);
+        _freeThreadNumbers[_numFreeThreadNumbers++] = threadNumber;
+        pthread_mutex_unlock(&_threadNumberMutex);
+    }
+}
+
+static void
+_createThreadNumberKey(void)
+{
+    pthread_key_create(&_threadNumberKey, _releaseThreadNumber);
+}
+
+static size_t
+_getThreadNumber(void)
+{
+    pthread_once(&_threadNumberKeyOnce, _createThreadNumberKey);
+
+    uintptr_t value = (uintptr_t) pthread_getspecific(_threadNumberKey);
+    if (value != 0) {
+        return value - 1;
+    }
+
+    size_t threadNumber;
+    pthread_mutex_lock(&_threadNumberMutex);
+    if (_numFreeThreadNumbers > 0) {
+        threadNumber = _freeThreadNumbers[--_numFreeThreadNumbers];
+    } else if (_nextThreadNumber < AthenaStatsMaxThreads) {
+        threadNumber = _nextThreadNumber++;
+    } else {
+        threadNumber = _AthenaStatsSharedBlock;
+    }
+    pthread_mutex_unlock(&_threadNumberMutex);
+
+    pthread_setspecific(_threadNumberKey, (void *) (threadNumber + 1));
+    return threadNumber;
+}
+
+static uint64_t *
+_getBlock(AthenaStats *stats, size_t threadNumber)
+{
+    uint64_t *block = __atomic_load_n(&stats->blocks[threadNumber], __ATOMIC_ACQUIRE);
+    if (block == NULL) {
+        void *newBlock = NULL;
+        int result = parcMemory_MemAlign(&newBlock, AthenaStatsCacheLineSize, stats->blockSize);
+        assertTrue(result == 0, "Could not allocate a statistics block");
+        memset(newBlock, 0, stats->blockSize);
+
+        // Only the shared block can be raced for
+        if (__atomic_compare_exchange_n(&stats->blocks[threadNumber], &block, (uint64_t *) newBlock,
+                                        false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            block = newBlock;
+        } else {
+            parcMemory_Deallocate(&newBlock);
+        }
+    }
+    return block;
+}
+
+static void
+_add(AthenaStats *stats, size_t index, uint64_t value)
+{
+    size_t threadNumber = _getThreadNumber();
+    uint64_t *block = _getBlock(stats, threadNumber);
+
+    if (threadNumber == _AthenaStatsSharedBlock) {
+        __atomic_fetch_add(&block[index], value, __ATOMIC_RELEASE);
+    } else {
+        __atomic_store_n(&block[index], __atomic_load_n(&block[index], __ATOMIC_RELAXED) + value, __ATOMIC_RELEASE);
+    }
+}
+
+static uint64_t
+_sum(const AthenaStats *stats, size_t index)
+{
+    uint64_t sum = 0;
+    for (size_t threadNumber = 0; threadNumber <= AthenaStatsMaxThreads; threadNumber++) {
+        uint64_t *block = __atomic_load_n(&stats->blocks[threadNumber], __ATOMIC_ACQUIRE);
+        if (block) {
+            sum += __atomic_load_n(&block[index], __ATOMIC_ACQUIRE);
+        }
+    }
+    return sum;
+}
+
+static void
+_athenaStats_Destroy(AthenaStats **statsPtr)
+{
+    AthenaStats *stats = *statsPtr;
+    for (size_t threadNumber = 0; threadNumber <= AthenaStatsMaxThreads; threadNumber++) {
+        if (stats->blocks[threadNumber]) {
+            parcMemory_Deallocate(&stats->blocks[threadNumber]);
+        }
+    }
+    if (stats->bucketBounds) {
+        parcMemory_Deallocate(&stats->bucketBounds);
+    }
+}
+
+parcObject_ExtendPARCObject(AthenaStats, _athenaStats_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaStats, AthenaStats);
+
+parcObject_ImplementRelease(athenaStats, AthenaStats);
+
+AthenaStats *
+athenaStats_Create(size_t numCounters, size_t numHistograms, size_t numBuckets, const uint64_t *bucketBounds)
+{
+    assertTrue((numHistograms == 0) || ((numBuckets > 0) && (bucketBounds != NULL)),
+               "Histograms need at least one bucket");
+
+    AthenaStats *stats = parcObject_CreateAndClearInstance(AthenaStats);
+    assertNotNull(stats, "Could not allocate statistics");
+
+    stats->numCounters = numCounters;
+    stats->numHistograms = numHistograms;
+    stats->numBuckets = (numHistograms > 0) ? numBuckets : 0;
+    if (stats->numBuckets > 0) {
+        stats->bucketBounds = parcMemory_Allocate(sizeof(uint64_t) * numBuckets);
+        assertNotNull(stats->bucketBounds, "Could not allocate histogram buckets");
+        memcpy(stats->bucketBounds, bucketBounds, sizeof(uint64_t) * numBuckets);
+    }
+
+    size_t blockSize = sizeof(uint64_t) * (numCounters + (numHistograms * stats->numBuckets));
+    assertTrue(blockSize > 0, "Statistics need at least one counter or histogram");
+    stats->blockSize = ((blockSize + AthenaStatsCacheLineSize - 1) / AthenaStatsCacheLineSize) * AthenaStatsCacheLineSize;
+
+    return stats;
+}
+
+void
+athenaStats_Add(AthenaStats *stats, size_t counter, uint64_t value)
+{
+    assertTrue(counter < stats->numCounters, "Counter %zu out of range", counter);
+    _add(stats, counter, value);
+}
+
+void
+athenaStats_Increment(AthenaStats *stats, size_t counter)
+{
+    assertTrue(counter < stats->numCounters, "Counter %zu out of range", counter);
+    _add(stats, counter, 1);
+}
+
+void
+athenaStats_Record(AthenaStats *stats, size_t histogram, uint64_t value)
+{
+    assertTrue(histogram < stats->numHistograms, "Histogram %zu out of range", histogram);
+    size_t bucket = 0;
+    while ((bucket < stats->numBuckets - 1) && (value >= stats->bucketBounds[bucket])) {
+        bucket++;
+    }
+    _add(stats, stats->numCounters + (histogram * stats->numBuckets) + bucket, 1);
+}
+
+uint64_t
+athenaStats_Get(const AthenaStats *stats, size_t counter)
+{
+    assertTrue(counter < stats->numCounters, "Counter %zu out of range", counter);
+    return _sum(stats, counter);
+}
+
+void
+athenaStats_GetHistogram(const AthenaStats *stats, size_t histogram, uint64_t *buckets)
+{
+    assertTrue(histogram < stats->numHistograms, "Histogram %zu out of range", histogram);
+    size_t first = stats->numCounters + (histogram * stats->numBuckets);
+    for (size_t bucket = 0; bucket < stats->numBuckets; bucket++) {
+        buckets[bucket] = _sum(stats, first + bucket);
+    }
+}
+
+size_t
+athenaStats_GetNumberOfBuckets(const AthenaStats *stats)
+{
+    return stats->numBuckets;
+}
+
+size_t
+athenaStats_GetNumberOfBlocks(const AthenaStats *stats)
+{
+    size_t numBlocks = 0;
+    for (size_t threadNumber = 0; threadNumber <= AthenaStatsMaxThreads; threadNumber++) {
+        if (__atomic_load_n(&stats->blocks[threadNumber], __ATOMIC_ACQUIRE)) {
+            numBlocks++;
+        }
+    }
+    return numBlocks;
+}
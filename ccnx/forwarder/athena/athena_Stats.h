@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Stats_h
+#define libathena_Stats_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+//
+// Per-thread statistics
+//
+// Counters bumped on every message would bounce their cache line between threads if they were
+// shared, whether or not they were updated atomically.  A statistics object instead gives each
+// thread that updates it a block of its own, aligned to and padded out to AthenaStatsCacheLineSize,
+// holding that thread's share of every counter and histogram.  A thread only ever writes its own
+// block, so updates are plain loads and stores with no locked instructions, and the shares are only
+// summed when a counter is read, by the stats command or anything else reporting them.
+//
+// Counters and histograms are identified by their index, normally from an enumeration kept by the
+// module owning the statistics.  Every histogram of a statistics object has the same buckets, given
+// by the upper bound of each, a value being counted in the first bucket whose bound is greater than
+// it and the last bucket counting everything else.
+//
+// Threads are given one of AthenaStatsMaxThreads blocks the first time they update any statistics,
+// and give it back when they exit, so a thread's counts outlive it.  Threads beyond that number
+// share one more block, which they update atomically.
+//
+
+#define AthenaStatsCacheLineSize 64     // alignment and padding of per-thread blocks
+#define AthenaStatsMaxThreads 64        // threads with blocks of their own
+
+struct athena_stats;
+typedef struct athena_stats AthenaStats;
+
+/**
+ * @abstract create a set of per-thread counters and histograms
+ * @discussion
+ *
+ * @param [in] numCounters number of counters, indexed from 0
+ * @param [in] numHistograms number of histograms, indexed from 0
+ * @param [in] numBuckets number of buckets in each histogram
+ * @param [in] bucketBounds upper bound of each bucket, in increasing order, or NULL if there are no histograms
+ * @return a new statistics object with every count zero
+ *
+ * Example:
+ * @code
+ * {
+ *     static const uint64_t bounds[] = { 100, 1000, UINT64_MAX };
+ *     AthenaStats *stats = athenaStats_Create(MyCounter_Count, 1, 3, bounds);
+ *     athenaStats_Release(&stats);
+ * }
+ * @endcode
+ */
+AthenaStats *athenaStats_Create(size_t numCounters, size_t numHistograms, size_t numBuckets, const uint64_t *bucketBounds);
+
+/**
+ * @abstract acquire a reference to a statistics object
+ *
+ * @param [in] stats instance to acquire
+ * @return the same statistics object
+ */
+AthenaStats *athenaStats_Acquire(const AthenaStats *stats);
+
+/**
+ * @abstract release a statistics object, freeing every thread's block with the last reference
+ *
+ * @param [in,out] statsPtr pointer to the statistics object to release, set to NULL
+ */
+void athenaStats_Release(AthenaStats **statsPtr);
+
+/**
+ * @abstract add to a counter on behalf of the calling thread
+ *
+ * @param [in] stats statistics object
+ * @param [in] counter index of the counter
+ * @param [in] value amount to add
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaStats_Add(athena->stats, AthenaCounter_PurgedBytes, bytesFreed);
+ * }
+ * @endcode
+ */
+void athenaStats_Add(AthenaStats *stats, size_t counter, uint64_t value);
+
+/**
+ * @abstract add one to a counter on behalf of the calling thread
+ *
+ * @param [in] stats statistics object
+ * @param [in] counter index of the counter
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaStats_Increment(athena->stats, AthenaCounter_ProcessedInterests);
+ * }
+ * @endcode
+ */
+void athenaStats_Increment(AthenaStats *stats, size_t counter);
+
+/**
+ * @abstract count a value in the bucket of a histogram it falls in
+ *
+ * @param [in] stats statistics object
+ * @param [in] histogram index of the histogram
+ * @param [in] value value to count
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaStats_Record(stats, MyHistogram_Latency, latencyMicros);
+ * }
+ * @endcode
+ */
+void athenaStats_Record(AthenaStats *stats, size_t histogram, uint64_t value);
+
+/**
+ * @abstract sum a counter over every thread
+ * @discussion
+ *
+ * Counters are read while other threads go on updating them, so counters read one after another
+ * may not be from the same instant.  An update to a counter made before another is seen by reading
+ * the later one first.
+ *
+ * @param [in] stats statistics object
+ * @param [in] counter index of the counter
+ * @return the counter's total
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t numInterests = athenaStats_Get(athena->stats, AthenaCounter_ProcessedInterests);
+ * }
+ * @endcode
+ */
+uint64_t athenaStats_Get(const AthenaStats *stats, size_t counter);
+
+/**
+ * @abstract sum the buckets of a histogram over every thread
+ *
+ * @param [in] stats statistics object
+ * @param [in] histogram index of the histogram
+ * @param [out] buckets filled in with the count of each of athenaStats_GetNumberOfBuckets buckets
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t buckets[3];
+ *     athenaStats_GetHistogram(stats, MyHistogram_Latency, buckets);
+ * }
+ * @endcode
+ */
+void athenaStats_GetHistogram(const AthenaStats *stats, size_t histogram, uint64_t *buckets);
+
+/**
+ * @abstract the number of buckets in each histogram
+ *
+ * @param [in] stats statistics object
+ * @return bucket count
+ */
+size_t athenaStats_GetNumberOfBuckets(const AthenaStats *stats);
+
+/**
+ * @abstract the number of per-thread blocks holding counts
+ * @discussion
+ *
+ * One for each thread that has updated the statistics, less any whose block was handed on to a
+ * later thread after it exited, plus one if any were updated by threads beyond AthenaStatsMaxThreads.
+ *
+ * @param [in] stats statistics object
+ * @return block count
+ */
+size_t athenaStats_GetNumberOfBlocks(const AthenaStats *stats);
+
+#endif // libathena_Stats_h
@@ -33,15 +33,47 @@
 #include <LongBow/runtime.h>
 
 #include <errno.h>
+#include <sched.h>
+#include <stdint.h>
 #include <unistd.h>
 
 #include <ccnx/forwarder/athena/athena_TransportLink.h>
+#include <ccnx/forwarder/athena/athena_Stats.h>
 #include <parc/algol/parc_Object.h>
 #include <ccnx/common/ccnx_Interest.h>
 
+/**
+ * @typedef _AthenaTransportLinkSendQueueNode
+ * @brief An entry on a link's multi-producer single-consumer send queue
+ */
+typedef struct _athenaTransportLinkSendQueueNode {
+    struct _athenaTransportLinkSendQueueNode *next;
+    CCNxMetaMessage *ccnxMetaMessage;
+} _AthenaTransportLinkSendQueueNode;
+
+typedef enum {
+    _AthenaTransportLinkCounter_MessageFromLink_Received,
+    _AthenaTransportLinkCounter_MessageFromLink_Empty,
+    _AthenaTransportLinkCounter_MessageFromLink_DroppedNoConnection,
+    _AthenaTransportLinkCounter_MessageToLink_Sent,
+    _AthenaTransportLinkCounter_MessageToLink_DroppedNoConnection,
+    _AthenaTransportLinkCounter_MessageToLink_Queued,
+    _AthenaTransportLinkCounter_MessageToLink_DroppedQueueFull,
+    _AthenaTransportLinkCounter_Link_Added,
+    _AthenaTransportLinkCounter_Link_Closed,
+    _AthenaTransportLinkCounter_Link_Removed,
+    _AthenaTransportLinkCounter_Count
+} _AthenaTransportLinkCounter;
+
 /**
  * @typedef AthenaTransportLink
  * @brief Transport Link instance private data
+ *
+ * The send queue is an intrusive MPSC list: producers swap themselves onto sendQueueTail and then link the
+ * previous tail to themselves, the owning I/O context pops from sendQueueHead.  sendQueueStub keeps the list
+ * non-empty so producers never touch the head.  sendQueuePending counts queued messages and is used both to
+ * bound the queue and to wake the owner only on the transition from empty.  Only the thread holding sendBusy
+ * calls the send method or pops the queue.
  */
 struct AthenaTransportLink {
     char *linkName;
@@ -53,21 +85,21 @@ struct AthenaTransportLink {
     AthenaTransportLinkEvent linkEvents;
     AthenaTransportLinkFlag linkFlags;
     int forceLocal;
+    size_t pushQuota;                 // bytes of unsolicited content admitted per period, 0 if not trusted to push
+    size_t pushBytes;                 // unsolicited content admitted in the current period
+    uint64_t pushPeriodStart;         // when the current period started
     void *linkData;
     AthenaTransportLink_AddLinkCallback *addLink;
     AthenaTransportLink_AddLinkCallbackContext addLinkContext;
     AthenaTransportLink_RemoveLinkCallback *removeLink;
     AthenaTransportLink_RemoveLinkCallbackContext removeLinkContext;
-    struct {
-        size_t messageFromLink_Received;
-        size_t messageFromLink_Empty;
-        size_t messageFromLink_DroppedNoConnection;
-        size_t messageToLink_Sent;
-        size_t messageToLink_DroppedNoConnection;
-        size_t link_Added;
-        size_t link_Closed;
-        size_t link_Removed;
-    } stats;
+    _AthenaTransportLinkSendQueueNode *sendQueueHead;
+    _AthenaTransportLinkSendQueueNode *sendQueueTail;
+    _AthenaTransportLinkSendQueueNode sendQueueStub;
+    size_t sendQueuePending;
+    int wakeupFd;
+    bool sendBusy;                    // a thread is in the link's send method
+    AthenaStats *stats;               // _AthenaTransportLinkCounter counts, bumped by whichever thread sends or receives
 };
 
 static PARCLog *
@@ -87,10 +119,20 @@ _parc_logger_create(const char *name)
     return log;
 }
 
+static void _sendQueue_Push(AthenaTransportLink *athenaTransportLink, _AthenaTransportLinkSendQueueNode *node);
+static _AthenaTransportLinkSendQueueNode *_sendQueue_Pop(AthenaTransportLink *athenaTransportLink);
+
 static void
 _destroy_link(AthenaTransportLink **athenaTransportLink)
 {
+    // Anything still queued can no longer be sent, the last reference is gone.
+    _AthenaTransportLinkSendQueueNode *node;
+    while ((node = _sendQueue_Pop(*athenaTransportLink)) != NULL) {
+        ccnxMetaMessage_Release(&node->ccnxMetaMessage);
+        parcMemory_Deallocate(&node);
+    }
     parcMemory_Deallocate(&((*athenaTransportLink)->linkName));
+    athenaStats_Release(&((*athenaTransportLink)->stats));
     parcLog_Release(&((*athenaTransportLink)->log));
 }
 
@@ -132,9 +174,13 @@ athenaTransportLink_Create(const char *name,
         athenaTransportLink->receiveMethod = receiveMethod;
         athenaTransportLink->closeMethod = closeMethod;
         athenaTransportLink->log = _parc_logger_create(name);
+        athenaTransportLink->stats = athenaStats_Create(_AthenaTransportLinkCounter_Count, 0, 0, NULL);
         athenaTransportLink->linkEvents = AthenaTransportLinkEvent_None;
         athenaTransportLink->linkFlags = AthenaTransportLinkFlag_None;
         athenaTransportLink->eventFd = -1;
+        athenaTransportLink->wakeupFd = -1;
+        athenaTransportLink->sendQueueHead = &athenaTransportLink->sendQueueStub;
+        athenaTransportLink->sendQueueTail = &athenaTransportLink->sendQueueStub;
     }
 
     return athenaTransportLink;
@@ -150,37 +196,223 @@ athenaTransportLink_GetLogger(AthenaTransportLink *athenaTransportLink)
     return athenaTransportLink->log;
 }
 
+static int
+_athenaTransportLink_Send(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage)
+{
+    if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Closing) {
+        athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageToLink_DroppedNoConnection);
+        errno = ENOTCONN;
+        return -1;
+    }
+    athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageToLink_Sent);
+    return athenaTransportLink->sendMethod(athenaTransportLink, ccnxMetaMessage);
+}
+
+/**
+ * @abstract take the right to call the link's send method
+ * @discussion
+ *
+ * Link send methods aren't reentrant, so only the thread holding sendBusy may call one.
+ */
+static bool
+_athenaTransportLink_AcquireSend(AthenaTransportLink *athenaTransportLink)
+{
+    return __atomic_exchange_n(&athenaTransportLink->sendBusy, true, __ATOMIC_SEQ_CST) == false;
+}
+
+static size_t _athenaTransportLink_DrainSendQueueLocked(AthenaTransportLink *athenaTransportLink);
+
+/**
+ * @abstract give up the right to call the link's send method
+ * @discussion
+ *
+ * A drain that found the link busy left its messages queued, with nothing to wake the owner for them
+ * again before its next poll timeout.  The releasing thread sends them instead, for as long as it can
+ * take the link back and finds something to send.
+ */
+static void
+_athenaTransportLink_ReleaseSend(AthenaTransportLink *athenaTransportLink)
+{
+    // Sequentially consistent so that either this thread sees a message queued before a failed drain,
+    // or that drain found the link free.
+    __atomic_store_n(&athenaTransportLink->sendBusy, false, __ATOMIC_SEQ_CST);
+    while ((__atomic_load_n(&athenaTransportLink->sendQueuePending, __ATOMIC_SEQ_CST) > 0) &&
+           _athenaTransportLink_AcquireSend(athenaTransportLink)) {
+        size_t drained = _athenaTransportLink_DrainSendQueueLocked(athenaTransportLink);
+        __atomic_store_n(&athenaTransportLink->sendBusy, false, __ATOMIC_SEQ_CST);
+        if (drained == 0) {
+            break; // a push still being linked in, left for the owner's next drain
+        }
+    }
+}
+
+static void
+_sendQueue_Push(AthenaTransportLink *athenaTransportLink, _AthenaTransportLinkSendQueueNode *node)
+{
+    node->next = NULL;
+    _AthenaTransportLinkSendQueueNode *previous = __atomic_exchange_n(&athenaTransportLink->sendQueueTail, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&previous->next, node, __ATOMIC_RELEASE);
+}
+
+/**
+ * @abstract remove the oldest node from the send queue, only called by the owning I/O context
+ * @discussion
+ *
+ * Returns NULL if the queue is empty, or if a producer has swapped in a new tail but not yet linked
+ * it; in that case the node will be seen on a later call.
+ */
+static _AthenaTransportLinkSendQueueNode *
+_sendQueue_Pop(AthenaTransportLink *athenaTransportLink)
+{
+    _AthenaTransportLinkSendQueueNode *stub = &athenaTransportLink->sendQueueStub;
+    _AthenaTransportLinkSendQueueNode *head = athenaTransportLink->sendQueueHead;
+    _AthenaTransportLinkSendQueueNode *next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+
+    if (head == stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        athenaTransportLink->sendQueueHead = next;
+        head = next;
+        next = __atomic_load_n(&next->next, __ATOMIC_ACQUIRE);
+    }
+    if (next) {
+        athenaTransportLink->sendQueueHead = next;
+        return head;
+    }
+    if (head != __atomic_load_n(&athenaTransportLink->sendQueueTail, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    // head is the last real node, put the stub back behind it so it can be handed out
+    _sendQueue_Push(athenaTransportLink, stub);
+    next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+    if (next) {
+        athenaTransportLink->sendQueueHead = next;
+        return head;
+    }
+    return NULL;
+}
+
 int
-athenaTransportLink_Send(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage)
+athenaTransportLink_Enqueue(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage)
 {
-    if (athenaTransportLink->sendMethod) {
-        if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Closing) {
-            athenaTransportLink->stats.messageToLink_DroppedNoConnection++;
-            errno = ENOTCONN;
-            return -1;
+    if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Closing) {
+        athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageToLink_DroppedNoConnection);
+        errno = ENOTCONN;
+        return -1;
+    }
+
+    size_t pending = __atomic_fetch_add(&athenaTransportLink->sendQueuePending, 1, __ATOMIC_SEQ_CST);
+    if (pending >= AthenaTransportLinkSendQueueLimit) {
+        __atomic_fetch_sub(&athenaTransportLink->sendQueuePending, 1, __ATOMIC_ACQ_REL);
+        athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageToLink_DroppedQueueFull);
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    _AthenaTransportLinkSendQueueNode *node = parcMemory_Allocate(sizeof(_AthenaTransportLinkSendQueueNode));
+    assertNotNull(node, "parcMemory_Allocate failed to allocate a send queue entry");
+    node->ccnxMetaMessage = ccnxMetaMessage_Acquire(ccnxMetaMessage);
+    _sendQueue_Push(athenaTransportLink, node);
+    athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageToLink_Queued);
+
+    // Only the producer that made the queue non-empty needs to wake the owner, it drains everything queued.
+    int wakeupFd = __atomic_load_n(&athenaTransportLink->wakeupFd, __ATOMIC_ACQUIRE);
+    if ((pending == 0) && (wakeupFd != -1)) {
+        uint64_t count = 1;
+        if (write(wakeupFd, &count, sizeof(count)) < 0 && (errno != EAGAIN)) {
+            parcLog_Warning(athenaTransportLink->log, "send queue wakeup failed: (%d) %s", errno, strerror(errno));
         }
-        athenaTransportLink->stats.messageToLink_Sent++;
-        return athenaTransportLink->sendMethod(athenaTransportLink, ccnxMetaMessage);
     }
     return 0;
 }
 
+/**
+ * @abstract send everything on the queue, the caller must hold the right to send on the link
+ */
+static size_t
+_athenaTransportLink_DrainSendQueueLocked(AthenaTransportLink *athenaTransportLink)
+{
+    size_t drained = 0;
+    _AthenaTransportLinkSendQueueNode *node;
+
+    while ((node = _sendQueue_Pop(athenaTransportLink)) != NULL) {
+        __atomic_fetch_sub(&athenaTransportLink->sendQueuePending, 1, __ATOMIC_ACQ_REL);
+        if (athenaTransportLink->sendMethod) {
+            _athenaTransportLink_Send(athenaTransportLink, node->ccnxMetaMessage);
+        }
+        ccnxMetaMessage_Release(&node->ccnxMetaMessage);
+        parcMemory_Deallocate(&node);
+        drained++;
+    }
+    return drained;
+}
+
+size_t
+athenaTransportLink_DrainSendQueue(AthenaTransportLink *athenaTransportLink)
+{
+    // If another thread is sending on the link the queue is left for a later drain
+    if (_athenaTransportLink_AcquireSend(athenaTransportLink) == false) {
+        return 0;
+    }
+    size_t drained = _athenaTransportLink_DrainSendQueueLocked(athenaTransportLink);
+    _athenaTransportLink_ReleaseSend(athenaTransportLink);
+    return drained;
+}
+
+int
+athenaTransportLink_Send(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage)
+{
+    if (athenaTransportLink->sendMethod == NULL) {
+        return 0;
+    }
+    if (_athenaTransportLink_AcquireSend(athenaTransportLink) == false) {
+        // Another thread is sending on the link, leave it to the owner to send after it
+        return athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+    }
+
+    // Messages queued while the link was busy go out first, so a link sends in the order it was handed messages.
+    // A message only goes out directly once nothing is left ahead of it, including a push still being linked in.
+    _athenaTransportLink_DrainSendQueueLocked(athenaTransportLink);
+    int result;
+    if (athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 0) {
+        result = _athenaTransportLink_Send(athenaTransportLink, ccnxMetaMessage);
+    } else {
+        result = athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+        _athenaTransportLink_DrainSendQueueLocked(athenaTransportLink);
+    }
+    _athenaTransportLink_ReleaseSend(athenaTransportLink);
+    return result;
+}
+
+size_t
+athenaTransportLink_GetSendQueueDepth(AthenaTransportLink *athenaTransportLink)
+{
+    return __atomic_load_n(&athenaTransportLink->sendQueuePending, __ATOMIC_ACQUIRE);
+}
+
+void
+athenaTransportLink_SetWakeupFd(AthenaTransportLink *athenaTransportLink, int wakeupFd)
+{
+    __atomic_store_n(&athenaTransportLink->wakeupFd, wakeupFd, __ATOMIC_RELEASE);
+}
+
 AthenaTransportLinkEvent
 athenaTransportLink_GetEvent(AthenaTransportLink *athenaTransportLink)
 {
-    return athenaTransportLink->linkEvents;
+    return __atomic_load_n(&athenaTransportLink->linkEvents, __ATOMIC_ACQUIRE);
 }
 
 void
 athenaTransportLink_SetEvent(AthenaTransportLink *athenaTransportLink, AthenaTransportLinkEvent linkEvents)
 {
-    athenaTransportLink->linkEvents |= linkEvents;
+    __atomic_fetch_or(&athenaTransportLink->linkEvents, linkEvents, __ATOMIC_ACQ_REL);
 }
 
 void
 athenaTransportLink_ClearEvent(AthenaTransportLink *athenaTransportLink, AthenaTransportLinkEvent linkEvents)
 {
-    athenaTransportLink->linkEvents &= ~linkEvents;
+    __atomic_fetch_and(&athenaTransportLink->linkEvents, ~linkEvents, __ATOMIC_ACQ_REL);
 }
 
 CCNxMetaMessage *
@@ -189,13 +421,13 @@ athenaTransportLink_Receive(AthenaTransportLink *athenaTransportLink)
     CCNxMetaMessage *ccnxMetaMessage = NULL;
     if (athenaTransportLink->receiveMethod) {
         if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Closing) {
-            athenaTransportLink->stats.messageFromLink_DroppedNoConnection++;
+            athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageFromLink_DroppedNoConnection);
             errno = ENOTCONN;
             return NULL;
         }
         if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Error) {
             athenaTransportLink_Close(athenaTransportLink);
-            athenaTransportLink->stats.messageFromLink_DroppedNoConnection++;
+            athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageFromLink_DroppedNoConnection);
             errno = ENOTCONN;
             return NULL;
         }
@@ -203,10 +435,10 @@ athenaTransportLink_Receive(AthenaTransportLink *athenaTransportLink)
         athenaTransportLink_ClearEvent(athenaTransportLink, AthenaTransportLinkEvent_Receive);
         ccnxMetaMessage = athenaTransportLink->receiveMethod(athenaTransportLink);
         if (ccnxMetaMessage == NULL) {
-            athenaTransportLink->stats.messageFromLink_Empty++;
+            athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageFromLink_Empty);
             errno = ENOMSG;
         } else {
-            athenaTransportLink->stats.messageFromLink_Received++;
+            athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_MessageFromLink_Received);
         }
     }
     return ccnxMetaMessage;
@@ -216,7 +448,7 @@ void
 athenaTransportLink_RemoveLink(AthenaTransportLink *athenaTransportLink)
 {
     if (athenaTransportLink->removeLink) {
-        athenaTransportLink->stats.link_Removed++;
+        athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_Link_Removed);
         athenaTransportLink->removeLink(athenaTransportLink->removeLinkContext, athenaTransportLink);
     }
 }
@@ -224,14 +456,18 @@ athenaTransportLink_RemoveLink(AthenaTransportLink *athenaTransportLink)
 void
 athenaTransportLink_Close(AthenaTransportLink *athenaTransportLink)
 {
-    // XXX test and set
-    if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Closing) {
+    // Test and set, so a link is only ever closed once however many threads see it fail.
+    if (__atomic_fetch_or(&athenaTransportLink->linkEvents, AthenaTransportLinkEvent_Closing, __ATOMIC_ACQ_REL) & AthenaTransportLinkEvent_Closing) {
         return;
     }
-    athenaTransportLink_SetEvent(athenaTransportLink, AthenaTransportLinkEvent_Closing);
     if (athenaTransportLink->closeMethod) {
-        athenaTransportLink->stats.link_Closed++;
+        // Wait out any other thread in the send method, later senders will see the link closing
+        while (_athenaTransportLink_AcquireSend(athenaTransportLink) == false) {
+            sched_yield();
+        }
+        athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_Link_Closed);
         athenaTransportLink->closeMethod(athenaTransportLink);
+        _athenaTransportLink_ReleaseSend(athenaTransportLink);
     }
     athenaTransportLink_RemoveLink(athenaTransportLink);
     athenaTransportLink_Release(&athenaTransportLink);
@@ -259,7 +495,7 @@ int
 athenaTransportLink_AddLink(AthenaTransportLink *athenaTransportLink, AthenaTransportLink *newTransportLink)
 {
     if (athenaTransportLink->addLink) {
-        athenaTransportLink->stats.link_Added++;
+        athenaStats_Increment(athenaTransportLink->stats, _AthenaTransportLinkCounter_Link_Added);
         return athenaTransportLink->addLink(athenaTransportLink->addLinkContext, newTransportLink);
     }
     return 0;
@@ -349,6 +585,35 @@ athenaTransportLink_IsNotLocal(AthenaTransportLink *athenaTransportLink)
     return true;
 }
 
+void
+athenaTransportLink_SetPushQuota(AthenaTransportLink *athenaTransportLink, size_t pushQuota)
+{
+    athenaTransportLink->pushQuota = pushQuota;
+}
+
+size_t
+athenaTransportLink_GetPushQuota(AthenaTransportLink *athenaTransportLink)
+{
+    return athenaTransportLink->pushQuota;
+}
+
+bool
+athenaTransportLink_AdmitPush(AthenaTransportLink *athenaTransportLink, size_t sizeInBytes, uint64_t nowInMillis)
+{
+    if (athenaTransportLink->pushQuota == 0) {
+        return false;
+    }
+    if (nowInMillis >= (athenaTransportLink->pushPeriodStart + AthenaTransportLinkPushQuotaWindowMillis)) {
+        athenaTransportLink->pushPeriodStart = nowInMillis;
+        athenaTransportLink->pushBytes = 0;
+    }
+    if ((athenaTransportLink->pushBytes + sizeInBytes) > athenaTransportLink->pushQuota) {
+        return false;
+    }
+    athenaTransportLink->pushBytes += sizeInBytes;
+    return true;
+}
+
 void
 athenaTransportLink_SetLogLevel(AthenaTransportLink *athenaTransportLink, const PARCLogLevel level)
 {
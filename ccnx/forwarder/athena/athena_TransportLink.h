@@ -99,6 +99,18 @@ typedef enum {
 #define AthenaTransportLink_ForcedLocal  1
 #define AthenaTransportLink_ForcedNonLocal  -1
 
+/**
+ * @define AthenaTransportLinkSendQueueLimit
+ * @brief Maximum number of messages waiting on a link's send queue before further enqueues are dropped
+ */
+#define AthenaTransportLinkSendQueueLimit 4096
+
+/**
+ * @define AthenaTransportLinkPushQuotaWindowMillis
+ * @brief Period over which a trusted-push link's byte quota of unsolicited content is counted
+ */
+#define AthenaTransportLinkPushQuotaWindowMillis 1000
+
 /**
  * @typedef AthenaTransportLinkEvent
  * @brief An enumeration of event types
@@ -243,9 +255,14 @@ CCNxMetaMessage *athenaTransportLink_Receive(AthenaTransportLink *athenaTranspor
  * @abstract called to invoke the link specific send method
  * @discussion
  *
+ * May be called from any thread holding a reference to the link.  Only one thread at a time runs
+ * the link specific send method; a caller that finds another thread sending on the link queues the
+ * message with athenaTransportLink_Enqueue instead, for the link's owner to send.  Messages already
+ * queued on the link are sent before this one, so a link sends messages in the order it was given them.
+ *
  * @param [in] athenaTransportLink link instance to send message on
  * @param [in] ccnxMetaMessage message to send
- * @return 0 if successful, -1 on error with errno set to indicate error
+ * @return 0 if successful or queued, -1 on error with errno set to indicate error
  *
  * Example:
  * @code
@@ -255,6 +272,84 @@ CCNxMetaMessage *athenaTransportLink_Receive(AthenaTransportLink *athenaTranspor
  */
 int athenaTransportLink_Send(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage);
 
+/**
+ * @abstract queue a message to be sent on a link by the link's owning I/O context
+ * @discussion
+ *
+ * Unlike athenaTransportLink_Send, this never calls the link specific send method, so it never blocks
+ * on the link.  It may be called concurrently from any number of threads without locking.  The message
+ * is acquired and placed on the link's lock-free multi-producer single-consumer queue.  If the queue was empty the owning context is woken through its wakeup descriptor, and it sends
+ * everything queued the next time it calls athenaTransportLink_DrainSendQueue.  The caller must hold a
+ * reference to the link for the duration of the call.
+ *
+ * @param [in] athenaTransportLink link instance to send message on
+ * @param [in] ccnxMetaMessage message to send
+ * @return 0 if queued, -1 with errno set to ENOTCONN if the link is closing or ENOBUFS if the queue is full
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+ * }
+ * @endcode
+ */
+int athenaTransportLink_Enqueue(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage);
+
+/**
+ * @abstract send every message waiting on the link's send queue
+ * @discussion
+ *
+ * Must only be called from the link's owning I/O context.  Each message is passed to the link specific send
+ * method and then released.  Nothing is drained while another thread is sending on the link, that thread
+ * sends the queued messages once it is done.
+ *
+ * @param [in] athenaTransportLink link instance to drain
+ * @return number of messages taken from the queue
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t sent = athenaTransportLink_DrainSendQueue(athenaTransportLink);
+ * }
+ * @endcode
+ */
+size_t athenaTransportLink_DrainSendQueue(AthenaTransportLink *athenaTransportLink);
+
+/**
+ * @abstract return the number of messages waiting on the link's send queue
+ * @discussion
+ *
+ * @param [in] athenaTransportLink link instance to query
+ * @return number of queued messages
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t depth = athenaTransportLink_GetSendQueueDepth(athenaTransportLink);
+ * }
+ * @endcode
+ */
+size_t athenaTransportLink_GetSendQueueDepth(AthenaTransportLink *athenaTransportLink);
+
+/**
+ * @abstract set the descriptor written to when the link's send queue becomes non-empty
+ * @discussion
+ *
+ * Set by the owning I/O context, usually the link adapter, when the link is added.  An 8 byte count is
+ * written so that both an eventfd and a pipe may be used.  -1 disables wakeups.
+ *
+ * @param [in] athenaTransportLink link instance
+ * @param [in] wakeupFd descriptor to write to
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaTransportLink_SetWakeupFd(athenaTransportLink, wakeupFd);
+ * }
+ * @endcode
+ */
+void athenaTransportLink_SetWakeupFd(AthenaTransportLink *athenaTransportLink, int wakeupFd);
+
 /**
  * @abstract called to return the name of the transport link
  * @discussion
@@ -530,6 +625,65 @@ void athenaTransportLink_ForceLocal(AthenaTransportLink *athenaTransportLink, in
  */
 bool athenaTransportLink_IsForceLocal(AthenaTransportLink *athenaTransportLink);
 
+/**
+ * @abstract trust the link to push unsolicited content into the content store
+ * @discussion
+ *
+ * Content Objects received on a trusted-push link which match no PIT entry are admitted into the
+ * content store, up to pushQuota bytes in each AthenaTransportLinkPushQuotaWindowMillis period.
+ * The quota is not inherited by links cloned from this one, such as the connections accepted by a
+ * listener, only links opened to a configured peer are trusted.
+ *
+ * @param [in] athenaTransportLink link instance
+ * @param [in] pushQuota bytes admitted per period, 0 if the link is not trusted to push
+ *
+ * Example:
+ * @code
+ * {
+ *     athenaTransportLink_SetPushQuota(athenaTransportLink, 1024 * 1024);
+ * }
+ * @endcode
+ */
+void athenaTransportLink_SetPushQuota(AthenaTransportLink *athenaTransportLink, size_t pushQuota);
+
+/**
+ * @abstract return the link's byte quota of unsolicited content
+ * @discussion
+ *
+ * @param [in] athenaTransportLink link instance
+ * @return bytes admitted per period, 0 if the link is not trusted to push
+ *
+ * Example:
+ * @code
+ * {
+ *     bool trusted = athenaTransportLink_GetPushQuota(athenaTransportLink) > 0;
+ * }
+ * @endcode
+ */
+size_t athenaTransportLink_GetPushQuota(AthenaTransportLink *athenaTransportLink);
+
+/**
+ * @abstract charge unsolicited content against the link's push quota
+ * @discussion
+ *
+ * The bytes are only charged if they are admitted.
+ *
+ * @param [in] athenaTransportLink link instance
+ * @param [in] sizeInBytes size of the unsolicited Content Object's message
+ * @param [in] nowInMillis current time
+ * @return true if the link is trusted to push and the content fits in what is left of its quota
+ *
+ * Example:
+ * @code
+ * {
+ *     if (athenaTransportLink_AdmitPush(athenaTransportLink, sizeInBytes, nowInMillis)) {
+ *         athenaContentStore_PutContentObject(athenaContentStore, contentObject);
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaTransportLink_AdmitPush(AthenaTransportLink *athenaTransportLink, size_t sizeInBytes, uint64_t nowInMillis);
+
 /**
  * Set the logging level for a link
  *
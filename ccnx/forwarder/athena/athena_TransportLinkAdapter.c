@@ -78,11 +78,32 @@
 #include <LongBow/runtime.h>
 
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
 #include <ccnx/forwarder/athena/athena.h>
 #include <ccnx/forwarder/athena/athena_TransportLinkAdapter.h>
+#include <ccnx/forwarder/athena/athena_Stats.h>
+
+typedef enum {
+    _AthenaTransportLinkAdapterCounter_MessageSent,
+    _AthenaTransportLinkAdapterCounter_MessageSend_Attempted,
+    _AthenaTransportLinkAdapterCounter_MessageSend_HopLimitExceeded,
+    _AthenaTransportLinkAdapterCounter_MessageSend_LinkDoesNotExist,
+    _AthenaTransportLinkAdapterCounter_MessageSend_LinkNotAcceptingSendRequests,
+    _AthenaTransportLinkAdapterCounter_MessageSend_LinkSendFailed,
+    _AthenaTransportLinkAdapterCounter_MessageSend_Dequeued,
+    _AthenaTransportLinkAdapterCounter_MessageReceived,
+    _AthenaTransportLinkAdapterCounter_MessageReceive_Attempted,
+    _AthenaTransportLinkAdapterCounter_MessageReceive_LinkDoesNotExist,
+    _AthenaTransportLinkAdapterCounter_MessageReceive_NoMessage,
+    _AthenaTransportLinkAdapterCounter_Count
+} _AthenaTransportLinkAdapterCounter;
 
 /**
  * @typedef AthenaTransportLinkAdapter
@@ -96,22 +117,12 @@ struct AthenaTransportLinkAdapter {
     struct pollfd *pollfdSendList;
     AthenaTransportLink **pollfdTransportLink;
     int pollfdListSize;
+    int wakeupFd[2]; // read and write ends written by link send queues, polled in pollfdReceiveList slot 0
     void (*removeLink)(AthenaTransportLinkAdapter_RemoveLinkCallbackContext removeLinkContext, PARCBitVector *parcBitVector);
     AthenaTransportLinkAdapter_RemoveLinkCallbackContext removeLinkContext;
     int nextLinkToRead;
     PARCLog *log;
-    struct {
-        size_t messageSent;
-        size_t messageSend_Attempted;
-        size_t messageSend_HopLimitExceeded;
-        size_t messageSend_LinkDoesNotExist;
-        size_t messageSend_LinkNotAcceptingSendRequests;
-        size_t messageSend_LinkSendFailed;
-        size_t messageReceived;
-        size_t messageReceive_Attempted;
-        size_t messageReceive_LinkDoesNotExist;
-        size_t messageReceive_NoMessage;
-    } stats;
+    AthenaStats *stats;          // _AthenaTransportLinkAdapterCounter counts
 };
 
 void
@@ -141,10 +152,32 @@ athenaTransportLinkAdapter_Destroy(AthenaTransportLinkAdapter **athenaTransportL
         parcMemory_Deallocate(&((*athenaTransportLinkAdapter)->pollfdSendList));
         parcMemory_Deallocate(&((*athenaTransportLinkAdapter)->pollfdTransportLink));
     }
+    close((*athenaTransportLinkAdapter)->wakeupFd[0]);
+    if ((*athenaTransportLinkAdapter)->wakeupFd[1] != (*athenaTransportLinkAdapter)->wakeupFd[0]) {
+        close((*athenaTransportLinkAdapter)->wakeupFd[1]);
+    }
+    athenaStats_Release(&((*athenaTransportLinkAdapter)->stats));
     parcLog_Release(&((*athenaTransportLinkAdapter)->log));
     parcMemory_Deallocate(athenaTransportLinkAdapter);
 }
 
+void
+athenaTransportLinkAdapter_GetStats(const AthenaTransportLinkAdapter *athenaTransportLinkAdapter, AthenaTransportLinkAdapterStats *stats)
+{
+    const AthenaStats *counts = athenaTransportLinkAdapter->stats;
+    stats->messageSent = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSent);
+    stats->messageSend_Attempted = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSend_Attempted);
+    stats->messageSend_HopLimitExceeded = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSend_HopLimitExceeded);
+    stats->messageSend_LinkDoesNotExist = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSend_LinkDoesNotExist);
+    stats->messageSend_LinkNotAcceptingSendRequests = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSend_LinkNotAcceptingSendRequests);
+    stats->messageSend_LinkSendFailed = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSend_LinkSendFailed);
+    stats->messageSend_Dequeued = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageSend_Dequeued);
+    stats->messageReceived = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageReceived);
+    stats->messageReceive_Attempted = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageReceive_Attempted);
+    stats->messageReceive_LinkDoesNotExist = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageReceive_LinkDoesNotExist);
+    stats->messageReceive_NoMessage = athenaStats_Get(counts, _AthenaTransportLinkAdapterCounter_MessageReceive_NoMessage);
+}
+
 PARCLog *
 athenaTransportLinkAdapter_GetLogger(AthenaTransportLinkAdapter *athenaTransportLinkAdapter)
 {
@@ -168,6 +201,48 @@ _parc_logger_create(void)
     return log;
 }
 
+/**
+ * @abstract create the descriptor pair links use to wake the adapter when their send queue becomes non-empty
+ * @discussion
+ *
+ * An eventfd where available, otherwise a non-blocking pipe.  The read end occupies slot 0 of the
+ * receive poll list, with no link associated, so a blocked poll returns as soon as another thread queues
+ * a message.
+ *
+ * @param [in] athenaTransportLinkAdapter link adapter instance
+ */
+static void
+_createWakeup(AthenaTransportLinkAdapter *athenaTransportLinkAdapter)
+{
+#ifdef __linux__
+    int wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    assertFalse(wakeupFd == -1, "eventfd failed to create a send queue wakeup: %s", strerror(errno));
+    athenaTransportLinkAdapter->wakeupFd[0] = wakeupFd;
+    athenaTransportLinkAdapter->wakeupFd[1] = wakeupFd;
+#else
+    int result = pipe(athenaTransportLinkAdapter->wakeupFd);
+    assertFalse(result == -1, "pipe failed to create a send queue wakeup: %s", strerror(errno));
+    for (int end = 0; end < 2; end++) {
+        fcntl(athenaTransportLinkAdapter->wakeupFd[end], F_SETFL, O_NONBLOCK);
+        fcntl(athenaTransportLinkAdapter->wakeupFd[end], F_SETFD, FD_CLOEXEC);
+    }
+#endif
+
+    athenaTransportLinkAdapter->pollfdReceiveList = parcMemory_Allocate(sizeof(struct pollfd));
+    assertNotNull(athenaTransportLinkAdapter->pollfdReceiveList, "parcMemory_Allocate failed to create the pollfdReceiveList");
+    athenaTransportLinkAdapter->pollfdSendList = parcMemory_Allocate(sizeof(struct pollfd));
+    assertNotNull(athenaTransportLinkAdapter->pollfdSendList, "parcMemory_Allocate failed to create the pollfdSendList");
+    athenaTransportLinkAdapter->pollfdTransportLink = parcMemory_Allocate(sizeof(AthenaTransportLink *));
+    assertNotNull(athenaTransportLinkAdapter->pollfdTransportLink, "parcMemory_Allocate failed to create the pollfdTransportLink list");
+
+    athenaTransportLinkAdapter->pollfdReceiveList[0].fd = athenaTransportLinkAdapter->wakeupFd[0];
+    athenaTransportLinkAdapter->pollfdReceiveList[0].events = POLLIN;
+    athenaTransportLinkAdapter->pollfdSendList[0].fd = -1;
+    athenaTransportLinkAdapter->pollfdSendList[0].events = 0;
+    athenaTransportLinkAdapter->pollfdTransportLink[0] = NULL;
+    athenaTransportLinkAdapter->pollfdListSize = 1;
+}
+
 AthenaTransportLinkAdapter *
 athenaTransportLinkAdapter_Create(void (*removeLinkCallback)(void *removeLinkContext, PARCBitVector *parcBitVector), AthenaTransportLinkAdapter_RemoveLinkCallbackContext removeLinkContext)
 {
@@ -181,6 +256,8 @@ athenaTransportLinkAdapter_Create(void (*removeLinkCallback)(void *removeLinkCon
     athenaTransportLinkAdapter->removeLink = removeLinkCallback;
     athenaTransportLinkAdapter->removeLinkContext = removeLinkContext;
     athenaTransportLinkAdapter->log = _parc_logger_create();
+    athenaTransportLinkAdapter->stats = athenaStats_Create(_AthenaTransportLinkAdapterCounter_Count, 0, 0, NULL);
+    _createWakeup(athenaTransportLinkAdapter);
 
     return athenaTransportLinkAdapter;
 }
@@ -206,9 +283,9 @@ _add_to_pollfdList(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, Athen
 {
     int index;
 
-    // Check for an existing availble slot
+    // Check for an existing availble slot, slot 0 is the send queue wakeup and is never free
     for (index = 0; index < athenaTransportLinkAdapter->pollfdListSize; index++) {
-        if (athenaTransportLinkAdapter->pollfdTransportLink[index] == NULL) {
+        if (athenaTransportLinkAdapter->pollfdReceiveList[index].fd == -1) {
             athenaTransportLinkAdapter->pollfdTransportLink[index] = newTransportLink;
             athenaTransportLinkAdapter->pollfdReceiveList[index].fd = eventFd;
             athenaTransportLinkAdapter->pollfdReceiveList[index].events = POLLIN;
@@ -329,6 +406,9 @@ _athenaTransportLinkAdapter_AddLink(AthenaTransportLinkAdapter *athenaTransportL
         }
     }
 
+    // Messages queued on the link by other threads wake us through our poll list.
+    athenaTransportLink_SetWakeupFd(newTransportLink, athenaTransportLinkAdapter->wakeupFd[1]);
+
     // If any transport link has a registered file descriptor add it to the general polling list.
     int eventFd = athenaTransportLink_GetEventFd(newTransportLink);
     if (eventFd != -1) {
@@ -361,6 +441,9 @@ _athenaTransportLinkAdapter_RemoveLink(AthenaTransportLinkAdapter *athenaTranspo
 {
     int linkId = -1;
 
+    // Stop threads still holding a reference from waking us once the link is gone
+    athenaTransportLink_SetWakeupFd(athenaTransportLink, -1);
+
     // if this is a listener it can simply be removed
     if (athenaTransportLink_IsNotRoutable(athenaTransportLink)) {
         if (athenaTransportLinkAdapter->listenerList) {
@@ -494,6 +577,45 @@ athenaTransportLinkAdapter_Open(AthenaTransportLinkAdapter *athenaTransportLinkA
     return athenaTransportLink_GetName(athenaTransportLink);
 }
 
+/**
+ * @abstract send everything other threads have queued on our links
+ * @discussion
+ *
+ * @param [in] athenaTransportLinkAdapter link adapter instance
+ * @return true if a queue still has messages, because a producer was caught part way through an enqueue
+ */
+static bool
+_drainSendQueues(AthenaTransportLinkAdapter *athenaTransportLinkAdapter)
+{
+    bool pending = false;
+
+    for (int index = 0; index < parcArrayList_Size(athenaTransportLinkAdapter->instanceList); index++) {
+        AthenaTransportLink *athenaTransportLink = parcArrayList_Get(athenaTransportLinkAdapter->instanceList, index);
+        if (athenaTransportLink && athenaTransportLink_GetSendQueueDepth(athenaTransportLink)) {
+            athenaStats_Add(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_Dequeued,
+                            athenaTransportLink_DrainSendQueue(athenaTransportLink));
+            if (athenaTransportLink_GetSendQueueDepth(athenaTransportLink)) {
+                pending = true;
+            }
+        }
+    }
+    return pending;
+}
+
+bool
+athenaTransportLinkAdapter_FlushSendQueues(AthenaTransportLinkAdapter *athenaTransportLinkAdapter)
+{
+    return _drainSendQueues(athenaTransportLinkAdapter);
+}
+
+static void
+_consumeWakeup(AthenaTransportLinkAdapter *athenaTransportLinkAdapter)
+{
+    uint64_t count[8];
+    while (read(athenaTransportLinkAdapter->wakeupFd[0], count, sizeof(count)) > 0) {
+    }
+}
+
 int
 athenaTransportLinkAdapter_Poll(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int timeout)
 {
@@ -511,6 +633,11 @@ athenaTransportLinkAdapter_Poll(AthenaTransportLinkAdapter *athenaTransportLinkA
         }
     }
 
+    // Flush sends queued by other threads, and don't block if one of them is still mid-enqueue
+    if (_drainSendQueues(athenaTransportLinkAdapter)) {
+        timeout = 0;
+    }
+
     if (events) { // if we have existing events, poll doesn't need to block
         timeout = 0;
     }
@@ -520,6 +647,10 @@ athenaTransportLinkAdapter_Poll(AthenaTransportLinkAdapter *athenaTransportLinkA
         parcLog_Error(athenaTransportLinkAdapter_GetLogger(athenaTransportLinkAdapter),
                       "Receive list poll error: (%d) %s", errno, strerror(errno));
     } else {
+        if (pollfdReceiveList[0].revents & POLLIN) {
+            _consumeWakeup(athenaTransportLinkAdapter);
+            _drainSendQueues(athenaTransportLinkAdapter);
+        }
         for (int index = 0; index < pollfdListSize; index++) {
             if (pollfdReceiveList[index].revents) {
                 AthenaTransportLink *athenaTransportLink = athenaTransportLinkAdapter->pollfdTransportLink[index];
@@ -624,22 +755,22 @@ _retrieve_next_message(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, P
     // set and returned as the linkId of the message received, or set to zero and returned
     // if there is no message.
     for (; index < parcArrayList_Size(list); index++) {
-        athenaTransportLinkAdapter->stats.messageReceive_Attempted++;
+        athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageReceive_Attempted);
         AthenaTransportLink *athenaTransportLink = parcArrayList_Get(list, index);
         if (athenaTransportLink == NULL) {
-            athenaTransportLinkAdapter->stats.messageReceive_LinkDoesNotExist++;
+            athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageReceive_LinkDoesNotExist);
             continue;
         }
         if (athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Receive) {
             ccnxMetaMessage = athenaTransportLink_Receive(athenaTransportLink);
             if (ccnxMetaMessage) {
-                athenaTransportLinkAdapter->stats.messageReceived++;
+                athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageReceived);
                 if (linkId) {
                     *linkId = index;
                 }
                 return ccnxMetaMessage;
             } else {
-                athenaTransportLinkAdapter->stats.messageReceive_NoMessage++;
+                athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageReceive_NoMessage);
             }
         }
     }
@@ -663,7 +794,6 @@ athenaTransportLinkAdapter_Receive(AthenaTransportLinkAdapter *athenaTransportLi
     if (ccnxMetaMessage) {
         parcBitVector_Set(*resultVector, linkId);
         athenaTransportLinkAdapter->nextLinkToRead = linkId + 1;
-        athenaTransportLinkAdapter->stats.messageReceived++;
         return ccnxMetaMessage;
     }
 
@@ -685,7 +815,6 @@ athenaTransportLinkAdapter_Receive(AthenaTransportLinkAdapter *athenaTransportLi
     if (ccnxMetaMessage) {
         parcBitVector_Set(*resultVector, linkId);
         athenaTransportLinkAdapter->nextLinkToRead = linkId + 1;
-        athenaTransportLinkAdapter->stats.messageReceived++;
         return ccnxMetaMessage;
     }
 
@@ -707,20 +836,20 @@ athenaTransportLinkAdapter_Send(AthenaTransportLinkAdapter *athenaTransportLinkA
     }
 
     while ((nextLinkToWrite = parcBitVector_NextBitSet(linkOutputVector, nextLinkToWrite)) >= 0) {
-        athenaTransportLinkAdapter->stats.messageSend_Attempted++;
+        athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_Attempted);
         if (nextLinkToWrite >= parcArrayList_Size(athenaTransportLinkAdapter->instanceList)) {
-            athenaTransportLinkAdapter->stats.messageSend_LinkDoesNotExist++;
+            athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_LinkDoesNotExist);
             nextLinkToWrite++;
             continue;
         }
         AthenaTransportLink *athenaTransportLink = parcArrayList_Get(athenaTransportLinkAdapter->instanceList, nextLinkToWrite);
         if (athenaTransportLink == NULL) {
-            athenaTransportLinkAdapter->stats.messageSend_LinkDoesNotExist++;
+            athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_LinkDoesNotExist);
             nextLinkToWrite++;
             continue;
         }
         if (!(athenaTransportLink_GetEvent(athenaTransportLink) & AthenaTransportLinkEvent_Send)) {
-            athenaTransportLinkAdapter->stats.messageSend_LinkNotAcceptingSendRequests++;
+            athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_LinkNotAcceptingSendRequests);
             nextLinkToWrite++;
             continue;
         }
@@ -729,7 +858,7 @@ athenaTransportLinkAdapter_Send(AthenaTransportLinkAdapter *athenaTransportLinkA
         if (ccnxMetaMessage_IsInterest(ccnxMetaMessage)) {
             if (athenaTransportLink_IsNotLocal(athenaTransportLink)) {
                 if (ccnxInterest_GetHopLimit(ccnxMetaMessage) == 0) {
-                    athenaTransportLinkAdapter->stats.messageSend_HopLimitExceeded++;
+                    athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_HopLimitExceeded);
                     nextLinkToWrite++;
                     continue;
                 }
@@ -737,10 +866,10 @@ athenaTransportLinkAdapter_Send(AthenaTransportLinkAdapter *athenaTransportLinkA
         }
         int result = athenaTransportLink_Send(athenaTransportLink, ccnxMetaMessage);
         if (result == 0) {
-            athenaTransportLinkAdapter->stats.messageSent++;
+            athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSent);
             parcBitVector_Set(resultVector, nextLinkToWrite);
         } else {
-            athenaTransportLinkAdapter->stats.messageSend_LinkSendFailed++;
+            athenaStats_Increment(athenaTransportLinkAdapter->stats, _AthenaTransportLinkAdapterCounter_MessageSend_LinkSendFailed);
         }
         nextLinkToWrite++;
     }
@@ -763,6 +892,21 @@ athenaTransportLinkAdapter_LinkIdToName(AthenaTransportLinkAdapter *athenaTransp
     return NULL;
 }
 
+AthenaTransportLink *
+athenaTransportLinkAdapter_AcquireLink(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int linkId)
+{
+    if ((athenaTransportLinkAdapter->instanceList == NULL) || (linkId < 0)) {
+        return NULL;
+    }
+    if (linkId < parcArrayList_Size(athenaTransportLinkAdapter->instanceList)) {
+        AthenaTransportLink *athenaTransportLink = parcArrayList_Get(athenaTransportLinkAdapter->instanceList, linkId);
+        if (athenaTransportLink) {
+            return athenaTransportLink_Acquire(athenaTransportLink);
+        }
+    }
+    return NULL;
+}
+
 int
 athenaTransportLinkAdapter_LinkNameToId(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, const char *linkName)
 {
@@ -795,6 +939,94 @@ athenaTransportLinkAdapter_IsNotLocal(AthenaTransportLinkAdapter *athenaTranspor
     return false;
 }
 
+bool
+athenaTransportLinkAdapter_AdmitPush(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int linkId,
+                                     size_t sizeInBytes, uint64_t nowInMillis)
+{
+    if (athenaTransportLinkAdapter->instanceList == NULL) {
+        return false;
+    }
+    if ((linkId >= 0) && (linkId < parcArrayList_Size(athenaTransportLinkAdapter->instanceList))) {
+        AthenaTransportLink *athenaTransportLink = parcArrayList_Get(athenaTransportLinkAdapter->instanceList, linkId);
+        if (athenaTransportLink) {
+            return athenaTransportLink_AdmitPush(athenaTransportLink, sizeInBytes, nowInMillis);
+        }
+    }
+    return false;
+}
+
+/**
+ * @typedef AthenaTransportLinkSnapshotEntry
+ * @brief Copy of the attributes of a link, made for a snapshot
+ */
+typedef struct athena_transportlink_snapshot_entry {
+    char *linkName;
+    int index;
+    bool notLocal;
+    bool localForced;
+    size_t pushQuota;
+} _AthenaTransportLinkSnapshotEntry;
+
+static void
+_athenaTransportLinkSnapshotEntry_Destroy(_AthenaTransportLinkSnapshotEntry **entryPtr)
+{
+    parcMemory_Deallocate(&(*entryPtr)->linkName);
+}
+
+static PARCJSON *
+_athenaTransportLinkSnapshotEntry_ToJSON(const _AthenaTransportLinkSnapshotEntry *entry)
+{
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddString(json, "linkName", entry->linkName);
+    parcJSON_AddInteger(json, "index", entry->index);
+    parcJSON_AddBoolean(json, "notLocal", entry->notLocal);
+    parcJSON_AddBoolean(json, "localForced", entry->localForced);
+    if (entry->pushQuota > 0) {
+        parcJSON_AddInteger(json, "pushQuota", entry->pushQuota);
+    }
+    return json;
+}
+
+parcObject_ExtendPARCObject(_AthenaTransportLinkSnapshotEntry, _athenaTransportLinkSnapshotEntry_Destroy,
+                            NULL, NULL, NULL, NULL, NULL, _athenaTransportLinkSnapshotEntry_ToJSON);
+
+static
+parcObject_ImplementRelease(_athenaTransportLinkSnapshotEntry, _AthenaTransportLinkSnapshotEntry);
+
+static void
+_appendLinkToSnapshot(AthenaSnapshot *snapshot, AthenaTransportLink *athenaTransportLink, int index)
+{
+    const char *linkName = athenaTransportLink_GetName(athenaTransportLink);
+
+    _AthenaTransportLinkSnapshotEntry *entry = parcObject_CreateInstance(_AthenaTransportLinkSnapshotEntry);
+    entry->linkName = parcMemory_StringDuplicate(linkName, strlen(linkName));
+    entry->index = index;
+    entry->notLocal = athenaTransportLink_IsNotLocal(athenaTransportLink);
+    entry->localForced = athenaTransportLink_IsForceLocal(athenaTransportLink);
+    entry->pushQuota = athenaTransportLink_GetPushQuota(athenaTransportLink);
+    athenaSnapshot_Append(snapshot, entry);
+    _athenaTransportLinkSnapshotEntry_Release(&entry);
+}
+
+AthenaSnapshot *
+athenaTransportLinkAdapter_CreateSnapshot(AthenaTransportLinkAdapter *athenaTransportLinkAdapter)
+{
+    AthenaSnapshot *snapshot = athenaSnapshot_Create("links", 0);
+
+    // Listeners are reported with an index of -1 as they are not routable, as in the link list
+    for (int index = 0; index < parcArrayList_Size(athenaTransportLinkAdapter->listenerList); index++) {
+        _appendLinkToSnapshot(snapshot, parcArrayList_Get(athenaTransportLinkAdapter->listenerList, index), -1);
+    }
+    for (int index = 0; index < parcArrayList_Size(athenaTransportLinkAdapter->instanceList); index++) {
+        AthenaTransportLink *athenaTransportLink = parcArrayList_Get(athenaTransportLinkAdapter->instanceList, index);
+        if (athenaTransportLink) {
+            _appendLinkToSnapshot(snapshot, athenaTransportLink, index);
+        }
+    }
+
+    return snapshot;
+}
+
 static CCNxMetaMessage *
 _create_linkList_response(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, CCNxName *ccnxName)
 {
@@ -810,6 +1042,10 @@ _create_linkList_response(AthenaTransportLinkAdapter *athenaTransportLinkAdapter
         parcJSON_AddInteger(jsonItem, "index", -1);
         parcJSON_AddBoolean(jsonItem, "notLocal", notLocal);
         parcJSON_AddBoolean(jsonItem, "localForced", localForced);
+        size_t pushQuota = athenaTransportLink_GetPushQuota(athenaTransportLink);
+        if (pushQuota > 0) {
+            parcJSON_AddInteger(jsonItem, "pushQuota", pushQuota);
+        }
 
         PARCJSONValue *jsonItemValue = parcJSONValue_CreateFromJSON(jsonItem);
         parcJSON_Release(&jsonItem);
@@ -834,6 +1070,10 @@ _create_linkList_response(AthenaTransportLinkAdapter *athenaTransportLinkAdapter
             parcJSON_AddInteger(jsonItem, "index", index);
             parcJSON_AddBoolean(jsonItem, "notLocal", notLocal);
             parcJSON_AddBoolean(jsonItem, "localForced", localForced);
+            size_t pushQuota = athenaTransportLink_GetPushQuota(athenaTransportLink);
+            if (pushQuota > 0) {
+                parcJSON_AddInteger(jsonItem, "pushQuota", pushQuota);
+            }
 
             PARCJSONValue *jsonItemValue = parcJSONValue_CreateFromJSON(jsonItem);
             parcJSON_Release(&jsonItem);
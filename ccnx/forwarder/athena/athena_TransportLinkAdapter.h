@@ -43,6 +43,7 @@ typedef struct AthenaTransportLinkAdapter AthenaTransportLinkAdapter;
 
 #include <ccnx/forwarder/athena/athena_TransportLinkModule.h>
 #include <ccnx/forwarder/athena/athena_TransportLink.h>
+#include <ccnx/forwarder/athena/athena_Snapshot.h>
 
 //
 // Transport Link Adapter interfaces
@@ -56,6 +57,8 @@ typedef struct AthenaTransportLinkAdapter AthenaTransportLinkAdapter;
 //
 //    athenaTransportLinkAdapter_Send
 //    athenaTransportLinkAdapter_Receive
+//    athenaTransportLinkAdapter_AcquireLink
+//    athenaTransportLinkAdapter_GetStats
 //
 //    athenaTransportLinkAdapter_LinkIdToName
 //    athenaTransportLinkAdapter_LinkNameToId
@@ -79,6 +82,24 @@ typedef void *AthenaTransportLinkAdapter_RemoveLinkCallbackContext;
  */
 typedef void (AthenaTransportLinkAdapter_RemoveLinkCallback)(AthenaTransportLinkAdapter_RemoveLinkCallbackContext removeLinkContext, PARCBitVector *parcBitVector);
 
+/**
+ * @typedef AthenaTransportLinkAdapterStats
+ * @brief Counts of the messages sent and received through a link adapter, summed over every thread
+ */
+typedef struct athena_transport_link_adapter_stats {
+    uint64_t messageSent;
+    uint64_t messageSend_Attempted;
+    uint64_t messageSend_HopLimitExceeded;
+    uint64_t messageSend_LinkDoesNotExist;
+    uint64_t messageSend_LinkNotAcceptingSendRequests;
+    uint64_t messageSend_LinkSendFailed;
+    uint64_t messageSend_Dequeued;             // sent from link send queues
+    uint64_t messageReceived;
+    uint64_t messageReceive_Attempted;
+    uint64_t messageReceive_LinkDoesNotExist;
+    uint64_t messageReceive_NoMessage;
+} AthenaTransportLinkAdapterStats;
+
 /**
  * @abstract create a new instance of a link adapter
  * @discussion
@@ -258,6 +279,28 @@ const char *athenaTransportLinkAdapter_Open(AthenaTransportLinkAdapter *athenaTr
  */
 int athenaTransportLinkAdapter_Poll(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int timeout);
 
+/**
+ * @abstract Send everything other threads have queued on the adapter's links
+ * @discussion
+ *
+ * Poll flushes the send queues as a matter of course, this is for callers that need them empty
+ * before going on, such as a forwarder draining before it exits.  A queue being sent on by another
+ * thread, or caught part way through an enqueue, is left for a later call.
+ *
+ * @param [in] athenaTransportLinkAdapter link adapter instance
+ * @return true if messages are still queued, false once every queue is empty
+ *
+ * Example:
+ * @code
+ * {
+ *     while (athenaTransportLinkAdapter_FlushSendQueues(athenaTransportLinkAdapter)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaTransportLinkAdapter_FlushSendQueues(AthenaTransportLinkAdapter *athenaTransportLinkAdapter);
+
 /**
  * @abstract Close down and remove a link from the AthenaTransportLinkAdapter instance list
  * @discussion
@@ -312,6 +355,51 @@ PARCBitVector *athenaTransportLinkAdapter_Close(AthenaTransportLinkAdapter *athe
 const char *athenaTransportLinkAdapter_LinkIdToName(AthenaTransportLinkAdapter *athenaTransportLinkAdapter,
                                                     int linkId);
 
+/**
+ * @abstract acquire a reference to the link instance associated with an internal link identifier
+ * @discussion
+ *
+ * Must be called from the thread that owns the link adapter.  The returned reference may be handed to
+ * other threads, which can then queue messages on the link with athenaTransportLink_Enqueue without
+ * locking; the adapter sends them from its next poll.  The caller releases the reference when done.
+ *
+ * @param [in] athenaTransportLinkAdapter link adapter instance
+ * @param [in] linkId internal link identifier
+ * @return a new reference to the link, NULL if linkId was not found
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaTransportLink *athenaTransportLink = athenaTransportLinkAdapter_AcquireLink(tla, linkId);
+ *     if (athenaTransportLink) {
+ *         athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+ *         athenaTransportLink_Release(&athenaTransportLink);
+ *     }
+ * }
+ * @endcode
+ */
+AthenaTransportLink *athenaTransportLinkAdapter_AcquireLink(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int linkId);
+
+/**
+ * @abstract read the counts of messages sent and received through a link adapter
+ * @discussion
+ *
+ * May be called from any thread.  The counts are kept per thread and summed as they are read.
+ *
+ * @param [in] athenaTransportLinkAdapter link adapter instance
+ * @param [out] stats filled in with the counts
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaTransportLinkAdapterStats stats;
+ *     athenaTransportLinkAdapter_GetStats(tla, &stats);
+ * }
+ * @endcode
+ */
+void athenaTransportLinkAdapter_GetStats(const AthenaTransportLinkAdapter *athenaTransportLinkAdapter,
+                                         AthenaTransportLinkAdapterStats *stats);
+
 /**
  * @abstract find the internal link identifier associated with a specific link name
  * @discussion
@@ -375,6 +463,30 @@ int athenaTransportLinkAdapter_CloseByName(AthenaTransportLinkAdapter *athenaTra
  */
 bool athenaTransportLinkAdapter_IsNotLocal(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int linkId);
 
+/**
+ * @abstract tell us if unsolicited content received on a link may be admitted into the content store
+ * @discussion
+ *
+ * The content is charged against the link's push quota if it is admitted.
+ *
+ * @param [in] athenaTransportLinkAdapter link adapter instance
+ * @param [in] linkId link instance the content was received on
+ * @param [in] sizeInBytes size of the unsolicited Content Object's message
+ * @param [in] nowInMillis current time
+ * @return true if the link is trusted to push and the content fits in its quota, false if not
+ *
+ * Example:
+ * @code
+ * {
+ *     if (athenaTransportLinkAdapter_AdmitPush(athenaTransportLinkAdapter, linkId, sizeInBytes, nowInMillis)) {
+ *         athenaContentStore_PutContentObject(athenaContentStore, contentObject);
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaTransportLinkAdapter_AdmitPush(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, int linkId,
+                                          size_t sizeInBytes, uint64_t nowInMillis);
+
 /**
  * Process a message (e.g. an Interest) addressed to this module. For example, it might be a
  * message asking for a particular statistic or a control message. The response can be NULL,
@@ -388,6 +500,17 @@ bool athenaTransportLinkAdapter_IsNotLocal(AthenaTransportLinkAdapter *athenaTra
  */
 CCNxMetaMessage *athenaTransportLinkAdapter_ProcessMessage(AthenaTransportLinkAdapter *athenaTransportLinkAdapter, const CCNxMetaMessage *message);
 
+/**
+ * Take a snapshot of the link table.  Each listener and link instance is copied into the snapshot
+ * as its name, index (-1 for listeners) and locality, rendered as
+ * {"linkName", "index", "notLocal", "localForced"}, so that links may come and go while the
+ * snapshot is rendered.
+ *
+ * @param athenaTransportLinkAdapter instance
+ * @return a new `AthenaSnapshot`, to be released with `athenaSnapshot_Release`.
+ */
+AthenaSnapshot *athenaTransportLinkAdapter_CreateSnapshot(AthenaTransportLinkAdapter *athenaTransportLinkAdapter);
+
 /**
  * Set the logging level
  *
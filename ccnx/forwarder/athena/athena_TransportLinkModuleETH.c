@@ -693,6 +693,7 @@ _ETHOpenListener(AthenaTransportLinkModule *athenaTransportLinkModule, const cha
 #define LINK_NAME_SPECIFIER "name%3D"
 #define SRC_LINK_SPECIFIER "src%3D"
 #define LOCAL_LINK_FLAG "local%3D"
+#define TRUSTED_PUSH_LINK_SPECIFIER "trusted-push%3D"
 #define LINK_MTU_SIZE "mtu%3D"
 
 #include <parc/algol/parc_URIAuthority.h>
@@ -787,6 +788,7 @@ _ETHOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
     size_t mtu = 0;
 
     int forceLocal = 0;
+    size_t pushQuota = 0;
 
     PARCURIPath *remainder = parcURI_GetPath(connectionURI);
     size_t segments = parcURIPath_Count(remainder);
@@ -840,6 +842,18 @@ _ETHOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
             continue;
         }
 
+        if (strncasecmp(token, TRUSTED_PUSH_LINK_SPECIFIER, strlen(TRUSTED_PUSH_LINK_SPECIFIER)) == 0) {
+            if ((sscanf(token, "%*[^%%]%%3D%zu", &pushQuota) != 1) || (pushQuota == 0)) {
+                parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
+                              "Improper trusted-push quota specification (%s)", token);
+                parcMemory_Deallocate(&token);
+                errno = EINVAL;
+                return NULL;
+            }
+            parcMemory_Deallocate(&token);
+            continue;
+        }
+
         if (strncasecmp(token, LOCAL_LINK_FLAG, strlen(LOCAL_LINK_FLAG)) == 0) {
             if (_parse_local(athenaTransportLinkModule, token, &forceLocal) == 0) {
                 parcMemory_Deallocate(&token);
@@ -857,6 +871,14 @@ _ETHOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
         return NULL;
     }
 
+    // Anyone able to reach a listener could connect to it, only configured peers can be trusted
+    if ((pushQuota > 0) && listener) {
+        parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
+                      "Only connections, not listeners, can be trusted to push content");
+        errno = EINVAL;
+        return NULL;
+    }
+
     if (listener) {
         result = _ETHOpenListener(athenaTransportLinkModule, linkName, device, &srcMAC, mtu);
     } else {
@@ -872,6 +894,11 @@ _ETHOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
         athenaTransportLink_ForceLocal(result, forceLocal);
     }
 
+    // unsolicited content from this link is admitted into the content store
+    if (result && pushQuota) {
+        athenaTransportLink_SetPushQuota(result, pushQuota);
+    }
+
     return result;
 }
 
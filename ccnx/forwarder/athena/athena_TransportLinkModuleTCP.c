@@ -636,6 +636,7 @@ _TCPOpenListener(AthenaTransportLinkModule *athenaTransportLinkModule, const cha
 #define TCP_LISTENER_FLAG "listener"
 #define LINK_NAME_SPECIFIER "name%3D"
 #define LOCAL_LINK_FLAG "local%3D"
+#define TRUSTED_PUSH_LINK_SPECIFIER "trusted-push%3D"
 
 #include <parc/algol/parc_URIAuthority.h>
 
@@ -673,6 +674,7 @@ _TCPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
     char name[MAXPATHLEN] = { 0 };
     char localFlag[MAXPATHLEN] = { 0 };
     int forceLocal = 0;
+    size_t pushQuota = 0;
     char *linkName = NULL;
 
     PARCURIPath *remainder = parcURI_GetPath(connectionURI);
@@ -700,6 +702,18 @@ _TCPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
             continue;
         }
 
+        if (strncasecmp(token, TRUSTED_PUSH_LINK_SPECIFIER, strlen(TRUSTED_PUSH_LINK_SPECIFIER)) == 0) {
+            if ((sscanf(token, "%*[^%%]%%3D%zu", &pushQuota) != 1) || (pushQuota == 0)) {
+                parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
+                              "Improper trusted-push quota specification (%s)", token);
+                parcMemory_Deallocate(&token);
+                errno = EINVAL;
+                return NULL;
+            }
+            parcMemory_Deallocate(&token);
+            continue;
+        }
+
         if (strncasecmp(token, LOCAL_LINK_FLAG, strlen(LOCAL_LINK_FLAG)) == 0) {
             if (sscanf(token, "%*[^%%]%%3D%s", localFlag) != 1) {
                 parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
@@ -730,6 +744,14 @@ _TCPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
         return NULL;
     }
 
+    // Anyone able to reach a listener could connect to it, only configured peers can be trusted
+    if ((pushQuota > 0) && listener) {
+        parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
+                      "Only connections, not listeners, can be trusted to push content");
+        errno = EINVAL;
+        return NULL;
+    }
+
     if (listener) {
         result = _TCPOpenListener(athenaTransportLinkModule, linkName, address, port);
     } else {
@@ -741,6 +763,11 @@ _TCPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
         athenaTransportLink_ForceLocal(result, forceLocal);
     }
 
+    // unsolicited content from this link is admitted into the content store
+    if (result && pushQuota) {
+        athenaTransportLink_SetPushQuota(result, pushQuota);
+    }
+
     return result;
 }
 
@@ -778,6 +778,7 @@ _UDPOpenListener(AthenaTransportLinkModule *athenaTransportLinkModule, const cha
 #define LINK_NAME_SPECIFIER "name%3D"
 #define SRC_LINK_SPECIFIER "src%3D"
 #define LOCAL_LINK_FLAG "local%3D"
+#define TRUSTED_PUSH_LINK_SPECIFIER "trusted-push%3D"
 #define LINK_MTU_SIZE "mtu%3D"
 
 #include <parc/algol/parc_URIAuthority.h>
@@ -825,6 +826,7 @@ _UDPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
     uint16_t srcPort = 0;
     char localFlag[MAXPATHLEN] = { 0 };
     int forceLocal = 0;
+    size_t pushQuota = 0;
     char *linkName = NULL;
 
     PARCURIPath *remainder = parcURI_GetPath(connectionURI);
@@ -882,6 +884,18 @@ _UDPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
             continue;
         }
 
+        if (strncasecmp(token, TRUSTED_PUSH_LINK_SPECIFIER, strlen(TRUSTED_PUSH_LINK_SPECIFIER)) == 0) {
+            if ((sscanf(token, "%*[^%%]%%3D%zu", &pushQuota) != 1) || (pushQuota == 0)) {
+                parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
+                              "Improper trusted-push quota specification (%s)", token);
+                parcMemory_Deallocate(&token);
+                errno = EINVAL;
+                return NULL;
+            }
+            parcMemory_Deallocate(&token);
+            continue;
+        }
+
         if (strncasecmp(token, LOCAL_LINK_FLAG, strlen(LOCAL_LINK_FLAG)) == 0) {
             if (sscanf(token, "%*[^%%]%%3D%s", localFlag) != 1) {
                 parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
@@ -912,6 +926,14 @@ _UDPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
         return NULL;
     }
 
+    // Anyone able to reach a listener could connect to it, only configured peers can be trusted
+    if ((pushQuota > 0) && listener) {
+        parcLog_Error(athenaTransportLinkModule_GetLogger(athenaTransportLinkModule),
+                      "Only connections, not listeners, can be trusted to push content");
+        errno = EINVAL;
+        return NULL;
+    }
+
     struct sockaddr_in *destination = parcNetwork_SockInet4Address(address, port);
     struct sockaddr_in *source = parcNetwork_SockInet4Address(srcAddress, srcPort);
 
@@ -929,6 +951,11 @@ _UDPOpen(AthenaTransportLinkModule *athenaTransportLinkModule, PARCURI *connecti
         athenaTransportLink_ForceLocal(result, forceLocal);
     }
 
+    // unsolicited content from this link is admitted into the content store
+    if (result && pushQuota) {
+        athenaTransportLink_SetPushQuota(result, pushQuota);
+    }
+
     return result;
 }
 
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+/*
+ * Athena content store warming
+ *
+ * The list is read a line at a time as names are handed out, a line naming chunks being held until
+ * each of its chunk names has been.  Names are handed out at the job's rate measured from its
+ * start, so a forwarder busy with other messages catches up, up to AthenaWarmInterestsPerSlice at
+ * a time, rather than losing the names it could not issue.  Names fetched are held in a map until
+ * a Content Object answers them, and the job waits for those still outstanding until the last of
+ * their Interests expires.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_HashMap.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+
+#include <ccnx/forwarder/athena/athena_Warm.h>
+
+struct athena_warm {
+    PARCLog *log;
+    char *listPath;
+    FILE *list;                       // NULL once exhausted
+    int lineNumber;
+
+    CCNxName *chunkedName;            // name of the line being enumerated by chunk, NULL if none
+    uint64_t nextChunk;
+    uint64_t numChunks;
+
+    size_t interestsPerSecond;
+    uint64_t startTime;
+
+    PARCHashMap *pending;             // names fetched and not yet answered
+    uint64_t pendingUntil;            // expiry of the last Interest fetching a pending name
+
+    AthenaWarmStats stats;
+};
+
+static void
+_athenaWarm_Destroy(AthenaWarm **warmPtr)
+{
+    AthenaWarm *warm = *warmPtr;
+    if (warm->list) {
+        fclose(warm->list);
+    }
+    if (warm->chunkedName) {
+        ccnxName_Release(&warm->chunkedName);
+    }
+    parcHashMap_Release(&warm->pending);
+    parcMemory_Deallocate(&warm->listPath);
+    parcLog_Release(&warm->log);
+}
+
+parcObject_ExtendPARCObject(AthenaWarm, _athenaWarm_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+parcObject_ImplementAcquire(athenaWarm, AthenaWarm);
+
+parcObject_ImplementRelease(athenaWarm, AthenaWarm);
+
+AthenaWarm *
+athenaWarm_Create(const char *listPath, size_t interestsPerSecond, uint64_t nowInMillis, PARCLog *log)
+{
+    FILE *list = fopen(listPath, "r");
+    if (list == NULL) {
+        parcLog_Error(log, "Unable to open warming list %s: %s", listPath, strerror(errno));
+        return NULL;
+    }
+
+    AthenaWarm *warm = parcObject_CreateAndClearInstance(AthenaWarm);
+    assertNotNull(warm, "Failed to allocate a warming job");
+    warm->log = parcLog_Acquire(log);
+    warm->listPath = parcMemory_StringDuplicate(listPath, strlen(listPath));
+    warm->list = list;
+    warm->interestsPerSecond = (interestsPerSecond > 0) ? interestsPerSecond : AthenaWarmDefaultRate;
+    warm->startTime = nowInMillis;
+    warm->pending = parcHashMap_Create();
+    return warm;
+}
+
+const char *
+athenaWarm_GetListPath(const AthenaWarm *warm)
+{
+    return warm->listPath;
+}
+
+size_t
+athenaWarm_GetRate(const AthenaWarm *warm)
+{
+    return warm->interestsPerSecond;
+}
+
+/**
+ * @abstract parse a list line into a name and the number of its chunks, 0 if it isn't chunked
+ *
+ * @return the name, NULL for a blank line or one that could not be parsed
+ */
+static CCNxName *
+_athenaWarm_ParseLine(AthenaWarm *warm, char *line, uint64_t *numChunks)
+{
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+    char *uri = strtok(line, " \t\r\n");
+    if (uri == NULL) {
+        return NULL;
+    }
+    char *chunks = strtok(NULL, " \t\r\n");
+    char *extra = strtok(NULL, " \t\r\n");
+
+    *numChunks = 0;
+    if (chunks != NULL) {
+        char *end;
+        *numChunks = strtoull(chunks, &end, 10);
+        if ((*end != '\0') || (*numChunks == 0) || (extra != NULL)) {
+            parcLog_Error(warm->log, "%s:%d: expected a name and a number of chunks", warm->listPath, warm->lineNumber);
+            warm->stats.numInvalid++;
+            return NULL;
+        }
+    }
+
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    if (name == NULL) {
+        parcLog_Error(warm->log, "%s:%d: unable to parse name %s", warm->listPath, warm->lineNumber, uri);
+        warm->stats.numInvalid++;
+    }
+    return name;
+}
+
+static CCNxName *
+_athenaWarm_CreateChunkName(AthenaWarm *warm)
+{
+    CCNxName *name = ccnxName_Copy(warm->chunkedName);
+    CCNxNameSegment *chunkSegment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, warm->nextChunk);
+    ccnxName_Append(name, chunkSegment);
+    ccnxNameSegment_Release(&chunkSegment);
+
+    if (++warm->nextChunk == warm->numChunks) {
+        ccnxName_Release(&warm->chunkedName);
+    }
+    return name;
+}
+
+static CCNxName *
+_athenaWarm_ReadName(AthenaWarm *warm)
+{
+    if (warm->chunkedName) {
+        return _athenaWarm_CreateChunkName(warm);
+    }
+
+    char line[MAXPATHLEN];
+    while ((warm->list != NULL) && (fgets(line, sizeof(line), warm->list) != NULL)) {
+        warm->lineNumber++;
+        uint64_t numChunks;
+        CCNxName *name = _athenaWarm_ParseLine(warm, line, &numChunks);
+        if (name == NULL) {
+            continue;
+        }
+        if (numChunks == 0) {
+            return name;
+        }
+        warm->chunkedName = name;
+        warm->nextChunk = 0;
+        warm->numChunks = numChunks;
+        return _athenaWarm_CreateChunkName(warm);
+    }
+
+    if (warm->list) {
+        fclose(warm->list);
+        warm->list = NULL;
+    }
+    return NULL;
+}
+
+CCNxName *
+athenaWarm_CreateNextName(AthenaWarm *warm, uint64_t nowInMillis)
+{
+    uint64_t elapsed = (nowInMillis > warm->startTime) ? (nowInMillis - warm->startTime) : 0;
+    uint64_t allowed = ((elapsed * warm->interestsPerSecond) / 1000) + 1;
+    if (warm->stats.numIssued >= allowed) {
+        return NULL;
+    }
+
+    CCNxName *name = _athenaWarm_ReadName(warm);
+    if (name) {
+        warm->stats.numIssued++;
+    }
+    return name;
+}
+
+void
+athenaWarm_Hit(AthenaWarm *warm)
+{
+    warm->stats.numHits++;
+}
+
+void
+athenaWarm_Miss(AthenaWarm *warm, const CCNxName *name, uint64_t expiryInMillis)
+{
+    warm->stats.numMisses++;
+    parcHashMap_Put(warm->pending, name, name);
+    if (expiryInMillis > warm->pendingUntil) {
+        warm->pendingUntil = expiryInMillis;
+    }
+}
+
+void
+athenaWarm_NoRoute(AthenaWarm *warm)
+{
+    warm->stats.numNoRoute++;
+}
+
+bool
+athenaWarm_Fetched(AthenaWarm *warm, const CCNxName *name, size_t sizeInBytes)
+{
+    if (parcHashMap_Remove(warm->pending, name) == false) {
+        return false;
+    }
+    warm->stats.numFetched++;
+    warm->stats.bytesFetched += sizeInBytes;
+    return true;
+}
+
+bool
+athenaWarm_IsComplete(const AthenaWarm *warm, uint64_t nowInMillis)
+{
+    if ((warm->list != NULL) || (warm->chunkedName != NULL)) {
+        return false;
+    }
+    return (parcHashMap_Size(warm->pending) == 0) || (nowInMillis >= warm->pendingUntil);
+}
+
+void
+athenaWarm_GetStats(const AthenaWarm *warm, AthenaWarmStats *stats)
+{
+    *stats = warm->stats;
+    stats->numPending = parcHashMap_Size(warm->pending);
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libathena_Warm_h
+#define libathena_Warm_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <parc/logging/parc_Log.h>
+
+#include <ccnx/common/ccnx_Name.h>
+
+//
+// Content store warming
+//
+// A warming job reads a list of names and hands them back to the forwarder, at no more than a given
+// number per second, to be fetched through the usual PIT and FIB path so that the content store is
+// filled before consumers ask for the content.  Each line of the list holds a name, optionally
+// followed by a number of chunks, in which case the names of chunks 0 up to that number are warmed
+// in turn.  Text following a '#' is a comment.
+//
+//     lci:/video/trailer 240     # chunks 0 to 239 of the trailer
+//     lci:/images/logo
+//
+// The job only generates names and keeps count.  The forwarder issues the Interests, reporting
+// names found in the content store as hits and those it fetched as misses, and reports the Content
+// Objects answering them as they arrive.  The list is read as the job goes, so it may be long.
+//
+
+#define AthenaWarmDefaultRate 100               // interests issued per second when no rate is given
+#define AthenaWarmInterestsPerSlice 64          // most interests issued between two messages
+#define AthenaWarmIntervalMillis 10             // longest the forwarder waits for a message while warming
+
+/**
+ * @typedef AthenaWarmStats
+ * @brief Progress of a warming job
+ */
+typedef struct athena_warm_stats {
+    uint64_t numIssued;                         // names taken from the list
+    uint64_t numHits;                           // of those, already in the content store
+    uint64_t numMisses;                         // of those, fetched
+    uint64_t numNoRoute;                        // of those, with no route to fetch them on
+    uint64_t numFetched;                        // fetches answered with a Content Object
+    uint64_t bytesFetched;                      // payload bytes of the Content Objects fetched
+    uint64_t numPending;                        // fetches not answered yet
+    uint64_t numInvalid;                        // list lines that could not be parsed
+} AthenaWarmStats;
+
+struct athena_warm;
+typedef struct athena_warm AthenaWarm;
+
+/**
+ * @abstract start a warming job from a list of names
+ * @discussion
+ *
+ * @param [in] listPath file listing the names to warm, kept open until the job is released
+ * @param [in] interestsPerSecond most names handed out per second, 0 for AthenaWarmDefaultRate
+ * @param [in] nowInMillis time the job starts, from which its rate is measured
+ * @param [in] log to report list errors to
+ * @return a new warming job, or NULL if the list could not be opened
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaWarm *warm = athenaWarm_Create("/var/athena/warm.list", 500, nowInMillis, athena->log);
+ *     athenaWarm_Release(&warm);
+ * }
+ * @endcode
+ */
+AthenaWarm *athenaWarm_Create(const char *listPath, size_t interestsPerSecond, uint64_t nowInMillis, PARCLog *log);
+
+/**
+ * @abstract acquire a reference to a warming job
+ *
+ * @param [in] warm instance to acquire
+ * @return the same warming job
+ */
+AthenaWarm *athenaWarm_Acquire(const AthenaWarm *warm);
+
+/**
+ * @abstract release a warming job, closing its list with the last reference
+ *
+ * @param [in,out] warmPtr pointer to the warming job to release, set to NULL
+ */
+void athenaWarm_Release(AthenaWarm **warmPtr);
+
+/**
+ * @abstract the list a warming job was started from
+ *
+ * @param [in] warm warming job
+ * @return path of the list, valid for the life of the job
+ */
+const char *athenaWarm_GetListPath(const AthenaWarm *warm);
+
+/**
+ * @abstract the rate names are handed out at
+ *
+ * @param [in] warm warming job
+ * @return names per second
+ */
+size_t athenaWarm_GetRate(const AthenaWarm *warm);
+
+/**
+ * @abstract take the next name to warm, if the job's rate allows one
+ * @discussion
+ *
+ * Lines of the list that cannot be parsed are logged, counted and skipped.
+ *
+ * @param [in] warm warming job
+ * @param [in] nowInMillis current time
+ * @return a new name to be released by the caller, or NULL if the rate has been reached or the list is exhausted
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxName *name;
+ *     while ((name = athenaWarm_CreateNextName(warm, nowInMillis)) != NULL) {
+ *         ...
+ *         ccnxName_Release(&name);
+ *     }
+ * }
+ * @endcode
+ */
+CCNxName *athenaWarm_CreateNextName(AthenaWarm *warm, uint64_t nowInMillis);
+
+/**
+ * @abstract count a name that was already in the content store
+ *
+ * @param [in] warm warming job
+ */
+void athenaWarm_Hit(AthenaWarm *warm);
+
+/**
+ * @abstract count a name that was forwarded to be fetched, and wait for it until it expires
+ *
+ * @param [in] warm warming job
+ * @param [in] name name fetched, acquired until answered or the job completes
+ * @param [in] expiryInMillis time the Interest fetching it expires
+ */
+void athenaWarm_Miss(AthenaWarm *warm, const CCNxName *name, uint64_t expiryInMillis);
+
+/**
+ * @abstract count a name that could not be fetched for want of a route
+ *
+ * @param [in] warm warming job
+ */
+void athenaWarm_NoRoute(AthenaWarm *warm);
+
+/**
+ * @abstract report a Content Object that has arrived
+ * @discussion
+ *
+ * Called for every Content Object matching a PIT entry while a job is in progress.  Those
+ * answering one of the job's fetches are counted, the others are left alone.
+ *
+ * @param [in] warm warming job
+ * @param [in] name name of the Content Object
+ * @param [in] sizeInBytes payload size of the Content Object
+ * @return true if the Content Object answers a fetch by the job, and so belongs in the content store
+ *
+ * Example:
+ * @code
+ * {
+ *     if (athenaWarm_Fetched(warm, ccnxContentObject_GetName(contentObject), payloadSize)) {
+ *         athenaContentStore_PutContentObject(store, contentObject);
+ *     }
+ * }
+ * @endcode
+ */
+bool athenaWarm_Fetched(AthenaWarm *warm, const CCNxName *name, size_t sizeInBytes);
+
+/**
+ * @abstract whether a warming job is complete
+ * @discussion
+ *
+ * A job is complete once its list is exhausted and every fetch has been answered or has expired.
+ *
+ * @param [in] warm warming job
+ * @param [in] nowInMillis current time
+ * @return true if the job is complete
+ */
+bool athenaWarm_IsComplete(const AthenaWarm *warm, uint64_t nowInMillis);
+
+/**
+ * @abstract read the progress of a warming job
+ *
+ * @param [in] warm warming job
+ * @param [out] stats filled in with the job's counts
+ *
+ * Example:
+ * @code
+ * {
+ *     AthenaWarmStats stats;
+ *     athenaWarm_GetStats(warm, &stats);
+ * }
+ * @endcode
+ */
+void athenaWarm_GetStats(const AthenaWarm *warm, AthenaWarmStats *stats);
+
+#endif // libathena_Warm_h
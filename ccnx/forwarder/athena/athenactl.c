@@ -35,6 +35,8 @@
 #include <config.h>
 
 #include <sys/param.h>
+#include <sys/time.h>
+#include <unistd.h>
 #include <stdio.h>
 
 #include "athenactl.h"
@@ -42,9 +44,15 @@
 
 #include <ccnx/common/validation/ccnxValidation_CRC32C.h>
 #include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+
+// Arguments beyond this many on a line of a command file are ignored
+#define ATHENACTL_MAX_COMMAND_ARGS 16
 
 #define COMMAND_QUIT "quit"
 #define COMMAND_RUN "spawn"
+#define COMMAND_RELOAD "reload"
+#define COMMAND_DRAIN "drain"
 
 #define COMMAND_SET "set"
 #define SUBCOMMAND_SET_DEBUG "debug"
@@ -52,6 +60,7 @@
 #define SUBCOMMAND_UNSET_DEBUG "debug"
 
 #define SUBCOMMAND_SET_LEVEL "level"
+#define SUBCOMMAND_SET_STALE "stale"
 
 #define COMMAND_ADD "add"
 #define SUBCOMMAND_ADD_LINK "link"
@@ -65,6 +74,12 @@
 #define SUBCOMMAND_LIST_ROUTES "routes"
 #define SUBCOMMAND_LIST_CONNECTIONS "connections"
 
+#define COMMAND_DUMP "dump"
+
+#define COMMAND_PURGE "purge"
+#define SUBCOMMAND_PURGE_CACHE "cache"
+#define COMMAND_WARM "warm"
+
 #define COMMAND_REMOVE "remove"
 #define SUBCOMMAND_REMOVE_LINK "link"
 #define SUBCOMMAND_REMOVE_CONNECTION "connection"
@@ -80,40 +95,291 @@ athenactl_EncodeMessage(CCNxMetaMessage *message)
     parcSigner_Release(&signer);
 }
 
+/*
+ * A session holds one portal open across commands.  Commands whose response is only printed are
+ * pipelined: their interests are sent without waiting, each under a distinct name, and the responses
+ * are matched to them by name as they arrive.  Every command is given up on after its timeout.
+ */
+typedef struct {
+    CCNxName *name;
+    const char *resultPrefix;
+    uint64_t deadline;
+} _AthenactlPendingCommand;
+
+static struct {
+    CCNxPortalFactory *factory;
+    CCNxPortal *portal;
+    uint64_t sequence;
+    _AthenactlPendingCommand *pending;
+    size_t numPending;
+    size_t pendingCapacity;
+} _athenactlSession;
+
+static unsigned _athenactlTimeoutInMillis = ATHENACTL_DEFAULT_TIMEOUT_MILLIS;
+
+static uint64_t
+_athenactl_NowInMillis(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+}
+
+static char *
+_athenactl_ResponseString(CCNxMetaMessage *response)
+{
+    char *result = NULL;
+    if (ccnxMetaMessage_IsContentObject(response)) {
+        CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(response);
+        PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+        if (payload) {
+            result = parcBuffer_ToString(payload);
+        }
+    }
+    return result;
+}
+
+static void
+_athenactl_RemovePending(size_t index)
+{
+    ccnxName_Release(&_athenactlSession.pending[index].name);
+    _athenactlSession.pending[index] = _athenactlSession.pending[--_athenactlSession.numPending];
+}
+
+/*
+ * Print a response for the pipelined command it answers, returns false if it answers none of them.
+ */
+static bool
+_athenactl_CompletePending(CCNxMetaMessage *response)
+{
+    if (ccnxMetaMessage_IsContentObject(response) == false) {
+        return false;
+    }
+    CCNxName *name = ccnxContentObject_GetName(ccnxMetaMessage_GetContentObject(response));
+
+    for (size_t i = 0; i < _athenactlSession.numPending; i++) {
+        if (ccnxName_Equals(_athenactlSession.pending[i].name, name)) {
+            char *result = _athenactl_ResponseString(response);
+            if (result) {
+                printf("%s%s\n", _athenactlSession.pending[i].resultPrefix, result);
+                parcMemory_Deallocate(&result);
+            }
+            _athenactl_RemovePending(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+_athenactl_ExpirePending(uint64_t nowInMillis)
+{
+    size_t i = 0;
+    while (i < _athenactlSession.numPending) {
+        if (_athenactlSession.pending[i].deadline <= nowInMillis) {
+            char *name = ccnxName_ToString(_athenactlSession.pending[i].name);
+            printf("%stimed out waiting for %s\n", _athenactlSession.pending[i].resultPrefix, name);
+            parcMemory_Deallocate(&name);
+            _athenactl_RemovePending(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+/*
+ * Wait for the response named `name`, completing any pipelined commands answered meanwhile.
+ */
+static const char *
+_athenactl_AwaitResponse(CCNxPortal *portal, const CCNxName *name, uint64_t deadline)
+{
+    const char *result = NULL;
+
+    while (ccnxPortal_IsError(portal) == false) {
+        uint64_t nowInMillis = _athenactl_NowInMillis();
+        _athenactl_ExpirePending(nowInMillis);
+        if (nowInMillis >= deadline) {
+            char *nameString = ccnxName_ToString(name);
+            printf("timed out waiting for %s\n", nameString);
+            parcMemory_Deallocate(&nameString);
+            break;
+        }
+
+        CCNxMetaMessage *response = ccnxPortal_Receive(portal, CCNxStackTimeout_MicroSeconds((deadline - nowInMillis) * 1000));
+        if (response != NULL) {
+            bool isResult = ccnxMetaMessage_IsContentObject(response) &&
+                            ccnxName_Equals(ccnxContentObject_GetName(ccnxMetaMessage_GetContentObject(response)), name);
+            if (isResult) {
+                result = _athenactl_ResponseString(response);
+                ccnxMetaMessage_Release(&response);
+                break;
+            }
+            _athenactl_CompletePending(response);
+            ccnxMetaMessage_Release(&response);
+        }
+    }
+    return result;
+}
+
 static const char *
 _athenactl_SendInterestControl(PARCIdentity *identity, CCNxMetaMessage *message)
 {
     const char *result = NULL;
-    CCNxPortalFactory *factory = ccnxPortalFactory_Create(identity);
+    CCNxPortalFactory *factory = NULL;
+    CCNxPortal *portal = _athenactlSession.portal;
 
-    CCNxPortal *portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+    if (portal == NULL) {
+        factory = ccnxPortalFactory_Create(identity);
+        portal = ccnxPortalFactory_CreatePortal(factory, ccnxPortalRTA_Message);
+    }
 
     assertNotNull(portal, "Expected a non-null CCNxPortal pointer.");
 
     athenactl_EncodeMessage(message);
 
     if (ccnxPortal_Send(portal, message, CCNxStackTimeout_Never)) {
-        while (ccnxPortal_IsError(portal) == false) {
-            CCNxMetaMessage *response = ccnxPortal_Receive(portal, CCNxStackTimeout_Never);
-            if (response != NULL) {
-                if (ccnxMetaMessage_IsContentObject(response)) {
-                    CCNxContentObject *contentObject = ccnxMetaMessage_GetContentObject(response);
+        uint64_t deadline = _athenactl_NowInMillis() + _athenactlTimeoutInMillis;
+        result = _athenactl_AwaitResponse(portal, ccnxInterest_GetName(message), deadline);
+    }
 
-                    PARCBuffer *payload = ccnxContentObject_GetPayload(contentObject);
+    if (factory != NULL) {
+        ccnxPortal_Release(&portal);
+        ccnxPortalFactory_Release(&factory);
+    }
+    return result;
+}
 
-                    if (payload) {
-                        result = parcBuffer_ToString(payload);
-                    }
-                }
-                ccnxMetaMessage_Release(&response);
-                break;
+/*
+ * Send a command whose response is only printed, after `resultPrefix`.  Outside of a session this
+ * waits for the response, in a session the response is printed whenever it arrives.
+ */
+static void
+_athenactl_SendInterestControlAsync(PARCIdentity *identity, CCNxInterest *interest, const char *resultPrefix)
+{
+    if (_athenactlSession.portal == NULL) {
+        const char *result = _athenactl_SendInterestControl(identity, interest);
+        if (result) {
+            printf("%s%s\n", resultPrefix, result);
+            parcMemory_Deallocate(&result);
+        }
+        return;
+    }
+
+    // Identical commands must not share a name, their interests would be aggregated by the forwarder
+    char sequence[32];
+    sprintf(sequence, "athenactl=%" PRIu64, _athenactlSession.sequence++);
+    PARCBuffer *sequenceValue = parcBuffer_AllocateCString(sequence);
+    CCNxNameSegment *sequenceSegment = ccnxNameSegment_CreateTypeValue(CCNxNameLabelType_NAME, sequenceValue);
+    parcBuffer_Release(&sequenceValue);
+
+    CCNxName *name = ccnxName_Copy(ccnxInterest_GetName(interest));
+    ccnxName_Append(name, sequenceSegment);
+    ccnxNameSegment_Release(&sequenceSegment);
+
+    CCNxInterest *pipelined = ccnxInterest_CreateSimple(name);
+    PARCBuffer *payload = ccnxInterest_GetPayload(interest);
+    if (payload != NULL) {
+        ccnxInterest_SetPayload(pipelined, payload);
+    }
+    athenactl_EncodeMessage(pipelined);
+
+    if (ccnxPortal_Send(_athenactlSession.portal, pipelined, CCNxStackTimeout_Never)) {
+        if (_athenactlSession.numPending == _athenactlSession.pendingCapacity) {
+            _athenactlSession.pendingCapacity = (_athenactlSession.pendingCapacity == 0) ? 64 : _athenactlSession.pendingCapacity * 2;
+            _athenactlSession.pending = parcMemory_Reallocate(_athenactlSession.pending,
+                                                              _athenactlSession.pendingCapacity * sizeof(_AthenactlPendingCommand));
+        }
+        _AthenactlPendingCommand *pending = &_athenactlSession.pending[_athenactlSession.numPending++];
+        pending->name = ccnxName_Acquire(name);
+        pending->resultPrefix = resultPrefix;
+        pending->deadline = _athenactl_NowInMillis() + _athenactlTimeoutInMillis;
+    }
+
+    ccnxInterest_Release(&pipelined);
+    ccnxName_Release(&name);
+}
+
+void
+athenactl_SetTimeout(unsigned timeoutInMillis)
+{
+    _athenactlTimeoutInMillis = timeoutInMillis;
+}
+
+void
+athenactl_OpenSession(PARCIdentity *identity)
+{
+    assertNull(_athenactlSession.portal, "An athenactl session is already open");
+
+    _athenactlSession.factory = ccnxPortalFactory_Create(identity);
+    _athenactlSession.portal = ccnxPortalFactory_CreatePortal(_athenactlSession.factory, ccnxPortalRTA_Message);
+    assertNotNull(_athenactlSession.portal, "Expected a non-null CCNxPortal pointer.");
+}
+
+void
+athenactl_CloseSession(void)
+{
+    // Wait for the responses to the commands still in flight, or for them to time out
+    while (_athenactlSession.numPending > 0 && ccnxPortal_IsError(_athenactlSession.portal) == false) {
+        uint64_t nowInMillis = _athenactl_NowInMillis();
+        _athenactl_ExpirePending(nowInMillis);
+        if (_athenactlSession.numPending == 0) {
+            break;
+        }
+
+        uint64_t deadline = _athenactlSession.pending[0].deadline;
+        for (size_t i = 1; i < _athenactlSession.numPending; i++) {
+            if (_athenactlSession.pending[i].deadline < deadline) {
+                deadline = _athenactlSession.pending[i].deadline;
             }
         }
+
+        CCNxMetaMessage *response = ccnxPortal_Receive(_athenactlSession.portal, CCNxStackTimeout_MicroSeconds((deadline - nowInMillis) * 1000));
+        if (response != NULL) {
+            _athenactl_CompletePending(response);
+            ccnxMetaMessage_Release(&response);
+        }
     }
 
-    ccnxPortal_Release(&portal);
+    while (_athenactlSession.numPending > 0) {
+        _athenactl_RemovePending(0);
+    }
+    if (_athenactlSession.pending != NULL) {
+        parcMemory_Deallocate(&_athenactlSession.pending);
+    }
+    _athenactlSession.pendingCapacity = 0;
+
+    ccnxPortal_Release(&_athenactlSession.portal);
+    ccnxPortalFactory_Release(&_athenactlSession.factory);
+}
+
+int
+athenactl_CommandFile(PARCIdentity *identity, FILE *commandFile)
+{
+    int result = 0;
+    char line[MAXPATHLEN];
+
+    athenactl_OpenSession(identity);
+
+    while (fgets(line, sizeof(line), commandFile) != NULL) {
+        char *argv[ATHENACTL_MAX_COMMAND_ARGS];
+        int argc = 0;
+
+        // Commands are whitespace separated words, anything after a '#' is a comment
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        for (char *word = strtok(line, " \t\r\n"); word != NULL && argc < ATHENACTL_MAX_COMMAND_ARGS; word = strtok(NULL, " \t\r\n")) {
+            argv[argc++] = word;
+        }
+
+        if (argc > 0 && athenactl_Command(identity, argc, argv) != 0) {
+            result = 1;
+        }
+    }
+
+    athenactl_CloseSession();
 
-    ccnxPortalFactory_Release(&factory);
     return result;
 }
 
@@ -143,11 +409,7 @@ _athenactl_AddListener(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("Link: %s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "Link: ");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -180,11 +442,7 @@ _athenactl_AddConnection(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("Link: %s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "Link: ");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -209,11 +467,7 @@ _athenactl_AddLink(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("Link: %s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "Link: ");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -242,11 +496,7 @@ _athenactl_AddRoute(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("FIB: %s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "FIB: ");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -275,11 +525,7 @@ _athenactl_RemoveRoute(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("FIB: %s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "FIB: ");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -461,11 +707,7 @@ _athenactl_RemoveLink(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("Link: %s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "Link: ");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -499,11 +741,7 @@ _athenactl_SetDebug(PARCIdentity *identity, int argc, char **argv)
     CCNxInterest *interest = ccnxInterest_CreateSimple(name);
     ccnxName_Release(&name);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("%s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -524,12 +762,33 @@ _athenactl_SetLogLevel(PARCIdentity *identity, int argc, char **argv)
     CCNxInterest *interest = ccnxInterest_CreateSimple(name);
     ccnxName_Release(&name);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("%s\n", result);
-        parcMemory_Deallocate(&result);
+    _athenactl_SendInterestControlAsync(identity, interest, "");
+
+    ccnxMetaMessage_Release(&interest);
+
+    return 0;
+}
+
+static int
+_athenactl_SetStale(PARCIdentity *identity, int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: set stale <prefix> <milliseconds>\n");
+        return 1;
     }
 
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_ContentStoreStale);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    char arguments[MAXPATHLEN];
+    snprintf(arguments, sizeof(arguments), "%s %s", argv[0], argv[1]);
+    PARCBuffer *payload = parcBuffer_AllocateCString(arguments);
+    ccnxInterest_SetPayload(interest, payload);
+    parcBuffer_Release(&payload);
+
+    _athenactl_SendInterestControlAsync(identity, interest, "");
+
     ccnxMetaMessage_Release(&interest);
 
     return 0;
@@ -542,11 +801,7 @@ _athenactl_UnSetDebug(PARCIdentity *identity, int argc, char **argv)
     CCNxInterest *interest = ccnxInterest_CreateSimple(name);
     ccnxName_Release(&name);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("%s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -557,7 +812,7 @@ static int
 _athenactl_Set(PARCIdentity *identity, int argc, char **argv)
 {
     if (argc < 1) {
-        printf("usage: set level/debug\n");
+        printf("usage: set level/debug/stale\n");
         return 1;
     }
 
@@ -569,7 +824,10 @@ _athenactl_Set(PARCIdentity *identity, int argc, char **argv)
     if (strcasecmp(subcommand, SUBCOMMAND_SET_LEVEL) == 0) {
         return _athenactl_SetLogLevel(identity, --argc, &argv[1]);
     }
-    printf("usage: set level/debug\n");
+    if (strcasecmp(subcommand, SUBCOMMAND_SET_STALE) == 0) {
+        return _athenactl_SetStale(identity, --argc, &argv[1]);
+    }
+    printf("usage: set level/debug/stale\n");
     return 1;
 }
 
@@ -601,11 +859,21 @@ _athenactl_Quit(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("%s\n", result);
-        parcMemory_Deallocate(&result);
-    }
+    _athenactl_SendInterestControlAsync(identity, interest, "");
+
+    ccnxMetaMessage_Release(&interest);
+
+    return 0;
+}
+
+static int
+_athenactl_Drain(PARCIdentity *identity, int argc, char **argv)
+{
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_Drain);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    _athenactl_SendInterestControlAsync(identity, interest, "");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -637,11 +905,170 @@ _athenactl_Run(PARCIdentity *identity, int argc, char **argv)
     ccnxInterest_SetPayload(interest, payload);
     parcBuffer_Release(&payload);
 
-    const char *result = _athenactl_SendInterestControl(identity, interest);
-    if (result) {
-        printf("%s\n", result);
+    _athenactl_SendInterestControlAsync(identity, interest, "");
+
+    ccnxMetaMessage_Release(&interest);
+
+    return 0;
+}
+
+static int
+_athenactl_Reload(PARCIdentity *identity, int argc, char **argv)
+{
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_Reload);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    // Without a path the forwarder re-reads the configuration file it was started with
+    if (argc > 0) {
+        PARCBuffer *payload = parcBuffer_AllocateCString(argv[0]);
+        ccnxInterest_SetPayload(interest, payload);
+        parcBuffer_Release(&payload);
+    }
+
+    _athenactl_SendInterestControlAsync(identity, interest, "");
+
+    ccnxMetaMessage_Release(&interest);
+
+    return 0;
+}
+
+static int
+_athenactl_Dump(PARCIdentity *identity, int argc, char **argv)
+{
+    if (argc < 1) {
+        printf("usage: dump <%s/%s/%s/%s>\n", AthenaDump_FIB, AthenaDump_PIT, AthenaDump_ContentStore, AthenaDump_Links);
+        return 1;
+    }
+
+    // Every chunk is rendered from the snapshot the forwarder started for chunk 0 of the dump with this id,
+    // whose number of entries is only known once its last chunk has been rendered
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    char dumpId[AthenaDumpIdMaxLength + 1];
+    snprintf(dumpId, sizeof(dumpId), "%d-%ld%06ld", getpid(), (long) tv.tv_sec, (long) tv.tv_usec);
+
+    bool lastChunk = false;
+    int64_t numEntries = 0;
+    for (uint64_t chunkNumber = 0; lastChunk == false; chunkNumber++) {
+        char uri[MAXPATHLEN];
+        sprintf(uri, "%s/%s/%s", CCNxNameAthenaCommand_Dump, argv[0], dumpId);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        if (name == NULL) {
+            printf("Unable to parse table name %s\n", argv[0]);
+            return 1;
+        }
+        CCNxNameSegment *chunkSegment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, chunkNumber);
+        ccnxName_Append(name, chunkSegment);
+        ccnxNameSegment_Release(&chunkSegment);
+
+        CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+        ccnxName_Release(&name);
+
+        const char *result = _athenactl_SendInterestControl(identity, interest);
+        ccnxMetaMessage_Release(&interest);
+
+        if (result == NULL) {
+            printf("NULL result recieved from dump request\n");
+            return 1;
+        }
+
+        PARCJSON *jsonContent = parcJSON_ParseString(result);
+        if (jsonContent == NULL) {
+            printf("%s\n", result);
+            parcMemory_Deallocate(&result);
+            return 1;
+        }
         parcMemory_Deallocate(&result);
+
+        if (chunkNumber == 0) {
+            printf("%s:\n", argv[0]);
+        }
+
+        PARCJSONArray *entryList = parcJSONValue_GetArray(parcJSON_GetValueByName(jsonContent, JSON_KEY_RESULT));
+        for (size_t i = 0; i < parcJSONArray_GetLength(entryList); ++i) {
+            char *entryString = parcJSONValue_ToCompactString(parcJSONArray_GetValue(entryList, i));
+            printf("    %s\n", entryString);
+            parcMemory_Deallocate(&entryString);
+        }
+
+        lastChunk = parcJSONValue_GetBoolean(parcJSON_GetValueByName(jsonContent, "lastChunk"));
+        numEntries = parcJSONValue_GetInteger(parcJSON_GetValueByName(jsonContent, "numEntries"));
+        parcJSON_Release(&jsonContent);
     }
+    printf("(%" PRId64 " entries)\n", numEntries);
+
+    return 0;
+}
+
+static int
+_athenactl_PurgeCache(PARCIdentity *identity, int argc, char **argv)
+{
+    if (argc < 1) {
+        printf("usage: purge cache <prefix>\n");
+        return 1;
+    }
+
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_ContentStorePurge);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    PARCBuffer *payload = parcBuffer_AllocateCString(argv[0]);
+    ccnxInterest_SetPayload(interest, payload);
+    parcBuffer_Release(&payload);
+
+    _athenactl_SendInterestControlAsync(identity, interest, "");
+
+    ccnxMetaMessage_Release(&interest);
+
+    return 0;
+}
+
+static int
+_athenactl_Purge(PARCIdentity *identity, int argc, char **argv)
+{
+    if (argc < 1) {
+        printf("usage: purge cache <prefix>\n");
+        return 1;
+    }
+
+    const char *subcommand = argv[0];
+
+    if (strcasecmp(subcommand, SUBCOMMAND_PURGE_CACHE) == 0) {
+        return _athenactl_PurgeCache(identity, --argc, &argv[1]);
+    }
+    printf("usage: purge cache <prefix>\n");
+    return 1;
+}
+
+static int
+_athenactl_Warm(PARCIdentity *identity, int argc, char **argv)
+{
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_ContentStoreWarm);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    // Without a list the forwarder reports on the warming job in progress
+    if (argc > 0) {
+        char arguments[MAXPATHLEN];
+        if (argc > 1) {
+            char *end;
+            strtoul(argv[1], &end, 10);
+            if ((*end != '\0') || (end == argv[1])) {
+                printf("usage: warm [<name list file> [<interests per second>]]\n");
+                ccnxMetaMessage_Release(&interest);
+                return 1;
+            }
+            snprintf(arguments, sizeof(arguments), "%s %s", argv[0], argv[1]);
+        } else {
+            snprintf(arguments, sizeof(arguments), "%s", argv[0]);
+        }
+        PARCBuffer *payload = parcBuffer_AllocateCString(arguments);
+        ccnxInterest_SetPayload(interest, payload);
+        parcBuffer_Release(&payload);
+    }
+
+    _athenactl_SendInterestControlAsync(identity, interest, "");
 
     ccnxMetaMessage_Release(&interest);
 
@@ -652,7 +1079,7 @@ int
 athenactl_Command(PARCIdentity *identity, int argc, char **argv)
 {
     if (argc < 1) {
-        printf("commands: add/list/remove/set/unset/spawn/quit\n");
+        printf("commands: add/list/remove/set/unset/spawn/dump/purge/warm/reload/drain/quit\n");
         return 1;
     }
 
@@ -679,8 +1106,23 @@ athenactl_Command(PARCIdentity *identity, int argc, char **argv)
     if (strcasecmp(command, COMMAND_QUIT) == 0) {
         return _athenactl_Quit(identity, --argc, &argv[1]);
     }
+    if (strcasecmp(command, COMMAND_DRAIN) == 0) {
+        return _athenactl_Drain(identity, --argc, &argv[1]);
+    }
+    if (strcasecmp(command, COMMAND_RELOAD) == 0) {
+        return _athenactl_Reload(identity, --argc, &argv[1]);
+    }
+    if (strcasecmp(command, COMMAND_DUMP) == 0) {
+        return _athenactl_Dump(identity, --argc, &argv[1]);
+    }
+    if (strcasecmp(command, COMMAND_PURGE) == 0) {
+        return _athenactl_Purge(identity, --argc, &argv[1]);
+    }
+    if (strcasecmp(command, COMMAND_WARM) == 0) {
+        return _athenactl_Warm(identity, --argc, &argv[1]);
+    }
     printf("athenactl: unknown command\n");
-    printf("commands: add/list/remove/set/unset/spawn/quit\n");
+    printf("commands: add/list/remove/set/unset/spawn/dump/purge/warm/reload/drain/quit\n");
     return 1;
 }
 
@@ -690,12 +1132,18 @@ athenactl_Usage(void)
     printf("        add link <schema>://<authority>[/listener][/<options>][/name=<linkname>]\n");
     printf("            <schema> == tcp/...\n");
     printf("            <authority> == <protocol specific address/port>\n");
-    printf("            <options> == local=<true/false>\n");
+    printf("            <options> == local=<true/false>, trusted-push=<bytes per second>\n");
     printf("        remove link <linkname>\n");
     printf("        list <links/routes>\n");
     printf("        add route <linkname> lci:/<path>\n");
     printf("        remove route <linkname> lci:/<path>\n");
     printf("        set level <off/notice/info/debug/error/all>\n");
+    printf("        set stale lci:/<path> <milliseconds>\n");
     printf("        spawn <port>\n");
+    printf("        dump <fib/pit/cs/links>\n");
+    printf("        purge cache lci:/<path>\n");
+    printf("        warm [<name list file> [<interests per second>]]\n");
+    printf("        reload [<configuration file>]\n");
+    printf("        drain\n");
     printf("        quit\n");
 }
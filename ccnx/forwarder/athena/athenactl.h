@@ -31,6 +31,8 @@
 #ifndef athenactl_h
 #define athenactl_h
 
+#include <stdio.h>
+
 #include <ccnx/forwarder/athena/athena.h>
 
 #include <ccnx/api/ccnx_Portal/ccnx_Portal.h>
@@ -40,6 +42,8 @@
 // included to provide FORWARDER_CONNECTION_ENV
 #include <ccnx/transport/transport_rta/config/config_Forwarder_Metis.h>
 
+#define ATHENACTL_DEFAULT_TIMEOUT_MILLIS 5000
+
 /**
  * @abstract process a CCNx command line argument
  * @discussion
@@ -81,6 +85,81 @@
  */
 int athenactl_Command(PARCIdentity *identity, int argc, char **argv);
 
+/**
+ * @abstract run the athenactl commands read from a file, one per line
+ * @discussion
+ *
+ * The commands are run in a session (see athenactl_OpenSession), so that a long list of commands
+ * is pipelined over a single portal rather than each paying for its own portal setup.
+ *
+ * @param [in] identity user identity
+ * @param [in] commandFile file to read commands from, such as stdin
+ * @return 0 if every command succeeded
+ *
+ * Example:
+ * @code
+ * {
+ *     result = athenactl_CommandFile(identity, stdin);
+ * }
+ * @endcode
+ */
+int athenactl_CommandFile(PARCIdentity *identity, FILE *commandFile);
+
+/**
+ * @abstract open a session that holds one portal open across commands
+ * @discussion
+ *
+ * Until the session is closed, commands whose response is only printed are sent without waiting
+ * for their response, which is printed when it arrives.  Commands that use their response, such as
+ * list and dump, still wait for it, completing any pipelined commands answered in the meantime.
+ *
+ * @param [in] identity user identity
+ *
+ * Example:
+ * @code
+ * {
+ *     athenactl_OpenSession(identity);
+ *     athenactl_Command(identity, argc, argv);
+ *     ...
+ *     athenactl_CloseSession();
+ * }
+ * @endcode
+ */
+void athenactl_OpenSession(PARCIdentity *identity);
+
+/**
+ * @abstract close the open session
+ * @discussion
+ *
+ * Waits for the responses of commands still in flight, or for them to time out, before closing the portal.
+ *
+ * Example:
+ * @code
+ * {
+ *     athenactl_CloseSession();
+ * }
+ * @endcode
+ */
+void athenactl_CloseSession(void);
+
+/**
+ * @abstract set how long a command waits for its response
+ * @discussion
+ *
+ * A command is given up on, and reported as timed out, if no response arrives within the timeout.
+ * The default is ATHENACTL_DEFAULT_TIMEOUT_MILLIS.
+ *
+ * @param [in] timeoutInMillis timeout of each command in milliseconds
+ *
+ * Example:
+ * @code
+ * {
+ *     athenactl_SetTimeout(1000);
+ * }
+ * @endcode
+ */
+void athenactl_SetTimeout(unsigned timeoutInMillis);
+
 /**
  * @abstract print athenactl command usage
  * @discussion
@@ -38,15 +38,29 @@
 #include <getopt.h>
 #include <netdb.h>
 #include <errno.h>
+#include <signal.h>
 #include <sys/param.h>
 #include <sys/utsname.h>
 #include <stdio.h>
+#include <strings.h>
 
 #include <ccnx/forwarder/athena/athena.h>
 #include <ccnx/forwarder/athena/athena_About.h>
+#include <ccnx/forwarder/athena/athena_LRUContentStore.h>
+#include <ccnx/forwarder/athena/athena_ShardedContentStore.h>
 
 static char *_athenaDefaultConnectionURI = AthenaDefaultConnectionURI;
 static size_t _contentStoreSizeInMB = AthenaDefaultContentStoreSize;
+static size_t _contentStoreShards = 0;
+static AthenaLRUContentStoreEvictionPolicy _contentStoreEvictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+static size_t _contentStoreColdSegmentPercent = 0;
+static bool _contentStoreDeduplicatePayloads = false;
+static char *_configPath = NULL;
+static char *_fibImagePath = NULL;
+static bool _aggregateRoutes = false;
+static char *_routeFeedPath = NULL;
+static size_t _fanoutWorkers = 0;
+static char *_drainSnapshotPath = NULL;
 
 static void
 _athenaLogo()
@@ -61,12 +75,22 @@ _athenaLogo()
 static void
 _usage()
 {
-    printf("usage: athena [-c <protocol>://<address>:<port>[/listener][/name=<name>][/local=<bool>]] [-s contentStoreSize(MBs)] [--debug]\n");
+    printf("usage: athena [-c <protocol>://<address>:<port>[/listener][/name=<name>][/local=<bool>][/trusted-push=<bytes>]] [-s contentStoreSize(MBs)] [-S contentStoreShards] [-e lru|clock] [-z coldSegmentPercent] [--dedup] [-f configFile] [-i fibImage] [--aggregate] [-r routeFeedSocket] [-F fanoutWorkers] [-o drainSnapshotFile] [--debug]\n");
 }
 
 static struct option options[] = {
     { .name = "store",   .has_arg = optional_argument, .flag = NULL, .val = 's' },
+    { .name = "shards",  .has_arg = required_argument, .flag = NULL, .val = 'S' },
+    { .name = "eviction", .has_arg = required_argument, .flag = NULL, .val = 'e' },
+    { .name = "compress", .has_arg = required_argument, .flag = NULL, .val = 'z' },
+    { .name = "dedup",   .has_arg = no_argument,       .flag = NULL, .val = 'D' },
     { .name = "connect", .has_arg = optional_argument, .flag = NULL, .val = 'c' },
+    { .name = "config",  .has_arg = required_argument, .flag = NULL, .val = 'f' },
+    { .name = "fib-image", .has_arg = required_argument, .flag = NULL, .val = 'i' },
+    { .name = "aggregate", .has_arg = no_argument,     .flag = NULL, .val = 'A' },
+    { .name = "route-feed", .has_arg = required_argument, .flag = NULL, .val = 'r' },
+    { .name = "fanout",  .has_arg = required_argument, .flag = NULL, .val = 'F' },
+    { .name = "drain-snapshot", .has_arg = required_argument, .flag = NULL, .val = 'o' },
     { .name = "help",    .has_arg = no_argument,       .flag = NULL, .val = 'h' },
     { .name = "version", .has_arg = no_argument,       .flag = NULL, .val = 'v' },
     { .name = "debug",   .has_arg = no_argument,       .flag = NULL, .val = 'd' },
@@ -78,8 +102,10 @@ _parseCommandLine(Athena *athena, int argc, char **argv)
 {
     int c;
     bool interfaceConfigured = false;
+    const char *connectionSpecifications[argc];
+    int numConnectionSpecifications = 0;
 
-    while ((c = getopt_long(argc, argv, "hs:c:vd", options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "hs:S:e:z:Dc:f:i:Ar:F:o:vd", options, NULL)) != -1) {
         switch (c) {
             case 's': {
                 int sizeInMB = atoi(optarg);
@@ -89,18 +115,62 @@ _parseCommandLine(Athena *athena, int argc, char **argv)
                 _contentStoreSizeInMB = sizeInMB;
                 break;
             }
-            case 'c': {
-                PARCURI *connectionURI = parcURI_Parse(optarg);
-                const char *result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
-                if (result == NULL) {
-                    parcLog_Error(athena->log, "Unable to configure %s: %s", optarg, strerror(errno));
-                    parcURI_Release(&connectionURI);
+            case 'S': {
+                // A sharded store is shared with any instances spawned from this one
+                int numShards = atoi(optarg);
+                if ((numShards < 0) || (numShards > AthenaShardedContentStore_MaxShardCount)) {
+                    parcLog_Error(athena->log, "Content store shards must be between 0 and %d", AthenaShardedContentStore_MaxShardCount);
                     exit(EXIT_FAILURE);
                 }
-                parcURI_Release(&connectionURI);
-                interfaceConfigured = true;
+                _contentStoreShards = numShards;
                 break;
             }
+            case 'e':
+                if (strcasecmp(optarg, "clock") == 0) {
+                    _contentStoreEvictionPolicy = AthenaLRUContentStoreEvictionPolicy_Clock;
+                } else if (strcasecmp(optarg, "lru") == 0) {
+                    _contentStoreEvictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+                } else {
+                    _usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'z':
+                // Share of the store holding compressed entries evicted from the LRU
+                _contentStoreColdSegmentPercent = atoi(optarg);
+                break;
+            case 'D':
+                // Entries with identical payloads share one copy
+                _contentStoreDeduplicatePayloads = true;
+                break;
+            case 'c':
+                // Opened once all the options are parsed and the content store is set up
+                connectionSpecifications[numConnectionSpecifications++] = optarg;
+                break;
+            case 'f':
+                // Links, routes and cache policies, re-read on SIGHUP or a reload command
+                _configPath = optarg;
+                break;
+            case 'i':
+                // Routes compiled by athenafib, mapped rather than added one at a time
+                _fibImagePath = optarg;
+                break;
+            case 'A':
+                // Keep routes with the same links as the route above them out of the lookup table
+                _aggregateRoutes = true;
+                break;
+            case 'r':
+                // Unix domain socket a routing daemon streams route changes to
+                _routeFeedPath = optarg;
+                break;
+            case 'F':
+                // Threads sending Content Objects that satisfy Interests from many links
+                _fanoutWorkers = atoi(optarg);
+                break;
+            case 'o':
+                // Content store saved here when draining, never taken from a control command
+                _drainSnapshotPath = optarg;
+                break;
             case 'v':
                 printf("%s\n", athenaAbout_Version());
                 exit(0);
@@ -116,12 +186,82 @@ _parseCommandLine(Athena *athena, int argc, char **argv)
         }
     }
 
+    if (_contentStoreShards > 0) {
+        AthenaShardedContentStoreConfig storeConfig = {
+            .capacityInMB   = _contentStoreSizeInMB,
+            .numShards      = _contentStoreShards,
+            .evictionPolicy = _contentStoreEvictionPolicy,
+            .coldSegmentPercent = _contentStoreColdSegmentPercent,
+            .deduplicatePayloads = _contentStoreDeduplicatePayloads,
+            .namePool = athena->namePool
+        };
+        AthenaContentStore *contentStore = athenaContentStore_Create(&AthenaContentStore_ShardedImplementation, &storeConfig);
+        athena_SetContentStore(athena, contentStore);
+        athenaContentStore_Release(&contentStore);
+    } else if (_contentStoreEvictionPolicy != AthenaLRUContentStoreEvictionPolicy_LRU || _contentStoreColdSegmentPercent > 0
+               || _contentStoreDeduplicatePayloads) {
+        AthenaLRUContentStoreConfig storeConfig = {
+            .capacityInMB   = _contentStoreSizeInMB,
+            .evictionPolicy = _contentStoreEvictionPolicy,
+            .coldSegmentPercent = _contentStoreColdSegmentPercent,
+            .deduplicatePayloads = _contentStoreDeduplicatePayloads,
+            .namePool = athena->namePool
+        };
+        AthenaContentStore *contentStore = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &storeConfig);
+        athena_SetContentStore(athena, contentStore);
+        athenaContentStore_Release(&contentStore);
+    }
+
+    if (_fibImagePath) {
+        if (athena_LoadFIBImage(athena, _fibImagePath) == false) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (_aggregateRoutes && (athenaFIB_SetAggregation(athena->athenaFIB, true) == false)) {
+        parcLog_Error(athena->log, "Routes can't be aggregated with a FIB image");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < numConnectionSpecifications; i++) {
+        if (athena_OpenLink(athena, connectionSpecifications[i]) == NULL) {
+            parcLog_Error(athena->log, "Unable to configure %s: %s", connectionSpecifications[i], strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        interfaceConfigured = true;
+    }
+
     if (argc - optind) {
         parcLog_Error(athena->log, "Bad arguments");
         _usage();
         exit(EXIT_FAILURE);
     }
 
+    if (_configPath) {
+        if (athena_Reload(athena, _configPath, NULL) == false) {
+            exit(EXIT_FAILURE);
+        }
+        if (athenaConfig_GetNumberOfLinks(athena->config) > 0) {
+            interfaceConfigured = true;
+        }
+    }
+
+    if (_routeFeedPath) {
+        if (athena_OpenRouteFeed(athena, _routeFeedPath) == false) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (_drainSnapshotPath) {
+        athena_SetDrainSnapshotPath(athena, _drainSnapshotPath);
+    }
+
+    if (_fanoutWorkers > 0) {
+        if (athena_StartFanout(athena, _fanoutWorkers, AthenaFanoutDefaultThreshold) == false) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
     if (interfaceConfigured != true) {
         PARCURI *connectionURI = parcURI_Parse(_athenaDefaultConnectionURI);
         if (athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI) == NULL) {
@@ -157,6 +297,7 @@ main(int argc, char *argv[])
     // released so the reference is acquired for them.
     if (athena) {
         _parseCommandLine(athena, argc, argv);
+        signal(SIGHUP, athena_ReloadSignalHandler);
         (void) athena_ForwarderEngine(athena_Acquire(athena));
     }
     athena_Release(&athena);
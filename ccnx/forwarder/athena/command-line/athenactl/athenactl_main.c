@@ -40,6 +40,7 @@
 #include <netdb.h>
 #include <sys/param.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <LongBow/runtime.h>
 
@@ -73,21 +74,27 @@ _usage(void)
 {
     _athenactlLogo();
     printf("\n");
-    printf("usage: athenactl [-h] [-a <address>] [-f <identity file>] [-p <password>] <command>\n");
+    printf("usage: athenactl [-h] [-a <address>] [-f <identity file>] [-p <password>] [-t <milliseconds>] <command>\n");
+    printf("       athenactl [-h] [-a <address>] [-f <identity file>] [-p <password>] [-t <milliseconds>] -b <command file>\n");
     printf("    -a | --address  Forwarder connection address (default: tcp://localhost:9695)\n");
     printf("    -f | --identity  The file name containing a PKCS12 keystore\n");
     printf("    -p | --password  The password to unlock the keystore\n");
+    printf("    -t | --timeout  Milliseconds to wait for the response to each command (default: %d)\n", ATHENACTL_DEFAULT_TIMEOUT_MILLIS);
+    printf("    -b | --batch  Run the commands in the file, one per line, over one connection (- for stdin)\n");
     printf("    <command> The forwarder command to execute\n");
 }
 
 static char *keystoreFile = NULL;
 static char *keystorePassword = NULL;
+static char *commandFileName = NULL;
 
 /* options descriptor */
 static struct option longopts[] = {
     { "address",  required_argument, NULL, 'a' },
     { "identity", required_argument, NULL, 'f' },
     { "password", required_argument, NULL, 'p' },
+    { "timeout",  required_argument, NULL, 't' },
+    { "batch",    required_argument, NULL, 'b' },
     { "version",  no_argument,       NULL, 'v' },
     { "help",     no_argument,       NULL, 'h' },
     { NULL,       0,                 NULL, 0   }
@@ -99,7 +106,7 @@ main(int argc, char *argv[])
     int result;
 
     int ch;
-    while ((ch = getopt_long(argc, argv, "a:f:p:hv", longopts, NULL)) != -1) {
+    while ((ch = getopt_long(argc, argv, "a:f:p:t:b:hv", longopts, NULL)) != -1) {
         switch (ch) {
             case 'f':
                 keystoreFile = optarg;
@@ -113,6 +120,14 @@ main(int argc, char *argv[])
                 setenv(FORWARDER_CONNECTION_ENV, optarg, 1);
                 break;
 
+            case 't':
+                athenactl_SetTimeout(atoi(optarg));
+                break;
+
+            case 'b':
+                commandFileName = optarg;
+                break;
+
             case 'v':
                 printf("%s\n", athenactlAbout_Version());
                 exit(0);
@@ -152,7 +167,19 @@ main(int argc, char *argv[])
     PARCIdentity *identity = parcIdentity_Create(identityFile, PARCIdentityFileAsPARCIdentity);
     parcIdentityFile_Release(&identityFile);
 
-    result = athenactl_Command(identity, argc, argv);
+    if (commandFileName != NULL) {
+        FILE *commandFile = (strcmp(commandFileName, "-") == 0) ? stdin : fopen(commandFileName, "r");
+        if (commandFile == NULL) {
+            printf("Could not open command file '%s': %s\n", commandFileName, strerror(errno));
+            exit(1);
+        }
+        result = athenactl_CommandFile(identity, commandFile);
+        if (commandFile != stdin) {
+            fclose(commandFile);
+        }
+    } else {
+        result = athenactl_Command(identity, argc, argv);
+    }
 
     parcIdentity_Release(&identity);
     keystoreParams_Destroy(&keystoreParams);
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Kevin Fox, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+/*
+ * Athena FIB Image Compiler
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <parc/logging/parc_Log.h>
+#include <parc/logging/parc_LogReporterFile.h>
+#include <parc/algol/parc_FileOutputStream.h>
+
+#include <ccnx/forwarder/athena/athena_About.h>
+#include <ccnx/forwarder/athena/athena_FIBImage.h>
+
+static void
+_usage()
+{
+    printf("usage: athenafib [-h] [-v] <route list|-> <image file>\n");
+    printf("    Compiles a route list, one \"<linkName> <prefix>\" per line, into a FIB image for athena -i\n");
+}
+
+static struct option options[] = {
+    { .name = "help",    .has_arg = no_argument, .flag = NULL, .val = 'h' },
+    { .name = "version", .has_arg = no_argument, .flag = NULL, .val = 'v' },
+    { .name = NULL,      .has_arg = 0,           .flag = NULL, .val = 0   },
+};
+
+static PARCLog *
+_createLog(void)
+{
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDERR_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+
+    PARCLog *log = parcLog_Create("localhost", "athenafib", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+    parcLog_SetLevel(log, PARCLogLevel_Info);
+    return log;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int c;
+    while ((c = getopt_long(argc, argv, "hv", options, NULL)) != -1) {
+        switch (c) {
+            case 'v':
+                printf("%s\n", athenaAbout_Version());
+                exit(0);
+            case 'h':
+            default:
+                _usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+    if (argc - optind != 2) {
+        _usage();
+        exit(EXIT_FAILURE);
+    }
+    const char *routeListPath = argv[optind];
+    const char *imagePath = argv[optind + 1];
+
+    FILE *routeList = (strcmp(routeListPath, "-") == 0) ? stdin : fopen(routeListPath, "r");
+    if (routeList == NULL) {
+        printf("Could not open route list '%s': %s\n", routeListPath, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    PARCLog *log = _createLog();
+    ssize_t numRoutes = athenaFIBImage_Compile(routeList, imagePath, log);
+    parcLog_Release(&log);
+    if (routeList != stdin) {
+        fclose(routeList);
+    }
+
+    if (numRoutes < 0) {
+        exit(EXIT_FAILURE);
+    }
+    printf("Compiled %zd routes into %s\n", numRoutes, imagePath);
+    return 0;
+}
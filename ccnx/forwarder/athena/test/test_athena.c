@@ -73,8 +73,10 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athena_CreateRelease);
     LONGBOW_RUN_TEST_CASE(Global, athena_ProcessInterest);
     LONGBOW_RUN_TEST_CASE(Global, athena_ProcessContentObject);
+    LONGBOW_RUN_TEST_CASE(Global, athena_PushContentObject);
     LONGBOW_RUN_TEST_CASE(Global, athena_ProcessControl);
     LONGBOW_RUN_TEST_CASE(Global, athena_ProcessInterestReturn);
+    LONGBOW_RUN_TEST_CASE(Global, athena_Drain);
     LONGBOW_RUN_TEST_CASE(Global, athena_ForwarderEngine);
 }
 
@@ -228,6 +230,86 @@ LONGBOW_TEST_CASE(Global, athena_ProcessContentObject)
     athena_Release(&athena);
 }
 
+static CCNxContentObject *
+_createContentObject(const char *uri, const char *payloadString)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    PARCBuffer *payload = parcBuffer_WrapCString((char *) payloadString);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+    ccnxName_Release(&name);
+    parcBuffer_Release(&payload);
+    athena_EncodeMessage(contentObject);
+    return contentObject;
+}
+
+static bool
+_isInContentStore(Athena *athena, CCNxContentObject *contentObject)
+{
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(contentObject));
+    bool found = athenaContentStore_GetMatch(athena->athenaContentStore, interest) != NULL;
+    ccnxInterest_Release(&interest);
+    return found;
+}
+
+LONGBOW_TEST_CASE(Global, athena_PushContentObject)
+{
+    PARCURI *connectionURI;
+    Athena *athena = athena_Create(100);
+
+    connectionURI = parcURI_Parse("tcp://localhost:50100/listener/name=TCPListener");
+    const char *result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    connectionURI = parcURI_Parse("tcp://localhost:50100/name=TCP_0");
+    result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    // The quota fits the first content object but not both, whole messages being counted
+    CCNxContentObject *contentObject = _createContentObject("lci:/cakes/and/pies", "this is a payload");
+    CCNxContentObject *overQuota = _createContentObject("lci:/cakes/and/tarts", "this is another payload");
+    size_t quota = _messageSizeInBytes(contentObject) + _messageSizeInBytes(overQuota) - 1;
+    assertTrue(_messageSizeInBytes(contentObject) > strlen("this is a payload"), "Expected the whole message to be counted");
+
+    char trustedSpecification[128];
+    sprintf(trustedSpecification, "tcp://localhost:50100/trusted-push=%zu/name=TCP_1", quota);
+    connectionURI = parcURI_Parse(trustedSpecification);
+    result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    // Listeners can't be trusted, anyone could connect to them
+    connectionURI = parcURI_Parse("tcp://localhost:50101/listener/trusted-push=1024/name=TrustedListener");
+    result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result == NULL, "Expected a trusted-push listener to be refused");
+    parcURI_Release(&connectionURI);
+
+    PARCBitVector *untrustedVector = parcBitVector_Create();
+    parcBitVector_Set(untrustedVector, athenaTransportLinkAdapter_LinkNameToId(athena->athenaTransportLinkAdapter, "TCP_0"));
+    PARCBitVector *trustedVector = parcBitVector_Create();
+    parcBitVector_Set(trustedVector, athenaTransportLinkAdapter_LinkNameToId(athena->athenaTransportLinkAdapter, "TCP_1"));
+
+    // Unsolicited content is dropped unless its link is trusted to push
+    athena_ProcessMessage(athena, contentObject, untrustedVector);
+    assertFalse(_isInContentStore(athena, contentObject), "Expected unsolicited content from an untrusted link to be dropped");
+    athena_ProcessMessage(athena, contentObject, trustedVector);
+    assertTrue(_isInContentStore(athena, contentObject), "Expected unsolicited content from a trusted link to be stored");
+    ccnxContentObject_Release(&contentObject);
+
+    // Content beyond the link's quota is dropped
+    athena_ProcessMessage(athena, overQuota, trustedVector);
+    assertFalse(_isInContentStore(athena, overQuota), "Expected content over the push quota to be dropped");
+    ccnxContentObject_Release(&overQuota);
+
+    assertTrue(athenaStats_Get(athena->stats, AthenaCounter_PushedContentObjects) == 1, "Expected one pushed content object");
+    assertTrue(athenaStats_Get(athena->stats, AthenaCounter_UnsolicitedContentObjects) == 2, "Expected two dropped content objects");
+
+    parcBitVector_Release(&untrustedVector);
+    parcBitVector_Release(&trustedVector);
+    athena_Release(&athena);
+}
+
 LONGBOW_TEST_CASE(Global, athena_ProcessControl)
 {
     PARCURI *connectionURI;
@@ -299,6 +381,59 @@ LONGBOW_TEST_CASE(Global, athena_ProcessInterestReturn)
     athena_Release(&athena);
 }
 
+LONGBOW_TEST_CASE(Global, athena_Drain)
+{
+    PARCURI *connectionURI;
+    Athena *athena = athena_Create(100);
+
+    connectionURI = parcURI_Parse("tcp://localhost:50100/listener/name=TCPListener");
+    const char *result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    connectionURI = parcURI_Parse("tcp://localhost:50100/name=TCP_0");
+    result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    connectionURI = parcURI_Parse("tcp://localhost:50100/name=TCP_1");
+    result = athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(athena->athenaTransportLinkAdapter, "TCP_0");
+    PARCBitVector *interestIngressVector = parcBitVector_Create();
+    parcBitVector_Set(interestIngressVector, linkId);
+
+    linkId = athenaTransportLinkAdapter_LinkNameToId(athena->athenaTransportLinkAdapter, "TCP_1");
+    PARCBitVector *routeVector = parcBitVector_Create();
+    parcBitVector_Set(routeVector, linkId);
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar/baz");
+    athenaFIB_AddRoute(athena->athenaFIB, name, routeVector);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    athena_EncodeMessage(interest);
+
+    athena_ProcessMessage(athena, interest, interestIngressVector);
+    assertTrue(athenaPIT_GetNumberOfPendingInterests(athena->athenaPIT) == 1, "Expected the forwarded interest to be pending");
+
+    size_t numReturned = athena_Drain(athena);
+    assertTrue(numReturned == 1, "Expected the pending interest to be returned, not %zu", numReturned);
+    assertTrue(athenaPIT_GetNumberOfTableEntries(athena->athenaPIT) == 0, "Expected an empty PIT after draining");
+    assertTrue(athena->athenaState == Athena_Exit, "Expected the forwarder to exit after draining");
+
+    // Interests arriving while draining are refused rather than forwarded
+    athena->athenaState = Athena_Draining;
+    athena_ProcessMessage(athena, interest, interestIngressVector);
+    assertTrue(athenaPIT_GetNumberOfTableEntries(athena->athenaPIT) == 0, "Expected an interest refused while draining");
+
+    parcBitVector_Release(&interestIngressVector);
+    parcBitVector_Release(&routeVector);
+    ccnxName_Release(&name);
+    ccnxInterest_Release(&interest);
+    athena_Release(&athena);
+}
+
 LONGBOW_TEST_CASE(Global, athena_ForwarderEngine)
 {
     // Create a new athena instance
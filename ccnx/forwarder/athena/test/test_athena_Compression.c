@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Compression.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+LONGBOW_TEST_RUNNER(athena_Compression)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Compression)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Compression)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaCompression_RoundTrip);
+    LONGBOW_RUN_TEST_CASE(Global, athenaCompression_RoundTripShort);
+    LONGBOW_RUN_TEST_CASE(Global, athenaCompression_RoundTripRandom);
+    LONGBOW_RUN_TEST_CASE(Global, athenaCompression_DestinationTooSmall);
+    LONGBOW_RUN_TEST_CASE(Global, athenaCompression_Corrupt);
+    LONGBOW_RUN_TEST_CASE(Global, athenaCompression_IsCompressible);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static uint8_t *
+_createText(size_t length)
+{
+    const char *text = "<manifest><chunk name=\"lci:/a/b/c\" size=\"4096\"/></manifest>\n";
+    uint8_t *result = parcMemory_Allocate(length);
+    for (size_t i = 0; i < length; i++) {
+        result[i] = text[i % strlen(text)];
+    }
+    return result;
+}
+
+static uint8_t *
+_createRandom(size_t length)
+{
+    uint8_t *result = parcMemory_Allocate(length);
+    srandom(1);
+    for (size_t i = 0; i < length; i++) {
+        result[i] = (uint8_t) random();
+    }
+    return result;
+}
+
+/**
+ * Compress and decompress, returning the size of the compressed block.
+ */
+static size_t
+_roundTrip(const uint8_t *input, size_t length)
+{
+    size_t capacity = athenaCompression_Bound(length);
+    uint8_t *block = parcMemory_Allocate(capacity);
+    size_t blockLength = athenaCompression_Compress(input, length, block, capacity);
+    assertTrue(blockLength > 0, "Expected the input to fit within the bound");
+
+    uint8_t *output = parcMemory_Allocate(length + 1);
+    assertTrue(athenaCompression_Decompress(block, blockLength, output, length), "Expected the block to decompress");
+    assertTrue(memcmp(input, output, length) == 0, "Expected the decompressed data to match the input");
+
+    parcMemory_Deallocate(&output);
+    parcMemory_Deallocate(&block);
+    return blockLength;
+}
+
+LONGBOW_TEST_CASE(Global, athenaCompression_RoundTrip)
+{
+    size_t length = 64 * 1024;
+    uint8_t *input = _createText(length);
+
+    size_t blockLength = _roundTrip(input, length);
+    assertTrue(blockLength < (length / 4), "Expected repetitive text to compress at least 4x, got %zu bytes", blockLength);
+
+    parcMemory_Deallocate(&input);
+}
+
+LONGBOW_TEST_CASE(Global, athenaCompression_RoundTripShort)
+{
+    uint8_t *input = _createText(64);
+    for (size_t length = 0; length <= 64; length++) {
+        _roundTrip(input, length);
+    }
+    parcMemory_Deallocate(&input);
+}
+
+LONGBOW_TEST_CASE(Global, athenaCompression_RoundTripRandom)
+{
+    size_t length = 70 * 1024; // larger than the maximum match offset
+    uint8_t *input = _createRandom(length);
+
+    size_t blockLength = _roundTrip(input, length);
+    assertTrue(blockLength <= athenaCompression_Bound(length), "Expected the block to be within the bound");
+
+    parcMemory_Deallocate(&input);
+}
+
+LONGBOW_TEST_CASE(Global, athenaCompression_DestinationTooSmall)
+{
+    size_t length = 4096;
+    uint8_t *input = _createRandom(length);
+    uint8_t *block = parcMemory_Allocate(length / 2);
+
+    size_t blockLength = athenaCompression_Compress(input, length, block, length / 2);
+    assertTrue(blockLength == 0, "Expected compression to fail when the output does not fit");
+
+    parcMemory_Deallocate(&block);
+    parcMemory_Deallocate(&input);
+}
+
+LONGBOW_TEST_CASE(Global, athenaCompression_Corrupt)
+{
+    size_t length = 4096;
+    uint8_t *input = _createText(length);
+    size_t capacity = athenaCompression_Bound(length);
+    uint8_t *block = parcMemory_Allocate(capacity);
+    size_t blockLength = athenaCompression_Compress(input, length, block, capacity);
+    uint8_t *output = parcMemory_Allocate(length);
+
+    assertFalse(athenaCompression_Decompress(block, blockLength - 1, output, length), "Expected a truncated block to fail");
+    assertFalse(athenaCompression_Decompress(block, blockLength, output, length - 1), "Expected the wrong length to fail");
+
+    // One literal followed by a match that refers to before the start of the output
+    uint8_t invalidOffset[] = { 0x10, 'a', 0x05, 0x00, 0x10, 'b' };
+    assertFalse(athenaCompression_Decompress(invalidOffset, sizeof(invalidOffset), output, 6), "Expected an invalid offset to fail");
+
+    parcMemory_Deallocate(&output);
+    parcMemory_Deallocate(&block);
+    parcMemory_Deallocate(&input);
+}
+
+LONGBOW_TEST_CASE(Global, athenaCompression_IsCompressible)
+{
+    size_t length = 16 * 1024;
+    uint8_t *text = _createText(length);
+    uint8_t *random = _createRandom(length);
+
+    assertTrue(athenaCompression_IsCompressible(text, length, 4096, 90), "Expected text to be compressible");
+    assertFalse(athenaCompression_IsCompressible(random, length, 4096, 90), "Expected random data not to be compressible");
+    assertFalse(athenaCompression_IsCompressible(text, 0, 4096, 90), "Expected empty input not to be compressible");
+
+    parcMemory_Deallocate(&random);
+    parcMemory_Deallocate(&text);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Compression);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Config.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_FileOutputStream.h>
+#include <parc/logging/parc_LogReporterFile.h>
+
+#include <ccnx/forwarder/athena/athena_LRUContentStore.h>
+
+static AthenaFIB *_testFIB;
+
+static void
+_removeLink(void *context, PARCBitVector *linkVector)
+{
+    athenaFIB_RemoveLink(_testFIB, linkVector);
+}
+
+static PARCLog *
+_createLog(void)
+{
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+
+    PARCLog *log = parcLog_Create("localhost", "test_athena_Config", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+    return log;
+}
+
+static AthenaConfig *
+_readConfig(const char *contents)
+{
+    FILE *file = tmpfile();
+    fputs(contents, file);
+    rewind(file);
+    PARCLog *log = _createLog();
+    AthenaConfig *config = _athenaConfig_ReadStream(file, log, "test");
+    parcLog_Release(&log);
+    fclose(file);
+    return config;
+}
+
+static bool
+_isRoutedTo(AthenaTransportLinkAdapter *adapter, const char *prefix, const char *linkName)
+{
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(adapter, linkName);
+    if (linkId == -1) {
+        return false;
+    }
+    CCNxName *name = ccnxName_CreateFromURI(prefix);
+    PARCBitVector *egressVector = athenaFIB_Lookup(_testFIB, name);
+    ccnxName_Release(&name);
+    return egressVector && parcBitVector_Get(egressVector, linkId);
+}
+
+LONGBOW_TEST_RUNNER(athena_Config)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Config)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Config)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaConfig_Read);
+    LONGBOW_RUN_TEST_CASE(Global, athenaConfig_Read_Errors);
+    LONGBOW_RUN_TEST_CASE(Global, athenaConfig_Apply);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaConfig_Read)
+{
+    AthenaConfig *config = _readConfig("# test configuration\n"
+                                       "link udp://127.0.0.1:40100/name=UDP_0\n"
+                                       "\n"
+                                       "link tcp://127.0.0.1:40101/listener/name=TCP_L  # comment\n"
+                                       "route UDP_0 lci:/foo\n"
+                                       "route UDP_0 lci:/foo\n"
+                                       "stale lci:/foo 2000\n"
+                                       "store 20\n");
+    assertNotNull(config, "Expected the configuration to parse");
+    assertTrue(athenaConfig_GetNumberOfLinks(config) == 2, "Expected 2 links");
+    assertTrue(parcArrayList_Size(config->routes) == 1, "Expected duplicate routes to be merged");
+    assertTrue(parcArrayList_Size(config->staleWindows) == 1, "Expected 1 stale window");
+    assertTrue(config->storeSizeInMB == 20, "Expected a 20MB store");
+
+    _AthenaConfigLink *link = _findLink(config, "TCP_L");
+    assertNotNull(link, "Expected the link name to be taken from its specification");
+    assertTrue(_isListener(link), "Expected TCP_L to be a listener");
+
+    AthenaConfig *reference = athenaConfig_Acquire(config);
+    athenaConfig_Release(&reference);
+    athenaConfig_Release(&config);
+    assertNull(config, "Expected release to clear the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, athenaConfig_Read_Errors)
+{
+    const char *invalid[] = {
+        "link udp://127.0.0.1:40100\n",
+        "link udp://127.0.0.1:40100/name=UDP_0\nlink udp://127.0.0.1:40102/name=UDP_0\n",
+        "route UDP_0\n",
+        "route UDP_0 lci:/foo extra\n",
+        "stale lci:/foo soon\n",
+        "store 0\n",
+        "forward everything\n",
+        "link tcp://127.0.0.1:40101/listener/name=TCP_L\nroute TCP_L lci:/foo\n",
+        NULL
+    };
+    for (int i = 0; invalid[i] != NULL; i++) {
+        AthenaConfig *config = _readConfig(invalid[i]);
+        assertNull(config, "Expected configuration %d to be rejected", i);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, athenaConfig_Apply)
+{
+    PARCLog *log = _createLog();
+    _testFIB = athenaFIB_Create();
+    AthenaTransportLinkAdapter *adapter = athenaTransportLinkAdapter_Create(_removeLink, NULL);
+    AthenaLRUContentStoreConfig storeConfig = {
+        .capacityInMB = 10,
+        .evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU,
+        .coldSegmentPercent = 0,
+        .deduplicatePayloads = false,
+        .namePool = NULL
+    };
+    AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &storeConfig);
+
+    // A link we don't manage, routes to it may be configured but it's never closed
+    PARCURI *connectionURI = parcURI_Parse("udp://127.0.0.1:40110/name=OTHER");
+    assertNotNull(athenaTransportLinkAdapter_Open(adapter, connectionURI), "Unable to open unmanaged link");
+    parcURI_Release(&connectionURI);
+
+    AthenaConfigChanges changes;
+    AthenaConfig *running = _readConfig("link udp://127.0.0.1:40111/name=UDP_0\n"
+                                        "link udp://127.0.0.1:40112/name=UDP_1\n"
+                                        "route UDP_0 lci:/foo\n"
+                                        "route UDP_1 lci:/bar\n"
+                                        "route OTHER lci:/other\n"
+                                        "stale lci:/foo 2000\n");
+    assertTrue(athenaConfig_Apply(NULL, running, adapter, _testFIB, store, log, &changes), "Expected the configuration to apply");
+    assertTrue(changes.linksAdded == 2, "Expected 2 links added, got %zu", changes.linksAdded);
+    assertTrue(changes.routesAdded == 3, "Expected 3 routes added, got %zu", changes.routesAdded);
+    assertTrue(changes.policiesChanged == 1, "Expected 1 policy changed, got %zu", changes.policiesChanged);
+    assertTrue(_isRoutedTo(adapter, "lci:/foo/a", "UDP_0"), "Expected lci:/foo to be routed to UDP_0");
+    assertTrue(_isRoutedTo(adapter, "lci:/bar/a", "UDP_1"), "Expected lci:/bar to be routed to UDP_1");
+
+    // A route to an unknown link leaves the running configuration in place
+    AthenaConfig *config = _readConfig("link udp://127.0.0.1:40111/name=UDP_0\n"
+                                       "route MISSING lci:/foo\n");
+    assertFalse(athenaConfig_Apply(running, config, adapter, _testFIB, store, log, NULL), "Expected the configuration to be refused");
+    assertTrue(athenaTransportLinkAdapter_LinkNameToId(adapter, "UDP_1") != -1, "Expected UDP_1 to be left open");
+    assertTrue(_isRoutedTo(adapter, "lci:/bar/a", "UDP_1"), "Expected lci:/bar to still be routed to UDP_1");
+    athenaConfig_Release(&config);
+
+    // Only the differences are applied, unchanged links and routes are left as they are
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(adapter, "UDP_0");
+    config = _readConfig("link udp://127.0.0.1:40111/name=UDP_0\n"
+                         "route UDP_0 lci:/foo\n"
+                         "route UDP_0 lci:/baz\n"
+                         "route OTHER lci:/other\n");
+    assertTrue(athenaConfig_Apply(running, config, adapter, _testFIB, store, log, &changes), "Expected the configuration to apply");
+    assertTrue(changes.linksAdded == 0, "Expected no links added, got %zu", changes.linksAdded);
+    assertTrue(changes.linksRemoved == 1, "Expected 1 link removed, got %zu", changes.linksRemoved);
+    assertTrue(changes.routesAdded == 1, "Expected 1 route added, got %zu", changes.routesAdded);
+    assertTrue(changes.routesRemoved == 1, "Expected 1 route removed, got %zu", changes.routesRemoved);
+    assertTrue(changes.policiesChanged == 1, "Expected the stale window to be cleared, got %zu", changes.policiesChanged);
+    assertTrue(athenaTransportLinkAdapter_LinkNameToId(adapter, "UDP_0") == linkId, "Expected UDP_0 to be left open");
+    assertTrue(athenaTransportLinkAdapter_LinkNameToId(adapter, "UDP_1") == -1, "Expected UDP_1 to be closed");
+    assertTrue(athenaTransportLinkAdapter_LinkNameToId(adapter, "OTHER") != -1, "Expected OTHER to be left open");
+    assertTrue(_isRoutedTo(adapter, "lci:/foo/a", "UDP_0"), "Expected lci:/foo to still be routed to UDP_0");
+    assertTrue(_isRoutedTo(adapter, "lci:/baz/a", "UDP_0"), "Expected lci:/baz to be routed to UDP_0");
+    assertTrue(_isRoutedTo(adapter, "lci:/other/a", "OTHER"), "Expected lci:/other to still be routed to OTHER");
+    athenaConfig_Release(&running);
+    running = config;
+
+    // A link whose specification changed is reopened and its routes restored
+    config = _readConfig("link udp://127.0.0.1:40113/name=UDP_0\n"
+                         "route UDP_0 lci:/foo\n"
+                         "route UDP_0 lci:/baz\n"
+                         "route OTHER lci:/other\n");
+    assertTrue(athenaConfig_Apply(running, config, adapter, _testFIB, store, log, &changes), "Expected the configuration to apply");
+    assertTrue(changes.linksChanged == 1, "Expected 1 link changed, got %zu", changes.linksChanged);
+    assertTrue(changes.routesAdded == 2, "Expected the routes of the changed link to be restored, got %zu", changes.routesAdded);
+    assertTrue(_isRoutedTo(adapter, "lci:/foo/a", "UDP_0"), "Expected lci:/foo to be routed to the reopened UDP_0");
+    assertTrue(_isRoutedTo(adapter, "lci:/baz/a", "UDP_0"), "Expected lci:/baz to be routed to the reopened UDP_0");
+    athenaConfig_Release(&running);
+    running = config;
+
+    // Routes added at run time survive the link being reopened, and a reload that fails
+    PARCBitVector *linkVector = parcBitVector_Create();
+    parcBitVector_Set(linkVector, athenaTransportLinkAdapter_LinkNameToId(adapter, "UDP_0"));
+    CCNxName *runtimePrefix = ccnxName_CreateFromURI("lci:/runtime");
+    athenaFIB_AddRoute(_testFIB, runtimePrefix, linkVector);
+    ccnxName_Release(&runtimePrefix);
+    parcBitVector_Release(&linkVector);
+
+    config = _readConfig("link udp://127.0.0.1:40114/name=UDP_0\n"
+                         "link unknown://127.0.0.1:40115/name=UNKNOWN\n"
+                         "route UDP_0 lci:/foo\n"
+                         "route OTHER lci:/other\n");
+    assertFalse(athenaConfig_Apply(running, config, adapter, _testFIB, store, log, NULL), "Expected the configuration to fail");
+    assertTrue(athenaTransportLinkAdapter_LinkNameToId(adapter, "UDP_0") != -1, "Expected UDP_0 to be restored");
+    assertTrue(athenaTransportLinkAdapter_LinkNameToId(adapter, "UNKNOWN") == -1, "Expected UNKNOWN not to be open");
+    assertTrue(_isRoutedTo(adapter, "lci:/foo/a", "UDP_0"), "Expected lci:/foo to still be routed to UDP_0");
+    assertTrue(_isRoutedTo(adapter, "lci:/baz/a", "UDP_0"), "Expected lci:/baz to still be routed to UDP_0");
+    assertTrue(_isRoutedTo(adapter, "lci:/runtime/a", "UDP_0"), "Expected lci:/runtime to still be routed to UDP_0");
+    athenaConfig_Release(&config);
+
+    config = _readConfig("link udp://127.0.0.1:40114/name=UDP_0\n"
+                         "route UDP_0 lci:/foo\n"
+                         "route UDP_0 lci:/baz\n"
+                         "route OTHER lci:/other\n");
+    assertTrue(athenaConfig_Apply(running, config, adapter, _testFIB, store, log, &changes), "Expected the configuration to apply");
+    assertTrue(changes.linksChanged == 1, "Expected 1 link changed, got %zu", changes.linksChanged);
+    assertTrue(_isRoutedTo(adapter, "lci:/runtime/a", "UDP_0"), "Expected lci:/runtime to be routed to the reopened UDP_0");
+    athenaConfig_Release(&running);
+    athenaConfig_Release(&config);
+
+    athenaContentStore_Release(&store);
+    athenaTransportLinkAdapter_Destroy(&adapter);
+    athenaFIB_Release(&_testFIB);
+    parcLog_Release(&log);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Config);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -151,6 +151,10 @@ LONGBOW_TEST_CASE(Global, createRelease)
     AthenaLRUContentStoreConfig config;
 
     config.capacityInMB = 10;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
 
     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &config);
 
@@ -161,6 +165,10 @@ LONGBOW_TEST_CASE(Global, putContent)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 10;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &config);
 
     PARCBuffer *payload = parcBuffer_WrapCString("this is a payload");
@@ -178,6 +186,10 @@ LONGBOW_TEST_CASE(Global, removeMatch)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 10;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &config);
 
     PARCClock *clock = parcClock_Wallclock();
@@ -206,6 +218,10 @@ LONGBOW_TEST_CASE(Global, getMatchByName)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 10;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &config);
 
     char *lci = "lci:/cakes/and/pies";
@@ -241,6 +257,10 @@ LONGBOW_TEST_CASE(Global, setGetCapacity)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 10;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &config);
 
     size_t capacity = athenaContentStore_GetCapacity(store);
@@ -258,6 +278,10 @@ LONGBOW_TEST_CASE(Global, processMessage)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 10;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
     AthenaContentStore *store = athenaContentStore_Create(&AthenaContentStore_LRUImplementation, &config);
 
     CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthena_ContentStore "/stat/size");
@@ -396,6 +420,14 @@ LONGBOW_TEST_CASE(EmptyImplementation, apiFunctions)
 
     assertNull(athenaContentStore_ProcessMessage(store, interest), "Expected a NULL response.");
 
+    AthenaSnapshot *snapshot = athenaContentStore_CreateSnapshot(store);
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 0, "Expected an empty snapshot.");
+    athenaSnapshot_Release(&snapshot);
+
+    size_t bytesFreed = 1;
+    assertTrue(athenaContentStore_PurgePrefix(store, name, 10, &bytesFreed) == 0, "Expected nothing to be purged.");
+    assertTrue(bytesFreed == 0, "Expected no bytes to be freed.");
+
     ccnxName_Release(&name);
     ccnxInterest_Release(&interest);
     athenaContentStore_Release(&store);
@@ -416,6 +448,7 @@ LONGBOW_TEST_CASE(EmptyImplementation, booleanApiFunctions)
 
     assertFalse(athenaContentStore_PutContentObject(store, contentObject), "Expected false from PutContentObject");
     assertFalse(athenaContentStore_GetMatch(store, interest), "Expected false from GetMatch");
+    assertFalse(athenaContentStore_ContainsMatch(store, interest), "Expected false from ContainsMatch");
     assertFalse(athenaContentStore_SetCapacity(store, 1), "Expected false from SetCapacity");
     assertFalse(athenaContentStore_RemoveMatch(store, name, NULL, NULL), "Expected false from RemoveMatch");
 
@@ -37,6 +37,10 @@
 #include <LongBow/unit-test.h>
 
 #include <stdio.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_FileOutputStream.h>
+#include <parc/logging/parc_LogReporterFile.h>
 
 typedef struct test_data {
     AthenaFIB *testFIB;
@@ -80,9 +84,15 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaFIB_AddRoute);
     LONGBOW_RUN_TEST_CASE(Global, athenaFIB_Lookup);
     LONGBOW_RUN_TEST_CASE(Global, athenaFIB_Lookup_EmptyPath);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_LookupBatch);
     LONGBOW_RUN_TEST_CASE(Global, athenaFIB_DeleteRoute);
     LONGBOW_RUN_TEST_CASE(Global, athenaFIB_RemoveLink);
     LONGBOW_RUN_TEST_CASE(Global, athenaFIB_CreateEntryList);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_AcquireSnapshot);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_SetImage);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_SetAggregation);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_AddLeasedRoute);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_RestoreLinkEntries);
 //    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_Equals);
 //    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_NotEquals);
 //    LONGBOW_RUN_TEST_CASE(Global, athenaFIB_ToString);
@@ -197,6 +207,38 @@ LONGBOW_TEST_CASE(Global, athenaFIB_Lookup_EmptyPath)
     assertTrue(parcBitVector_Equals(result, data->testVector12), "Expected lookup to equal test vector");
 }
 
+LONGBOW_TEST_CASE(Global, athenaFIB_LookupBatch)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CCNxName *routeName = ccnxName_CreateFromURI("lci:/a/b");
+    athenaFIB_AddRoute(data->testFIB, routeName, data->testVector1);
+    athenaFIB_AddRoute(data->testFIB, data->testName2, data->testVector2);
+
+    CCNxName *unrouted = ccnxName_CreateFromURI("lci:/x/y");
+    const CCNxName *names[] = { data->testName1, data->testName2, unrouted, data->testName1 };
+    size_t count = sizeof(names) / sizeof(names[0]);
+    PARCBitVector *results[count];
+
+    athenaFIB_LookupBatch(data->testFIB, names, count, results);
+    assertTrue(parcBitVector_Equals(results[0], data->testVector1), "Expected the longest matching route");
+    assertTrue(parcBitVector_Equals(results[1], data->testVector2), "Expected the exact route");
+    assertNull(results[2], "Expected no result for an unrouted name");
+    assertTrue(parcBitVector_Equals(results[3], data->testVector1), "Expected a repeated name to match again");
+
+    for (size_t i = 0; i < count; i++) {
+        PARCBitVector *single = athenaFIB_Lookup(data->testFIB, names[i]);
+        assertTrue(((single == NULL) && (results[i] == NULL)) || parcBitVector_Equals(single, results[i]),
+                   "Expected the batch to agree with athenaFIB_Lookup for name %zu", i);
+        if (results[i] != NULL) {
+            parcBitVector_Release(&results[i]);
+        }
+    }
+
+    ccnxName_Release(&routeName);
+    ccnxName_Release(&unrouted);
+}
+
 LONGBOW_TEST_CASE(Global, athenaFIB_DeleteRoute)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -267,6 +309,237 @@ LONGBOW_TEST_CASE(Global, athenaFIB_CreateEntryList)
     parcList_Release(&entryList);
 }
 
+LONGBOW_TEST_CASE(Global, athenaFIB_AcquireSnapshot)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    athenaFIB_AddRoute(data->testFIB, data->testName1, data->testVector12);
+
+    AthenaSnapshot *snapshot = athenaFIB_AcquireSnapshot(data->testFIB);
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected the snapshot to have 2 entries");
+
+    AthenaSnapshot *unchanged = athenaFIB_AcquireSnapshot(data->testFIB);
+    assertTrue(unchanged == snapshot, "Expected the snapshot to be shared until the routes change");
+    athenaSnapshot_Release(&unchanged);
+
+    athenaFIB_DeleteRoute(data->testFIB, data->testName1, data->testVector12);
+
+    AthenaSnapshot *changed = athenaFIB_AcquireSnapshot(data->testFIB);
+    assertTrue(changed != snapshot, "Expected a new snapshot after a route change");
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected the earlier snapshot to be unaffected by the change");
+
+    const AthenaFIBListEntry *entry = athenaSnapshot_Get(snapshot, 1);
+    assertTrue(ccnxName_Equals(data->testName1, entry->name), "Expect the name at 1 to be testName1");
+    assertTrue(entry->linkId == 42, "Expect the routeId at 1 to be 42");
+
+    athenaSnapshot_Release(&changed);
+    athenaSnapshot_Release(&snapshot);
+}
+
+static bool
+_lookupEquals(AthenaFIB *fib, const char *uri, int linkId)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    PARCBitVector *result = athenaFIB_Lookup(fib, name);
+    ccnxName_Release(&name);
+    if (linkId == -1) {
+        return (result == NULL) || (parcBitVector_NumberOfBitsSet(result) == 0);
+    }
+    return (result != NULL) && (parcBitVector_NumberOfBitsSet(result) == 1) && (parcBitVector_Get(result, linkId) == 1);
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIB_SetImage)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    const char *imagePath = "/tmp/test_athena_FIB.fib";
+
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+    PARCLog *log = parcLog_Create("localhost", "test_athena_FIB", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+
+    FILE *routeList = tmpfile();
+    fputs("IMAGE_0 lci:/a\n"
+          "IMAGE_1 lci:/a/b\n"
+          "IMAGE_0 lci:/\n", routeList);
+    rewind(routeList);
+    assertTrue(athenaFIBImage_Compile(routeList, imagePath, log) == 3, "Expected the image to compile");
+    fclose(routeList);
+    AthenaFIBImage *image = athenaFIBImage_Open(imagePath, log);
+    assertNotNull(image, "Expected the image to open");
+    unlink(imagePath);
+    parcLog_Release(&log);
+
+    athenaFIB_SetImage(data->testFIB, image);
+    assertTrue(athenaFIB_GetImage(data->testFIB) == image, "Expected the FIB to hold the image");
+    athenaFIBImage_Release(&image);
+
+    // Image routes are only used once their links are known
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c", -1), "Expected no route to unopened image links");
+    athenaFIB_SetImageLinkId(data->testFIB, 0, 0);
+    athenaFIB_SetImageLinkId(data->testFIB, 1, 42);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c", 42), "Expected the image route for lci:/a/b");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/x", 0), "Expected the image route for lci:/a");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/q", 0), "Expected the image default route");
+
+    // Added routes extend the image, the longest match winning
+    athenaFIB_AddRoute(data->testFIB, data->testName1, data->testVector3);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", 23), "Expected the added route for lci:/a/b/c");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 42), "Expected the image route for lci:/a/b");
+
+    // A deleted image route stays hidden until it's added again
+    CCNxName *imageName = ccnxName_CreateFromURI("lci:/a/b");
+    athenaFIB_DeleteRoute(data->testFIB, imageName, data->testVector2);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 0), "Expected the deleted route to fall back to lci:/a");
+    athenaFIB_AddRoute(data->testFIB, imageName, data->testVector1);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 0), "Expected the route added back for lci:/a/b");
+    ccnxName_Release(&imageName);
+
+    // Removing a link forgets it in the image too
+    athenaFIB_RemoveLink(data->testFIB, data->testVector1);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", -1), "Expected no route once link 0 is removed");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/q", -1), "Expected no default route once link 0 is removed");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", 23), "Expected the added route to remain");
+
+    athenaFIB_SetImage(data->testFIB, NULL);
+    assertNull(athenaFIB_GetImage(data->testFIB), "Expected the image to be removed");
+}
+LONGBOW_TEST_CASE(Global, athenaFIB_SetAggregation)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *parent = ccnxName_CreateFromURI("lci:/a/b");
+    CCNxName *child = ccnxName_CreateFromURI("lci:/a/b/x");
+    CCNxName *grandchild = ccnxName_CreateFromURI("lci:/a/b/c/d");
+
+    assertTrue(athenaFIB_SetAggregation(data->testFIB, true), "Expected aggregation to be enabled");
+    athenaFIB_AddRoute(data->testFIB, parent, data->testVector1);
+    athenaFIB_AddRoute(data->testFIB, data->testName1, data->testVector1);
+    athenaFIB_AddRoute(data->testFIB, data->testName2, data->testVector2);
+    assertTrue(athenaFIB_GetNumberOfAggregatedRoutes(data->testFIB) == 1, "Expected lci:/a/b/c to be aggregated into lci:/a/b");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", 0), "Expected the aggregated route's links");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 42), "Expected the route for lci:/a/b/a");
+
+    // A route beneath an aggregated route is found before the route it's aggregated into
+    athenaFIB_AddRoute(data->testFIB, grandchild, data->testVector3);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d/e", 23), "Expected the route for lci:/a/b/c/d");
+    athenaFIB_DeleteRoute(data->testFIB, grandchild, data->testVector3);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d/e", 0), "Expected the aggregated route's links");
+
+    // Changing the route above puts back the routes that now differ from it
+    athenaFIB_AddRoute(data->testFIB, parent, data->testVector2);
+    assertTrue(athenaFIB_GetNumberOfAggregatedRoutes(data->testFIB) == 0, "Expected no aggregated routes");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", 0), "Expected lci:/a/b/c to keep its links");
+    PARCBitVector *result = athenaFIB_Lookup(data->testFIB, child);
+    assertTrue(parcBitVector_Equals(result, data->testVector12), "Expected lci:/a/b to have both links");
+
+    // Deleting a route leaves the lookups it answered to the route above
+    athenaFIB_DeleteRoute(data->testFIB, parent, data->testVector1);
+    athenaFIB_DeleteRoute(data->testFIB, data->testName2, data->testVector2);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 42), "Expected lci:/a/b to answer for lci:/a/b/a");
+
+    // Routes added before the route above them are aggregated when aggregation is enabled
+    athenaFIB_SetAggregation(data->testFIB, false);
+    athenaFIB_AddRoute(data->testFIB, child, data->testVector2);
+    assertTrue(athenaFIB_GetNumberOfAggregatedRoutes(data->testFIB) == 0, "Expected no aggregated routes");
+    athenaFIB_SetAggregation(data->testFIB, true);
+    assertTrue(athenaFIB_GetNumberOfAggregatedRoutes(data->testFIB) == 1, "Expected lci:/a/b/x to be aggregated into lci:/a/b");
+
+    // The entry list still holds every route
+    PARCList *entryList = athenaFIB_CreateEntryList(data->testFIB);
+    bool listed = false;
+    for (size_t i = 0; i < parcList_Size(entryList); ++i) {
+        AthenaFIBListEntry *entry = parcList_GetAtIndex(entryList, i);
+        listed |= ccnxName_Equals(athenaFIBListEntry_GetName(entry), child);
+    }
+    parcList_Release(&entryList);
+    assertTrue(listed, "Expected the aggregated route in the entry list");
+
+    athenaFIB_SetAggregation(data->testFIB, false);
+    assertTrue(athenaFIB_GetNumberOfAggregatedRoutes(data->testFIB) == 0, "Expected every route to be put back");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/x", 42), "Expected lci:/a/b/x to be routed to link 42");
+
+    ccnxName_Release(&grandchild);
+    ccnxName_Release(&child);
+    ccnxName_Release(&parent);
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIB_AddLeasedRoute)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    assertTrue(athenaFIB_AddLeasedRoute(data->testFIB, data->testName1, data->testVector1, 1000), "Expected the route to be added");
+    assertTrue(athenaFIB_GetNumberOfLeases(data->testFIB) == 1, "Expected 1 lease");
+    assertTrue(athenaFIB_ExpireLeases(data->testFIB, 500) == 0, "Expected no lease to run out yet");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", 0), "Expected the leased route");
+
+    // Renewing the lease keeps the route
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName1, data->testVector1, 2000);
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName2, data->testVector2, 1800);
+    assertTrue(athenaFIB_GetNumberOfLeases(data->testFIB) == 2, "Expected a renewed lease not to be counted twice");
+    assertTrue(athenaFIB_ExpireLeases(data->testFIB, 1500) == 0, "Expected the renewed lease to be kept");
+    assertTrue(athenaFIB_ExpireLeases(data->testFIB, 2500) == 2, "Expected both leases to run out");
+    assertTrue(athenaFIB_GetNumberOfLeases(data->testFIB) == 0, "Expected no leases");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", -1), "Expected the route to be removed");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", -1), "Expected the route to be removed");
+
+    // Routes added or deleted without a lease drop it
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName1, data->testVector1, 3000);
+    athenaFIB_AddRoute(data->testFIB, data->testName1, data->testVector1);
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName2, data->testVector2, 3000);
+    athenaFIB_DeleteRoute(data->testFIB, data->testName2, data->testVector2);
+    assertTrue(athenaFIB_GetNumberOfLeases(data->testFIB) == 0, "Expected no leases");
+    assertTrue(athenaFIB_ExpireLeases(data->testFIB, 4000) == 0, "Expected no leases to run out");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/c/d", 0), "Expected the route added without a lease to be kept");
+
+    // Leases are held per link
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName2, data->testVector12, 5000);
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName2, data->testVector2, 6000);
+    PARCJSONArray *leaseCounts = athenaFIB_CreateLeaseCounts(data->testFIB);
+    assertTrue(parcJSONArray_GetLength(leaseCounts) == 1, "Expected 1 leased prefix");
+    parcJSONArray_Release(&leaseCounts);
+    assertTrue(athenaFIB_ExpireLeases(data->testFIB, 5500) == 1, "Expected the lease on link 0 to run out");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 42), "Expected the route to link 42 to be kept");
+    athenaFIB_RemoveLink(data->testFIB, data->testVector2);
+    assertTrue(athenaFIB_GetNumberOfLeases(data->testFIB) == 0, "Expected removing the link to drop its lease");
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIB_RestoreLinkEntries)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    athenaFIB_AddRoute(data->testFIB, data->testName1, data->testVector12);
+    athenaFIB_AddLeasedRoute(data->testFIB, data->testName2, data->testVector1, 5000);
+    athenaFIB_AddRoute(data->testFIB, data->testName2, data->testVector2);
+
+    PARCList *routes = athenaFIB_CreateLinkEntryList(data->testFIB, 0);
+    assertTrue(parcList_Size(routes) == 2, "Expected 2 routes to link 0, got %zu", parcList_Size(routes));
+
+    // Routes come back on the link they are restored to, leased routes with their lease
+    athenaFIB_RemoveLink(data->testFIB, data->testVector1);
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 42), "Expected only the route to link 42 to be left");
+    assertTrue(athenaFIB_RestoreLinkEntries(data->testFIB, routes, 23) == 2, "Expected 2 routes to be restored");
+    parcList_Release(&routes);
+
+    PARCBitVector *expected = parcBitVector_Create();
+    parcBitVector_Set(expected, 23);
+    parcBitVector_Set(expected, 42);
+    PARCBitVector *links = athenaFIB_Lookup(data->testFIB, data->testName1);
+    assertTrue(parcBitVector_Equals(links, expected), "Expected lci:/a/b/c to be routed to links 23 and 42");
+    links = athenaFIB_Lookup(data->testFIB, data->testName2);
+    assertTrue(parcBitVector_Equals(links, expected), "Expected lci:/a/b/a to be routed to links 23 and 42");
+    parcBitVector_Release(&expected);
+
+    assertTrue(athenaFIB_GetNumberOfLeases(data->testFIB) == 1, "Expected the lease to be restored");
+    assertTrue(athenaFIB_ExpireLeases(data->testFIB, 6000) == 1, "Expected the restored lease to run out");
+    assertTrue(_lookupEquals(data->testFIB, "lci:/a/b/a", 42), "Expected the route to link 42 to be kept");
+
+    routes = athenaFIB_CreateLinkEntryList(data->testFIB, 0);
+    assertTrue(parcList_Size(routes) == 0, "Expected no routes to a removed link");
+    parcList_Release(&routes);
+}
 
 //LONGBOW_TEST_CASE(Global, athenaFIB_Equals)
 //{
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_FIBImage.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_FileOutputStream.h>
+#include <parc/logging/parc_LogReporterFile.h>
+
+#define TEST_IMAGE_PATH "/tmp/test_athena_FIBImage.fib"
+
+static PARCLog *
+_createLog(void)
+{
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+
+    PARCLog *log = parcLog_Create("localhost", "test_athena_FIBImage", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+    return log;
+}
+
+static ssize_t
+_compile(const char *routeList)
+{
+    FILE *file = tmpfile();
+    fputs(routeList, file);
+    rewind(file);
+    PARCLog *log = _createLog();
+    ssize_t result = athenaFIBImage_Compile(file, TEST_IMAGE_PATH, log);
+    parcLog_Release(&log);
+    fclose(file);
+    return result;
+}
+
+// Return the depth of the longest image route for uri, -1 if there is none, and its links in linkNames
+static int
+_longestMatch(AthenaFIBImage *image, const char *uri, char *linkNames, size_t size)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    AthenaFIBImageMatch matches[AthenaFIBImageMaxDepth + 1];
+    size_t numMatches = athenaFIBImage_Match(image, name, matches, AthenaFIBImageMaxDepth + 1);
+    ccnxName_Release(&name);
+
+    linkNames[0] = '\0';
+    if (numMatches == 0) {
+        return -1;
+    }
+    AthenaFIBImageMatch *longest = &matches[numMatches - 1];
+    for (size_t i = 0; i < longest->numLinks; i++) {
+        if (i > 0) {
+            strncat(linkNames, " ", size - strlen(linkNames) - 1);
+        }
+        strncat(linkNames, athenaFIBImage_GetLinkName(image, longest->links[i]), size - strlen(linkNames) - 1);
+    }
+    return (int) longest->depth;
+}
+
+LONGBOW_TEST_RUNNER(athena_FIBImage)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_FIBImage)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_FIBImage)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIBImage_Compile);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIBImage_Compile_Errors);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIBImage_Match);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFIBImage_Open_Invalid);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    unlink(TEST_IMAGE_PATH);
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIBImage_Compile)
+{
+    ssize_t numRoutes = _compile("# test routes\n"
+                                 "UDP_0 lci:/a\n"
+                                 "\n"
+                                 "UDP_1 lci:/a/b   # comment\n"
+                                 "UDP_0 lci:/a/b\n"
+                                 "UDP_0 lci:/a/b\n"
+                                 "TCP_0 lci:/\n");
+    assertTrue(numRoutes == 3, "Expected 3 routes, got %zd", numRoutes);
+
+    PARCLog *log = _createLog();
+    AthenaFIBImage *image = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    parcLog_Release(&log);
+    assertNotNull(image, "Expected the compiled image to open");
+    assertTrue(athenaFIBImage_GetNumberOfRoutes(image) == 3, "Expected 3 routes in the image");
+    assertTrue(athenaFIBImage_GetNumberOfLinks(image) == 3, "Expected 3 links in the image");
+    assertTrue(strcmp(athenaFIBImage_GetLinkName(image, 0), "UDP_0") == 0, "Expected links in the order listed");
+
+    AthenaFIBImage *acquired = athenaFIBImage_Acquire(image);
+    athenaFIBImage_Release(&acquired);
+    assertNull(acquired, "Expected athenaFIBImage_Release to NULL the pointer");
+    athenaFIBImage_Release(&image);
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIBImage_Compile_Errors)
+{
+    assertTrue(_compile("UDP_0\n") == -1, "Expected a route without a prefix to be rejected");
+    assertTrue(_compile("UDP_0 lci:/a extra\n") == -1, "Expected a route with extra words to be rejected");
+    assertTrue(access(TEST_IMAGE_PATH, F_OK) != 0, "Expected no image to be written");
+
+    char routeList[4 * AthenaFIBImageMaxDepth + 64] = "UDP_0 lci:";
+    for (int i = 0; i <= AthenaFIBImageMaxDepth; i++) {
+        strcat(routeList, "/x");
+    }
+    strcat(routeList, "\n");
+    assertTrue(_compile(routeList) == -1, "Expected a route deeper than %d segments to be rejected", AthenaFIBImageMaxDepth);
+
+    assertTrue(_compile("") == 0, "Expected an empty route list to compile");
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIBImage_Match)
+{
+    _compile("UDP_0 lci:/a\n"
+             "UDP_1 lci:/a/b\n"
+             "UDP_0 lci:/a/b\n"
+             "UDP_2 lci:/z/y/x\n"
+             "UDP_1 lci:/c\n"
+             "UDP_0 lci:/cc\n");
+    PARCLog *log = _createLog();
+    AthenaFIBImage *image = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    parcLog_Release(&log);
+    assertNotNull(image, "Expected the compiled image to open");
+
+    char linkNames[64];
+    int depth = _longestMatch(image, "lci:/a/b/c", linkNames, sizeof(linkNames));
+    assertTrue(depth == 2, "Expected lci:/a/b to match, got depth %d", depth);
+    assertTrue(strcmp(linkNames, "UDP_1 UDP_0") == 0, "Expected UDP_1 and UDP_0, got %s", linkNames);
+    depth = _longestMatch(image, "lci:/a/x", linkNames, sizeof(linkNames));
+    assertTrue((depth == 1) && (strcmp(linkNames, "UDP_0") == 0), "Expected lci:/a to match, got %d %s", depth, linkNames);
+    depth = _longestMatch(image, "lci:/cc/d", linkNames, sizeof(linkNames));
+    assertTrue((depth == 1) && (strcmp(linkNames, "UDP_0") == 0), "Expected lci:/cc to match, got %d %s", depth, linkNames);
+    depth = _longestMatch(image, "lci:/c", linkNames, sizeof(linkNames));
+    assertTrue((depth == 1) && (strcmp(linkNames, "UDP_1") == 0), "Expected lci:/c to match, got %d %s", depth, linkNames);
+    depth = _longestMatch(image, "lci:/z/y", linkNames, sizeof(linkNames));
+    assertTrue(depth == -1, "Expected no match for a prefix of a route, got %d", depth);
+    depth = _longestMatch(image, "lci:/q", linkNames, sizeof(linkNames));
+    assertTrue(depth == -1, "Expected no match without a default route, got %d", depth);
+    athenaFIBImage_Release(&image);
+
+    // Replacing the image doesn't disturb one already mapped
+    log = _createLog();
+    image = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    _compile("TCP_0 lci:/\n");
+    AthenaFIBImage *replacement = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    parcLog_Release(&log);
+    depth = _longestMatch(image, "lci:/a/b", linkNames, sizeof(linkNames));
+    assertTrue(depth == 2, "Expected the mapped image to be unchanged, got depth %d", depth);
+    depth = _longestMatch(replacement, "lci:/q", linkNames, sizeof(linkNames));
+    assertTrue((depth == 0) && (strcmp(linkNames, "TCP_0") == 0), "Expected the default route to match, got %d %s", depth, linkNames);
+    athenaFIBImage_Release(&replacement);
+    athenaFIBImage_Release(&image);
+}
+
+LONGBOW_TEST_CASE(Global, athenaFIBImage_Open_Invalid)
+{
+    PARCLog *log = _createLog();
+    AthenaFIBImage *image = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    assertNull(image, "Expected a missing image not to open");
+
+    FILE *file = fopen(TEST_IMAGE_PATH, "w");
+    for (int i = 0; i < 64; i++) {
+        fputs("not a FIB image ", file);
+    }
+    fclose(file);
+    image = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    assertNull(image, "Expected a file that isn't an image not to open");
+
+    // A truncated image is rejected rather than read beyond its end
+    _compile("UDP_0 lci:/a\n");
+    truncate(TEST_IMAGE_PATH, sizeof(_AthenaFIBImageHeader) + 8);
+    image = athenaFIBImage_Open(TEST_IMAGE_PATH, log);
+    assertNull(image, "Expected a truncated image not to open");
+    parcLog_Release(&log);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_FIBImage);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
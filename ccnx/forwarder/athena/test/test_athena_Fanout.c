@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Fanout.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_FileOutputStream.h>
+#include <parc/logging/parc_LogReporterFile.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/forwarder/athena/athena.h>
+
+#define TEST_NUM_LINKS ((2 * AthenaFanoutChunkSize) + 3) // two full chunks and a partial one
+
+typedef struct test_data {
+    PARCLog *log;
+    AthenaTransportLinkAdapter *adapter;
+    AthenaFanout *fanout;
+} TestData;
+
+static void
+_removeLink(void *context, PARCBitVector *linkVector)
+{
+}
+
+static PARCLog *
+_createLog(void)
+{
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+
+    PARCLog *log = parcLog_Create("localhost", "test_athena_Fanout", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+    return log;
+}
+
+LONGBOW_TEST_RUNNER(athena_Fanout)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Fanout)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Fanout)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaFanout_GetThreshold);
+    LONGBOW_RUN_TEST_CASE(Global, athenaFanout_Send);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    data->log = _createLog();
+    data->adapter = athenaTransportLinkAdapter_Create(_removeLink, NULL);
+    data->fanout = athenaFanout_Create(3, AthenaFanoutDefaultThreshold, data->log);
+    assertNotNull(data->fanout, "athenaFanout_Create failed");
+
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    athenaFanout_Release(&data->fanout);
+    athenaTransportLinkAdapter_Destroy(&data->adapter);
+    parcLog_Release(&data->log);
+    parcMemory_Deallocate(&data);
+
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaFanout_GetThreshold)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    assertTrue(athenaFanout_GetThreshold(data->fanout) == AthenaFanoutDefaultThreshold, "Unexpected threshold %zu",
+               athenaFanout_GetThreshold(data->fanout));
+}
+
+LONGBOW_TEST_CASE(Global, athenaFanout_Send)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCBitVector *resultVector;
+    CCNxMetaMessage *receiveMessage;
+
+    PARCURI *connectionURI = parcURI_Parse("tcp://127.0.0.1:40130/Listener/name=TCPListener");
+    assertNotNull(athenaTransportLinkAdapter_Open(data->adapter, connectionURI), "Unable to open the listener");
+    parcURI_Release(&connectionURI);
+
+    PARCBitVector *linkVector = parcBitVector_Create();
+    for (int i = 0; i < TEST_NUM_LINKS; i++) {
+        char specification[64];
+        snprintf(specification, sizeof(specification), "tcp://127.0.0.1:40130/name=TCP_%d", i);
+        connectionURI = parcURI_Parse(specification);
+        assertNotNull(athenaTransportLinkAdapter_Open(data->adapter, connectionURI), "Unable to open %s", specification);
+        parcURI_Release(&connectionURI);
+        parcBitVector_Set(linkVector, athenaTransportLinkAdapter_LinkNameToId(data->adapter, specification + strlen("tcp://127.0.0.1:40130/name=")));
+    }
+    // A link that isn't open is skipped
+    parcBitVector_Set(linkVector, 999);
+
+    // Accept the connections and find the links accepting sends
+    for (int i = 0; i < 10; i++) {
+        receiveMessage = athenaTransportLinkAdapter_Receive(data->adapter, &resultVector, 10);
+        assertNull(receiveMessage, "Received message when none sent");
+    }
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    PARCBuffer *payload = parcBuffer_WrapCString("fan-out");
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+    athena_EncodeMessage(contentObject);
+
+    resultVector = athenaFanout_Send(data->fanout, data->adapter, contentObject, linkVector);
+    assertTrue(parcBitVector_NumberOfBitsSet(resultVector) == TEST_NUM_LINKS, "Expected %d links handed to the workers, got %u",
+               TEST_NUM_LINKS, parcBitVector_NumberOfBitsSet(resultVector));
+    assertFalse(parcBitVector_Get(resultVector, 999), "A link that isn't open was handed to the workers");
+    parcBitVector_Release(&resultVector);
+    parcBitVector_Release(&linkVector);
+
+    // The forwarder goes on while the workers send, the message is kept until they are done with it
+    ccnxContentObject_Release(&contentObject);
+
+    // Every accepted end of the connections receives the object once
+    int numReceived = 0;
+    while (numReceived < TEST_NUM_LINKS) {
+        receiveMessage = athenaTransportLinkAdapter_Receive(data->adapter, &resultVector, 1000);
+        if (receiveMessage) {
+            assertTrue(ccnxMetaMessage_IsContentObject(receiveMessage), "Expected a Content Object");
+            ccnxMetaMessage_Release(&receiveMessage);
+            parcBitVector_Release(&resultVector);
+            numReceived++;
+        }
+    }
+
+    AthenaFanoutStats stats;
+    do {
+        usleep(1000);
+        athenaFanout_GetStats(data->fanout, &stats);
+    } while (stats.numFanouts == 0);
+    assertTrue(stats.numLinks == TEST_NUM_LINKS, "Expected %d links sent to, got %llu", TEST_NUM_LINKS, (unsigned long long) stats.numLinks);
+    assertTrue(stats.numSendsFailed == 0, "Unexpected send failures %llu", (unsigned long long) stats.numSendsFailed);
+
+    uint64_t numBucketed = 0;
+    for (int bucket = 0; bucket < AthenaFanoutLatencyBuckets; bucket++) {
+        numBucketed += stats.latencyHistogram[bucket];
+    }
+    assertTrue(numBucketed == 1, "Expected the fan-out counted in one latency bucket");
+    assertTrue(stats.maxLatencyMicros == stats.totalLatencyMicros, "Expected the only fan-out to be the longest");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Fanout);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -72,6 +72,9 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_FIB);
     LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Set);
     LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Quit);
+    LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Drain);
+    LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Dump);
+    LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_DumpWalk);
     LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Stats);
     LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Spawn);
     LONGBOW_RUN_TEST_CASE(Global, athenaInterestControl_Control);
@@ -381,7 +384,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Set)
 
     athena_EncodeMessage(interest);
 
-    response = _Control_Command(athena, interest);
+    response = _Control_Command(athena, interest, NULL);
     assertNotNull(response, "Invalid set type not replied to");
     ccnxMetaMessage_Release(&response);
 
@@ -394,7 +397,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Set)
 
     athena_EncodeMessage(interest);
 
-    response = _Control_Command(athena, interest);
+    response = _Control_Command(athena, interest, NULL);
     assertNotNull(response, "Missing set level not replied to");
     ccnxMetaMessage_Release(&response);
 
@@ -408,7 +411,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Set)
 
         athena_EncodeMessage(interest);
 
-        response = _Control_Command(athena, interest);
+        response = _Control_Command(athena, interest, NULL);
         assertNotNull(response, "Quit command failed");
         ccnxMetaMessage_Release(&response);
 
@@ -428,7 +431,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Quit)
 
     athena_EncodeMessage(interest);
 
-    CCNxMetaMessage *response = _Control_Command(athena, interest);
+    CCNxMetaMessage *response = _Control_Command(athena, interest, NULL);
     assertNotNull(response, "Quit command failed");
 
     ccnxMetaMessage_Release(&interest);
@@ -436,6 +439,202 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Quit)
     athena_Release(&athena);
 }
 
+LONGBOW_TEST_CASE(Global, athenaInterestControl_Drain)
+{
+    Athena *athena = athena_Create(0);
+
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_Drain);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+    athena_EncodeMessage(interest);
+
+    // Refused from a remote link
+    PARCURI *connectionURI = parcURI_Parse("tcp://localhost:50650/listener/name=TCPListener");
+    assertNotNull(athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI), "Unable to open listener");
+    parcURI_Release(&connectionURI);
+    connectionURI = parcURI_Parse("tcp://localhost:50650/local=false/name=TCP_0");
+    assertNotNull(athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI), "Unable to open link");
+    parcURI_Release(&connectionURI);
+
+    PARCBitVector *remoteVector = parcBitVector_Create();
+    parcBitVector_Set(remoteVector, athenaTransportLinkAdapter_LinkNameToId(athena->athenaTransportLinkAdapter, "TCP_0"));
+    CCNxMetaMessage *response = _Control_Command(athena, interest, remoteVector);
+    assertNotNull(response, "Drain command failed");
+    assertTrue(athena->athenaState == Athena_Running, "Expected a drain from a remote link to be refused");
+    ccnxMetaMessage_Release(&response);
+    parcBitVector_Release(&remoteVector);
+
+    // Refused if it names a snapshot file
+    CCNxInterest *interestWithPath = ccnxInterest_CreateSimple(ccnxInterest_GetName(interest));
+    PARCBuffer *payload = parcBuffer_AllocateCString("/tmp/athena_cs.json");
+    ccnxInterest_SetPayload(interestWithPath, payload);
+    parcBuffer_Release(&payload);
+    athena_EncodeMessage(interestWithPath);
+    response = _Control_Command(athena, interestWithPath, NULL);
+    assertNotNull(response, "Drain command failed");
+    assertTrue(athena->athenaState == Athena_Running, "Expected a drain naming a snapshot file to be refused");
+    ccnxMetaMessage_Release(&response);
+    ccnxMetaMessage_Release(&interestWithPath);
+
+    // The snapshot file is only set locally
+    athena_SetDrainSnapshotPath(athena, "/tmp/athena_cs.json");
+    response = _Control_Command(athena, interest, NULL);
+    assertNotNull(response, "Drain command failed");
+    assertTrue(athena->athenaState == Athena_Draining, "Expected the forwarder to be draining");
+    assertTrue(strcmp(athena->drainSnapshotPath, "/tmp/athena_cs.json") == 0, "Expected the snapshot path to be kept");
+
+    ccnxMetaMessage_Release(&interest);
+    ccnxMetaMessage_Release(&response);
+    athena_Release(&athena);
+}
+
+static CCNxMetaMessage *
+_dumpChunk(Athena *athena, const char *table, const char *dumpId, uint64_t chunkNumber)
+{
+    char uri[MAXPATHLEN];
+    sprintf(uri, "%s/%s/%s", CCNxNameAthenaCommand_Dump, table, dumpId);
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    CCNxNameSegment *chunkSegment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, chunkNumber);
+    ccnxName_Append(name, chunkSegment);
+    ccnxNameSegment_Release(&chunkSegment);
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+    athena_EncodeMessage(interest);
+
+    CCNxMetaMessage *response = _Control_Command(athena, interest, NULL);
+    assertNotNull(response, "Dump command failed");
+    ccnxMetaMessage_Release(&interest);
+    return response;
+}
+
+LONGBOW_TEST_CASE(Global, athenaInterestControl_Dump)
+{
+    Athena *athena = athena_Create(0);
+
+    // Enough routes for two chunks
+    PARCBitVector *linkVector = parcBitVector_Create();
+    parcBitVector_Set(linkVector, 0);
+    for (int i = 0; i < AthenaDumpEntriesPerChunk + 1; i++) {
+        char uri[64];
+        sprintf(uri, "lci:/dump/route/%d", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        athenaFIB_AddRoute(athena->athenaFIB, name, linkVector);
+        ccnxName_Release(&name);
+    }
+    parcBitVector_Release(&linkVector);
+
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthenaCommand_Dump "/" AthenaDump_FIB);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+    athena_EncodeMessage(interest);
+    CCNxMetaMessage *response = _Control_Command(athena, interest, NULL);
+    assertNotNull(response, "Dump command failed");
+    assertTrue(athena->dumpSequence == 0, "Expected a dump without an id to be refused");
+    ccnxMetaMessage_Release(&response);
+    ccnxMetaMessage_Release(&interest);
+
+    // Two dumps at once are kept apart
+    response = _dumpChunk(athena, AthenaDump_FIB, "one", 0);
+    ccnxMetaMessage_Release(&response);
+    response = _dumpChunk(athena, AthenaDump_FIB, "two", 0);
+    ccnxMetaMessage_Release(&response);
+    assertTrue(_findDump(athena, "one") >= 0, "Expected the first dump's snapshot to be kept");
+    assertTrue(_findDump(athena, "two") >= 0, "Expected the second dump's snapshot to be kept");
+
+    response = _dumpChunk(athena, AthenaDump_FIB, "one", 1);
+    ccnxMetaMessage_Release(&response);
+    assertTrue(_findDump(athena, "one") < 0, "Expected the snapshot to be released after its last chunk");
+    assertTrue(_findDump(athena, "two") >= 0, "Expected the other dump's snapshot to be kept");
+
+    // A later chunk without a snapshot is refused, not rendered from a new one
+    response = _dumpChunk(athena, AthenaDump_FIB, "one", 1);
+    ccnxMetaMessage_Release(&response);
+    assertTrue(_findDump(athena, "one") < 0, "Expected a retransmitted last chunk not to take a new snapshot");
+    response = _dumpChunk(athena, AthenaDump_FIB, "three", 1);
+    ccnxMetaMessage_Release(&response);
+    assertTrue(_findDump(athena, "three") < 0, "Expected a dump not started from chunk 0 to be refused");
+
+    // The least recently used dump makes way once every slot is taken
+    for (int i = 0; i < AthenaDumpsOutstanding; i++) {
+        char dumpId[16];
+        sprintf(dumpId, "slot%d", i);
+        response = _dumpChunk(athena, AthenaDump_FIB, dumpId, 0);
+        ccnxMetaMessage_Release(&response);
+    }
+    assertTrue(_findDump(athena, "two") < 0, "Expected the oldest dump to be abandoned");
+
+    athena_Release(&athena);
+}
+
+LONGBOW_TEST_CASE(Global, athenaInterestControl_DumpWalk)
+{
+    Athena *athena = athena_Create(1);
+
+    // Enough content for three chunks, and pending interests for two
+    for (int i = 0; i < (2 * AthenaDumpEntriesPerChunk) + 1; i++) {
+        char uri[64];
+        sprintf(uri, "lci:/dump/content/%d", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
+        athenaContentStore_PutContentObject(athena->athenaContentStore, contentObject);
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+    PARCBitVector *ingressVector = parcBitVector_Create();
+    parcBitVector_Set(ingressVector, 0);
+    for (int i = 0; i < AthenaDumpEntriesPerChunk + 1; i++) {
+        char uri[64];
+        sprintf(uri, "lci:/dump/interest/%d", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        CCNxInterest *interest = ccnxInterest_Create(name, 10000 + i, NULL, NULL); // each expiring on its own
+        PARCBitVector *expectedReturnVector;
+        athenaPIT_AddInterest(athena->athenaPIT, interest, ingressVector, &expectedReturnVector);
+        ccnxInterest_Release(&interest);
+        ccnxName_Release(&name);
+    }
+    parcBitVector_Release(&ingressVector);
+
+    // Chunk 0 walks no more of the store than it renders
+    CCNxMetaMessage *response = _dumpChunk(athena, AthenaDump_ContentStore, "walk", 0);
+    ccnxMetaMessage_Release(&response);
+    int slot = _findDump(athena, "walk");
+    assertTrue(slot >= 0, "Expected the dump to be kept");
+    assertNotNull(athena->dumps[slot].storeWalk, "Expected the store to be walked");
+    assertTrue(athenaSnapshot_GetSize(athena->dumps[slot].snapshot) == AthenaDumpEntriesPerChunk,
+               "Expected one chunk's worth of entries, got %zu", athenaSnapshot_GetSize(athena->dumps[slot].snapshot));
+
+    // A chunk the walk has not reached is refused
+    response = _dumpChunk(athena, AthenaDump_ContentStore, "walk", 2);
+    ccnxMetaMessage_Release(&response);
+    assertTrue(athenaSnapshot_GetSize(athena->dumps[slot].snapshot) == AthenaDumpEntriesPerChunk,
+               "Expected a chunk out of reach not to advance the walk");
+
+    // The rest is walked between messages
+    assertFalse(athenaInterestControl_ContinueDumps(athena), "Expected a slice to finish the walk");
+    assertTrue(athenaSnapshot_IsComplete(athena->dumps[slot].snapshot), "Expected the snapshot to be complete");
+    assertNull(athena->dumps[slot].storeWalk, "Expected the walk to be stopped");
+    assertNull(athena->dumps[slot].store, "Expected the store to be let go");
+    assertTrue(athenaSnapshot_GetSize(athena->dumps[slot].snapshot) == (2 * AthenaDumpEntriesPerChunk) + 1,
+               "Expected every entry, got %zu", athenaSnapshot_GetSize(athena->dumps[slot].snapshot));
+
+    response = _dumpChunk(athena, AthenaDump_ContentStore, "walk", 1);
+    ccnxMetaMessage_Release(&response);
+    response = _dumpChunk(athena, AthenaDump_ContentStore, "walk", 2);
+    ccnxMetaMessage_Release(&response);
+    assertTrue(_findDump(athena, "walk") < 0, "Expected the snapshot to be released after its last chunk");
+
+    // A PIT dump left part way through is stopped when the forwarder is released
+    response = _dumpChunk(athena, AthenaDump_PIT, "pit", 0);
+    ccnxMetaMessage_Release(&response);
+    slot = _findDump(athena, "pit");
+    assertTrue(slot >= 0, "Expected the dump to be kept");
+    assertNotNull(athena->dumps[slot].pitWalk, "Expected the PIT to be walked");
+    assertFalse(athenaSnapshot_IsComplete(athena->dumps[slot].snapshot), "Expected the PIT snapshot to be incomplete");
+
+    athena_Release(&athena);
+}
+
 LONGBOW_TEST_CASE(Global, athenaInterestControl_Stats)
 {
     Athena *athena = athena_Create(0);
@@ -446,7 +645,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Stats)
 
     athena_EncodeMessage(interest);
 
-    CCNxMetaMessage *response = _Control_Command(athena, interest);
+    CCNxMetaMessage *response = _Control_Command(athena, interest, NULL);
     assertNotNull(response, "Stats command failed");
 
     ccnxMetaMessage_Release(&interest);
@@ -469,7 +668,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Spawn)
 
     athena_EncodeMessage(interest);
 
-    CCNxMetaMessage *response = _Control_Command(athena, interest);
+    CCNxMetaMessage *response = _Control_Command(athena, interest, NULL);
     assertNotNull(response, "Spawn command failed");
     ccnxMetaMessage_Release(&interest);
     ccnxMetaMessage_Release(&response);
@@ -490,7 +689,7 @@ LONGBOW_TEST_CASE(Global, athenaInterestControl_Spawn)
 
     athena_EncodeMessage(interest);
 
-    response = _Control_Command(athena, interest);
+    response = _Control_Command(athena, interest, NULL);
     assertNotNull(response, "Spawn command failed");
     ccnxMetaMessage_Release(&interest);
     ccnxMetaMessage_Release(&response);
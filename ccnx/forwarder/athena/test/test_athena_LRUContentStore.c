@@ -46,6 +46,8 @@
 #include <parc/testing/parc_ObjectTesting.h>
 
 #include <ccnx/common/ccnx_NameSegmentNumber.h>
+#include <ccnx/common/validation/ccnxValidation_CRC32C.h>
+#include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
 
 
 static AthenaLRUContentStore *
@@ -53,6 +55,10 @@ _createLRUContentStore()
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
 
     return _athenaLRUContentStore_Create(&config);
 }
@@ -192,12 +198,14 @@ _createContentObject(char *lci, uint64_t chunkNum, PARCBuffer *payload)
 
 LONGBOW_TEST_CASE(Local, _athenaLRUContentStoreEntry_CreateRelease)
 {
+    AthenaNamePool *namePool = athenaNamePool_Create();
     CCNxContentObject *contentObject = _createContentObject("lci:/boose/roo/pie", 0, NULL);
-    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(contentObject);
+    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(namePool, contentObject);
 
     _athenaLRUContentStoreEntry_Release(&entry);
 
     ccnxContentObject_Release(&contentObject);
+    athenaNamePool_Release(&namePool);
 }
 
 LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_PutLRUContentStoreEntry)
@@ -209,7 +217,7 @@ LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_PutLRUContentStoreEntry)
     CCNxContentObject *contentObject = _createContentObject("lci:/boose/roo/pie", 10, NULL);
 
     parcBuffer_Release(&payload);
-    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(contentObject);
+    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject);
     ccnxContentObject_Release(&contentObject);
 
     entry->expiryTime = 10000;
@@ -363,7 +371,7 @@ LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndKeyId)
     CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
 
     parcBuffer_Release(&payload);
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject);
 
     entry1->hasKeyId = false;
     entry1->hasContentObjectHash = false;
@@ -375,7 +383,7 @@ LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndKeyId)
 
     CCNxContentObject *contentObject2 = ccnxContentObject_CreateWithDataPayload(name, NULL);
 
-    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(contentObject2);
+    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject2);
 
     entry2->keyId = parcBuffer_WrapCString("key id buffer");
     entry2->hasKeyId = true;
@@ -415,7 +423,7 @@ LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndObjectHash)
     CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
 
     parcBuffer_Release(&payload);
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject);
 
     entry1->hasKeyId = false;
     entry1->hasContentObjectHash = false;
@@ -427,7 +435,7 @@ LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndObjectHash)
 
     CCNxContentObject *contentObject2 = ccnxContentObject_CreateWithDataPayload(name, NULL);
 
-    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(contentObject2);
+    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject2);
 
     entry2->contentObjectHash = parcBuffer_WrapCString("corned beef");
     entry2->hasContentObjectHash = true;
@@ -457,6 +465,100 @@ LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndObjectHash)
     _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
 }
 
+LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchBatch)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+
+    char *uris[] = { "lci:/boose/roo/pie", "lci:/roo/pie/boose", "lci:/pie/roo/boose/not/stored", "lci:/boose/roo/pie" };
+    size_t count = sizeof(uris) / sizeof(uris[0]);
+    CCNxContentObject *stored[2];
+    const CCNxInterest *interests[count];
+
+    for (size_t i = 0; i < count; i++) {
+        CCNxName *name = ccnxName_CreateFromURI(uris[i]);
+        if (i < 2) {
+            PARCBuffer *payload = parcBuffer_Allocate(500);
+            stored[i] = ccnxContentObject_CreateWithDataPayload(name, payload);
+            assertTrue(_athenaLRUContentStore_PutContentObject(impl, stored[i]), "Expected to store %s", uris[i]);
+            parcBuffer_Release(&payload);
+        }
+        interests[i] = ccnxInterest_CreateSimple(name);
+        ccnxName_Release(&name);
+    }
+
+    CCNxContentObject *results[count];
+    bool needsRefresh[count];
+    _athenaLRUContentStore_GetMatchBatch((AthenaContentStoreImplementation *) impl, interests, count, results, needsRefresh);
+    assertTrue(results[0] == stored[0], "Expected to match the first content object");
+    assertTrue(results[1] == stored[1], "Expected to match the second content object");
+    assertNull(results[2], "Expected a NULL response from an unmatchable name");
+    assertTrue(results[3] == stored[0], "Expected a repeated interest to match again");
+    assertTrue(impl->stats.numMatchHits == 3, "Expected 3 store hits");
+
+    for (size_t i = 0; i < count; i++) {
+        if (results[i] != NULL) {
+            ccnxContentObject_Release(&results[i]);
+        }
+        ccnxInterest_Release((CCNxInterest **) &interests[i]);
+    }
+    ccnxContentObject_Release(&stored[0]);
+    ccnxContentObject_Release(&stored[1]);
+
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, _athenaLRUContentStore_GetMatchBatchStale)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+    uint64_t now = parcClock_GetTime(impl->wallClock);
+
+    CCNxName *staleName = ccnxName_CreateFromURI("lci:/stale/entry");
+    CCNxName *otherName = ccnxName_CreateFromURI("lci:/other/entry");
+    CCNxContentObject *staleObject = ccnxContentObject_CreateWithDataPayload(staleName, NULL);
+    CCNxContentObject *otherObject = ccnxContentObject_CreateWithDataPayload(otherName, NULL);
+    ccnxContentObject_SetExpiryTime(staleObject, now + 10000);
+    ccnxContentObject_SetExpiryTime(otherObject, now + 10000);
+    _athenaLRUContentStore_PutContentObject(impl, otherObject);
+    _athenaLRUContentStore_PutContentObject(impl, staleObject);
+
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/stale");
+    assertTrue(_athenaLRUContentStore_SetStaleWindow(impl, prefix, 1000), "Expected the stale window to be set");
+
+    // Expire both entries, only the one under the prefix may be served
+    impl->lruHead->expiryTime = now - 100;
+    impl->lruHead->prev->expiryTime = now - 100;
+
+    const CCNxInterest *interests[] = {
+        ccnxInterest_CreateSimple(staleName), ccnxInterest_CreateSimple(otherName), ccnxInterest_CreateSimple(staleName)
+    };
+    size_t count = sizeof(interests) / sizeof(interests[0]);
+    CCNxContentObject *results[count];
+    bool needsRefresh[count];
+    _athenaLRUContentStore_GetMatchBatch((AthenaContentStoreImplementation *) impl, interests, count, results, needsRefresh);
+
+    assertTrue(results[0] == staleObject, "Expected the stale entry to be served");
+    assertTrue(needsRefresh[0], "Expected the first stale match to ask for a refresh");
+    assertNull(results[1], "Expected no match outside a stale window");
+    assertFalse(needsRefresh[1], "Expected no refresh for a miss");
+    assertTrue(results[2] == staleObject, "Expected the stale entry to be served again");
+    assertFalse(needsRefresh[2], "Expected a single refresh");
+    assertTrue(impl->stats.numStaleHits == 2, "Expected stale hits to be counted");
+    assertTrue(impl->numEntries == 1, "Expected the stale entry to be kept");
+
+    for (size_t i = 0; i < count; i++) {
+        if (results[i] != NULL) {
+            ccnxContentObject_Release(&results[i]);
+        }
+        ccnxInterest_Release((CCNxInterest **) &interests[i]);
+    }
+    ccnxName_Release(&prefix);
+    ccnxContentObject_Release(&staleObject);
+    ccnxContentObject_Release(&otherObject);
+    ccnxName_Release(&staleName);
+    ccnxName_Release(&otherName);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
 LONGBOW_TEST_CASE(Local, _moveContentStoreEntryToLRUHead)
 {
     AthenaLRUContentStore *impl = _createLRUContentStore();
@@ -545,6 +647,7 @@ LONGBOW_TEST_CASE(Local, _getLeastUsedFromLRU)
 
 LONGBOW_TEST_CASE(Local, _compareByExpiryTime)
 {
+    AthenaNamePool *namePool = athenaNamePool_Create();
     CCNxName *name1 = ccnxName_CreateFromURI("lci:/first/entry");
     CCNxContentObject *contentObject1 = ccnxContentObject_CreateWithDataPayload(name1, NULL);
 
@@ -558,9 +661,9 @@ LONGBOW_TEST_CASE(Local, _compareByExpiryTime)
     ccnxContentObject_SetExpiryTime(contentObject2, 200);
     // contentObject3 has no expiry time.
 
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject1);
-    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(contentObject2);
-    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(contentObject3);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(namePool, contentObject1);
+    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(namePool, contentObject2);
+    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(namePool, contentObject3);
 
     assertTrue(_compareByExpiryTime(entry1, entry2) == -1, "Expected result -1");
     assertTrue(_compareByExpiryTime(entry2, entry1) == 1, "Expected result 1");
@@ -580,10 +683,12 @@ LONGBOW_TEST_CASE(Local, _compareByExpiryTime)
     ccnxName_Release(&name1);
     ccnxName_Release(&name2);
     ccnxName_Release(&name3);
+    athenaNamePool_Release(&namePool);
 }
 
 LONGBOW_TEST_CASE(Local, _compareByRecommendedCacheTime)
 {
+    AthenaNamePool *namePool = athenaNamePool_Create();
     CCNxName *name1 = ccnxName_CreateFromURI("lci:/first/entry");
     CCNxContentObject *contentObject1 = ccnxContentObject_CreateWithDataPayload(name1, NULL);
 
@@ -594,9 +699,9 @@ LONGBOW_TEST_CASE(Local, _compareByRecommendedCacheTime)
     CCNxContentObject *contentObject3 = ccnxContentObject_CreateWithDataPayload(name3, NULL);
 
 
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject1);
-    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(contentObject2);
-    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(contentObject3);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(namePool, contentObject1);
+    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(namePool, contentObject2);
+    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(namePool, contentObject3);
 
     // There is no interface (yet) for assigning the recommended cache time. So update the store entries directly.
 
@@ -627,6 +732,7 @@ LONGBOW_TEST_CASE(Local, _compareByRecommendedCacheTime)
     ccnxName_Release(&name1);
     ccnxName_Release(&name2);
     ccnxName_Release(&name3);
+    athenaNamePool_Release(&namePool);
 }
 
 LONGBOW_TEST_CASE(Local, putWithExpiryTime)
@@ -648,9 +754,9 @@ LONGBOW_TEST_CASE(Local, putWithExpiryTime)
     ccnxContentObject_SetExpiryTime(contentObject2, now + 100);
     // contentObject3 has no expiry time, so it expires last.
 
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject1);
-    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(contentObject2);
-    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(contentObject3);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject1);
+    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject2);
+    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject3);
 
     bool status = _athenaLRUContentStore_PutContentObject(impl, contentObject1);
     assertTrue(status, "Exepected to insert content");
@@ -707,13 +813,13 @@ LONGBOW_TEST_CASE(Local, putWithExpiryTime_Expired)
 
     // NOTE: These two are considered expired and should NOT be added to the store.
     ccnxContentObject_SetExpiryTime(contentObject1, now);
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject1);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject1);
 
     ccnxContentObject_SetExpiryTime(contentObject2, now - 100);
-    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(contentObject2);
+    _AthenaLRUContentStoreEntry *entry2 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject2);
 
     // NOTE: This one does not have an expiry time, so should be added.
-    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(contentObject3);
+    _AthenaLRUContentStoreEntry *entry3 = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject3);
 
     bool status = _athenaLRUContentStore_PutContentObject(impl, contentObject1);
     assertFalse(status, "Exepected to fail on inserting expired content");
@@ -783,10 +889,762 @@ LONGBOW_TEST_CASE(Local, putContentAndEnforceCapacity)
     _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
 }
 
+LONGBOW_TEST_CASE(Local, setCapacityTrimsStore)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+
+    size_t payloadSize = 100 * 1024;
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+
+    for (int i = 0; i < 8; i++) {
+        CCNxContentObject *content = _createContentObject("lci:/this/is/content", i, payload);
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, content), "Expected to be able to insert content");
+        ccnxContentObject_Release(&content);
+    }
+    assertTrue(impl->numEntries == 8, "Expected 8 entries in the store");
+
+    // Shrink to room for 3 payloads, the least recently used entries should be evicted
+    athenaLRUContentStore_SetCapacityInBytes(impl, 3 * (payloadSize + 64));
+    assertTrue(impl->currentSizeInBytes <= impl->maxSizeInBytes, "Expected the store to be trimmed to its new capacity");
+    assertTrue(impl->numEntries == 3, "Expected 3 entries to remain, got %" PRIu64, impl->numEntries);
+
+    AthenaLRUContentStoreStats stats;
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numRemovedByLRU == 5, "Expected 5 LRU removals, got %" PRIu64, stats.numRemovedByLRU);
+    assertTrue(stats.sizeInBytes == impl->currentSizeInBytes, "Expected stats to report the current size");
+
+    parcBuffer_Release(&payload);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+/**
+ * Create a content object with an encoded wire format, as received content would have.
+ */
+static CCNxContentObject *
+_createEncodedContentObject(char *lci, uint64_t chunkNum, PARCBuffer *payload)
+{
+    CCNxContentObject *result = _createContentObject(lci, chunkNum, payload);
+
+    PARCSigner *signer = ccnxValidationCRC32C_CreateSigner();
+    CCNxCodecNetworkBufferIoVec *iovec = ccnxCodecTlvPacket_DictionaryEncode(result, signer);
+    assertTrue(ccnxWireFormatMessage_PutIoVec(result, iovec), "ccnxWireFormatMessage_PutIoVec failed");
+    ccnxCodecNetworkBufferIoVec_Release(&iovec);
+    parcSigner_Release(&signer);
+
+    return result;
+}
+
+static AthenaLRUContentStore *
+_createColdSegmentContentStore(size_t capacityInBytes)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 50;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+    athenaLRUContentStore_SetCapacityInBytes(impl, capacityInBytes);
+    return impl;
+}
+
+LONGBOW_TEST_CASE(Local, coldSegmentCompressesEvictedContent)
+{
+    AthenaLRUContentStore *impl = _createColdSegmentContentStore(64 * 1024);
+
+    size_t payloadSize = 8 * 1024;
+    const char *text = "{ \"sensor\": \"temperature\", \"units\": \"celsius\", \"reading\": 21 }\n";
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+    for (size_t i = 0; i < payloadSize; i++) {
+        parcBuffer_PutUint8(payload, text[i % strlen(text)]);
+    }
+    parcBuffer_Flip(payload);
+
+    CCNxContentObject *first = _createEncodedContentObject("lci:/cold/segment", 0, payload);
+    assertTrue(_athenaLRUContentStore_PutContentObject(impl, first), "Expected to be able to insert content");
+    for (int i = 1; i < 12; i++) {
+        CCNxContentObject *content = _createEncodedContentObject("lci:/cold/segment", i, payload);
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, content), "Expected to be able to insert content");
+        ccnxContentObject_Release(&content);
+    }
+
+    // More content than fits uncompressed, but everything is still held
+    AthenaLRUContentStoreStats stats;
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numEntries == 12, "Expected all 12 entries to be held, got %" PRIu64, stats.numEntries);
+    assertTrue(stats.numCompressed > 0, "Expected evicted entries to be compressed");
+    assertTrue(stats.numColdEntries == stats.numCompressed, "Expected each compressed entry to be in the cold segment");
+    assertTrue(stats.numRemovedByLRU == 0, "Expected no entries to be discarded");
+    assertTrue(stats.bytesAfterCompression < stats.bytesBeforeCompression, "Expected compressed entries to be smaller");
+    assertTrue(stats.coldSizeInBytes <= stats.coldCapacityInBytes, "Expected the cold segment to be within its capacity");
+    assertTrue(stats.sizeInBytes <= stats.capacityInBytes, "Expected the store to be within its capacity");
+
+    // The first entry is the oldest, so it is compressed. Matching it restores the original content.
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(first));
+    CCNxContentObject *match = _athenaLRUContentStore_GetMatch(impl, interest);
+    assertNotNull(match, "Expected to match the compressed content");
+    assertTrue(ccnxName_Equals(ccnxContentObject_GetName(match), ccnxContentObject_GetName(first)), "Expected the names to match");
+    assertTrue(parcBuffer_Equals(ccnxContentObject_GetPayload(match), payload), "Expected the restored payload to match");
+    assertTrue(impl->lruHead->contentObject == match, "Expected the restored entry to be at the head of the LRU");
+
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numDecompressed == 1, "Expected one entry to be decompressed");
+    assertTrue(stats.numMatchHits == 1, "Expected a hit");
+    assertTrue(stats.sizeInBytes <= stats.capacityInBytes, "Expected the store to be within its capacity");
+
+    ccnxInterest_Release(&interest);
+    ccnxContentObject_Release(&first);
+    parcBuffer_Release(&payload);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, coldSegmentRestoresStaleContent)
+{
+    AthenaLRUContentStore *impl = _createColdSegmentContentStore(64 * 1024);
+    uint64_t now = parcClock_GetTime(impl->wallClock);
+
+    size_t payloadSize = 8 * 1024;
+    const char *text = "{ \"sensor\": \"temperature\", \"units\": \"celsius\", \"reading\": 21 }\n";
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+    for (size_t i = 0; i < payloadSize; i++) {
+        parcBuffer_PutUint8(payload, text[i % strlen(text)]);
+    }
+    parcBuffer_Flip(payload);
+
+    CCNxContentObject *first = _createEncodedContentObject("lci:/cold/stale", 0, payload);
+    ccnxContentObject_SetExpiryTime(first, now + 10000);
+    assertTrue(_athenaLRUContentStore_PutContentObject(impl, first), "Expected to be able to insert content");
+    for (int i = 1; i < 12; i++) {
+        CCNxContentObject *content = _createEncodedContentObject("lci:/cold/segment", i, payload);
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, content), "Expected to be able to insert content");
+        ccnxContentObject_Release(&content);
+    }
+
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/cold/stale");
+    assertTrue(_athenaLRUContentStore_SetStaleWindow(impl, prefix, 1000), "Expected the stale window to be set");
+
+    // The first entry is the oldest, so it is compressed, and only servable because of its stale window
+    _AthenaLRUContentStoreEntry *entry = impl->coldTail;
+    assertNotNull(entry, "Expected an entry in the cold segment");
+    assertTrue(entry->hasExpiryTime, "Expected the compressed entry to be the one that expires");
+    entry->expiryTime = now - 100;
+
+    // Making room for it must neither purge it as expired nor evict it
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(first));
+    bool needsRefresh = false;
+    CCNxContentObject *match = _athenaLRUContentStore_GetMatchOrStale(impl, interest, &needsRefresh);
+    assertNotNull(match, "Expected the stale compressed entry to be served");
+    assertTrue(needsRefresh, "Expected a refresh to be asked for");
+    assertTrue(parcBuffer_Equals(ccnxContentObject_GetPayload(match), payload), "Expected the restored payload to match");
+    assertTrue(impl->lruHead->contentObject == match, "Expected the restored entry to be at the head of the LRU");
+    assertTrue(impl->stats.numDecompressed == 1, "Expected one entry to be decompressed");
+    assertTrue(impl->stats.numRemovedByExpiration == 0, "Expected nothing to be removed as expired");
+
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&prefix);
+    ccnxContentObject_Release(&first);
+    parcBuffer_Release(&payload);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, coldSegmentSkipsIncompressibleContent)
+{
+    AthenaLRUContentStore *impl = _createColdSegmentContentStore(64 * 1024);
+
+    size_t payloadSize = 8 * 1024;
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+    srandom(1);
+    for (size_t i = 0; i < payloadSize; i++) {
+        parcBuffer_PutUint8(payload, (uint8_t) random());
+    }
+    parcBuffer_Flip(payload);
+
+    for (int i = 0; i < 12; i++) {
+        CCNxContentObject *content = _createEncodedContentObject("lci:/cold/random", i, payload);
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, content), "Expected to be able to insert content");
+        ccnxContentObject_Release(&content);
+    }
+
+    AthenaLRUContentStoreStats stats;
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numCompressed == 0, "Expected random payloads not to be compressed");
+    assertTrue(stats.numIncompressible == stats.numRemovedByLRU, "Expected every eviction to be found incompressible");
+    assertTrue(stats.numEntries < 12, "Expected entries to be discarded");
+    assertTrue(stats.coldSizeInBytes == 0, "Expected the cold segment to be empty");
+
+    parcBuffer_Release(&payload);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+static PARCBuffer *
+_createChunkPayload(size_t payloadSize, uint64_t chunkNum)
+{
+    PARCBuffer *result = parcBuffer_Allocate(payloadSize);
+    for (size_t i = 0; i < payloadSize; i++) {
+        parcBuffer_PutUint8(result, (uint8_t) ((i * 31) + chunkNum));
+    }
+    return parcBuffer_Flip(result);
+}
+
+LONGBOW_TEST_CASE(Local, dedupSharesIdenticalPayloads)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = true;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    // Two versions publishing the same four chunks
+    size_t payloadSize = 8 * 1024;
+    for (uint64_t chunk = 0; chunk < 4; chunk++) {
+        PARCBuffer *payload = _createChunkPayload(payloadSize, chunk);
+        CCNxContentObject *v1 = _createEncodedContentObject("lci:/firmware/v1", chunk, payload);
+        CCNxContentObject *v2 = _createEncodedContentObject("lci:/firmware/v2", chunk, payload);
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, v1), "Expected to be able to insert content");
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, v2), "Expected to be able to insert content");
+        ccnxContentObject_Release(&v1);
+        ccnxContentObject_Release(&v2);
+        parcBuffer_Release(&payload);
+    }
+
+    AthenaLRUContentStoreStats stats;
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numEntries == 8, "Expected 8 entries, got %" PRIu64, stats.numEntries);
+    assertTrue(stats.numSharedPayloads == 4, "Expected 4 distinct payloads, got %" PRIu64, stats.numSharedPayloads);
+    assertTrue(stats.numDeduplicatedEntries == 4, "Expected 4 entries sharing a payload, got %" PRIu64, stats.numDeduplicatedEntries);
+    assertTrue(stats.sharedPayloadSizeInBytes == 4 * payloadSize, "Expected each payload to be charged once");
+    assertTrue(stats.sizeInBytes < 5 * payloadSize, "Expected the shared bytes to be charged once, size is %zu", stats.sizeInBytes);
+
+    // A second version entry is reassembled with the shared payload
+    PARCBuffer *expected = _createChunkPayload(payloadSize, 1);
+    CCNxContentObject *v2Chunk1 = _createContentObject("lci:/firmware/v2", 1, NULL);
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(v2Chunk1));
+    CCNxContentObject *match = _athenaLRUContentStore_GetMatch(impl, interest);
+    assertNotNull(match, "Expected to match the deduplicated entry");
+    assertTrue(ccnxName_Equals(ccnxContentObject_GetName(match), ccnxContentObject_GetName(v2Chunk1)), "Expected the names to match");
+    assertTrue(parcBuffer_Equals(ccnxContentObject_GetPayload(match), expected), "Expected the payload to match");
+
+    // Removing the entry that first held the payload leaves it for the entry sharing it
+    CCNxContentObject *v1Chunk1 = _createContentObject("lci:/firmware/v1", 1, NULL);
+    assertTrue(_athenaLRUContentStore_RemoveMatch(impl, ccnxContentObject_GetName(v1Chunk1), NULL, NULL), "Expected to remove the first version");
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numSharedPayloads == 4, "Expected the payload to still be held");
+
+    // and no longer keeps the removed entry's wire format alive
+    PARCBuffer *key = _createPayloadKey(parcBuffer_HashCode(expected));
+    _AthenaLRUContentStorePayload *sharedPayload = (_AthenaLRUContentStorePayload *) parcHashMap_Get(impl->tableByPayload, key);
+    parcBuffer_Release(&key);
+    assertNotNull(sharedPayload, "Expected to find the shared payload");
+    assertTrue(sharedPayload->isDetached, "Expected the shared payload to be copied out of the removed entry");
+    assertTrue(parcBuffer_Capacity(sharedPayload->payload) == payloadSize, "Expected the shared payload to hold only its own bytes");
+
+    match = _athenaLRUContentStore_GetMatch(impl, interest);
+    assertNotNull(match, "Expected to match the deduplicated entry");
+    assertTrue(parcBuffer_Equals(ccnxContentObject_GetPayload(match), expected), "Expected the payload to match");
+
+    assertTrue(_athenaLRUContentStore_RemoveMatch(impl, ccnxContentObject_GetName(v2Chunk1), NULL, NULL), "Expected to remove the second version");
+    athenaLRUContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numSharedPayloads == 3, "Expected the payload to be released with its last entry");
+    assertTrue(stats.numDeduplicatedEntries == 3, "Expected 3 entries sharing a payload");
+    assertTrue(stats.numEntries == 6, "Expected 6 entries");
+
+    ccnxInterest_Release(&interest);
+    ccnxContentObject_Release(&v1Chunk1);
+    ccnxContentObject_Release(&v2Chunk1);
+    parcBuffer_Release(&expected);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, containsMatchLeavesStore)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+    uint64_t now = parcClock_GetTime(impl->wallClock);
+
+    CCNxName *oldName = ccnxName_CreateFromURI("lci:/contains/old");
+    CCNxName *newName = ccnxName_CreateFromURI("lci:/contains/new");
+    CCNxContentObject *oldObject = ccnxContentObject_CreateWithDataPayload(oldName, NULL);
+    CCNxContentObject *newObject = ccnxContentObject_CreateWithDataPayload(newName, NULL);
+    ccnxContentObject_SetExpiryTime(oldObject, now + 10000);
+    _athenaLRUContentStore_PutContentObject(impl, oldObject);
+    _athenaLRUContentStore_PutContentObject(impl, newObject);
+
+    CCNxInterest *oldInterest = ccnxInterest_CreateSimple(oldName);
+    assertTrue(_athenaLRUContentStore_ContainsMatch(impl, oldInterest), "Expected the old entry to be found");
+    assertTrue(impl->lruTail->contentObject == oldObject, "Expected the old entry to stay at the LRU tail");
+    assertTrue(impl->stats.numMatchHits == 0, "Expected a look not to count as a hit");
+
+    // An expired entry is not reported, and not removed
+    impl->lruTail->expiryTime = now - 100;
+    assertFalse(_athenaLRUContentStore_ContainsMatch(impl, oldInterest), "Expected an expired entry not to be reported");
+    assertTrue(impl->numEntries == 2, "Expected the expired entry to be kept");
+
+    CCNxName *otherName = ccnxName_CreateFromURI("lci:/contains/other");
+    CCNxInterest *otherInterest = ccnxInterest_CreateSimple(otherName);
+    assertFalse(_athenaLRUContentStore_ContainsMatch(impl, otherInterest), "Expected no match");
+
+    ccnxInterest_Release(&otherInterest);
+    ccnxName_Release(&otherName);
+    ccnxInterest_Release(&oldInterest);
+    ccnxContentObject_Release(&oldObject);
+    ccnxContentObject_Release(&newObject);
+    ccnxName_Release(&oldName);
+    ccnxName_Release(&newName);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, sharedNamePool)
+{
+    AthenaNamePool *namePool = athenaNamePool_Create();
+
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = namePool;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    // A name already interned by another table is not interned again
+    CCNxName *name = ccnxName_CreateFromURI("lci:/shared/name");
+    AthenaInternedName *interned = athenaNamePool_Intern(namePool, name);
+    size_t numNames = athenaNamePool_GetNumberOfNames(namePool);
+
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
+    assertTrue(_athenaLRUContentStore_PutContentObject(impl, contentObject), "Expected to be able to insert content");
+    assertTrue(athenaNamePool_GetNumberOfNames(namePool) == numNames, "Expected the store to use the interned name");
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    assertTrue(_athenaLRUContentStore_GetMatch(impl, interest) == contentObject, "Expected to match the content");
+    ccnxInterest_Release(&interest);
+
+    // A name that was never interned is a miss without touching the indexes
+    CCNxName *otherName = ccnxName_CreateFromURI("lci:/shared/other");
+    interest = ccnxInterest_CreateSimple(otherName);
+    assertNull(_athenaLRUContentStore_GetMatch(impl, interest), "Expected no match");
+    assertTrue(athenaNamePool_GetNumberOfNames(namePool) == numNames, "Expected a lookup not to intern the name");
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&otherName);
+
+    // Names are released from the pool along with the last entry referring to them
+    athenaInternedName_Release(&interned);
+    assertTrue(_athenaLRUContentStore_RemoveMatch(impl, name, NULL, NULL), "Expected to remove the content");
+    assertTrue(athenaNamePool_GetNumberOfNames(namePool) == 0, "Expected the pool to be empty");
+
+    ccnxContentObject_Release(&contentObject);
+    ccnxName_Release(&name);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+    athenaNamePool_Release(&namePool);
+}
+
+LONGBOW_TEST_CASE(Local, snapshot)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    CCNxName *name1 = ccnxName_CreateFromURI("lci:/snapshot/one");
+    CCNxName *name2 = ccnxName_CreateFromURI("lci:/snapshot/two");
+    CCNxContentObject *contentObject1 = ccnxContentObject_CreateWithDataPayload(name1, NULL);
+    CCNxContentObject *contentObject2 = ccnxContentObject_CreateWithDataPayload(name2, NULL);
+    _athenaLRUContentStore_PutContentObject(impl, contentObject1);
+    _athenaLRUContentStore_PutContentObject(impl, contentObject2);
+
+    AthenaSnapshot *snapshot = athenaSnapshot_Create("cs", 0);
+    _athenaLRUContentStore_Snapshot(impl, snapshot);
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected a snapshot entry per stored object");
+
+    // The snapshot outlives the entries it was taken from
+    _athenaLRUContentStore_RemoveMatch(impl, name1, NULL, NULL);
+    _athenaLRUContentStore_RemoveMatch(impl, name2, NULL, NULL);
+
+    const _AthenaLRUContentStoreSnapshotEntry *entry = athenaSnapshot_Get(snapshot, 0);
+    CCNxName *snapshotName = athenaInternedName_CreateName(entry->name);
+    assertTrue(ccnxName_Equals(snapshotName, name2), "Expected the most recently used entry first");
+    assertFalse(entry->isCold, "Expected the entry not to be in the cold segment");
+    ccnxName_Release(&snapshotName);
+
+    PARCJSON *json = parcObject_ToJSON(athenaSnapshot_Get(snapshot, 1));
+    assertNotNull(parcJSON_GetValueByName(json, "sizeInBytes"), "Expected the entry to render its size");
+    parcJSON_Release(&json);
+
+    athenaSnapshot_Release(&snapshot);
+    ccnxContentObject_Release(&contentObject1);
+    ccnxContentObject_Release(&contentObject2);
+    ccnxName_Release(&name1);
+    ccnxName_Release(&name2);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+static void
+_putEmptyContent(AthenaLRUContentStore *impl, const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
+    assertTrue(_athenaLRUContentStore_PutContentObject(impl, contentObject), "Expected to store %s", uri);
+    ccnxContentObject_Release(&contentObject);
+    ccnxName_Release(&name);
+}
+
+static void
+_assertSnapshotName(const AthenaSnapshot *snapshot, size_t index, const char *uri)
+{
+    const _AthenaLRUContentStoreSnapshotEntry *entry = athenaSnapshot_Get(snapshot, index);
+    CCNxName *snapshotName = athenaInternedName_CreateName(entry->name);
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    assertTrue(ccnxName_Equals(snapshotName, name), "Expected %s at entry %zu", uri, index);
+    ccnxName_Release(&name);
+    ccnxName_Release(&snapshotName);
+}
+
+LONGBOW_TEST_CASE(Local, snapshotWalk)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    _putEmptyContent(impl, "lci:/walk/one");
+    _putEmptyContent(impl, "lci:/walk/two");
+    _putEmptyContent(impl, "lci:/walk/three");
+    _putEmptyContent(impl, "lci:/walk/four");
+
+    AthenaSnapshot *snapshot = athenaSnapshot_CreatePartial("cs", 0);
+    AthenaContentStoreWalk *walk = _athenaLRUContentStore_StartSnapshot(impl);
+    assertTrue(_athenaLRUContentStore_ContinueSnapshot(impl, walk, snapshot, 1), "Expected the walk to stop after one entry");
+
+    // A match reorders the LRU, but not the walk
+    CCNxName *name = ccnxName_CreateFromURI("lci:/walk/three");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    assertNotNull(_athenaLRUContentStore_GetMatch(impl, interest), "Expected a match");
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    // Removing the entry the walk visits next, and the one it stops at, moves the walk past them
+    name = ccnxName_CreateFromURI("lci:/walk/two");
+    assertTrue(_athenaLRUContentStore_RemoveMatch(impl, name, NULL, NULL), "Expected to remove the content");
+    ccnxName_Release(&name);
+    name = ccnxName_CreateFromURI("lci:/walk/four");
+    assertTrue(_athenaLRUContentStore_RemoveMatch(impl, name, NULL, NULL), "Expected to remove the content");
+    ccnxName_Release(&name);
+
+    // Content added after the walk started is not reported
+    _putEmptyContent(impl, "lci:/walk/five");
+
+    assertFalse(_athenaLRUContentStore_ContinueSnapshot(impl, walk, snapshot, 10), "Expected the walk to be through the store");
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected 2 entries, got %zu", athenaSnapshot_GetSize(snapshot));
+    _assertSnapshotName(snapshot, 0, "lci:/walk/one");
+    _assertSnapshotName(snapshot, 1, "lci:/walk/three");
+
+    _athenaLRUContentStore_StopSnapshot(impl, &walk);
+    assertNull(walk, "Expected stop to clear the pointer");
+    assertNull(impl->walks, "Expected no walks in progress");
+
+    athenaSnapshot_Release(&snapshot);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, purgePrefix)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    char *uris[] = { "lci:/a/b", "lci:/a/b/1", "lci:/a/b/2", "lci:/a/b/3/x", "lci:/a/c", "lci:/x" };
+    size_t numURIs = sizeof(uris) / sizeof(uris[0]);
+    for (size_t i = 0; i < numURIs; i++) {
+        CCNxName *name = ccnxName_CreateFromURI(uris[i]);
+        PARCBuffer *payload = parcBuffer_Allocate(100);
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+        assertTrue(_athenaLRUContentStore_PutContentObject(impl, contentObject), "Expected to store %s", uris[i]);
+        ccnxContentObject_Release(&contentObject);
+        parcBuffer_Release(&payload);
+        ccnxName_Release(&name);
+    }
+    size_t sizeBeforePurge = impl->currentSizeInBytes;
+
+    // Purge in slices of at most three entries
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/a/b");
+    size_t bytesFreed = 0;
+    size_t totalBytesFreed = 0;
+    size_t numPurged = _athenaLRUContentStore_PurgePrefix(impl, prefix, 3, &bytesFreed);
+    assertTrue(numPurged == 3, "Expected a full slice, got %zu", numPurged);
+    totalBytesFreed += bytesFreed;
+
+    numPurged = _athenaLRUContentStore_PurgePrefix(impl, prefix, 3, &bytesFreed);
+    assertTrue(numPurged == 1, "Expected the rest of the prefix, got %zu", numPurged);
+    totalBytesFreed += bytesFreed;
+
+    numPurged = _athenaLRUContentStore_PurgePrefix(impl, prefix, 3, &bytesFreed);
+    assertTrue(numPurged == 0, "Expected nothing left under the prefix, got %zu", numPurged);
+    assertTrue(bytesFreed == 0, "Expected no bytes freed by an empty purge");
+
+    assertTrue(totalBytesFreed == sizeBeforePurge - impl->currentSizeInBytes, "Expected the freed bytes to be reported");
+    assertTrue(impl->numEntries == 2, "Expected the entries outside the prefix to remain");
+    assertTrue(impl->stats.numRemovedByPurge == 4, "Expected purged entries to be counted");
+
+    // Only the nodes leading to /a/c and /x remain in the index
+    assertTrue(parcHashMap_Size(impl->tableByPrefix) == 4, "Expected empty prefix nodes to be removed");
+
+    CCNxName *other = ccnxName_CreateFromURI("lci:/a/c");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(other);
+    assertNotNull(_athenaLRUContentStore_GetMatch(impl, interest), "Expected a match outside the purged prefix");
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&other);
+
+    ccnxName_Release(&prefix);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, staleWhileRevalidate)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+    uint64_t now = parcClock_GetTime(impl->wallClock);
+
+    CCNxName *staleName = ccnxName_CreateFromURI("lci:/stale/entry");
+    CCNxName *otherName = ccnxName_CreateFromURI("lci:/other/entry");
+    CCNxContentObject *staleObject = ccnxContentObject_CreateWithDataPayload(staleName, NULL);
+    CCNxContentObject *otherObject = ccnxContentObject_CreateWithDataPayload(otherName, NULL);
+    ccnxContentObject_SetExpiryTime(staleObject, now + 10000);
+    ccnxContentObject_SetExpiryTime(otherObject, now + 10000);
+    _athenaLRUContentStore_PutContentObject(impl, otherObject);
+    _athenaLRUContentStore_PutContentObject(impl, staleObject);
+
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/stale");
+    assertTrue(_athenaLRUContentStore_SetStaleWindow(impl, prefix, 1000), "Expected the stale window to be set");
+
+    // Expire both entries, only the one under the prefix may be served
+    impl->lruHead->expiryTime = now - 100;
+    impl->lruHead->prev->expiryTime = now - 100;
+
+    CCNxInterest *staleInterest = ccnxInterest_CreateSimple(staleName);
+    CCNxInterest *otherInterest = ccnxInterest_CreateSimple(otherName);
+    bool needsRefresh = false;
+
+    assertNull(_athenaLRUContentStore_GetMatchOrStale(impl, otherInterest, &needsRefresh), "Expected no match outside a stale window");
+    assertFalse(needsRefresh, "Expected no refresh for a miss");
+
+    assertNotNull(_athenaLRUContentStore_GetMatchOrStale(impl, staleInterest, &needsRefresh), "Expected the stale entry to be served");
+    assertTrue(needsRefresh, "Expected the first stale match to ask for a refresh");
+    assertNotNull(_athenaLRUContentStore_GetMatchOrStale(impl, staleInterest, &needsRefresh), "Expected the stale entry to be served");
+    assertFalse(needsRefresh, "Expected a single refresh");
+    assertTrue(impl->stats.numStaleHits == 2, "Expected stale hits to be counted");
+
+    // Only a copy we asked to refresh is stored
+    assertFalse(_athenaLRUContentStore_PutRefresh(impl, otherObject), "Expected unsolicited content not to be stored");
+
+    CCNxContentObject *freshObject = ccnxContentObject_CreateWithDataPayload(staleName, NULL);
+    ccnxContentObject_SetExpiryTime(freshObject, now + 10000);
+    assertTrue(_athenaLRUContentStore_PutRefresh(impl, freshObject), "Expected the refreshed copy to be stored");
+    assertNotNull(_athenaLRUContentStore_GetMatchOrStale(impl, staleInterest, &needsRefresh), "Expected the fresh entry to be served");
+    assertFalse(needsRefresh, "Expected no refresh for fresh content");
+    assertTrue(impl->numEntries == 1, "Expected the refreshed copy to replace the stale entry");
+
+    // Past the window the entry is removed as before
+    impl->lruHead->expiryTime = now - 2000;
+    assertNull(_athenaLRUContentStore_GetMatchOrStale(impl, staleInterest, &needsRefresh), "Expected no match past the stale window");
+
+    ccnxContentObject_Release(&freshObject);
+    ccnxInterest_Release(&staleInterest);
+    ccnxInterest_Release(&otherInterest);
+    ccnxName_Release(&prefix);
+    ccnxContentObject_Release(&staleObject);
+    ccnxContentObject_Release(&otherObject);
+    ccnxName_Release(&staleName);
+    ccnxName_Release(&otherName);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, sweepExpired)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+    uint64_t now = parcClock_GetTime(impl->wallClock);
+
+    uint64_t expiryTimes[] = { now + 100, now + 200, now + 100000 };
+    for (size_t i = 0; i < 3; i++) {
+        char uri[64];
+        sprintf(uri, "lci:/sweep/%zu", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
+        ccnxContentObject_SetExpiryTime(contentObject, expiryTimes[i]);
+        _athenaLRUContentStore_PutContentObject(impl, contentObject);
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+
+    // Expire the first two, keeping the order of the expiry index
+    impl->lruHead->prev->expiryTime = now - 100;
+    impl->lruHead->prev->prev->expiryTime = now - 200;
+
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 1) == 1, "Expected a slice of one entry");
+    assertTrue(impl->numEntries == 2, "Expected the earliest expired entry to be removed");
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 10) == 1, "Expected the remaining expired entry to be removed");
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 10) == 0, "Expected unexpired entries to be kept");
+    assertTrue(impl->numEntries == 1, "Expected only the unexpired entry to remain");
+    assertTrue(impl->stats.numRemovedByExpiration == 2, "Expected swept entries to be counted as expirations");
+
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, sweepPastStaleEntries)
+{
+    AthenaLRUContentStore *impl = _createLRUContentStore();
+    uint64_t now = parcClock_GetTime(impl->wallClock);
+
+    // Three entries under a stale window expire ahead of one that can be removed
+    const char *uris[] = { "lci:/stale/1", "lci:/stale/2", "lci:/stale/3", "lci:/gone/1" };
+    for (size_t i = 0; i < 4; i++) {
+        CCNxName *name = ccnxName_CreateFromURI(uris[i]);
+        CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
+        ccnxContentObject_SetExpiryTime(contentObject, now + 100 * (i + 1));
+        _athenaLRUContentStore_PutContentObject(impl, contentObject);
+        ccnxContentObject_Release(&contentObject);
+        ccnxName_Release(&name);
+    }
+
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/stale");
+    assertTrue(_athenaLRUContentStore_SetStaleWindow(impl, prefix, 10000), "Expected the stale window to be set");
+
+    uint64_t offset = 400;
+    for (_AthenaLRUContentStoreEntry *entry = impl->lruHead; entry != NULL; entry = entry->prev) {
+        entry->expiryTime = now - offset;
+        offset += 100;
+    }
+
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 1) == 0, "Expected a slice to move one stale entry aside");
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 2) == 0, "Expected a slice to move the other stale entries aside");
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 1) == 1, "Expected the entry behind the stale entries to be removed");
+    assertTrue(impl->numEntries == 3, "Expected the stale entries to be kept");
+    assertTrue(parcSortedList_Size(impl->listByStaleUntilTime) == 3, "Expected the stale entries to be indexed by window end");
+
+    // Stepped over entries are not examined again until their window ends
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 10) == 0, "Expected nothing to remove within the stale window");
+
+    for (_AthenaLRUContentStoreEntry *entry = impl->lruHead; entry != NULL; entry = entry->prev) {
+        entry->expiryTime = now - 20000;
+        entry->staleUntilTime = now - 10000;
+    }
+    assertTrue(_athenaLRUContentStore_SweepExpired(impl, 10) == 3, "Expected the entries to be removed once their window ends");
+    assertTrue(impl->numEntries == 0, "Expected an empty store");
+
+    ccnxName_Release(&prefix);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, clockHitDoesNotMoveEntry)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_Clock;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    size_t payloadSize = 1024;
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+    CCNxContentObject *oldest = _createContentObject("lci:/clock", 0, payload);
+    CCNxContentObject *middle = _createContentObject("lci:/clock", 1, payload);
+    CCNxContentObject *newest = _createContentObject("lci:/clock", 2, payload);
+    _athenaLRUContentStore_PutContentObject(impl, oldest);
+    _athenaLRUContentStore_PutContentObject(impl, middle);
+    _athenaLRUContentStore_PutContentObject(impl, newest);
+
+    _AthenaLRUContentStoreEntry *tail = impl->lruTail;
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(oldest));
+    assertNotNull(_athenaLRUContentStore_GetMatch(impl, interest), "Expected a match");
+    assertTrue(impl->lruTail == tail, "Expected a hit to leave the eviction list unchanged");
+    assertTrue(tail->referenced, "Expected a hit to mark the entry as referenced");
+
+    // Make room for two entries, the referenced oldest entry gets a second chance
+    athenaLRUContentStore_SetCapacityInBytes(impl, impl->currentSizeInBytes - 1);
+    assertTrue(impl->numEntries == 2, "Expected one entry to be evicted");
+    assertNotNull(_athenaLRUContentStore_GetMatch(impl, interest), "Expected the referenced entry to survive eviction");
+    ccnxInterest_Release(&interest);
+
+    interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(middle));
+    assertNull(_athenaLRUContentStore_GetMatch(impl, interest), "Expected the unreferenced entry to be evicted");
+    ccnxInterest_Release(&interest);
+
+    ccnxContentObject_Release(&oldest);
+    ccnxContentObject_Release(&middle);
+    ccnxContentObject_Release(&newest);
+    parcBuffer_Release(&payload);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+/**
+ * Replay a skewed request trace against a store of the given policy, caching each miss, and return the
+ * number of hits.  The trace is generated deterministically so that both policies see the same requests.
+ */
+static uint64_t
+_replayTrace(AthenaLRUContentStoreEvictionPolicy policy, size_t numNames, size_t numRequests, size_t capacityInEntries)
+{
+    AthenaLRUContentStoreConfig config;
+    config.capacityInMB = 1;
+    config.evictionPolicy = policy;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+    AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
+
+    size_t payloadSize = 1024;
+    PARCBuffer *payload = parcBuffer_Allocate(payloadSize);
+    athenaLRUContentStore_SetCapacityInBytes(impl, capacityInEntries * (payloadSize + 32));
+
+    uint64_t hits = 0;
+    uint32_t random = 12345;
+    for (size_t i = 0; i < numRequests; i++) {
+        random = random * 1103515245 + 12345;
+        uint64_t uniform = (random >> 8) % numNames;
+        uint64_t chunk = (uniform * uniform) / numNames; // skewed towards low chunk numbers
+
+        CCNxContentObject *content = _createContentObject("lci:/t", chunk, payload);
+        CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(content));
+        if (_athenaLRUContentStore_GetMatch(impl, interest) != NULL) {
+            hits++;
+        } else {
+            _athenaLRUContentStore_PutContentObject(impl, content);
+        }
+        ccnxInterest_Release(&interest);
+        ccnxContentObject_Release(&content);
+    }
+
+    parcBuffer_Release(&payload);
+    _athenaLRUContentStore_Release((AthenaContentStoreImplementation *) &impl);
+    return hits;
+}
+
+LONGBOW_TEST_CASE(Local, clockHitRatioParity)
+{
+    uint64_t lruHits = _replayTrace(AthenaLRUContentStoreEvictionPolicy_LRU, 500, 20000, 50);
+    uint64_t clockHits = _replayTrace(AthenaLRUContentStoreEvictionPolicy_Clock, 500, 20000, 50);
+
+    assertTrue(lruHits > 0, "Expected the trace to produce cache hits");
+    assertTrue(clockHits * 100 >= lruHits * 95,
+               "Expected the Clock hit ratio to be within 5%% of LRU (LRU %" PRIu64 ", Clock %" PRIu64 ")", lruHits, clockHits);
+}
+
 LONGBOW_TEST_CASE(Local, putContentAndExpireByExpiryTime)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 1; // 2M
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
 
     AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
 
@@ -800,7 +1658,7 @@ LONGBOW_TEST_CASE(Local, putContentAndExpireByExpiryTime)
     CCNxName *name4 = ccnxName_CreateFromURI("lci:/object/4");
 
     CCNxContentObject *contentObject1 = ccnxContentObject_CreateWithDataPayload(name1, payload);
-    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(contentObject1);
+    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject1);
     entry->hasExpiryTime = true;
     entry->expiryTime = now + 2000000;
     bool status = _athenaLRUContentStore_PutLRUContentStoreEntry(impl, entry);
@@ -808,7 +1666,7 @@ LONGBOW_TEST_CASE(Local, putContentAndExpireByExpiryTime)
     assertTrue(status, "Expected to put the content in the store");
 
     CCNxContentObject *contentObject2 = ccnxContentObject_CreateWithDataPayload(name2, payload);
-    entry = _athenaLRUContentStoreEntry_Create(contentObject2);
+    entry = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject2);
     entry->expiryTime = now - 10000; // This one expires first. (it's already expired)
     entry->hasExpiryTime = true;
     status = _athenaLRUContentStore_PutLRUContentStoreEntry(impl, entry);
@@ -816,7 +1674,7 @@ LONGBOW_TEST_CASE(Local, putContentAndExpireByExpiryTime)
     assertTrue(status, "Expected to put the content in the store");
 
     CCNxContentObject *contentObject3 = ccnxContentObject_CreateWithDataPayload(name3, payload);
-    entry = _athenaLRUContentStoreEntry_Create(contentObject3);
+    entry = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject3);
     entry->expiryTime = now + 3000000;
     entry->hasExpiryTime = true;
     status = _athenaLRUContentStore_PutLRUContentStoreEntry(impl, entry);
@@ -827,7 +1685,7 @@ LONGBOW_TEST_CASE(Local, putContentAndExpireByExpiryTime)
     // with the earliest expiration time to be expired.
 
     CCNxContentObject *contentObject4 = ccnxContentObject_CreateWithDataPayload(name4, payload);
-    entry = _athenaLRUContentStoreEntry_Create(contentObject4);
+    entry = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject4);
     entry->expiryTime = now + 3000000;
     entry->hasExpiryTime = true;
     status = _athenaLRUContentStore_PutLRUContentStoreEntry(impl, entry);
@@ -877,6 +1735,10 @@ LONGBOW_TEST_CASE(Local, putTooBig)
 {
     AthenaLRUContentStoreConfig config;
     config.capacityInMB = 1;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
 
     AthenaLRUContentStore *impl = _athenaLRUContentStore_Create(&config);
 
@@ -904,8 +1766,12 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_Name)
     CCNxName *name1 = ccnxName_CreateFromURI("lci:/name/1");
     CCNxName *name2 = ccnxName_CreateFromURI("lci:/name/2");
 
-    PARCObject *keyObj1 = _createHashableKey(name1, NULL, NULL);
-    PARCObject *keyObj2 = _createHashableKey(name2, NULL, NULL);
+    AthenaNamePool *namePool = athenaNamePool_Create();
+    AthenaInternedName *interned1 = athenaNamePool_Intern(namePool, name1);
+    AthenaInternedName *interned2 = athenaNamePool_Intern(namePool, name2);
+
+    PARCObject *keyObj1 = _createHashableKey(interned1, NULL, NULL);
+    PARCObject *keyObj2 = _createHashableKey(interned2, NULL, NULL);
 
     assertNotNull(keyObj1, "Expected non-null key object");
     assertNotNull(keyObj2, "Expected non-null key object");
@@ -915,6 +1781,9 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_Name)
 
     parcObject_Release((PARCObject **) &keyObj1);
     parcObject_Release((PARCObject **) &keyObj2);
+    athenaInternedName_Release(&interned1);
+    athenaInternedName_Release(&interned2);
+    athenaNamePool_Release(&namePool);
     ccnxName_Release(&name1);
     ccnxName_Release(&name2);
 }
@@ -926,11 +1795,15 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_NameAndKeyId)
     CCNxName *name1 = ccnxName_CreateFromURI("lci:/name/1");
     CCNxName *name2 = ccnxName_CreateFromURI("lci:/name/2");
 
+    AthenaNamePool *namePool = athenaNamePool_Create();
+    AthenaInternedName *interned1 = athenaNamePool_Intern(namePool, name1);
+    AthenaInternedName *interned2 = athenaNamePool_Intern(namePool, name2);
+
     PARCBuffer *keyId1 = parcBuffer_WrapCString("keyId 1");
     PARCBuffer *keyId2 = parcBuffer_WrapCString("keyId 2");
 
-    PARCObject *keyObj1 = _createHashableKey(name1, NULL, NULL);
-    PARCObject *keyObj2 = _createHashableKey(name1, keyId1, NULL);
+    PARCObject *keyObj1 = _createHashableKey(interned1, NULL, NULL);
+    PARCObject *keyObj2 = _createHashableKey(interned1, keyId1, NULL);
 
     assertFalse(parcObject_HashCode(keyObj1) == 0, "Expected non zero hashcode");
     assertFalse(parcObject_HashCode(keyObj2) == 0, "Expected non zero hashcode");
@@ -941,8 +1814,8 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_NameAndKeyId)
 
     // Different KeyIds.
 
-    keyObj1 = _createHashableKey(name1, keyId1, NULL);
-    keyObj2 = _createHashableKey(name1, keyId2, NULL);
+    keyObj1 = _createHashableKey(interned1, keyId1, NULL);
+    keyObj2 = _createHashableKey(interned1, keyId2, NULL);
 
     assertFalse(parcObject_HashCode(keyObj1) == 0, "Expected non zero hashcode");
     assertFalse(parcObject_HashCode(keyObj2) == 0, "Expected non zero hashcode");
@@ -952,6 +1825,9 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_NameAndKeyId)
     parcObject_Release((PARCObject **) &keyObj2);
     parcBuffer_Release(&keyId1);
     parcBuffer_Release(&keyId2);
+    athenaInternedName_Release(&interned1);
+    athenaInternedName_Release(&interned2);
+    athenaNamePool_Release(&namePool);
     ccnxName_Release(&name1);
     ccnxName_Release(&name2);
 }
@@ -963,11 +1839,15 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_NameAndObjectHash)
     CCNxName *name1 = ccnxName_CreateFromURI("lci:/name/1");
     CCNxName *name2 = ccnxName_CreateFromURI("lci:/name/2");
 
+    AthenaNamePool *namePool = athenaNamePool_Create();
+    AthenaInternedName *interned1 = athenaNamePool_Intern(namePool, name1);
+    AthenaInternedName *interned2 = athenaNamePool_Intern(namePool, name2);
+
     PARCBuffer *objHash1 = parcBuffer_WrapCString("hash 1");
     PARCBuffer *objHash2 = parcBuffer_WrapCString("hash 2");
 
-    PARCObject *keyObj1 = _createHashableKey(name1, NULL, objHash1);
-    PARCObject *keyObj2 = _createHashableKey(name1, NULL, NULL);
+    PARCObject *keyObj1 = _createHashableKey(interned1, NULL, objHash1);
+    PARCObject *keyObj2 = _createHashableKey(interned1, NULL, NULL);
 
     assertFalse(parcObject_HashCode(keyObj1) == 0, "Expected non zero hashcode");
     assertFalse(parcObject_HashCode(keyObj2) == 0, "Expected non zero hashcode");
@@ -978,8 +1858,8 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_NameAndObjectHash)
 
     // Different object hashes.
 
-    keyObj1 = _createHashableKey(name1, NULL, objHash1);
-    keyObj2 = _createHashableKey(name1, NULL, objHash2);
+    keyObj1 = _createHashableKey(interned1, NULL, objHash1);
+    keyObj2 = _createHashableKey(interned1, NULL, objHash2);
 
     assertFalse(parcObject_HashCode(keyObj1) == 0, "Expected non zero hashcode");
     assertFalse(parcObject_HashCode(keyObj2) == 0, "Expected non zero hashcode");
@@ -992,23 +1872,28 @@ LONGBOW_TEST_CASE(Loca, _createHashableKey_NameAndObjectHash)
 
     // Now try with
 
+    athenaInternedName_Release(&interned1);
+    athenaInternedName_Release(&interned2);
+    athenaNamePool_Release(&namePool);
     ccnxName_Release(&name1);
     ccnxName_Release(&name2);
 }
 
 LONGBOW_TEST_CASE(Local, _athenaLRUContentStoreEntry_Display)
 {
+    AthenaNamePool *namePool = athenaNamePool_Create();
     CCNxName *name1 = ccnxName_CreateFromURI("lci:/first/entry");
     CCNxContentObject *contentObject1 = ccnxContentObject_CreateWithDataPayload(name1, NULL);
 
     ccnxContentObject_SetExpiryTime(contentObject1, 87654321);
-    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(contentObject1);
+    _AthenaLRUContentStoreEntry *entry1 = _athenaLRUContentStoreEntry_Create(namePool, contentObject1);
 
     _athenaLRUContentStoreEntry_Display(entry1, 4);
 
     _athenaLRUContentStoreEntry_Release(&entry1);
     ccnxContentObject_Release(&contentObject1);
     ccnxName_Release(&name1);
+    athenaNamePool_Release(&namePool);
 }
 
 LONGBOW_TEST_CASE(Local, getMatch_Expired)
@@ -1018,7 +1903,7 @@ LONGBOW_TEST_CASE(Local, getMatch_Expired)
     CCNxName *name = ccnxName_CreateFromURI("lci:/boose/roo/pie");
     CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, NULL);
 
-    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(contentObject);
+    _AthenaLRUContentStoreEntry *entry = _athenaLRUContentStoreEntry_Create(impl->namePool, contentObject);
     ccnxContentObject_Release(&contentObject);
 
     entry->expiryTime = 10000;
@@ -1114,6 +1999,8 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByName);
     LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndKeyId);
     LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_GetMatchByNameAndObjectHash);
+    LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_GetMatchBatch);
+    LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_GetMatchBatchStale);
     LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_RemoveMatch);
     //LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStore_PurgeContentStoreEntry);
     LONGBOW_RUN_TEST_CASE(Local, _athenaLRUContentStoreEntry_Display);
@@ -1130,6 +2017,21 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, putWithExpiryTime_Expired);
 
     LONGBOW_RUN_TEST_CASE(Local, putContentAndEnforceCapacity);
+    LONGBOW_RUN_TEST_CASE(Local, setCapacityTrimsStore);
+    LONGBOW_RUN_TEST_CASE(Local, clockHitDoesNotMoveEntry);
+    LONGBOW_RUN_TEST_CASE(Local, clockHitRatioParity);
+    LONGBOW_RUN_TEST_CASE(Local, coldSegmentCompressesEvictedContent);
+    LONGBOW_RUN_TEST_CASE(Local, coldSegmentRestoresStaleContent);
+    LONGBOW_RUN_TEST_CASE(Local, coldSegmentSkipsIncompressibleContent);
+    LONGBOW_RUN_TEST_CASE(Local, dedupSharesIdenticalPayloads);
+    LONGBOW_RUN_TEST_CASE(Local, containsMatchLeavesStore);
+    LONGBOW_RUN_TEST_CASE(Local, sharedNamePool);
+    LONGBOW_RUN_TEST_CASE(Local, snapshot);
+    LONGBOW_RUN_TEST_CASE(Local, snapshotWalk);
+    LONGBOW_RUN_TEST_CASE(Local, purgePrefix);
+    LONGBOW_RUN_TEST_CASE(Local, staleWhileRevalidate);
+    LONGBOW_RUN_TEST_CASE(Local, sweepExpired);
+    LONGBOW_RUN_TEST_CASE(Local, sweepPastStaleEntries);
     LONGBOW_RUN_TEST_CASE(Local, putTooBig);
     LONGBOW_RUN_TEST_CASE(Local, putContentAndExpireByExpiryTime);
 
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_LogReporterAsync.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+
+typedef struct test_reporter {
+    uint64_t reported;
+    bool blocked;
+} TestReporter;
+
+static PARCLogReporter *
+_testReporter_Acquire(const PARCLogReporter *reporter)
+{
+    return parcObject_Acquire(reporter);
+}
+
+static void
+_testReporter_Release(PARCLogReporter **reporterPtr)
+{
+    parcObject_Release((void **) reporterPtr);
+}
+
+static void
+_testReporter_Report(PARCLogReporter *reporter, const PARCLogEntry *entry)
+{
+    TestReporter *testReporter = parcLogReporter_GetPrivateObject(reporter);
+    while (__atomic_load_n(&testReporter->blocked, __ATOMIC_ACQUIRE)) {
+        usleep(100);
+    }
+    __atomic_add_fetch(&testReporter->reported, 1, __ATOMIC_RELEASE);
+}
+
+LONGBOW_TEST_RUNNER(athena_LogReporterAsync)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_LogReporterAsync)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_LogReporterAsync)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaLogReporterAsync_CreateRelease);
+    LONGBOW_RUN_TEST_CASE(Global, athenaLogReporterAsync_Report);
+    LONGBOW_RUN_TEST_CASE(Global, athenaLogReporterAsync_Dropped);
+    LONGBOW_RUN_TEST_CASE(Global, athenaLogReporterAsync_DisabledLevel);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestReporter *testReporter = parcMemory_AllocateAndClear(sizeof(TestReporter));
+    assertNotNull(testReporter, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestReporter));
+    longBowTestCase_SetClipBoardData(testCase, testReporter);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestReporter *testReporter = longBowTestCase_GetClipBoardData(testCase);
+    parcMemory_Deallocate(&testReporter);
+
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static PARCLog *
+_createLog(TestReporter *testReporter, size_t capacity, PARCLogReporter **asyncReporter)
+{
+    PARCLogReporter *reporter = parcLogReporter_Create(_testReporter_Acquire, _testReporter_Release,
+                                                       _testReporter_Report, testReporter);
+    *asyncReporter = athenaLogReporterAsync_Create(reporter, capacity);
+    assertNotNull(*asyncReporter, "Expected athenaLogReporterAsync_Create to return a non-NULL value");
+    parcLogReporter_Release(&reporter);
+
+    PARCLog *log = parcLog_Create("localhost", "test_athena_LogReporterAsync", NULL, *asyncReporter);
+    parcLog_SetLevel(log, PARCLogLevel_Info);
+    return log;
+}
+
+LONGBOW_TEST_CASE(Global, athenaLogReporterAsync_CreateRelease)
+{
+    TestReporter *testReporter = longBowTestCase_GetClipBoardData(testCase);
+    PARCLogReporter *reporter = parcLogReporter_Create(_testReporter_Acquire, _testReporter_Release,
+                                                       _testReporter_Report, testReporter);
+
+    PARCLogReporter *asyncReporter = athenaLogReporterAsync_Create(reporter, 5);
+    assertNotNull(asyncReporter, "Expected athenaLogReporterAsync_Create to return a non-NULL value");
+    parcLogReporter_Release(&reporter);
+
+    _AthenaLogReporterAsync *queue = parcLogReporter_GetPrivateObject(asyncReporter);
+    assertTrue(queue->capacity == 8, "Expected capacity to be rounded up to 8, got %zu", queue->capacity);
+    assertTrue(athenaLogReporterAsync_GetDroppedCount(asyncReporter) == 0, "Expected no dropped entries");
+
+    parcLogReporter_Release(&asyncReporter);
+    assertNull(asyncReporter, "Expected release to NULL the reporter reference");
+}
+
+LONGBOW_TEST_CASE(Global, athenaLogReporterAsync_Report)
+{
+    TestReporter *testReporter = longBowTestCase_GetClipBoardData(testCase);
+    PARCLogReporter *asyncReporter;
+    PARCLog *log = _createLog(testReporter, 64, &asyncReporter);
+
+    for (int i = 0; i < 10; i++) {
+        parcLog_Info(log, "entry %d", i);
+    }
+    athenaLogReporterAsync_Flush(asyncReporter);
+
+    assertTrue(testReporter->reported == 10, "Expected 10 reported entries, got %" PRIu64, testReporter->reported);
+    assertTrue(athenaLogReporterAsync_GetWrittenCount(asyncReporter) == 10, "Expected 10 written entries");
+    assertTrue(athenaLogReporterAsync_GetDroppedCount(asyncReporter) == 0, "Expected no dropped entries");
+
+    parcLog_Release(&log);
+    parcLogReporter_Release(&asyncReporter);
+}
+
+LONGBOW_TEST_CASE(Global, athenaLogReporterAsync_Dropped)
+{
+    TestReporter *testReporter = longBowTestCase_GetClipBoardData(testCase);
+    PARCLogReporter *asyncReporter;
+    PARCLog *log = _createLog(testReporter, 2, &asyncReporter);
+
+    // Stall the writer so the ring fills, logging must not block
+    testReporter->blocked = true;
+    for (int i = 0; i < 10; i++) {
+        parcLog_Info(log, "entry %d", i);
+    }
+    uint64_t dropped = athenaLogReporterAsync_GetDroppedCount(asyncReporter);
+    assertTrue(dropped >= 7, "Expected at least 7 dropped entries, got %" PRIu64, dropped);
+
+    __atomic_store_n(&testReporter->blocked, false, __ATOMIC_RELEASE);
+    athenaLogReporterAsync_Flush(asyncReporter);
+
+    assertTrue((testReporter->reported + dropped) == 10,
+               "Expected reported (%" PRIu64 ") + dropped (%" PRIu64 ") to be 10", testReporter->reported, dropped);
+
+    parcLog_Release(&log);
+    parcLogReporter_Release(&asyncReporter);
+}
+
+LONGBOW_TEST_CASE(Global, athenaLogReporterAsync_DisabledLevel)
+{
+    TestReporter *testReporter = longBowTestCase_GetClipBoardData(testCase);
+    PARCLogReporter *asyncReporter;
+    PARCLog *log = _createLog(testReporter, 16, &asyncReporter);
+
+    assertFalse(parcLog_IsLoggable(log, PARCLogLevel_Debug), "Expected debug to be disabled at the Info level");
+    parcLog_Debug(log, "not reported");
+    athenaLogReporterAsync_Flush(asyncReporter);
+    assertTrue(testReporter->reported == 0, "Expected no reported entries");
+
+    parcLog_Release(&log);
+    parcLogReporter_Release(&asyncReporter);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_LogReporterAsync);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
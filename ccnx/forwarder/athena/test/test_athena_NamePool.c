@@ -0,0 +1,486 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_NamePool.c"
+
+#include <parc/algol/parc_HashMap.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+LONGBOW_TEST_RUNNER(athena_NamePool)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_NamePool)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_NamePool)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_Create);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_InternSharesPrefixes);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_Lookup);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_LookupLongestPrefix);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_Batch);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_ReleaseRemovesNames);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_Grow);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNamePool_Concurrent);
+    LONGBOW_RUN_TEST_CASE(Global, athenaInternedName_CreateName);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNameKey_Equals);
+    LONGBOW_RUN_TEST_CASE(Global, athenaNameKey_CreateScratch);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_Create)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+    assertNotNull(pool, "Could not create a name pool");
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 0, "Expected an empty pool");
+    assertTrue(athenaNamePool_GetSizeInBytes(pool) == 0, "Expected an empty pool to hold no names");
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_InternSharesPrefixes)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name1 = ccnxName_CreateFromURI("lci:/foo/bar/chunk1");
+    CCNxName *name2 = ccnxName_CreateFromURI("lci:/foo/bar/chunk2");
+    CCNxName *name3 = ccnxName_CreateFromURI("lci:/foo/bar/chunk1");
+
+    AthenaInternedName *interned1 = athenaNamePool_Intern(pool, name1);
+    AthenaInternedName *interned2 = athenaNamePool_Intern(pool, name2);
+    AthenaInternedName *interned3 = athenaNamePool_Intern(pool, name3);
+
+    assertTrue(interned1 == interned3, "Expected equal names to intern to the same pointer");
+    assertTrue(interned1 != interned2, "Expected different names to intern to different pointers");
+    assertTrue(athenaInternedName_GetPrefix(interned1) == athenaInternedName_GetPrefix(interned2),
+               "Expected names with a common prefix to share it");
+    assertTrue(athenaInternedName_GetSegmentCount(interned1) == 3, "Expected 3 segments");
+
+    // /foo, /foo/bar, /foo/bar/chunk1 and /foo/bar/chunk2
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 4, "Expected 4 names, got %zu", athenaNamePool_GetNumberOfNames(pool));
+
+    athenaInternedName_Release(&interned1);
+    athenaInternedName_Release(&interned2);
+    athenaInternedName_Release(&interned3);
+    ccnxName_Release(&name1);
+    ccnxName_Release(&name2);
+    ccnxName_Release(&name3);
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_Lookup)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/foo");
+    CCNxName *other = ccnxName_CreateFromURI("lci:/foo/baz");
+
+    AthenaInternedName *interned = athenaNamePool_Intern(pool, name);
+
+    AthenaInternedName *found = athenaNamePool_Lookup(pool, name);
+    assertTrue(found == interned, "Expected lookup to find the interned name");
+    athenaInternedName_Release(&found);
+
+    found = athenaNamePool_Lookup(pool, prefix);
+    assertTrue(found == athenaInternedName_GetPrefix(interned), "Expected lookup to find the interned prefix");
+    athenaInternedName_Release(&found);
+
+    found = athenaNamePool_Lookup(pool, other);
+    assertNull(found, "Expected lookup of a name that was not interned to fail");
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 2, "Expected lookup not to add names");
+
+    athenaInternedName_Release(&interned);
+    ccnxName_Release(&name);
+    ccnxName_Release(&prefix);
+    ccnxName_Release(&other);
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_LookupLongestPrefix)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxName *longer = ccnxName_CreateFromURI("lci:/foo/bar/baz/chunk");
+    CCNxName *unrelated = ccnxName_CreateFromURI("lci:/other");
+
+    AthenaInternedName *interned = athenaNamePool_Intern(pool, name);
+
+    AthenaInternedName *found = athenaNamePool_LookupLongestPrefix(pool, longer);
+    assertTrue(found == interned, "Expected the longest interned prefix");
+    athenaInternedName_Release(&found);
+
+    found = athenaNamePool_LookupLongestPrefix(pool, unrelated);
+    assertNotNull(found, "Expected the empty name");
+    assertTrue(athenaInternedName_GetSegmentCount(found) == 0, "Expected the empty name");
+    assertNull(athenaInternedName_GetPrefix(found), "Expected the empty name to have no prefix");
+    athenaInternedName_Release(&found);
+
+    athenaInternedName_Release(&interned);
+    ccnxName_Release(&name);
+    ccnxName_Release(&longer);
+    ccnxName_Release(&unrelated);
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_Batch)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    // More names than a group, of different lengths, with one repeated and some sharing prefixes
+    const size_t count = AthenaNamePoolBatchSize + 5;
+    CCNxName *names[count];
+    for (size_t i = 0; i < count; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/batch/%zu/seg%zu", i % 3, i);
+        if (i % 4 == 0) {
+            snprintf(uri, sizeof(uri), "lci:/batch/%zu", i);
+        }
+        names[i] = ccnxName_CreateFromURI(uri);
+    }
+    ccnxName_Release(&names[count - 1]);
+    names[count - 1] = ccnxName_Acquire(names[1]);
+
+    AthenaInternedName *interned[count];
+    athenaNamePool_InternBatch(pool, (const CCNxName **) names, count, interned);
+    for (size_t i = 0; i < count; i++) {
+        AthenaInternedName *one = athenaNamePool_Lookup(pool, names[i]);
+        assertTrue(one == interned[i], "Expected the batch to intern name %zu as athenaNamePool_Intern would", i);
+        athenaInternedName_Release(&one);
+    }
+    assertTrue(interned[count - 1] == interned[1], "Expected a repeated name to be interned once");
+
+    AthenaInternedName *found[count];
+    athenaNamePool_LookupBatch(pool, (const CCNxName **) names, count, found);
+    for (size_t i = 0; i < count; i++) {
+        assertTrue(found[i] == interned[i], "Expected the batch to find name %zu", i);
+        athenaInternedName_Release(&found[i]);
+    }
+
+    // Names longer than, and unrelated to, those interned
+    CCNxName *others[3];
+    others[0] = ccnxName_CreateFromURI("lci:/batch/1/seg1/chunk");
+    others[1] = ccnxName_CreateFromURI("lci:/other");
+    others[2] = ccnxName_CreateFromURI("lci:/batch/0");
+    athenaNamePool_LookupBatch(pool, (const CCNxName **) others, 3, found);
+    assertNull(found[0], "Expected no exact match for a longer name");
+    assertNull(found[1], "Expected no exact match for an unrelated name");
+    assertNotNull(found[2], "Expected a match for an interned prefix");
+    athenaInternedName_Release(&found[2]);
+
+    athenaNamePool_LookupLongestPrefixBatch(pool, (const CCNxName **) others, 3, found);
+    assertTrue(found[0] == interned[1], "Expected the longest interned prefix");
+    assertTrue(athenaInternedName_GetSegmentCount(found[1]) == 0, "Expected the empty name");
+    assertTrue(athenaInternedName_GetSegmentCount(found[2]) == 2, "Expected the name itself");
+    for (size_t i = 0; i < 3; i++) {
+        athenaInternedName_Release(&found[i]);
+        ccnxName_Release(&others[i]);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        athenaInternedName_Release(&interned[i]);
+        ccnxName_Release(&names[i]);
+    }
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 0, "Expected every name removed, %zu left",
+               athenaNamePool_GetNumberOfNames(pool));
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_ReleaseRemovesNames)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name1 = ccnxName_CreateFromURI("lci:/foo/bar/chunk1");
+    CCNxName *name2 = ccnxName_CreateFromURI("lci:/foo/baz");
+
+    AthenaInternedName *interned1 = athenaNamePool_Intern(pool, name1);
+    AthenaInternedName *interned2 = athenaNamePool_Intern(pool, name2);
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 4, "Expected 4 names, got %zu", athenaNamePool_GetNumberOfNames(pool));
+
+    // Only /foo is still used by /foo/baz
+    athenaInternedName_Release(&interned1);
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 2, "Expected 2 names, got %zu", athenaNamePool_GetNumberOfNames(pool));
+
+    AthenaInternedName *found = athenaNamePool_Lookup(pool, name1);
+    assertNull(found, "Expected a released name to be removed");
+
+    // Names keep the pool alive until they are released
+    athenaNamePool_Release(&pool);
+    athenaInternedName_Release(&interned2);
+
+    ccnxName_Release(&name1);
+    ccnxName_Release(&name2);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_Grow)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+    size_t numNames = INITIAL_BUCKET_COUNT * 3;
+
+    AthenaInternedName **interned = parcMemory_Allocate(numNames * sizeof(AthenaInternedName *));
+    char uri[64];
+    for (size_t i = 0; i < numNames; i++) {
+        sprintf(uri, "lci:/grow/name%zu", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        interned[i] = athenaNamePool_Intern(pool, name);
+        ccnxName_Release(&name);
+    }
+    assertTrue(pool->table->numBuckets > INITIAL_BUCKET_COUNT, "Expected the table to grow");
+
+    for (size_t i = 0; i < numNames; i++) {
+        sprintf(uri, "lci:/grow/name%zu", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        AthenaInternedName *found = athenaNamePool_Lookup(pool, name);
+        assertTrue(found == interned[i], "Expected to find %s after growing", uri);
+        athenaInternedName_Release(&found);
+        ccnxName_Release(&name);
+    }
+
+    for (size_t i = 0; i < numNames; i++) {
+        athenaInternedName_Release(&interned[i]);
+    }
+    assertTrue(athenaNamePool_GetNumberOfNames(pool) == 0, "Expected an empty pool");
+    assertTrue(athenaNamePool_GetSizeInBytes(pool) == 0, "Expected an empty pool to hold no names");
+
+    parcMemory_Deallocate(&interned);
+    athenaNamePool_Release(&pool);
+}
+
+#define CONCURRENT_THREADS 8
+#define CONCURRENT_PINNED 64
+#define CONCURRENT_NAMES 3000
+#define CONCURRENT_ITERATIONS 20000
+
+typedef struct {
+    AthenaNamePool *pool;
+    CCNxName *pinnedNames[CONCURRENT_PINNED];
+    AthenaInternedName *pinned[CONCURRENT_PINNED];
+} _ConcurrentState;
+
+typedef struct {
+    _ConcurrentState *state;
+    unsigned seed;
+    bool failed;
+} _ConcurrentWorker;
+
+static void *
+_concurrentWorker(void *arg)
+{
+    _ConcurrentWorker *worker = arg;
+    _ConcurrentState *state = worker->state;
+    char uri[64];
+
+    // Names come and go under the lookups, and the table grows, while the pinned names stay put
+    for (int i = 0; (i < CONCURRENT_ITERATIONS) && !worker->failed; i++) {
+        int k = rand_r(&worker->seed) % CONCURRENT_NAMES;
+        sprintf(uri, "lci:/shared/name%d/chunk%d", k, k % 7);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+
+        AthenaInternedName *interned = athenaNamePool_Intern(state->pool, name);
+        AthenaInternedName *found = athenaNamePool_Lookup(state->pool, name);
+        AthenaInternedName *prefix = athenaNamePool_LookupLongestPrefix(state->pool, name);
+        worker->failed |= (found != interned) || (prefix != interned);
+        athenaInternedName_Release(&found);
+        athenaInternedName_Release(&prefix);
+        athenaInternedName_Release(&interned);
+
+        int j = rand_r(&worker->seed) % CONCURRENT_PINNED;
+        const CCNxName *names[2] = { state->pinnedNames[j], name };
+        AthenaInternedName *results[2];
+        athenaNamePool_LookupBatch(state->pool, names, 2, results);
+        worker->failed |= (results[0] != state->pinned[j]);
+        athenaInternedName_Release(&results[0]);
+        if (results[1] != NULL) {
+            athenaInternedName_Release(&results[1]);
+        }
+
+        ccnxName_Release(&name);
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, athenaNamePool_Concurrent)
+{
+    _ConcurrentState state = { .pool = athenaNamePool_Create() };
+    char uri[64];
+
+    for (int i = 0; i < CONCURRENT_PINNED; i++) {
+        sprintf(uri, "lci:/pinned/name%d", i);
+        state.pinnedNames[i] = ccnxName_CreateFromURI(uri);
+        state.pinned[i] = athenaNamePool_Intern(state.pool, state.pinnedNames[i]);
+    }
+
+    pthread_t threads[CONCURRENT_THREADS];
+    _ConcurrentWorker workers[CONCURRENT_THREADS];
+    for (int i = 0; i < CONCURRENT_THREADS; i++) {
+        workers[i] = (_ConcurrentWorker) { .state = &state, .seed = i + 1, .failed = false };
+        pthread_create(&threads[i], NULL, _concurrentWorker, &workers[i]);
+    }
+    for (int i = 0; i < CONCURRENT_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        assertFalse(workers[i].failed, "Expected every lookup on thread %d to find the interned name", i);
+    }
+
+    assertTrue(athenaNamePool_GetNumberOfNames(state.pool) == CONCURRENT_PINNED + 1,
+               "Expected only the pinned names to remain, not %zu", athenaNamePool_GetNumberOfNames(state.pool));
+
+    for (int i = 0; i < CONCURRENT_PINNED; i++) {
+        athenaInternedName_Release(&state.pinned[i]);
+        ccnxName_Release(&state.pinnedNames[i]);
+    }
+    assertTrue(athenaNamePool_GetNumberOfNames(state.pool) == 0, "Expected an empty pool");
+    athenaNamePool_Release(&state.pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaInternedName_CreateName)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar/chunk=3");
+    AthenaInternedName *interned = athenaNamePool_Intern(pool, name);
+
+    CCNxName *created = athenaInternedName_CreateName(interned);
+    assertTrue(ccnxName_Equals(name, created), "Expected the created name to equal the interned name");
+    ccnxName_Release(&created);
+
+    athenaInternedName_Release(&interned);
+    ccnxName_Release(&name);
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNameKey_Equals)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    AthenaInternedName *interned = athenaNamePool_Intern(pool, name);
+    PARCBuffer *keyId1 = parcBuffer_WrapCString("keyId1");
+    PARCBuffer *keyId2 = parcBuffer_WrapCString("keyId1");
+    PARCBuffer *keyId3 = parcBuffer_WrapCString("keyId3");
+
+    AthenaNameKey *nameKey = athenaNameKey_Create(interned, NULL);
+    AthenaNameKey *key1 = athenaNameKey_Create(interned, keyId1);
+    AthenaNameKey *key2 = athenaNameKey_Create(interned, keyId2);
+    AthenaNameKey *key3 = athenaNameKey_Create(interned, keyId3);
+
+    assertTrue(parcObject_Equals(key1, key2), "Expected keys with equal restrictions to be equal");
+    assertTrue(parcObject_HashCode(key1) == parcObject_HashCode(key2), "Expected equal keys to have equal hash codes");
+    assertTrue(parcObject_Compare(key1, key2) == 0, "Expected equal keys to compare equal");
+    assertFalse(parcObject_Equals(key1, key3), "Expected keys with different restrictions to differ");
+    assertFalse(parcObject_Equals(nameKey, key1), "Expected a key without a restriction to differ");
+    assertTrue(parcObject_Compare(nameKey, key1) < 0, "Expected a key without a restriction to sort first");
+
+    AthenaNameKey *copy = parcObject_Copy(key1);
+    assertTrue(parcObject_Equals(copy, key1), "Expected a copy to be equal");
+    assertTrue(athenaNameKey_GetName(copy) == interned, "Expected a copy to share the interned name");
+    athenaNameKey_Release(&copy);
+
+    athenaNameKey_Release(&nameKey);
+    athenaNameKey_Release(&key1);
+    athenaNameKey_Release(&key2);
+    athenaNameKey_Release(&key3);
+    parcBuffer_Release(&keyId1);
+    parcBuffer_Release(&keyId2);
+    parcBuffer_Release(&keyId3);
+    athenaInternedName_Release(&interned);
+    ccnxName_Release(&name);
+    athenaNamePool_Release(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, athenaNameKey_CreateScratch)
+{
+    AthenaNamePool *pool = athenaNamePool_Create();
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    AthenaInternedName *interned = athenaNamePool_Intern(pool, name);
+    PARCBuffer *keyId = parcBuffer_WrapCString("keyId");
+
+    AthenaNameKey *key = athenaNameKey_Create(interned, keyId);
+    PARCHashMap *table = parcHashMap_Create();
+    parcHashMap_Put(table, key, key);
+
+    size_t outstanding = parcMemory_Outstanding();
+    size_t scratchMark = athenaScratch_Mark();
+    AthenaNameKey *scratchKey = athenaNameKey_CreateScratch(interned, keyId);
+    assertTrue(parcMemory_Outstanding() == outstanding, "Expected a scratch key to need no allocation");
+    assertTrue(parcObject_Equals(scratchKey, key), "Expected a scratch key to equal a key made the same way");
+    assertTrue(parcObject_HashCode(scratchKey) == parcObject_HashCode(key), "Expected equal hash codes");
+    assertTrue(parcHashMap_Get(table, scratchKey) == key, "Expected a scratch key to find the entry");
+    assertTrue(athenaNameKey_GetName(scratchKey) == interned, "Expected a scratch key to borrow the name");
+    athenaScratch_Rewind(scratchMark);
+
+    parcHashMap_Release(&table);
+    athenaNameKey_Release(&key);
+    parcBuffer_Release(&keyId);
+    athenaInternedName_Release(&interned);
+    ccnxName_Release(&name);
+    athenaNamePool_Release(&pool);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_NamePool);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
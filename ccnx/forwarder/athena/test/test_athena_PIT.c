@@ -159,6 +159,7 @@ LONGBOW_TEST_CASE(CreateAcquireRelease, CreateRelease)
 LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_AddInterest);
+    LONGBOW_RUN_TEST_CASE(Global, athenaPIT_AddInterestBatch);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_RemoveInterest);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_Match_NoRestriction);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_Match_KeyIdRestriction);
@@ -167,10 +168,13 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_CreateCapacity);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_PurgeExpired);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_RemoveLink);
+    LONGBOW_RUN_TEST_CASE(Global, athenaPIT_RemoveAllPending);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_LinkCleanupFromMatch);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_GetNumberOfTableEntries);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_GetNumberOfPendingInterests);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_GetMeanEntryLifetime);
+    LONGBOW_RUN_TEST_CASE(Global, athenaPIT_CreateSnapshot);
+    LONGBOW_RUN_TEST_CASE(Global, athenaPIT_ContinueSnapshot);
 
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_ProcessMessage_Size);
     LONGBOW_RUN_TEST_CASE(Global, athenaPIT_ProcessMessage_AvgEntryLifetime);
@@ -404,6 +408,31 @@ LONGBOW_TEST_CASE(Global, athenaPIT_AddInterest)
     assertTrue(parcBitVector_Equals(expectedReturnVector, savedReturnVector), "Expect an existing return vectors");
 }
 
+LONGBOW_TEST_CASE(Global, athenaPIT_AddInterestBatch)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    // testInterest1 is repeated from another link within the batch and must be aggregated
+    const CCNxInterest *interests[] = { data->testInterest1, data->testInterest1WithKeyId, data->testInterest1 };
+    const PARCBitVector *ingressVectors[] = { data->testVector1, data->testVector1, data->testVector2 };
+    size_t count = sizeof(interests) / sizeof(interests[0]);
+    AthenaPITResolution results[count];
+    PARCBitVector *expectedReturnVectors[count];
+
+    athenaPIT_AddInterestBatch(data->testPIT, interests, ingressVectors, count, results, expectedReturnVectors);
+    assertTrue(results[0] == AthenaPITResolution_Forward, "Expect the first interest to be Forward");
+    assertTrue(results[1] == AthenaPITResolution_Forward, "Expect the restricted interest to be Forward");
+    assertTrue(results[2] == AthenaPITResolution_Aggregated, "Expect the repeated interest to be Aggregated");
+    assertTrue(expectedReturnVectors[0] == expectedReturnVectors[2], "Expect the repeated interest to share an entry");
+    assertTrue(athenaPIT_GetNumberOfTableEntries(data->testPIT) == 2, "Expect two PIT entries");
+    assertTrue(athenaPIT_GetNumberOfPendingInterests(data->testPIT) == 3, "Expect three pending interests");
+
+    for (size_t i = 0; i < count; i++) {
+        assertNotNull(expectedReturnVectors[i], "Expected a return vector for interest %zu", i);
+        parcBitVector_Release(&expectedReturnVectors[i]);
+    }
+}
+
 LONGBOW_TEST_CASE(Global, athenaPIT_RemoveInterest)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -723,6 +752,44 @@ LONGBOW_TEST_CASE(Global, athenaPIT_RemoveLink)
     parcBitVector_Release(&backLinkVector);
 }
 
+typedef struct {
+    size_t numEntries;
+    PARCBitVector *allIngress;
+} _PendingResult;
+
+static void
+_collectPending(void *context, CCNxInterest *interest, PARCBitVector *ingressVector)
+{
+    _PendingResult *pending = (_PendingResult *) context;
+    assertNotNull(interest, "Expected an interest for each entry");
+    parcBitVector_SetVector(pending->allIngress, ingressVector);
+    pending->numEntries++;
+}
+
+LONGBOW_TEST_CASE(Global, athenaPIT_RemoveAllPending)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    _PendingResult pending = { .numEntries = 0, .allIngress = parcBitVector_Create() };
+    assertTrue(athenaPIT_RemoveAllPending(data->testPIT, _collectPending, &pending) == 0, "Expected nothing pending in an empty PIT");
+    assertTrue(pending.numEntries == 0, "Expected no callbacks for an empty PIT");
+
+    PARCBitVector *expectedReturnVector;
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1, data->testVector1, &expectedReturnVector);
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1, data->testVector2, &expectedReturnVector);
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1WithKeyId, data->testVector1, &expectedReturnVector);
+
+    size_t numPending = athenaPIT_RemoveAllPending(data->testPIT, _collectPending, &pending);
+    assertTrue(numPending == 3, "Expected three pending interests to be removed, not %zu", numPending);
+    assertTrue(pending.numEntries == 2, "Expected two entries to be removed, not %zu", pending.numEntries);
+    assertTrue(parcBitVector_Contains(pending.allIngress, data->testVector1), "Expected the ingress links to be returned");
+    assertTrue(parcBitVector_Contains(pending.allIngress, data->testVector2), "Expected the aggregated ingress link to be returned");
+    assertTrue(athenaPIT_GetNumberOfTableEntries(data->testPIT) == 0, "Expected an empty PIT");
+    assertTrue(athenaPIT_GetNumberOfPendingInterests(data->testPIT) == 0, "Expected nothing pending");
+
+    parcBitVector_Release(&pending.allIngress);
+}
+
 LONGBOW_TEST_CASE(Global, athenaPIT_GetNumberOfTableEntries)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -895,6 +962,74 @@ LONGBOW_TEST_CASE(Global, athenaPIT_LinkCleanupFromMatch)
     assertTrue(athenaPIT_RemoveLink(data->testPIT, data->testVector1), "Expected True result from RemoveLink()");
 }
 
+LONGBOW_TEST_CASE(Global, athenaPIT_CreateSnapshot)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    PARCBitVector *expectedReturnVector;
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1, data->testVector1, &expectedReturnVector);
+    athenaPIT_AddInterest(data->testPIT, data->testInterest2, data->testVector1, &expectedReturnVector);
+
+    AthenaSnapshot *snapshot = athenaPIT_CreateSnapshot(data->testPIT);
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected a snapshot entry per PIT entry");
+
+    // Aggregating onto an entry must not change the snapshot taken before it
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1, data->testVector2, &expectedReturnVector);
+
+    for (size_t i = 0; i < athenaSnapshot_GetSize(snapshot); i++) {
+        const _AthenaPITSnapshotEntry *entry = athenaSnapshot_Get(snapshot, i);
+        assertTrue(parcBitVector_Equals(entry->ingress, data->testVector1), "Expected the ingress at the time of the snapshot");
+        assertTrue(entry->expiresInMillis <= (int64_t) TEST_INTEREST_LIFETIME, "Expected the entry to expire within its lifetime");
+
+        PARCJSON *json = parcObject_ToJSON(entry);
+        assertNotNull(parcJSON_GetValueByName(json, "name"), "Expected the entry to render its name");
+        parcJSON_Release(&json);
+    }
+
+    athenaSnapshot_Release(&snapshot);
+}
+
+LONGBOW_TEST_CASE(Global, athenaPIT_ContinueSnapshot)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    data->testPIT->clock = parcClock_Test();
+
+    // Three entries, each expiring 10ms after the one before
+    PARCBitVector *expectedReturnVector;
+    _TestClockTimeval.tv_usec = 0;
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1, data->testVector1, &expectedReturnVector);
+    _TestClockTimeval.tv_usec += 10 * 1000;
+    athenaPIT_AddInterest(data->testPIT, data->testInterest2, data->testVector1, &expectedReturnVector);
+    _TestClockTimeval.tv_usec += 10 * 1000;
+    athenaPIT_AddInterest(data->testPIT, data->testInterest1WithKeyId, data->testVector1, &expectedReturnVector);
+
+    AthenaSnapshot *snapshot = athenaSnapshot_CreatePartial("pit", athenaPIT_GetNumberOfTableEntries(data->testPIT));
+    AthenaPITWalk *walk = athenaPIT_StartSnapshot(data->testPIT);
+
+    bool more = athenaPIT_ContinueSnapshot(data->testPIT, walk, snapshot, 1);
+    assertTrue(more, "Expected the walk to stop after the first slice");
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 1, "Expected one entry in the first slice");
+
+    // An entry removed between slices is not reported
+    assertTrue(athenaPIT_RemoveInterest(data->testPIT, data->testInterest2, data->testVector1), "Expected the interest to be removed");
+
+    more = athenaPIT_ContinueSnapshot(data->testPIT, walk, snapshot, 1);
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected the next remaining entry, got %zu entries", athenaSnapshot_GetSize(snapshot));
+    if (more) {
+        more = athenaPIT_ContinueSnapshot(data->testPIT, walk, snapshot, 1);
+    }
+    assertFalse(more, "Expected the walk to be through the PIT");
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 2, "Expected nothing past the last entry");
+
+    const _AthenaPITSnapshotEntry *first = athenaSnapshot_Get(snapshot, 0);
+    const _AthenaPITSnapshotEntry *second = athenaSnapshot_Get(snapshot, 1);
+    assertTrue(first->expiresInMillis < second->expiresInMillis, "Expected entries in order of expiration");
+
+    athenaPIT_StopSnapshot(&walk);
+    assertNull(walk, "Expected stop to clear the pointer");
+    athenaSnapshot_Release(&snapshot);
+}
+
 LONGBOW_TEST_CASE(Global, athenaPIT_ProcessMessage_Size)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_RouteFeed.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_FileOutputStream.h>
+#include <parc/logging/parc_LogReporterFile.h>
+
+#define TEST_SOCKET_PATH "/tmp/test_athena_RouteFeed.sock"
+
+typedef struct test_data {
+    PARCLog *log;
+    AthenaFIB *fib;
+    AthenaTransportLinkAdapter *adapter;
+    AthenaRouteFeed *routeFeed;
+    int client;
+    uint64_t sequence;
+} TestData;
+
+static AthenaFIB *_testFIB;
+
+static void
+_removeLink(void *context, PARCBitVector *linkVector)
+{
+    athenaFIB_RemoveLink(_testFIB, linkVector);
+}
+
+static PARCLog *
+_createLog(void)
+{
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+
+    PARCLog *log = parcLog_Create("localhost", "test_athena_RouteFeed", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+    return log;
+}
+
+static int
+_connect(void)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, TEST_SOCKET_PATH);
+
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    assertTrue(client != -1, "Unable to create a client socket (%s)", strerror(errno));
+    assertTrue(connect(client, (struct sockaddr *) &address, sizeof(address)) == 0, "Unable to connect (%s)", strerror(errno));
+    return client;
+}
+
+// Send a frame with the next sequence number
+static void
+_send(TestData *data, AthenaRouteFeedFrameType type, const char *prefix, size_t numLinks, const char *linkNames[])
+{
+    uint8_t frame[1024];
+    size_t length = athenaRouteFeed_EncodeFrame(frame, sizeof(frame), type, ++data->sequence, prefix, numLinks, linkNames);
+    assertTrue(length > 0, "Unable to encode a frame");
+    assertTrue(write(data->client, frame, length) == (ssize_t) length, "Unable to send a frame");
+}
+
+// Act as the forwarder until the feed answers, returning the answer's type
+static AthenaRouteFeedFrameType
+_receive(TestData *data, uint64_t *sequence, uint32_t *numRejected)
+{
+    uint8_t frame[FRAME_LENGTH_SIZE + FRAME_HEADER_SIZE + 4];
+    size_t received = 0;
+    while (received < FRAME_LENGTH_SIZE + FRAME_HEADER_SIZE) {
+        athenaRouteFeed_Apply(data->routeFeed, data->adapter, data->fib);
+        struct pollfd pollfd = { .fd = data->client, .events = POLLIN };
+        if (poll(&pollfd, 1, 10) == 1) {
+            ssize_t readCount = read(data->client, frame + received, sizeof(frame) - received);
+            assertTrue(readCount > 0, "Expected an answer from the route feed");
+            received += readCount;
+        }
+    }
+    size_t length = _get(frame, FRAME_LENGTH_SIZE);
+    while (received < FRAME_LENGTH_SIZE + length) {
+        ssize_t readCount = read(data->client, frame + received, FRAME_LENGTH_SIZE + length - received);
+        assertTrue(readCount > 0, "Expected the rest of the answer from the route feed");
+        received += readCount;
+    }
+    *sequence = _get(frame + FRAME_LENGTH_SIZE + 1, 8);
+    if (numRejected) {
+        *numRejected = (length == FRAME_HEADER_SIZE + 4) ? (uint32_t) _get(frame + FRAME_LENGTH_SIZE + FRAME_HEADER_SIZE, 4) : 0;
+    }
+    return frame[FRAME_LENGTH_SIZE];
+}
+
+static void
+_expectAck(TestData *data, uint32_t expectedRejected)
+{
+    uint64_t sequence;
+    uint32_t numRejected;
+    assertTrue(_receive(data, &sequence, &numRejected) == AthenaRouteFeedFrame_Ack, "Expected an ack");
+    assertTrue(sequence == data->sequence, "Expected the ack of sequence %llu, got %llu",
+               (unsigned long long) data->sequence, (unsigned long long) sequence);
+    assertTrue(numRejected == expectedRejected, "Expected %u rejected changes, got %u", expectedRejected, numRejected);
+}
+
+static bool
+_isRoutedTo(TestData *data, const char *prefix, const char *linkName)
+{
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(data->adapter, linkName);
+    if (linkId == -1) {
+        return false;
+    }
+    CCNxName *name = ccnxName_CreateFromURI(prefix);
+    PARCBitVector *egressVector = athenaFIB_Lookup(data->fib, name);
+    ccnxName_Release(&name);
+    return egressVector && (parcBitVector_Get(egressVector, linkId) == 1);
+}
+
+LONGBOW_TEST_RUNNER(athena_RouteFeed)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_RouteFeed)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_RouteFeed)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaRouteFeed_EncodeFrame);
+    LONGBOW_RUN_TEST_CASE(Global, athenaRouteFeed_Sync);
+    LONGBOW_RUN_TEST_CASE(Global, athenaRouteFeed_Resync);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    data->log = _createLog();
+    data->fib = _testFIB = athenaFIB_Create();
+    data->adapter = athenaTransportLinkAdapter_Create(_removeLink, NULL);
+    const char *specifications[] = { "udp://127.0.0.1:40120/name=UDP_0", "udp://127.0.0.1:40121/name=UDP_1" };
+    for (size_t i = 0; i < 2; i++) {
+        PARCURI *connectionURI = parcURI_Parse(specifications[i]);
+        assertNotNull(athenaTransportLinkAdapter_Open(data->adapter, connectionURI), "Unable to open %s", specifications[i]);
+        parcURI_Release(&connectionURI);
+    }
+
+    data->routeFeed = athenaRouteFeed_Create(TEST_SOCKET_PATH, data->log);
+    assertNotNull(data->routeFeed, "Unable to create a route feed on %s", TEST_SOCKET_PATH);
+    data->client = _connect();
+
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    close(data->client);
+    athenaRouteFeed_Release(&data->routeFeed);
+    athenaTransportLinkAdapter_Destroy(&data->adapter);
+    athenaFIB_Release(&data->fib);
+    parcLog_Release(&data->log);
+    parcMemory_Deallocate(&data);
+
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaRouteFeed_EncodeFrame)
+{
+    uint8_t frame[64];
+    const char *linkNames[] = { "UDP_0", "UDP_1" };
+    size_t length = athenaRouteFeed_EncodeFrame(frame, sizeof(frame), AthenaRouteFeedFrame_Replace, 7, "lci:/a", 2, linkNames);
+    assertTrue(length == 4 + 9 + 2 + 6 + 2 + 2 * (2 + 5), "Unexpected frame length %zu", length);
+    assertTrue(_get(frame, 4) == length - 4, "Expected the length field not to count itself");
+    assertTrue(frame[4] == AthenaRouteFeedFrame_Replace, "Expected the frame type");
+    assertTrue(_get(frame + 5, 8) == 7, "Expected the sequence number");
+
+    CCNxName *prefix;
+    _AthenaRouteFeedLinks *links;
+    assertTrue(_decodeRoute(frame + 13, length - 13, &prefix, &links), "Expected the route to decode");
+    assertTrue(links->numLinks == 2, "Expected 2 links, got %zu", links->numLinks);
+    assertTrue(strcmp(links->linkNames[1], "UDP_1") == 0, "Expected UDP_1, got %s", links->linkNames[1]);
+    ccnxName_Release(&prefix);
+    parcObject_Release((void **) &links);
+
+    assertFalse(_decodeRoute(frame + 13, length - 14, &prefix, &links), "Expected a truncated route not to decode");
+    assertTrue(athenaRouteFeed_EncodeFrame(frame, 16, AthenaRouteFeedFrame_Add, 8, "lci:/a", 2, linkNames) == 0,
+               "Expected a frame larger than the buffer not to be encoded");
+}
+
+LONGBOW_TEST_CASE(Global, athenaRouteFeed_Sync)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    const char *both[] = { "UDP_0", "UDP_1" };
+    const char *udp0[] = { "UDP_0" };
+    const char *udp1[] = { "UDP_1" };
+    const char *missing[] = { "MISSING" };
+
+    _send(data, AthenaRouteFeedFrame_SyncBegin, NULL, 0, NULL);
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/a", 1, udp0);
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/b", 2, both);
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/c", 1, missing);
+    _send(data, AthenaRouteFeedFrame_SyncEnd, NULL, 0, NULL);
+    _expectAck(data, 1);
+    assertTrue(_isRoutedTo(data, "lci:/a/x", "UDP_0"), "Expected lci:/a to be routed to UDP_0");
+    assertTrue(_isRoutedTo(data, "lci:/b/x", "UDP_0") && _isRoutedTo(data, "lci:/b/x", "UDP_1"),
+               "Expected lci:/b to be routed to both links");
+
+    // Deltas
+    _send(data, AthenaRouteFeedFrame_Replace, "lci:/a", 1, udp1);
+    _send(data, AthenaRouteFeedFrame_Delete, "lci:/b", 1, udp0);
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/d", 1, udp0);
+    _send(data, AthenaRouteFeedFrame_Commit, NULL, 0, NULL);
+    _expectAck(data, 0);
+    assertFalse(_isRoutedTo(data, "lci:/a/x", "UDP_0"), "Expected lci:/a to be replaced");
+    assertTrue(_isRoutedTo(data, "lci:/a/x", "UDP_1"), "Expected lci:/a to be routed to UDP_1");
+    assertFalse(_isRoutedTo(data, "lci:/b/x", "UDP_0"), "Expected lci:/b to no longer be routed to UDP_0");
+    assertTrue(_isRoutedTo(data, "lci:/d/x", "UDP_0"), "Expected lci:/d to be routed to UDP_0");
+
+    // A full sync only changes what differs
+    _send(data, AthenaRouteFeedFrame_SyncBegin, NULL, 0, NULL);
+    _send(data, AthenaRouteFeedFrame_Replace, "lci:/a", 1, udp1);
+    _send(data, AthenaRouteFeedFrame_Replace, "lci:/e", 1, udp0);
+    _send(data, AthenaRouteFeedFrame_SyncEnd, NULL, 0, NULL);
+    _expectAck(data, 0);
+    assertTrue(_isRoutedTo(data, "lci:/a/x", "UDP_1"), "Expected lci:/a to be left in place");
+    assertFalse(_isRoutedTo(data, "lci:/b/x", "UDP_1"), "Expected lci:/b to be removed");
+    assertFalse(_isRoutedTo(data, "lci:/d/x", "UDP_0"), "Expected lci:/d to be removed");
+    assertTrue(_isRoutedTo(data, "lci:/e/x", "UDP_0"), "Expected lci:/e to be added");
+    assertTrue(parcHashMap_Size(data->routeFeed->routes) == 2, "Expected the feed to hold 2 prefixes");
+}
+
+LONGBOW_TEST_CASE(Global, athenaRouteFeed_Resync)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    const char *udp0[] = { "UDP_0" };
+    uint64_t sequence;
+
+    // Deltas before a full sync are refused
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/a", 1, udp0);
+    assertTrue(_receive(data, &sequence, NULL) == AthenaRouteFeedFrame_Resync, "Expected a resync request");
+
+    _send(data, AthenaRouteFeedFrame_SyncBegin, NULL, 0, NULL);
+    _send(data, AthenaRouteFeedFrame_SyncEnd, NULL, 0, NULL);
+    _expectAck(data, 0);
+
+    // A gap in the sequence numbers asks for a full sync and later frames are ignored until it starts
+    uint64_t lastSequence = data->sequence;
+    data->sequence++;
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/a", 1, udp0);
+    assertTrue(_receive(data, &sequence, NULL) == AthenaRouteFeedFrame_Resync, "Expected a resync request");
+    assertTrue(sequence == lastSequence, "Expected the last sequence accepted, got %llu", (unsigned long long) sequence);
+    _send(data, AthenaRouteFeedFrame_Commit, NULL, 0, NULL);
+
+    _send(data, AthenaRouteFeedFrame_SyncBegin, NULL, 0, NULL);
+    _send(data, AthenaRouteFeedFrame_Add, "lci:/b", 1, udp0);
+    _send(data, AthenaRouteFeedFrame_SyncEnd, NULL, 0, NULL);
+    _expectAck(data, 0);
+    assertFalse(_isRoutedTo(data, "lci:/a/x", "UDP_0"), "Expected the route sent out of sequence to be ignored");
+    assertTrue(_isRoutedTo(data, "lci:/b/x", "UDP_0"), "Expected lci:/b to be routed to UDP_0");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_RouteFeed);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
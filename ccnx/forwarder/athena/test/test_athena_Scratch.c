@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Scratch.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+LONGBOW_TEST_RUNNER(athena_Scratch)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Scratch)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Scratch)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaScratch_Allocate);
+    LONGBOW_RUN_TEST_CASE(Global, athenaScratch_Rewind);
+    LONGBOW_RUN_TEST_CASE(Global, athenaScratch_Chunks);
+    LONGBOW_RUN_TEST_CASE(Global, athenaScratch_Threads);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    athenaScratch_Reset();
+
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaScratch_Allocate)
+{
+    assertTrue(athenaScratch_GetBytesInUse() == 0, "Expected an empty arena");
+
+    uint8_t *first = athenaScratch_Allocate(1);
+    uint8_t *second = athenaScratch_Allocate(20);
+    assertTrue(((uintptr_t) first % AthenaScratchAlignment) == 0, "Expected an aligned allocation");
+    assertTrue(((uintptr_t) second % AthenaScratchAlignment) == 0, "Expected an aligned allocation");
+    assertTrue(second == first + AthenaScratchAlignment, "Expected allocations to be consecutive");
+    assertTrue(athenaScratch_GetBytesInUse() == 3 * AthenaScratchAlignment,
+               "Expected 48 bytes in use, got %zu", athenaScratch_GetBytesInUse());
+    memset(second, 0xff, 20);
+
+    athenaScratch_Reset();
+    assertTrue(athenaScratch_GetBytesInUse() == 0, "Expected an empty arena after a reset");
+    assertTrue(athenaScratch_Allocate(8) == first, "Expected the arena to be reused after a reset");
+}
+
+LONGBOW_TEST_CASE(Global, athenaScratch_Rewind)
+{
+    void *outer = athenaScratch_Allocate(32);
+
+    size_t mark = athenaScratch_Mark();
+    void *inner = athenaScratch_Allocate(64);
+    athenaScratch_Allocate(64);
+    athenaScratch_Rewind(mark);
+
+    assertTrue(athenaScratch_GetBytesInUse() == 32, "Expected only the outer allocation in use");
+    assertTrue(athenaScratch_Allocate(16) == inner, "Expected the space after the mark to be reused");
+    assertTrue(outer != inner, "Expected the outer allocation to be kept");
+}
+
+LONGBOW_TEST_CASE(Global, athenaScratch_Chunks)
+{
+    // Fill the inline buffer, then overflow into a chunk, then into a chunk big enough for one allocation
+    athenaScratch_Allocate(AthenaScratchInlineSize - 64);
+    size_t mark = athenaScratch_Mark();
+    assertTrue(parcMemory_Outstanding() == 0, "Expected the inline buffer to need no allocation");
+
+    uint8_t *chunked = athenaScratch_Allocate(128);
+    assertTrue(parcMemory_Outstanding() == 1, "Expected a chunk to be allocated");
+    assertTrue(((uintptr_t) chunked % AthenaScratchAlignment) == 0, "Expected an aligned allocation");
+    memset(chunked, 0, 128);
+
+    size_t chunkMark = athenaScratch_Mark();
+    athenaScratch_Allocate(16);
+    athenaScratch_Rewind(chunkMark);
+    assertTrue(parcMemory_Outstanding() == 1, "Expected a rewind within a chunk to keep it");
+
+    uint8_t *large = athenaScratch_Allocate(AthenaScratchChunkSize * 2);
+    assertTrue(parcMemory_Outstanding() == 2, "Expected a chunk for a large allocation");
+    memset(large, 0, AthenaScratchChunkSize * 2);
+
+    athenaScratch_Rewind(mark);
+    assertTrue(parcMemory_Outstanding() == 0, "Expected the chunks to be freed");
+    assertTrue(athenaScratch_GetBytesInUse() == mark, "Expected the arena back at the mark");
+
+    // The space left in the inline buffer is still used
+    athenaScratch_Allocate(64);
+    assertTrue(parcMemory_Outstanding() == 0, "Expected the rest of the inline buffer to be used");
+}
+
+static void *
+_allocate(void *arg)
+{
+    uint8_t **result = (uint8_t **) arg;
+    *result = athenaScratch_Allocate(16);
+    size_t bytesInUse = athenaScratch_GetBytesInUse();
+    athenaScratch_Reset();
+    return (void *) bytesInUse;
+}
+
+LONGBOW_TEST_CASE(Global, athenaScratch_Threads)
+{
+    uint8_t *mine = athenaScratch_Allocate(16);
+
+    pthread_t thread;
+    uint8_t *theirs = NULL;
+    void *theirBytesInUse = NULL;
+    pthread_create(&thread, NULL, _allocate, &theirs);
+    pthread_join(thread, &theirBytesInUse);
+
+    assertTrue(theirs != mine, "Expected each thread to have its own arena");
+    assertTrue((uintptr_t) theirBytesInUse == 16, "Expected a new thread to start with an empty arena");
+    assertTrue(athenaScratch_GetBytesInUse() == 16, "Expected another thread not to affect this arena");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Scratch);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
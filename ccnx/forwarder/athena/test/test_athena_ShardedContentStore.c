@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+
+#include "../athena_ShardedContentStore.c"
+
+#include <LongBow/testing.h>
+#include <LongBow/debugging.h>
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/common/ccnx_NameSegmentNumber.h>
+
+#define NUM_THREADS 4
+#define NUM_OBJECTS_PER_THREAD 200
+
+static AthenaShardedContentStore *
+_createShardedContentStore(size_t capacityInMB, size_t numShards)
+{
+    AthenaShardedContentStoreConfig config;
+    config.capacityInMB = capacityInMB;
+    config.numShards = numShards;
+    config.evictionPolicy = AthenaLRUContentStoreEvictionPolicy_LRU;
+    config.coldSegmentPercent = 0;
+    config.deduplicatePayloads = false;
+    config.namePool = NULL;
+
+    return _athenaShardedContentStore_Create(&config);
+}
+
+static CCNxContentObject *
+_createContentObject(char *lci, uint64_t chunkNum, PARCBuffer *payload)
+{
+    CCNxName *name = ccnxName_CreateFromURI(lci);
+    CCNxNameSegment *chunkSegment = ccnxNameSegmentNumber_Create(CCNxNameLabelType_CHUNK, chunkNum);
+    ccnxName_Append(name, chunkSegment);
+
+    CCNxContentObject *result = ccnxContentObject_CreateWithDataPayload(name, payload);
+
+    ccnxName_Release(&name);
+    ccnxNameSegment_Release(&chunkSegment);
+
+    return result;
+}
+
+LONGBOW_TEST_RUNNER(ccnx_ShardedContentStore)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(ccnx_ShardedContentStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(ccnx_ShardedContentStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, CreateRelease);
+    LONGBOW_RUN_TEST_CASE(Local, capacitySetGet);
+    LONGBOW_RUN_TEST_CASE(Local, putAndGetMatch);
+    LONGBOW_RUN_TEST_CASE(Local, removeMatch);
+    LONGBOW_RUN_TEST_CASE(Local, getMatchHeldAfterEviction);
+    LONGBOW_RUN_TEST_CASE(Local, rebalance);
+    LONGBOW_RUN_TEST_CASE(Local, concurrentPutAndGetMatch);
+    LONGBOW_RUN_TEST_CASE(Local, processMessage_StatSize);
+    LONGBOW_RUN_TEST_CASE(Local, snapshotWalk);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, CreateRelease)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 5);
+    assertNotNull(impl, "Expected non-null result from _athenaShardedContentStore_Create()");
+    assertTrue(impl->numShards == 8, "Expected the shard count to be rounded up to 8, got %zu", impl->numShards);
+
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+    assertNull(impl, "Expected null result from _athenaShardedContentStore_Release()");
+
+    impl = _athenaShardedContentStore_Create(NULL);
+    assertTrue(impl->numShards == AthenaShardedContentStore_DefaultShardCount, "Expected the default shard count");
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+
+    impl = _createShardedContentStore(10, AthenaShardedContentStore_MaxShardCount + 1);
+    assertTrue(impl->numShards == AthenaShardedContentStore_MaxShardCount, "Expected the shard count to be capped, got %zu", impl->numShards);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, capacitySetGet)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(1, 4);
+    size_t truth = 1000;
+    _athenaShardedContentStore_SetCapacity(impl, truth);
+
+    size_t test = _athenaShardedContentStore_GetCapacity(impl);
+    assertTrue(test == truth, "expected the same size capacity as was set");
+
+    AthenaLRUContentStoreStats stats;
+    _athenaShardedContentStore_GetStats(impl, &stats);
+    assertTrue(stats.capacityInBytes <= truth * 1024 * 1024, "Expected the shard capacities to sum to no more than the total");
+    assertTrue(stats.capacityInBytes > (truth - 1) * 1024 * 1024, "Expected the shard capacities to use the whole budget");
+
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, putAndGetMatch)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 4);
+    PARCBuffer *payload = parcBuffer_Allocate(100);
+
+    for (uint64_t i = 0; i < 50; i++) {
+        CCNxContentObject *content = _createContentObject("lci:/sharded/content", i, payload);
+        assertTrue(_athenaShardedContentStore_PutContentObject(impl, content), "Expected to be able to insert content");
+        ccnxContentObject_Release(&content);
+    }
+
+    for (uint64_t i = 0; i < 50; i++) {
+        CCNxContentObject *content = _createContentObject("lci:/sharded/content", i, payload);
+        CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(content));
+
+        CCNxContentObject *match = _athenaShardedContentStore_GetMatch(impl, interest);
+        assertNotNull(match, "Expected to find a match for chunk %" PRIu64, i);
+        assertTrue(ccnxName_Equals(ccnxContentObject_GetName(match), ccnxContentObject_GetName(content)),
+                   "Expected the matched name to equal the interest name");
+
+        ccnxInterest_Release(&interest);
+        ccnxContentObject_Release(&content);
+    }
+
+    AthenaLRUContentStoreStats stats;
+    _athenaShardedContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numEntries == 50, "Expected 50 entries, got %" PRIu64, stats.numEntries);
+    assertTrue(stats.numMatchHits == 50, "Expected 50 hits, got %" PRIu64, stats.numMatchHits);
+
+    size_t populatedShards = 0;
+    for (size_t i = 0; i < impl->numShards; i++) {
+        AthenaLRUContentStoreStats shardStats;
+        athenaLRUContentStore_GetStats(impl->shards[i]->store, &shardStats);
+        populatedShards += (shardStats.numEntries > 0) ? 1 : 0;
+    }
+    assertTrue(populatedShards > 1, "Expected content to be spread over more than one shard");
+
+    parcBuffer_Release(&payload);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, removeMatch)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 4);
+    PARCBuffer *payload = parcBuffer_Allocate(100);
+
+    CCNxContentObject *content = _createContentObject("lci:/sharded/remove", 1, payload);
+    _athenaShardedContentStore_PutContentObject(impl, content);
+
+    CCNxName *name = ccnxContentObject_GetName(content);
+    assertTrue(_athenaShardedContentStore_RemoveMatch(impl, name, NULL, NULL), "Expected the content to be removed");
+    assertFalse(_athenaShardedContentStore_RemoveMatch(impl, name, NULL, NULL), "Expected nothing left to remove");
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    assertNull(_athenaShardedContentStore_GetMatch(impl, interest), "Expected no match after removal");
+
+    ccnxInterest_Release(&interest);
+    ccnxContentObject_Release(&content);
+    parcBuffer_Release(&payload);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, snapshotWalk)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 4);
+    PARCBuffer *payload = parcBuffer_Allocate(100);
+
+    for (uint64_t i = 0; i < 50; i++) {
+        CCNxContentObject *content = _createContentObject("lci:/sharded/walk", i, payload);
+        _athenaShardedContentStore_PutContentObject(impl, content);
+        ccnxContentObject_Release(&content);
+    }
+
+    // Slices run across shard boundaries, and no slice goes past its limit
+    AthenaSnapshot *snapshot = athenaSnapshot_CreatePartial("cs", 0);
+    AthenaContentStoreWalk *walk = _athenaShardedContentStore_StartSnapshot(impl);
+    size_t numSlices = 0;
+    bool more = true;
+    while (more) {
+        size_t sizeBefore = athenaSnapshot_GetSize(snapshot);
+        more = _athenaShardedContentStore_ContinueSnapshot(impl, walk, snapshot, 7);
+        assertTrue(athenaSnapshot_GetSize(snapshot) - sizeBefore <= 7, "Expected at most 7 entries per slice");
+        numSlices++;
+    }
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 50, "Expected every entry, got %zu", athenaSnapshot_GetSize(snapshot));
+    assertTrue(numSlices >= 8, "Expected the walk to take at least 8 slices, took %zu", numSlices);
+    _athenaShardedContentStore_StopSnapshot(impl, &walk);
+
+    // A walk stopped part way through lets go of the shard it was in
+    walk = _athenaShardedContentStore_StartSnapshot(impl);
+    _athenaShardedContentStore_ContinueSnapshot(impl, walk, snapshot, 1);
+    _athenaShardedContentStore_StopSnapshot(impl, &walk);
+    assertNull(walk, "Expected stop to clear the pointer");
+
+    athenaSnapshot_Release(&snapshot);
+    parcBuffer_Release(&payload);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, getMatchHeldAfterEviction)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 1);
+    PARCBuffer *payload = parcBuffer_Allocate(100);
+
+    CCNxContentObject *content = _createContentObject("lci:/sharded/held", 1, payload);
+    _athenaShardedContentStore_PutContentObject(impl, content);
+
+    CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(content));
+    CCNxContentObject *match = _athenaShardedContentStore_GetMatch(impl, interest);
+    ccnxContentObject_Release(&content);
+
+    // Evicting the entry must not invalidate the borrowed match
+    _athenaShardedContentStore_RemoveMatch(impl, ccnxInterest_GetName(interest), NULL, NULL);
+    assertTrue(ccnxName_Equals(ccnxContentObject_GetName(match), ccnxInterest_GetName(interest)),
+               "Expected the borrowed match to remain valid");
+
+    ccnxInterest_Release(&interest);
+    parcBuffer_Release(&payload);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, rebalance)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(16, 2);
+    PARCBuffer *payload = parcBuffer_Allocate(100);
+
+    // Put everything into a single shard, then rebalance in its favour
+    CCNxContentObject *content = _createContentObject("lci:/sharded/hot", 1, payload);
+    _AthenaContentStoreShard *hotShard = _getShard(impl, ccnxContentObject_GetName(content));
+    for (int i = 0; i < 100; i++) {
+        _athenaShardedContentStore_PutContentObject(impl, content);
+    }
+    ccnxContentObject_Release(&content);
+
+    _athenaShardedContentStore_Rebalance(impl, true);
+
+    AthenaLRUContentStoreStats hotStats;
+    athenaLRUContentStore_GetStats(hotShard->store, &hotStats);
+    assertTrue(hotStats.capacityInBytes > (impl->maxSizeInBytes / 2),
+               "Expected the busy shard to be given more than an even share, got %zu", hotStats.capacityInBytes);
+
+    parcBuffer_Release(&payload);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+typedef struct test_thread_data {
+    AthenaShardedContentStore *impl;
+    PARCBuffer *payload;
+    int threadId;
+    int hits;
+} TestThreadData;
+
+static void *
+_putAndGetMatchThread(void *arg)
+{
+    TestThreadData *data = (TestThreadData *) arg;
+    char prefix[64];
+    sprintf(prefix, "lci:/sharded/thread%d", data->threadId);
+
+    for (uint64_t i = 0; i < NUM_OBJECTS_PER_THREAD; i++) {
+        CCNxContentObject *content = _createContentObject(prefix, i, data->payload);
+        _athenaShardedContentStore_PutContentObject(data->impl, content);
+
+        CCNxInterest *interest = ccnxInterest_CreateSimple(ccnxContentObject_GetName(content));
+        if (_athenaShardedContentStore_GetMatch(data->impl, interest) != NULL) {
+            data->hits++;
+        }
+        ccnxInterest_Release(&interest);
+        ccnxContentObject_Release(&content);
+    }
+    _holdMatch(NULL);
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Local, concurrentPutAndGetMatch)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 8);
+    PARCBuffer *payload = parcBuffer_Allocate(100);
+
+    pthread_t threads[NUM_THREADS];
+    TestThreadData data[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; i++) {
+        data[i].impl = impl;
+        data[i].payload = payload;
+        data[i].threadId = i;
+        data[i].hits = 0;
+        pthread_create(&threads[i], NULL, _putAndGetMatchThread, &data[i]);
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        assertTrue(data[i].hits == NUM_OBJECTS_PER_THREAD, "Expected every put to be matched, thread %d got %d", i, data[i].hits);
+    }
+
+    AthenaLRUContentStoreStats stats;
+    _athenaShardedContentStore_GetStats(impl, &stats);
+    assertTrue(stats.numEntries == (NUM_THREADS * NUM_OBJECTS_PER_THREAD), "Expected all objects to be stored, got %" PRIu64, stats.numEntries);
+
+    parcBuffer_Release(&payload);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+LONGBOW_TEST_CASE(Local, processMessage_StatSize)
+{
+    AthenaShardedContentStore *impl = _createShardedContentStore(10, 4);
+
+    CCNxName *name = ccnxName_CreateFromURI(CCNxNameAthena_ContentStore "/stat/size");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromInterest(interest);
+    ccnxInterest_Release(&interest);
+
+    CCNxMetaMessage *response = _athenaShardedContentStore_ProcessMessage(impl, message);
+
+    assertNotNull(response, "Expected a response to ProcessMessage()");
+    assertTrue(ccnxMetaMessage_IsContentObject(response), "Expected a content object");
+
+    ccnxMetaMessage_Release(&message);
+    ccnxMetaMessage_Release(&response);
+    _athenaShardedContentStore_Release((AthenaContentStoreImplementation *) &impl);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(ccnx_ShardedContentStore);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
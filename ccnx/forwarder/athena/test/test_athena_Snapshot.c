@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Snapshot.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct test_entry {
+    int value;
+} _TestEntry;
+
+static PARCJSON *
+_testEntry_ToJSON(const _TestEntry *entry)
+{
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddInteger(json, "value", entry->value);
+    return json;
+}
+
+parcObject_ExtendPARCObject(_TestEntry, NULL, NULL, NULL, NULL, NULL, NULL, _testEntry_ToJSON);
+
+static
+parcObject_ImplementRelease(_testEntry, _TestEntry);
+
+static AthenaSnapshot *
+_createSnapshot(size_t numEntries)
+{
+    AthenaSnapshot *snapshot = athenaSnapshot_Create("test", numEntries);
+    for (size_t i = 0; i < numEntries; i++) {
+        _TestEntry *entry = parcObject_CreateInstance(_TestEntry);
+        entry->value = (int) i;
+        athenaSnapshot_Append(snapshot, entry);
+        _testEntry_Release(&entry);
+    }
+    return snapshot;
+}
+
+LONGBOW_TEST_RUNNER(athena_Snapshot)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Snapshot)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Snapshot)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaSnapshot_Create);
+    LONGBOW_RUN_TEST_CASE(Global, athenaSnapshot_Append);
+    LONGBOW_RUN_TEST_CASE(Global, athenaSnapshot_GetNumberOfChunks);
+    LONGBOW_RUN_TEST_CASE(Global, athenaSnapshot_CreateChunk);
+    LONGBOW_RUN_TEST_CASE(Global, athenaSnapshot_CreateChunk_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, athenaSnapshot_CreatePartial);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaSnapshot_Create)
+{
+    AthenaSnapshot *snapshot = athenaSnapshot_Create("test", 0);
+    assertNotNull(snapshot, "Could not create a snapshot");
+    assertTrue(strcmp(athenaSnapshot_GetTableName(snapshot), "test") == 0, "Unexpected table name");
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 0, "Expected an empty snapshot");
+    assertTrue(athenaSnapshot_GetTime(snapshot) > 0, "Expected the time the snapshot was taken");
+
+    AthenaSnapshot *reference = athenaSnapshot_Acquire(snapshot);
+    assertTrue(reference == snapshot, "Expected acquire to return the same snapshot");
+    athenaSnapshot_Release(&reference);
+    athenaSnapshot_Release(&snapshot);
+    assertNull(snapshot, "Expected release to clear the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, athenaSnapshot_Append)
+{
+    AthenaSnapshot *snapshot = _createSnapshot(100);
+    assertTrue(athenaSnapshot_GetSize(snapshot) == 100, "Expected 100 entries, got %zu", athenaSnapshot_GetSize(snapshot));
+
+    for (size_t i = 0; i < athenaSnapshot_GetSize(snapshot); i++) {
+        const _TestEntry *entry = athenaSnapshot_Get(snapshot, i);
+        assertTrue(entry->value == (int) i, "Expected entries in the order appended");
+    }
+    athenaSnapshot_Release(&snapshot);
+}
+
+LONGBOW_TEST_CASE(Global, athenaSnapshot_GetNumberOfChunks)
+{
+    AthenaSnapshot *snapshot = _createSnapshot(0);
+    assertTrue(athenaSnapshot_GetNumberOfChunks(snapshot, 10) == 1, "Expected an empty snapshot to take one chunk");
+    athenaSnapshot_Release(&snapshot);
+
+    snapshot = _createSnapshot(10);
+    assertTrue(athenaSnapshot_GetNumberOfChunks(snapshot, 10) == 1, "Expected 10 entries to fit one chunk");
+    athenaSnapshot_Release(&snapshot);
+
+    snapshot = _createSnapshot(11);
+    assertTrue(athenaSnapshot_GetNumberOfChunks(snapshot, 10) == 2, "Expected 11 entries to take two chunks");
+    athenaSnapshot_Release(&snapshot);
+}
+
+LONGBOW_TEST_CASE(Global, athenaSnapshot_CreateChunk)
+{
+    AthenaSnapshot *snapshot = _createSnapshot(25);
+
+    for (size_t chunk = 0; chunk < 3; chunk++) {
+        PARCJSON *json = athenaSnapshot_CreateChunk(snapshot, chunk, 10);
+
+        PARCJSONValue *value = parcJSON_GetValueByName(json, "numEntries");
+        assertTrue(parcJSONValue_GetInteger(value) == 25, "Expected the total number of entries");
+        value = parcJSON_GetValueByName(json, "chunk");
+        assertTrue(parcJSONValue_GetInteger(value) == chunk, "Expected chunk %zu", chunk);
+        value = parcJSON_GetValueByName(json, "lastChunk");
+        assertTrue(parcJSONValue_GetBoolean(value) == (chunk == 2), "Expected only chunk 2 to be the last");
+
+        PARCJSONArray *entryList = parcJSONValue_GetArray(parcJSON_GetValueByName(json, "result"));
+        size_t expectedLength = (chunk == 2) ? 5 : 10;
+        assertTrue(parcJSONArray_GetLength(entryList) == expectedLength,
+                   "Expected %zu entries in chunk %zu, got %zu", expectedLength, chunk, parcJSONArray_GetLength(entryList));
+
+        PARCJSON *first = parcJSONValue_GetJSON(parcJSONArray_GetValue(entryList, 0));
+        value = parcJSON_GetValueByName(first, "value");
+        assertTrue(parcJSONValue_GetInteger(value) == (chunk * 10), "Expected chunk %zu to start at entry %zu", chunk, chunk * 10);
+
+        parcJSON_Release(&json);
+    }
+
+    athenaSnapshot_Release(&snapshot);
+}
+
+LONGBOW_TEST_CASE(Global, athenaSnapshot_CreateChunk_Empty)
+{
+    AthenaSnapshot *snapshot = _createSnapshot(5);
+
+    // Past the end
+    PARCJSON *json = athenaSnapshot_CreateChunk(snapshot, 7, 10);
+    PARCJSONArray *entryList = parcJSONValue_GetArray(parcJSON_GetValueByName(json, "result"));
+    assertTrue(parcJSONArray_GetLength(entryList) == 0, "Expected no entries past the end of the snapshot");
+    assertTrue(parcJSONValue_GetBoolean(parcJSON_GetValueByName(json, "lastChunk")), "Expected a chunk past the end to be the last");
+    parcJSON_Release(&json);
+
+    athenaSnapshot_Release(&snapshot);
+}
+
+LONGBOW_TEST_CASE(Global, athenaSnapshot_CreatePartial)
+{
+    AthenaSnapshot *snapshot = athenaSnapshot_CreatePartial("test", 0);
+    assertFalse(athenaSnapshot_IsComplete(snapshot), "Expected a partial snapshot to be incomplete");
+
+    for (int i = 0; i < 10; i++) {
+        _TestEntry *entry = parcObject_CreateInstance(_TestEntry);
+        entry->value = i;
+        athenaSnapshot_Append(snapshot, entry);
+        _testEntry_Release(&entry);
+    }
+
+    // Every entry appended so far fits the chunk, but the walk may yet find more
+    PARCJSON *json = athenaSnapshot_CreateChunk(snapshot, 0, 10);
+    assertTrue(parcJSONValue_GetInteger(parcJSON_GetValueByName(json, "numEntries")) == 10, "Expected the entries so far");
+    assertFalse(parcJSONValue_GetBoolean(parcJSON_GetValueByName(json, "lastChunk")), "Expected no last chunk before the walk is done");
+    parcJSON_Release(&json);
+
+    json = athenaSnapshot_CreateChunk(snapshot, 1, 10);
+    assertFalse(parcJSONValue_GetBoolean(parcJSON_GetValueByName(json, "lastChunk")), "Expected no last chunk before the walk is done");
+    parcJSON_Release(&json);
+
+    athenaSnapshot_SetComplete(snapshot);
+    assertTrue(athenaSnapshot_IsComplete(snapshot), "Expected the snapshot to be complete");
+    json = athenaSnapshot_CreateChunk(snapshot, 1, 10);
+    PARCJSONArray *entryList = parcJSONValue_GetArray(parcJSON_GetValueByName(json, "result"));
+    assertTrue(parcJSONArray_GetLength(entryList) == 0, "Expected no entries past the end of the snapshot");
+    assertTrue(parcJSONValue_GetBoolean(parcJSON_GetValueByName(json, "lastChunk")), "Expected the empty chunk after a full one to be the last");
+    parcJSON_Release(&json);
+
+    athenaSnapshot_Release(&snapshot);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Snapshot);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Stats.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define TEST_NUM_THREADS 8
+#define TEST_NUM_UPDATES 100000
+
+typedef enum {
+    TestCounter_Messages,
+    TestCounter_Bytes,
+    TestCounter_Count
+} TestCounter;
+
+static const uint64_t _testBucketBounds[] = { 10, 100, UINT64_MAX };
+
+static void *
+_update(void *arg)
+{
+    AthenaStats *stats = (AthenaStats *) arg;
+    for (int i = 0; i < TEST_NUM_UPDATES; i++) {
+        athenaStats_Increment(stats, TestCounter_Messages);
+        athenaStats_Add(stats, TestCounter_Bytes, 3);
+        athenaStats_Record(stats, 1, i % 200);
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_RUNNER(athena_Stats)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Stats)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Stats)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaStats_Create);
+    LONGBOW_RUN_TEST_CASE(Global, athenaStats_Add);
+    LONGBOW_RUN_TEST_CASE(Global, athenaStats_Record);
+    LONGBOW_RUN_TEST_CASE(Global, athenaStats_Threads);
+    LONGBOW_RUN_TEST_CASE(Global, athenaStats_ThreadExit);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    AthenaStats *stats = athenaStats_Create(TestCounter_Count, 2, 3, _testBucketBounds);
+    assertNotNull(stats, "athenaStats_Create failed");
+    longBowTestCase_SetClipBoardData(testCase, stats);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    AthenaStats *stats = longBowTestCase_GetClipBoardData(testCase);
+    athenaStats_Release(&stats);
+
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaStats_Create)
+{
+    AthenaStats *stats = longBowTestCase_GetClipBoardData(testCase);
+
+    assertTrue(athenaStats_Get(stats, TestCounter_Messages) == 0, "Expected a new counter to be zero");
+    assertTrue(athenaStats_GetNumberOfBuckets(stats) == 3, "Expected 3 buckets, got %zu", athenaStats_GetNumberOfBuckets(stats));
+    assertTrue(athenaStats_GetNumberOfBlocks(stats) == 0, "Expected no blocks before any update");
+    assertTrue(stats->blockSize % AthenaStatsCacheLineSize == 0, "Expected blocks padded to a cache line, got %zu", stats->blockSize);
+
+    // Counters only
+    AthenaStats *counters = athenaStats_Create(TestCounter_Count, 0, 0, NULL);
+    assertTrue(athenaStats_GetNumberOfBuckets(counters) == 0, "Expected no buckets");
+    athenaStats_Release(&counters);
+}
+
+LONGBOW_TEST_CASE(Global, athenaStats_Add)
+{
+    AthenaStats *stats = longBowTestCase_GetClipBoardData(testCase);
+
+    athenaStats_Increment(stats, TestCounter_Messages);
+    athenaStats_Increment(stats, TestCounter_Messages);
+    athenaStats_Add(stats, TestCounter_Bytes, 1500);
+
+    assertTrue(athenaStats_Get(stats, TestCounter_Messages) == 2, "Expected 2 messages, got %llu",
+               (unsigned long long) athenaStats_Get(stats, TestCounter_Messages));
+    assertTrue(athenaStats_Get(stats, TestCounter_Bytes) == 1500, "Expected 1500 bytes, got %llu",
+               (unsigned long long) athenaStats_Get(stats, TestCounter_Bytes));
+    assertTrue(athenaStats_GetNumberOfBlocks(stats) == 1, "Expected one block for the updating thread");
+
+    size_t threadNumber = _getThreadNumber();
+    assertTrue(((uintptr_t) stats->blocks[threadNumber] % AthenaStatsCacheLineSize) == 0, "Expected a cache line aligned block");
+}
+
+LONGBOW_TEST_CASE(Global, athenaStats_Record)
+{
+    AthenaStats *stats = longBowTestCase_GetClipBoardData(testCase);
+
+    athenaStats_Record(stats, 0, 0);
+    athenaStats_Record(stats, 0, 9);
+    athenaStats_Record(stats, 0, 10);
+    athenaStats_Record(stats, 0, 1000000);
+    athenaStats_Record(stats, 1, 50);
+
+    uint64_t buckets[3];
+    athenaStats_GetHistogram(stats, 0, buckets);
+    assertTrue((buckets[0] == 2) && (buckets[1] == 1) && (buckets[2] == 1), "Unexpected buckets %llu %llu %llu",
+               (unsigned long long) buckets[0], (unsigned long long) buckets[1], (unsigned long long) buckets[2]);
+
+    athenaStats_GetHistogram(stats, 1, buckets);
+    assertTrue((buckets[0] == 0) && (buckets[1] == 1) && (buckets[2] == 0), "Expected histograms counted apart");
+    assertTrue(athenaStats_Get(stats, TestCounter_Messages) == 0, "Expected histograms counted apart from counters");
+}
+
+LONGBOW_TEST_CASE(Global, athenaStats_Threads)
+{
+    AthenaStats *stats = longBowTestCase_GetClipBoardData(testCase);
+
+    pthread_t threads[TEST_NUM_THREADS];
+    for (int i = 0; i < TEST_NUM_THREADS; i++) {
+        assertTrue(pthread_create(&threads[i], NULL, _update, stats) == 0, "Unable to start thread %d", i);
+    }
+
+    // Reading while the threads update never sees a total go backwards
+    uint64_t previous = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t numMessages = athenaStats_Get(stats, TestCounter_Messages);
+        assertTrue(numMessages >= previous, "Counter went from %llu to %llu",
+                   (unsigned long long) previous, (unsigned long long) numMessages);
+        previous = numMessages;
+    }
+
+    for (int i = 0; i < TEST_NUM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint64_t expected = (uint64_t) TEST_NUM_THREADS * TEST_NUM_UPDATES;
+    assertTrue(athenaStats_Get(stats, TestCounter_Messages) == expected, "Expected %llu messages, got %llu",
+               (unsigned long long) expected, (unsigned long long) athenaStats_Get(stats, TestCounter_Messages));
+    assertTrue(athenaStats_Get(stats, TestCounter_Bytes) == 3 * expected, "Expected %llu bytes, got %llu",
+               (unsigned long long) (3 * expected), (unsigned long long) athenaStats_Get(stats, TestCounter_Bytes));
+
+    uint64_t buckets[3];
+    athenaStats_GetHistogram(stats, 1, buckets);
+    assertTrue(buckets[0] + buckets[1] + buckets[2] == expected, "Expected every value counted in a bucket");
+    assertTrue(buckets[0] == expected / 20, "Expected %llu in the first bucket, got %llu",
+               (unsigned long long) (expected / 20), (unsigned long long) buckets[0]);
+}
+
+LONGBOW_TEST_CASE(Global, athenaStats_ThreadExit)
+{
+    AthenaStats *stats = longBowTestCase_GetClipBoardData(testCase);
+
+    // A thread's counts outlive it, and its block is handed on to the next thread
+    for (int i = 0; i < 3; i++) {
+        pthread_t thread;
+        assertTrue(pthread_create(&thread, NULL, _update, stats) == 0, "Unable to start thread");
+        pthread_join(thread, NULL);
+    }
+
+    assertTrue(athenaStats_Get(stats, TestCounter_Messages) == 3 * TEST_NUM_UPDATES, "Expected %d messages, got %llu",
+               3 * TEST_NUM_UPDATES, (unsigned long long) athenaStats_Get(stats, TestCounter_Messages));
+    assertTrue(athenaStats_GetNumberOfBlocks(stats) == 1, "Expected threads run one after another to share a block, got %zu",
+               athenaStats_GetNumberOfBlocks(stats));
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Stats);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -35,6 +35,9 @@
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_Network.h>
 
+#include <ccnx/common/ccnx_Interest.h>
+
+#include <pthread.h>
 #include <stdio.h>
 
 
@@ -68,6 +71,11 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_SetGetEventFd);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_Routable);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_IsNotLocal);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLink_AdmitPush);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLink_EnqueueDrain);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLink_EnqueueConcurrent);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLink_SendInOrder);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLink_DrainBusyLink);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -262,6 +270,204 @@ LONGBOW_TEST_CASE(Global, athenaTransportLinkAdapter_IsNotLocal)
     athenaTransportLink_Release(&athenaTransportLink);
 }
 
+LONGBOW_TEST_CASE(Global, athenaTransportLink_AdmitPush)
+{
+    AthenaTransportLink *athenaTransportLink = athenaTransportLink_Create("test", _send_method, _receive_method, _close_method);
+    assertNotNull(athenaTransportLink, "athenaTransportLink_Create failed");
+    assertFalse(athenaTransportLink_AdmitPush(athenaTransportLink, 1, 0), "Expected a link not trusted to push by default");
+
+    athenaTransportLink_SetPushQuota(athenaTransportLink, 100);
+    assertTrue(athenaTransportLink_GetPushQuota(athenaTransportLink) == 100, "athenaTransportLink_SetPushQuota failed");
+    assertTrue(athenaTransportLink_AdmitPush(athenaTransportLink, 60, 0), "Expected content within the quota to be admitted");
+    assertFalse(athenaTransportLink_AdmitPush(athenaTransportLink, 60, 10), "Expected content over the quota to be refused");
+    assertTrue(athenaTransportLink_AdmitPush(athenaTransportLink, 40, 20), "Expected content filling the quota to be admitted");
+
+    // The quota is renewed each period
+    assertTrue(athenaTransportLink_AdmitPush(athenaTransportLink, 60, AthenaTransportLinkPushQuotaWindowMillis),
+               "Expected the quota to be renewed");
+
+    AthenaTransportLink *clone = athenaTransportLink_Clone(athenaTransportLink, "clone", _send_method, _receive_method, _close_method);
+    assertTrue(athenaTransportLink_GetPushQuota(clone) == 0, "Expected a clone not to inherit the push quota");
+    athenaTransportLink_Release(&clone);
+
+    athenaTransportLink_Release(&athenaTransportLink);
+}
+
+static size_t _sentCount;
+
+static int
+_counting_send_method(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage)
+{
+    _sentCount++;
+    return 0;
+}
+
+LONGBOW_TEST_CASE(Global, athenaTransportLink_EnqueueDrain)
+{
+    AthenaTransportLink *athenaTransportLink = athenaTransportLink_Create("test", _counting_send_method, _receive_method, _close_method);
+    assertNotNull(athenaTransportLink, "athenaTransportLink_Create failed");
+
+    int wakeup[2];
+    assertTrue(pipe(wakeup) == 0, "pipe failed (%s)", strerror(errno));
+    athenaTransportLink_SetWakeupFd(athenaTransportLink, wakeup[1]);
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxMetaMessage *ccnxMetaMessage = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    _sentCount = 0;
+    for (int i = 0; i < 3; i++) {
+        int result = athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+        assertTrue(result == 0, "athenaTransportLink_Enqueue failed (%s)", strerror(errno));
+    }
+    assertTrue(athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 3, "expected 3 queued messages");
+    assertTrue(_sentCount == 0, "enqueue should not send");
+
+    // Only the first enqueue onto an empty queue wakes the owner
+    uint64_t count[4];
+    ssize_t readCount = read(wakeup[0], count, sizeof(count));
+    assertTrue(readCount == sizeof(uint64_t), "expected a single wakeup (%zd)", readCount);
+
+    size_t drained = athenaTransportLink_DrainSendQueue(athenaTransportLink);
+    assertTrue(drained == 3, "athenaTransportLink_DrainSendQueue drained %zu, expected 3", drained);
+    assertTrue(_sentCount == 3, "expected 3 sends, got %zu", _sentCount);
+    assertTrue(athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 0, "queue should be empty");
+    assertTrue(athenaTransportLink_DrainSendQueue(athenaTransportLink) == 0, "empty queue drained messages");
+
+    // The queue is bounded
+    for (int i = 0; i < AthenaTransportLinkSendQueueLimit; i++) {
+        athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+    }
+    int result = athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+    assertTrue((result == -1) && (errno == ENOBUFS), "athenaTransportLink_Enqueue should fail on a full queue");
+
+    // A closing link refuses new messages, queued messages are released with the link
+    athenaTransportLink_SetEvent(athenaTransportLink, AthenaTransportLinkEvent_Closing);
+    result = athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+    assertTrue((result == -1) && (errno == ENOTCONN), "athenaTransportLink_Enqueue should fail on a closing link");
+
+    ccnxMetaMessage_Release(&ccnxMetaMessage);
+    athenaTransportLink_Release(&athenaTransportLink);
+    close(wakeup[0]);
+    close(wakeup[1]);
+}
+
+#define _ProducerCount 4
+#define _MessagesPerProducer 1000
+
+typedef struct {
+    AthenaTransportLink *athenaTransportLink;
+    CCNxMetaMessage *ccnxMetaMessage;
+} _ProducerArgs;
+
+static void *
+_producer(void *arg)
+{
+    _ProducerArgs *args = arg;
+    for (int i = 0; i < _MessagesPerProducer; i++) {
+        while (athenaTransportLink_Enqueue(args->athenaTransportLink, args->ccnxMetaMessage) != 0) {
+            usleep(10);
+        }
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, athenaTransportLink_EnqueueConcurrent)
+{
+    AthenaTransportLink *athenaTransportLink = athenaTransportLink_Create("test", _counting_send_method, _receive_method, _close_method);
+    assertNotNull(athenaTransportLink, "athenaTransportLink_Create failed");
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    _ProducerArgs args = { athenaTransportLink, ccnxInterest_CreateSimple(name) };
+    ccnxName_Release(&name);
+
+    _sentCount = 0;
+    pthread_t producers[_ProducerCount];
+    for (int i = 0; i < _ProducerCount; i++) {
+        pthread_create(&producers[i], NULL, _producer, &args);
+    }
+
+    // Drain concurrently with the producers, as the owning I/O context would
+    while (_sentCount < (_ProducerCount * _MessagesPerProducer)) {
+        athenaTransportLink_DrainSendQueue(athenaTransportLink);
+    }
+    for (int i = 0; i < _ProducerCount; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    assertTrue(_sentCount == (_ProducerCount * _MessagesPerProducer), "expected %d sends, got %zu",
+               _ProducerCount * _MessagesPerProducer, _sentCount);
+    assertTrue(athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 0, "queue should be empty");
+
+    ccnxMetaMessage_Release(&args.ccnxMetaMessage);
+    athenaTransportLink_Release(&athenaTransportLink);
+}
+
+static CCNxMetaMessage *_sentMessages[4];
+
+static int
+_recording_send_method(AthenaTransportLink *athenaTransportLink, CCNxMetaMessage *ccnxMetaMessage)
+{
+    _sentMessages[_sentCount++] = ccnxMetaMessage;
+    return 0;
+}
+
+LONGBOW_TEST_CASE(Global, athenaTransportLink_SendInOrder)
+{
+    AthenaTransportLink *athenaTransportLink = athenaTransportLink_Create("test", _recording_send_method, _receive_method, _close_method);
+    assertNotNull(athenaTransportLink, "athenaTransportLink_Create failed");
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/first");
+    CCNxMetaMessage *first = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+    name = ccnxName_CreateFromURI("lci:/foo/second");
+    CCNxMetaMessage *second = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    _sentCount = 0;
+
+    // While another thread holds the link the message is queued
+    assertTrue(_athenaTransportLink_AcquireSend(athenaTransportLink), "expected to take the link");
+    assertTrue(athenaTransportLink_Send(athenaTransportLink, first) == 0, "athenaTransportLink_Send failed to queue");
+    assertTrue(_sentCount == 0, "a busy link should not send");
+    athenaTransportLink->sendBusy = false; // as if the owner hadn't drained yet
+
+    // A later send on the free link goes out behind the queued message
+    assertTrue(athenaTransportLink_Send(athenaTransportLink, second) == 0, "athenaTransportLink_Send failed");
+    assertTrue(_sentCount == 2, "expected 2 sends, got %zu", _sentCount);
+    assertTrue((_sentMessages[0] == first) && (_sentMessages[1] == second), "messages were sent out of order");
+    assertTrue(athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 0, "queue should be empty");
+
+    ccnxMetaMessage_Release(&first);
+    ccnxMetaMessage_Release(&second);
+    athenaTransportLink_Release(&athenaTransportLink);
+}
+
+LONGBOW_TEST_CASE(Global, athenaTransportLink_DrainBusyLink)
+{
+    AthenaTransportLink *athenaTransportLink = athenaTransportLink_Create("test", _counting_send_method, _receive_method, _close_method);
+    assertNotNull(athenaTransportLink, "athenaTransportLink_Create failed");
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxMetaMessage *ccnxMetaMessage = ccnxInterest_CreateSimple(name);
+    ccnxName_Release(&name);
+
+    _sentCount = 0;
+
+    // A drain that finds another thread sending leaves the message queued
+    assertTrue(_athenaTransportLink_AcquireSend(athenaTransportLink), "expected to take the link");
+    athenaTransportLink_Enqueue(athenaTransportLink, ccnxMetaMessage);
+    assertTrue(athenaTransportLink_DrainSendQueue(athenaTransportLink) == 0, "a busy link should not be drained");
+    assertTrue(_sentCount == 0, "a busy link should not send");
+
+    // The sending thread sends it when it gives up the link
+    _athenaTransportLink_ReleaseSend(athenaTransportLink);
+    assertTrue(_sentCount == 1, "expected the queued message to be sent on release, got %zu sends", _sentCount);
+    assertTrue(athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 0, "queue should be empty");
+
+    ccnxMetaMessage_Release(&ccnxMetaMessage);
+    athenaTransportLink_Release(&athenaTransportLink);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
 }
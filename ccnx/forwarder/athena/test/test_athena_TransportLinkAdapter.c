@@ -35,6 +35,7 @@
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/algol/parc_Network.h>
 
+#include <pthread.h>
 #include <stdio.h>
 
 
@@ -62,6 +63,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_OpenPollClose);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_AddRemoveLink);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_SendReceive);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_AcquireLinkEnqueue);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_LoadLookupRemoveModule);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_NameToIdToName);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkAdapter_IsNotLocal);
@@ -365,6 +367,82 @@ LONGBOW_TEST_CASE(Global, athenaTransportLinkAdapter_SendReceive)
     athenaTransportLinkAdapter_Destroy(&athenaTransportLinkAdapter);
 }
 
+typedef struct {
+    AthenaTransportLink *athenaTransportLink;
+    CCNxMetaMessage *ccnxMetaMessage;
+} _EnqueueArgs;
+
+static void *
+_enqueueFromThread(void *arg)
+{
+    _EnqueueArgs *args = arg;
+    usleep(1000);
+    int result = athenaTransportLink_Enqueue(args->athenaTransportLink, args->ccnxMetaMessage);
+    assertTrue(result == 0, "athenaTransportLink_Enqueue failed (%s)", strerror(errno));
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, athenaTransportLinkAdapter_AcquireLinkEnqueue)
+{
+    PARCURI *connectionURI;
+    const char *result;
+    CCNxMetaMessage *receiveMessage;
+    PARCBitVector *resultVector;
+    AthenaTransportLinkAdapter *athenaTransportLinkAdapter = athenaTransportLinkAdapter_Create(_removeLink, NULL);
+    assertNotNull(athenaTransportLinkAdapter, "athenaTransportLinkAdapter_Create returned NULL");
+
+    _LoadModule(athenaTransportLinkAdapter, "TCP");
+
+    connectionURI = parcURI_Parse("tcp://127.0.0.1:50200/Listener/name=TCPListener");
+    result = athenaTransportLinkAdapter_Open(athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    connectionURI = parcURI_Parse("tcp://127.0.0.1:50200/name=TCP_1");
+    result = athenaTransportLinkAdapter_Open(athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result != NULL, "athenaTransportLinkAdapter_Open failed (%s)", strerror(errno));
+    parcURI_Release(&connectionURI);
+
+    // Accept the connection from TCP_1
+    receiveMessage = athenaTransportLinkAdapter_Receive(athenaTransportLinkAdapter, &resultVector, 0);
+    assertNull(resultVector, "Received message when none sent");
+
+    int linkId = athenaTransportLinkAdapter_LinkNameToId(athenaTransportLinkAdapter, "TCP_1");
+    AthenaTransportLink *athenaTransportLink = athenaTransportLinkAdapter_AcquireLink(athenaTransportLinkAdapter, linkId);
+    assertNotNull(athenaTransportLink, "athenaTransportLinkAdapter_AcquireLink failed");
+    assertNull(athenaTransportLinkAdapter_AcquireLink(athenaTransportLinkAdapter, 9999), "acquired a link that doesn't exist");
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    _EnqueueArgs args = { athenaTransportLink, ccnxInterest_CreateSimple(name) };
+    ccnxName_Release(&name);
+    athena_EncodeMessage(args.ccnxMetaMessage);
+
+    // A blocked receive is woken by the enqueue, sends it, and then receives it on the accepted end.
+    pthread_t producer;
+    pthread_create(&producer, NULL, _enqueueFromThread, &args);
+    receiveMessage = athenaTransportLinkAdapter_Receive(athenaTransportLinkAdapter, &resultVector, -1);
+    while (receiveMessage == NULL) {
+        receiveMessage = athenaTransportLinkAdapter_Receive(athenaTransportLinkAdapter, &resultVector, -1);
+    }
+    pthread_join(producer, NULL);
+
+    assertNotNull(resultVector, "athenaTransportLinkAdapter_Receive failed");
+    assertFalse(parcBitVector_Get(resultVector, linkId), "message was received on the sending link");
+    assertTrue(athenaTransportLink_GetSendQueueDepth(athenaTransportLink) == 0, "send queue was not drained");
+    parcBitVector_Release(&resultVector);
+    ccnxMetaMessage_Release(&receiveMessage);
+
+    AthenaTransportLinkAdapterStats stats;
+    athenaTransportLinkAdapter_GetStats(athenaTransportLinkAdapter, &stats);
+    assertTrue(stats.messageSend_Dequeued == 1, "Expected 1 message sent from the queue, got %llu",
+               (unsigned long long) stats.messageSend_Dequeued);
+    assertTrue(stats.messageReceived == 1, "Expected 1 message received, got %llu", (unsigned long long) stats.messageReceived);
+
+    ccnxMetaMessage_Release(&args.ccnxMetaMessage);
+    athenaTransportLink_Release(&athenaTransportLink);
+    athenaTransportLinkAdapter_Destroy(&athenaTransportLinkAdapter);
+}
+
 LONGBOW_TEST_CASE(Global, athenaTransportLinkAdapter_LoadLookupRemoveModule)
 {
     int result;
@@ -59,6 +59,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleTCP_OpenClose);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleTCP_SendReceive);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleTCP_Local);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleTCP_Shards);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -185,6 +186,28 @@ LONGBOW_TEST_CASE(Global, athenaTransportLinkModuleTCP_SendReceive)
     athenaTransportLinkAdapter_Destroy(&athenaTransportLinkAdapter);
 }
 
+LONGBOW_TEST_CASE(Global, athenaTransportLinkModuleTCP_Shards)
+{
+    PARCURI *connectionURI;
+    const char *result;
+    AthenaTransportLinkAdapter *athenaTransportLinkAdapter = athenaTransportLinkAdapter_Create(_removeLink, NULL);
+    assertNotNull(athenaTransportLinkAdapter, "athenaTransportLinkAdapter_Create returned NULL");
+
+    // A shard on a forwarder of its own would drop everything for want of routes, so none are opened
+    connectionURI = parcURI_Parse("tcp://127.0.0.1:40010/listener/shards=2/name=TCP_S");
+    result = athenaTransportLinkAdapter_Open(athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result == NULL, "athenaTransportLinkAdapter_Open opened a sharded listener");
+    assertTrue(errno == EINVAL, "athenaTransportLinkAdapter_Open set errno %d rather than EINVAL", errno);
+    parcURI_Release(&connectionURI);
+
+    connectionURI = parcURI_Parse("tcp://127.0.0.1:40010/listener/steer=cpu/name=TCP_S");
+    result = athenaTransportLinkAdapter_Open(athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result == NULL, "athenaTransportLinkAdapter_Open accepted a listener steering specification");
+    parcURI_Release(&connectionURI);
+
+    athenaTransportLinkAdapter_Destroy(&athenaTransportLinkAdapter);
+}
+
 LONGBOW_TEST_CASE(Global, athenaTransportLinkModuleTCP_Local)
 {
     PARCURI *connectionURI;
@@ -61,6 +61,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleUDP_MTU);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleUDP_P2P);
     LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleUDP_Local);
+    LONGBOW_RUN_TEST_CASE(Global, athenaTransportLinkModuleUDP_Shards);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -303,6 +304,28 @@ LONGBOW_TEST_CASE(Global, athenaTransportLinkModuleUDP_P2P)
     athenaTransportLinkAdapter_Destroy(&athenaTransportLinkAdapter);
 }
 
+LONGBOW_TEST_CASE(Global, athenaTransportLinkModuleUDP_Shards)
+{
+    PARCURI *connectionURI;
+    const char *result;
+    AthenaTransportLinkAdapter *athenaTransportLinkAdapter = athenaTransportLinkAdapter_Create(_removeLink, NULL);
+    assertNotNull(athenaTransportLinkAdapter, "athenaTransportLinkAdapter_Create returned NULL");
+
+    // A shard on a forwarder of its own would drop everything for want of routes, so none are opened
+    connectionURI = parcURI_Parse("udp://127.0.0.1:40011/listener/shards=2/name=UDP_S");
+    result = athenaTransportLinkAdapter_Open(athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result == NULL, "athenaTransportLinkAdapter_Open opened a sharded listener");
+    assertTrue(errno == EINVAL, "athenaTransportLinkAdapter_Open set errno %d rather than EINVAL", errno);
+    parcURI_Release(&connectionURI);
+
+    connectionURI = parcURI_Parse("udp://127.0.0.1:40011/listener/steer=cpu/name=UDP_S");
+    result = athenaTransportLinkAdapter_Open(athenaTransportLinkAdapter, connectionURI);
+    assertTrue(result == NULL, "athenaTransportLinkAdapter_Open accepted a listener steering specification");
+    parcURI_Release(&connectionURI);
+
+    athenaTransportLinkAdapter_Destroy(&athenaTransportLinkAdapter);
+}
+
 LONGBOW_TEST_CASE(Global, athenaTransportLinkModuleUDP_Local)
 {
     PARCURI *connectionURI;
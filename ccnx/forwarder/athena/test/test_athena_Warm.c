@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../athena_Warm.c"
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <parc/algol/parc_FileOutputStream.h>
+#include <parc/logging/parc_LogReporterFile.h>
+
+#define TEST_LIST_PATH "/tmp/test_athena_Warm.list"
+
+typedef struct test_data {
+    PARCLog *log;
+} TestData;
+
+static PARCLog *
+_createLog(void)
+{
+    PARCFileOutputStream *fileOutput = parcFileOutputStream_Create(dup(STDOUT_FILENO));
+    PARCOutputStream *output = parcFileOutputStream_AsOutputStream(fileOutput);
+    parcFileOutputStream_Release(&fileOutput);
+
+    PARCLogReporter *reporter = parcLogReporterFile_Create(output);
+    parcOutputStream_Release(&output);
+
+    PARCLog *log = parcLog_Create("localhost", "test_athena_Warm", NULL, reporter);
+    parcLogReporter_Release(&reporter);
+    return log;
+}
+
+static void
+_writeList(const char *contents)
+{
+    FILE *file = fopen(TEST_LIST_PATH, "w");
+    assertNotNull(file, "Unable to write %s", TEST_LIST_PATH);
+    fputs(contents, file);
+    fclose(file);
+}
+
+static void
+_assertNextName(AthenaWarm *warm, uint64_t nowInMillis, const char *expected)
+{
+    CCNxName *name = athenaWarm_CreateNextName(warm, nowInMillis);
+    assertNotNull(name, "Expected %s", expected);
+    CCNxName *expectedName = ccnxName_CreateFromURI(expected);
+    assertTrue(ccnxName_Equals(name, expectedName), "Expected %s", expected);
+    ccnxName_Release(&expectedName);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_RUNNER(athena_Warm)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(athena_Warm)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(athena_Warm)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, athenaWarm_Create);
+    LONGBOW_RUN_TEST_CASE(Global, athenaWarm_CreateNextName);
+    LONGBOW_RUN_TEST_CASE(Global, athenaWarm_Rate);
+    LONGBOW_RUN_TEST_CASE(Global, athenaWarm_Fetched);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    data->log = _createLog();
+
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    parcLog_Release(&data->log);
+    parcMemory_Deallocate(&data);
+    unlink(TEST_LIST_PATH);
+
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_TEARDOWN_FAILED;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, athenaWarm_Create)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    unlink(TEST_LIST_PATH);
+    AthenaWarm *warm = athenaWarm_Create(TEST_LIST_PATH, 0, 0, data->log);
+    assertNull(warm, "Expected no job without a list");
+
+    _writeList("lci:/foo\n");
+    warm = athenaWarm_Create(TEST_LIST_PATH, 0, 0, data->log);
+    assertNotNull(warm, "athenaWarm_Create failed");
+    assertTrue(strcmp(athenaWarm_GetListPath(warm), TEST_LIST_PATH) == 0, "Expected the list path to be kept");
+    assertTrue(athenaWarm_GetRate(warm) == AthenaWarmDefaultRate, "Expected the default rate, not %zu", athenaWarm_GetRate(warm));
+    athenaWarm_Release(&warm);
+}
+
+LONGBOW_TEST_CASE(Global, athenaWarm_CreateNextName)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    _writeList("# warming list\n"
+               "lci:/foo/bar\n"
+               "\n"
+               "lci:/video 2   # two chunks\n"
+               "lci:/bad chunks\n"
+               "lci:/last\n");
+    AthenaWarm *warm = athenaWarm_Create(TEST_LIST_PATH, 1000, 0, data->log);
+    assertNotNull(warm, "athenaWarm_Create failed");
+
+    // Far enough in that the rate doesn't hold any of the names back
+    uint64_t nowInMillis = 1000;
+    _assertNextName(warm, nowInMillis, "lci:/foo/bar");
+    _assertNextName(warm, nowInMillis, "lci:/video/chunk=0");
+    _assertNextName(warm, nowInMillis, "lci:/video/chunk=1");
+    _assertNextName(warm, nowInMillis, "lci:/last");
+    assertNull(athenaWarm_CreateNextName(warm, nowInMillis), "Expected the list to be exhausted");
+    assertTrue(athenaWarm_IsComplete(warm, nowInMillis), "Expected a job with nothing pending to be complete");
+
+    AthenaWarmStats stats;
+    athenaWarm_GetStats(warm, &stats);
+    assertTrue(stats.numIssued == 4, "Expected 4 names issued, not %llu", (unsigned long long) stats.numIssued);
+    assertTrue(stats.numInvalid == 1, "Expected 1 invalid line, not %llu", (unsigned long long) stats.numInvalid);
+
+    athenaWarm_Release(&warm);
+}
+
+LONGBOW_TEST_CASE(Global, athenaWarm_Rate)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    _writeList("lci:/names 100\n");
+    AthenaWarm *warm = athenaWarm_Create(TEST_LIST_PATH, 10, 5000, data->log);
+    assertNotNull(warm, "athenaWarm_Create failed");
+
+    size_t numNames = 0;
+    CCNxName *name;
+    while ((name = athenaWarm_CreateNextName(warm, 5000)) != NULL) {
+        ccnxName_Release(&name);
+        numNames++;
+    }
+    assertTrue(numNames == 1, "Expected a single name at the start, not %zu", numNames);
+
+    // Ten per second, so half a second later five more are due
+    while ((name = athenaWarm_CreateNextName(warm, 5500)) != NULL) {
+        ccnxName_Release(&name);
+        numNames++;
+    }
+    assertTrue(numNames == 6, "Expected 6 names after half a second, not %zu", numNames);
+    assertFalse(athenaWarm_IsComplete(warm, 5500), "Expected the job to be in progress");
+
+    athenaWarm_Release(&warm);
+}
+
+LONGBOW_TEST_CASE(Global, athenaWarm_Fetched)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    _writeList("lci:/cached\nlci:/fetched\nlci:/lost\n");
+    AthenaWarm *warm = athenaWarm_Create(TEST_LIST_PATH, 1000, 0, data->log);
+    assertNotNull(warm, "athenaWarm_Create failed");
+
+    CCNxName *cached = athenaWarm_CreateNextName(warm, 1000);
+    CCNxName *fetched = athenaWarm_CreateNextName(warm, 1000);
+    CCNxName *lost = athenaWarm_CreateNextName(warm, 1000);
+    assertNull(athenaWarm_CreateNextName(warm, 1000), "Expected the list to be exhausted");
+
+    athenaWarm_Hit(warm);
+    athenaWarm_Miss(warm, fetched, 5000);
+    athenaWarm_Miss(warm, lost, 6000);
+
+    assertFalse(athenaWarm_Fetched(warm, cached, 100), "Expected a name not fetched by the job to be left alone");
+    assertTrue(athenaWarm_Fetched(warm, fetched, 100), "Expected a fetched name to be counted");
+    assertFalse(athenaWarm_Fetched(warm, fetched, 100), "Expected a name to be counted once");
+
+    assertFalse(athenaWarm_IsComplete(warm, 5500), "Expected the job to wait for its pending fetch");
+    assertTrue(athenaWarm_IsComplete(warm, 6000), "Expected the job to complete once its fetches expire");
+
+    AthenaWarmStats stats;
+    athenaWarm_GetStats(warm, &stats);
+    assertTrue(stats.numHits == 1, "Expected 1 hit");
+    assertTrue(stats.numMisses == 2, "Expected 2 misses");
+    assertTrue(stats.numFetched == 1, "Expected 1 fetched");
+    assertTrue(stats.bytesFetched == 100, "Expected 100 bytes fetched");
+    assertTrue(stats.numPending == 1, "Expected 1 pending");
+
+    ccnxName_Release(&cached);
+    ccnxName_Release(&fetched);
+    ccnxName_Release(&lost);
+    athenaWarm_Release(&warm);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(athena_Warm);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
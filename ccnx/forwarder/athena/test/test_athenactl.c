@@ -67,6 +67,7 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, athenactl_Command);
     LONGBOW_RUN_TEST_CASE(Global, athenactl_Usage);
+    LONGBOW_RUN_TEST_CASE(Global, athenactl_CommandFile);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -176,6 +177,49 @@ LONGBOW_TEST_CASE(Global, athenactl_Command)
     }
 }
 
+LONGBOW_TEST_CASE(Global, athenactl_CommandFile)
+{
+    Athena *athena = athena_Create(AthenaDefaultContentStoreSize);
+    assertNotNull(athena, "Expected a forwarder instance");
+
+    PARCURI *connectionURI = parcURI_Parse("tcp://localhost:50501/listener");
+    assertNotNull(athenaTransportLinkAdapter_Open(athena->athenaTransportLinkAdapter, connectionURI), "Unable to configure an interface");
+    parcURI_Release(&connectionURI);
+
+    pthread_t thread;
+    int result = pthread_create(&thread, NULL, athena_ForwarderEngine, (void *) athena_Acquire(athena));
+    assertTrue(result == 0, "pthread_create failed to create athena_ForwarderEngine");
+
+    result = setenv(FORWARDER_CONNECTION_ENV, "tcp://localhost:50501", 1);
+    assertTrue(result == 0, "setenv of %s failed", FORWARDER_CONNECTION_ENV);
+
+    // Identical route commands are pipelined under distinct names
+    FILE *commandFile = tmpfile();
+    fputs("# reconfigure\n", commandFile);
+    fputs("add link tcp://localhost:50501/name=TCP_0\n", commandFile);
+    for (int i = 0; i < 10; i++) {
+        fputs("add route TCP_0 lci:/foo/bar\n", commandFile);
+    }
+    fputs("\n", commandFile);
+    fputs("list routes\n", commandFile);
+    fputs("remove route TCP_0 lci:/foo/bar  # trailing comment\n", commandFile);
+    fputs("quit\n", commandFile);
+    rewind(commandFile);
+
+    parcSecurity_Init();
+    PARCIdentity *identity = _create_identity();
+    result = athenactl_CommandFile(identity, commandFile);
+    parcIdentity_Release(&identity);
+    parcSecurity_Fini();
+    fclose(commandFile);
+
+    assertTrue(result == 0, "athenactl_CommandFile failed");
+    assertTrue(_athenactlSession.portal == NULL, "Expected the session to be closed");
+
+    athena_Release(&athena);
+    pthread_join(thread, NULL);
+}
+
 LONGBOW_TEST_CASE(Global, athenactl_Usage)
 {
     athenactl_Usage();